@@ -77,6 +77,8 @@ return
 	"interactionAmbient.vertex",
 	"interactionAmbient_skinned.pixel",
 	"interactionAmbient_skinned.vertex",
+	"interactionClustered.pixel",
+	"interactionClustered.vertex",
 	"interactionSM.pixel",
 	"interactionSM.vertex",
 	"motionBlur.pixel",
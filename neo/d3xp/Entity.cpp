@@ -220,6 +220,41 @@ void AddRenderGui( const char* name, idUserInterface** gui, const idDict* args )
 	UpdateGuiParms( *gui, args );
 }
 
+/*
+================
+spawn arg symbols for the canonical render entity and sound parsing
+================
+*/
+static const idDictSymbol key_model( "model" );
+static const idDictSymbol key_skin( "skin" );
+static const idDictSymbol key_shader( "shader" );
+static const idDictSymbol key_origin( "origin" );
+static const idDictSymbol key_rotation( "rotation" );
+static const idDictSymbol key_angle( "angle" );
+static const idDictSymbol key_color( "_color" );
+static const idDictSymbol key_shaderParms[MAX_ENTITY_SHADER_PARMS] =
+{
+	idDictSymbol( "shaderParm0" ), idDictSymbol( "shaderParm1" ), idDictSymbol( "shaderParm2" ), idDictSymbol( "shaderParm3" ),
+	idDictSymbol( "shaderParm4" ), idDictSymbol( "shaderParm5" ), idDictSymbol( "shaderParm6" ), idDictSymbol( "shaderParm7" ),
+	idDictSymbol( "shaderParm8" ), idDictSymbol( "shaderParm9" ), idDictSymbol( "shaderParm10" ), idDictSymbol( "shaderParm11" )
+};
+static const idDictSymbol key_noDynamicInteractions( "noDynamicInteractions" );
+static const idDictSymbol key_noShadows( "noshadows" );
+static const idDictSymbol key_noSelfShadows( "noselfshadows" );
+static const idDictSymbol key_minDistance( "s_mindistance" );
+static const idDictSymbol key_maxDistance( "s_maxdistance" );
+static const idDictSymbol key_volume( "s_volume" );
+static const idDictSymbol key_shakes( "s_shakes" );
+static const idDictSymbol key_diversity( "s_diversity" );
+static const idDictSymbol key_waitForTrigger( "s_waitfortrigger" );
+static const idDictSymbol key_omni( "s_omni" );
+static const idDictSymbol key_looping( "s_looping" );
+static const idDictSymbol key_occlusion( "s_occlusion" );
+static const idDictSymbol key_global( "s_global" );
+static const idDictSymbol key_unclamped( "s_unclamped" );
+static const idDictSymbol key_soundClass( "s_soundClass" );
+static const idDictSymbol key_soundShader( "s_shader" );
+
 /*
 ================
 idGameEdit::ParseSpawnArgsToRenderEntity
@@ -239,7 +274,7 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict* args, renderEntity_
 	
 	memset( renderEntity, 0, sizeof( *renderEntity ) );
 	
-	temp = args->GetString( "model" );
+	temp = args->GetString( key_model );
 	
 	modelDef = NULL;
 	if( temp[0] != '\0' )
@@ -263,7 +298,7 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict* args, renderEntity_
 		renderEntity->bounds.Zero();
 	}
 	
-	temp = args->GetString( "skin" );
+	temp = args->GetString( key_skin );
 	if( temp[0] != '\0' )
 	{
 		renderEntity->customSkin = declManager->FindSkin( temp );
@@ -273,18 +308,18 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict* args, renderEntity_
 		renderEntity->customSkin = modelDef->GetDefaultSkin();
 	}
 	
-	temp = args->GetString( "shader" );
+	temp = args->GetString( key_shader );
 	if( temp[0] != '\0' )
 	{
 		renderEntity->customShader = declManager->FindMaterial( temp );
 	}
 	
-	args->GetVector( "origin", "0 0 0", renderEntity->origin );
+	args->GetVector( key_origin, "0 0 0", renderEntity->origin );
 	
 	// get the rotation matrix in either full form, or single angle form
-	if( !args->GetMatrix( "rotation", "1 0 0 0 1 0 0 0 1", renderEntity->axis ) )
+	if( !args->GetMatrix( key_rotation, "1 0 0 0 1 0 0 0 1", renderEntity->axis ) )
 	{
-		angle = args->GetFloat( "angle" );
+		angle = args->GetFloat( key_angle );
 		if( angle != 0.0f )
 		{
 			renderEntity->axis = idAngles( 0.0f, angle, 0.0f ).ToMat3();
@@ -298,28 +333,28 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict* args, renderEntity_
 	renderEntity->referenceSound = NULL;
 	
 	// get shader parms
-	args->GetVector( "_color", "1 1 1", color );
+	args->GetVector( key_color, "1 1 1", color );
 	renderEntity->shaderParms[ SHADERPARM_RED ]		= color[0];
 	renderEntity->shaderParms[ SHADERPARM_GREEN ]	= color[1];
 	renderEntity->shaderParms[ SHADERPARM_BLUE ]	= color[2];
-	renderEntity->shaderParms[ 3 ]					= args->GetFloat( "shaderParm3", "1" );
-	renderEntity->shaderParms[ 4 ]					= args->GetFloat( "shaderParm4", "0" );
-	renderEntity->shaderParms[ 5 ]					= args->GetFloat( "shaderParm5", "0" );
-	renderEntity->shaderParms[ 6 ]					= args->GetFloat( "shaderParm6", "0" );
-	renderEntity->shaderParms[ 7 ]					= args->GetFloat( "shaderParm7", "0" );
-	renderEntity->shaderParms[ 8 ]					= args->GetFloat( "shaderParm8", "0" );
-	renderEntity->shaderParms[ 9 ]					= args->GetFloat( "shaderParm9", "0" );
-	renderEntity->shaderParms[ 10 ]					= args->GetFloat( "shaderParm10", "0" );
-	renderEntity->shaderParms[ 11 ]					= args->GetFloat( "shaderParm11", "0" );
+	renderEntity->shaderParms[ 3 ]					= args->GetFloat( key_shaderParms[3], "1" );
+	renderEntity->shaderParms[ 4 ]					= args->GetFloat( key_shaderParms[4], "0" );
+	renderEntity->shaderParms[ 5 ]					= args->GetFloat( key_shaderParms[5], "0" );
+	renderEntity->shaderParms[ 6 ]					= args->GetFloat( key_shaderParms[6], "0" );
+	renderEntity->shaderParms[ 7 ]					= args->GetFloat( key_shaderParms[7], "0" );
+	renderEntity->shaderParms[ 8 ]					= args->GetFloat( key_shaderParms[8], "0" );
+	renderEntity->shaderParms[ 9 ]					= args->GetFloat( key_shaderParms[9], "0" );
+	renderEntity->shaderParms[ 10 ]					= args->GetFloat( key_shaderParms[10], "0" );
+	renderEntity->shaderParms[ 11 ]					= args->GetFloat( key_shaderParms[11], "0" );
 	
 	// check noDynamicInteractions flag
-	renderEntity->noDynamicInteractions = args->GetBool( "noDynamicInteractions" );
+	renderEntity->noDynamicInteractions = args->GetBool( key_noDynamicInteractions );
 	
 	// check noshadows flag
-	renderEntity->noShadow = args->GetBool( "noshadows" );
+	renderEntity->noShadow = args->GetBool( key_noShadows );
 	
 	// check noselfshadows flag
-	renderEntity->noSelfShadow = args->GetBool( "noselfshadows" );
+	renderEntity->noSelfShadow = args->GetBool( key_noSelfShadows );
 	
 	// init any guis, including entity-specific states
 	for( i = 0; i < MAX_RENDERENTITY_GUI; i++ )
@@ -347,44 +382,44 @@ void idGameEdit::ParseSpawnArgsToRefSound( const idDict* args, refSound_t* refSo
 	
 	memset( refSound, 0, sizeof( *refSound ) );
 	
-	refSound->parms.minDistance = args->GetFloat( "s_mindistance" );
-	refSound->parms.maxDistance = args->GetFloat( "s_maxdistance" );
-	refSound->parms.volume = args->GetFloat( "s_volume" );
-	refSound->parms.shakes = args->GetFloat( "s_shakes" );
+	refSound->parms.minDistance = args->GetFloat( key_minDistance );
+	refSound->parms.maxDistance = args->GetFloat( key_maxDistance );
+	refSound->parms.volume = args->GetFloat( key_volume );
+	refSound->parms.shakes = args->GetFloat( key_shakes );
 	
-	args->GetVector( "origin", "0 0 0", refSound->origin );
+	args->GetVector( key_origin, "0 0 0", refSound->origin );
 	
 	refSound->referenceSound  = NULL;
 	
 	// if a diversity is not specified, every sound start will make
 	// a random one.  Specifying diversity is usefull to make multiple
 	// lights all share the same buzz sound offset, for instance.
-	refSound->diversity = args->GetFloat( "s_diversity", "-1" );
-	refSound->waitfortrigger = args->GetBool( "s_waitfortrigger" );
+	refSound->diversity = args->GetFloat( key_diversity, "-1" );
+	refSound->waitfortrigger = args->GetBool( key_waitForTrigger );
 	
-	if( args->GetBool( "s_omni" ) )
+	if( args->GetBool( key_omni ) )
 	{
 		refSound->parms.soundShaderFlags |= SSF_OMNIDIRECTIONAL;
 	}
-	if( args->GetBool( "s_looping" ) )
+	if( args->GetBool( key_looping ) )
 	{
 		refSound->parms.soundShaderFlags |= SSF_LOOPING;
 	}
-	if( args->GetBool( "s_occlusion" ) )
+	if( args->GetBool( key_occlusion ) )
 	{
 		refSound->parms.soundShaderFlags |= SSF_NO_OCCLUSION;
 	}
-	if( args->GetBool( "s_global" ) )
+	if( args->GetBool( key_global ) )
 	{
 		refSound->parms.soundShaderFlags |= SSF_GLOBAL;
 	}
-	if( args->GetBool( "s_unclamped" ) )
+	if( args->GetBool( key_unclamped ) )
 	{
 		refSound->parms.soundShaderFlags |= SSF_UNCLAMPED;
 	}
-	refSound->parms.soundClass = args->GetInt( "s_soundClass" );
+	refSound->parms.soundClass = args->GetInt( key_soundClass );
 	
-	temp = args->GetString( "s_shader" );
+	temp = args->GetString( key_soundShader );
 	if( temp[0] != '\0' )
 	{
 		refSound->shader = declManager->FindSound( temp );
@@ -235,7 +235,7 @@ void idGameLocal::Clear()
 	locationEntities = NULL;
 	smokeParticles = NULL;
 	editEntities = NULL;
-	entityHash.Clear( 1024, MAX_GENTITIES );
+	entityHash.Clear();
 	cinematicSkipTime = 0;
 	cinematicStopTime = 0;
 	cinematicMaxSkipTime = 0;
@@ -1598,7 +1598,7 @@ void idGameLocal::MapClear( bool clearClients )
 		spawnIds[ i ] = -1;
 	}
 	
-	entityHash.Clear( 1024, MAX_GENTITIES );
+	entityHash.Clear();
 	
 	if( !clearClients )
 	{
@@ -1609,7 +1609,7 @@ void idGameLocal::MapClear( bool clearClients )
 			{
 				continue;
 			}
-			entityHash.Add( entityHash.GenerateKey( entities[ i ]->name.c_str(), true ), i );
+			entityHash.Set( entities[ i ]->name, i );
 		}
 	}
 	
@@ -3755,6 +3755,12 @@ bool idGameLocal::SpawnEntityDef( const idDict& args, idEntity** ent, bool setDe
 	idStr		error;
 	const char*  name;
 	
+	static const idDictSymbol key_name( "name" );
+	static const idDictSymbol key_classname( "classname" );
+	static const idDictSymbol key_slowmo( "slowmo" );
+	static const idDictSymbol key_spawnclass( "spawnclass" );
+	static const idDictSymbol key_spawnfunc( "spawnfunc" );
+	
 	if( ent )
 	{
 		*ent = NULL;
@@ -3762,12 +3768,12 @@ bool idGameLocal::SpawnEntityDef( const idDict& args, idEntity** ent, bool setDe
 	
 	spawnArgs = args;
 	
-	if( spawnArgs.GetString( "name", "", &name ) )
+	if( spawnArgs.GetString( key_name, "", &name ) )
 	{
 		sprintf( error, " on '%s'", name );
 	}
 	
-	spawnArgs.GetString( "classname", NULL, &classname );
+	spawnArgs.GetString( key_classname, NULL, &classname );
 	
 	const idDeclEntityDef* def = FindEntityDef( classname, false );
 	
@@ -3779,7 +3785,7 @@ bool idGameLocal::SpawnEntityDef( const idDict& args, idEntity** ent, bool setDe
 	
 	spawnArgs.SetDefaults( &def->dict );
 	
-	if( !spawnArgs.FindKey( "slowmo" ) )
+	if( !spawnArgs.FindKey( key_slowmo ) )
 	{
 		bool slowmo = true;
 		
@@ -3799,7 +3805,7 @@ bool idGameLocal::SpawnEntityDef( const idDict& args, idEntity** ent, bool setDe
 	}
 	
 	// check if we should spawn a class object
-	spawnArgs.GetString( "spawnclass", NULL, &spawn );
+	spawnArgs.GetString( key_spawnclass, NULL, &spawn );
 	if( spawn )
 	{
 	
@@ -3828,7 +3834,7 @@ bool idGameLocal::SpawnEntityDef( const idDict& args, idEntity** ent, bool setDe
 	}
 	
 	// check if we should call a script function to spawn
-	spawnArgs.GetString( "spawnfunc", NULL, &spawn );
+	spawnArgs.GetString( key_spawnfunc, NULL, &spawn );
 	if( spawn )
 	{
 		const function_t* func = program.FindFunction( spawn );
@@ -4022,7 +4028,7 @@ void idGameLocal::AddEntityToHash( const char* name, idEntity* ent )
 	{
 		Error( "Multiple entities named '%s'", name );
 	}
-	entityHash.Add( entityHash.GenerateKey( name, true ), ent->entityNumber );
+	entityHash.Set( name, ent->entityNumber );
 }
 
 /*
@@ -4032,16 +4038,11 @@ idGameLocal::RemoveEntityFromHash
 */
 bool idGameLocal::RemoveEntityFromHash( const char* name, idEntity* ent )
 {
-	int hash, i;
-	
-	hash = entityHash.GenerateKey( name, true );
-	for( i = entityHash.First( hash ); i != -1; i = entityHash.Next( i ) )
+	const int* entityNumber = entityHash.Find( name );
+	if( entityNumber != NULL && entities[*entityNumber] == ent )
 	{
-		if( entities[i] && entities[i] == ent && entities[i]->name.Icmp( name ) == 0 )
-		{
-			entityHash.Remove( hash, i );
-			return true;
-		}
+		entityHash.Remove( name );
+		return true;
 	}
 	return false;
 }
@@ -4132,15 +4133,10 @@ Returns the entity whose name matches the specified string.
 */
 idEntity* idGameLocal::FindEntity( const char* name ) const
 {
-	int hash, i;
-	
-	hash = entityHash.GenerateKey( name, true );
-	for( i = entityHash.First( hash ); i != -1; i = entityHash.Next( i ) )
+	const int* entityNumber = entityHash.Find( name );
+	if( entityNumber != NULL )
 	{
-		if( entities[i] && entities[i]->name.Icmp( name ) == 0 )
-		{
-			return entities[i];
-		}
+		return entities[*entityNumber];
 	}
 	
 	return NULL;
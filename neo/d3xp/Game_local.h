@@ -299,7 +299,7 @@ public:
 	int						spawnIds[MAX_GENTITIES];// for use in idEntityPtr
 	idArray< int, 2 >		firstFreeEntityIndex;	// first free index in the entities array. [0] for replicated entities, [1] for non-replicated
 	int						num_entities;			// current number <= MAX_GENTITIES
-	idHashIndex				entityHash;				// hash table to quickly find entities by name
+	idHashMap<idStr, int>	entityHash;				// entity numbers by name to quickly find entities
 	idWorldspawn* 			world;					// world entity
 	idLinkList<idEntity>	spawnedEntities;		// all spawned entities
 	idLinkList<idEntity>	activeEntities;			// all thinking entities (idEntity::thinkFlags != 0)
@@ -849,6 +849,76 @@ CONSOLE_COMMAND( finishBuild, "finishes the build process", NULL )
 	globalImages->FinishBuild( ( args.Argc() > 1 ) );
 }
 
+/*
+=================
+Com_BakeAssets_f
+=================
+*/
+CONSOLE_COMMAND( bakeAssets, "rebuilds the out of date generated images, models and sounds of the preload manifests", NULL )
+{
+	if( fileSystem->InProductionMode() )
+	{
+		common->Printf( "bakeAssets can't be used in production mode\n" );
+		return;
+	}
+	
+	idStrList manifestNames;
+	if( args.Argc() > 1 )
+	{
+		manifestNames.Append( args.Argv( 1 ) );
+	}
+	else
+	{
+		manifestNames.Append( "_common.preload" );
+		idFileList* files = fileSystem->ListFiles( "maps", ".preload", true, true );
+		for( int i = 0; i < files->GetNumFiles(); i++ )
+		{
+			manifestNames.Append( files->GetFile( i ) );
+		}
+		fileSystem->FreeFileList( files );
+	}
+	
+	// merge the manifests so shared resources are only baked once
+	idPreloadManifest manifest;
+	for( int i = 0; i < manifestNames.Num(); i++ )
+	{
+		idPreloadManifest mapManifest;
+		if( !mapManifest.LoadManifest( manifestNames[i] ) )
+		{
+			common->Warning( "couldn't load preload manifest '%s'", manifestNames[i].c_str() );
+			continue;
+		}
+		for( int j = 0; j < mapManifest.NumResources(); j++ )
+		{
+			const preloadEntry_s& p = mapManifest.GetPreloadByIndex( j );
+			switch( p.resType )
+			{
+				case PRELOAD_IMAGE:
+					manifest.AddImage( p.resourceName, p.imgData.filter, p.imgData.repeat, p.imgData.usage, p.imgData.cubeMap );
+					break;
+				case PRELOAD_MODEL:
+					manifest.AddModel( p.resourceName );
+					break;
+				case PRELOAD_SAMPLE:
+					manifest.AddSample( p.resourceName );
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	
+	const int start = Sys_Milliseconds();
+	
+	bakeStats_t stats;
+	renderSystem->Bake( manifest, stats );
+	soundSystem->Bake( manifest, stats );
+	bakeCache.Save();
+	
+	const int end = Sys_Milliseconds();
+	common->Printf( "%d baked, %d up to date, %d failed in %5.1f seconds\n", stats.baked, stats.upToDate, stats.failed, ( end - start ) * 0.001f );
+}
+
 /*
 =================
 idCommonLocal::RenderSplash
@@ -1234,15 +1304,15 @@ void idCommonLocal::Init( int argc, const char* const* argv, const char* cmdline
 		
 		fileSystem->BeginLevelLoad( "_startup", saveFile.GetDataPtr(), saveFile.GetAllocated() );
 		
+		// init the parallel job manager, the decl files are scanned in jobs
+		parallelJobManager->Init();
+		
 		// initialize the declaration manager
 		declManager->Init();
 		
 		// init journalling, etc
 		eventLoop->Init();
 		
-		// init the parallel job manager
-		parallelJobManager->Init();
-		
 		// exec the startup scripts
 		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "exec default.cfg\n" );
 		
@@ -1554,6 +1624,9 @@ void idCommonLocal::Shutdown()
 	printf( "renderSystem->Shutdown();\n" );
 	renderSystem->Shutdown();
 	
+	printf( "bakeCache.Save();\n" );
+	bakeCache.Save();
+	
 	printf( "commonDialog.Shutdown();\n" );
 	commonDialog.Shutdown();
 	
@@ -2044,6 +2117,10 @@ CONSOLE_COMMAND( testSIMD, "test SIMD code", NULL )
 {
 	idSIMD::Test_f( args );
 }
+CONSOLE_COMMAND( testHashMap, "compares idHashMap with idHashIndex, usage: testHashMap [numKeys]", NULL )
+{
+	idHashMapBase::Test_f( args );
+}
 
 // RB begin
 CONSOLE_COMMAND( testFormattingSizes, "test printf format security", 0 )
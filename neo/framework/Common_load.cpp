@@ -506,6 +506,7 @@ void idCommonLocal::ExecuteMapChange()
 		manifestName += ".preload";
 		idPreloadManifest manifest;
 		manifest.LoadManifest( manifestName );
+		declManager->Preload( manifest );
 		renderSystem->Preload( manifest, currentMapName );
 		soundSystem->Preload( manifest );
 		game->Preload( manifest );
@@ -609,6 +610,7 @@ void idCommonLocal::ExecuteMapChange()
 	declManager->EndLevelLoad();
 	uiManager->EndLevelLoad( currentMapName );
 	fileSystem->EndLevelLoad();
+	bakeCache.Save();
 	
 	if( !mapSpawnData.savegameFile && !IsMultiplayer() )
 	{
@@ -793,6 +795,12 @@ void idCommonLocal::LoadPacifierBinarizeFilename( const char* filename, const ch
 {
 	idLib::Printf( "Binarize File: '%s' - reason '%s'\n", filename, reason );
 	
+	// images are also binarized in jobs, only the main thread drives the pacifier
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
+	
 	// we won't actually show updates on very quick files (<16ms), so keep this false until the first progress
 	loadPacifierBinarizeActive = false;
 	loadPacifierBinarizeFilename = filename;
@@ -805,11 +813,19 @@ void idCommonLocal::LoadPacifierBinarizeFilename( const char* filename, const ch
 
 void idCommonLocal::LoadPacifierBinarizeInfo( const char* info )
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	loadPacifierBinarizeInfo = info;
 }
 
 void idCommonLocal::LoadPacifierBinarizeMiplevel( int level, int maxLevel )
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	loadPacifierBinarizeMiplevel = level;
 	loadPacifierBinarizeMiplevelTotal = maxLevel;
 }
@@ -817,6 +833,10 @@ void idCommonLocal::LoadPacifierBinarizeMiplevel( int level, int maxLevel )
 // foresthale 2014-05-30: loading progress pacifier for binarize operations only
 void idCommonLocal::LoadPacifierBinarizeProgress( float progress )
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	static int lastUpdateTime = 0;
 	int time = Sys_Milliseconds();
 	if( progress == 0.0f )
@@ -841,6 +861,10 @@ void idCommonLocal::LoadPacifierBinarizeProgress( float progress )
 // foresthale 2014-05-30: loading progress pacifier for binarize operations only
 void idCommonLocal::LoadPacifierBinarizeEnd()
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	loadPacifierBinarizeActive = false;
 	loadPacifierBinarizeStartTime = 0;
 	loadPacifierBinarizeProgress = 0.0f;
@@ -855,6 +879,10 @@ void idCommonLocal::LoadPacifierBinarizeEnd()
 // foresthale 2014-05-30: loading progress pacifier for binarize operations only
 void idCommonLocal::LoadPacifierBinarizeProgressTotal( int total )
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	loadPacifierBinarizeProgressTotal = total;
 	loadPacifierBinarizeProgressCurrent = 0;
 }
@@ -862,6 +890,10 @@ void idCommonLocal::LoadPacifierBinarizeProgressTotal( int total )
 // foresthale 2014-05-30: loading progress pacifier for binarize operations only
 void idCommonLocal::LoadPacifierBinarizeProgressIncrement( int step )
 {
+	if( !idLib::IsMainThread() )
+	{
+		return;
+	}
 	loadPacifierBinarizeProgressCurrent += step;
 	LoadPacifierBinarizeProgress( ( float )loadPacifierBinarizeProgressCurrent / loadPacifierBinarizeProgressTotal );
 }
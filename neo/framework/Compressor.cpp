@@ -819,7 +819,8 @@ int idCompressor_RunLength::Read( void* outData, int outLength )
 		}
 	}
 	
-	return writeByte;
+	// the loop above decodes the padding of the last word past the end of the output as well
+	return Min( writeByte, writeLength );
 }
 
 
@@ -916,7 +917,8 @@ int idCompressor_RunLength_ZeroBased::Read( void* outData, int outLength )
 		}
 	}
 	
-	return writeByte;
+	// the loop above decodes the padding of the last word past the end of the output as well
+	return Min( writeByte, writeLength );
 }
 
 
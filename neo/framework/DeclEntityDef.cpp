@@ -48,6 +48,9 @@ idDeclEntityDef::FreeData
 void idDeclEntityDef::FreeData()
 {
 	dict.Clear();
+	textKeys.Clear();
+	textValues.Clear();
+	textEndLine = 0;
 }
 
 /*
@@ -56,9 +59,38 @@ idDeclEntityDef::Parse
 ================
 */
 bool idDeclEntityDef::Parse( const char* text, const int textLength, bool allowBinaryVersion )
+{
+	if( !ParseText( text, textLength ) )
+	{
+		MakeDefault();
+		return false;
+	}
+	return ParseLinks();
+}
+
+/*
+================
+idDeclEntityDef::CanParseInParallel
+================
+*/
+bool idDeclEntityDef::CanParseInParallel() const
+{
+	return true;
+}
+
+/*
+================
+idDeclEntityDef::ParseText
+================
+*/
+bool idDeclEntityDef::ParseText( const char* text, const int textLength )
 {
 	idLexer src;
 	idToken	token, token2;
+	idHashIndex keyHash;
+	
+	textKeys.Clear();
+	textValues.Clear();
 	
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
@@ -78,23 +110,54 @@ bool idDeclEntityDef::Parse( const char* text, const int textLength, bool allowB
 		if( token.type != TT_STRING )
 		{
 			src.Warning( "Expected quoted string, but found '%s'", token.c_str() );
-			MakeDefault();
 			return false;
 		}
 		
 		if( !src.ReadToken( &token2 ) )
 		{
 			src.Warning( "Unexpected end of file" );
-			MakeDefault();
 			return false;
 		}
 		
-		if( dict.FindKey( token ) )
+		const int hash = keyHash.GenerateKey( token, false );
+		int i;
+		for( i = keyHash.First( hash ); i != -1; i = keyHash.Next( i ) )
+		{
+			if( textKeys[i].Icmp( token ) == 0 )
+			{
+				break;
+			}
+		}
+		if( i != -1 )
 		{
 			src.Warning( "'%s' already defined", token.c_str() );
 		}
-		dict.Set( token, token2 );
+		else
+		{
+			keyHash.Add( hash, textKeys.Num() );
+		}
+		textKeys.Append( token );
+		textValues.Append( token2 );
+	}
+	
+	textEndLine = src.GetLineNum();
+	
+	return true;
+}
+
+/*
+================
+idDeclEntityDef::ParseLinks
+================
+*/
+bool idDeclEntityDef::ParseLinks()
+{
+	for( int i = 0; i < textKeys.Num(); i++ )
+	{
+		dict.Set( textKeys[i], textValues[i] );
 	}
+	textKeys.Clear();
+	textValues.Clear();
 	
 	// we always automatically set a "classname" key to our name
 	dict.Set( "classname", GetName() );
@@ -118,7 +181,7 @@ bool idDeclEntityDef::Parse( const char* text, const int textLength, bool allowB
 		const idDeclEntityDef* copy = static_cast<const idDeclEntityDef*>( declManager->FindType( DECL_ENTITYDEF, kv->GetValue(), false ) );
 		if( !copy )
 		{
-			src.Warning( "Unknown entityDef '%s' inherited by '%s'", kv->GetValue().c_str(), GetName() );
+			common->Warning( "file %s, line %d: Unknown entityDef '%s' inherited by '%s'", GetFileName(), textEndLine, kv->GetValue().c_str(), GetName() );
 		}
 		else
 		{
@@ -45,8 +45,17 @@ public:
 	virtual size_t			Size() const;
 	virtual const char* 	DefaultDefinition() const;
 	virtual bool			Parse( const char* text, const int textLength, bool allowBinaryVersion );
+	virtual bool			CanParseInParallel() const;
+	virtual bool			ParseText( const char* text, const int textLength );
+	virtual bool			ParseLinks();
 	virtual void			FreeData();
 	virtual void			Print();
+	
+private:
+	// the key/value pairs read by ParseText, the global string pools of the dict aren't thread safe
+	idStrList				textKeys;
+	idStrList				textValues;
+	int						textEndLine;
 };
 
 #endif /* !__DECLENTITYDEF_H__ */
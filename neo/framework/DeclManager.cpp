@@ -126,6 +126,9 @@ protected:
 	// After calling parse, a decl will be guaranteed usable.
 	void						ParseLocal();
 	
+	// Resolves the links of a decl whose text was parsed in a job.
+	void						ParseLinksLocal();
+	
 	// Does a MakeDefualt, but flags the decl so that it
 	// will Parse() the next time the decl is found.
 	void						Purge();
@@ -154,9 +157,20 @@ private:
 	bool						referencedThisLevel;	// set to true when the decl is used for the current level
 	bool						redefinedInReload;		// used during file reloading to make sure a decl that has
 	// its source removed will be defaulted
+	bool						linksPending;			// the text was parsed in a job, but ParseLinks() wasn't run yet
 	idDeclLocal* 				nextInFile;				// next decl in the decl file
 };
 
+// a declaration found in the text of a decl file
+struct declSpan_t
+{
+	declType_t					type;
+	idStr						name;
+	int							offset;					// offset of the decl text in the file
+	int							length;					// length of the decl text
+	int							line;					// line of the declaration token
+};
+
 class idDeclFile
 {
 public:
@@ -166,6 +180,18 @@ public:
 	void						Reload( bool force );
 	int							LoadAndParse();
 	
+	// the steps of LoadAndParse, only ScanText may run in a job
+	char* 						LoadText( int& length, const struct declCacheFile_t*& cached );
+	void						ParseText( const char* buffer, int length );
+	bool						ScanText( idLexer& src, idList< declSpan_t >& spans ) const;
+	void						DefineText( const char* buffer, const idList< declSpan_t >& spans, int numTextLines, bool cacheable );
+	void						ParseCache( const struct declCacheFile_t& cached );
+	void						FinishLoad();
+	
+private:
+	bool						CanParseCache( const struct declCacheFile_t& cached ) const;
+	idDeclLocal* 				DefineDecl( declType_t type, const char* name, int sourceLine, bool& reparse );
+	
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -189,6 +215,7 @@ public:
 	virtual void				Reload( bool force );
 	virtual void				BeginLevelLoad();
 	virtual void				EndLevelLoad();
+	virtual void				Preload( const idPreloadManifest& manifest );
 	virtual void				RegisterDeclType( const char* typeName, declType_t type, idDecl * ( *allocator )() );
 	virtual void				RegisterDeclFolder( const char* folder, const char* extension, declType_t defaultType );
 	virtual int					GetChecksum() const;
@@ -245,7 +272,8 @@ private:
 	idList<idDeclFolder*, TAG_IDLIB_LIST_DECL>		declFolders;
 	
 	idList<idDeclFile*, TAG_IDLIB_LIST_DECL>		loadedFiles;
-	idHashIndex					hashTables[DECL_MAX_TYPES];
+	// the keys point to the names of the decls
+	idHashMap<const char*, idDeclLocal*, idHashMapTraitsNoCase >	hashTables[DECL_MAX_TYPES];
 	idList<idDeclLocal*, TAG_IDLIB_LIST_DECL>		linearLists[DECL_MAX_TYPES];
 	idDeclFile					implicitDecls;	// this holds all the decls that were created because explicit
 	// text definitions were not found. Decls that became default
@@ -255,8 +283,15 @@ private:
 	bool						insideLevelLoad;
 	
 	static idCVar				decl_show;
+	static idCVar				decl_parallelParse;
+	static idCVar				decl_parallelScan;
+	static idCVar				decl_cache;
 	
 private:
+	friend class idDeclFile;
+	
+	void						LoadFilesInJobs( const idList< idDeclFile* >& files );
+	
 	static void					ListDecls_f( const idCmdArgs& args );
 	static void					ReloadDecls_f( const idCmdArgs& args );
 	static void					TouchDecl_f( const idCmdArgs& args );
@@ -266,6 +301,9 @@ private:
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
+idCVar idDeclManagerLocal::decl_cache( "decl_cache", "1", CVAR_SYSTEM | CVAR_BOOL, "keep the scanned decl files in a binary cache so unchanged files are not scanned again" );
+idCVar idDeclManagerLocal::decl_parallelParse( "decl_parallelParse", "1", CVAR_SYSTEM | CVAR_BOOL, "parse the decls of the level preload manifest in jobs where the decl type allows it" );
+idCVar idDeclManagerLocal::decl_parallelScan( "decl_parallelScan", "1", CVAR_SYSTEM | CVAR_BOOL, "scan the files of a decl folder for their decls in jobs" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager* 		declManager = &declManagerLocal;
@@ -593,6 +631,268 @@ void ConvertPDAsToStrings_f( const idCmdArgs& args )
 	declManagerLocal.ConvertPDAsToStrings( args );
 }
 
+/*
+====================================================================================
+
+ binary decl cache
+
+ Keeps the decl boundaries and the compressed text of the decl files, so unchanged
+ files are neither scanned with the lexer nor compressed again on startup. A file is
+ taken from the cache if its timestamp or, failing that, the checksum of its content
+ is the one it was scanned with.
+
+====================================================================================
+*/
+
+static const char* DECL_CACHE_FILE = "generated/decls.cache";
+static const int DECL_CACHE_VERSION = 1;
+static const unsigned int DECL_CACHE_MAGIC = ( 'D' << 24 ) | ( 'C' << 16 ) | ( 'C' << 8 ) | DECL_CACHE_VERSION;
+
+#ifdef USE_COMPRESSED_DECLS
+static const int DECL_CACHE_COMPRESSED = 1;
+#else
+static const int DECL_CACHE_COMPRESSED = 0;
+#endif
+
+struct declCacheFile_t
+{
+	idStr						fileName;
+	ID_TIME_T					timestamp;
+	int							fileSize;
+	int							checksum;
+	int							numLines;
+	int							numDecls;
+	idList< byte >				decls;			// type name, name, source location and compressed text of each decl
+};
+
+class idDeclCache
+{
+public:
+	idDeclCache();
+	
+	declCacheFile_t* 			FindFile( const char* fileName );
+	declCacheFile_t* 			AllocFile( const char* fileName );
+	void						FreeFile( const char* fileName );
+	void						SetDirty()
+	{
+		dirty = true;
+	}
+	void						Save();
+	void						Clear();
+	
+private:
+	void						Load();
+	int							FindFileIndex( const char* fileName ) const;
+	
+	idList< declCacheFile_t* >	files;
+	idHashIndex					fileHash;
+	bool						loaded;
+	bool						dirty;
+};
+
+static idDeclCache declCache;
+
+/*
+================
+idDeclCache::idDeclCache
+================
+*/
+idDeclCache::idDeclCache()
+{
+	loaded = false;
+	dirty = false;
+}
+
+/*
+================
+idDeclCache::Load
+
+The whole cache is read at once.
+================
+*/
+void idDeclCache::Load()
+{
+	if( loaded )
+	{
+		return;
+	}
+	loaded = true;
+	
+	idFileLocal file( fileSystem->OpenFileReadMemory( DECL_CACHE_FILE ) );
+	if( file == NULL )
+	{
+		return;
+	}
+	
+	unsigned int magic = 0;
+	int compressed = -1;
+	int numFiles = 0;
+	file->ReadBig( magic );
+	file->ReadBig( compressed );
+	file->ReadBig( numFiles );
+	if( magic != DECL_CACHE_MAGIC || compressed != DECL_CACHE_COMPRESSED )
+	{
+		return;
+	}
+	
+	for( int i = 0; i < numFiles; i++ )
+	{
+		declCacheFile_t* cached = new( TAG_DECL ) declCacheFile_t;
+		file->ReadString( cached->fileName );
+		file->ReadBig( cached->timestamp );
+		file->ReadBig( cached->fileSize );
+		file->ReadBig( cached->checksum );
+		file->ReadBig( cached->numLines );
+		file->ReadBig( cached->numDecls );
+		int length = 0;
+		file->ReadBig( length );
+		if( length < 0 || file->Tell() + length > file->Length() )
+		{
+			delete cached;
+			break;
+		}
+		cached->decls.SetNum( length );
+		file->Read( cached->decls.Ptr(), length );
+		fileHash.Add( fileHash.GenerateKey( cached->fileName, false ), files.Append( cached ) );
+	}
+}
+
+/*
+================
+idDeclCache::Save
+================
+*/
+void idDeclCache::Save()
+{
+	if( !dirty || fileSystem->InProductionMode() )
+	{
+		return;
+	}
+	dirty = false;
+	
+	idFileLocal file( fileSystem->OpenFileWrite( DECL_CACHE_FILE, "fs_basepath" ) );
+	if( file == NULL )
+	{
+		idLib::Warning( "idDeclCache: Could not open file '%s'", DECL_CACHE_FILE );
+		return;
+	}
+	
+	int numFiles = 0;
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		numFiles += ( files[i] != NULL );
+	}
+	
+	file->WriteBig( DECL_CACHE_MAGIC );
+	file->WriteBig( DECL_CACHE_COMPRESSED );
+	file->WriteBig( numFiles );
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		const declCacheFile_t* cached = files[i];
+		if( cached == NULL )
+		{
+			continue;
+		}
+		file->WriteString( cached->fileName );
+		file->WriteBig( cached->timestamp );
+		file->WriteBig( cached->fileSize );
+		file->WriteBig( cached->checksum );
+		file->WriteBig( cached->numLines );
+		file->WriteBig( cached->numDecls );
+		file->WriteBig( cached->decls.Num() );
+		file->Write( cached->decls.Ptr(), cached->decls.Num() );
+	}
+}
+
+/*
+================
+idDeclCache::Clear
+================
+*/
+void idDeclCache::Clear()
+{
+	files.DeleteContents( true );
+	fileHash.Free();
+	loaded = false;
+	dirty = false;
+}
+
+/*
+================
+idDeclCache::FindFileIndex
+================
+*/
+int idDeclCache::FindFileIndex( const char* fileName ) const
+{
+	const int key = fileHash.GenerateKey( fileName, false );
+	for( int i = fileHash.First( key ); i != -1; i = fileHash.Next( i ) )
+	{
+		if( files[i] != NULL && files[i]->fileName.Icmp( fileName ) == 0 )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+idDeclCache::FindFile
+================
+*/
+declCacheFile_t* idDeclCache::FindFile( const char* fileName )
+{
+	Load();
+	const int index = FindFileIndex( fileName );
+	return ( index != -1 ) ? files[index] : NULL;
+}
+
+/*
+================
+idDeclCache::AllocFile
+
+Returns an empty entry for the file.
+================
+*/
+declCacheFile_t* idDeclCache::AllocFile( const char* fileName )
+{
+	Load();
+	dirty = true;
+	
+	const int index = FindFileIndex( fileName );
+	if( index != -1 )
+	{
+		files[index]->decls.Clear();
+		files[index]->numDecls = 0;
+		return files[index];
+	}
+	
+	declCacheFile_t* cached = new( TAG_DECL ) declCacheFile_t;
+	cached->fileName = fileName;
+	cached->numDecls = 0;
+	fileHash.Add( fileHash.GenerateKey( cached->fileName, false ), files.Append( cached ) );
+	return cached;
+}
+
+/*
+================
+idDeclCache::FreeFile
+================
+*/
+void idDeclCache::FreeFile( const char* fileName )
+{
+	Load();
+	
+	const int index = FindFileIndex( fileName );
+	if( index != -1 )
+	{
+		// keep the indexes in the hash valid
+		delete files[index];
+		files[index] = NULL;
+		dirty = true;
+	}
+}
+
 /*
 ====================================================================================
 
@@ -660,53 +960,92 @@ void idDeclFile::Reload( bool force )
 
 /*
 ================
-idDeclFile::LoadAndParse
+idDeclFile::DefineDecl
 
-This is used during both the initial load, and any reloads
+Finds or creates the decl for a definition in this file. Returns NULL if the decl
+was already defined elsewhere. reparse is set if the decl is currently in use.
 ================
 */
-int c_savedMemory = 0;
-
-int idDeclFile::LoadAndParse()
+idDeclLocal* idDeclFile::DefineDecl( declType_t type, const char* name, int sourceLine, bool& reparse )
 {
-	int			i, numTypes;
-	idLexer		src;
-	idToken		token;
-	int			startMarker;
-	char* 		buffer;
-	int			length, size;
-	int			sourceLine;
-	idStr		name;
-	idDeclLocal* newDecl;
-	bool		reparse;
-	
-	// load the text
-	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
-	length = fileSystem->ReadFile( fileName, ( void** )&buffer, &timestamp );
-	if( length == -1 )
+	// look it up, possibly getting a newly created default decl
+	reparse = false;
+	idDeclLocal* newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, false );
+	if( newDecl )
 	{
-		common->FatalError( "couldn't load %s", fileName.c_str() );
-		return 0;
+		// update the existing copy
+		if( newDecl->sourceFile != this || newDecl->redefinedInReload )
+		{
+			common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), sourceLine, declManagerLocal.GetDeclNameFromType( type ),
+							 name, newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+			return NULL;
+		}
+		if( newDecl->declState != DS_UNPARSED )
+		{
+			reparse = true;
+		}
+	}
+	else
+	{
+		// allow it to be created as a default, then add it to the per-file list
+		newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, true );
+		newDecl->nextInFile = this->decls;
+		this->decls = newDecl;
 	}
 	
-	if( !src.LoadMemory( buffer, length, fileName ) )
+	newDecl->redefinedInReload = true;
+	
+	if( newDecl->textSource )
 	{
-		common->Error( "Couldn't parse %s", fileName.c_str() );
-		Mem_Free( buffer );
-		return 0;
+		Mem_Free( newDecl->textSource );
+		newDecl->textSource = NULL;
 	}
 	
-	// mark all the defs that were from the last reload of this file
-	for( idDeclLocal* decl = decls; decl; decl = decl->nextInFile )
+	return newDecl;
+}
+
+/*
+================
+idDeclFile::ParseText
+
+Scans the text for the individual declarations and defines them.
+================
+*/
+void idDeclFile::ParseText( const char* buffer, int length )
+{
+	idLexer src;
+	
+	if( !src.LoadMemory( buffer, length, fileName ) )
 	{
-		decl->redefinedInReload = false;
+		common->Error( "Couldn't parse %s", fileName.c_str() );
+		return;
 	}
 	
 	src.SetFlags( DECL_LEXER_FLAGS );
 	
-	checksum = MD5_BlockChecksum( buffer, length );
+	idList< declSpan_t > spans;
+	const bool cacheable = ScanText( src, spans );
+	DefineText( buffer, spans, src.GetLineNum(), cacheable );
+}
+
+/*
+================
+idDeclFile::ScanText
+
+Finds the individual declarations in the text without defining them, so it can run in a job.
+Returns false if there were errors, which should show up again on the next load instead of
+being hidden by the decl cache.
+================
+*/
+bool idDeclFile::ScanText( idLexer& src, idList< declSpan_t >& spans ) const
+{
+	int			i, numTypes;
+	idToken		token;
+	int			startMarker;
+	int			sourceLine;
+	idStr		name;
 	
-	fileSize = length;
+	bool cacheable = true;
 	
 	// scan through, identifying each individual declaration
 	while( 1 )
@@ -744,6 +1083,7 @@ int idDeclFile::LoadAndParse()
 				// if we ever see an open brace, we somehow missed the [type] <name> prefix
 				src.Warning( "Missing decl name" );
 				src.SkipBracedSection( false );
+				cacheable = false;
 				continue;
 				
 			}
@@ -753,6 +1093,7 @@ int idDeclFile::LoadAndParse()
 				if( defaultType == DECL_MAX_TYPES )
 				{
 					src.Warning( "No type" );
+					cacheable = false;
 					continue;
 				}
 				src.UnreadToken( &token );
@@ -765,6 +1106,7 @@ int idDeclFile::LoadAndParse()
 		if( !src.ReadToken( &token ) )
 		{
 			src.Warning( "Type without definition at end of file" );
+			cacheable = false;
 			break;
 		}
 		
@@ -773,6 +1115,7 @@ int idDeclFile::LoadAndParse()
 			// if we ever see an open brace, we somehow missed the [type] <name> prefix
 			src.Warning( "Missing decl name" );
 			src.SkipBracedSection( false );
+			cacheable = false;
 			continue;
 		}
 		
@@ -789,56 +1132,186 @@ int idDeclFile::LoadAndParse()
 		if( !src.ReadToken( &token ) )
 		{
 			src.Warning( "Type without definition at end of file" );
+			cacheable = false;
 			break;
 		}
 		if( token != "{" )
 		{
 			src.Warning( "Expecting '{' but found '%s'", token.c_str() );
+			cacheable = false;
 			continue;
 		}
 		src.UnreadToken( &token );
 		
 		// now take everything until a matched closing brace
 		src.SkipBracedSection();
-		size = src.GetFileOffset() - startMarker;
 		
-		// look it up, possibly getting a newly created default decl
-		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
-		if( newDecl )
+		declSpan_t& span = spans.Alloc();
+		span.type = identifiedType;
+		span.name = name;
+		span.offset = startMarker;
+		span.length = src.GetFileOffset() - startMarker;
+		span.line = sourceLine;
+	}
+	
+	return cacheable;
+}
+
+/*
+================
+idDeclFile::DefineText
+
+Defines the decls found by ScanText. The result is kept in the decl cache if the text
+was cacheable.
+================
+*/
+void idDeclFile::DefineText( const char* buffer, const idList< declSpan_t >& spans, int numTextLines, bool cacheable )
+{
+	idFile_Memory cacheFile( "declCache" );
+	int numCachedDecls = 0;
+	
+	for( int i = 0; i < spans.Num(); i++ )
+	{
+		const declSpan_t& span = spans[i];
+		
+		bool reparse;
+		idDeclLocal* newDecl = DefineDecl( span.type, span.name, span.line, reparse );
+		if( newDecl == NULL )
 		{
-			// update the existing copy
-			if( newDecl->sourceFile != this || newDecl->redefinedInReload )
-			{
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-							 name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
-				continue;
-			}
-			if( newDecl->declState != DS_UNPARSED )
-			{
-				reparse = true;
-			}
+			continue;
 		}
-		else
+		
+		newDecl->SetTextLocal( buffer + span.offset, span.length );
+		newDecl->sourceFile = this;
+		newDecl->sourceTextOffset = span.offset;
+		newDecl->sourceTextLength = span.length;
+		newDecl->sourceLine = span.line;
+		newDecl->declState = DS_UNPARSED;
+		
+		if( cacheable )
 		{
-			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
-			newDecl->nextInFile = this->decls;
-			this->decls = newDecl;
+			cacheFile.WriteString( declManagerLocal.GetDeclNameFromType( span.type ) );
+			cacheFile.WriteString( span.name );
+			cacheFile.WriteBig( span.offset );
+			cacheFile.WriteBig( span.length );
+			cacheFile.WriteBig( span.line );
+			cacheFile.WriteBig( newDecl->textLength );
+			cacheFile.WriteBig( newDecl->compressedLength );
+			cacheFile.WriteBig( newDecl->checksum );
+			cacheFile.Write( newDecl->textSource, newDecl->compressedLength );
+			numCachedDecls++;
 		}
 		
-		newDecl->redefinedInReload = true;
+		// if it is currently in use, reparse it immedaitely
+		if( reparse )
+		{
+			newDecl->ParseLocal();
+		}
+	}
+	
+	numLines = numTextLines;
+	
+	if( !idDeclManagerLocal::decl_cache.GetBool() )
+	{
+		return;
+	}
+	if( !cacheable )
+	{
+		declCache.FreeFile( fileName );
+		return;
+	}
+	
+	declCacheFile_t* cached = declCache.AllocFile( fileName );
+	cached->timestamp = timestamp;
+	cached->fileSize = fileSize;
+	cached->checksum = checksum;
+	cached->numLines = numLines;
+	cached->numDecls = numCachedDecls;
+	cached->decls.SetNum( cacheFile.Length() );
+	memcpy( cached->decls.Ptr(), cacheFile.GetDataPtr(), cacheFile.Length() );
+}
+
+/*
+================
+idDeclFile::CanParseCache
+
+Returns false if a decl type of the cached file isn't registered anymore.
+================
+*/
+bool idDeclFile::CanParseCache( const declCacheFile_t& cached ) const
+{
+	idStr typeName;
+	idStr name;
+	int sourceTextOffset, sourceTextLength, sourceLine;
+	int textLength, compressedLength, textChecksum;
+	
+	idFile_Memory cacheFile( "declCache", ( const char* )cached.decls.Ptr(), cached.decls.Num() );
+	
+	for( int i = 0; i < cached.numDecls; i++ )
+	{
+		cacheFile.ReadString( typeName );
+		cacheFile.ReadString( name );
+		cacheFile.ReadBig( sourceTextOffset );
+		cacheFile.ReadBig( sourceTextLength );
+		cacheFile.ReadBig( sourceLine );
+		cacheFile.ReadBig( textLength );
+		cacheFile.ReadBig( compressedLength );
+		cacheFile.ReadBig( textChecksum );
+		if( declManagerLocal.GetDeclTypeFromName( typeName ) == DECL_MAX_TYPES || compressedLength < 0 || cacheFile.Seek( compressedLength, FS_SEEK_CUR ) != 0 )
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/*
+================
+idDeclFile::ParseCache
+
+Defines the decls the way ParseText did when the file was cached, CanParseCache has to be
+true for the cached file.
+================
+*/
+void idDeclFile::ParseCache( const declCacheFile_t& cached )
+{
+	idStr typeName;
+	idStr name;
+	int sourceTextOffset, sourceTextLength, sourceLine;
+	int textLength, compressedLength, textChecksum;
+	
+	idFile_Memory cacheFile( "declCache", ( const char* )cached.decls.Ptr(), cached.decls.Num() );
+	
+	for( int i = 0; i < cached.numDecls; i++ )
+	{
+		cacheFile.ReadString( typeName );
+		cacheFile.ReadString( name );
+		cacheFile.ReadBig( sourceTextOffset );
+		cacheFile.ReadBig( sourceTextLength );
+		cacheFile.ReadBig( sourceLine );
+		cacheFile.ReadBig( textLength );
+		cacheFile.ReadBig( compressedLength );
+		cacheFile.ReadBig( textChecksum );
+		const byte* compressed = cacheFile.ReadInPlace( compressedLength );
 		
-		if( newDecl->textSource )
+		bool reparse;
+		idDeclLocal* newDecl = DefineDecl( declManagerLocal.GetDeclTypeFromName( typeName ), name, sourceLine, reparse );
+		if( newDecl == NULL )
 		{
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
+			continue;
 		}
 		
-		newDecl->SetTextLocal( buffer + startMarker, size );
+		// same as SetTextLocal, without the compression
+		newDecl->textSource = ( char* )Mem_Alloc( compressedLength + 1, TAG_DECLTEXT );
+		memcpy( newDecl->textSource, compressed, compressedLength );
+		newDecl->textSource[compressedLength] = '\0';
+		newDecl->textLength = textLength;
+		newDecl->compressedLength = compressedLength;
+		newDecl->checksum = textChecksum;
 		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
+		newDecl->sourceTextOffset = sourceTextOffset;
+		newDecl->sourceTextLength = sourceTextLength;
 		newDecl->sourceLine = sourceLine;
 		newDecl->declState = DS_UNPARSED;
 		
@@ -849,10 +1322,85 @@ int idDeclFile::LoadAndParse()
 		}
 	}
 	
-	numLines = src.GetLineNum();
+	fileSize = cached.fileSize;
+	checksum = cached.checksum;
+	numLines = cached.numLines;
+}
+
+/*
+================
+idDeclFile::LoadText
+
+The first step of LoadAndParse. Returns the text that still has to be parsed and freed with
+Mem_Free, or NULL if the decls can be defined from the decl cache. The cached file is returned
+then, it isn't parsed here so the caller can define the decls of all files in file order.
+================
+*/
+char* idDeclFile::LoadText( int& length, const declCacheFile_t*& cachedFile )
+{
+	char* 		buffer;
+	
+	cachedFile = NULL;
+	
+	// mark all the defs that were from the last reload of this file
+	for( idDeclLocal* decl = decls; decl; decl = decl->nextInFile )
+	{
+		decl->redefinedInReload = false;
+	}
+	
+	// files with an unchanged timestamp aren't even read
+	declCacheFile_t* cached = NULL;
+	if( idDeclManagerLocal::decl_cache.GetBool() )
+	{
+		cached = declCache.FindFile( fileName );
+		if( cached != NULL )
+		{
+			const ID_TIME_T cachedTimestamp = fileSystem->GetTimestamp( fileName );
+			if( cachedTimestamp != FILE_NOT_FOUND_TIMESTAMP && cachedTimestamp == cached->timestamp && CanParseCache( *cached ) )
+			{
+				common->DPrintf( "...loading '%s' from the decl cache\n", fileName.c_str() );
+				timestamp = cachedTimestamp;
+				cachedFile = cached;
+				return NULL;
+			}
+		}
+	}
 	
-	Mem_Free( buffer );
+	// load the text
+	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
+	length = fileSystem->ReadFile( fileName, ( void** )&buffer, &timestamp );
+	if( length == -1 )
+	{
+		common->FatalError( "couldn't load %s", fileName.c_str() );
+		return NULL;
+	}
 	
+	checksum = MD5_BlockChecksum( buffer, length );
+	
+	fileSize = length;
+	
+	// the content may not have changed with the timestamp, like after copying the files
+	if( cached != NULL && cached->fileSize == fileSize && cached->checksum == checksum && CanParseCache( *cached ) )
+	{
+		cached->timestamp = timestamp;
+		declCache.SetDirty();
+		Mem_Free( buffer );
+		cachedFile = cached;
+		return NULL;
+	}
+	
+	return buffer;
+}
+
+/*
+================
+idDeclFile::FinishLoad
+
+The last step of LoadAndParse.
+================
+*/
+void idDeclFile::FinishLoad()
+{
 	// any defs that weren't redefinedInReload should now be defaulted
 	for( idDeclLocal* decl = decls ; decl ; decl = decl->nextInFile )
 	{
@@ -864,6 +1412,33 @@ int idDeclFile::LoadAndParse()
 			decl->sourceLine = decl->sourceFile->numLines;
 		}
 	}
+}
+
+/*
+================
+idDeclFile::LoadAndParse
+
+This is used during both the initial load, and any reloads
+================
+*/
+int c_savedMemory = 0;
+
+int idDeclFile::LoadAndParse()
+{
+	int length;
+	const declCacheFile_t* cached;
+	char* buffer = LoadText( length, cached );
+	if( buffer != NULL )
+	{
+		ParseText( buffer, length );
+		Mem_Free( buffer );
+	}
+	else if( cached != NULL )
+	{
+		ParseCache( *cached );
+	}
+	
+	FinishLoad();
 	
 	return checksum;
 }
@@ -1008,6 +1583,8 @@ void idDeclManagerLocal::Shutdown()
 	declTypes.DeleteContents( true );
 	declFolders.DeleteContents( true );
 	
+	declCache.Clear();
+	
 #ifdef USE_COMPRESSED_DECLS
 	ShutdownHuffman();
 #endif
@@ -1024,6 +1601,8 @@ void idDeclManagerLocal::Reload( bool force )
 	{
 		loadedFiles[i]->Reload( force );
 	}
+	
+	declCache.Save();
 }
 
 /*
@@ -1061,6 +1640,152 @@ void idDeclManagerLocal::EndLevelLoad()
 	// and sound sample manager will need to free media that was not referenced
 }
 
+struct declParse_t
+{
+	idDeclLocal* 	decl;
+	idDecl* 		self;
+	bool			parsed;
+};
+
+struct declParseJob_t
+{
+	declParse_t* 	parses;
+	int				numParses;
+};
+
+static const int DECL_PARSE_BATCH = 16;
+
+/*
+===================
+DeclParseTextJob
+===================
+*/
+static void DeclParseTextJob( declParseJob_t* job )
+{
+	for( int i = 0; i < job->numParses; i++ )
+	{
+		declParse_t& parse = job->parses[i];
+		
+		const int textLength = parse.decl->GetTextLength();
+		char* text = ( char* )Mem_Alloc( textLength + 1, TAG_DECLTEXT );
+		parse.decl->GetText( text );
+		parse.parsed = parse.self->ParseText( text, textLength );
+		Mem_Free( text );
+	}
+}
+
+REGISTER_PARALLEL_JOB( DeclParseTextJob, "DeclParseTextJob" );
+
+/*
+===================
+idDeclManagerLocal::Preload
+
+Parses the decls listed in the preload manifest. The text of the decls that can parse it on
+their own is parsed in jobs, which only write to their own decl, while the lock keeps other
+threads from finding the decls half parsed. The links are then resolved in manifest order;
+a decl that references one that wasn't resolved yet gets it resolved by FindType(), just like
+the decl would have been parsed by the first FindType() on the serial path. Everything else
+is parsed as FindType() would have.
+===================
+*/
+void idDeclManagerLocal::Preload( const idPreloadManifest& manifest )
+{
+	idScopedCriticalSection cs( mutex );
+	
+	const int start = Sys_Milliseconds();
+	
+	idList< idDeclLocal* > decls;
+	idList< declParse_t > parses;
+	for( int i = 0; i < manifest.NumResources(); i++ )
+	{
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
+		if( p.resType != PRELOAD_DECL )
+		{
+			continue;
+		}
+		const int colon = p.resourceName.Find( ':' );
+		if( colon <= 0 )
+		{
+			continue;
+		}
+		const idStr typeName = p.resourceName.Left( colon );
+		const declType_t type = GetDeclTypeFromName( typeName );
+		if( type == DECL_MAX_TYPES )
+		{
+			continue;
+		}
+		idDeclLocal* decl = FindTypeWithoutParsing( type, p.resourceName.c_str() + colon + 1, false );
+		if( decl == NULL || decl->declState != DS_UNPARSED || decl->textSource == NULL )
+		{
+			continue;
+		}
+		decl->AllocateSelf();
+		decls.Append( decl );
+		
+		if( !decl_parallelParse.GetBool() || !decl->self->CanParseInParallel() )
+		{
+			continue;
+		}
+		
+		// same as ParseLocal up to the actual parse
+		decl->self->FreeData();
+		MediaPrint( "parsing %s %s\n", declTypes[type]->typeName.c_str(), decl->name.c_str() );
+		decl->declState = DS_PARSED;
+		decl->linksPending = true;
+		
+		declParse_t& parse = parses.Alloc();
+		parse.decl = decl;
+		parse.self = decl->self;
+		parse.parsed = false;
+	}
+	
+	if( parses.Num() > 0 )
+	{
+		idList< declParseJob_t > jobs;
+		for( int i = 0; i < parses.Num(); i += DECL_PARSE_BATCH )
+		{
+			declParseJob_t& job = jobs.Alloc();
+			job.parses = &parses[i];
+			job.numParses = Min( DECL_PARSE_BATCH, parses.Num() - i );
+		}
+		
+		idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobs.Num(), 0, NULL );
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			jobList->AddJob( ( jobRun_t )DeclParseTextJob, &jobs[i] );
+		}
+		jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_THREADS );
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+		
+		// a failed parse would have defaulted the decl inside Parse()
+		for( int i = 0; i < parses.Num(); i++ )
+		{
+			if( !parses[i].parsed )
+			{
+				parses[i].decl->linksPending = false;
+				parses[i].decl->MakeDefault();
+			}
+		}
+	}
+	
+	for( int i = 0; i < decls.Num(); i++ )
+	{
+		idDeclLocal* decl = decls[i];
+		if( decl->declState == DS_UNPARSED )
+		{
+			decl->ParseLocal();
+		}
+		else if( decl->linksPending )
+		{
+			decl->ParseLinksLocal();
+		}
+	}
+	
+	const int end = Sys_Milliseconds();
+	common->Printf( "%5d decls preloaded, %d in parallel, in %d msec\n", decls.Num(), parses.Num(), end - start );
+}
+
 /*
 ===================
 idDeclManagerLocal::RegisterDeclType
@@ -1126,6 +1851,7 @@ void idDeclManagerLocal::RegisterDeclFolder( const char* folder, const char* ext
 	fileList = fileSystem->ListFiles( declFolder->folder, declFolder->extension, true );
 	
 	// load and parse decl files
+	idList< idDeclFile* > files;
 	for( i = 0; i < fileList->GetNumFiles(); i++ )
 	{
 		fileName = declFolder->folder + "/" + fileList->GetFile( i );
@@ -1147,10 +1873,105 @@ void idDeclManagerLocal::RegisterDeclFolder( const char* folder, const char* ext
 			df = new( TAG_DECL ) idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		files.Append( df );
 	}
 	
 	fileSystem->FreeFileList( fileList );
+	
+	if( decl_parallelScan.GetBool() )
+	{
+		LoadFilesInJobs( files );
+	}
+	else
+	{
+		for( i = 0; i < files.Num(); i++ )
+		{
+			files[i]->LoadAndParse();
+		}
+	}
+	
+	declCache.Save();
+}
+
+struct declScan_t
+{
+	char* 					buffer;
+	int						length;
+	const declCacheFile_t* 	cached;
+	idDeclFile* 			file;
+	idList< declSpan_t >	spans;
+	int						numLines;
+	bool					cacheable;
+	bool					hadError;
+};
+
+/*
+===================
+DeclScanText
+===================
+*/
+static void DeclScanText( idLexer& src, void* data )
+{
+	declScan_t* scan = ( declScan_t* )data;
+	scan->cacheable = scan->file->ScanText( src, scan->spans );
+	scan->numLines = src.GetLineNum();
+	scan->hadError = src.HadError();
+}
+
+/*
+===================
+idDeclManagerLocal::LoadFilesInJobs
+
+LoadAndParse for all the files, but the text of the files is scanned for the decls by an
+idLexerBatch. The decls of all files, from the decl cache or from the scanned text, are defined
+afterwards in file order, so a decl that is defined in several files still ends up in the first one. The lexer errors are fatal on the serial path,
+so a file with an error is parsed again on this thread to get the same result.
+===================
+*/
+void idDeclManagerLocal::LoadFilesInJobs( const idList< idDeclFile* >& files )
+{
+	idList< declScan_t > scans;
+	scans.SetNum( files.Num() );
+	
+	idLexerBatch batch;
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		declScan_t& scan = scans[i];
+		scan.file = files[i];
+		scan.buffer = files[i]->LoadText( scan.length, scan.cached );
+		scan.numLines = 0;
+		scan.cacheable = false;
+		scan.hadError = true;
+		if( scan.buffer != NULL )
+		{
+			batch.AddMemory( scan.buffer, scan.length, files[i]->fileName, &scan );
+		}
+	}
+	
+	// the errors are printed when the file is parsed again
+	batch.Run( DeclScanText, DECL_LEXER_FLAGS | LEXFL_NOERRORS, JOBLIST_PARALLELISM_MAX_THREADS );
+	
+	for( int i = 0; i < scans.Num(); i++ )
+	{
+		declScan_t& scan = scans[i];
+		if( scan.buffer != NULL )
+		{
+			if( scan.hadError )
+			{
+				scan.file->ParseText( scan.buffer, scan.length );
+			}
+			else
+			{
+				scan.file->DefineText( scan.buffer, scan.spans, scan.numLines, scan.cacheable );
+			}
+			Mem_Free( scan.buffer );
+		}
+		else if( scan.cached != NULL )
+		{
+			scan.file->ParseCache( *scan.cached );
+		}
+		scan.file->FinishLoad();
+	}
 }
 
 /*
@@ -1286,6 +2107,11 @@ const idDecl* idDeclManagerLocal::FindType( declType_t type, const char* name, b
 		}
 		decl->ParseLocal();
 	}
+	else if( decl->linksPending )
+	{
+		// Preload parsed the text, but hasn't gotten to this decl yet
+		decl->ParseLinksLocal();
+	}
 	
 	// mark it as referenced
 	decl->referencedThisLevel = true;
@@ -1330,6 +2156,8 @@ void idDeclManagerLocal::ReloadFile( const char* filename, bool force )
 			checksum ^= loadedFiles[i]->checksum;
 		}
 	}
+	
+	declCache.Save();
 }
 
 /*
@@ -1548,7 +2376,7 @@ idDeclManagerLocal::CreateNewDecl
 idDecl* idDeclManagerLocal::CreateNewDecl( declType_t type, const char* name, const char* _fileName )
 {
 	int typeIndex = ( int )type;
-	int i, hash;
+	int i;
 	
 	if( typeIndex < 0 || typeIndex >= declTypes.Num() || declTypes[typeIndex] == NULL || typeIndex >= DECL_MAX_TYPES )
 	{
@@ -1564,14 +2392,11 @@ idDecl* idDeclManagerLocal::CreateNewDecl( declType_t type, const char* name, co
 	fileName.BackSlashesToSlashes();
 	
 	// see if it already exists
-	hash = hashTables[typeIndex].GenerateKey( canonicalName, false );
-	for( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) )
+	idDeclLocal* const* existing = hashTables[typeIndex].Find( canonicalName );
+	if( existing != NULL )
 	{
-		if( linearLists[typeIndex][i]->name.Icmp( canonicalName ) == 0 )
-		{
-			linearLists[typeIndex][i]->AllocateSelf();
-			return linearLists[typeIndex][i]->self;
-		}
+		( *existing )->AllocateSelf();
+		return ( *existing )->self;
 	}
 	
 	idDeclFile* sourceFile;
@@ -1625,8 +2450,8 @@ idDecl* idDeclManagerLocal::CreateNewDecl( declType_t type, const char* name, co
 	sourceFile->decls = decl;
 	
 	// add it to the hash table and linear list
-	decl->index = linearLists[typeIndex].Num();
-	hashTables[typeIndex].Add( hash, linearLists[typeIndex].Append( decl ) );
+	decl->index = linearLists[typeIndex].Append( decl );
+	hashTables[typeIndex].Set( decl->name.c_str(), decl );
 	
 	return decl->self;
 }
@@ -1645,39 +2470,22 @@ bool idDeclManagerLocal::RenameDecl( declType_t type, const char* oldName, const
 	char canonicalNewName[MAX_STRING_CHARS];
 	MakeNameCanonical( newName, canonicalNewName, sizeof( canonicalNewName ) );
 	
-	idDeclLocal*	decl = NULL;
-	
 	// make sure it already exists
 	int typeIndex = ( int )type;
-	int i, hash;
-	hash = hashTables[typeIndex].GenerateKey( canonicalOldName, false );
-	for( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) )
+	idDeclLocal* decl = NULL;
+	if( !hashTables[typeIndex].Get( canonicalOldName, &decl ) )
 	{
-		if( linearLists[typeIndex][i]->name.Icmp( canonicalOldName ) == 0 )
-		{
-			decl = linearLists[typeIndex][i];
-			break;
-		}
-	}
-	if( !decl )
 		return false;
-		
-	//if ( !hashTables[(int)type].Get( canonicalOldName, &declPtr ) )
-	//	return false;
+	}
 	
-	//decl = *declPtr;
+	// the key points to the old name so remove it before changing the name
+	hashTables[typeIndex].Remove( canonicalOldName );
 	
 	//Change the name
 	decl->name = canonicalNewName;
 	
-	
 	// add it to the hash table
-	//hashTables[(int)decl->type].Set( decl->name, decl );
-	int newhash = hashTables[typeIndex].GenerateKey( canonicalNewName, false );
-	hashTables[typeIndex].Add( newhash, decl->index );
-	
-	//Remove the old hash item
-	hashTables[typeIndex].Remove( hash, decl->index );
+	hashTables[typeIndex].Set( decl->name.c_str(), decl );
 	
 	return true;
 }
@@ -2015,7 +2823,6 @@ This finds or creats the decl, but does not cause a parse.  This is only used in
 idDeclLocal* idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const char* name, bool makeDefault )
 {
 	int typeIndex = ( int )type;
-	int i, hash;
 	
 	if( typeIndex < 0 || typeIndex >= declTypes.Num() || declTypes[typeIndex] == NULL || typeIndex >= DECL_MAX_TYPES )
 	{
@@ -2028,18 +2835,15 @@ idDeclLocal* idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	MakeNameCanonical( name, canonicalName, sizeof( canonicalName ) );
 	
 	// see if it already exists
-	hash = hashTables[typeIndex].GenerateKey( canonicalName, false );
-	for( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) )
+	idDeclLocal* const* existing = hashTables[typeIndex].Find( canonicalName );
+	if( existing != NULL )
 	{
-		if( linearLists[typeIndex][i]->name.Icmp( canonicalName ) == 0 )
+		// only print these when decl_show is set to 2, because it can be a lot of clutter
+		if( decl_show.GetInteger() > 1 )
 		{
-			// only print these when decl_show is set to 2, because it can be a lot of clutter
-			if( decl_show.GetInteger() > 1 )
-			{
-				MediaPrint( "referencing %s %s\n", declTypes[ type ]->typeName.c_str(), name );
-			}
-			return linearLists[typeIndex][i];
+			MediaPrint( "referencing %s %s\n", declTypes[ type ]->typeName.c_str(), name );
 		}
+		return *existing;
 	}
 	
 	if( !makeDefault )
@@ -2060,8 +2864,8 @@ idDeclLocal* idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	decl->parsedOutsideLevelLoad = !insideLevelLoad;
 	
 	// add it to the linear list and hash table
-	decl->index = linearLists[typeIndex].Num();
-	hashTables[typeIndex].Add( hash, linearLists[typeIndex].Append( decl ) );
+	decl->index = linearLists[typeIndex].Append( decl );
+	hashTables[typeIndex].Set( decl->name.c_str(), decl );
 	
 	return decl;
 }
@@ -2282,6 +3086,7 @@ idDeclLocal::idDeclLocal()
 	referencedThisLevel = false;
 	everReferenced = false;
 	redefinedInReload = false;
+	linksPending = false;
 	nextInFile = NULL;
 }
 
@@ -2718,6 +3523,12 @@ void idDeclLocal::ParseLocal()
 	
 	declManagerLocal.MediaPrint( "parsing %s %s\n", declManagerLocal.declTypes[type]->typeName.c_str(), name.c_str() );
 	
+	// list the decl in the level preload manifest so it can be parsed in parallel
+	if( self->CanParseInParallel() && cvarSystem->GetCVarBool( "fs_buildresources" ) )
+	{
+		fileSystem->AddDeclPreload( declManagerLocal.declTypes[type]->typeName, name );
+	}
+	
 	// if no text source try to generate default text
 	if( textSource == NULL )
 	{
@@ -2753,6 +3564,20 @@ void idDeclLocal::ParseLocal()
 	declManagerLocal.indent--;
 }
 
+/*
+=================
+idDeclLocal::ParseLinksLocal
+=================
+*/
+void idDeclLocal::ParseLinksLocal()
+{
+	linksPending = false;
+	
+	declManagerLocal.indent++;
+	self->ParseLinks();
+	declManagerLocal.indent--;
+}
+
 /*
 =================
 idDeclLocal::Purge
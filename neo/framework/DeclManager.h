@@ -280,6 +280,24 @@ public:
 		return base->Parse( text, textLength, allowBinaryVersion );
 	}
 	
+	// Decls that can read their text without referencing other decls or media
+	// split Parse() into ParseText(), which the manager may issue from a job while
+	// it preloads a level, and ParseLinks(), which always runs on the main thread
+	// and does everything else. A failed ParseText() is followed by a MakeDefault()
+	// on the main thread. Together they must have the same result as Parse().
+	virtual bool			CanParseInParallel() const
+	{
+		return false;
+	}
+	virtual bool			ParseText( const char* text, const int textLength )
+	{
+		return false;
+	}
+	virtual bool			ParseLinks()
+	{
+		return true;
+	}
+	
 	// Frees any pointers held by the subclass. This may be called before
 	// any Parse(), so the constructor must have set sane values. The decl will be
 	// invalid after issuing this call, but it will always be immediately followed
@@ -326,6 +344,7 @@ ID_INLINE idDecl* idDeclAllocator()
 class idMaterial;
 class idDeclSkin;
 class idSoundShader;
+class idPreloadManifest;
 
 class idDeclManager
 {
@@ -340,6 +359,9 @@ public:
 	virtual void			BeginLevelLoad() = 0;
 	virtual void			EndLevelLoad() = 0;
 	
+	// Parses the decls listed in the preload manifest, in parallel where the decl type allows it.
+	virtual void			Preload( const idPreloadManifest& manifest ) = 0;
+	
 	// Registers a new decl type.
 	virtual void			RegisterDeclType( const char* typeName, declType_t type, idDecl * ( *allocator )() ) = 0;
 	
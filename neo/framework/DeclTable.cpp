@@ -123,6 +123,31 @@ idDeclTable::Parse
 =================
 */
 bool idDeclTable::Parse( const char* text, const int textLength, bool allowBinaryVersion )
+{
+	if( !ParseText( text, textLength ) )
+	{
+		MakeDefault();
+		return false;
+	}
+	return true;
+}
+
+/*
+=================
+idDeclTable::CanParseInParallel
+=================
+*/
+bool idDeclTable::CanParseInParallel() const
+{
+	return true;
+}
+
+/*
+=================
+idDeclTable::ParseText
+=================
+*/
+bool idDeclTable::ParseText( const char* text, const int textLength )
 {
 	idLexer src;
 	idToken token;
@@ -167,7 +192,6 @@ bool idDeclTable::Parse( const char* text, const int textLength, bool allowBinar
 				if( errorFlag )
 				{
 					// we got something non-numeric
-					MakeDefault();
 					return false;
 				}
 				
@@ -183,7 +207,6 @@ bool idDeclTable::Parse( const char* text, const int textLength, bool allowBinar
 					continue;
 				}
 				src.Warning( "expected comma or brace" );
-				MakeDefault();
 				return false;
 			}
 			
@@ -191,7 +214,6 @@ bool idDeclTable::Parse( const char* text, const int textLength, bool allowBinar
 		else
 		{
 			src.Warning( "unknown token '%s'", token.c_str() );
-			MakeDefault();
 			return false;
 		}
 	}
@@ -44,6 +44,8 @@ public:
 	virtual size_t			Size() const;
 	virtual const char* 	DefaultDefinition() const;
 	virtual bool			Parse( const char* text, const int textLength, bool allowBinaryVersion );
+	virtual bool			CanParseInParallel() const;
+	virtual bool			ParseText( const char* text, const int textLength );
 	virtual void			FreeData();
 	
 	float					TableLookup( float index ) const;
@@ -194,6 +194,16 @@ int idFile::Read( void* buffer, int len )
 	return 0;
 }
 
+/*
+=================
+idFile::ReadInPlace
+=================
+*/
+const byte* idFile::ReadInPlace( int len )
+{
+	return NULL;
+}
+
 /*
 =================
 idFile::Write
@@ -791,6 +801,22 @@ int idFile_Memory::Read( void* buffer, int len )
 	return len;
 }
 
+/*
+=================
+idFile_Memory::ReadInPlace
+=================
+*/
+const byte* idFile_Memory::ReadInPlace( int len )
+{
+	if( !( mode & ( 1 << FS_READ ) ) || curPtr + len > filePtr + fileSize )
+	{
+		return NULL;
+	}
+	const byte* data = ( const byte* )curPtr;
+	curPtr += len;
+	return data;
+}
+
 idCVar memcpyImpl( "memcpyImpl", "0", 0, "Which implementation of memcpy to use for idFile_Memory::Write() [0/1 - standard (1 eliminates branch misprediction), 2 - auto-vectorized]" );
 void* memcpy2( void* __restrict b, const void* __restrict a, size_t n )
 {
@@ -1938,6 +1964,24 @@ int idFile_InnerResource::Read( void* buffer, int len )
 	return read;
 }
 
+/*
+=================
+idFile_InnerResource::ReadInPlace
+
+Only possible if the whole file was read into the resource buffer
+=================
+*/
+const byte* idFile_InnerResource::ReadInPlace( int len )
+{
+	if( resourceBuffer == NULL || internalFilePos + len > length )
+	{
+		return NULL;
+	}
+	const byte* data = &resourceBuffer[ internalFilePos ];
+	internalFilePos += len;
+	return data;
+}
+
 /*
 =================
 idFile_InnerResource::Tell
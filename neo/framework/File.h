@@ -58,6 +58,9 @@ public:
 	virtual const char* 	GetFullPath() const;
 	// Read data from the file to the buffer.
 	virtual int				Read( void* buffer, int len );
+	// Returns the next len bytes and skips over them without copying if the file is in memory, otherwise NULL.
+	// The data stays valid until the file is closed.
+	virtual const byte* 	ReadInPlace( int len );
 	// Write data from the buffer to the file.
 	virtual int				Write( const void* buffer, int len );
 	// Returns the length of the file.
@@ -170,6 +173,7 @@ public:
 		return name.c_str();
 	}
 	virtual int				Read( void* buffer, int len );
+	virtual const byte* 	ReadInPlace( int len );
 	virtual int				Write( const void* buffer, int len );
 	virtual int				Length() const;
 	virtual void			SetLength( size_t len );
@@ -383,6 +387,7 @@ public:
 		return name.c_str();
 	}
 	virtual int				Read( void* buffer, int len );
+	virtual const byte* 	ReadInPlace( int len );
 	virtual int				Write( const void* buffer, int len )
 	{
 		assert( false );
@@ -190,6 +190,9 @@ public:
 	
 	virtual void			StartPreload( const idStrList& _preload );
 	virtual void			StopPreload();
+	virtual void			ReadAsync( fsAsyncRead_t* read );
+	virtual bool			WaitAsyncRead( fsAsyncRead_t* read );
+	virtual void			CancelAsyncRead( fsAsyncRead_t* read );
 	idFile* 				GetResourceFile( const char* fileName, bool memFile );
 	bool					GetResourceCacheEntry( const char* fileName, idResourceCacheEntry& rc );
 	virtual int				ReadFromBGL( idFile* _resourceFile, void* _buffer, int _offset, int _len );
@@ -223,6 +226,10 @@ public:
 	{
 		preloadList.AddParticle( resName );
 	}
+	virtual void			AddDeclPreload( const char* typeName, const char* resName )
+	{
+		preloadList.AddDecl( typeName, resName );
+	}
 	
 	static void				Dir_f( const idCmdArgs& args );
 	static void				DirTree_f( const idCmdArgs& args );
@@ -252,11 +259,33 @@ private:
 	static idCVar			fs_game_base;
 	static idCVar			fs_enableBGL;
 	static idCVar			fs_debugBGL;
+	static idCVar			fs_preloadMemory;
+	static idCVar			fs_preloadDropDistance;
 	
 	idStr					manifestName;
 	idStrList				fileManifest;
 	idPreloadManifest		preloadList;
 	
+	// resource files that are read ahead by the I/O thread between StartPreload and StopPreload
+	struct preloadFile_t
+	{
+		fsAsyncRead_t		read;
+		idStr				filename;
+		const byte* 		mapped;					// the file in a memory mapped container, paged in by the OS instead
+		bool				prefetched;
+		bool				claimed;
+	};
+	idFileReadThread		readThread;
+	idSysMutex				preloadMutex;
+	idList< preloadFile_t* > preloadFiles;
+	idHashIndex				preloadHash;
+	int						preloadNextQueued;		// next file that is queued with the I/O thread
+	int						preloadNextClaim;		// files before this one have been claimed or dropped
+	int						preloadLastClaim;		// furthest file that has been claimed
+	int						preloadBytes;			// memory of the queued and unclaimed files
+	int						preloadNumUsed;
+	int						preloadNumDropped;
+	
 	idList< idResourceContainer* > resourceFiles;
 	byte* 	resourceBufferPtr;
 	int		resourceBufferSize;
@@ -290,6 +319,12 @@ private:
 	void					RemoveResourceFile( const char* resourceFileName );
 	int						FindResourceFile( const char* resourceFileName );
 	
+	void					QueuePreloads();
+	void					DropPreload( preloadFile_t* preload );
+	int						FindPreload( const char* fileName ) const;
+	idFile* 				ClaimPreload( const char* fileName );
+	bool					IsStreamedContainer( const idResourceContainer* container ) const;
+	
 	void					SetupGameDirectories( const char* gameName );
 	void					Startup();
 	void					InitPrecache();
@@ -298,13 +333,17 @@ private:
 
 idCVar	idFileSystemLocal::fs_debug( "fs_debug", "0", CVAR_SYSTEM | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
 idCVar	idFileSystemLocal::fs_debugResources( "fs_debugResources", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
-idCVar	idFileSystemLocal::fs_enableBGL( "fs_enableBGL", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
-idCVar	idFileSystemLocal::fs_debugBGL( "fs_debugBGL", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
+idCVar	idFileSystemLocal::fs_enableBGL( "fs_enableBGL", "1", CVAR_SYSTEM | CVAR_BOOL, "read preloaded resource files ahead on the background I/O thread" );
+idCVar	idFileSystemLocal::fs_debugBGL( "fs_debugBGL", "0", CVAR_SYSTEM | CVAR_BOOL, "print statistics of the background I/O thread after each preload" );
+idCVar	idFileSystemLocal::fs_preloadMemory( "fs_preloadMemory", "64", CVAR_SYSTEM | CVAR_INTEGER, "megabytes of resource files that are read ahead of the loads", 1, 1024 );
+idCVar	idFileSystemLocal::fs_preloadDropDistance( "fs_preloadDropDistance", "128", CVAR_SYSTEM | CVAR_INTEGER, "read ahead files that fall this many files behind the furthest opened one are dropped", 0, 4096 );
 idCVar	idFileSystemLocal::fs_copyfiles( "fs_copyfiles", "0", CVAR_SYSTEM | CVAR_INIT | CVAR_BOOL, "Copy every file touched to fs_savepath" );
 idCVar	idFileSystemLocal::fs_buildResources( "fs_buildresources", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "Copy every file touched to a resource file" );
 idCVar	idFileSystemLocal::fs_game( "fs_game", "", CVAR_SYSTEM | CVAR_INIT | CVAR_SERVERINFO, "mod path" );
 idCVar  idFileSystemLocal::fs_game_base( "fs_game_base", "", CVAR_SYSTEM | CVAR_INIT | CVAR_SERVERINFO, "alternate mod path, searched after the main fs_game path, before the basedir" );
 
+extern idCVar fs_verifyResources;
+
 idCVar	fs_basepath( "fs_basepath", "", CVAR_SYSTEM | CVAR_INIT, "" );
 idCVar	fs_savepath( "fs_savepath", "", CVAR_SYSTEM | CVAR_INIT, "" );
 idCVar	fs_resourceLoadPriority( "fs_resourceLoadPriority", "0", CVAR_SYSTEM , "if 1, open requests will be honored from resource files first; if 0, the resource files are checked after normal search paths" );
@@ -316,10 +355,40 @@ idFileSystem* 		fileSystem = &fileSystemLocal;
 /*
 ================
 idFileSystemLocal::ReadFromBGL
+
+While a preload is running the resource containers are read by the I/O thread, so the read
+goes through the I/O thread as well instead of seeking the disk away from the preloads.
 ================
 */
 int idFileSystemLocal::ReadFromBGL( idFile* _resourceFile, void* _buffer, int _offset, int _len )
 {
+	preloadMutex.Lock();
+	const bool preloading = ( preloadNextClaim < preloadFiles.Num() );
+	preloadMutex.Unlock();
+	
+	if( fs_enableBGL.GetBool() && preloading )
+	{
+		for( int i = 0; i < resourceFiles.Num(); i++ )
+		{
+			if( resourceFiles[i]->resourceFile == _resourceFile && IsStreamedContainer( resourceFiles[i] ) )
+			{
+				fsAsyncRead_t read;
+				read.osPath = _resourceFile->GetFullPath();
+				read.offset = _offset;
+				read.length = _len;
+				read.buffer = _buffer;
+				read.priority = FS_READ_PRIORITY_HIGH;
+				readThread.Queue( &read );
+				readThread.Wait( &read );
+				if( read.GetState() == FS_READ_DONE || read.GetState() == FS_READ_FAILED )
+				{
+					return read.bytesRead;
+				}
+				break;
+			}
+		}
+	}
+	
 	if( _resourceFile->Tell() != _offset )
 	{
 		_resourceFile->Seek( _offset, FS_SEEK_SET );
@@ -327,22 +396,321 @@ int idFileSystemLocal::ReadFromBGL( idFile* _resourceFile, void* _buffer, int _o
 	return _resourceFile->Read( _buffer, _len );
 }
 
+/*
+================
+idFileSystemLocal::IsStreamedContainer
+
+The ordered startup container is read into memory as a whole and the other containers are
+usually memory mapped, the files are used straight out of memory then and there's nothing to stream.
+The preload only asks the OS to page in the mapped files ahead of the loads.
+================
+*/
+bool idFileSystemLocal::IsStreamedContainer( const idResourceContainer* container ) const
+{
+	return container->GetMappedData() == NULL && idStr::Icmp( container->GetFileName(), "_ordered.resources" ) != 0;
+}
+
 /*
 ================
 idFileSystemLocal::StartPreload
+
+Reads the given resource files ahead on the I/O thread, in the given order. The files should
+be sorted by their offset in the resource containers and loaded in roughly the same order, every
+file that is opened while the preload is running is taken from memory if it has been read ahead.
+Files in mapped containers are prefetched into the page cache instead. Files that are skipped by
+the loads are dropped once they fall fs_preloadDropDistance files behind the furthest opened one.
 ================
 */
 void idFileSystemLocal::StartPreload( const idStrList& _preload )
 {
+	StopPreload();
+	
+	if( !fs_enableBGL.GetBool() || resourceFiles.Num() == 0 )
+	{
+		return;
+	}
+	
+	idScopedCriticalSection lock( preloadMutex );
+	
+	preloadFiles.Resize( _preload.Num() );
+	preloadHash.ResizeIndex( _preload.Num() );
+	for( int i = 0; i < _preload.Num(); i++ )
+	{
+		idResourceCacheEntry rc;
+		if( !GetResourceCacheEntry( _preload[i], rc ) || rc.length <= 0 || rc.IsCompressed() )
+		{
+			continue;
+		}
+		idResourceContainer* container = resourceFiles[ rc.containerIndex ];
+		if( idStr::Icmp( container->GetFileName(), "_ordered.resources" ) == 0 )
+		{
+			continue;
+		}
+		if( FindPreload( rc.filename ) != -1 )
+		{
+			continue;
+		}
+		
+		preloadFile_t* preload = new( TAG_IDFILE ) preloadFile_t;
+		preload->filename = rc.filename;
+		preload->mapped = ( container->GetMappedData() != NULL ) ? container->GetMappedData() + rc.offset : NULL;
+		preload->prefetched = false;
+		preload->claimed = false;
+		preload->read.osPath = container->resourceFile->GetFullPath();
+		preload->read.offset = rc.offset;
+		preload->read.length = rc.length;
+		preload->read.priority = FS_READ_PRIORITY_NORMAL;
+		preloadHash.Add( preloadHash.GenerateKey( preload->filename, false ), preloadFiles.Append( preload ) );
+	}
+	
+	preloadNextQueued = 0;
+	preloadNextClaim = 0;
+	preloadLastClaim = 0;
+	preloadBytes = 0;
+	preloadNumUsed = 0;
+	preloadNumDropped = 0;
+	
+	QueuePreloads();
 }
 
 /*
 ================
 idFileSystemLocal::StopPreload
+
+Cancels the reads that are still queued and frees the files that were read but never opened.
+The loads must be done, a file that is being claimed on another thread is freed here as well.
 ================
 */
 void idFileSystemLocal::StopPreload()
 {
+	idScopedCriticalSection lock( preloadMutex );
+	
+	if( preloadFiles.Num() == 0 )
+	{
+		return;
+	}
+	
+	for( int i = preloadNextClaim; i < preloadFiles.Num(); i++ )
+	{
+		DropPreload( preloadFiles[i] );
+	}
+	
+	if( fs_debugBGL.GetBool() )
+	{
+		idLib::Printf( "preload: %d files, %d read ahead and used, %d dropped, %d never queued\n",
+					   preloadFiles.Num(), preloadNumUsed, preloadNumDropped, preloadFiles.Num() - preloadNextQueued );
+		readThread.PrintStats();
+	}
+	
+	preloadFiles.DeleteContents( true );
+	preloadHash.Clear();
+	preloadNextQueued = 0;
+	preloadNextClaim = 0;
+	preloadLastClaim = 0;
+	preloadBytes = 0;
+}
+
+/*
+================
+idFileSystemLocal::QueuePreloads
+
+Keeps the I/O thread busy up to the memory budget of the preload, at least one file is always
+in flight no matter how large it is.
+================
+*/
+void idFileSystemLocal::QueuePreloads()
+{
+	const int maxBytes = fs_preloadMemory.GetInteger() * 1024 * 1024;
+	if( preloadNextQueued < preloadNextClaim )
+	{
+		// the loads are ahead of the reads
+		preloadNextQueued = preloadNextClaim;
+	}
+	while( preloadNextQueued < preloadFiles.Num() )
+	{
+		preloadFile_t* preload = preloadFiles[ preloadNextQueued ];
+		if( preload->claimed )
+		{
+			// already opened before it was queued
+			preloadNextQueued++;
+			continue;
+		}
+		if( preloadBytes > 0 && preloadBytes + preload->read.length > maxBytes )
+		{
+			break;
+		}
+		preloadNextQueued++;
+		if( preload->mapped != NULL )
+		{
+			// counts against the budget as well so the page cache isn't flooded ahead of the loads
+			Sys_PrefetchMappedFile( preload->mapped, preload->read.length );
+			preload->prefetched = true;
+			preloadBytes += preload->read.length;
+			continue;
+		}
+		preload->read.buffer = Mem_Alloc( preload->read.length, TAG_TEMP );
+		preloadBytes += preload->read.length;
+		readThread.Queue( &preload->read );
+	}
+}
+
+/*
+================
+idFileSystemLocal::DropPreload
+================
+*/
+void idFileSystemLocal::DropPreload( preloadFile_t* preload )
+{
+	if( preload->prefetched )
+	{
+		preload->prefetched = false;
+		preloadBytes -= preload->read.length;
+		return;
+	}
+	if( preload->read.buffer == NULL )
+	{
+		return;
+	}
+	readThread.Cancel( &preload->read );
+	if( preload->read.GetState() == FS_READ_DONE )
+	{
+		preloadNumDropped++;
+	}
+	Mem_Free( preload->read.buffer );
+	preload->read.buffer = NULL;
+	preloadBytes -= preload->read.length;
+}
+
+/*
+================
+idFileSystemLocal::FindPreload
+================
+*/
+int idFileSystemLocal::FindPreload( const char* fileName ) const
+{
+	const int key = preloadHash.GenerateKey( fileName, false );
+	for( int index = preloadHash.First( key ); index != idHashIndex::NULL_INDEX; index = preloadHash.Next( index ) )
+	{
+		if( idStr::Icmp( preloadFiles[index]->filename, fileName ) == 0 )
+		{
+			return index;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+idFileSystemLocal::ClaimPreload
+
+Returns the file from memory if it's part of the running preload and it could be read,
+otherwise it's left to the normal file reads. Mapped files are always left to the container,
+claiming them only gives their share of the budget back.
+================
+*/
+idFile* idFileSystemLocal::ClaimPreload( const char* fileName )
+{
+	preloadFile_t* preload = NULL;
+	{
+		idScopedCriticalSection lock( preloadMutex );
+		
+		if( preloadFiles.Num() == 0 )
+		{
+			return NULL;
+		}
+		
+		const int index = FindPreload( fileName );
+		if( index == -1 || preloadFiles[index]->claimed )
+		{
+			return NULL;
+		}
+		
+		preload = preloadFiles[index];
+		preload->claimed = true;
+		
+		// the image and model jobs open their batches out of order, so the files the loads went
+		// past are only dropped once they are far enough behind to not be opened anymore
+		preloadLastClaim = Max( preloadLastClaim, index );
+		const int dropBefore = preloadLastClaim - fs_preloadDropDistance.GetInteger();
+		for( ; preloadNextClaim < preloadFiles.Num(); preloadNextClaim++ )
+		{
+			if( preloadFiles[ preloadNextClaim ]->claimed )
+			{
+				continue;
+			}
+			if( preloadNextClaim >= dropBefore )
+			{
+				break;
+			}
+			DropPreload( preloadFiles[ preloadNextClaim ] );
+		}
+		
+		if( preload->prefetched )
+		{
+			preload->prefetched = false;
+			preloadBytes -= preload->read.length;
+			preloadNumUsed++;
+		}
+		if( preload->read.buffer == NULL )
+		{
+			QueuePreloads();
+			return NULL;
+		}
+	}
+	
+	// the claimed file is never dropped by the other claims, so the other opens and the
+	// reads through the I/O thread don't have to wait for it
+	const bool read = readThread.Wait( &preload->read );
+	
+	idScopedCriticalSection lock( preloadMutex );
+	
+	idFile* file = NULL;
+	if( read )
+	{
+		idFile_Memory* mfile = new( TAG_IDFILE ) idFile_Memory( preload->filename, ( const char* )preload->read.buffer, preload->read.length );
+		mfile->TakeDataOwnership();
+		file = mfile;
+		preloadNumUsed++;
+	}
+	else
+	{
+		Mem_Free( preload->read.buffer );
+	}
+	preload->read.buffer = NULL;
+	preloadBytes -= preload->read.length;
+	
+	QueuePreloads();
+	return file;
+}
+
+/*
+================
+idFileSystemLocal::ReadAsync
+================
+*/
+void idFileSystemLocal::ReadAsync( fsAsyncRead_t* read )
+{
+	readThread.Queue( read );
+}
+
+/*
+================
+idFileSystemLocal::WaitAsyncRead
+================
+*/
+bool idFileSystemLocal::WaitAsyncRead( fsAsyncRead_t* read )
+{
+	return readThread.Wait( read );
+}
+
+/*
+================
+idFileSystemLocal::CancelAsyncRead
+================
+*/
+void idFileSystemLocal::CancelAsyncRead( fsAsyncRead_t* read )
+{
+	readThread.Cancel( read );
 }
 
 /*
@@ -358,6 +726,12 @@ idFileSystemLocal::idFileSystemLocal()
 	resourceBufferSize = 0;
 	resourceBufferAvailable = 0;
 	numFilesOpenedAsCached = 0;
+	preloadNextQueued = 0;
+	preloadNextClaim = 0;
+	preloadLastClaim = 0;
+	preloadBytes = 0;
+	preloadNumUsed = 0;
+	preloadNumDropped = 0;
 }
 
 /*
@@ -2254,38 +2628,39 @@ int idFileSystemLocal::GetFileList( const char* relativePath, const idStrList& e
 		int idx = resourceFiles.Num() - 1;
 		while( idx >= 0 )
 		{
-			for( int i = 0; i < resourceFiles[ idx ]->cacheTable.Num(); i++ )
+			for( int i = 0; i < resourceFiles[ idx ]->NumFileResources(); i++ )
 			{
-				idResourceCacheEntry& rt = resourceFiles[ idx ]->cacheTable[ i ];
+				const char* filename = resourceFiles[ idx ]->GetResourceName( i );
+				const int filenameLength = idStr::Length( filename );
 				// if the name is not long anough to at least contain the path
 				
-				if( rt.filename.Length() <= pathLength )
+				if( filenameLength <= pathLength )
 				{
 					continue;
 				}
 				
 				// check for a path match without the trailing '/'
-				if( pathLength && idStr::Icmpn( rt.filename, relativePath, pathLength - 1 ) != 0 )
+				if( pathLength && idStr::Icmpn( filename, relativePath, pathLength - 1 ) != 0 )
 				{
 					continue;
 				}
 				
 				// ensure we have a path, and not just a filename containing the path
-				if( rt.filename[ pathLength ] == '\0' || ( pathLength && rt.filename[pathLength - 1] != '/' ) )
+				if( filename[ pathLength ] == '\0' || ( pathLength && filename[pathLength - 1] != '/' ) )
 				{
 					continue;
 				}
 				
 				// make sure the file is not in a subdirectory
 				int j = pathLength;
-				for( ; rt.filename[j + 1] != '\0'; j++ )
+				for( ; filename[j + 1] != '\0'; j++ )
 				{
-					if( rt.filename[ j ] == '/' )
+					if( filename[ j ] == '/' )
 					{
 						break;
 					}
 				}
-				if( rt.filename[ j + 1 ] )
+				if( filename[ j + 1 ] )
 				{
 					continue;
 				}
@@ -2293,7 +2668,7 @@ int idFileSystemLocal::GetFileList( const char* relativePath, const idStrList& e
 				// check for extension match
 				for( j = 0; j < extensions.Num(); j++ )
 				{
-					if( rt.filename.Length() >= extensions[j].Length() && extensions[j].Icmp( rt.filename.c_str() +   rt.filename.Length() - extensions[j].Length() ) == 0 )
+					if( filenameLength >= extensions[j].Length() && extensions[j].Icmp( filename +   filenameLength - extensions[j].Length() ) == 0 )
 					{
 						break;
 					}
@@ -2308,13 +2683,13 @@ int idFileSystemLocal::GetFileList( const char* relativePath, const idStrList& e
 				{
 					idStr work = relativePath;
 					work += "/";
-					work += rt.filename.c_str() + pathLength;
+					work += filename + pathLength;
 					work.StripTrailing( '/' );
 					AddUnique( work, list, hashIndex );
 				}
 				else
 				{
-					idStr work = rt.filename.c_str() + pathLength;
+					idStr work = filename + pathLength;
 					work.StripTrailing( '/' );
 					AddUnique( work, list, hashIndex );
 				}
@@ -2791,43 +3166,66 @@ void idFileSystemLocal::CreateCRCsForResourceFileList( const idFileList& list )
 		uint32 resourceMagic;
 		currentFile->ReadBig( resourceMagic );
 		
-		if( resourceMagic != RESOURCE_FILE_MAGIC )
+		idList< unsigned int > innerFileCRCs; // DG: use int instead of long for 64bit compatibility
+		if( resourceMagic == RESOURCE_FILE_MAGIC_V2 )
 		{
-			idLib::Printf( "Resource file magic number doesn't match, skipping %s.\n", list.GetFile( fileIndex ) );
-			continue;
+			// version 2 tables have the CRC of the uncompressed data of every file
+			idResourceContainer container;
+			if( !container.Init( list.GetFile( fileIndex ), 0 ) )
+			{
+				idLib::Printf( "Resource file table is bad, skipping %s.\n", list.GetFile( fileIndex ) );
+				continue;
+			}
+			
+			innerFileCRCs.SetNum( container.NumFileResources() );
+			for( int innerFileIndex = 0; innerFileIndex < container.NumFileResources(); ++innerFileIndex )
+			{
+				idResourceCacheEntry rc;
+				container.GetEntryV2( innerFileIndex, rc );
+				innerFileCRCs[innerFileIndex] = rc.checksum;
+			}
 		}
-		
-		int tableOffset;
-		currentFile->ReadBig( tableOffset );
-		
-		int tableLength;
-		currentFile->ReadBig( tableLength );
-		
-		// Read in the table
-		currentFile->Seek( tableOffset, FS_SEEK_SET );
-		
-		int numFileResources;
-		currentFile->ReadBig( numFileResources );
-		
-		idList< idResourceCacheEntry > cacheEntries;
-		cacheEntries.SetNum( numFileResources );
-		
-		for( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex )
+		else if( resourceMagic == RESOURCE_FILE_MAGIC )
 		{
-			cacheEntries[innerFileIndex].Read( currentFile.get() );
+			int tableOffset;
+			currentFile->ReadBig( tableOffset );
+			
+			int tableLength;
+			currentFile->ReadBig( tableLength );
+			
+			// Read in the table
+			currentFile->Seek( tableOffset, FS_SEEK_SET );
+			
+			int numFileResources;
+			currentFile->ReadBig( numFileResources );
+			
+			idList< idResourceCacheEntry > cacheEntries;
+			cacheEntries.SetNum( numFileResources );
+			
+			for( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex )
+			{
+				cacheEntries[innerFileIndex].Read( currentFile.get() );
+			}
+			
+			// All tables read, now seek to each one and calculate the CRC.
+			innerFileCRCs.SetNum( numFileResources );
+			for( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex )
+			{
+				const char* innerFileDataBegin = currentFile->GetDataPtr() + cacheEntries[innerFileIndex].offset;
+				
+				innerFileCRCs[innerFileIndex] = CRC32_BlockChecksum( innerFileDataBegin, cacheEntries[innerFileIndex].length );
+			}
 		}
-		
-		// All tables read, now seek to each one and calculate the CRC.
-		idTempArray< unsigned int > innerFileCRCs( numFileResources ); // DG: use int instead of long for 64bit compatibility
-		for( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex )
+		else
 		{
-			const char* innerFileDataBegin = currentFile->GetDataPtr() + cacheEntries[innerFileIndex].offset;
-			
-			innerFileCRCs[innerFileIndex] = CRC32_BlockChecksum( innerFileDataBegin, cacheEntries[innerFileIndex].length );
+			idLib::Printf( "Resource file magic number doesn't match, skipping %s.\n", list.GetFile( fileIndex ) );
+			continue;
 		}
 		
+		const int numFileResources = innerFileCRCs.Num();
+		
 		// Get the CRC for all the CRCs.
-		const unsigned int totalCRC = CRC32_BlockChecksum( innerFileCRCs.Ptr(), innerFileCRCs.Size() ); // DG: use int instead of long for 64bit compatibility
+		const unsigned int totalCRC = CRC32_BlockChecksum( innerFileCRCs.Ptr(), numFileResources * sizeof( unsigned int ) ); // DG: use int instead of long for 64bit compatibility
 		
 		// Write the .crc file corresponding to the .resources file.
 		idStr crcFilename = list.GetFile( fileIndex );
@@ -3107,6 +3505,8 @@ void idFileSystemLocal::Startup()
 	// print the current search paths
 	Path_f( idCmdArgs() );
 	
+	readThread.Start();
+	
 	common->Printf( "file system initialized.\n" );
 	common->Printf( "--------------------------------------\n" );
 }
@@ -3183,6 +3583,9 @@ Frees all resources and closes all files
 */
 void idFileSystemLocal::Shutdown( bool reloading )
 {
+	StopPreload();
+	readThread.Shutdown();
+	
 	gameFolder.Clear();
 	searchPaths.Clear();
 	
@@ -3239,23 +3642,14 @@ bool idFileSystemLocal::GetResourceCacheEntry( const char* fileName, idResourceC
 	
 	canonical.BackSlashesToSlashes();
 	canonical.ToLower();
-	int idx = resourceFiles.Num() - 1;
-	while( idx >= 0 )
+	const uint64 hash = idResourceContainer::HashName( canonical );
+	for( int idx = resourceFiles.Num() - 1; idx >= 0; idx-- )
 	{
-		const int key = resourceFiles[ idx ]->cacheHash.GenerateKey( canonical, false );
-		for( int index = resourceFiles[ idx ]->cacheHash.GetFirst( key ); index != idHashIndex::NULL_INDEX; index = resourceFiles[ idx ]->cacheHash.GetNext( index ) )
+		if( resourceFiles[ idx ]->FindResource( canonical, hash, rc ) )
 		{
-			idResourceCacheEntry& rt = resourceFiles[ idx ]->cacheTable[ index ];
-			if( idStr::Icmp( rt.filename, canonical ) == 0 )
-			{
-				rc.filename = rt.filename;
-				rc.length = rt.length;
-				rc.containerIndex = idx;
-				rc.offset = rt.offset;
-				return true;
-			}
+			rc.containerIndex = idx;
+			return true;
 		}
-		idx--;
 	}
 	return false;
 }
@@ -3283,6 +3677,21 @@ idFile* idFileSystemLocal::GetResourceFile( const char* fileName, bool memFile )
 		{
 			idLib::Printf( "RES: loading file %s\n", rc.filename.c_str() );
 		}
+		const idResourceContainer* container = resourceFiles[ rc.containerIndex ];
+		if( container->GetMappedData() != NULL )
+		{
+			// only gives the prefetched range back to the read-ahead budget
+			ClaimPreload( rc.filename );
+		}
+		if( container->GetMappedData() != NULL || rc.IsCompressed() || ( rc.checksum != 0 && fs_verifyResources.GetBool() ) )
+		{
+			return container->OpenResource( rc );
+		}
+		idFile* preloaded = ClaimPreload( rc.filename );
+		if( preloaded != NULL )
+		{
+			return preloaded;
+		}
 		idFile_InnerResource* file = new idFile_InnerResource( rc.filename, resourceFiles[ rc.containerIndex ]->resourceFile, rc.offset, rc.length );
 		// DG: add parenthesis to make sure this block is only entered when file != NULL - bug found by clang.
 		if( file != NULL && ( ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 ) )
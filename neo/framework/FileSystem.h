@@ -205,6 +205,11 @@ public:
 	virtual void			UnloadResourceContainer( const char* name ) = 0;
 	virtual void			StartPreload( const idStrList& _preload ) = 0;
 	virtual void			StopPreload() = 0;
+	// asynchronous reads done by the I/O thread, see File_Async.h
+	virtual void			ReadAsync( fsAsyncRead_t* read ) = 0;
+	// returns true if all of the read was done
+	virtual bool			WaitAsyncRead( fsAsyncRead_t* read ) = 0;
+	virtual void			CancelAsyncRead( fsAsyncRead_t* read ) = 0;
 	virtual int				ReadFromBGL( idFile* _resourceFile, void* _buffer, int _offset, int _len ) = 0;
 	virtual bool			IsBinaryModel( const idStr& resName ) const = 0;
 	virtual bool			IsSoundSample( const idStr& resName ) const = 0;
@@ -216,6 +221,7 @@ public:
 	virtual void			AddAnimPreload( const char* resName ) = 0;
 	virtual void			AddParticlePreload( const char* resName ) = 0;
 	virtual void			AddCollisionPreload( const char* resName ) = 0;
+	virtual void			AddDeclPreload( const char* typeName, const char* resName ) = 0;
 	
 };
 
@@ -0,0 +1,325 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+/*
+================================================================================================
+
+idFileReadThread
+
+================================================================================================
+*/
+
+// a waiting thread that missed the signal because another thread consumed it wakes up after this time
+static const int FILE_READ_WAIT_MSEC	= 10;
+
+/*
+========================
+idFileReadThread::idFileReadThread
+========================
+*/
+idFileReadThread::idFileReadThread()
+{
+	for( int i = 0; i < FS_READ_NUM_PRIORITIES; i++ )
+	{
+		queueHeads[i] = 0;
+	}
+	numReads = 0;
+	numFailed = 0;
+	numBytes = 0;
+	readMicroseconds = 0;
+}
+
+/*
+========================
+idFileReadThread::~idFileReadThread
+========================
+*/
+idFileReadThread::~idFileReadThread()
+{
+	Shutdown();
+}
+
+/*
+========================
+idFileReadThread::Start
+========================
+*/
+void idFileReadThread::Start()
+{
+	if( !IsRunning() )
+	{
+		StartWorkerThread( "FileRead", CORE_ANY, THREAD_ABOVE_NORMAL );
+	}
+}
+
+/*
+========================
+idFileReadThread::Shutdown
+
+Cancels everything that is still queued and stops the thread.
+========================
+*/
+void idFileReadThread::Shutdown()
+{
+	mutex.Lock();
+	for( int i = 0; i < FS_READ_NUM_PRIORITIES; i++ )
+	{
+		for( int j = queueHeads[i]; j < queues[i].Num(); j++ )
+		{
+			if( queues[i][j] != NULL )
+			{
+				queues[i][j]->SetState( FS_READ_CANCELED );
+			}
+		}
+		queues[i].Clear();
+		queueHeads[i] = 0;
+	}
+	mutex.Unlock();
+	
+	StopThread();
+}
+
+/*
+========================
+idFileReadThread::Queue
+========================
+*/
+void idFileReadThread::Queue( fsAsyncRead_t* read )
+{
+	assert( read->priority >= 0 && read->priority < FS_READ_NUM_PRIORITIES );
+	assert( !( read->GetState() == FS_READ_QUEUED || read->GetState() == FS_READ_IN_PROGRESS ) );
+	
+	read->bytesRead = 0;
+	read->SetState( FS_READ_QUEUED );
+	
+	mutex.Lock();
+	queues[read->priority].Append( read );
+	mutex.Unlock();
+	
+	SignalWork();
+}
+
+/*
+========================
+idFileReadThread::Wait
+========================
+*/
+bool idFileReadThread::Wait( fsAsyncRead_t* read )
+{
+	if( read->GetState() == FS_READ_QUEUED && read->priority != FS_READ_PRIORITY_HIGH )
+	{
+		// somebody is waiting for it so move it to the front
+		mutex.Lock();
+		if( read->GetState() == FS_READ_QUEUED )
+		{
+			idList< fsAsyncRead_t* >& queue = queues[read->priority];
+			const int index = queue.FindIndex( read );
+			if( index >= queueHeads[read->priority] )
+			{
+				queue[index] = NULL;
+				read->priority = FS_READ_PRIORITY_HIGH;
+				queues[FS_READ_PRIORITY_HIGH].Append( read );
+			}
+		}
+		mutex.Unlock();
+	}
+	
+	while( !read->IsFinished() )
+	{
+		readDone.Wait( FILE_READ_WAIT_MSEC );
+	}
+	return ( read->GetState() == FS_READ_DONE );
+}
+
+/*
+========================
+idFileReadThread::Cancel
+========================
+*/
+void idFileReadThread::Cancel( fsAsyncRead_t* read )
+{
+	mutex.Lock();
+	if( read->GetState() == FS_READ_QUEUED )
+	{
+		idList< fsAsyncRead_t* >& queue = queues[read->priority];
+		const int index = queue.FindIndex( read );
+		if( index >= queueHeads[read->priority] )
+		{
+			queue[index] = NULL;
+		}
+		read->SetState( FS_READ_CANCELED );
+	}
+	mutex.Unlock();
+	
+	while( !read->IsFinished() && read->GetState() != FS_READ_IDLE )
+	{
+		readDone.Wait( FILE_READ_WAIT_MSEC );
+	}
+}
+
+/*
+========================
+idFileReadThread::NumQueued
+========================
+*/
+int idFileReadThread::NumQueued()
+{
+	idScopedCriticalSection lock( mutex );
+	int num = 0;
+	for( int i = 0; i < FS_READ_NUM_PRIORITIES; i++ )
+	{
+		for( int j = queueHeads[i]; j < queues[i].Num(); j++ )
+		{
+			num += ( queues[i][j] != NULL );
+		}
+	}
+	return num;
+}
+
+/*
+========================
+idFileReadThread::PrintStats
+========================
+*/
+void idFileReadThread::PrintStats()
+{
+	const double seconds = readMicroseconds * 0.000001;
+	idLib::Printf( "%d async reads, %d failed, %.1f MB in %.2f seconds ( %.1f MB/s )\n", numReads, numFailed,
+				   numBytes / ( 1024.0 * 1024.0 ), seconds, ( seconds > 0.0 ) ? numBytes / ( 1024.0 * 1024.0 ) / seconds : 0.0 );
+}
+
+/*
+========================
+idFileReadThread::NextRead
+
+Takes the oldest read of the highest priority out of the queues.
+========================
+*/
+fsAsyncRead_t* idFileReadThread::NextRead()
+{
+	idScopedCriticalSection lock( mutex );
+	for( int i = FS_READ_NUM_PRIORITIES - 1; i >= 0; i-- )
+	{
+		idList< fsAsyncRead_t* >& queue = queues[i];
+		while( queueHeads[i] < queue.Num() )
+		{
+			fsAsyncRead_t* read = queue[queueHeads[i]++];
+			if( read != NULL )
+			{
+				read->SetState( FS_READ_IN_PROGRESS );
+				return read;
+			}
+		}
+		// keep the memory around for the next batch of reads
+		queue.SetNum( 0 );
+		queueHeads[i] = 0;
+	}
+	return NULL;
+}
+
+/*
+========================
+idFileReadThread::OpenFile
+========================
+*/
+idFile* idFileReadThread::OpenFile( const char* osPath )
+{
+	for( int i = 0; i < openFiles.Num(); i++ )
+	{
+		if( idStr::Cmp( openFiles[i]->GetFullPath(), osPath ) == 0 )
+		{
+			return openFiles[i];
+		}
+	}
+	idFile* file = fileSystem->OpenExplicitFileRead( osPath );
+	if( file != NULL )
+	{
+		openFiles.Append( file );
+	}
+	return file;
+}
+
+/*
+========================
+idFileReadThread::CloseFiles
+========================
+*/
+void idFileReadThread::CloseFiles()
+{
+	openFiles.DeleteContents();
+}
+
+/*
+========================
+idFileReadThread::Run
+
+Reads until the queues are empty.
+========================
+*/
+int idFileReadThread::Run()
+{
+	fsAsyncRead_t* read;
+	while( ( read = NextRead() ) != NULL && !IsTerminating() )
+	{
+		const uint64 start = Sys_Microseconds();
+		
+		idFile* file = OpenFile( read->osPath );
+		if( file != NULL && file->Seek( read->offset, FS_SEEK_SET ) == 0 )
+		{
+			read->bytesRead = file->Read( read->buffer, read->length );
+		}
+		
+		readMicroseconds += Sys_Microseconds() - start;
+		numBytes += read->bytesRead;
+		numReads++;
+		
+		const bool succeeded = ( read->bytesRead == read->length );
+		if( !succeeded )
+		{
+			numFailed++;
+		}
+		if( read->callback != NULL )
+		{
+			read->callback( read );
+		}
+		read->SetState( succeeded ? FS_READ_DONE : FS_READ_FAILED );
+		readDone.Raise();
+	}
+	if( read != NULL )
+	{
+		// terminating with a read taken out of the queue
+		read->SetState( FS_READ_CANCELED );
+		readDone.Raise();
+	}
+	
+	CloseFiles();
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __FILE_ASYNC_H__
+#define __FILE_ASYNC_H__
+
+/*
+==============================================================
+
+  Asynchronous file reads.
+
+  Reads are queued with the file system and done in order of priority by a dedicated
+  I/O thread that keeps its own handles to the files, so the reads never disturb the
+  file position of a file that is open on another thread. Reads of the same priority
+  are done in the order they were queued, so queue them sorted by file offset.
+
+==============================================================
+*/
+
+typedef enum
+{
+	FS_READ_PRIORITY_LOW,
+	FS_READ_PRIORITY_NORMAL,
+	FS_READ_PRIORITY_HIGH,			// somebody is waiting for the read right now
+	FS_READ_NUM_PRIORITIES
+} fsReadPriority_t;
+
+typedef enum
+{
+	FS_READ_IDLE,
+	FS_READ_QUEUED,
+	FS_READ_IN_PROGRESS,
+	FS_READ_DONE,
+	FS_READ_FAILED,
+	FS_READ_CANCELED
+} fsReadState_t;
+
+struct fsAsyncRead_t;
+
+// called from the I/O thread when the read is finished, before the read is marked done
+typedef void ( *fsReadCallback_t )( fsAsyncRead_t* read );
+
+/*
+================================================
+fsAsyncRead_t
+
+A single read of a range of a file. The request and the buffer are owned by the caller and
+have to stay valid until the read is finished or canceled.
+================================================
+*/
+struct fsAsyncRead_t
+{
+	fsAsyncRead_t()
+	{
+		offset = 0;
+		length = 0;
+		buffer = NULL;
+		priority = FS_READ_PRIORITY_NORMAL;
+		callback = NULL;
+		userData = NULL;
+		bytesRead = 0;
+	}
+	
+	// the state is changed with a full barrier, so bytesRead and the buffer are
+	// valid on the waiting thread once it sees the read finished
+	fsReadState_t		GetState() const
+	{
+		return ( fsReadState_t )state.Add( 0 );
+	}
+	void				SetState( fsReadState_t newState )
+	{
+		state.Exchange( newState );
+	}
+	bool				IsFinished() const
+	{
+		return GetState() >= FS_READ_DONE;
+	}
+	
+	idStr				osPath;			// full OS path of the file
+	int					offset;
+	int					length;
+	void* 				buffer;
+	fsReadPriority_t	priority;
+	fsReadCallback_t	callback;
+	void* 				userData;
+	
+	// set by the I/O thread
+	mutable idSysInterlockedInteger	state;	// fsReadState_t, constructed as FS_READ_IDLE
+	int					bytesRead;
+};
+
+/*
+================================================
+idFileReadThread
+
+The I/O thread behind the asynchronous reads of the file system.
+================================================
+*/
+class idFileReadThread : public idSysThread
+{
+public:
+	idFileReadThread();
+	~idFileReadThread();
+	
+	void				Start();
+	void				Shutdown();
+	
+	void				Queue( fsAsyncRead_t* read );
+	// waits until the read is finished, returns true if all of it was read
+	bool				Wait( fsAsyncRead_t* read );
+	// takes the read out of the queue, or waits for it if it's already being read
+	void				Cancel( fsAsyncRead_t* read );
+	
+	int					NumQueued();
+	void				PrintStats();
+	
+protected:
+	virtual int			Run();
+	
+private:
+	fsAsyncRead_t* 		NextRead();
+	idFile* 			OpenFile( const char* osPath );
+	void				CloseFiles();
+	
+	idSysMutex			mutex;
+	idSysSignal			readDone;
+	idList< fsAsyncRead_t* >	queues[FS_READ_NUM_PRIORITIES];
+	int					queueHeads[FS_READ_NUM_PRIORITIES];
+	
+	// only used by the I/O thread, closed whenever the queues run empty
+	idList< idFile* >	openFiles;
+	
+	int					numReads;
+	int					numFailed;
+	int64				numBytes;
+	uint64				readMicroseconds;
+};
+
+#endif /* !__FILE_ASYNC_H__ */
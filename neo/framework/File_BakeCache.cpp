@@ -0,0 +1,287 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+static const char* BAKE_CACHE_FILE = "generated/bake.cache";
+static const int BAKE_CACHE_VERSION = 1;
+static const unsigned int BAKE_CACHE_MAGIC = ( 'B' << 24 ) | ( 'K' << 16 ) | ( 'C' << 8 ) | BAKE_CACHE_VERSION;
+
+idBakeCache bakeCache;
+
+/*
+========================
+idBakeCache::idBakeCache
+========================
+*/
+idBakeCache::idBakeCache()
+{
+	entries.SetGranularity( 4096 );
+	entryHash.SetGranularity( 4096 );
+	loaded = false;
+	dirty = false;
+}
+
+/*
+========================
+idBakeCache::IsEnabled
+
+The resource containers of a production build have no sources to hash.
+========================
+*/
+bool idBakeCache::IsEnabled() const
+{
+	return fileSystem != NULL && !fileSystem->InProductionMode();
+}
+
+/*
+========================
+idBakeCache::Load
+========================
+*/
+void idBakeCache::Load()
+{
+	if( loaded )
+	{
+		return;
+	}
+	loaded = true;
+	
+	idFileLocal file( fileSystem->OpenFileReadMemory( BAKE_CACHE_FILE ) );
+	if( file == NULL )
+	{
+		return;
+	}
+	
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if( magic != BAKE_CACHE_MAGIC )
+	{
+		return;
+	}
+	
+	int numEntries = 0;
+	file->ReadBig( numEntries );
+	entries.SetNum( numEntries );
+	for( int i = 0; i < numEntries; i++ )
+	{
+		bakeEntry_t& entry = entries[i];
+		file->ReadString( entry.generatedName );
+		file->ReadBig( entry.contentHash );
+		file->ReadBig( entry.sourceTime );
+		entryHash.Add( entryHash.GenerateKey( entry.generatedName, false ), i );
+	}
+}
+
+/*
+========================
+idBakeCache::Save
+========================
+*/
+void idBakeCache::Save()
+{
+	idScopedCriticalSection lock( mutex );
+	
+	if( !dirty )
+	{
+		return;
+	}
+	
+	idFileLocal file( fileSystem->OpenFileWrite( BAKE_CACHE_FILE, "fs_basepath" ) );
+	if( file == NULL )
+	{
+		idLib::Warning( "idBakeCache: Could not open file '%s'", BAKE_CACHE_FILE );
+		return;
+	}
+	
+	file->WriteBig( BAKE_CACHE_MAGIC );
+	file->WriteBig( entries.Num() );
+	for( int i = 0; i < entries.Num(); i++ )
+	{
+		const bakeEntry_t& entry = entries[i];
+		file->WriteString( entry.generatedName );
+		file->WriteBig( entry.contentHash );
+		file->WriteBig( entry.sourceTime );
+	}
+	dirty = false;
+}
+
+/*
+========================
+idBakeCache::FindEntry
+========================
+*/
+int idBakeCache::FindEntry( const char* generatedName ) const
+{
+	const int key = entryHash.GenerateKey( generatedName, false );
+	for( int i = entryHash.First( key ); i != -1; i = entryHash.Next( i ) )
+	{
+		if( entries[i].generatedName.Icmp( generatedName ) == 0 )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+========================
+idBakeCache::IsVerified
+========================
+*/
+bool idBakeCache::IsVerified( const char* generatedName, ID_TIME_T sourceTime )
+{
+	if( !IsEnabled() || sourceTime == FILE_NOT_FOUND_TIMESTAMP )
+	{
+		return false;
+	}
+	
+	idScopedCriticalSection lock( mutex );
+	Load();
+	
+	const int index = FindEntry( generatedName );
+	return ( index != -1 && entries[index].sourceTime == sourceTime );
+}
+
+/*
+========================
+idBakeCache::IsCurrent
+========================
+*/
+bool idBakeCache::IsCurrent( const char* generatedName, unsigned int contentHash, ID_TIME_T sourceTime )
+{
+	if( !IsEnabled() )
+	{
+		return false;
+	}
+	
+	idScopedCriticalSection lock( mutex );
+	Load();
+	
+	const int index = FindEntry( generatedName );
+	if( index == -1 || entries[index].contentHash != contentHash )
+	{
+		return false;
+	}
+	if( entries[index].sourceTime != sourceTime )
+	{
+		entries[index].sourceTime = sourceTime;
+		dirty = true;
+	}
+	return true;
+}
+
+/*
+========================
+idBakeCache::Update
+========================
+*/
+void idBakeCache::Update( const char* generatedName, unsigned int contentHash, ID_TIME_T sourceTime )
+{
+	if( !IsEnabled() )
+	{
+		return;
+	}
+	
+	idScopedCriticalSection lock( mutex );
+	Load();
+	
+	int index = FindEntry( generatedName );
+	if( index == -1 )
+	{
+		index = entries.Num();
+		entries.Alloc().generatedName = generatedName;
+		entryHash.Add( entryHash.GenerateKey( generatedName, false ), index );
+	}
+	entries[index].contentHash = contentHash;
+	entries[index].sourceTime = sourceTime;
+	dirty = true;
+}
+
+/*
+========================
+idBakeCache::IsFileCurrent
+========================
+*/
+bool idBakeCache::IsFileCurrent( const char* generatedName, const char* sourceName, ID_TIME_T sourceTime, unsigned int paramsHash )
+{
+	if( !IsEnabled() || sourceTime == FILE_NOT_FOUND_TIMESTAMP )
+	{
+		return false;
+	}
+	if( IsVerified( generatedName, sourceTime ) )
+	{
+		return true;
+	}
+	const unsigned int contentHash = HashFile( sourceName, paramsHash );
+	return ( contentHash != 0 && IsCurrent( generatedName, contentHash, sourceTime ) );
+}
+
+/*
+========================
+idBakeCache::UpdateFile
+========================
+*/
+void idBakeCache::UpdateFile( const char* generatedName, const char* sourceName, ID_TIME_T sourceTime, unsigned int paramsHash )
+{
+	if( !IsEnabled() || sourceTime == FILE_NOT_FOUND_TIMESTAMP || IsVerified( generatedName, sourceTime ) )
+	{
+		return;
+	}
+	const unsigned int contentHash = HashFile( sourceName, paramsHash );
+	if( contentHash != 0 )
+	{
+		Update( generatedName, contentHash, sourceTime );
+	}
+}
+
+/*
+========================
+idBakeCache::HashFile
+========================
+*/
+unsigned int idBakeCache::HashFile( const char* sourceName, unsigned int paramsHash )
+{
+	void* buffer = NULL;
+	const int length = fileSystem->ReadFile( sourceName, &buffer );
+	if( length < 0 || buffer == NULL )
+	{
+		return 0;
+	}
+	
+	unsigned int hash;
+	CRC32_InitChecksum( hash );
+	CRC32_UpdateChecksum( hash, &paramsHash, sizeof( paramsHash ) );
+	CRC32_UpdateChecksum( hash, buffer, length );
+	CRC32_FinishChecksum( hash );
+	fileSystem->FreeFile( buffer );
+	
+	// 0 is used for sources that couldn't be read
+	return ( hash != 0 ) ? hash : 1;
+}
@@ -0,0 +1,106 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __FILE_BAKECACHE_H__
+#define __FILE_BAKECACHE_H__
+
+/*
+==============================================================
+
+  Content hashes of the sources of generated files.
+
+  The generated images, models and sound samples store the timestamp of their source and are
+  rebuilt when it changes, which also happens when the files are only copied. The bake cache
+  remembers a hash of the source content and the build parameters for every generated file,
+  so a changed timestamp only costs hashing the source instead of a rebuild.
+
+==============================================================
+*/
+
+struct bakeStats_t
+{
+	bakeStats_t()
+	{
+		upToDate = 0;
+		baked = 0;
+		failed = 0;
+	}
+	int				upToDate;		// generated file matches the source content
+	int				baked;			// generated file was missing or stale and has been rebuilt
+	int				failed;			// the source couldn't be loaded
+};
+
+class idBakeCache
+{
+public:
+	idBakeCache();
+	
+	// the cache is loaded on first use, Save only writes it if anything changed
+	void			Save();
+	
+	// true if the generated file was last checked against sources with this timestamp
+	bool			IsVerified( const char* generatedName, ID_TIME_T sourceTime );
+	
+	// true if the generated file was built from sources with this content hash, the entry
+	// is updated with the source timestamp so the next check doesn't need the hash
+	bool			IsCurrent( const char* generatedName, unsigned int contentHash, ID_TIME_T sourceTime );
+	
+	// records the content hash of the sources a generated file was built from
+	void			Update( const char* generatedName, unsigned int contentHash, ID_TIME_T sourceTime );
+	
+	// IsVerified, else IsCurrent with the hash of the source file
+	bool			IsFileCurrent( const char* generatedName, const char* sourceName, ID_TIME_T sourceTime, unsigned int paramsHash );
+	
+	// Update with the hash of the source file, unless it was already checked at this timestamp
+	void			UpdateFile( const char* generatedName, const char* sourceName, ID_TIME_T sourceTime, unsigned int paramsHash );
+	
+	// hash of the source file content and the build parameters, 0 if the file can't be read
+	static unsigned int	HashFile( const char* sourceName, unsigned int paramsHash );
+	
+private:
+	struct bakeEntry_t
+	{
+		idStr			generatedName;
+		unsigned int	contentHash;
+		ID_TIME_T		sourceTime;
+	};
+	
+	void			Load();
+	int				FindEntry( const char* generatedName ) const;
+	bool			IsEnabled() const;
+	
+	idList< bakeEntry_t >	entries;
+	idHashIndex		entryHash;
+	idSysMutex		mutex;
+	bool			loaded;
+	bool			dirty;
+};
+
+extern idBakeCache	bakeCache;
+
+#endif /* !__FILE_BAKECACHE_H__ */
@@ -139,7 +139,8 @@ enum preloadType_t
 	PRELOAD_SAMPLE,
 	PRELOAD_ANIM,
 	PRELOAD_COLLISION,
-	PRELOAD_PARTICLE
+	PRELOAD_PARTICLE,
+	PRELOAD_DECL			// resourceName is the decl type name and the decl name separated by a colon
 };
 
 // preload
@@ -266,6 +267,15 @@ public:
 		pe.resourceName = _resourceName;
 		entries.Append( pe );
 	}
+	void AddDecl( const char* _typeName, const char* _resourceName )
+	{
+		static preloadEntry_s pe;
+		pe.resType = PRELOAD_DECL;
+		pe.resourceName = _typeName;
+		pe.resourceName += ":";
+		pe.resourceName += _resourceName;
+		entries.Append( pe );
+	}
 	void AddAnim( const char* _resourceName )
 	{
 		static preloadEntry_s pe;
@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "precompiled.h"
 #pragma hdrstop
 
+#include <zlib.h>
+
 /*
 ================================================================================================
 
@@ -37,6 +39,116 @@ idResourceContainer
 ================================================================================================
 */
 
+idCVar fs_mapResources( "fs_mapResources", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "memory map the resource containers and read files straight out of the mapping" );
+idCVar fs_resourceFormat( "fs_resourceFormat", "2", CVAR_SYSTEM | CVAR_INTEGER, "version of the resource files that are written, 1 is uncompressed and readable by older builds", 1, 2 );
+idCVar fs_verifyResources( "fs_verifyResources", "0", CVAR_SYSTEM | CVAR_BOOL, "check the checksum of every file that is loaded from a version 2 resource file" );
+
+// the files and the table in version 2 resource files are aligned so they can be used in place
+static const int RESOURCE_V2_ALIGNMENT = 16;
+// only keep the compressed data if it's at least this much smaller
+static const int RESOURCE_V2_MIN_SAVING = 8;		// 1/8th
+static const uint32 RESOURCE_V2_EMPTY_SLOT = 0xFFFFFFFF;
+static const uint32 RESOURCE_V2_MAX_SEED = 1 << 24;
+
+template< class type >
+static ID_INLINE type BigValue( type value )
+{
+	idSwap::Big( value );
+	return value;
+}
+
+/*
+========================
+ResourceSlot
+
+Position of a name hash in the perfect hash table, the seed of the hash bucket displaces the
+names of the bucket until they all land in free slots.
+========================
+*/
+static ID_INLINE uint32 ResourceSlot( uint64 hash, uint32 seed, uint32 numSlots )
+{
+	uint32 h = ( uint32 )hash + seed * 0x9E3779B9;
+	h ^= h >> 16;
+	h *= 0x85EBCA6B;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35;
+	h ^= h >> 16;
+	return h % numSlots;
+}
+
+/*
+========================
+InflateResource
+========================
+*/
+static bool InflateResource( const byte* src, int srcLength, byte* dest, int destLength )
+{
+	z_stream stream;
+	memset( &stream, 0, sizeof( stream ) );
+	stream.next_in = ( Bytef* )src;
+	stream.avail_in = srcLength;
+	stream.next_out = ( Bytef* )dest;
+	stream.avail_out = destLength;
+	
+	// raw deflate with no header / checksum
+	if( inflateInit2( &stream, -MAX_WBITS ) != Z_OK )
+	{
+		return false;
+	}
+	const int status = inflate( &stream, Z_FINISH );
+	inflateEnd( &stream );
+	
+	return ( status == Z_STREAM_END && stream.total_out == ( uLong )destLength );
+}
+
+/*
+========================
+DeflateResource
+
+Returns the compressed length, or 0 if the data doesn't fit in dest.
+========================
+*/
+static int DeflateResource( const byte* src, int srcLength, byte* dest, int destLength )
+{
+	z_stream stream;
+	memset( &stream, 0, sizeof( stream ) );
+	stream.next_in = ( Bytef* )src;
+	stream.avail_in = srcLength;
+	stream.next_out = ( Bytef* )dest;
+	stream.avail_out = destLength;
+	
+	// raw deflate with no header / checksum
+	if( deflateInit2( &stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 9, Z_DEFAULT_STRATEGY ) != Z_OK )
+	{
+		return 0;
+	}
+	const int status = deflate( &stream, Z_FINISH );
+	deflateEnd( &stream );
+	
+	return ( status == Z_STREAM_END ) ? ( int )stream.total_out : 0;
+}
+
+/*
+========================
+idResourceContainer::HashName
+========================
+*/
+uint64 idResourceContainer::HashName( const char* canonicalName )
+{
+	// 64 bit FNV-1a
+	uint64 hash = 0xCBF29CE484222325ULL;
+	for( const char* c = canonicalName; *c != '\0'; c++ )
+	{
+		hash ^= ( byte ) * c;
+		hash *= 0x100000001B3ULL;
+	}
+	// mix the bits, short names don't reach the high bits otherwise
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
 /*
 ========================
 idResourceContainer::ReOpen
@@ -44,8 +156,78 @@ idResourceContainer::ReOpen
 */
 void idResourceContainer::ReOpen()
 {
+	FreeTableV2();
+	Unmap();
 	delete resourceFile;
 	resourceFile = fileSystem->OpenFileRead( fileName );
+	if( resourceFile != NULL )
+	{
+		Map();
+		if( resourceMagic == RESOURCE_FILE_MAGIC_V2 )
+		{
+			InitTableV2();
+		}
+	}
+}
+
+/*
+========================
+idResourceContainer::Map
+
+Maps the whole container into memory so the files in it can be used without copying them.
+A container that was read into memory is used as it is.
+========================
+*/
+void idResourceContainer::Map()
+{
+	Unmap();
+	
+	const int length = resourceFile->Length();
+	resourceFile->Rewind();
+	mappedData = resourceFile->ReadInPlace( length );
+	if( mappedData != NULL )
+	{
+		mappedLength = length;
+		return;
+	}
+	
+	if( !fs_mapResources.GetBool() )
+	{
+		return;
+	}
+	
+	mappedData = Sys_MapFile( resourceFile->GetFullPath(), &mappedLength );
+	if( mappedData == NULL )
+	{
+		idLib::Warning( "Unable to map resource file %s, reading from the file", fileName.c_str() );
+		mappedLength = 0;
+		return;
+	}
+	if( mappedLength != length )
+	{
+		// the file changed under us
+		Sys_UnmapFile( mappedData, mappedLength );
+		mappedData = NULL;
+		mappedLength = 0;
+		return;
+	}
+	mappedBySystem = true;
+}
+
+/*
+========================
+idResourceContainer::Unmap
+========================
+*/
+void idResourceContainer::Unmap()
+{
+	if( mappedBySystem )
+	{
+		Sys_UnmapFile( mappedData, mappedLength );
+	}
+	mappedData = NULL;
+	mappedLength = 0;
+	mappedBySystem = false;
 }
 
 /*
@@ -53,7 +235,7 @@ void idResourceContainer::ReOpen()
 idResourceContainer::Init
 ========================
 */
-bool idResourceContainer::Init( const char* _fileName, uint8 containerIndex )
+bool idResourceContainer::Init( const char* _fileName, uint8 _containerIndex )
 {
 
 	if( idStr::Icmp( _fileName, "_ordered.resources" ) == 0 )
@@ -71,7 +253,15 @@ bool idResourceContainer::Init( const char* _fileName, uint8 containerIndex )
 		return false;
 	}
 	
+	containerIndex = _containerIndex;
+	
 	resourceFile->ReadBig( resourceMagic );
+	if( resourceMagic == RESOURCE_FILE_MAGIC_V2 )
+	{
+		fileName = _fileName;
+		Map();
+		return InitTableV2();
+	}
 	if( resourceMagic != RESOURCE_FILE_MAGIC )
 	{
 		idLib::FatalError( "resourceFileMagic != RESOURCE_FILE_MAGIC" );
@@ -81,10 +271,22 @@ bool idResourceContainer::Init( const char* _fileName, uint8 containerIndex )
 	
 	resourceFile->ReadBig( tableOffset );
 	resourceFile->ReadBig( tableLength );
+	
+	Map();
+	
 	// read this into a memory buffer with a single read
-	char* const buf = ( char* )Mem_Alloc( tableLength, TAG_RESOURCE );
-	resourceFile->Seek( tableOffset, FS_SEEK_SET );
-	resourceFile->Read( buf, tableLength );
+	const bool tableMapped = ( mappedData != NULL && tableOffset >= 0 && tableOffset + tableLength <= mappedLength );
+	char* buf = NULL;
+	if( tableMapped )
+	{
+		buf = ( char* )mappedData + tableOffset;
+	}
+	else
+	{
+		buf = ( char* )Mem_Alloc( tableLength, TAG_RESOURCE );
+		resourceFile->Seek( tableOffset, FS_SEEK_SET );
+		resourceFile->Read( buf, tableLength );
+	}
 	idFile_Memory memFile( "resourceHeader", ( const char* )buf, tableLength );
 	
 	// Parse the resourceFile header, which includes every resource used
@@ -101,7 +303,8 @@ bool idResourceContainer::Init( const char* _fileName, uint8 containerIndex )
 		rt.filename.ToLower();
 		rt.containerIndex = containerIndex;
 		
-		const int key = cacheHash.GenerateKey( rt.filename, false );
+		// the names are lower case already, so the lookups don't have to ignore the case
+		const int key = cacheHash.GenerateKey( rt.filename, true );
 		bool found = false;
 		//for ( int index = cacheHash.GetFirst( key ); index != idHashIndex::NULL_INDEX; index = cacheHash.GetNext( index ) ) {
 		//	idResourceCacheEntry & rtc = cacheTable[ index ];
@@ -116,11 +319,641 @@ bool idResourceContainer::Init( const char* _fileName, uint8 containerIndex )
 			cacheHash.Add( key, i );
 		}
 	}
-	Mem_Free( buf );
+	if( !tableMapped )
+	{
+		Mem_Free( buf );
+	}
 	
 	return true;
 }
 
+/*
+========================
+idResourceContainer::InitTableV2
+
+The table isn't parsed, it's used where it is in the mapped container or read into memory
+with a single read.
+========================
+*/
+bool idResourceContainer::InitTableV2()
+{
+	FreeTableV2();
+	
+	resourceHeaderV2_t header;
+	resourceFile->Seek( 0, FS_SEEK_SET );
+	if( resourceFile->Read( &header, sizeof( header ) ) != sizeof( header ) )
+	{
+		idLib::Warning( "Resource file %s is truncated", fileName.c_str() );
+		return false;
+	}
+	idSwapClass< resourceHeaderV2_t > swap;
+	swap.Big( header.magic );
+	swap.Big( header.numFileResources );
+	swap.Big( header.tableOffset );
+	swap.Big( header.tableLength );
+	swap.Big( header.numBuckets );
+	swap.Big( header.tableChecksum );
+	
+	// the files are addressed with 32 bit offsets in here
+	const int64 fileLength = resourceFile->Length();
+	const int64 entriesLength = ( int64 )header.numFileResources * sizeof( resourceEntryV2_t );
+	const int64 hashLength = ( header.numBuckets > 0 ) ? ( ( int64 )header.numBuckets + header.numFileResources ) * sizeof( uint32 ) : 0;
+	if( header.tableOffset < ( int64 )sizeof( header ) || header.tableLength <= 0 || header.tableOffset + header.tableLength > fileLength
+			|| header.tableOffset + header.tableLength > INT_MAX || entriesLength + hashLength > header.tableLength )
+	{
+		idLib::Warning( "Resource file %s has a bad table", fileName.c_str() );
+		return false;
+	}
+	
+	tableOffset = ( int )header.tableOffset;
+	tableLength = header.tableLength;
+	if( mappedData != NULL )
+	{
+		tableV2 = mappedData + tableOffset;
+	}
+	else
+	{
+		byte* buf = ( byte* )Mem_Alloc( tableLength, TAG_RESOURCE );
+		resourceFile->Seek( tableOffset, FS_SEEK_SET );
+		resourceFile->Read( buf, tableLength );
+		tableV2 = buf;
+		tableV2Owned = true;
+	}
+	
+	if( CRC32_BlockChecksum( tableV2, tableLength ) != header.tableChecksum )
+	{
+		idLib::Warning( "Resource file %s has a bad table checksum", fileName.c_str() );
+		FreeTableV2();
+		return false;
+	}
+	
+	entriesV2 = ( const resourceEntryV2_t* )tableV2;
+	bucketsV2 = ( const uint32* )( tableV2 + entriesLength );
+	slotsV2 = bucketsV2 + header.numBuckets;
+	namesV2 = ( const char* )( tableV2 + entriesLength + hashLength );
+	namesV2Length = tableLength - ( int )( entriesLength + hashLength );
+	numBucketsV2 = header.numBuckets;
+	numFileResources = header.numFileResources;
+	
+	// make sure the entries can't point outside of the container
+	for( int i = 0; i < numFileResources; i++ )
+	{
+		const resourceEntryV2_t& entry = entriesV2[ i ];
+		const int64 offset = BigValue( entry.offset );
+		const int length = BigValue( entry.length );
+		const int compressedLength = BigValue( entry.compressedLength );
+		const int storedLength = ( compressedLength > 0 ) ? compressedLength : length;
+		const uint32 nameOffset = BigValue( entry.nameOffset );
+		if( offset < 0 || length < 0 || compressedLength < 0 || offset + storedLength > fileLength || offset + storedLength > INT_MAX
+				|| nameOffset >= ( uint32 )namesV2Length || memchr( namesV2 + nameOffset, '\0', namesV2Length - nameOffset ) == NULL )
+		{
+			idLib::Warning( "Resource file %s has a bad entry %d", fileName.c_str(), i );
+			FreeTableV2();
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/*
+========================
+idResourceContainer::FreeTableV2
+========================
+*/
+void idResourceContainer::FreeTableV2()
+{
+	if( tableV2Owned )
+	{
+		Mem_Free( ( void* )tableV2 );
+	}
+	tableV2 = NULL;
+	tableV2Owned = false;
+	entriesV2 = NULL;
+	bucketsV2 = NULL;
+	slotsV2 = NULL;
+	namesV2 = NULL;
+	namesV2Length = 0;
+	numBucketsV2 = 0;
+	numFileResources = 0;
+}
+
+/*
+========================
+idResourceContainer::GetEntryV2
+========================
+*/
+void idResourceContainer::GetEntryV2( int index, idResourceCacheEntry& rc ) const
+{
+	const resourceEntryV2_t& entry = entriesV2[ index ];
+	rc.filename = namesV2 + BigValue( entry.nameOffset );
+	rc.offset = ( int )BigValue( entry.offset );
+	rc.length = BigValue( entry.length );
+	rc.compressedLength = BigValue( entry.compressedLength );
+	rc.checksum = BigValue( entry.checksum );
+	rc.containerIndex = containerIndex;
+}
+
+/*
+========================
+idResourceContainer::GetResourceName
+========================
+*/
+const char* idResourceContainer::GetResourceName( int index ) const
+{
+	if( tableV2 != NULL )
+	{
+		return namesV2 + BigValue( entriesV2[ index ].nameOffset );
+	}
+	return cacheTable[ index ].filename.c_str();
+}
+
+/*
+========================
+idResourceContainer::FindResource
+========================
+*/
+bool idResourceContainer::FindResource( const char* canonicalName, uint64 hash, idResourceCacheEntry& rc ) const
+{
+	if( tableV2 != NULL )
+	{
+		const uint32 nameHash = ( uint32 )( hash >> 32 );
+		if( numBucketsV2 > 0 )
+		{
+			const uint32 seed = BigValue( bucketsV2[ nameHash % numBucketsV2 ] );
+			const uint32 index = BigValue( slotsV2[ ResourceSlot( hash, seed, numFileResources ) ] );
+			// the slots aren't covered by the entry checks in InitTableV2
+			if( index == RESOURCE_V2_EMPTY_SLOT || index >= ( uint32 )numFileResources || BigValue( entriesV2[ index ].nameHash ) != nameHash
+					|| idStr::Cmp( namesV2 + BigValue( entriesV2[ index ].nameOffset ), canonicalName ) != 0 )
+			{
+				return false;
+			}
+			GetEntryV2( index, rc );
+			return true;
+		}
+		// no perfect hash could be built for the names, the last of duplicates wins
+		for( int i = numFileResources - 1; i >= 0; i-- )
+		{
+			if( BigValue( entriesV2[ i ].nameHash ) == nameHash && idStr::Cmp( namesV2 + BigValue( entriesV2[ i ].nameOffset ), canonicalName ) == 0 )
+			{
+				GetEntryV2( i, rc );
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	const int key = cacheHash.GenerateKey( canonicalName, true );
+	for( int index = cacheHash.GetFirst( key ); index != idHashIndex::NULL_INDEX; index = cacheHash.GetNext( index ) )
+	{
+		const idResourceCacheEntry& rt = cacheTable[ index ];
+		if( idStr::Cmp( rt.filename, canonicalName ) == 0 )
+		{
+			rc.filename = rt.filename;
+			rc.offset = rt.offset;
+			rc.length = rt.length;
+			rc.compressedLength = 0;
+			rc.checksum = 0;
+			rc.containerIndex = containerIndex;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+========================
+idResourceContainer::ReadResource
+========================
+*/
+bool idResourceContainer::ReadResource( const idResourceCacheEntry& rc, byte* dest ) const
+{
+	const int storedLength = rc.StoredLength();
+	const byte* stored = NULL;
+	byte* temp = NULL;
+	if( mappedData != NULL )
+	{
+		stored = mappedData + rc.offset;
+	}
+	else
+	{
+		stored = temp = rc.IsCompressed() ? ( byte* )Mem_Alloc( storedLength, TAG_TEMP ) : dest;
+		if( resourceFile->Seek( rc.offset, FS_SEEK_SET ) != 0 || resourceFile->Read( temp, storedLength ) != storedLength )
+		{
+			if( temp != dest )
+			{
+				Mem_Free( temp );
+			}
+			return false;
+		}
+	}
+	
+	bool succeeded = true;
+	if( rc.IsCompressed() )
+	{
+		succeeded = InflateResource( stored, storedLength, dest, rc.length );
+	}
+	else if( stored != dest )
+	{
+		memcpy( dest, stored, rc.length );
+	}
+	if( temp != NULL && temp != dest )
+	{
+		Mem_Free( temp );
+	}
+	
+	if( succeeded && rc.checksum != 0 && fs_verifyResources.GetBool() )
+	{
+		succeeded = ( CRC32_BlockChecksum( dest, rc.length ) == rc.checksum );
+	}
+	return succeeded;
+}
+
+/*
+========================
+idResourceContainer::OpenResource
+
+Compressed files are uncompressed into memory, other files of a container that's in memory are
+read only views of the container, no copy is made of them unless they have to be verified.
+========================
+*/
+idFile* idResourceContainer::OpenResource( const idResourceCacheEntry& rc ) const
+{
+	const bool verify = ( rc.checksum != 0 && fs_verifyResources.GetBool() );
+	if( mappedData != NULL && !rc.IsCompressed() && !verify )
+	{
+		return new( TAG_IDFILE ) idFile_Memory( rc.filename, ( const char* )mappedData + rc.offset, rc.length );
+	}
+	if( rc.length == 0 )
+	{
+		return new( TAG_IDFILE ) idFile_Memory( rc.filename, "", 0 );
+	}
+	
+	byte* data = ( byte* )Mem_Alloc( rc.length, TAG_TEMP );
+	if( !ReadResource( rc, data ) )
+	{
+		idLib::Warning( "%s in resource file %s is corrupt", rc.filename.c_str(), fileName.c_str() );
+		Mem_Free( data );
+		return NULL;
+	}
+	idFile_Memory* file = new( TAG_IDFILE ) idFile_Memory( rc.filename, ( const char* )data, rc.length );
+	file->TakeDataOwnership();
+	return file;
+}
+
+/*
+========================
+idResourceContainer::ReadTable
+
+Reads the table of a resource file of any version, returns the version or 0 if it's not a resource file.
+========================
+*/
+int idResourceContainer::ReadTable( idFile* f, idList< idResourceCacheEntry >& entries )
+{
+	entries.Clear();
+	
+	uint32 magic = 0;
+	f->Seek( 0, FS_SEEK_SET );
+	f->ReadBig( magic );
+	
+	if( magic == RESOURCE_FILE_MAGIC )
+	{
+		int _tableOffset = 0;
+		int _tableLength = 0;
+		f->ReadBig( _tableOffset );
+		f->ReadBig( _tableLength );
+		// read this into a memory buffer with a single read
+		char* const buf = ( char* )Mem_Alloc( _tableLength, TAG_RESOURCE );
+		f->Seek( _tableOffset, FS_SEEK_SET );
+		f->Read( buf, _tableLength );
+		idFile_Memory memFile( "resourceHeader", ( const char* )buf, _tableLength );
+		
+		int _numFileResources = 0;
+		memFile.ReadBig( _numFileResources );
+		entries.SetNum( _numFileResources );
+		for( int i = 0; i < _numFileResources; i++ )
+		{
+			entries[ i ].Read( &memFile );
+			entries[ i ].filename.BackSlashesToSlashes();
+			entries[ i ].filename.ToLower();
+		}
+		Mem_Free( buf );
+		return 1;
+	}
+	
+	if( magic == RESOURCE_FILE_MAGIC_V2 )
+	{
+		// let the container do the checking
+		idResourceContainer container;
+		container.resourceFile = f;
+		container.fileName = f->GetName();
+		const bool valid = container.InitTableV2();
+		if( valid )
+		{
+			entries.SetNum( container.numFileResources );
+			for( int i = 0; i < container.numFileResources; i++ )
+			{
+				container.GetEntryV2( i, entries[ i ] );
+			}
+		}
+		container.resourceFile = NULL;
+		return valid ? 2 : 0;
+	}
+	
+	return 0;
+}
+
+/*
+========================
+idResourceContainer::ReadEntryData
+
+Returns the uncompressed data of a file in a resource file of any version.
+========================
+*/
+byte* idResourceContainer::ReadEntryData( idFile* f, const idResourceCacheEntry& entry )
+{
+	byte* data = ( byte* )Mem_Alloc( entry.length, TAG_RESOURCE );
+	if( !entry.IsCompressed() )
+	{
+		f->Seek( entry.offset, FS_SEEK_SET );
+		f->Read( data, entry.length );
+		return data;
+	}
+	
+	byte* compressed = ( byte* )Mem_Alloc( entry.compressedLength, TAG_TEMP );
+	f->Seek( entry.offset, FS_SEEK_SET );
+	f->Read( compressed, entry.compressedLength );
+	if( !InflateResource( compressed, entry.compressedLength, data, entry.length ) )
+	{
+		idLib::Warning( "%s in resource file %s is corrupt", entry.filename.c_str(), f->GetName() );
+		memset( data, 0, entry.length );
+	}
+	Mem_Free( compressed );
+	return data;
+}
+
+/*
+========================
+idResourceContainer::ReserveHeader
+
+Leaves room for the header, which is written by WriteTable.
+========================
+*/
+void idResourceContainer::ReserveHeader( idFile* f, int version )
+{
+	const int headerLength = ( version == 2 ) ? sizeof( resourceHeaderV2_t ) : 3 * sizeof( int );
+	for( int i = 0; i < headerLength; i += sizeof( int ) )
+	{
+		f->WriteBig( 0 );
+	}
+}
+
+/*
+========================
+idResourceContainer::WriteEntryData
+
+Writes the data of a file and sets the offset, the compressed length and the checksum of the entry.
+========================
+*/
+void idResourceContainer::WriteEntryData( idFile* f, int version, idResourceCacheEntry& entry, const byte* data )
+{
+	entry.compressedLength = 0;
+	entry.checksum = 0;
+	
+	if( version != 2 )
+	{
+		entry.offset = f->Tell();
+		f->Write( data, entry.length );
+		return;
+	}
+	
+	// align the file so it will be usable if memory mapped
+	static const byte padding[ RESOURCE_V2_ALIGNMENT ] = { 0 };
+	f->Write( padding, ( RESOURCE_V2_ALIGNMENT - ( f->Tell() & ( RESOURCE_V2_ALIGNMENT - 1 ) ) ) & ( RESOURCE_V2_ALIGNMENT - 1 ) );
+	entry.offset = f->Tell();
+	if( entry.length == 0 )
+	{
+		return;
+	}
+	
+	entry.checksum = CRC32_BlockChecksum( data, entry.length );
+	
+	const int maxCompressedLength = entry.length - entry.length / RESOURCE_V2_MIN_SAVING;
+	byte* compressed = ( byte* )Mem_Alloc( Max( maxCompressedLength, 1 ), TAG_TEMP );
+	entry.compressedLength = DeflateResource( data, entry.length, compressed, maxCompressedLength );
+	if( entry.IsCompressed() )
+	{
+		f->Write( compressed, entry.compressedLength );
+	}
+	else
+	{
+		f->Write( data, entry.length );
+	}
+	Mem_Free( compressed );
+}
+
+/*
+========================
+idResourceContainer::WriteTable
+
+Writes the table after the files and goes back to write the header.
+========================
+*/
+void idResourceContainer::WriteTable( idFile* f, int version, idList< idResourceCacheEntry >& entries )
+{
+	if( version != 2 )
+	{
+		const int _tableOffset = f->Tell();
+		f->WriteBig( entries.Num() );
+		
+		// write the individual resource entries
+		for( int i = 0; i < entries.Num(); i++ )
+		{
+			entries[ i ].Write( f );
+		}
+		
+		// go back and write the header offsets again, now that we have file offsets and lengths
+		const int _tableLength = f->Tell() - _tableOffset;
+		f->Seek( 0, FS_SEEK_SET );
+		f->WriteBig( RESOURCE_FILE_MAGIC );
+		f->WriteBig( _tableOffset );
+		f->WriteBig( _tableLength );
+		return;
+	}
+	
+	const int numEntries = entries.Num();
+	
+	// canonical names and their hashes, the last of duplicate names is the one that's found
+	idList< idStrStatic< 256 > > names;
+	idList< uint64 > hashes;
+	idList< int > unique;
+	idHashIndex nameHash( 4096, Max( numEntries, 1 ) );
+	names.SetNum( numEntries );
+	hashes.SetNum( numEntries );
+	unique.Resize( numEntries );
+	for( int i = numEntries - 1; i >= 0; i-- )
+	{
+		names[ i ] = entries[ i ].filename;
+		names[ i ].BackSlashesToSlashes();
+		names[ i ].ToLower();
+		hashes[ i ] = HashName( names[ i ] );
+		
+		const int key = nameHash.GenerateKey( names[ i ], true );
+		int j = nameHash.GetFirst( key );
+		for( ; j != idHashIndex::NULL_INDEX; j = nameHash.GetNext( j ) )
+		{
+			if( names[ j ] == names[ i ] )
+			{
+				break;
+			}
+		}
+		if( j == idHashIndex::NULL_INDEX )
+		{
+			nameHash.Add( key, i );
+			unique.Append( i );
+		}
+	}
+	
+	// build the perfect hash, the biggest buckets are placed first while most slots are still free
+	uint32 numBuckets = ( numEntries > 0 ) ? Max( unique.Num() / 2, 1 ) : 0;
+	idList< uint32 > seeds;
+	idList< uint32 > slots;
+	seeds.AssureSize( numBuckets, 0 );
+	slots.AssureSize( numEntries, RESOURCE_V2_EMPTY_SLOT );
+	
+	idList< int > bucketSize;
+	idList< int > bucketFirst;
+	idList< int > bucketMembers;
+	bucketSize.AssureSize( numBuckets, 0 );
+	bucketFirst.AssureSize( numBuckets + 1, 0 );
+	bucketMembers.SetNum( unique.Num() );
+	for( int i = 0; i < unique.Num(); i++ )
+	{
+		bucketSize[( uint32 )( hashes[ unique[ i ] ] >> 32 ) % numBuckets ]++;
+	}
+	for( uint32 b = 0; b < numBuckets; b++ )
+	{
+		bucketFirst[ b + 1 ] = bucketFirst[ b ] + bucketSize[ b ];
+	}
+	idList< int > bucketFill;
+	bucketFill.AssureSize( numBuckets, 0 );
+	for( int i = 0; i < unique.Num(); i++ )
+	{
+		const uint32 b = ( uint32 )( hashes[ unique[ i ] ] >> 32 ) % numBuckets;
+		bucketMembers[ bucketFirst[ b ] + bucketFill[ b ]++ ] = unique[ i ];
+	}
+	
+	idList< int > bucketOrder;
+	bucketOrder.SetNum( numBuckets );
+	for( uint32 b = 0; b < numBuckets; b++ )
+	{
+		bucketOrder[ b ] = b;
+	}
+	struct idSort_BucketSize : public idSort_Quick< int, idSort_BucketSize >
+	{
+		const idList< int >* sizes;
+		int Compare( const int& a, const int& b ) const
+		{
+			return ( *sizes )[ b ] - ( *sizes )[ a ];
+		}
+	};
+	idSort_BucketSize bucketSort;
+	bucketSort.sizes = &bucketSize;
+	bucketOrder.SortWithTemplate( bucketSort );
+	
+	for( uint32 i = 0; i < numBuckets && bucketSize[ bucketOrder[ i ] ] > 0; i++ )
+	{
+		const int b = bucketOrder[ i ];
+		const int first = bucketFirst[ b ];
+		const int num = bucketSize[ b ];
+		uint32 seed = 0;
+		for( ; seed < RESOURCE_V2_MAX_SEED; seed++ )
+		{
+			int placed = 0;
+			for( ; placed < num; placed++ )
+			{
+				const int entry = bucketMembers[ first + placed ];
+				const uint32 slot = ResourceSlot( hashes[ entry ], seed, numEntries );
+				if( slots[ slot ] != RESOURCE_V2_EMPTY_SLOT )
+				{
+					break;
+				}
+				slots[ slot ] = entry;
+			}
+			if( placed == num )
+			{
+				break;
+			}
+			// take the names of this try out again
+			for( int j = 0; j < placed; j++ )
+			{
+				slots[ ResourceSlot( hashes[ bucketMembers[ first + j ] ], seed, numEntries ) ] = RESOURCE_V2_EMPTY_SLOT;
+			}
+		}
+		if( seed == RESOURCE_V2_MAX_SEED )
+		{
+			// only happens with 64 bit hash collisions, the table has to be searched
+			idLib::Warning( "No perfect hash for the resource file table, names will be searched" );
+			numBuckets = 0;
+			break;
+		}
+		seeds[ b ] = seed;
+	}
+	
+	// the table is built in memory so the checksum can be put in the header
+	idFile_Memory table( "resourceTable" );
+	idList< int > nameOffsets;
+	int nameLength = 0;
+	nameOffsets.SetNum( numEntries );
+	for( int i = 0; i < numEntries; i++ )
+	{
+		nameOffsets[ i ] = nameLength;
+		nameLength += names[ i ].Length() + 1;
+	}
+	for( int i = 0; i < numEntries; i++ )
+	{
+		const idResourceCacheEntry& ent = entries[ i ];
+		table.WriteBig( ( int64 )ent.offset );
+		table.WriteBig( ent.length );
+		table.WriteBig( ent.compressedLength );
+		table.WriteBig( ent.checksum );
+		table.WriteBig( ( uint32 )( hashes[ i ] >> 32 ) );
+		table.WriteBig( nameOffsets[ i ] );
+		table.WriteBig( 0 );
+	}
+	if( numBuckets > 0 )
+	{
+		table.WriteBigArray( seeds.Ptr(), numBuckets );
+		table.WriteBigArray( slots.Ptr(), numEntries );
+	}
+	for( int i = 0; i < numEntries; i++ )
+	{
+		table.Write( names[ i ].c_str(), names[ i ].Length() + 1 );
+	}
+	
+	static const byte padding[ RESOURCE_V2_ALIGNMENT ] = { 0 };
+	f->Write( padding, ( RESOURCE_V2_ALIGNMENT - ( f->Tell() & ( RESOURCE_V2_ALIGNMENT - 1 ) ) ) & ( RESOURCE_V2_ALIGNMENT - 1 ) );
+	
+	resourceHeaderV2_t header;
+	header.magic = RESOURCE_FILE_MAGIC_V2;
+	header.numFileResources = numEntries;
+	header.tableOffset = f->Tell();
+	header.tableLength = table.Length();
+	header.numBuckets = numBuckets;
+	header.tableChecksum = CRC32_BlockChecksum( table.GetDataPtr(), table.Length() );
+	header.reserved = 0;
+	
+	f->Write( table.GetDataPtr(), table.Length() );
+	
+	f->Seek( 0, FS_SEEK_SET );
+	f->WriteBig( header.magic );
+	f->WriteBig( header.numFileResources );
+	f->WriteBig( header.tableOffset );
+	f->WriteBig( header.tableLength );
+	f->WriteBig( header.numBuckets );
+	f->WriteBig( header.tableChecksum );
+	f->WriteBig( header.reserved );
+}
 
 /*
 ========================
@@ -185,87 +1018,55 @@ void idResourceContainer::UpdateResourceFile( const char* _filename, const idStr
 		return;
 	}
 	
-	uint32 magic = 0;
-	int _tableOffset = 0;
-	int _tableLength = 0;
+	int version = fs_resourceFormat.GetInteger();
 	idList< idResourceCacheEntry > entries;
 	idStrList filesToUpdate = _filesToUpdate;
 	
 	idFile* inFile = fileSystem->OpenFileRead( _filename );
-	if( inFile == NULL )
-	{
-		magic = RESOURCE_FILE_MAGIC;
-		
-		outFile->WriteBig( magic );
-		outFile->WriteBig( _tableOffset );
-		outFile->WriteBig( _tableLength );
-		
-	}
-	else
+	if( inFile != NULL )
 	{
-		inFile->ReadBig( magic );
-		if( magic != RESOURCE_FILE_MAGIC )
+		// keep the version of the file that's updated
+		version = ReadTable( inFile, entries );
+		if( version == 0 )
 		{
 			delete inFile;
+			delete outFile;
 			return;
 		}
+	}
+	
+	ReserveHeader( outFile, version );
+	
+	for( int i = 0; i < entries.Num(); i++ )
+	{
+		idLib::Printf( "examining %s\n", entries[ i ].filename.c_str() );
+		byte* fileData = NULL;
 		
-		inFile->ReadBig( _tableOffset );
-		inFile->ReadBig( _tableLength );
-		// read this into a memory buffer with a single read
-		char* const buf = ( char* )Mem_Alloc( _tableLength, TAG_RESOURCE );
-		inFile->Seek( _tableOffset, FS_SEEK_SET );
-		inFile->Read( buf, _tableLength );
-		idFile_Memory memFile( "resourceHeader", ( const char* )buf, _tableLength );
-		
-		int _numFileResources = 0;
-		memFile.ReadBig( _numFileResources );
-		
-		outFile->WriteBig( magic );
-		outFile->WriteBig( _tableOffset );
-		outFile->WriteBig( _tableLength );
-		
-		entries.SetNum( _numFileResources );
-		
-		for( int i = 0; i < _numFileResources; i++ )
+		for( int j = filesToUpdate.Num() - 1; j >= 0; j-- )
 		{
-			entries[ i ].Read( &memFile );
-			
-			
-			idLib::Printf( "examining %s\n", entries[ i ].filename.c_str() );
-			byte* fileData = NULL;
-			
-			for( int j = filesToUpdate.Num() - 1; j >= 0; j-- )
+			if( filesToUpdate[ j ].Icmp( entries[ i ].filename ) == 0 )
 			{
-				if( filesToUpdate[ j ].Icmp( entries[ i ].filename ) == 0 )
+				idFile* newFile = fileSystem->OpenFileReadMemory( filesToUpdate[ j ] );
+				if( newFile != NULL )
 				{
-					idFile* newFile = fileSystem->OpenFileReadMemory( filesToUpdate[ j ] );
-					if( newFile != NULL )
-					{
-						idLib::Printf( "Updating %s\n", filesToUpdate[ j ].c_str() );
-						entries[ i ].length = newFile->Length();
-						fileData = ( byte* )Mem_Alloc( entries[ i ].length, TAG_TEMP );
-						newFile->Read( fileData, newFile->Length() );
-						delete newFile;
-					}
-					filesToUpdate.RemoveIndex( j );
+					idLib::Printf( "Updating %s\n", filesToUpdate[ j ].c_str() );
+					entries[ i ].length = newFile->Length();
+					fileData = ( byte* )Mem_Alloc( entries[ i ].length, TAG_TEMP );
+					newFile->Read( fileData, newFile->Length() );
+					delete newFile;
 				}
+				filesToUpdate.RemoveIndex( j );
 			}
-			
-			if( fileData == NULL )
-			{
-				inFile->Seek( entries[ i ].offset, FS_SEEK_SET );
-				fileData = ( byte* )Mem_Alloc( entries[ i ].length, TAG_TEMP );
-				inFile->Read( fileData, entries[ i ].length );
-			}
-			
-			entries[ i ].offset = outFile->Tell();
-			outFile->Write( ( void* )fileData, entries[ i ].length );
-			
-			Mem_Free( fileData );
 		}
 		
-		Mem_Free( buf );
+		if( fileData == NULL )
+		{
+			fileData = ReadEntryData( inFile, entries[ i ] );
+		}
+		
+		WriteEntryData( outFile, version, entries[ i ], fileData );
+		
+		Mem_Free( fileData );
 	}
 	
 	while( filesToUpdate.Num() > 0 )
@@ -282,8 +1083,7 @@ void idResourceContainer::UpdateResourceFile( const char* _filename, const idStr
 			int idx = entries.Append( rt );
 			if( idx >= 0 )
 			{
-				entries[ idx ].offset = outFile->Tell();
-				outFile->Write( ( void* )fileData, entries[ idx ].length );
+				WriteEntryData( outFile, version, entries[ idx ], fileData );
 			}
 			delete newFile;
 			Mem_Free( fileData );
@@ -291,21 +1091,7 @@ void idResourceContainer::UpdateResourceFile( const char* _filename, const idStr
 		filesToUpdate.RemoveIndex( 0 );
 	}
 	
-	_tableOffset = outFile->Tell();
-	outFile->WriteBig( entries.Num() );
-	
-	// write the individual resource entries
-	for( int i = 0; i < entries.Num(); i++ )
-	{
-		entries[ i ].Write( outFile );
-	}
-	
-	// go back and write the header offsets again, now that we have file offsets and lengths
-	_tableLength = outFile->Tell() - _tableOffset;
-	outFile->Seek( 0, FS_SEEK_SET );
-	outFile->WriteBig( magic );
-	outFile->WriteBig( _tableOffset );
-	outFile->WriteBig( _tableLength );
+	WriteTable( outFile, version, entries );
 	
 	delete outFile;
 	delete inFile;
@@ -319,6 +1105,7 @@ idResourceContainer::ExtractResourceFile
 */
 void idResourceContainer::SetContainerIndex( const int& _idx )
 {
+	containerIndex = _idx;
 	for( int i = 0; i < cacheTable.Num(); i++ )
 	{
 		cacheTable[ i ].containerIndex = _idx;
@@ -340,33 +1127,16 @@ void idResourceContainer::ExtractResourceFile( const char* _fileName, const char
 		return;
 	}
 	
-	uint32 magic;
-	inFile->ReadBig( magic );
-	if( magic != RESOURCE_FILE_MAGIC )
+	idList< idResourceCacheEntry > entries;
+	if( ReadTable( inFile, entries ) == 0 )
 	{
 		delete inFile;
 		return;
 	}
 	
-	int _tableOffset;
-	int _tableLength;
-	inFile->ReadBig( _tableOffset );
-	inFile->ReadBig( _tableLength );
-	// read this into a memory buffer with a single read
-	char* const buf = ( char* )Mem_Alloc( _tableLength, TAG_RESOURCE );
-	inFile->Seek( _tableOffset, FS_SEEK_SET );
-	inFile->Read( buf, _tableLength );
-	idFile_Memory memFile( "resourceHeader", ( const char* )buf, _tableLength );
-	
-	int _numFileResources;
-	memFile.ReadBig( _numFileResources );
-	
-	for( int i = 0; i < _numFileResources; i++ )
+	for( int i = 0; i < entries.Num(); i++ )
 	{
-		idResourceCacheEntry rt;
-		rt.Read( &memFile );
-		rt.filename.BackSlashesToSlashes();
-		rt.filename.ToLower();
+		idResourceCacheEntry& rt = entries[ i ];
 		byte* fbuf = NULL;
 		if( _copyWavs && ( rt.filename.Find( ".idwav" ) >= 0 ||  rt.filename.Find( ".idxma" ) >= 0 ||  rt.filename.Find( ".idmsf" ) >= 0 ) )
 		{
@@ -378,9 +1148,7 @@ void idResourceContainer::ExtractResourceFile( const char* _fileName, const char
 		}
 		else
 		{
-			inFile->Seek( rt.offset, FS_SEEK_SET );
-			fbuf = ( byte* )Mem_Alloc( rt.length, TAG_RESOURCE );
-			inFile->Read( fbuf, rt.length );
+			fbuf = ReadEntryData( inFile, rt );
 		}
 		idStr outName = _outPath;
 		outName.AppendPath( rt.filename );
@@ -393,11 +1161,8 @@ void idResourceContainer::ExtractResourceFile( const char* _fileName, const char
 		Mem_Free( fbuf );
 	}
 	delete inFile;
-	Mem_Free( buf );
 }
 
-
-
 /*
 ========================
 idResourceContainer::Open
@@ -470,14 +1235,8 @@ void idResourceContainer::WriteResourceFile( const char* manifestName, const idS
 		
 		idLib::Printf( "Writing resource file %s\n", fileName.c_str() );
 		
-		int	tableOffset = 0;
-		int	tableLength = 0;
-		int	tableNewLength = 0;
-		uint32	resourceFileMagic = RESOURCE_FILE_MAGIC;
-		
-		resFile->WriteBig( resourceFileMagic );
-		resFile->WriteBig( tableOffset );
-		resFile->WriteBig( tableLength );
+		const int version = fs_resourceFormat.GetInteger();
+		ReserveHeader( resFile, version );
 		
 		idList< idResourceCacheEntry > entries;
 		
@@ -497,28 +1256,17 @@ void idResourceContainer::WriteResourceFile( const char* manifestName, const idS
 			{
 				continue;
 			}
-			// if the entry is uncompressed, align the file pointer to a 16 byte boundary
-			// so it will be usable if memory mapped
 			ent.length = fm->Length();
 			
 			// always get the offset, even if the file will have zero length
-			ent.offset = resFile->Tell();
+			WriteEntryData( resFile, version, ent, ( const byte* )fm->GetDataPtr() );
 			
 			entries.Append( ent );
 			
-			if( ent.length == 0 )
-			{
-				ent.filename = "";
-				delete fm;
-				continue;
-			}
-			
-			resFile->Write( fm->GetDataPtr(), ent.length );
-			
 			delete fm;
 			
 			// pacifier every ten megs
-			if( ( ent.offset + ent.length ) / 10000000 != ent.offset / 10000000 )
+			if( ( ent.offset + ent.StoredLength() ) / 10000000 != ent.offset / 10000000 )
 			{
 				idLib::Printf( "." );
 			}
@@ -527,30 +1275,7 @@ void idResourceContainer::WriteResourceFile( const char* manifestName, const idS
 		idLib::Printf( "\n" );
 		
 		// write the table out now that we have all the files
-		tableOffset = resFile->Tell();
-		
-		// count how many we are going to write for this platform
-		int	numFileResources = entries.Num();
-		
-		resFile->WriteBig( numFileResources );
-		
-		// write the individual resource entries
-		for( int i = 0; i < entries.Num(); i++ )
-		{
-			entries[ i ].Write( resFile );
-			if( i + 1 == numFileResources )
-			{
-				// we just wrote out the last new entry
-				tableNewLength = resFile->Tell() - tableOffset;
-			}
-		}
-		
-		// go back and write the header offsets again, now that we have file offsets and lengths
-		tableLength = resFile->Tell() - tableOffset;
-		resFile->Seek( 0, FS_SEEK_SET );
-		resFile->WriteBig( resourceFileMagic );
-		resFile->WriteBig( tableOffset );
-		resFile->WriteBig( tableLength );
+		WriteTable( resFile, version, entries );
 		delete resFile;
 	}
 }
@@ -34,9 +34,20 @@ If you have questions concerning this license or the applicable additional terms
 
   Resource containers
 
+  Version 1 containers store the files uncompressed, followed by a table of names, 32 bit offsets
+  and lengths that is parsed when the container is opened.
+
+  Version 2 containers store every file either uncompressed or deflated, whichever is smaller,
+  with a checksum of the uncompressed data. The table is used as it is on disk: fixed size entries
+  with 64 bit offsets, a perfect hash of the canonical (lower case, forward slashes) file names
+  and the names themselves.
+
 ==============================================================
 */
 
+static const uint32 RESOURCE_FILE_MAGIC = 0xD000000D;
+static const uint32 RESOURCE_FILE_MAGIC_V2 = 0xD200000D;
+
 class idResourceCacheEntry
 {
 public:
@@ -50,8 +61,11 @@ public:
 		//filename = NULL;
 		offset = 0;
 		length = 0;
+		compressedLength = 0;
+		checksum = 0;
 		containerIndex = 0;
 	}
+	// version 1 table entries
 	size_t Read( idFile* f )
 	{
 		size_t sz = f->ReadString( filename );
@@ -66,13 +80,46 @@ public:
 		sz += f->WriteBig( length );
 		return sz;
 	}
+	bool IsCompressed() const
+	{
+		return compressedLength > 0;
+	}
+	// number of bytes in the resource file
+	int StoredLength() const
+	{
+		return IsCompressed() ? compressedLength : length;
+	}
 	idStrStatic< 256 >	filename;
 	int					offset;							// into the resource file
 	int 				length;
+	int					compressedLength;				// 0 if stored uncompressed
+	uint32				checksum;						// CRC32 of the uncompressed data, 0 if there is none
 	uint8				containerIndex;
 };
 
-static const uint32 RESOURCE_FILE_MAGIC = 0xD000000D;
+// version 2 header and table entries, big endian on disk
+struct resourceHeaderV2_t
+{
+	uint32			magic;
+	uint32			numFileResources;
+	int64			tableOffset;
+	int32			tableLength;
+	uint32			numBuckets;			// perfect hash buckets, 0 if the table has to be searched
+	uint32			tableChecksum;		// CRC32 of the table
+	uint32			reserved;
+};
+
+struct resourceEntryV2_t
+{
+	int64			offset;
+	int32			length;
+	int32			compressedLength;	// 0 if stored uncompressed
+	uint32			checksum;
+	uint32			nameHash;			// high 32 bits of the 64 bit name hash
+	uint32			nameOffset;			// into the name block
+	uint32			reserved;
+};
+
 class idResourceContainer
 {
 	friend class	idFileSystemLocal;
@@ -85,9 +132,23 @@ public:
 		tableLength = 0;
 		resourceMagic = 0;
 		numFileResources = 0;
+		containerIndex = 0;
+		tableV2 = NULL;
+		tableV2Owned = false;
+		entriesV2 = NULL;
+		bucketsV2 = NULL;
+		slotsV2 = NULL;
+		namesV2 = NULL;
+		namesV2Length = 0;
+		numBucketsV2 = 0;
+		mappedData = NULL;
+		mappedLength = 0;
+		mappedBySystem = false;
 	}
 	~idResourceContainer()
 	{
+		FreeTableV2();
+		Unmap();
 		delete resourceFile;
 		cacheTable.Clear();
 	}
@@ -104,7 +165,39 @@ public:
 	}
 	void SetContainerIndex( const int& _idx );
 	void ReOpen();
+	// the whole container if it's in memory, files can be read straight out of it
+	const byte* GetMappedData() const
+	{
+		return mappedData;
+	}
+	
+	int NumFileResources() const
+	{
+		return numFileResources;
+	}
+	// canonical name of a file in the container
+	const char* GetResourceName( int index ) const;
+	// looks up a canonical file name, the hash is from HashName
+	bool FindResource( const char* canonicalName, uint64 hash, idResourceCacheEntry& rc ) const;
+	// reads and uncompresses the whole file, dest has to hold rc.length bytes
+	bool ReadResource( const idResourceCacheEntry& rc, byte* dest ) const;
+	// opens a file that's compressed or in a container in memory
+	idFile* OpenResource( const idResourceCacheEntry& rc ) const;
+	static uint64 HashName( const char* canonicalName );
+	
 private:
+	void Map();
+	void Unmap();
+	bool InitTableV2();
+	void FreeTableV2();
+	void GetEntryV2( int index, idResourceCacheEntry& rc ) const;
+	
+	static int ReadTable( idFile* f, idList< idResourceCacheEntry >& entries );
+	static byte* ReadEntryData( idFile* f, const idResourceCacheEntry& entry );
+	static void ReserveHeader( idFile* f, int version );
+	static void WriteEntryData( idFile* f, int version, idResourceCacheEntry& entry, const byte* data );
+	static void WriteTable( idFile* f, int version, idList< idResourceCacheEntry >& entries );
+	
 	idStrStatic< 256 > fileName;
 	idFile* 	resourceFile;			// open file handle
 	// offset should probably be a 64 bit value for development, but 4 gigs won't fit on
@@ -113,8 +206,23 @@ private:
 	int		tableLength;			// table length
 	int		resourceMagic;			// magic
 	int		numFileResources;		// number of file resources in this container
-	idList< idResourceCacheEntry, TAG_RESOURCE>	cacheTable;
+	uint8	containerIndex;
+	idList< idResourceCacheEntry, TAG_RESOURCE>	cacheTable;		// version 1 only
 	idHashIndex	cacheHash;
+	
+	// version 2 table, in the mapped container or read into memory
+	const byte* tableV2;
+	bool		tableV2Owned;
+	const resourceEntryV2_t* entriesV2;
+	const uint32* bucketsV2;
+	const uint32* slotsV2;
+	const char* namesV2;
+	int			namesV2Length;
+	uint32		numBucketsV2;
+	
+	const byte* mappedData;			// memory mapped container or the data of a memory file
+	int			mappedLength;
+	bool		mappedBySystem;			// needs to be unmapped
 };
 
 
@@ -31,6 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 idStrPool		idDict::globalKeys;
 idStrPool		idDict::globalValues;
+bool			idDict::globalKeysReady;
+idDictSymbol* 	idDictSymbol::symbols;
 
 /*
 ================
@@ -88,7 +90,7 @@ void idDict::Copy( const idDict& other )
 		found = ( int* ) _alloca16( other.args.Num() * sizeof( int ) );
 		for( i = 0; i < n; i++ )
 		{
-			found[i] = FindKeyIndex( other.args[i].GetKey() );
+			found[i] = FindPoolKeyIndex( other.args[i].key, argHash.GenerateKey( other.args[i].GetKey(), false ) );
 		}
 	}
 	else
@@ -202,19 +204,19 @@ idDict::SetDefaults
 void idDict::SetDefaults( const idDict* dict )
 {
 	int i, n;
-	const idKeyValue* kv, *def;
+	const idKeyValue* def;
 	idKeyValue newkv;
 	
 	n = dict->args.Num();
 	for( i = 0; i < n; i++ )
 	{
 		def = &dict->args[i];
-		kv = FindKey( def->GetKey() );
-		if( !kv )
+		const int hash = argHash.GenerateKey( def->GetKey(), false );
+		if( FindPoolKeyIndex( def->key, hash ) == -1 )
 		{
 			newkv.key = globalKeys.CopyString( def->key );
 			newkv.value = globalValues.CopyString( def->value );
-			argHash.Add( argHash.GenerateKey( newkv.GetKey(), false ), args.Append( newkv ) );
+			argHash.Add( hash, args.Append( newkv ) );
 		}
 	}
 }
@@ -440,6 +442,39 @@ bool idDict::GetBool( const char* key, const bool defaultBool, bool& out ) const
 	}
 }
 
+/*
+================
+ParseAngles
+================
+*/
+static void ParseAngles( const char* s, idAngles& out )
+{
+	out.Zero();
+	sscanf( s, "%f %f %f", &out.pitch, &out.yaw, &out.roll );
+}
+
+/*
+================
+ParseVector
+================
+*/
+static void ParseVector( const char* s, idVec3& out )
+{
+	out.Zero();
+	sscanf( s, "%f %f %f", &out.x, &out.y, &out.z );
+}
+
+/*
+================
+ParseMatrix
+================
+*/
+static void ParseMatrix( const char* s, idMat3& out )
+{
+	out.Identity();		// sccanf has a bug in it on Mac OS 9.  Sigh.
+	sscanf( s, "%f %f %f %f %f %f %f %f %f", &out[0].x, &out[0].y, &out[0].z, &out[1].x, &out[1].y, &out[1].z, &out[2].x, &out[2].y, &out[2].z );
+}
+
 /*
 ================
 idDict::GetAngles
@@ -456,8 +491,7 @@ bool idDict::GetAngles( const char* key, const char* defaultString, idAngles& ou
 	}
 	
 	found = GetString( key, defaultString, &s );
-	out.Zero();
-	sscanf( s, "%f %f %f", &out.pitch, &out.yaw, &out.roll );
+	ParseAngles( s, out );
 	return found;
 }
 
@@ -477,8 +511,7 @@ bool idDict::GetVector( const char* key, const char* defaultString, idVec3& out
 	}
 	
 	found = GetString( key, defaultString, &s );
-	out.Zero();
-	sscanf( s, "%f %f %f", &out.x, &out.y, &out.z );
+	ParseVector( s, out );
 	return found;
 }
 
@@ -540,8 +573,46 @@ bool idDict::GetMatrix( const char* key, const char* defaultString, idMat3& out
 	}
 	
 	found = GetString( key, defaultString, &s );
-	out.Identity();		// sccanf has a bug in it on Mac OS 9.  Sigh.
-	sscanf( s, "%f %f %f %f %f %f %f %f %f", &out[0].x, &out[0].y, &out[0].z, &out[1].x, &out[1].y, &out[1].z, &out[2].x, &out[2].y, &out[2].z );
+	ParseMatrix( s, out );
+	return found;
+}
+
+/*
+================
+idDict::GetAngles
+================
+*/
+bool idDict::GetAngles( const idDictSymbol& key, const char* defaultString, idAngles& out ) const
+{
+	const char* s;
+	const bool found = GetString( key, ( defaultString != NULL ) ? defaultString : "0 0 0", &s );
+	ParseAngles( s, out );
+	return found;
+}
+
+/*
+================
+idDict::GetVector
+================
+*/
+bool idDict::GetVector( const idDictSymbol& key, const char* defaultString, idVec3& out ) const
+{
+	const char* s;
+	const bool found = GetString( key, ( defaultString != NULL ) ? defaultString : "0 0 0", &s );
+	ParseVector( s, out );
+	return found;
+}
+
+/*
+================
+idDict::GetMatrix
+================
+*/
+bool idDict::GetMatrix( const idDictSymbol& key, const char* defaultString, idMat3& out ) const
+{
+	const char* s;
+	const bool found = GetString( key, ( defaultString != NULL ) ? defaultString : "1 0 0 0 1 0 0 0 1", &s );
+	ParseMatrix( s, out );
 	return found;
 }
 
@@ -613,6 +684,52 @@ int idDict::FindKeyIndex( const char* key ) const
 	return -1;
 }
 
+/*
+================
+idDict::FindKeyIndex
+================
+*/
+int idDict::FindKeyIndex( const idDictSymbol& key ) const
+{
+	if( args.Num() == 0 )
+	{
+		return -1;
+	}
+	
+	if( key.poolKey == NULL )
+	{
+		// the key pool is not up yet
+		return FindKeyIndex( key.name );
+	}
+	
+	return FindPoolKeyIndex( key.poolKey, argHash.GenerateKey( key.hash ) );
+}
+
+/*
+================
+idDict::FindPoolKeyIndex
+
+Keys from the same case insensitive pool are equal only when the pointers are equal. Without
+MONOLITH the game DLL has its own key pool, keys from another pool are compared as strings.
+================
+*/
+int idDict::FindPoolKeyIndex( const idPoolStr* key, const int hash ) const
+{
+	for( int i = argHash.First( hash ); i != -1; i = argHash.Next( i ) )
+	{
+		const idPoolStr* argKey = args[i].key;
+		if( argKey == key )
+		{
+			return i;
+		}
+		if( argKey->GetPool() != key->GetPool() && argKey->Icmp( *key ) == 0 )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
 /*
 ================
 idDict::Delete
@@ -1033,6 +1150,14 @@ void idDict::Init()
 {
 	globalKeys.SetCaseSensitive( false );
 	globalValues.SetCaseSensitive( true );
+	
+	globalKeysReady = true;
+	
+	// intern the symbols made before the key pool was up, lookups never do it
+	for( const idDictSymbol* symbol = idDictSymbol::symbols; symbol != NULL; symbol = symbol->next )
+	{
+		symbol->Intern();
+	}
 }
 
 /*
@@ -1042,10 +1167,110 @@ idDict::Shutdown
 */
 void idDict::Shutdown()
 {
+	// the pooled keys of the symbols are freed with the pool
+	for( const idDictSymbol* symbol = idDictSymbol::symbols; symbol != NULL; symbol = symbol->next )
+	{
+		symbol->poolKey = NULL;
+	}
+	
+	globalKeysReady = false;
+	
 	globalKeys.Clear();
 	globalValues.Clear();
 }
 
+/*
+================
+idDictSymbol::idDictSymbol
+================
+*/
+idDictSymbol::idDictSymbol( const char* name ) :
+	name( name ),
+	hash( idStr::IHash( name ) ),
+	poolKey( NULL ),
+	next( NULL )
+{
+	assert( name != NULL && name[0] != '\0' );
+	Register();
+}
+
+/*
+================
+idDictSymbol::idDictSymbol
+================
+*/
+idDictSymbol::idDictSymbol( const idDictSymbol& other ) :
+	name( other.name ),
+	hash( other.hash ),
+	poolKey( NULL ),
+	next( NULL )
+{
+	Register();
+}
+
+/*
+================
+idDictSymbol::~idDictSymbol
+
+Static symbols are destroyed after idDict::Shutdown cleared the key pool, they must not
+touch the pool or the list of symbols then.
+================
+*/
+idDictSymbol::~idDictSymbol()
+{
+	if( !idDict::globalKeysReady )
+	{
+		return;
+	}
+	
+	for( idDictSymbol** link = &symbols; *link != NULL; link = &( *link )->next )
+	{
+		if( *link == this )
+		{
+			*link = next;
+			break;
+		}
+	}
+	
+	if( poolKey != NULL )
+	{
+		idDict::globalKeys.FreeString( poolKey );
+		poolKey = NULL;
+	}
+}
+
+/*
+================
+idDictSymbol::Register
+
+Symbols made at static init time are interned by idDict::Init, later ones right away.
+================
+*/
+void idDictSymbol::Register()
+{
+	next = symbols;
+	symbols = this;
+	
+	if( idDict::globalKeysReady )
+	{
+		Intern();
+	}
+}
+
+/*
+================
+idDictSymbol::Intern
+================
+*/
+void idDictSymbol::Intern() const
+{
+	if( poolKey == NULL )
+	{
+		// the reference keeps the pooled string alive for as long as the symbol exists
+		poolKey = idDict::globalKeys.AllocString( name );
+	}
+}
+
 /*
 ================
 idDict::ShowMemoryUsage_f
@@ -95,8 +95,54 @@ public:
 	}
 };
 
+/*
+================================================
+idDictSymbol is a key with a precomputed case insensitive hash. The key is interned in
+the global key pool once, when the symbol is made or by idDict::Init for the symbols
+made before it. Looking up a symbol never touches the key pool so it is safe from
+jobs, and finding the key in a dict only compares pointers unless the dict holds keys
+from the key pool of another module.
+
+The name is not copied, symbols are meant to be made from string literals on the main
+thread and kept around as static or member constants.
+================================================
+*/
+class idDictSymbol
+{
+	friend class idDict;
+	
+public:
+	explicit			idDictSymbol( const char* name );
+	idDictSymbol( const idDictSymbol& other );
+	~idDictSymbol();
+	
+	const char* 		c_str() const
+	{
+		return name;
+	}
+	int					GetHash() const
+	{
+		return hash;
+	}
+	
+private:
+	const char* 		name;
+	int					hash;				// idStr::IHash of the name
+	mutable const idPoolStr* poolKey;		// interned key, NULL while the key pool is down
+	idDictSymbol* 		next;				// next in the list of all symbols
+	
+	static idDictSymbol* symbols;			// all symbols, so idDict::Init can intern them
+	
+	void				Register();
+	void				Intern() const;
+	
+	void				operator=( const idDictSymbol& );
+};
+
 class idDict
 {
+	friend class idDictSymbol;
+	
 public:
 	idDict();
 	idDict( const idDict& other );	// allow declaration with assignment
@@ -165,14 +211,33 @@ public:
 	bool				GetAngles( const char* key, const char* defaultString, idAngles& out ) const;
 	bool				GetMatrix( const char* key, const char* defaultString, idMat3& out ) const;
 	
+	// lookups with symbols only compare pointers
+	const char* 		GetString( const idDictSymbol& key, const char* defaultString = "" ) const;
+	float				GetFloat( const idDictSymbol& key, const char* defaultString ) const;
+	int					GetInt( const idDictSymbol& key, const char* defaultString ) const;
+	bool				GetBool( const idDictSymbol& key, const char* defaultString ) const;
+	float				GetFloat( const idDictSymbol& key, const float defaultFloat = 0.0f ) const;
+	int					GetInt( const idDictSymbol& key, const int defaultInt = 0 ) const;
+	bool				GetBool( const idDictSymbol& key, const bool defaultBool = false ) const;
+	idVec3				GetVector( const idDictSymbol& key, const char* defaultString = NULL ) const;
+	idAngles			GetAngles( const idDictSymbol& key, const char* defaultString = NULL ) const;
+	idMat3				GetMatrix( const idDictSymbol& key, const char* defaultString = NULL ) const;
+	
+	bool				GetString( const idDictSymbol& key, const char* defaultString, const char** out ) const;
+	bool				GetVector( const idDictSymbol& key, const char* defaultString, idVec3& out ) const;
+	bool				GetAngles( const idDictSymbol& key, const char* defaultString, idAngles& out ) const;
+	bool				GetMatrix( const idDictSymbol& key, const char* defaultString, idMat3& out ) const;
+	
 	int					GetNumKeyVals() const;
 	const idKeyValue* 	GetKeyVal( int index ) const;
 	// returns the key/value pair with the given key
 	// returns NULL if the key/value pair does not exist
 	const idKeyValue* 	FindKey( const char* key ) const;
+	const idKeyValue* 	FindKey( const idDictSymbol& key ) const;
 	// returns the index to the key/value pair with the given key
 	// returns -1 if the key/value pair does not exist
 	int					FindKeyIndex( const char* key ) const;
+	int					FindKeyIndex( const idDictSymbol& key ) const;
 	// delete the key/value pair with the given key
 	void				Delete( const char* key );
 	// finds the next key/value pair with the given key prefix.
@@ -209,6 +274,9 @@ private:
 	
 	static idStrPool	globalKeys;
 	static idStrPool	globalValues;
+	static bool			globalKeysReady;		// true between Init and Shutdown
+	
+	int					FindPoolKeyIndex( const idPoolStr* key, const int hash ) const;
 };
 
 
@@ -397,6 +465,100 @@ ID_INLINE idMat3 idDict::GetMatrix( const char* key, const char* defaultString )
 	return out;
 }
 
+ID_INLINE const idKeyValue* idDict::FindKey( const idDictSymbol& key ) const
+{
+	const int index = FindKeyIndex( key );
+	return ( index >= 0 ) ? &args[index] : NULL;
+}
+
+ID_INLINE bool idDict::GetString( const idDictSymbol& key, const char* defaultString, const char** out ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		*out = kv->GetValue();
+		return true;
+	}
+	*out = defaultString;
+	return false;
+}
+
+ID_INLINE const char* idDict::GetString( const idDictSymbol& key, const char* defaultString ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return kv->GetValue();
+	}
+	return defaultString;
+}
+
+ID_INLINE float idDict::GetFloat( const idDictSymbol& key, const char* defaultString ) const
+{
+	return atof( GetString( key, defaultString ) );
+}
+
+ID_INLINE int idDict::GetInt( const idDictSymbol& key, const char* defaultString ) const
+{
+	return atoi( GetString( key, defaultString ) );
+}
+
+ID_INLINE bool idDict::GetBool( const idDictSymbol& key, const char* defaultString ) const
+{
+	return ( atoi( GetString( key, defaultString ) ) != 0 );
+}
+
+ID_INLINE float idDict::GetFloat( const idDictSymbol& key, const float defaultFloat ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atof( kv->GetValue() );
+	}
+	return defaultFloat;
+}
+
+ID_INLINE int idDict::GetInt( const idDictSymbol& key, const int defaultInt ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atoi( kv->GetValue() );
+	}
+	return defaultInt;
+}
+
+ID_INLINE bool idDict::GetBool( const idDictSymbol& key, const bool defaultBool ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atoi( kv->GetValue() ) != 0;
+	}
+	return defaultBool;
+}
+
+ID_INLINE idVec3 idDict::GetVector( const idDictSymbol& key, const char* defaultString ) const
+{
+	idVec3 out;
+	GetVector( key, defaultString, out );
+	return out;
+}
+
+ID_INLINE idAngles idDict::GetAngles( const idDictSymbol& key, const char* defaultString ) const
+{
+	idAngles out;
+	GetAngles( key, defaultString, out );
+	return out;
+}
+
+ID_INLINE idMat3 idDict::GetMatrix( const idDictSymbol& key, const char* defaultString ) const
+{
+	idMat3 out;
+	GetMatrix( key, defaultString, out );
+	return out;
+}
+
 ID_INLINE int idDict::GetNumKeyVals() const
 {
 	return args.Num();
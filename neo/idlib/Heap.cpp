@@ -39,6 +39,102 @@ If you have questions concerning this license or the applicable additional terms
 #include <stdlib.h>
 #undef new
 
+static const char* memTagNames[] =
+{
+#define MEM_TAG( x )	#x,
+#include "sys/sys_alloc_tags.h"
+};
+
+/*
+==================
+Mem_TagName
+==================
+*/
+const char* Mem_TagName( const memTag_t tag )
+{
+	if( tag < 0 || tag >= TAG_NUM_TAGS )
+	{
+		return "?";
+	}
+	return memTagNames[tag];
+}
+
+#if defined( ID_MEMORY_TRACKING )
+
+// stored in front of every tracked allocation, keeps the alignment intact
+union memHeader_t
+{
+	struct
+	{
+		size_t			size;
+		memTag_t		tag;
+	};
+	byte				pad[16];
+};
+
+struct memTagStats_t
+{
+	interlockedInt_t	numBytes;
+	interlockedInt_t	numAllocs;
+	interlockedInt_t	peakBytes;
+	interlockedInt_t	totalAllocs;		// allocations made since startup, freeing doesn't count down
+};
+
+static memTagStats_t	memTagCounters[TAG_NUM_TAGS];
+
+/*
+==================
+Mem_TrackAlloc
+==================
+*/
+static void Mem_TrackAlloc( memHeader_t* header, const size_t size, const memTag_t tag )
+{
+	header->size = size;
+	header->tag = ( tag >= 0 && tag < TAG_NUM_TAGS ) ? tag : TAG_UNSET;
+	
+	memTagStats_t& stats = memTagCounters[header->tag];
+	const interlockedInt_t bytes = Sys_InterlockedAdd( stats.numBytes, ( interlockedInt_t )size );
+	Sys_InterlockedIncrement( stats.numAllocs );
+	Sys_InterlockedIncrement( stats.totalAllocs );
+	
+	for( interlockedInt_t peak = stats.peakBytes; bytes > peak; peak = stats.peakBytes )
+	{
+		if( Sys_InterlockedCompareExchange( stats.peakBytes, peak, bytes ) == peak )
+		{
+			break;
+		}
+	}
+}
+
+/*
+==================
+Mem_GetNumAllocations
+==================
+*/
+int Mem_GetNumAllocations()
+{
+	int total = 0;
+	for( int i = 0; i < TAG_NUM_TAGS; i++ )
+	{
+		total += memTagCounters[i].totalAllocs;
+	}
+	return total;
+}
+
+/*
+==================
+Mem_TrackFree
+==================
+*/
+static void Mem_TrackFree( const memHeader_t* header )
+{
+	memTagStats_t& stats = memTagCounters[header->tag];
+	Sys_InterlockedSub( stats.numBytes, ( interlockedInt_t )header->size );
+	Sys_InterlockedDecrement( stats.numAllocs );
+}
+
+#endif
+
 /*
 ==================
 Mem_Alloc16
@@ -52,17 +148,32 @@ void* Mem_Alloc16( const size_t size, const memTag_t tag )
 	{
 		return NULL;
 	}
+#if defined( ID_MEMORY_TRACKING )
+	const size_t paddedSize = ( ( size + 15 ) & ~15 ) + sizeof( memHeader_t );
+#else
 	const size_t paddedSize = ( size + 15 ) & ~15;
+#endif
+	void* ret;
 #ifdef _WIN32
 	// this should work with MSVC and mingw, as long as __MSVCRT_VERSION__ >= 0x0700
-	return _aligned_malloc( paddedSize, 16 );
+	ret = _aligned_malloc( paddedSize, 16 );
 #else // not _WIN32
 	// DG: the POSIX solution for linux etc
-	void* ret;
-	posix_memalign( &ret, 16, paddedSize );
-	return ret;
+	if( posix_memalign( &ret, 16, paddedSize ) != 0 )
+	{
+		ret = NULL;
+	}
 	// DG end
 #endif // _WIN32
+#if defined( ID_MEMORY_TRACKING )
+	if( ret != NULL )
+	{
+		memHeader_t* header = ( memHeader_t* )ret;
+		Mem_TrackAlloc( header, size, tag );
+		ret = header + 1;
+	}
+#endif
+	return ret;
 }
 
 /*
@@ -76,6 +187,11 @@ void Mem_Free16( void* ptr )
 	{
 		return;
 	}
+#if defined( ID_MEMORY_TRACKING )
+	memHeader_t* header = ( memHeader_t* )ptr - 1;
+	Mem_TrackFree( header );
+	ptr = header;
+#endif
 #ifdef _WIN32
 	_aligned_free( ptr );
 #else // not _WIN32
@@ -110,3 +226,250 @@ char* Mem_CopyString( const char* in )
 	return out;
 }
 
+
+#if defined( ID_MEMORY_TRACKING )
+
+/*
+==============================================================================
+
+	Memory tracking
+
+==============================================================================
+*/
+
+idMemAllocatorStats* idMemAllocatorStats::first = NULL;
+interlockedInt_t idMemAllocatorStats::lock = 0;
+
+/*
+========================
+idMemAllocatorStats::idMemAllocatorStats
+========================
+*/
+idMemAllocatorStats::idMemAllocatorStats( const char* allocatorName, memTag_t memTag, int size ) :
+	name( allocatorName ),
+	tag( memTag ),
+	elementSize( size ),
+	numBytes( 0 ),
+	numAllocs( 0 ),
+	peakBytes( 0 )
+{
+	Link();
+}
+
+/*
+========================
+idMemAllocatorStats::idMemAllocatorStats
+========================
+*/
+idMemAllocatorStats::idMemAllocatorStats( const idMemAllocatorStats& other ) :
+	name( other.name ),
+	tag( other.tag ),
+	elementSize( other.elementSize ),
+	numBytes( 0 ),
+	numAllocs( 0 ),
+	peakBytes( 0 )
+{
+	Link();
+}
+
+/*
+========================
+idMemAllocatorStats::~idMemAllocatorStats
+========================
+*/
+idMemAllocatorStats::~idMemAllocatorStats()
+{
+	Lock();
+	if( prev != NULL )
+	{
+		prev->next = next;
+	}
+	else
+	{
+		first = next;
+	}
+	if( next != NULL )
+	{
+		next->prev = prev;
+	}
+	Unlock();
+}
+
+/*
+========================
+idMemAllocatorStats::Link
+========================
+*/
+void idMemAllocatorStats::Link()
+{
+	Lock();
+	prev = NULL;
+	next = first;
+	if( first != NULL )
+	{
+		first->prev = this;
+	}
+	first = this;
+	Unlock();
+}
+
+/*
+========================
+idMemAllocatorStats::Lock
+========================
+*/
+void idMemAllocatorStats::Lock()
+{
+	// a plain spin lock because allocators can be global objects that are
+	// constructed before anything else is initialized
+	while( Sys_InterlockedIncrement( lock ) != 1 )
+	{
+		Sys_InterlockedDecrement( lock );
+		Sys_Yield();
+	}
+}
+
+/*
+========================
+idMemAllocatorStats::Unlock
+========================
+*/
+void idMemAllocatorStats::Unlock()
+{
+	Sys_InterlockedDecrement( lock );
+}
+
+struct memAllocatorSnapshot_t
+{
+	const idMemAllocatorStats* 	allocator;
+	int							numBytes;
+	int							numAllocs;
+};
+
+static bool								memSnapshotValid = false;
+static memTagStats_t					memSnapshotTags[TAG_NUM_TAGS];
+static idList<memAllocatorSnapshot_t>	memSnapshotAllocators;
+
+/*
+========================
+Mem_PrintTagStats
+========================
+*/
+static void Mem_PrintTagStats( bool diff )
+{
+	int totalBytes = 0;
+	int totalAllocs = 0;
+	int totalMade = 0;
+	
+	// "made" counts every allocation, so it also shows the temporary allocations that were freed again
+	idLib::Printf( "%-24s %12s %10s %12s %10s\n", "tag", diff ? "delta KB" : "KB", diff ? "delta num" : "num", "peak KB", "made" );
+	for( int i = 0; i < TAG_NUM_TAGS; i++ )
+	{
+		const memTagStats_t& stats = memTagCounters[i];
+		int numBytes = stats.numBytes;
+		int numAllocs = stats.numAllocs;
+		int numMade = stats.totalAllocs;
+		if( diff )
+		{
+			numBytes -= memSnapshotTags[i].numBytes;
+			numAllocs -= memSnapshotTags[i].numAllocs;
+			numMade -= memSnapshotTags[i].totalAllocs;
+		}
+		if( numBytes == 0 && numAllocs == 0 && numMade == 0 )
+		{
+			continue;
+		}
+		idLib::Printf( "%-24s %12d %10d %12d %10d\n", memTagNames[i], numBytes >> 10, numAllocs, stats.peakBytes >> 10, numMade );
+		totalBytes += numBytes;
+		totalAllocs += numAllocs;
+		totalMade += numMade;
+	}
+	idLib::Printf( "%-24s %12d %10d %12s %10d\n\n", "total", totalBytes >> 10, totalAllocs, "", totalMade );
+	
+	idLib::Printf( "%-20s %-24s %6s %12s %10s %12s\n", "allocator", "tag", "size", diff ? "delta KB" : "KB", diff ? "delta num" : "num", "peak KB" );
+	idMemAllocatorStats::Lock();
+	for( const idMemAllocatorStats* allocator = idMemAllocatorStats::first; allocator != NULL; allocator = allocator->next )
+	{
+		int numBytes = allocator->numBytes;
+		int numAllocs = allocator->numAllocs;
+		if( diff )
+		{
+			for( int i = 0; i < memSnapshotAllocators.Num(); i++ )
+			{
+				if( memSnapshotAllocators[i].allocator == allocator )
+				{
+					numBytes -= memSnapshotAllocators[i].numBytes;
+					numAllocs -= memSnapshotAllocators[i].numAllocs;
+					break;
+				}
+			}
+		}
+		if( numBytes == 0 && numAllocs == 0 && ( diff || allocator->peakBytes == 0 ) )
+		{
+			continue;
+		}
+		idLib::Printf( "%-20s %-24s %6d %12d %10d %12d\n", allocator->name, Mem_TagName( allocator->tag ), allocator->elementSize, numBytes >> 10, numAllocs, allocator->peakBytes >> 10 );
+	}
+	idMemAllocatorStats::Unlock();
+}
+
+/*
+========================
+Mem_TakeSnapshot
+========================
+*/
+static void Mem_TakeSnapshot()
+{
+	memcpy( memSnapshotTags, memTagCounters, sizeof( memSnapshotTags ) );
+	
+	memSnapshotAllocators.Clear();
+	idMemAllocatorStats::Lock();
+	for( const idMemAllocatorStats* allocator = idMemAllocatorStats::first; allocator != NULL; allocator = allocator->next )
+	{
+		memAllocatorSnapshot_t& snapshot = memSnapshotAllocators.Alloc();
+		snapshot.allocator = allocator;
+		snapshot.numBytes = allocator->numBytes;
+		snapshot.numAllocs = allocator->numAllocs;
+	}
+	idMemAllocatorStats::Unlock();
+	
+	memSnapshotValid = true;
+}
+
+/*
+========================
+memTagStats
+========================
+*/
+CONSOLE_COMMAND_SHIP( memTagStats, "prints the memory used per memory tag and block allocator", 0 )
+{
+	Mem_PrintTagStats( false );
+}
+
+/*
+========================
+memTagSnapshot
+========================
+*/
+CONSOLE_COMMAND_SHIP( memTagSnapshot, "remembers the current memory use for memTagDiff", 0 )
+{
+	Mem_TakeSnapshot();
+	idLib::Printf( "memory snapshot taken\n" );
+}
+
+/*
+========================
+memTagDiff
+========================
+*/
+CONSOLE_COMMAND_SHIP( memTagDiff, "prints the memory use changes since the last memTagSnapshot", 0 )
+{
+	if( !memSnapshotValid )
+	{
+		idLib::Printf( "no memory snapshot, use memTagSnapshot first\n" );
+		return;
+	}
+	Mem_PrintTagStats( true );
+}
+
+#endif
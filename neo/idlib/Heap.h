@@ -67,6 +67,63 @@ void* 		Mem_ClearedAlloc( const size_t size, const memTag_t tag );
 char* 		Mem_CopyString( const char* in );
 // RB end
 
+const char* Mem_TagName( const memTag_t tag );
+
+/*
+================================================
+idMemAllocatorStats
+
+Only available when compiled with ID_MEMORY_TRACKING (the MEMORY_TRACKING
+cmake option). Every Mem_Alloc16 is then accounted against its tag and every
+block allocator keeps one of these, so memTagStats, memTagSnapshot and
+memTagDiff can show where the memory went.
+================================================
+*/
+#if defined( ID_MEMORY_TRACKING )
+
+// number of Mem_Alloc16 calls made since startup over all tags, for counting allocations in a block of code
+int			Mem_GetNumAllocations();
+
+class idMemAllocatorStats
+{
+public:
+	idMemAllocatorStats( const char* allocatorName, memTag_t memTag, int size );
+	idMemAllocatorStats( const idMemAllocatorStats& other );
+	~idMemAllocatorStats();
+	
+	void							Update( int bytes, int count )
+	{
+		numBytes = bytes;
+		numAllocs = count;
+		if( bytes > peakBytes )
+		{
+			peakBytes = bytes;
+		}
+	}
+	
+	const char* 					name;
+	memTag_t						tag;
+	int								elementSize;
+	int								numBytes;		// bytes currently handed out
+	int								numAllocs;		// number of live allocations
+	int								peakBytes;		// max bytes handed out at any time
+	
+	idMemAllocatorStats* 			next;
+	idMemAllocatorStats* 			prev;
+	
+	static idMemAllocatorStats* 	first;			// all allocators, only touch while holding the lock
+	static interlockedInt_t			lock;
+	
+	static void						Lock();
+	static void						Unlock();
+	
+private:
+	void							Link();
+	void							operator=( const idMemAllocatorStats& );
+};
+
+#endif
+
 ID_INLINE void* operator new( size_t s )
 #if !defined(_MSC_VER)
 throw( std::bad_alloc ) // DG: standard signature seems to include throw(..)
@@ -308,6 +365,10 @@ private:
 	bool				allowAllocs;
 	bool				clearAllocs;
 	
+#if defined( ID_MEMORY_TRACKING )
+	idMemAllocatorStats	stats;
+#endif
+	
 	ID_INLINE void		AllocNewBlock();
 };
 
@@ -324,6 +385,9 @@ ID_INLINE idBlockAlloc<_type_, _blockSize_, memTag>::idBlockAlloc( bool clear )
 	active( 0 ),
 	allowAllocs( true ),
 	clearAllocs( clear )
+#if defined( ID_MEMORY_TRACKING )
+	, stats( "idBlockAlloc", memTag, sizeof( _type_ ) )
+#endif
 {
 }
 
@@ -360,6 +424,9 @@ ID_INLINE _type_* idBlockAlloc<_type_, _blockSize_, memTag>::Alloc()
 	}
 	
 	active++;
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( active * sizeof( _type_ ), active );
+#endif
 	element_t* element = free;
 	free = free->next;
 	element->next = NULL;
@@ -397,6 +464,9 @@ ID_INLINE void idBlockAlloc<_type_, _blockSize_, memTag>::Free( _type_ * t )
 	element->next = free;
 	free = element;
 	active--;
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( active * sizeof( _type_ ), active );
+#endif
 #endif
 }
 
@@ -417,6 +487,9 @@ ID_INLINE void idBlockAlloc<_type_, _blockSize_, memTag>::Shutdown()
 	blocks = NULL;
 	free = NULL;
 	total = active = 0;
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( 0, 0 );
+#endif
 }
 
 /*
@@ -804,6 +877,10 @@ private:
 	
 	memTag_t						tag;
 	
+#if defined( ID_MEMORY_TRACKING )
+	idMemAllocatorStats				stats;
+#endif
+	
 	void							Clear();
 	idDynamicBlock<type>* 			AllocInternal( const int num );
 	idDynamicBlock<type>* 			ResizeInternal( idDynamicBlock<type>* block, const int num );
@@ -815,6 +892,9 @@ private:
 
 template<class type, int baseBlockSize, int minBlockSize, memTag_t _tag_>
 idDynamicBlockAlloc<type, baseBlockSize, minBlockSize, _tag_>::idDynamicBlockAlloc()
+#if defined( ID_MEMORY_TRACKING )
+	: stats( "idDynamicBlockAlloc", _tag_, sizeof( type ) )
+#endif
 {
 	tag = _tag_;
 	Clear();
@@ -996,6 +1076,10 @@ type* idDynamicBlockAlloc<type, baseBlockSize, minBlockSize, _tag_>::Alloc( cons
 	numUsedBlocks++;
 	usedBlockMemory += block->GetSize();
 	
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( usedBlockMemory, numUsedBlocks );
+#endif
+	
 	return block->GetMemory();
 }
 
@@ -1032,6 +1116,10 @@ type* idDynamicBlockAlloc<type, baseBlockSize, minBlockSize, _tag_>::Resize( typ
 	
 	usedBlockMemory += block->GetSize();
 	
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( usedBlockMemory, numUsedBlocks );
+#endif
+	
 	return block->GetMemory();
 }
 
@@ -1051,6 +1139,10 @@ void idDynamicBlockAlloc<type, baseBlockSize, minBlockSize, _tag_>::Free( type*
 	numUsedBlocks--;
 	usedBlockMemory -= block->GetSize();
 	
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( usedBlockMemory, numUsedBlocks );
+#endif
+	
 	FreeInternal( block );
 	
 #ifdef DYNAMIC_BLOCK_ALLOC_CHECK
@@ -1119,6 +1211,10 @@ void idDynamicBlockAlloc<type, baseBlockSize, minBlockSize, _tag_>::Clear()
 	numResizes = 0;
 	numFrees = 0;
 	
+#if defined( ID_MEMORY_TRACKING )
+	stats.Update( 0, 0 );
+#endif
+	
 #ifdef DYNAMIC_BLOCK_ALLOC_CHECK
 	blockId[0] = 0x11111111;
 	blockId[1] = 0x22222222;
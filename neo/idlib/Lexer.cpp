@@ -109,68 +109,42 @@ punctuation_t default_punctuations[] =
 
 int default_punctuationtable[256];
 int default_nextpunctuation[sizeof( default_punctuations ) / sizeof( punctuation_t )];
-int default_setup;
 
 char idLexer::baseFolder[ 256 ];
 
 /*
 ================
-idLexer::CreatePunctuationTable
+Lexer_BuildPunctuationTable
+
+Chains the punctuations by their first character, longer punctuations first.
 ================
 */
-void idLexer::CreatePunctuationTable( const punctuation_t* punctuations )
+static void Lexer_BuildPunctuationTable( const punctuation_t* punctuations, int* punctuationtable, int* nextpunctuation, int numPunctuations )
 {
 	int i, n, lastp;
 	const punctuation_t* p, *newp;
 	
-	//get memory for the table
-	if( punctuations == default_punctuations )
-	{
-		idLexer::punctuationtable = default_punctuationtable;
-		idLexer::nextpunctuation = default_nextpunctuation;
-		if( default_setup )
-		{
-			return;
-		}
-		default_setup = true;
-		i = sizeof( default_punctuations ) / sizeof( punctuation_t );
-	}
-	else
-	{
-		if( !idLexer::punctuationtable || idLexer::punctuationtable == default_punctuationtable )
-		{
-			idLexer::punctuationtable = ( int* ) Mem_Alloc( 256 * sizeof( int ), TAG_IDLIB_LEXER );
-		}
-		if( idLexer::nextpunctuation && idLexer::nextpunctuation != default_nextpunctuation )
-		{
-			Mem_Free( idLexer::nextpunctuation );
-		}
-		for( i = 0; punctuations[i].p; i++ )
-		{
-		}
-		idLexer::nextpunctuation = ( int* ) Mem_Alloc( i * sizeof( int ), TAG_IDLIB_LEXER );
-	}
-	memset( idLexer::punctuationtable, 0xFF, 256 * sizeof( int ) );
-	memset( idLexer::nextpunctuation, 0xFF, i * sizeof( int ) );
+	memset( punctuationtable, 0xFF, 256 * sizeof( int ) );
+	memset( nextpunctuation, 0xFF, numPunctuations * sizeof( int ) );
 	//add the punctuations in the list to the punctuation table
 	for( i = 0; punctuations[i].p; i++ )
 	{
 		newp = &punctuations[i];
 		lastp = -1;
 		//sort the punctuations in this table entry on length (longer punctuations first)
-		for( n = idLexer::punctuationtable[( unsigned int ) newp->p[0]]; n >= 0; n = idLexer::nextpunctuation[n] )
+		for( n = punctuationtable[( unsigned int ) newp->p[0]]; n >= 0; n = nextpunctuation[n] )
 		{
 			p = &punctuations[n];
 			if( strlen( p->p ) < strlen( newp->p ) )
 			{
-				idLexer::nextpunctuation[i] = n;
+				nextpunctuation[i] = n;
 				if( lastp >= 0 )
 				{
-					idLexer::nextpunctuation[lastp] = i;
+					nextpunctuation[lastp] = i;
 				}
 				else
 				{
-					idLexer::punctuationtable[( unsigned int ) newp->p[0]] = i;
+					punctuationtable[( unsigned int ) newp->p[0]] = i;
 				}
 				break;
 			}
@@ -178,19 +152,68 @@ void idLexer::CreatePunctuationTable( const punctuation_t* punctuations )
 		}
 		if( n < 0 )
 		{
-			idLexer::nextpunctuation[i] = -1;
+			nextpunctuation[i] = -1;
 			if( lastp >= 0 )
 			{
-				idLexer::nextpunctuation[lastp] = i;
+				nextpunctuation[lastp] = i;
 			}
 			else
 			{
-				idLexer::punctuationtable[( unsigned int ) newp->p[0]] = i;
+				punctuationtable[( unsigned int ) newp->p[0]] = i;
 			}
 		}
 	}
 }
 
+/*
+================
+idLexerDefaultPunctuations
+
+The table of the default punctuations is built during static initialization, before any
+lexer can run in a job, so it is only ever read afterwards.
+================
+*/
+static class idLexerDefaultPunctuations
+{
+public:
+	idLexerDefaultPunctuations()
+	{
+		Lexer_BuildPunctuationTable( default_punctuations, default_punctuationtable, default_nextpunctuation, sizeof( default_punctuations ) / sizeof( punctuation_t ) );
+	}
+} lexerDefaultPunctuations;
+
+/*
+================
+idLexer::CreatePunctuationTable
+================
+*/
+void idLexer::CreatePunctuationTable( const punctuation_t* punctuations )
+{
+	int i;
+	
+	if( punctuations == default_punctuations )
+	{
+		idLexer::punctuationtable = default_punctuationtable;
+		idLexer::nextpunctuation = default_nextpunctuation;
+		return;
+	}
+	
+	//get memory for the table
+	if( !idLexer::punctuationtable || idLexer::punctuationtable == default_punctuationtable )
+	{
+		idLexer::punctuationtable = ( int* ) Mem_Alloc( 256 * sizeof( int ), TAG_IDLIB_LEXER );
+	}
+	if( idLexer::nextpunctuation && idLexer::nextpunctuation != default_nextpunctuation )
+	{
+		Mem_Free( idLexer::nextpunctuation );
+	}
+	for( i = 0; punctuations[i].p; i++ )
+	{
+	}
+	idLexer::nextpunctuation = ( int* ) Mem_Alloc( i * sizeof( int ), TAG_IDLIB_LEXER );
+	Lexer_BuildPunctuationTable( punctuations, idLexer::punctuationtable, idLexer::nextpunctuation, i );
+}
+
 /*
 ================
 idLexer::GetPunctuationFromId
@@ -614,6 +637,20 @@ int idLexer::ReadEscapeCharacter( char* ch )
 	return 1;
 }
 
+/*
+================
+idLexer::AppendTokenText
+
+Copies a run of script characters into the token at once instead of one character at a time.
+================
+*/
+ID_INLINE void idLexer::AppendTokenText( idToken* token, const char* text, int length )
+{
+	token->EnsureAlloced( token->len + length + 1, true );
+	memcpy( token->data + token->len, text, length );
+	token->len += length;
+}
+
 /*
 ================
 idLexer::ReadString
@@ -626,7 +663,9 @@ int idLexer::ReadString( idToken* token, int quote )
 {
 	int tmpline;
 	const char* tmpscript_p;
+	const char* p;
 	char ch;
+	const bool escapeChars = !( idLexer::flags & LEXFL_NOSTRINGESCAPECHARS );
 	
 	if( quote == '\"' )
 	{
@@ -643,7 +682,7 @@ int idLexer::ReadString( idToken* token, int quote )
 	while( 1 )
 	{
 		// if there is an escape character and escape characters are allowed
-		if( *idLexer::script_p == '\\' && !( idLexer::flags & LEXFL_NOSTRINGESCAPECHARS ) )
+		if( *idLexer::script_p == '\\' && escapeChars )
 		{
 			if( !idLexer::ReadEscapeCharacter( &ch ) )
 			{
@@ -712,7 +751,14 @@ int idLexer::ReadString( idToken* token, int quote )
 				idLexer::Error( "newline inside string" );
 				return 0;
 			}
-			token->AppendDirty( *idLexer::script_p++ );
+			// copy everything up to the next quote, escape character or error at once
+			p = idLexer::script_p + 1;
+			while( *p != quote && *p != '\n' && *p != '\0' && ( *p != '\\' || !escapeChars ) )
+			{
+				p++;
+			}
+			AppendTokenText( token, idLexer::script_p, p - idLexer::script_p );
+			idLexer::script_p = p;
 		}
 	}
 	token->data[token->len] = '\0';
@@ -738,18 +784,79 @@ int idLexer::ReadString( idToken* token, int quote )
 
 /*
 ================
-idLexer::ReadName
+idLexer::ReadString
+
+Strings without escape characters that can't be concatenated are referenced in the script,
+all others are decoded into the lexer.
 ================
 */
-int idLexer::ReadName( idToken* token )
+int idLexer::ReadString( idTokenRef* token, int quote )
+{
+	const char* p;
+	
+	if( ( idLexer::flags & LEXFL_NOSTRINGCONCAT ) &&
+			( !( idLexer::flags & LEXFL_ALLOWBACKSLASHSTRINGCONCAT ) || ( quote != '\"' ) ) )
+	{
+		p = idLexer::script_p + 1;
+		while( *p != quote && *p != '\n' && *p != '\0' && ( *p != '\\' || ( idLexer::flags & LEXFL_NOSTRINGESCAPECHARS ) ) )
+		{
+			p++;
+		}
+		if( *p == quote )
+		{
+			token->type = ( quote == '\"' ) ? TT_STRING : TT_LITERAL;
+			token->text = idLexer::script_p + 1;
+			token->length = p - token->text;
+			idLexer::script_p = p + 1;
+			
+			if( token->type == TT_LITERAL )
+			{
+				if( !( idLexer::flags & LEXFL_ALLOWMULTICHARLITERALS ) )
+				{
+					if( token->length != 1 )
+					{
+						idLexer::Warning( "literal is not one character long" );
+					}
+				}
+				token->subtype = ( token->length > 0 ) ? token->text[0] : '\0';
+			}
+			else
+			{
+				// the sub type is the length of the string
+				token->subtype = token->length;
+			}
+			return 1;
+		}
+	}
+	
+	// let the regular string parsing deal with escape characters, concatenation and errors
+	decoded.data[0] = '\0';
+	decoded.len = 0;
+	if( !idLexer::ReadString( &decoded, quote ) )
+	{
+		return 0;
+	}
+	token->text = decoded.c_str();
+	token->length = decoded.Length();
+	token->type = decoded.type;
+	token->subtype = decoded.subtype;
+	return 1;
+}
+
+/*
+================
+idLexer::ScanName
+
+Returns a pointer to the first character after the name that starts at the given position.
+================
+*/
+ID_INLINE const char* idLexer::ScanName( const char* p ) const
 {
 	char c;
 	
-	token->type = TT_NAME;
 	do
 	{
-		token->AppendDirty( *idLexer::script_p++ );
-		c = *idLexer::script_p;
+		c = *( ++p );
 	}
 	while( ( c >= 'a' && c <= 'z' ) ||
 			( c >= 'A' && c <= 'Z' ) ||
@@ -759,12 +866,43 @@ int idLexer::ReadName( idToken* token )
 			( ( idLexer::flags & LEXFL_ONLYSTRINGS ) && ( c == '-' ) ) ||
 			// if special path name characters are allowed
 			( ( idLexer::flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == ':' || c == '.' ) ) );
+	return p;
+}
+
+/*
+================
+idLexer::ReadName
+================
+*/
+int idLexer::ReadName( idToken* token )
+{
+	const char* start = idLexer::script_p;
+	
+	token->type = TT_NAME;
+	idLexer::script_p = ScanName( start );
+	AppendTokenText( token, start, idLexer::script_p - start );
 	token->data[token->len] = '\0';
 	//the sub type is the length of the name
 	token->subtype = token->Length();
 	return 1;
 }
 
+/*
+================
+idLexer::ReadName
+================
+*/
+int idLexer::ReadName( idTokenRef* token )
+{
+	token->type = TT_NAME;
+	token->text = idLexer::script_p;
+	idLexer::script_p = ScanName( idLexer::script_p );
+	token->length = idLexer::script_p - token->text;
+	//the sub type is the length of the name
+	token->subtype = token->length;
+	return 1;
+}
+
 /*
 ================
 idLexer::CheckString
@@ -786,19 +924,21 @@ ID_INLINE int idLexer::CheckString( const char* str ) const
 
 /*
 ================
-idLexer::ReadNumber
+idLexer::ScanNumber
+
+Steps over the number at the current script position and sets the number sub type.
+The text of the number runs from the start position up to textEnd, which excludes
+the type suffixes.
 ================
 */
-int idLexer::ReadNumber( idToken* token )
+int idLexer::ScanNumber( int* subtype, const char** textEnd )
 {
 	int i;
 	int dot;
 	char c, c2;
+	const char* start = idLexer::script_p;
 	
-	token->type = TT_NUMBER;
-	token->subtype = 0;
-	token->intvalue = 0;
-	token->floatvalue = 0;
+	*subtype = 0;
 	
 	c = *idLexer::script_p;
 	c2 = *( idLexer::script_p + 1 );
@@ -808,42 +948,37 @@ int idLexer::ReadNumber( idToken* token )
 		// check for a hexadecimal number
 		if( c2 == 'x' || c2 == 'X' )
 		{
-			token->AppendDirty( *idLexer::script_p++ );
-			token->AppendDirty( *idLexer::script_p++ );
+			idLexer::script_p += 2;
 			c = *idLexer::script_p;
 			while( ( c >= '0' && c <= '9' ) ||
 					( c >= 'a' && c <= 'f' ) ||
 					( c >= 'A' && c <= 'F' ) )
 			{
-				token->AppendDirty( c );
 				c = *( ++idLexer::script_p );
 			}
-			token->subtype = TT_HEX | TT_INTEGER;
+			*subtype = TT_HEX | TT_INTEGER;
 		}
 		// check for a binary number
 		else if( c2 == 'b' || c2 == 'B' )
 		{
-			token->AppendDirty( *idLexer::script_p++ );
-			token->AppendDirty( *idLexer::script_p++ );
+			idLexer::script_p += 2;
 			c = *idLexer::script_p;
 			while( c == '0' || c == '1' )
 			{
-				token->AppendDirty( c );
 				c = *( ++idLexer::script_p );
 			}
-			token->subtype = TT_BINARY | TT_INTEGER;
+			*subtype = TT_BINARY | TT_INTEGER;
 		}
 		// its an octal number
 		else
 		{
-			token->AppendDirty( *idLexer::script_p++ );
+			idLexer::script_p++;
 			c = *idLexer::script_p;
 			while( c >= '0' && c <= '7' )
 			{
-				token->AppendDirty( c );
 				c = *( ++idLexer::script_p );
 			}
-			token->subtype = TT_OCTAL | TT_INTEGER;
+			*subtype = TT_OCTAL | TT_INTEGER;
 		}
 	}
 	else
@@ -863,7 +998,6 @@ int idLexer::ReadNumber( idToken* token )
 			{
 				break;
 			}
-			token->AppendDirty( c );
 			c = *( ++idLexer::script_p );
 		}
 		if( c == 'e' && dot == 0 )
@@ -874,26 +1008,18 @@ int idLexer::ReadNumber( idToken* token )
 		// if a floating point number
 		if( dot == 1 )
 		{
-			token->subtype = TT_DECIMAL | TT_FLOAT;
+			*subtype = TT_DECIMAL | TT_FLOAT;
 			// check for floating point exponent
 			if( c == 'e' )
 			{
-				//Append the e so that GetFloatValue code works
-				token->AppendDirty( c );
+				//Keep the e so that GetFloatValue code works
 				c = *( ++idLexer::script_p );
-				if( c == '-' )
+				if( c == '-' || c == '+' )
 				{
-					token->AppendDirty( c );
-					c = *( ++idLexer::script_p );
-				}
-				else if( c == '+' )
-				{
-					token->AppendDirty( c );
 					c = *( ++idLexer::script_p );
 				}
 				while( c >= '0' && c <= '9' )
 				{
-					token->AppendDirty( c );
 					c = *( ++idLexer::script_p );
 				}
 			}
@@ -903,40 +1029,37 @@ int idLexer::ReadNumber( idToken* token )
 				c2 = 4;
 				if( CheckString( "INF" ) )
 				{
-					token->subtype |= TT_INFINITE;
+					*subtype |= TT_INFINITE;
 				}
 				else if( CheckString( "IND" ) )
 				{
-					token->subtype |= TT_INDEFINITE;
+					*subtype |= TT_INDEFINITE;
 				}
 				else if( CheckString( "NAN" ) )
 				{
-					token->subtype |= TT_NAN;
+					*subtype |= TT_NAN;
 				}
 				else if( CheckString( "QNAN" ) )
 				{
-					token->subtype |= TT_NAN;
+					*subtype |= TT_NAN;
 					c2++;
 				}
 				else if( CheckString( "SNAN" ) )
 				{
-					token->subtype |= TT_NAN;
+					*subtype |= TT_NAN;
 					c2++;
 				}
 				for( i = 0; i < c2; i++ )
 				{
-					token->AppendDirty( c );
 					c = *( ++idLexer::script_p );
 				}
 				while( c >= '0' && c <= '9' )
 				{
-					token->AppendDirty( c );
 					c = *( ++idLexer::script_p );
 				}
 				if( !( idLexer::flags & LEXFL_ALLOWFLOATEXCEPTIONS ) )
 				{
-					token->AppendDirty( 0 );	// zero terminate for c_str
-					idLexer::Error( "parsed %s", token->c_str() );
+					idLexer::Error( "parsed %s", idStr( start, 0, idLexer::script_p - start ).c_str() );
 				}
 			}
 		}
@@ -952,42 +1075,45 @@ int idLexer::ReadNumber( idToken* token )
 				idLexer::Error( "ip address should have three dots" );
 				return 0;
 			}
-			token->subtype = TT_IPADDRESS;
+			*subtype = TT_IPADDRESS;
 		}
 		else
 		{
-			token->subtype = TT_DECIMAL | TT_INTEGER;
+			*subtype = TT_DECIMAL | TT_INTEGER;
 		}
 	}
 	
-	if( token->subtype & TT_FLOAT )
+	// the suffixes aren't part of the token text
+	*textEnd = idLexer::script_p;
+	
+	if( *subtype & TT_FLOAT )
 	{
 		if( c > ' ' )
 		{
 			// single-precision: float
 			if( c == 'f' || c == 'F' )
 			{
-				token->subtype |= TT_SINGLE_PRECISION;
+				*subtype |= TT_SINGLE_PRECISION;
 				idLexer::script_p++;
 			}
 			// extended-precision: long double
 			else if( c == 'l' || c == 'L' )
 			{
-				token->subtype |= TT_EXTENDED_PRECISION;
+				*subtype |= TT_EXTENDED_PRECISION;
 				idLexer::script_p++;
 			}
 			// default is double-precision: double
 			else
 			{
-				token->subtype |= TT_DOUBLE_PRECISION;
+				*subtype |= TT_DOUBLE_PRECISION;
 			}
 		}
 		else
 		{
-			token->subtype |= TT_DOUBLE_PRECISION;
+			*subtype |= TT_DOUBLE_PRECISION;
 		}
 	}
-	else if( token->subtype & TT_INTEGER )
+	else if( *subtype & TT_INTEGER )
 	{
 		if( c > ' ' )
 		{
@@ -997,12 +1123,12 @@ int idLexer::ReadNumber( idToken* token )
 				// long integer
 				if( c == 'l' || c == 'L' )
 				{
-					token->subtype |= TT_LONG;
+					*subtype |= TT_LONG;
 				}
 				// unsigned integer
 				else if( c == 'u' || c == 'U' )
 				{
-					token->subtype |= TT_UNSIGNED;
+					*subtype |= TT_UNSIGNED;
 				}
 				else
 				{
@@ -1012,32 +1138,55 @@ int idLexer::ReadNumber( idToken* token )
 			}
 		}
 	}
-	else if( token->subtype & TT_IPADDRESS )
+	else if( *subtype & TT_IPADDRESS )
 	{
 		if( c == ':' )
 		{
-			token->AppendDirty( c );
 			c = *( ++idLexer::script_p );
 			while( c >= '0' && c <= '9' )
 			{
-				token->AppendDirty( c );
 				c = *( ++idLexer::script_p );
 			}
-			token->subtype |= TT_IPPORT;
+			*subtype |= TT_IPPORT;
+			*textEnd = idLexer::script_p;
 		}
 	}
+	return 1;
+}
+
+/*
+================
+idLexer::ReadNumber
+================
+*/
+int idLexer::ReadNumber( idToken* token )
+{
+	const char* start = idLexer::script_p;
+	const char* textEnd;
+	
+	token->type = TT_NUMBER;
+	token->intvalue = 0;
+	token->floatvalue = 0;
+	
+	if( !ScanNumber( &token->subtype, &textEnd ) )
+	{
+		return 0;
+	}
+	AppendTokenText( token, start, textEnd - start );
 	token->data[token->len] = '\0';
 	return 1;
 }
 
 /*
 ================
-idLexer::ReadPunctuation
+idLexer::FindPunctuation
+
+Returns the longest punctuation at the current script position or NULL if there is none.
 ================
 */
-int idLexer::ReadPunctuation( idToken* token )
+const punctuation_t* idLexer::FindPunctuation( int* length ) const
 {
-	int l, n, i;
+	int l, n;
 	const char* p;
 	const punctuation_t* punc;
 	
@@ -1046,11 +1195,9 @@ int idLexer::ReadPunctuation( idToken* token )
 	{
 		punc = &( idLexer::punctuations[n] );
 #else
-	int i;
-		
-	for( i = 0; idLexer::punctuations[i].p; i++ )
+	for( n = 0; idLexer::punctuations[n].p; n++ )
 	{
-		punc = &idLexer::punctuations[i];
+		punc = &idLexer::punctuations[n];
 #endif
 		p = punc->p;
 		// check for this punctuation in the script
@@ -1063,22 +1210,36 @@ int idLexer::ReadPunctuation( idToken* token )
 		}
 		if( !p[l] )
 		{
-			//
-			token->EnsureAlloced( l + 1, false );
-			for( i = 0; i <= l; i++ )
-			{
-				token->data[i] = p[i];
-			}
-			token->len = l;
-			//
-			idLexer::script_p += l;
-			token->type = TT_PUNCTUATION;
-			// sub type is the punctuation id
-			token->subtype = punc->n;
-			return 1;
+			*length = l;
+			return punc;
 		}
 	}
-	return 0;
+	return NULL;
+}
+
+/*
+================
+idLexer::ReadPunctuation
+================
+*/
+int idLexer::ReadPunctuation( idToken* token )
+{
+	int l;
+	const punctuation_t* punc;
+	
+	punc = FindPunctuation( &l );
+	if( punc == NULL )
+	{
+		return 0;
+	}
+	token->EnsureAlloced( l + 1, false );
+	memcpy( token->data, punc->p, l + 1 );
+	token->len = l;
+	idLexer::script_p += l;
+	token->type = TT_PUNCTUATION;
+	// sub type is the punctuation id
+	token->subtype = punc->n;
+	return 1;
 }
 
 /*
@@ -1206,6 +1367,156 @@ int idLexer::ReadToken( idToken* token )
 	return 1;
 }
 
+/*
+================
+idLexer::ReadTokenRef
+
+Same as ReadToken but the token text is not copied, see idTokenRef.
+================
+*/
+int idLexer::ReadTokenRef( idTokenRef* token )
+{
+	int c, l;
+	const char* start;
+	const char* textEnd;
+	const punctuation_t* punc;
+	
+	if( !loaded )
+	{
+		idLib::common->Error( "idLexer::ReadTokenRef: no file loaded" );
+		return 0;
+	}
+	
+	if( script_p == NULL )
+	{
+		return 0;
+	}
+	
+	// if there is a token available (from unreadToken)
+	if( tokenavailable )
+	{
+		tokenavailable = 0;
+		token->text = idLexer::token.c_str();
+		token->length = idLexer::token.Length();
+		token->type = idLexer::token.type;
+		token->subtype = idLexer::token.subtype;
+		token->line = idLexer::token.line;
+		token->linesCrossed = idLexer::token.linesCrossed;
+		return 1;
+	}
+	// save script pointer
+	lastScript_p = script_p;
+	// save line counter
+	lastline = line;
+	// start of the white space
+	whiteSpaceStart_p = script_p;
+	// read white space before token
+	if( !ReadWhiteSpace() )
+	{
+		return 0;
+	}
+	// end of the white space
+	whiteSpaceEnd_p = script_p;
+	// line the token is on
+	token->line = line;
+	// number of lines crossed before token
+	token->linesCrossed = line - lastline;
+	
+	c = *script_p;
+	start = script_p;
+	
+	// if we're keeping everything as whitespace deliminated strings
+	if( idLexer::flags & LEXFL_ONLYSTRINGS )
+	{
+		// if there is a leading quote
+		if( c == '\"' || c == '\'' )
+		{
+			if( !ReadString( token, c ) )
+			{
+				return 0;
+			}
+		}
+		else
+		{
+			ReadName( token );
+		}
+	}
+	// if there is a number
+	else if( ( c >= '0' && c <= '9' ) ||
+			 ( c == '.' && ( *( script_p + 1 ) >= '0' && *( script_p + 1 ) <= '9' ) ) )
+	{
+		token->type = TT_NUMBER;
+		if( !ScanNumber( &token->subtype, &textEnd ) )
+		{
+			return 0;
+		}
+		token->text = start;
+		token->length = textEnd - start;
+		// if names are allowed to start with a number
+		if( idLexer::flags & LEXFL_ALLOWNUMBERNAMES )
+		{
+			c = *script_p;
+			if( ( c >= 'a' && c <= 'z' ) ||	( c >= 'A' && c <= 'Z' ) || c == '_' )
+			{
+				if( textEnd == script_p )
+				{
+					script_p = ScanName( script_p );
+					token->length = script_p - start;
+				}
+				else
+				{
+					// a type suffix was skipped so the name isn't contiguous with the number
+					decoded.data[0] = '\0';
+					decoded.len = 0;
+					AppendTokenText( &decoded, start, textEnd - start );
+					ReadName( &decoded );
+					token->text = decoded.c_str();
+					token->length = decoded.Length();
+				}
+				token->type = TT_NAME;
+				token->subtype = token->length;
+			}
+		}
+	}
+	// if there is a leading quote
+	else if( c == '\"' || c == '\'' )
+	{
+		if( !ReadString( token, c ) )
+		{
+			return 0;
+		}
+	}
+	// if there is a name
+	else if( ( c >= 'a' && c <= 'z' ) ||	( c >= 'A' && c <= 'Z' ) || c == '_' )
+	{
+		ReadName( token );
+	}
+	// names may also start with a slash when pathnames are allowed
+	else if( ( idLexer::flags & LEXFL_ALLOWPATHNAMES ) && ( ( c == '/' || c == '\\' ) || c == '.' ) )
+	{
+		ReadName( token );
+	}
+	// check for punctuations
+	else
+	{
+		punc = FindPunctuation( &l );
+		if( punc == NULL )
+		{
+			idLexer::Error( "unknown punctuation %c", c );
+			return 0;
+		}
+		script_p += l;
+		// the text of the punctuation table is zero terminated and stays valid
+		token->text = punc->p;
+		token->length = l;
+		token->type = TT_PUNCTUATION;
+		// sub type is the punctuation id
+		token->subtype = punc->n;
+	}
+	// succesfully read a token
+	return 1;
+}
+
 /*
 ================
 idLexer::ExpectTokenString
@@ -1213,16 +1524,16 @@ idLexer::ExpectTokenString
 */
 int idLexer::ExpectTokenString( const char* string )
 {
-	idToken token;
+	idTokenRef token;
 	
-	if( !idLexer::ReadToken( &token ) )
+	if( !idLexer::ReadTokenRef( &token ) )
 	{
 		idLexer::Error( "couldn't find expected '%s'", string );
 		return 0;
 	}
 	if( token != string )
 	{
-		idLexer::Error( "expected '%s' but found '%s'", string, token.c_str() );
+		idLexer::Error( "expected '%s' but found '%.*s'", string, token.length, token.text );
 		return 0;
 	}
 	return 1;
@@ -1328,9 +1639,9 @@ idLexer::CheckTokenString
 */
 int idLexer::CheckTokenString( const char* string )
 {
-	idToken tok;
+	idTokenRef tok;
 	
-	if( !ReadToken( &tok ) )
+	if( !ReadTokenRef( &tok ) )
 	{
 		return 0;
 	}
@@ -1377,9 +1688,9 @@ idLexer::PeekTokenString
 */
 int idLexer::PeekTokenString( const char* string )
 {
-	idToken tok;
+	idTokenRef tok;
 	
-	if( !ReadToken( &tok ) )
+	if( !ReadTokenRef( &tok ) )
 	{
 		return 0;
 	}
@@ -1430,9 +1741,9 @@ idLexer::SkipUntilString
 */
 int idLexer::SkipUntilString( const char* string )
 {
-	idToken token;
+	idTokenRef token;
 	
-	while( idLexer::ReadToken( &token ) )
+	while( idLexer::ReadTokenRef( &token ) )
 	{
 		if( token == string )
 		{
@@ -1449,9 +1760,9 @@ idLexer::SkipRestOfLine
 */
 int idLexer::SkipRestOfLine()
 {
-	idToken token;
+	idTokenRef token;
 	
-	while( idLexer::ReadToken( &token ) )
+	while( idLexer::ReadTokenRef( &token ) )
 	{
 		if( token.linesCrossed )
 		{
@@ -1473,13 +1784,13 @@ Internal brace depths are properly skipped.
 */
 int idLexer::SkipBracedSection( bool parseFirstBrace )
 {
-	idToken token;
+	idTokenRef token;
 	int depth;
 	
 	depth = parseFirstBrace ? 0 : 1;
 	do
 	{
-		if( !ReadToken( &token ) )
+		if( !ReadTokenRef( &token ) )
 		{
 			return false;
 		}
@@ -37,6 +37,8 @@ If you have questions concerning this license or the applicable additional terms
 	Does not use memory allocation during parsing. The lexer uses no
 	memory allocation if a source is loaded with LoadMemory().
 	However, idToken may still allocate memory for large strings.
+	ReadTokenRef() doesn't copy the token text at all but returns
+	a reference into the script buffer.
 
 	A number directly following the escape character '\' in a string is
 	assumed to be in decimal format instead of octal. Binary numbers of
@@ -163,6 +165,8 @@ public:
 	};
 	// read a token
 	int				ReadToken( idToken* token );
+	// read a token without copying the text, the text references the script, see idTokenRef
+	int				ReadTokenRef( idTokenRef* token );
 	// expect a certain token, reads the token when available
 	int				ExpectTokenString( const char* string );
 	// expect a certain token type
@@ -273,6 +277,7 @@ private:
 	int* 			punctuationtable;		// ASCII table with punctuations
 	int* 			nextpunctuation;		// next punctuation in chain
 	idToken			token;					// available token
+	idToken			decoded;				// text of the last idTokenRef that doesn't exist in the script
 	idLexer* 		next;					// next script in a chain
 	bool			hadError;				// set by idLexer::Error, even if the error is supressed
 	
@@ -282,9 +287,15 @@ private:
 	void			CreatePunctuationTable( const punctuation_t* punctuations );
 	int				ReadWhiteSpace();
 	int				ReadEscapeCharacter( char* ch );
+	void			AppendTokenText( idToken* token, const char* text, int length );
 	int				ReadString( idToken* token, int quote );
+	int				ReadString( idTokenRef* token, int quote );
+	const char* 	ScanName( const char* p ) const;
 	int				ReadName( idToken* token );
+	int				ReadName( idTokenRef* token );
+	int				ScanNumber( int* subtype, const char** textEnd );
 	int				ReadNumber( idToken* token );
+	const punctuation_t* FindPunctuation( int* length ) const;
 	int				ReadPunctuation( idToken* token );
 	int				ReadPrimitive( idToken* token );
 	int				CheckString( const char* str ) const;
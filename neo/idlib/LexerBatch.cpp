@@ -0,0 +1,154 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+/*
+================
+idLexerBatch::idLexerBatch
+================
+*/
+idLexerBatch::idLexerBatch()
+{
+}
+
+/*
+================
+idLexerBatch::~idLexerBatch
+================
+*/
+idLexerBatch::~idLexerBatch()
+{
+	Clear();
+}
+
+/*
+================
+idLexerBatch::Clear
+================
+*/
+void idLexerBatch::Clear()
+{
+	for( int i = 0; i < scripts.Num(); i++ )
+	{
+		if( scripts[i]->ownsBuffer )
+		{
+			idLib::fileSystem->FreeFile( ( void* )scripts[i]->ptr );
+		}
+	}
+	scripts.DeleteContents( true );
+}
+
+/*
+================
+idLexerBatch::AddMemory
+================
+*/
+void idLexerBatch::AddMemory( const char* ptr, int length, const char* name, void* data )
+{
+	assert( ptr[length] == '\0' );
+	
+	lexerBatchScript_t* script = new( TAG_IDLIB_LEXER ) lexerBatchScript_t;
+	script->ptr = ptr;
+	script->length = length;
+	script->name = name;
+	script->data = data;
+	script->ownsBuffer = false;
+	script->hadError = false;
+	script->func = NULL;
+	script->flags = 0;
+	scripts.Append( script );
+}
+
+/*
+================
+idLexerBatch::AddFile
+================
+*/
+bool idLexerBatch::AddFile( const char* filename, void* data )
+{
+	void* buffer;
+	
+	// the file system adds a trailing zero to the buffer
+	int length = idLib::fileSystem->ReadFile( filename, &buffer );
+	if( length < 0 || buffer == NULL )
+	{
+		return false;
+	}
+	AddMemory( ( const char* )buffer, length, filename, data );
+	scripts[scripts.Num() - 1]->ownsBuffer = true;
+	return true;
+}
+
+/*
+================
+LexerBatchJob
+================
+*/
+static void LexerBatchJob( lexerBatchScript_t* script )
+{
+	idLexer lexer( script->flags );
+	if( !lexer.LoadMemory( script->ptr, script->length, script->name ) )
+	{
+		script->hadError = true;
+		return;
+	}
+	script->func( lexer, script->data );
+	script->hadError = lexer.HadError();
+}
+
+REGISTER_PARALLEL_JOB( LexerBatchJob, "LexerBatchJob" );
+
+/*
+================
+idLexerBatch::Run
+================
+*/
+void idLexerBatch::Run( lexerBatchFunc_t func, int flags, int parallelism )
+{
+	if( scripts.Num() == 0 )
+	{
+		return;
+	}
+	
+	// an error in one of the jobs shouldn't take down the others
+	flags |= LEXFL_NOFATALERRORS;
+	
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, scripts.Num(), 0, NULL );
+	for( int i = 0; i < scripts.Num(); i++ )
+	{
+		scripts[i]->func = func;
+		scripts[i]->flags = flags;
+		scripts[i]->hadError = false;
+		jobList->AddJob( ( jobRun_t )LexerBatchJob, scripts[i] );
+	}
+	jobList->Submit( NULL, parallelism );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+}
@@ -0,0 +1,104 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __LEXERBATCH_H__
+#define __LEXERBATCH_H__
+
+/*
+===============================================================================
+
+	idLexerBatch
+
+	Lexes many scripts in parallel on the job system, one job per script.
+	Files are read on the calling thread because the file system isn't
+	thread safe, after that every script gets its own idLexer which is
+	handed to the callback from a job. The callback should only touch data
+	that belongs to its script, the user data pointer given when the script
+	was added is passed along for that purpose.
+
+	Errors are never fatal inside the jobs, HadError() reports them after
+	Run() returns.
+
+===============================================================================
+*/
+
+typedef void ( *lexerBatchFunc_t )( idLexer& lexer, void* data );
+
+struct lexerBatchScript_t
+{
+	const char* 		ptr;
+	int					length;
+	idStr				name;
+	void* 				data;
+	bool				ownsBuffer;			// buffer was read with the file system
+	bool				hadError;
+	lexerBatchFunc_t	func;
+	int					flags;
+};
+
+class idLexerBatch
+{
+public:
+	idLexerBatch();
+	~idLexerBatch();
+	
+	// add a script from memory, the memory must stay valid until Run() returns
+	// NOTE: the ptr is expected to point at a valid C string: ptr[length] == '\0'
+	void			AddMemory( const char* ptr, int length, const char* name, void* data = NULL );
+	// read a file with the file system and add it, returns false if the file could not be read
+	bool			AddFile( const char* filename, void* data = NULL );
+	// lex all added scripts with the given lexer flags, returns once all callbacks are done
+	void			Run( lexerBatchFunc_t func, int flags, int parallelism = JOBLIST_PARALLELISM_DEFAULT );
+	// free all scripts and the files read by AddFile
+	void			Clear();
+	
+	int				Num() const;
+	const char* 	GetName( int index ) const;
+	// returns true if the lexer of the given script had an error during the last Run()
+	bool			HadError( int index ) const;
+	
+private:
+	idList<lexerBatchScript_t*, TAG_IDLIB_LEXER> scripts;
+};
+
+ID_INLINE int idLexerBatch::Num() const
+{
+	return scripts.Num();
+}
+
+ID_INLINE const char* idLexerBatch::GetName( int index ) const
+{
+	return scripts[index]->name.c_str();
+}
+
+ID_INLINE bool idLexerBatch::HadError( int index ) const
+{
+	return scripts[index]->hadError;
+}
+
+#endif /* !__LEXERBATCH_H__ */
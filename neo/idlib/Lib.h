@@ -304,6 +304,7 @@ public:
 #include "containers/BTree.h"
 #include "containers/BinSearch.h"
 #include "containers/HashIndex.h"
+#include "containers/HashMap.h"
 #include "containers/HashTable.h"
 #include "containers/StaticList.h"
 #include "containers/LinkList.h"
@@ -331,6 +332,7 @@ public:
 #include "Swap.h"
 #include "Callback.h"
 #include "ParallelJobList.h"
+#include "LexerBatch.h"
 
 #include "SoftwareCache.h"
 
@@ -144,25 +144,36 @@ static idCVar jobs_longJobMicroSec( "jobs_longJobMicroSec", "10000", CVAR_INTEGE
 
 const static int		MAX_THREADS	= 32;
 
+/*
+================================================
+The jobs of a submitted list are split into sections at each SYNC_SYNCHRONIZE point.
+All jobs within a section are independent, so at submit time each section is divided
+into one contiguous job range per processing unit. A unit pops jobs from the front of
+its own range and, once that runs dry, steals the back half of the range of another
+unit. The only shared state that is touched per job is the lock of the range that is
+being popped from, which is only contended while a steal is in progress.
+
+A running job may add child jobs to its own list. Child jobs are pushed on a stack
+owned by the unit that runs the parent, popped from the top by that unit and stolen
+from the bottom by the other units. Every job keeps a count of its unfinished child
+jobs so a continuation job can be started once a job and all its children are done.
+Child jobs and continuations are counted against the signal of the job that added
+them, so sync points and Wait() include them.
+================================================
+*/
 struct threadJobListState_t
 {
 	threadJobListState_t() :
 		jobList( NULL ),
 		version( 0xFFFFFFFF ),
-		signalIndex( 0 ),
-		lastJobIndex( 0 ),
-		nextJobIndex( -1 ) {}
+		section( 0 ) {}
 	threadJobListState_t( int _version ) :
 		jobList( NULL ),
 		version( _version ),
-		signalIndex( 0 ),
-		lastJobIndex( 0 ),
-		nextJobIndex( -1 ) {}
+		section( 0 ) {}
 	idParallelJobList_Threads* 	jobList;
 	int							version;
-	int							signalIndex;
-	int							lastJobIndex;
-	int							nextJobIndex;
+	int							section;
 };
 
 struct threadStats_t
@@ -193,6 +204,15 @@ public:
 	bool					TryWait();
 	bool					IsSubmitted() const;
 	
+	// Splits the sections of the submitted list over the given number of processing units.
+	void					DistributeJobs( int numUnits );
+	
+	//------------------------
+	// These are called from the jobs running on this list.
+	//------------------------
+	void					AddChildJob( jobRun_t function, void* data );
+	void					SetContinuationJob( jobRun_t function, void* data );
+	
 	unsigned int			GetNumExecutedJobs() const
 	{
 		return threadStats.numExecutedJobs;
@@ -262,37 +282,85 @@ private:
 	unsigned int			maxSyncs;
 	unsigned int			numSyncs;
 	int						lastSignalJob;
+	int						numUnits;
 	idSysInterlockedInteger* waitForGuard;
 	idSysInterlockedInteger doneGuards[NUM_DONE_GUARDS];
 	int						currentDoneGuard;
 	idSysInterlockedInteger	version;
 	struct job_t
 	{
-		jobRun_t	function;
-		void* 		data;
-		int			executed;
+		jobRun_t				function;
+		void* 					data;
+		int						signal;			// index of the signal this job is counted against
+		int						parent;			// job that added this job as a child or continuation, -1 for none
+		idSysInterlockedInteger	pending;		// the job itself plus all its unfinished child jobs
+		jobRun_t				continuation;
+		void* 					continuationData;
+		int						executed;
+	};
+	struct jobSection_t
+	{
+		int			firstJob;
+		int			waitSignal;		// signal that must be complete before the section starts, -1 for none
+	};
+	// one per section per processing unit, padded so units never share a cache line
+	struct jobRange_t
+	{
+		idSysInterlockedInteger	lock;
+		int						first;
+		int						last;
+		byte					pad[CACHE_LINE_SIZE - sizeof( idSysInterlockedInteger ) - 2 * sizeof( int )];
+	};
+	// child jobs added by the jobs running on a processing unit
+	static const int		MAX_STACK_JOBS = 256;
+	struct jobStack_t
+	{
+		idSysInterlockedInteger	lock;
+		int						bottom;
+		int						top;
+		int						jobs[MAX_STACK_JOBS];
+	};
+	// the job a thread is currently running
+	struct jobContext_t
+	{
+		idParallelJobList_Threads* 	jobList;
+		int							unit;
+		int							job;
 	};
 	idList< job_t, TAG_JOBLIST >		jobList;
+	idList< jobSection_t, TAG_JOBLIST >	sections;
+	idList< jobRange_t, TAG_JOBLIST >	jobRanges;
+	idList< job_t, TAG_JOBLIST >		childJobs;
+	idSysInterlockedInteger				numChildJobs;
+	idList< jobStack_t, TAG_JOBLIST >	jobStacks;
 	idList< idSysInterlockedInteger, TAG_JOBLIST >	signalJobCount;
-	idSysInterlockedInteger				currentJob;
-	idSysInterlockedInteger				fetchLock;
+	idSysInterlockedInteger				numJobsRemaining;
 	idSysInterlockedInteger				numThreadsExecuting;
 	
 	threadStats_t						deferredThreadStats;
 	threadStats_t						threadStats;
 	
 	int						RunJobsInternal( unsigned int threadNum, threadJobListState_t& state, bool singleJob );
+	int						PopJob( jobRange_t& range );
+	int						PopChildJob( int unit );
+	int						StealJob( int section, int unit );
+	int						FetchJob( int section, int unit );
+	void					JobsDone( int signal, int count );
 	
-	static void				Nop( void* data ) {}
+	job_t& 					GetJob( int jobIndex )
+	{
+		return ( jobIndex < jobList.Num() ) ? jobList[jobIndex] : childJobs[jobIndex - jobList.Num()];
+	}
+	void					ExecuteJob( jobContext_t& context, int jobIndex );
+	void					FinishJob( jobContext_t& context, int jobIndex );
+	void					SpawnJob( jobContext_t& context, jobRun_t function, void* data, int parent, int signal );
 	
-	static int				JOB_SIGNAL;
-	static int				JOB_SYNCHRONIZE;
-	static int				JOB_LIST_DONE;
+	static jobContext_t* 	GetContext();
+	
+	static ID_TLS			currentContext;
 };
 
-int idParallelJobList_Threads::JOB_SIGNAL;
-int idParallelJobList_Threads::JOB_SYNCHRONIZE;
-int idParallelJobList_Threads::JOB_LIST_DONE;
+ID_TLS idParallelJobList_Threads::currentContext;
 
 /*
 ========================
@@ -307,6 +375,7 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	listPriority( priority ),
 	numSyncs( 0 ),
 	lastSignalJob( 0 ),
+	numUnits( 0 ),
 	waitForGuard( NULL ),
 	currentDoneGuard( 0 ),
 	jobList()
@@ -316,10 +385,13 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	
 	this->maxJobs = maxJobs;
 	this->maxSyncs = maxSyncs;
-	jobList.AssureSize( maxJobs + maxSyncs * 2 + 1 );	// syncs go in as dummy jobs and one more to update the doneCount
+	jobList.AssureSize( maxJobs );
 	jobList.SetNum( 0 );
+	sections.AssureSize( maxSyncs + 1 );
+	sections.SetNum( 0 );
 	signalJobCount.AssureSize( maxSyncs + 1 );			// need one extra for submit
 	signalJobCount.SetNum( 0 );
+	childJobs.SetNum( maxJobs );						// child jobs are allocated from here while the list is running
 	
 	memset( &deferredThreadStats, 0, sizeof( threadStats_t ) );
 	memset( &threadStats, 0, sizeof( threadStats_t ) );
@@ -358,6 +430,11 @@ ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void* data
 		job_t& job = jobList.Alloc();
 		job.function = function;
 		job.data = data;
+		job.signal = signalJobCount.Num();
+		job.parent = -1;
+		job.pending.SetValue( 1 );
+		job.continuation = NULL;
+		job.continuationData = NULL;
 		job.executed = 0;
 	}
 	else
@@ -403,15 +480,11 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 		case SYNC_SIGNAL:
 		{
 			assert( !hasSignal );
-			if( jobList.Num() )
+			if( jobList.Num() > lastSignalJob )
 			{
-				assert( !hasSignal );
-				signalJobCount.Alloc();
-				signalJobCount[signalJobCount.Num() - 1].SetValue( jobList.Num() - lastSignalJob );
+				// close the current signal with the jobs added since the last signal
+				signalJobCount.Alloc().SetValue( jobList.Num() - lastSignalJob );
 				lastSignalJob = jobList.Num();
-				job_t& job = jobList.Alloc();
-				job.function = Nop;
-				job.data = & JOB_SIGNAL;
 				hasSignal = true;
 			}
 			break;
@@ -420,9 +493,16 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 		{
 			if( hasSignal )
 			{
-				job_t& job = jobList.Alloc();
-				job.function = Nop;
-				job.data = & JOB_SYNCHRONIZE;
+				// all jobs added from here on wait for the last signal
+				if( sections.Num() == 0 )
+				{
+					jobSection_t& first = sections.Alloc();
+					first.firstJob = 0;
+					first.waitSignal = -1;
+				}
+				jobSection_t& section = sections.Alloc();
+				section.firstJob = jobList.Num();
+				section.waitSignal = signalJobCount.Num() - 1;
 				hasSignal = false;
 				numSyncs++;
 			}
@@ -440,14 +520,12 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads* waitForJobLis
 {
 	assert( done );
 	assert( numSyncs <= maxSyncs );
-	assert( ( unsigned int ) jobList.Num() <= maxJobs + numSyncs * 2 );
-	assert( fetchLock.GetValue() == 0 );
+	assert( ( unsigned int ) jobList.Num() <= maxJobs );
 	
 	done = false;
-	currentJob.SetValue( 0 );
 	
 	memset( &deferredThreadStats, 0, sizeof( deferredThreadStats ) );
-	deferredThreadStats.numExecutedJobs = jobList.Num() - numSyncs * 2;
+	deferredThreadStats.numExecutedJobs = jobList.Num();
 	deferredThreadStats.numExecutedSyncs = numSyncs;
 	deferredThreadStats.submitTime = Sys_Microseconds();
 	deferredThreadStats.startTime = 0;
@@ -471,12 +549,18 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads* waitForJobLis
 	currentDoneGuard = ( currentDoneGuard + 1 ) & ( NUM_DONE_GUARDS - 1 );
 	doneGuards[currentDoneGuard].SetValue( 1 );
 	
-	signalJobCount.Alloc();
-	signalJobCount[signalJobCount.Num() - 1].SetValue( jobList.Num() - lastSignalJob );
-	
-	job_t& job = jobList.Alloc();
-	job.function = Nop;
-	job.data = & JOB_LIST_DONE;
+	if( jobList.Num() > lastSignalJob )
+	{
+		signalJobCount.Alloc().SetValue( jobList.Num() - lastSignalJob );
+	}
+	if( sections.Num() == 0 )
+	{
+		jobSection_t& section = sections.Alloc();
+		section.firstJob = 0;
+		section.waitSignal = -1;
+	}
+	numJobsRemaining.SetValue( jobList.Num() );
+	numChildJobs.SetValue( 0 );
 	
 	if( threaded )
 	{
@@ -487,11 +571,49 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads* waitForJobLis
 	else
 	{
 		// run all the jobs right here
+		DistributeJobs( 1 );
 		threadJobListState_t state( GetVersion() );
 		RunJobs( 0, state, false );
 	}
 }
 
+/*
+========================
+idParallelJobList_Threads::DistributeJobs
+========================
+*/
+void idParallelJobList_Threads::DistributeJobs( int numUnits )
+{
+	assert( !done );
+	assert( numUnits > 0 && numUnits <= MAX_THREADS );
+	
+	this->numUnits = numUnits;
+	
+	jobRanges.SetNum( sections.Num() * numUnits );
+	for( int i = 0; i < sections.Num(); i++ )
+	{
+		const int firstJob = sections[i].firstJob;
+		const int numJobs = ( ( i + 1 < sections.Num() ) ? sections[i + 1].firstJob : jobList.Num() ) - firstJob;
+		for( int j = 0; j < numUnits; j++ )
+		{
+			jobRange_t& range = jobRanges[i * numUnits + j];
+			range.lock.SetValue( 0 );
+			range.first = firstJob + ( numJobs * j ) / numUnits;
+			range.last = firstJob + ( numJobs * ( j + 1 ) ) / numUnits;
+		}
+	}
+	
+	jobStacks.SetNum( numUnits );
+	for( int i = 0; i < numUnits; i++ )
+	{
+		jobStacks[i].lock.SetValue( 0 );
+		jobStacks[i].bottom = 0;
+		jobStacks[i].top = 0;
+	}
+	
+	SYS_MEMORYBARRIER;
+}
+
 /*
 ========================
 idParallelJobList_Threads::Wait
@@ -510,7 +632,7 @@ void idParallelJobList_Threads::Wait()
 		bool waited = false;
 		uint64 waitStart = Sys_Microseconds();
 		
-		while( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 )
+		while( numJobsRemaining.GetValue() > 0 )
 		{
 			Sys_Yield();
 			waited = true;
@@ -522,7 +644,10 @@ void idParallelJobList_Threads::Wait()
 			waited = true;
 		}
 		
+		deferredThreadStats.numExecutedJobs += Min( numChildJobs.GetValue(), childJobs.Num() );
+		
 		jobList.SetNum( 0 );
+		sections.SetNum( 0 );
 		signalJobCount.SetNum( 0 );
 		numSyncs = 0;
 		lastSignalJob = 0;
@@ -541,7 +666,7 @@ idParallelJobList_Threads::TryWait
 */
 bool idParallelJobList_Threads::TryWait()
 {
-	if( jobList.Num() == 0 || signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 )
+	if( jobList.Num() == 0 || numJobsRemaining.GetValue() <= 0 )
 	{
 		Wait();
 		return true;
@@ -617,12 +742,362 @@ uint64 idParallelJobList_Threads::GetUnitWastedTimeMicroSec( int unit ) const
 	return threadStats.threadTotalTime[unit] - threadStats.threadExecTime[unit];
 }
 
+/*
+========================
+idParallelJobList_Threads::PopJob
+
+Takes the job at the front of the range, returns -1 if the range is empty.
+========================
+*/
+int idParallelJobList_Threads::PopJob( jobRange_t& range )
+{
+	// the owner only ever contends with a thief that is splitting the range
+	while( range.lock.Increment() != 1 )
+	{
+		range.lock.Decrement();
+		Sys_Yield();
+	}
+	int jobIndex = -1;
+	if( range.first < range.last )
+	{
+		jobIndex = range.first++;
+	}
+	range.lock.Decrement();
+	return jobIndex;
+}
+/*
+========================
+idParallelJobList_Threads::PopChildJob
+
+Takes the most recently added child job from the stack of the given unit, returns -1 if the stack is empty.
+========================
+*/
+int idParallelJobList_Threads::PopChildJob( int unit )
+{
+	jobStack_t& stack = jobStacks[unit];
+	if( stack.top <= stack.bottom )
+	{
+		return -1;
+	}
+	while( stack.lock.Increment() != 1 )
+	{
+		stack.lock.Decrement();
+		Sys_Yield();
+	}
+	int jobIndex = -1;
+	if( stack.top > stack.bottom )
+	{
+		jobIndex = stack.jobs[--stack.top];
+	}
+	if( stack.top <= stack.bottom )
+	{
+		stack.bottom = stack.top = 0;
+	}
+	stack.lock.Decrement();
+	return jobIndex;
+}
+
+/*
+========================
+idParallelJobList_Threads::StealJob
+
+Steals the back half of the job range of another unit, moves it into the range of
+the given unit and returns the first stolen job. If no other unit has any submitted
+jobs left, the oldest child job of another unit is stolen instead.
+Returns -1 if there is nothing left to steal.
+========================
+*/
+int idParallelJobList_Threads::StealJob( int section, int unit )
+{
+	jobRange_t* ranges = &jobRanges[section * numUnits];
+	
+	for( int i = 1; i < numUnits; i++ )
+	{
+		jobRange_t& victim = ranges[( unit + i ) % numUnits];
+		if( victim.first >= victim.last )
+		{
+			continue;
+		}
+		if( victim.lock.Increment() != 1 )
+		{
+			// somebody else is working on this range so try the next one
+			victim.lock.Decrement();
+			continue;
+		}
+		const int remaining = victim.last - victim.first;
+		if( remaining <= 0 )
+		{
+			victim.lock.Decrement();
+			continue;
+		}
+		const int stolenFirst = victim.last - ( ( remaining + 1 ) >> 1 );
+		const int stolenLast = victim.last;
+		victim.last = stolenFirst;
+		victim.lock.Decrement();
+		
+		// publish the rest of the stolen jobs so they can be stolen again
+		jobRange_t& own = ranges[unit];
+		while( own.lock.Increment() != 1 )
+		{
+			own.lock.Decrement();
+			Sys_Yield();
+		}
+		own.first = stolenFirst + 1;
+		own.last = stolenLast;
+		own.lock.Decrement();
+		
+		return stolenFirst;
+	}
+	
+	for( int i = 1; i < numUnits; i++ )
+	{
+		jobStack_t& victim = jobStacks[( unit + i ) % numUnits];
+		if( victim.top <= victim.bottom )
+		{
+			continue;
+		}
+		if( victim.lock.Increment() != 1 )
+		{
+			victim.lock.Decrement();
+			continue;
+		}
+		int jobIndex = -1;
+		if( victim.top > victim.bottom )
+		{
+			jobIndex = victim.jobs[victim.bottom++];
+		}
+		victim.lock.Decrement();
+		if( jobIndex >= 0 )
+		{
+			return jobIndex;
+		}
+	}
+	return -1;
+}
+
+/*
+========================
+idParallelJobList_Threads::FetchJob
+
+Grabs a child job of our own, a job from our own range in the given section or steals one from another unit.
+========================
+*/
+int idParallelJobList_Threads::FetchJob( int section, int unit )
+{
+	int jobIndex = PopChildJob( unit );
+	if( jobIndex < 0 )
+	{
+		jobIndex = PopJob( jobRanges[section * numUnits + unit] );
+		if( jobIndex < 0 )
+		{
+			jobIndex = StealJob( section, unit );
+		}
+	}
+	return jobIndex;
+}
+
+/*
+========================
+idParallelJobList_Threads::JobsDone
+========================
+*/
+void idParallelJobList_Threads::JobsDone( int signal, int count )
+{
+	if( count == 0 )
+	{
+		return;
+	}
+	signalJobCount[signal].Sub( count );
+	if( numJobsRemaining.Sub( count ) == 0 )
+	{
+		// this was the very last job of the job list
+		deferredThreadStats.endTime = Sys_Microseconds();
+		doneGuards[currentDoneGuard].Decrement();
+	}
+}
+
+/*
+========================
+idParallelJobList_Threads::GetContext
+========================
+*/
+idParallelJobList_Threads::jobContext_t* idParallelJobList_Threads::GetContext()
+{
+	return ( jobContext_t* )( ptrdiff_t )currentContext;
+}
+
+/*
+========================
+idParallelJobList_Threads::SpawnJob
+
+Adds a job while the list is running. If the job cannot be queued it is run right away.
+========================
+*/
+void idParallelJobList_Threads::SpawnJob( jobContext_t& context, jobRun_t function, void* data, int parent, int signal )
+{
+	if( parent >= 0 )
+	{
+		GetJob( parent ).pending.Increment();
+	}
+	
+	const int slot = numChildJobs.Increment() - 1;
+	if( slot < childJobs.Num() )
+	{
+		job_t& job = childJobs[slot];
+		job.function = function;
+		job.data = data;
+		job.signal = signal;
+		job.parent = parent;
+		job.pending.SetValue( 1 );
+		job.continuation = NULL;
+		job.continuationData = NULL;
+		job.executed = 0;
+		
+		// count the job before it becomes visible to the other units
+		signalJobCount[signal].Increment();
+		numJobsRemaining.Increment();
+		
+		jobStack_t& stack = jobStacks[context.unit];
+		while( stack.lock.Increment() != 1 )
+		{
+			stack.lock.Decrement();
+			Sys_Yield();
+		}
+		const bool pushed = ( stack.top < MAX_STACK_JOBS );
+		if( pushed )
+		{
+			stack.jobs[stack.top++] = jobList.Num() + slot;
+		}
+		stack.lock.Decrement();
+		
+		if( pushed )
+		{
+			return;
+		}
+		
+		// the job that is adding this job hasn't been counted as done yet, so these can't reach zero
+		signalJobCount[signal].Decrement();
+		numJobsRemaining.Decrement();
+	}
+	
+	// no more room so run the job right here as part of the parent
+	const int currentJob = context.job;
+	context.job = parent;
+	function( data );
+	context.job = currentJob;
+	
+	if( parent >= 0 )
+	{
+		FinishJob( context, parent );
+	}
+}
+
+/*
+========================
+idParallelJobList_Threads::FinishJob
+
+Called when a job or one of its child jobs is done, starts the continuation once everything is done.
+========================
+*/
+void idParallelJobList_Threads::FinishJob( jobContext_t& context, int jobIndex )
+{
+	job_t& job = GetJob( jobIndex );
+	if( job.pending.Decrement() > 0 )
+	{
+		return;
+	}
+	if( job.continuation != NULL )
+	{
+		// the continuation replaces this job as a child of the parent
+		SpawnJob( context, job.continuation, job.continuationData, job.parent, job.signal );
+	}
+	if( job.parent >= 0 )
+	{
+		FinishJob( context, job.parent );
+	}
+}
+
 #ifndef _DEBUG
 volatile float longJobTime;
 volatile jobRun_t longJobFunc;
 volatile void* longJobData;
 #endif
 
+/*
+========================
+idParallelJobList_Threads::ExecuteJob
+========================
+*/
+void idParallelJobList_Threads::ExecuteJob( jobContext_t& context, int jobIndex )
+{
+	job_t& job = GetJob( jobIndex );
+	
+	uint64 jobStart = Sys_Microseconds();
+	
+	context.job = jobIndex;
+	job.function( job.data );
+	job.executed = 1;
+	context.job = -1;
+	
+	uint64 jobEnd = Sys_Microseconds();
+	deferredThreadStats.threadExecTime[context.unit] += jobEnd - jobStart;
+	
+#ifndef _DEBUG
+	if( jobs_longJobMicroSec.GetInteger() > 0 )
+	{
+		if( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
+				&& GetId() != JOBLIST_UTILITY )
+		{
+			longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
+			longJobFunc = job.function;
+			longJobData = job.data;
+			const char* jobName = GetJobName( job.function );
+			const char* jobListName = GetJobListName( GetId() );
+			idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, context.unit );
+		}
+	}
+#endif
+	
+	FinishJob( context, jobIndex );
+}
+
+/*
+========================
+idParallelJobList_Threads::AddChildJob
+========================
+*/
+void idParallelJobList_Threads::AddChildJob( jobRun_t function, void* data )
+{
+	jobContext_t* context = GetContext();
+	if( context == NULL || context->jobList != this || context->job < 0 )
+	{
+		assert( false );	// child jobs can only be added by the jobs of this list
+		function( data );
+		return;
+	}
+	SpawnJob( *context, function, data, context->job, GetJob( context->job ).signal );
+}
+
+/*
+========================
+idParallelJobList_Threads::SetContinuationJob
+========================
+*/
+void idParallelJobList_Threads::SetContinuationJob( jobRun_t function, void* data )
+{
+	jobContext_t* context = GetContext();
+	if( context == NULL || context->jobList != this || context->job < 0 )
+	{
+		assert( false );	// continuations can only be set by the jobs of this list
+		function( data );
+		return;
+	}
+	job_t& job = GetJob( context->job );
+	assert( job.continuation == NULL );
+	job.continuation = function;
+	job.continuationData = data;
+}
+
 /*
 ========================
 idParallelJobList_Threads::RunJobsInternal
@@ -637,6 +1112,7 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 	}
 	
 	assert( threadNum < MAX_THREADS );
+	assert( ( int )threadNum < numUnits );
 	
 	if( deferredThreadStats.startTime == 0 )
 	{
@@ -645,140 +1121,76 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 	
 	int result = RUN_OK;
 	
+	jobContext_t context;
+	context.jobList = this;
+	context.unit = threadNum;
+	context.job = -1;
+	jobContext_t* previousContext = GetContext();
+	currentContext = ( ptrdiff_t )&context;
+	
+	// completed jobs are counted locally and only published when the signal changes
+	// or when this thread stops working on the list
+	int doneSignal = 0;
+	int doneCount = 0;
+	
 	do
 	{
-	
-		// run through all signals and syncs before the last job that has been or is being executed
-		// this loop is really an optimization to minimize the time spent in the fetchLock section below
-		for( ; state.lastJobIndex < ( int ) currentJob.GetValue() && state.lastJobIndex < jobList.Num(); state.lastJobIndex++ )
+		// if all sections have been handed out we're done
+		if( state.section >= sections.Num() )
 		{
-			if( jobList[state.lastJobIndex].data == & JOB_SIGNAL )
-			{
-				state.signalIndex++;
-				assert( state.signalIndex < signalJobCount.Num() );
-			}
-			else if( jobList[state.lastJobIndex].data == & JOB_SYNCHRONIZE )
-			{
-				assert( state.signalIndex > 0 );
-				if( signalJobCount[state.signalIndex - 1].GetValue() > 0 )
-				{
-					// stalled on a synchronization point
-					return ( result | RUN_STALLED );
-				}
-			}
-			else if( jobList[state.lastJobIndex].data == & JOB_LIST_DONE )
-			{
-				if( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 )
-				{
-					// stalled on a synchronization point
-					return ( result | RUN_STALLED );
-				}
-			}
+			result |= RUN_DONE;
+			break;
 		}
 		
-		// try to lock to fetch a new job
-		if( fetchLock.Increment() == 1 )
+		int jobIndex;
+		const jobSection_t& section = sections[state.section];
+		if( section.waitSignal >= 0 && signalJobCount[section.waitSignal].GetValue() > 0 )
 		{
-		
-			// grab a new job
-			state.nextJobIndex = currentJob.Increment() - 1;
-			
-			// run through any remaining signals and syncs (this should rarely iterate more than once)
-			for( ; state.lastJobIndex <= state.nextJobIndex && state.lastJobIndex < jobList.Num(); state.lastJobIndex++ )
+			// help out with whatever is left of the previous section
+			jobIndex = ( state.section > 0 ) ? FetchJob( state.section - 1, threadNum ) : -1;
+			if( jobIndex < 0 )
 			{
-				if( jobList[state.lastJobIndex].data == & JOB_SIGNAL )
-				{
-					state.signalIndex++;
-					assert( state.signalIndex < signalJobCount.Num() );
-				}
-				else if( jobList[state.lastJobIndex].data == & JOB_SYNCHRONIZE )
-				{
-					assert( state.signalIndex > 0 );
-					if( signalJobCount[state.signalIndex - 1].GetValue() > 0 )
-					{
-						// return this job to the list
-						currentJob.Decrement();
-						// release the fetch lock
-						fetchLock.Decrement();
-						// stalled on a synchronization point
-						return ( result | RUN_STALLED );
-					}
-				}
-				else if( jobList[state.lastJobIndex].data == & JOB_LIST_DONE )
-				{
-					if( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 )
-					{
-						// return this job to the list
-						currentJob.Decrement();
-						// release the fetch lock
-						fetchLock.Decrement();
-						// stalled on a synchronization point
-						return ( result | RUN_STALLED );
-					}
-					// decrement the done count
-					doneGuards[currentDoneGuard].Decrement();
-				}
+				// stalled on a synchronization point
+				result |= RUN_STALLED;
+				break;
 			}
-			// release the fetch lock
-			fetchLock.Decrement();
 		}
 		else
 		{
-			// release the fetch lock
-			fetchLock.Decrement();
-			// another thread is fetching right now so consider stalled
-			return ( result | RUN_STALLED );
-		}
-		
-		// if at the end of the job list we're done
-		if( state.nextJobIndex >= jobList.Num() )
-		{
-			return ( result | RUN_DONE );
-		}
-		
-		// execute the next job
-		{
-			uint64 jobStart = Sys_Microseconds();
-			
-			jobList[state.nextJobIndex].function( jobList[state.nextJobIndex].data );
-			jobList[state.nextJobIndex].executed = 1;
-			
-			uint64 jobEnd = Sys_Microseconds();
-			deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
-			
-#ifndef _DEBUG
-			if( jobs_longJobMicroSec.GetInteger() > 0 )
+			jobIndex = FetchJob( state.section, threadNum );
+			if( jobIndex < 0 )
 			{
-				if( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
-						&& GetId() != JOBLIST_UTILITY )
-				{
-					longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
-					longJobFunc = jobList[state.nextJobIndex].function;
-					longJobData = jobList[state.nextJobIndex].data;
-					const char* jobName = GetJobName( jobList[state.nextJobIndex].function );
-					const char* jobListName = GetJobListName( GetId() );
-					idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
-				}
+				// nothing left in this section so move on to the next one,
+				// publish what we've done first in case the next section waits for it
+				JobsDone( doneSignal, doneCount );
+				doneCount = 0;
+				state.section++;
+				continue;
 			}
-#endif
 		}
 		
+		const int signal = GetJob( jobIndex ).signal;
+		
+		ExecuteJob( context, jobIndex );
+		
 		result |= RUN_PROGRESS;
 		
-		// decrease the job count for the current signal
-		if( signalJobCount[state.signalIndex].Decrement() == 0 )
+		// count the job against its signal
+		if( signal != doneSignal )
 		{
-			// if this was the very last job of the job list
-			if( state.signalIndex == signalJobCount.Num() - 1 )
-			{
-				deferredThreadStats.endTime = Sys_Microseconds();
-				return ( result | RUN_DONE );
-			}
+			JobsDone( doneSignal, doneCount );
+			doneSignal = signal;
+			doneCount = 0;
 		}
+		doneCount++;
 		
 	}
 	while( ! singleJob );
 	
+	JobsDone( doneSignal, doneCount );
+	
+	currentContext = ( ptrdiff_t )previousContext;
+	
 	return result;
 }
 
@@ -880,6 +1292,28 @@ void idParallelJobList::InsertSyncPoint( jobSyncType_t syncType )
 	jobListThreads->InsertSyncPoint( syncType );
 }
 
+/*
+========================
+idParallelJobList::AddChildJob
+========================
+*/
+void idParallelJobList::AddChildJob( jobRun_t function, void* data )
+{
+	assert( IsRegisteredJob( function ) );
+	jobListThreads->AddChildJob( function, data );
+}
+
+/*
+========================
+idParallelJobList::SetContinuationJob
+========================
+*/
+void idParallelJobList::SetContinuationJob( jobRun_t function, void* data )
+{
+	assert( IsRegisteredJob( function ) );
+	jobListThreads->SetContinuationJob( function, data );
+}
+
 /*
 ========================
 idParallelJobList::Wait
@@ -1156,9 +1590,7 @@ int idJobThread::Run()
 		{
 			threadJobListState[numJobLists].jobList = jobLists[firstJobList & ( MAX_JOBLISTS - 1 )].jobList;
 			threadJobListState[numJobLists].version = jobLists[firstJobList & ( MAX_JOBLISTS - 1 )].version;
-			threadJobListState[numJobLists].signalIndex = 0;
-			threadJobListState[numJobLists].lastJobIndex = 0;
-			threadJobListState[numJobLists].nextJobIndex = -1;
+			threadJobListState[numJobLists].section = 0;
 			numJobLists++;
 			firstJobList++;
 		}
@@ -1264,9 +1696,12 @@ extern void Sys_CPUCount( int& logicalNum, int& coreNum, int& packageNum );
 //
 // Hyperthreading is not dead yet.  Intel's Core i7 Processor is quad-core with HT for 8 logicals.
 
-// DOOM3: We don't have that many jobs, so just set this fairly low so we don't spin up a ton of idle threads
-#define MAX_JOB_THREADS		2
-#define NUM_JOB_THREADS		"2"
+// Job threads are only started for the available logical cores, so idle threads are never
+// spun up on smaller machines. By default one job thread is used per logical core, leaving
+// one core for the main thread, but never less than the 2 threads that DOOM3 always used.
+#define MAX_JOB_THREADS		32
+#define NUM_JOB_THREADS		"-1"
+#define MIN_DEFAULT_THREADS	2
 #define JOB_THREAD_CORES	{	CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY,	\
 								CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY,	\
 								CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY,	\
@@ -1277,7 +1712,7 @@ extern void Sys_CPUCount( int& logicalNum, int& coreNum, int& packageNum );
 								CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY }
 
 
-idCVar jobs_numThreads( "jobs_numThreads", NUM_JOB_THREADS, CVAR_INTEGER | CVAR_NOCHEAT, "number of threads used to crunch through jobs", 0, MAX_JOB_THREADS );
+idCVar jobs_numThreads( "jobs_numThreads", NUM_JOB_THREADS, CVAR_INTEGER | CVAR_NOCHEAT, "number of threads used to crunch through jobs, -1 = one per logical core", -1, MAX_JOB_THREADS );
 
 class idParallelJobManagerLocal : public idParallelJobManager
 {
@@ -1301,7 +1736,11 @@ public:
 	void						Submit( idParallelJobList_Threads* jobList, int parallelism );
 	
 private:
+	void						UpdateMaxThreads();
+	
+	
 	idJobThread						threads[MAX_JOB_THREADS];
+	unsigned int					numJobThreads;			// number of threads that were actually started
 	unsigned int					maxThreads;
 	int								numPhysicalCpuCores;
 	int								numLogicalCpuCores;
@@ -1333,13 +1772,32 @@ void idParallelJobManagerLocal::Init()
 	core_t cores[] = JOB_THREAD_CORES;
 	assert( sizeof( cores ) / sizeof( cores[0] ) >= MAX_JOB_THREADS );
 	
-	for( int i = 0; i < MAX_JOB_THREADS; i++ )
+	Sys_CPUCount( numLogicalCpuCores, numPhysicalCpuCores, numCpuPackages );
+	
+	// there is no point in having more job threads than logical cores
+	numJobThreads = idMath::ClampInt( MIN_DEFAULT_THREADS, MAX_JOB_THREADS, numLogicalCpuCores );
+	for( unsigned int i = 0; i < numJobThreads; i++ )
 	{
 		threads[i].Start( cores[i], i );
 	}
-	maxThreads = jobs_numThreads.GetInteger();
-	
-	Sys_CPUCount( numPhysicalCpuCores, numLogicalCpuCores, numCpuPackages );
+	UpdateMaxThreads();
+}
+
+/*
+========================
+idParallelJobManagerLocal::UpdateMaxThreads
+========================
+*/
+void idParallelJobManagerLocal::UpdateMaxThreads()
+{
+	int numThreads = jobs_numThreads.GetInteger();
+	if( numThreads < 0 )
+	{
+		// leave one core for the thread that is submitting the jobs
+		numThreads = Max( MIN_DEFAULT_THREADS, numLogicalCpuCores - 1 );
+	}
+	maxThreads = idMath::ClampInt( 0, numJobThreads, numThreads );
+	jobs_numThreads.ClearModified();
 }
 
 /*
@@ -1349,7 +1807,7 @@ idParallelJobManagerLocal::Shutdown
 */
 void idParallelJobManagerLocal::Shutdown()
 {
-	for( int i = 0; i < MAX_JOB_THREADS; i++ )
+	for( unsigned int i = 0; i < numJobThreads; i++ )
 	{
 		threads[i].StopThread();
 	}
@@ -1460,8 +1918,7 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads* jobList, int
 {
 	if( jobs_numThreads.IsModified() )
 	{
-		maxThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, jobs_numThreads.GetInteger() );
-		jobs_numThreads.ClearModified();
+		UpdateMaxThreads();
 	}
 	
 	// determine the number of threads to use
@@ -1472,15 +1929,15 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads* jobList, int
 	}
 	else if( parallelism == JOBLIST_PARALLELISM_MAX_CORES )
 	{
-		numThreads = numLogicalCpuCores;
+		numThreads = Min( numLogicalCpuCores, ( int )numJobThreads );
 	}
 	else if( parallelism == JOBLIST_PARALLELISM_MAX_THREADS )
 	{
-		numThreads = MAX_JOB_THREADS;
+		numThreads = numJobThreads;
 	}
-	else if( parallelism > MAX_JOB_THREADS )
+	else if( parallelism > ( int )numJobThreads )
 	{
-		numThreads = MAX_JOB_THREADS;
+		numThreads = numJobThreads;
 	}
 	else
 	{
@@ -1489,11 +1946,15 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads* jobList, int
 	
 	if( numThreads <= 0 )
 	{
+		jobList->DistributeJobs( 1 );
 		threadJobListState_t state( jobList->GetVersion() );
 		jobList->RunJobs( 0, state, false );
 		return;
 	}
 	
+	// give every thread its own share of the jobs, the rest is balanced by stealing
+	jobList->DistributeJobs( numThreads );
+	
 	for( int i = 0; i < numThreads; i++ )
 	{
 		threads[i].AddJobList( jobList );
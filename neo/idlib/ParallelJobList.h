@@ -90,6 +90,13 @@ public:
 	CellSpursJob128* 		AddJobSPURS();
 	void					InsertSyncPoint( jobSyncType_t syncType );
 	
+	// Add a job from within a job that is running on this list. Child jobs are counted against
+	// the same sync point as the job that adds them, so sync points and Wait() include them.
+	void					AddChildJob( jobRun_t function, void* data );
+	// Run a job once the calling job and all of its child jobs are done. Can only be called
+	// from within a job that is running on this list.
+	void					SetContinuationJob( jobRun_t function, void* data );
+	
 	// Submit the jobs in this list.
 	void					Submit( idParallelJobList* waitForJobList = NULL, int parallelism = JOBLIST_PARALLELISM_DEFAULT );
 	// Wait for the jobs in this list to finish. Will spin in place if any jobs are not done.
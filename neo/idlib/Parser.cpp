@@ -509,7 +509,7 @@ int idParser::ReadSourceToken( idToken* token )
 	t = idParser::tokens;
 	assert( idParser::tokens != NULL );
 	idParser::tokens = idParser::tokens->next;
-	delete t;
+	FreeToken( t );
 	return true;
 }
 
@@ -522,12 +522,47 @@ int idParser::UnreadSourceToken( idToken* token )
 {
 	idToken* t;
 	
-	t = new( TAG_IDLIB_PARSER ) idToken( token );
+	t = AllocToken( token );
 	t->next = idParser::tokens;
 	idParser::tokens = t;
 	return true;
 }
 
+/*
+================
+idParser::AllocToken
+
+Returns a copy of the given token, reusing a previously freed token when available.
+The recycled token keeps its string buffer, so copying a short token doesn't allocate.
+================
+*/
+idToken* idParser::AllocToken( const idToken* token )
+{
+	idToken* t;
+	
+	if( freeTokens == NULL )
+	{
+		return new( TAG_IDLIB_PARSER ) idToken( token );
+	}
+	t = freeTokens;
+	freeTokens = freeTokens->next;
+	*t = *token;
+	return t;
+}
+
+/*
+================
+idParser::FreeToken
+
+Tokens are always allocated with new so a recycled token can still be deleted by FreeDefine.
+================
+*/
+void idParser::FreeToken( idToken* token )
+{
+	token->next = freeTokens;
+	freeTokens = token;
+}
+
 /*
 ================
 idParser::ReadDefineParms
@@ -633,7 +668,7 @@ int idParser::ReadDefineParms( define_t* define, idToken** parms, int maxparms )
 			if( numparms < define->numparms )
 			{
 			
-				t = new( TAG_IDLIB_PARSER ) idToken( token );
+				t = AllocToken( &token );
 				t->next = NULL;
 				if( last ) last->next = t;
 				else parms[numparms] = t;
@@ -810,7 +845,7 @@ int idParser::ExpandBuiltinDefine( idToken* deftoken, define_t* define, idToken*
 	idToken* token;
 	char buf[MAX_STRING_CHARS];
 	
-	token = new( TAG_IDLIB_PARSER ) idToken( deftoken );
+	token = AllocToken( deftoken );
 	switch( define->builtin )
 	{
 		case BUILTIN_LINE:
@@ -932,7 +967,7 @@ int idParser::ExpandDefine( idToken* deftoken, define_t* define, idToken** first
 		{
 			for( pt = parms[parmnum]; pt; pt = pt->next )
 			{
-				t = new( TAG_IDLIB_PARSER ) idToken( pt );
+				t = AllocToken( pt );
 				//add the token to the list
 				t->next = NULL;
 				if( last ) last->next = t;
@@ -965,7 +1000,7 @@ int idParser::ExpandDefine( idToken* deftoken, define_t* define, idToken** first
 						idParser::Error( "can't stringize tokens" );
 						return false;
 					}
-					t = new( TAG_IDLIB_PARSER ) idToken( token );
+					t = AllocToken( &token );
 					t->line = deftoken->line;
 				}
 				else
@@ -976,7 +1011,7 @@ int idParser::ExpandDefine( idToken* deftoken, define_t* define, idToken** first
 			}
 			else
 			{
-				t = new( TAG_IDLIB_PARSER ) idToken( dt );
+				t = AllocToken( dt );
 				t->line = deftoken->line;
 			}
 			// add the token to the list
@@ -1007,10 +1042,10 @@ int idParser::ExpandDefine( idToken* deftoken, define_t* define, idToken** first
 						idParser::Error( "can't merge '%s' with '%s'", t1->c_str(), t2->c_str() );
 						return false;
 					}
-					delete t1->next;
+					FreeToken( t1->next );
 					t1->next = t2->next;
 					if( t2 == last ) last = t1;
-					delete t2;
+					FreeToken( t2 );
 					continue;
 				}
 			}
@@ -1026,7 +1061,7 @@ int idParser::ExpandDefine( idToken* deftoken, define_t* define, idToken** first
 		for( pt = parms[i]; pt; pt = nextpt )
 		{
 			nextpt = pt->next;
-			delete pt;
+			FreeToken( pt );
 		}
 	}
 	
@@ -2154,7 +2189,7 @@ int idParser::Evaluate( signed int* intvalue, double* floatvalue, int integer )
 			if( defined )
 			{
 				defined = false;
-				t = new( TAG_IDLIB_PARSER ) idToken( token );
+				t = AllocToken( &token );
 				t->next = NULL;
 				if( lasttoken ) lasttoken->next = t;
 				else firsttoken = t;
@@ -2163,7 +2198,7 @@ int idParser::Evaluate( signed int* intvalue, double* floatvalue, int integer )
 			else if( token == "defined" )
 			{
 				defined = true;
-				t = new( TAG_IDLIB_PARSER ) idToken( token );
+				t = AllocToken( &token );
 				t->next = NULL;
 				if( lasttoken ) lasttoken->next = t;
 				else firsttoken = t;
@@ -2187,7 +2222,7 @@ int idParser::Evaluate( signed int* intvalue, double* floatvalue, int integer )
 		//if the token is a number or a punctuation
 		else if( token.type == TT_NUMBER || token.type == TT_PUNCTUATION )
 		{
-			t = new( TAG_IDLIB_PARSER ) idToken( token );
+			t = AllocToken( &token );
 			t->next = NULL;
 			if( lasttoken ) lasttoken->next = t;
 			else firsttoken = t;
@@ -2215,7 +2250,7 @@ int idParser::Evaluate( signed int* intvalue, double* floatvalue, int integer )
 		Log_Write( " %s", t->c_str() );
 #endif //DEBUG_EVAL
 		nexttoken = t->next;
-		delete t;
+		FreeToken( t );
 	} //end for
 #ifdef DEBUG_EVAL
 	if( integer ) Log_Write( "eval result: %d", *intvalue );
@@ -2267,7 +2302,7 @@ int idParser::DollarEvaluate( signed int* intvalue, double* floatvalue, int inte
 			if( defined )
 			{
 				defined = false;
-				t = new( TAG_IDLIB_PARSER ) idToken( token );
+				t = AllocToken( &token );
 				t->next = NULL;
 				if( lasttoken ) lasttoken->next = t;
 				else firsttoken = t;
@@ -2276,7 +2311,7 @@ int idParser::DollarEvaluate( signed int* intvalue, double* floatvalue, int inte
 			else if( token == "defined" )
 			{
 				defined = true;
-				t = new( TAG_IDLIB_PARSER ) idToken( token );
+				t = AllocToken( &token );
 				t->next = NULL;
 				if( lasttoken ) lasttoken->next = t;
 				else firsttoken = t;
@@ -2306,7 +2341,7 @@ int idParser::DollarEvaluate( signed int* intvalue, double* floatvalue, int inte
 			{
 				break;
 			}
-			t = new( TAG_IDLIB_PARSER ) idToken( token );
+			t = AllocToken( &token );
 			t->next = NULL;
 			if( lasttoken ) lasttoken->next = t;
 			else firsttoken = t;
@@ -2334,7 +2369,7 @@ int idParser::DollarEvaluate( signed int* intvalue, double* floatvalue, int inte
 		Log_Write( " %s", t->c_str() );
 #endif //DEBUG_EVAL
 		nexttoken = t->next;
-		delete t;
+		FreeToken( t );
 	} //end for
 #ifdef DEBUG_EVAL
 	if( integer ) Log_Write( "$eval result: %d", *intvalue );
@@ -3677,6 +3712,13 @@ void idParser::FreeSource( bool keepDefines )
 		tokens = tokens->next;
 		delete token;
 	}
+	// free the recycled tokens
+	while( freeTokens )
+	{
+		token = freeTokens;
+		freeTokens = freeTokens->next;
+		delete token;
+	}
 	// free all indents
 	while( indentstack )
 	{
@@ -3773,6 +3815,7 @@ idParser::idParser()
 	this->definehash = NULL;
 	this->defines = NULL;
 	this->tokens = NULL;
+	this->freeTokens = NULL;
 	this->marker_p = NULL;
 }
 
@@ -3792,6 +3835,7 @@ idParser::idParser( int flags )
 	this->definehash = NULL;
 	this->defines = NULL;
 	this->tokens = NULL;
+	this->freeTokens = NULL;
 	this->marker_p = NULL;
 }
 
@@ -3811,6 +3855,7 @@ idParser::idParser( const char* filename, int flags, bool OSPath )
 	this->definehash = NULL;
 	this->defines = NULL;
 	this->tokens = NULL;
+	this->freeTokens = NULL;
 	this->marker_p = NULL;
 	LoadFile( filename, OSPath );
 }
@@ -3831,6 +3876,7 @@ idParser::idParser( const char* ptr, int length, const char* name, int flags )
 	this->definehash = NULL;
 	this->defines = NULL;
 	this->tokens = NULL;
+	this->freeTokens = NULL;
 	this->marker_p = NULL;
 	LoadMemory( ptr, length, name );
 }
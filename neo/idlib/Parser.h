@@ -197,6 +197,7 @@ protected:
 	int				flags;						// flags used for script parsing
 	idLexer* 		scriptstack;				// stack with scripts of the source
 	idToken* 		tokens;						// tokens to read first
+	idToken* 		freeTokens;					// recycled tokens, saves an allocation for each unread or expanded token
 	define_t* 		defines;					// list with macro definitions
 	define_t** 		definehash;					// hash chain with defines
 	indent_t* 		indentstack;				// stack with indents
@@ -211,6 +212,8 @@ protected:
 	int				ReadSourceToken( idToken* token );
 	int				ReadLine( idToken* token );
 	int				UnreadSourceToken( idToken* token );
+	idToken* 		AllocToken( const idToken* token );
+	void			FreeToken( idToken* token );
 	int				ReadDefineParms( define_t* define, idToken** parms, int maxparms );
 	int				StringizeTokens( idToken* tokens, idToken* token );
 	int				MergeTokens( idToken* t1, idToken* t2 );
@@ -131,6 +131,7 @@ class idStr
 public:
 	idStr();
 	idStr( const idStr& text );
+	idStr( idStr&& text );		// takes over the allocated buffer of text
 	idStr( const idStr& text, int start, int end );
 	idStr( const char* text );
 	idStr( const char* text, int start, int end );
@@ -150,6 +151,7 @@ public:
 	char& 				operator[]( int index );
 	
 	void				operator=( const idStr& text );
+	void				operator=( idStr&& text );		// takes over the allocated buffer of text
 	void				operator=( const char* text );
 	
 	friend idStr		operator+( const idStr& a, const idStr& b );
@@ -488,6 +490,12 @@ ID_INLINE idStr::idStr( const idStr& text )
 	len = l;
 }
 
+ID_INLINE idStr::idStr( idStr&& text )
+{
+	Construct();
+	operator=( std::move( text ) );
+}
+
 ID_INLINE idStr::idStr( const idStr& text, int start, int end )
 {
 	Construct();
@@ -682,6 +690,46 @@ ID_INLINE void idStr::operator=( const idStr& text )
 	len = l;
 }
 
+/*
+========================
+idStr::operator=
+
+Strings in the base buffer are short and static buffers can't be handed over, so those are
+copied. Otherwise the allocated buffer moves and text is left empty. If this string has an
+allocated buffer of its own, text gets that buffer so it can be reused without allocating,
+like the copy assignment reuses the buffer of the target.
+========================
+*/
+ID_INLINE void idStr::operator=( idStr&& text )
+{
+	if( text.data == text.baseBuffer || text.IsStatic() || IsStatic() )
+	{
+		operator=( static_cast< const idStr& >( text ) );
+		return;
+	}
+	if( this == &text )
+	{
+		return;
+	}
+	if( data != baseBuffer )
+	{
+		char* oldData = data;
+		const int oldAlloced = GetAlloced();
+		data = text.data;
+		len = text.len;
+		SetAlloced( text.GetAlloced() );
+		text.data = oldData;
+		text.len = 0;
+		text.data[ 0 ] = '\0';
+		text.SetAlloced( oldAlloced );
+		return;
+	}
+	data = text.data;
+	len = text.len;
+	SetAlloced( text.GetAlloced() );
+	text.Construct();
+}
+
 ID_INLINE idStr operator+( const idStr& a, const idStr& b )
 {
 	idStr result( a );
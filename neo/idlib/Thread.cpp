@@ -239,7 +239,11 @@ int idSysThread::ThreadProc( idSysThread* thread )
 				
 				retVal = thread->Run();
 			}
+			// clear the running flag before raising the signal, the thread object may be
+			// destroyed as soon as the thread waiting on the signal wakes up
+			thread->isRunning = false;
 			thread->signalWorkerDone.Raise();
+			return retVal;
 		}
 		else
 		{
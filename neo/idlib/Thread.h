@@ -178,6 +178,12 @@ public:
 		value = ( interlockedInt_t )v;
 	}
 	
+	// atomically sets a new value and returns the previous value
+	int					Exchange( int v )
+	{
+		return Sys_InterlockedExchange( value, ( interlockedInt_t ) v );
+	}
+	
 private:
 	interlockedInt_t	value;
 };
@@ -210,3 +210,65 @@ void idToken::ClearTokenWhiteSpace()
 	whiteSpaceEnd_p = NULL;
 	linesCrossed = 0;
 }
+
+/*
+================
+idTokenRef::ToToken
+================
+*/
+void idTokenRef::ToToken( idToken* token ) const
+{
+	token->Clear();
+	token->Append( text, length );
+	token->type = type;
+	token->subtype = subtype & ~TT_VALUESVALID;
+	token->line = line;
+	token->linesCrossed = linesCrossed;
+	token->flags = 0;
+	token->whiteSpaceStart_p = NULL;
+	token->whiteSpaceEnd_p = NULL;
+}
+
+/*
+================
+idTokenRef::ToString
+================
+*/
+void idTokenRef::ToString( idStr& str ) const
+{
+	str.Clear();
+	str.Append( text, length );
+}
+
+/*
+================
+idTokenRef::GetDoubleValue
+================
+*/
+double idTokenRef::GetDoubleValue() const
+{
+	if( type != TT_NUMBER )
+	{
+		return 0.0;
+	}
+	// numbers are short enough to fit the base buffer of the token
+	idToken token;
+	ToToken( &token );
+	return token.GetDoubleValue();
+}
+
+/*
+================
+idTokenRef::GetIntValue
+================
+*/
+int idTokenRef::GetIntValue() const
+{
+	if( type != TT_NUMBER )
+	{
+		return 0;
+	}
+	idToken token;
+	ToToken( &token );
+	return token.GetIntValue();
+}
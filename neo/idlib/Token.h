@@ -73,6 +73,7 @@ class idToken : public idStr
 
 	friend class idParser;
 	friend class idLexer;
+	friend class idTokenRef;
 	
 public:
 	int				type;								// token type
@@ -180,4 +181,86 @@ ID_INLINE void idToken::AppendDirty( const char a )
 	data[len++] = a;
 }
 
+/*
+===============================================================================
+
+	idTokenRef is a token read with idLexer::ReadTokenRef that references the
+	script text instead of copying it. The text is NOT zero terminated and only
+	stays valid while the script buffer it was read from is loaded. Strings with
+	escape characters, concatenated strings and unread tokens are decoded into
+	the lexer and are only valid until the next token is read.
+
+===============================================================================
+*/
+
+class idTokenRef
+{
+public:
+	const char* 	text;								// token text, not zero terminated
+	int				length;								// number of characters in text
+	int				type;								// token type
+	int				subtype;							// token sub type
+	int				line;								// line in script the token was on
+	int				linesCrossed;						// number of lines crossed in white space before token
+	
+public:
+	idTokenRef();
+	
+	int				Length() const;
+	int				Cmp( const char* str ) const;		// case sensitive compare with a zero terminated string
+	int				Icmp( const char* str ) const;		// case insensitive compare with a zero terminated string
+	bool			operator==( const char* str ) const;
+	bool			operator!=( const char* str ) const;
+	
+	void			ToToken( idToken* token ) const;	// copy the text and type into a real token
+	void			ToString( idStr& str ) const;
+	double			GetDoubleValue() const;				// double value of TT_NUMBER
+	float			GetFloatValue() const;				// float value of TT_NUMBER
+	int				GetIntValue() const;				// int value of TT_NUMBER
+};
+
+ID_INLINE idTokenRef::idTokenRef() : text( "" ), length(), type(), subtype(), line(), linesCrossed()
+{
+}
+
+ID_INLINE int idTokenRef::Length() const
+{
+	return length;
+}
+
+ID_INLINE int idTokenRef::Cmp( const char* str ) const
+{
+	int d = idStr::Cmpn( text, str, length );
+	if( d != 0 )
+	{
+		return d;
+	}
+	return -( unsigned char )str[length];
+}
+
+ID_INLINE int idTokenRef::Icmp( const char* str ) const
+{
+	int d = idStr::Icmpn( text, str, length );
+	if( d != 0 )
+	{
+		return d;
+	}
+	return -( unsigned char )str[length];
+}
+
+ID_INLINE bool idTokenRef::operator==( const char* str ) const
+{
+	return ( Cmp( str ) == 0 );
+}
+
+ID_INLINE bool idTokenRef::operator!=( const char* str ) const
+{
+	return ( Cmp( str ) != 0 );
+}
+
+ID_INLINE float idTokenRef::GetFloatValue() const
+{
+	return ( float ) GetDoubleValue();
+}
+
 #endif /* !__TOKEN_H__ */
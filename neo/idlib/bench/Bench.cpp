@@ -0,0 +1,465 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+
+idBenchmark* 	idBenchmark::list = NULL;
+idStrList		bench_declFiles;
+
+// file extensions of the loose decl files that are picked up with -decls
+static const char* BENCH_DECL_EXTENSIONS = "mtr def skin sndshd prt af fx pda vfx guide table";
+
+/*
+================
+idBenchTimer::idBenchTimer
+================
+*/
+idBenchTimer::idBenchTimer( int maxSamples_, int maxMicroseconds_ )
+{
+	maxSamples = Max( maxSamples_, 1 );
+	maxMicroseconds = ( uint64 )Max( maxMicroseconds_, 0 );
+	startTime = 0;
+	sampleTime = 0;
+	numCalls = 0;
+	bytes = 0;
+	resultName = NULL;
+	resultValue = 0.0;
+	startAllocs = 0;
+	allocsPerRun = -1.0;
+	// allocate all samples up front so recording them doesn't show up in the allocation count
+	samples.SetGranularity( maxSamples );
+	samples.Resize( maxSamples );
+}
+
+/*
+================
+idBenchTimer::Next
+
+The first run warms up the caches and is not recorded. Sampling stops when the sample count
+or the time budget of the benchmark is reached, whichever comes first. With memory tracking the
+allocations made by the recorded runs are counted as well.
+================
+*/
+bool idBenchTimer::Next()
+{
+	const uint64 now = Sys_Microseconds();
+	numCalls++;
+	
+	if( numCalls == 1 )
+	{
+		sampleTime = now;
+		return true;
+	}
+	if( numCalls == 2 )
+	{
+#if defined( ID_MEMORY_TRACKING )
+		startAllocs = Mem_GetNumAllocations();
+#endif
+		startTime = now;
+		sampleTime = now;
+		return true;
+	}
+	
+	samples.Append( now - sampleTime );
+	if( samples.Num() >= maxSamples || now - startTime >= maxMicroseconds )
+	{
+#if defined( ID_MEMORY_TRACKING )
+		allocsPerRun = ( double )( Mem_GetNumAllocations() - startAllocs ) / samples.Num();
+#endif
+		return false;
+	}
+	sampleTime = Sys_Microseconds();
+	return true;
+}
+
+/*
+================
+idBenchmark::idBenchmark
+================
+*/
+idBenchmark::idBenchmark( const char* name_, const char* group_, benchFunction_t function_ )
+{
+	name = name_;
+	group = group_;
+	function = function_;
+	next = list;
+	list = this;
+}
+
+/*
+================================================
+benchResult_t
+================================================
+*/
+struct benchResult_t
+{
+	idStr			name;
+	int				numSamples;
+	double			minTime;
+	double			medianTime;
+	double			meanTime;
+	double			stdDevTime;
+	int64			bytes;
+	const char* 	resultName;
+	double			resultValue;
+	double			allocsPerRun;
+	idStr			failure;
+};
+
+/*
+================================================
+idSort_BenchSample
+================================================
+*/
+class idSort_BenchSample : public idSort_Quick< uint64, idSort_BenchSample >
+{
+public:
+	int Compare( const uint64& a, const uint64& b ) const
+	{
+		return ( a < b ) ? -1 : ( ( a > b ) ? 1 : 0 );
+	}
+};
+
+/*
+================================================
+idSort_Benchmark
+
+Sorts by group and name so the output is stable.
+================================================
+*/
+class idSort_Benchmark : public idSort_Quick< idBenchmark*, idSort_Benchmark >
+{
+public:
+	int Compare( idBenchmark* const& a, idBenchmark* const& b ) const
+	{
+		const int c = idStr::Icmp( a->group, b->group );
+		return ( c != 0 ) ? c : idStr::Icmp( a->name, b->name );
+	}
+};
+
+/*
+================
+Bench_Stats
+================
+*/
+static void Bench_Stats( const idBenchTimer& timer, benchResult_t& result )
+{
+	idList<uint64> sorted;
+	sorted.SetNum( timer.NumSamples() );
+	double sum = 0.0;
+	for( int i = 0; i < timer.NumSamples(); i++ )
+	{
+		sorted[i] = timer.GetSample( i );
+		sum += ( double )sorted[i];
+	}
+	sorted.SortWithTemplate( idSort_BenchSample() );
+	
+	const int n = sorted.Num();
+	result.numSamples = n;
+	result.minTime = ( n > 0 ) ? ( double )sorted[0] : 0.0;
+	result.medianTime = ( n > 0 ) ? ( ( n & 1 ) ? ( double )sorted[n / 2] : ( sorted[n / 2 - 1] + sorted[n / 2] ) * 0.5 ) : 0.0;
+	result.meanTime = ( n > 0 ) ? sum / n : 0.0;
+	
+	double variance = 0.0;
+	for( int i = 0; i < n; i++ )
+	{
+		const double d = ( double )sorted[i] - result.meanTime;
+		variance += d * d;
+	}
+	result.stdDevTime = ( n > 1 ) ? sqrt( variance / ( n - 1 ) ) : 0.0;
+	
+	result.bytes = timer.GetBytes();
+	result.resultName = timer.GetResultName();
+	result.resultValue = timer.GetResultValue();
+	result.allocsPerRun = timer.GetAllocsPerRun();
+	result.failure = ( timer.GetFailure() != NULL ) ? timer.GetFailure() : "";
+}
+
+/*
+================
+Bench_Throughput
+
+Megabytes per second based on the median time.
+================
+*/
+static double Bench_Throughput( const benchResult_t& result )
+{
+	if( result.bytes <= 0 || result.medianTime <= 0.0 )
+	{
+		return 0.0;
+	}
+	return ( double )result.bytes / result.medianTime * ( 1000000.0 / ( 1024.0 * 1024.0 ) );
+}
+
+/*
+================
+Bench_JSONString
+================
+*/
+static idStr Bench_JSONString( const char* text )
+{
+	idStr out = "\"";
+	for( const char* s = text; *s != '\0'; s++ )
+	{
+		if( *s == '"' || *s == '\\' )
+		{
+			out += '\\';
+			out += *s;
+		}
+		else if( ( unsigned char )*s < ' ' )
+		{
+			out += va( "\\u%04x", ( unsigned char ) * s );
+		}
+		else
+		{
+			out += *s;
+		}
+	}
+	out += '"';
+	return out;
+}
+
+/*
+================
+Bench_WriteJSON
+================
+*/
+static bool Bench_WriteJSON( const char* fileName, const idList<benchResult_t>& results, const char* declSource )
+{
+	FILE* f = fopen( fileName, "w" );
+	if( f == NULL )
+	{
+		return false;
+	}
+	
+	fprintf( f, "{\n" );
+	fprintf( f, "\t\"suite\": \"idlib_bench\",\n" );
+	fprintf( f, "\t\"version\": %s,\n", Bench_JSONString( ENGINE_VERSION ).c_str() );
+	fprintf( f, "\t\"simd\": %s,\n", Bench_JSONString( SIMDProcessor->GetName() ).c_str() );
+	fprintf( f, "\t\"cpuid\": %d,\n", ( int )SIMDProcessor->cpuid );
+	fprintf( f, "\t\"decls\": %s,\n", Bench_JSONString( declSource ).c_str() );
+	fprintf( f, "\t\"benchmarks\": [\n" );
+	for( int i = 0; i < results.Num(); i++ )
+	{
+		const benchResult_t& r = results[i];
+		fprintf( f, "\t\t{ \"name\": %s, \"samples\": %d, \"min_us\": %.1f, \"median_us\": %.1f, \"mean_us\": %.1f, \"stddev_us\": %.1f",
+				 Bench_JSONString( r.name ).c_str(), r.numSamples, r.minTime, r.medianTime, r.meanTime, r.stdDevTime );
+		if( r.bytes > 0 )
+		{
+			fprintf( f, ", \"bytes\": %lld, \"mb_per_s\": %.2f", ( long long )r.bytes, Bench_Throughput( r ) );
+		}
+		if( r.allocsPerRun >= 0.0 )
+		{
+			fprintf( f, ", \"allocs_per_run\": %.1f", r.allocsPerRun );
+		}
+		if( r.resultName != NULL )
+		{
+			fprintf( f, ", %s: %.4f", Bench_JSONString( r.resultName ).c_str(), r.resultValue );
+		}
+		if( r.failure.Length() )
+		{
+			fprintf( f, ", \"failed\": %s", Bench_JSONString( r.failure ).c_str() );
+		}
+		fprintf( f, " }%s\n", ( i < results.Num() - 1 ) ? "," : "" );
+	}
+	fprintf( f, "\t]\n" );
+	fprintf( f, "}\n" );
+	
+	fclose( f );
+	return true;
+}
+
+/*
+================
+Bench_Usage
+================
+*/
+static void Bench_Usage()
+{
+	printf( "usage: idlib_bench [options]\n" );
+	printf( "  -json <file>      write the results as JSON\n" );
+	printf( "  -filter <text>    only run the benchmarks with the text in their name\n" );
+	printf( "  -samples <n>      maximum number of samples per benchmark (default 30)\n" );
+	printf( "  -time <ms>        maximum sampling time per benchmark (default 2000)\n" );
+	printf( "  -decls <dir>      tokenize the decl files below the directory instead of the built-in text\n" );
+	printf( "  -generic          use the generic SIMD processor\n" );
+	printf( "  -list             list the benchmarks and exit\n" );
+}
+
+/*
+================
+main
+================
+*/
+int main( int argc, char** argv )
+{
+	const char* jsonFile = NULL;
+	const char* filter = NULL;
+	const char* declDirectory = NULL;
+	int maxSamples = 30;
+	int maxMilliseconds = 2000;
+	bool forceGeneric = false;
+	bool listOnly = false;
+	
+	for( int i = 1; i < argc; i++ )
+	{
+		const bool hasValue = ( i + 1 < argc );
+		if( idStr::Icmp( argv[i], "-json" ) == 0 && hasValue )
+		{
+			jsonFile = argv[++i];
+		}
+		else if( idStr::Icmp( argv[i], "-filter" ) == 0 && hasValue )
+		{
+			filter = argv[++i];
+		}
+		else if( idStr::Icmp( argv[i], "-samples" ) == 0 && hasValue )
+		{
+			maxSamples = atoi( argv[++i] );
+		}
+		else if( idStr::Icmp( argv[i], "-time" ) == 0 && hasValue )
+		{
+			maxMilliseconds = atoi( argv[++i] );
+		}
+		else if( idStr::Icmp( argv[i], "-decls" ) == 0 && hasValue )
+		{
+			declDirectory = argv[++i];
+		}
+		else if( idStr::Icmp( argv[i], "-generic" ) == 0 )
+		{
+			forceGeneric = true;
+		}
+		else if( idStr::Icmp( argv[i], "-list" ) == 0 )
+		{
+			listOnly = true;
+		}
+		else
+		{
+			Bench_Usage();
+			return 1;
+		}
+	}
+	
+	Bench_InitSystem();
+	idSIMD::InitProcessor( "idlib_bench", forceGeneric );
+	
+	idList<idBenchmark*> benchmarks;
+	for( idBenchmark* b = idBenchmark::list; b != NULL; b = b->next )
+	{
+		if( filter == NULL || idStr::FindText( va( "%s.%s", b->group, b->name ), filter, false ) != -1 )
+		{
+			benchmarks.Append( b );
+		}
+	}
+	benchmarks.SortWithTemplate( idSort_Benchmark() );
+	
+	if( listOnly )
+	{
+		for( int i = 0; i < benchmarks.Num(); i++ )
+		{
+			printf( "%s.%s\n", benchmarks[i]->group, benchmarks[i]->name );
+		}
+		return 0;
+	}
+	
+	const char* declSource = "built-in";
+	if( declDirectory != NULL )
+	{
+		Bench_ListFiles( declDirectory, BENCH_DECL_EXTENSIONS, bench_declFiles );
+		bench_declFiles.SortWithTemplate( idSort_PathStr() );
+		if( bench_declFiles.Num() == 0 )
+		{
+			common->Warning( "no decl files found below '%s', using the built-in text", declDirectory );
+		}
+		else
+		{
+			declSource = declDirectory;
+		}
+	}
+	
+	printf( "idlib_bench, %s, %d decl files\n", SIMDProcessor->GetName(), bench_declFiles.Num() );
+	// the allocation count needs the MEMORY_TRACKING build, leave the column out without it
+#if defined( ID_MEMORY_TRACKING )
+	printf( "%-40s %8s %12s %12s %12s %10s %10s\n", "benchmark", "samples", "min us", "median us", "mean us", "MB/s", "allocs" );
+#else
+	printf( "%-40s %8s %12s %12s %12s %10s\n", "benchmark", "samples", "min us", "median us", "mean us", "MB/s" );
+#endif
+	
+	idList<benchResult_t> results;
+	int numFailed = 0;
+	for( int i = 0; i < benchmarks.Num(); i++ )
+	{
+		idBenchTimer timer( maxSamples, maxMilliseconds * 1000 );
+		benchmarks[i]->function( timer );
+		
+		benchResult_t& result = results.Alloc();
+		result.name = va( "%s.%s", benchmarks[i]->group, benchmarks[i]->name );
+		Bench_Stats( timer, result );
+		
+		printf( "%-40s %8d %12.1f %12.1f %12.1f", result.name.c_str(), result.numSamples, result.minTime, result.medianTime, result.meanTime );
+		if( result.bytes > 0 )
+		{
+			printf( " %10.1f", Bench_Throughput( result ) );
+		}
+		else
+		{
+			printf( " %10s", "-" );
+		}
+#if defined( ID_MEMORY_TRACKING )
+		printf( " %10.1f", result.allocsPerRun );
+#endif
+		if( result.resultName != NULL )
+		{
+			printf( "  %s %.3f", result.resultName, result.resultValue );
+		}
+		if( result.failure.Length() )
+		{
+			printf( "  FAILED: %s", result.failure.c_str() );
+			numFailed++;
+		}
+		printf( "\n" );
+	}
+	
+	if( jsonFile != NULL )
+	{
+		if( !Bench_WriteJSON( jsonFile, results, declSource ) )
+		{
+			common->Warning( "couldn't write '%s'", jsonFile );
+			return 1;
+		}
+		printf( "wrote %s\n", jsonFile );
+	}
+	
+	if( numFailed > 0 )
+	{
+		printf( "%d of %d benchmarks failed\n", numFailed, results.Num() );
+		return 1;
+	}
+	return 0;
+}
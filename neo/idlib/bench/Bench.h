@@ -0,0 +1,178 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/*
+================================================================================================
+
+	idlib_bench
+
+	Headless micro-benchmarks for idLib and the engine code that only depends on idLib (the DXT
+	encoders and the idCompressor variants). Benchmarks register themselves with the BENCHMARK
+	macro and time their kernel inside a "while( timer.Next() )" loop:
+
+	BENCHMARK( MinMax, "simd" )
+	{
+		// setup
+		while( timer.Next() )
+		{
+			// kernel
+		}
+		timer.SetBytes( numBytes );		// optional, bytes processed per run for the throughput
+	}
+
+	A benchmark that checks its output calls timer.SetFailed() when it is wrong, idlib_bench then
+	exits with 1 after all benchmarks ran.
+
+================================================================================================
+*/
+
+/*
+================================================
+idBenchTimer
+
+Collects the samples of a single benchmark. Every Next() call ends the sample that was started
+by the previous call, the first call starts the warm-up run which is not recorded.
+================================================
+*/
+class idBenchTimer
+{
+public:
+	idBenchTimer( int maxSamples, int maxMicroseconds );
+	
+	bool				Next();
+	
+	// bytes processed by a single run of the kernel
+	void				SetBytes( int64 numBytes )
+	{
+		bytes = numBytes;
+	}
+	// extra result value written out with the benchmark, e.g. a compression ratio
+	void				SetResult( const char* name, double value )
+	{
+		resultName = name;
+		resultValue = value;
+	}
+	// fails the benchmark, e.g. when a decoder doesn't give back its input
+	void				SetFailed( const char* reason )
+	{
+		failure = reason;
+	}
+	
+	int					NumSamples() const
+	{
+		return samples.Num();
+	}
+	uint64				GetSample( int index ) const
+	{
+		return samples[index];
+	}
+	int64				GetBytes() const
+	{
+		return bytes;
+	}
+	const char* 		GetResultName() const
+	{
+		return resultName;
+	}
+	// memory allocations made by a single run of the kernel, -1 without ID_MEMORY_TRACKING
+	double				GetAllocsPerRun() const
+	{
+		return allocsPerRun;
+	}
+	double				GetResultValue() const
+	{
+		return resultValue;
+	}
+	// NULL if the benchmark didn't fail
+	const char* 		GetFailure() const
+	{
+		return failure.Length() ? failure.c_str() : NULL;
+	}
+	
+private:
+	idList<uint64>		samples;
+	int					maxSamples;
+	uint64				maxMicroseconds;
+	uint64				startTime;
+	uint64				sampleTime;
+	int					numCalls;
+	int64				bytes;
+	const char* 		resultName;
+	double				resultValue;
+	idStr				failure;
+	int					startAllocs;
+	double				allocsPerRun;
+};
+
+typedef void ( *benchFunction_t )( idBenchTimer& timer );
+
+/*
+================================================
+idBenchmark
+
+Statically linked list of all benchmarks, created by the BENCHMARK macro.
+================================================
+*/
+class idBenchmark
+{
+public:
+	idBenchmark( const char* name, const char* group, benchFunction_t function );
+	
+	const char* 		name;
+	const char* 		group;
+	benchFunction_t		function;
+	idBenchmark* 		next;
+	
+	static idBenchmark* list;
+};
+
+#define BENCHMARK( name, group )																\
+	static void Bench_##name( idBenchTimer& timer );											\
+	static idBenchmark Bench_##name##_link( #name, group, Bench_##name );						\
+	static void Bench_##name( idBenchTimer& timer )
+
+// loose decl files that are tokenized by the lexer benchmarks, set with -decls on the command line
+extern idStrList	bench_declFiles;
+
+// headless replacements for the system layer
+void		Bench_InitSystem();
+void		Bench_StartJobThreads();
+void		Bench_ListFiles( const char* directory, const char* extensions, idStrList& list );
+bool		Bench_LoadFile( const char* fileName, idStr& text );
+
+// keeps the optimizer from throwing away the scalar result of a kernel
+template< typename _type_ >
+ID_INLINE void Bench_Use( const _type_& value )
+{
+	volatile _type_ sink = value;
+	( void )sink;
+}
+
+#endif // !__BENCH_H__
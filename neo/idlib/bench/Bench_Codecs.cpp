@@ -0,0 +1,483 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+#include "../../framework/Compressor.h"
+#include "../../renderer/DXT/DXTCodec.h"
+
+/*
+================================================================================================
+
+	DXT encoders
+
+================================================================================================
+*/
+
+static const int BENCH_IMAGE_SIZE		= 512;
+static const int BENCH_IMAGE_SIZE_HQ	= 32;		// the high quality color encoders take seconds for a 128x128 image
+static const int BENCH_IMAGE_SIZE_TILED	= 2048;	// a typical top mip level
+
+/*
+================
+Bench_Image
+
+Smooth gradients with some noise on top, roughly like a photo sourced texture.
+================
+*/
+static void Bench_Image( byte* rgba, int size )
+{
+	idRandom random( 8 );
+	for( int y = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			byte* p = rgba + ( y * size + x ) * 4;
+			const float fx = ( float )x / size;
+			const float fy = ( float )y / size;
+			p[0] = idMath::Ftob( 255.0f * ( 0.5f + 0.5f * idMath::Sin( fx * 9.0f ) * idMath::Cos( fy * 5.0f ) ) + random.CRandomFloat() * 12.0f );
+			p[1] = idMath::Ftob( 255.0f * fy * 0.8f + random.CRandomFloat() * 12.0f );
+			p[2] = idMath::Ftob( 255.0f * ( 1.0f - fx ) * 0.6f + random.CRandomFloat() * 12.0f );
+			p[3] = idMath::Ftob( 255.0f * ( 0.5f + 0.5f * idMath::Sin( ( fx + fy ) * 13.0f ) ) );
+		}
+	}
+}
+
+/*
+================
+Bench_NormalMap
+================
+*/
+static void Bench_NormalMap( byte* rgba, int size )
+{
+	for( int y = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			idVec3 n( idMath::Sin( x * 0.11f ) * 0.5f, idMath::Cos( y * 0.07f ) * 0.5f, 1.0f );
+			n.Normalize();
+			byte* p = rgba + ( y * size + x ) * 4;
+			p[0] = idMath::Ftob( ( n.x * 0.5f + 0.5f ) * 255.0f );
+			p[1] = idMath::Ftob( ( n.y * 0.5f + 0.5f ) * 255.0f );
+			p[2] = idMath::Ftob( ( n.z * 0.5f + 0.5f ) * 255.0f );
+			p[3] = 255;
+		}
+	}
+}
+
+static const int BENCH_DXT_GUARD_BYTES	= 16;
+static const byte BENCH_DXT_GUARD		= 0xCD;
+
+/*
+================
+Bench_DXTEncode
+
+Encodes into a buffer with guard bytes behind the exact size of the blocks, returns false
+if the encoder wrote past the blocks.
+================
+*/
+static bool Bench_DXTEncode( idDxtEncoder::compressFunction_t encode, const byte* image, int size, int blockBytes, idList<byte>& compressed )
+{
+	const int numBytes = ( size / 4 ) * ( size / 4 ) * blockBytes;
+	compressed.SetNum( numBytes + BENCH_DXT_GUARD_BYTES );
+	memset( compressed.Ptr(), BENCH_DXT_GUARD, compressed.Num() );
+	
+	idDxtEncoder encoder;
+	( encoder.*encode )( image, compressed.Ptr(), size, size );
+	
+	for( int i = numBytes; i < compressed.Num(); i++ )
+	{
+		if( compressed[i] != BENCH_DXT_GUARD )
+		{
+			return false;
+		}
+	}
+	compressed.SetNum( numBytes );
+	return true;
+}
+
+/*
+================
+Bench_DXT
+
+With a reference encoder the output has to match the reference byte for byte, and neither
+encoder may write past the blocks.
+================
+*/
+static void Bench_DXT( idBenchTimer& timer, idDxtEncoder::compressFunction_t encode, int size, int blockBytes, bool normalMap, idDxtEncoder::compressFunction_t reference = NULL )
+{
+	idTempArray< byte > image( size * size * 4 );
+	idTempArray< byte > compressed( ( size / 4 ) * ( size / 4 ) * blockBytes );
+	if( normalMap )
+	{
+		Bench_NormalMap( image.Ptr(), size );
+	}
+	else
+	{
+		Bench_Image( image.Ptr(), size );
+	}
+	
+	idDxtEncoder encoder;
+	while( timer.Next() )
+	{
+		( encoder.*encode )( image.Ptr(), compressed.Ptr(), size, size );
+	}
+	Bench_Use( compressed[0] );
+	timer.SetBytes( size * size * 4 );
+	
+	if( reference != NULL )
+	{
+		idList<byte> encoded, expected;
+		if( !Bench_DXTEncode( encode, image.Ptr(), size, blockBytes, encoded ) )
+		{
+			timer.SetFailed( "wrote past the output" );
+		}
+		else if( !Bench_DXTEncode( reference, image.Ptr(), size, blockBytes, expected ) )
+		{
+			timer.SetFailed( "reference wrote past the output" );
+		}
+		else if( memcmp( encoded.Ptr(), expected.Ptr(), encoded.Num() ) != 0 )
+		{
+			timer.SetFailed( "output differs from the reference" );
+		}
+	}
+}
+
+/*
+================
+Bench_DXTTiled
+
+The whole image in bands on all cores, as idBinaryImage compresses the mip levels. The
+bands have to give the same blocks as encoding the whole image at once.
+================
+*/
+static void Bench_DXTTiled( idBenchTimer& timer, idDxtEncoder::compressFunction_t encode, int size, int blockBytes )
+{
+	idTempArray< byte > image( size * size * 4 );
+	idTempArray< byte > compressed( ( size / 4 ) * ( size / 4 ) * blockBytes );
+	Bench_Image( image.Ptr(), size );
+	
+	Bench_StartJobThreads();
+	
+	idDxtEncoder encoder;
+	while( timer.Next() )
+	{
+		encoder.CompressImageTiled( encode, image.Ptr(), compressed.Ptr(), size, size, blockBytes );
+	}
+	Bench_Use( compressed[0] );
+	timer.SetBytes( size * size * 4 );
+	
+	idList<byte> expected;
+	if( !Bench_DXTEncode( encode, image.Ptr(), size, blockBytes, expected ) )
+	{
+		timer.SetFailed( "reference wrote past the output" );
+	}
+	else if( memcmp( compressed.Ptr(), expected.Ptr(), expected.Num() ) != 0 )
+	{
+		timer.SetFailed( "output differs from the whole image" );
+	}
+}
+
+BENCHMARK( DXT1Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT1Fast, BENCH_IMAGE_SIZE, 8, false );
+}
+
+BENCHMARK( DXT5Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT5Fast, BENCH_IMAGE_SIZE, 16, false );
+}
+
+BENCHMARK( YCoCgDXT5Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressYCoCgDXT5Fast, BENCH_IMAGE_SIZE, 16, false );
+}
+
+BENCHMARK( NormalMapDXT5Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressNormalMapDXT5Fast, BENCH_IMAGE_SIZE, 16, true );
+}
+
+BENCHMARK( DXT1Fast_SSE2, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT1Fast_SSE2, BENCH_IMAGE_SIZE, 8, false, &idDxtEncoder::CompressImageDXT1Fast_Generic );
+}
+
+BENCHMARK( DXT5Fast_SSE2, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT5Fast_SSE2, BENCH_IMAGE_SIZE, 16, false, &idDxtEncoder::CompressImageDXT5Fast_Generic );
+}
+
+BENCHMARK( YCoCgDXT5Fast_SSE2, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressYCoCgDXT5Fast_SSE2, BENCH_IMAGE_SIZE, 16, false, &idDxtEncoder::CompressYCoCgDXT5Fast_Generic );
+}
+
+BENCHMARK( DXT1Fast_Tiled, "dxt" )
+{
+	Bench_DXTTiled( timer, &idDxtEncoder::CompressImageDXT1Fast, BENCH_IMAGE_SIZE_TILED, 8 );
+}
+
+BENCHMARK( DXT5Fast_Tiled, "dxt" )
+{
+	Bench_DXTTiled( timer, &idDxtEncoder::CompressImageDXT5Fast, BENCH_IMAGE_SIZE_TILED, 16 );
+}
+
+BENCHMARK( YCoCgDXT5Fast_Tiled, "dxt" )
+{
+	Bench_DXTTiled( timer, &idDxtEncoder::CompressYCoCgDXT5Fast, BENCH_IMAGE_SIZE_TILED, 16 );
+}
+
+BENCHMARK( DXT1HQ, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT1HQ, BENCH_IMAGE_SIZE_HQ, 8, false );
+}
+
+BENCHMARK( DXT5HQ, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXT5HQ, BENCH_IMAGE_SIZE_HQ, 16, false );
+}
+
+BENCHMARK( NormalMapDXT5HQ, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressNormalMapDXT5HQ, BENCH_IMAGE_SIZE_HQ, 16, true );
+}
+
+BENCHMARK( DXN1Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXN1Fast, BENCH_IMAGE_SIZE, 8, false );
+}
+
+BENCHMARK( DXN2Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressNormalMapDXN2Fast, BENCH_IMAGE_SIZE, 16, true );
+}
+
+BENCHMARK( DXN1Fast_SSE2, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageDXN1Fast_SSE2, BENCH_IMAGE_SIZE, 8, false, &idDxtEncoder::CompressImageDXN1Fast_Generic );
+}
+
+BENCHMARK( DXN2Fast_SSE2, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressNormalMapDXN2Fast_SSE2, BENCH_IMAGE_SIZE, 16, true, &idDxtEncoder::CompressNormalMapDXN2Fast_Generic );
+}
+
+BENCHMARK( BC7Fast_Generic, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageBC7Fast_Generic, BENCH_IMAGE_SIZE, 16, false );
+}
+
+BENCHMARK( BC7Fast, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageBC7Fast, BENCH_IMAGE_SIZE, 16, false );
+}
+
+BENCHMARK( BC7HQ, "dxt" )
+{
+	Bench_DXT( timer, &idDxtEncoder::CompressImageBC7HQ, BENCH_IMAGE_SIZE_HQ, 16, false );
+}
+
+/*
+================================================================================================
+
+	idCompressor
+
+================================================================================================
+*/
+
+static const int BENCH_COMPRESSOR_BYTES = 256 * 1024;
+
+typedef idCompressor* ( *compressorAlloc_t )();
+typedef void ( *compressorInput_t )( idList<byte>& data );
+
+/*
+================
+Bench_CompressorText
+
+Save game like data: text, small integers and floats.
+================
+*/
+static void Bench_CompressorText( idList<byte>& data )
+{
+	static const char* words[] = { "origin", "angles", "health", "target", "model", "name", "spawnflags", "classname" };
+	
+	idRandom random( 9 );
+	data.SetNum( BENCH_COMPRESSOR_BYTES );
+	int n = 0;
+	while( n < BENCH_COMPRESSOR_BYTES )
+	{
+		const char* text;
+		switch( random.RandomInt( 3 ) )
+		{
+			case 0:
+				text = words[random.RandomInt( 8 )];
+				break;
+			case 1:
+				text = va( "%d", random.RandomInt( 256 ) );
+				break;
+			default:
+				text = va( "%1.2f", random.CRandomFloat() * 1000.0f );
+				break;
+		}
+		for( const char* s = text; *s != '\0' && n < BENCH_COMPRESSOR_BYTES; s++ )
+		{
+			data[n++] = *s;
+		}
+		if( n < BENCH_COMPRESSOR_BYTES )
+		{
+			data[n++] = 0;
+		}
+	}
+}
+
+/*
+================
+Bench_CompressorRuns
+
+Delta snapshot like data for the run length compressors: mostly unchanged (zero) fields,
+some repeated bytes and a few random ones. Text barely has any runs and just expands.
+================
+*/
+static void Bench_CompressorRuns( idList<byte>& data )
+{
+	idRandom random( 10 );
+	data.SetNum( BENCH_COMPRESSOR_BYTES );
+	int n = 0;
+	while( n < BENCH_COMPRESSOR_BYTES )
+	{
+		// the low bits of idRandom repeat after a few calls, so only the high ones are used
+		const float kind = random.RandomFloat();
+		const int end = Min( n + 1 + ( random.RandomInt() >> 10 ), BENCH_COMPRESSOR_BYTES );
+		const byte value = ( byte )Max( random.RandomInt() >> 7, 1 );
+		for( ; n < end; n++ )
+		{
+			if( kind < 0.6f )
+			{
+				data[n] = 0;
+			}
+			else if( kind < 0.85f )
+			{
+				data[n] = value;
+			}
+			else
+			{
+				data[n] = ( byte )( random.RandomInt() >> 7 );
+			}
+		}
+	}
+}
+
+/*
+================
+Bench_Compress
+================
+*/
+static void Bench_Compress( idBenchTimer& timer, compressorAlloc_t alloc, compressorInput_t input )
+{
+	idList<byte> data;
+	input( data );
+	
+	idCompressor* compressor = alloc();
+	float ratio = 0.0f;
+	while( timer.Next() )
+	{
+		idFile_Memory file( "bench" );
+		file.PreAllocate( BENCH_COMPRESSOR_BYTES * 2 );
+		compressor->Init( &file, true, 8 );
+		compressor->Write( data.Ptr(), data.Num() );
+		compressor->FinishCompress();
+		ratio = ( data.Num() - file.Length() ) * 100.0f / data.Num();
+	}
+	delete compressor;
+	
+	timer.SetBytes( data.Num() );
+	timer.SetResult( "ratio", ratio );
+}
+
+/*
+================
+Bench_Decompress
+
+Every compressor has to give back the exact input, a decoder that doesn't fails the run.
+================
+*/
+static void Bench_Decompress( idBenchTimer& timer, compressorAlloc_t alloc, compressorInput_t input )
+{
+	idList<byte> data;
+	input( data );
+	
+	idCompressor* compressor = alloc();
+	idFile_Memory compressed( "bench" );
+	compressor->Init( &compressed, true, 8 );
+	compressor->Write( data.Ptr(), data.Num() );
+	compressor->FinishCompress();
+	
+	idList<byte> decompressed;
+	decompressed.SetNum( data.Num() );
+	int numRead = 0;
+	while( timer.Next() )
+	{
+		idFile_Memory file( "bench", ( const char* )compressed.GetDataPtr(), compressed.Length() );
+		compressor->Init( &file, false, 8 );
+		numRead = compressor->Read( decompressed.Ptr(), decompressed.Num() );
+	}
+	delete compressor;
+	
+	timer.SetBytes( data.Num() );
+	if( numRead != data.Num() )
+	{
+		timer.SetFailed( va( "read %d of %d bytes", numRead, data.Num() ) );
+	}
+	else if( memcmp( data.Ptr(), decompressed.Ptr(), data.Num() ) != 0 )
+	{
+		timer.SetFailed( "decompressed data differs" );
+	}
+}
+
+// BitStream is the uncompressed base of the bit packing compressors, its ratio is always 0
+#define BENCH_COMPRESSOR( name, input )												\
+	BENCHMARK( name##_Compress, "compressor" )										\
+	{																				\
+		Bench_Compress( timer, idCompressor::Alloc##name, input );					\
+	}																				\
+	BENCHMARK( name##_Decompress, "compressor" )									\
+	{																				\
+		Bench_Decompress( timer, idCompressor::Alloc##name, input );				\
+	}
+
+BENCH_COMPRESSOR( NoCompression, Bench_CompressorText )
+BENCH_COMPRESSOR( BitStream, Bench_CompressorText )
+BENCH_COMPRESSOR( RunLength, Bench_CompressorRuns )
+BENCH_COMPRESSOR( RunLength_ZeroBased, Bench_CompressorRuns )
+BENCH_COMPRESSOR( Huffman, Bench_CompressorText )
+BENCH_COMPRESSOR( Arithmetic, Bench_CompressorText )
+BENCH_COMPRESSOR( LZSS, Bench_CompressorText )
+BENCH_COMPRESSOR( LZSS_WordAligned, Bench_CompressorText )
+BENCH_COMPRESSOR( LZW, Bench_CompressorText )
@@ -0,0 +1,398 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+
+/*
+================================================================================================
+
+	Containers
+
+================================================================================================
+*/
+
+static const int BENCH_NUM_ELEMENTS	= 64 * 1024;
+static const int BENCH_NUM_KEYS		= 256;
+
+/*
+================
+Bench_Keys
+
+Spawn arg like key names.
+================
+*/
+static void Bench_Keys( idStrList& keys, int numKeys )
+{
+	static const char* prefixes[] = { "model", "origin", "target", "snd_", "def_", "shaderParm", "light_", "editor_" };
+	keys.SetNum( numKeys );
+	for( int i = 0; i < numKeys; i++ )
+	{
+		keys[i] = va( "%s%d", prefixes[i % 8], i );
+	}
+}
+
+/*
+================
+ListAppend
+================
+*/
+BENCHMARK( ListAppend, "containers" )
+{
+	idList<int> list;
+	while( timer.Next() )
+	{
+		list.Clear();
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			list.Append( i );
+		}
+	}
+	Bench_Use( list.Num() );
+	timer.SetBytes( BENCH_NUM_ELEMENTS * sizeof( int ) );
+}
+
+/*
+================
+ListRemoveIndexFast
+================
+*/
+BENCHMARK( ListRemoveIndexFast, "containers" )
+{
+	idList<int> list;
+	list.SetNum( BENCH_NUM_ELEMENTS );
+	idRandom random( 5 );
+	while( timer.Next() )
+	{
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			list[i] = i;
+		}
+		while( list.Num() > 0 )
+		{
+			list.RemoveIndexFast( random.RandomInt( list.Num() ) );
+		}
+		list.SetNum( BENCH_NUM_ELEMENTS );
+	}
+	Bench_Use( list.Num() );
+}
+
+/*
+================
+ListSort
+================
+*/
+BENCHMARK( ListSort, "containers" )
+{
+	idList<int> source;
+	source.SetNum( BENCH_NUM_ELEMENTS );
+	idRandom random( 6 );
+	for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+	{
+		source[i] = random.RandomInt();
+	}
+	
+	idList<int> list;
+	while( timer.Next() )
+	{
+		list = source;
+		list.SortWithTemplate( idSort_QuickDefault<int>() );
+	}
+	Bench_Use( list[0] );
+	timer.SetBytes( BENCH_NUM_ELEMENTS * sizeof( int ) );
+}
+
+/*
+================
+StrListAppend
+
+Strings that don't fit the base buffer, every resize of the list moves them.
+================
+*/
+BENCHMARK( StrListAppend, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_KEYS );
+	for( int i = 0; i < BENCH_NUM_KEYS; i++ )
+	{
+		keys[i] += "_with_a_long_suffix";
+	}
+	
+	idStrList list;
+	while( timer.Next() )
+	{
+		list.Clear();
+		for( int i = 0; i < BENCH_NUM_ELEMENTS / 16; i++ )
+		{
+			list.Append( keys[i % BENCH_NUM_KEYS] );
+		}
+	}
+	Bench_Use( list.Num() );
+}
+
+/*
+================
+StrListInsertRemove
+================
+*/
+BENCHMARK( StrListInsertRemove, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_KEYS );
+	for( int i = 0; i < BENCH_NUM_KEYS; i++ )
+	{
+		keys[i] += "_with_a_long_suffix";
+	}
+	
+	idStrList list;
+	list.Resize( BENCH_NUM_KEYS * 2 );
+	idRandom random( 7 );
+	while( timer.Next() )
+	{
+		for( int i = 0; i < BENCH_NUM_KEYS; i++ )
+		{
+			list.Insert( keys[i], random.RandomInt( list.Num() + 1 ) );
+		}
+		while( list.Num() > 0 )
+		{
+			list.RemoveIndex( random.RandomInt( list.Num() ) );
+		}
+	}
+	Bench_Use( list.Num() );
+}
+
+/*
+================
+StrListSort
+================
+*/
+BENCHMARK( StrListSort, "containers" )
+{
+	idStrList source;
+	Bench_Keys( source, BENCH_NUM_ELEMENTS / 16 );
+	idRandom random( 8 );
+	for( int i = source.Num() - 1; i > 0; i-- )
+	{
+		SwapValues( source[i], source[random.RandomInt( i + 1 )] );
+	}
+	
+	idStrList list;
+	while( timer.Next() )
+	{
+		list = source;
+		list.SortWithTemplate( idSort_Str() );
+	}
+	Bench_Use( list[0].Length() );
+}
+
+/*
+================
+HashIndexAddFind
+================
+*/
+BENCHMARK( HashIndexAddFind, "containers" )
+{
+	idList<int> keys;
+	keys.SetNum( BENCH_NUM_ELEMENTS );
+	for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+	{
+		keys[i] = i * 7919;
+	}
+	
+	idHashIndex hash( BENCH_NUM_ELEMENTS, BENCH_NUM_ELEMENTS );
+	int found = 0;
+	while( timer.Next() )
+	{
+		hash.Clear();
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			hash.Add( hash.GenerateKey( keys[i] ), i );
+		}
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			for( int j = hash.First( hash.GenerateKey( keys[i] ) ); j != -1; j = hash.Next( j ) )
+			{
+				if( keys[j] == keys[i] )
+				{
+					found++;
+					break;
+				}
+			}
+		}
+	}
+	Bench_Use( found );
+}
+
+/*
+================
+HashMapSetFind
+================
+*/
+BENCHMARK( HashMapSetFind, "containers" )
+{
+	idHashMap<int, int> map;
+	int found = 0;
+	while( timer.Next() )
+	{
+		map.Clear();
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			map.Set( i * 7919, i );
+		}
+		for( int i = 0; i < BENCH_NUM_ELEMENTS; i++ )
+		{
+			found += ( map.Find( i * 7919 ) != NULL );
+		}
+	}
+	Bench_Use( found );
+}
+
+/*
+================
+HashMapFindString
+================
+*/
+BENCHMARK( HashMapFindString, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_ELEMENTS );
+	
+	idHashMap<const char*, int, idHashMapTraitsNoCase> map;
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		map.Set( keys[i].c_str(), i );
+	}
+	
+	int found = 0;
+	while( timer.Next() )
+	{
+		for( int i = 0; i < keys.Num(); i++ )
+		{
+			found += ( map.Find( keys[i].c_str() ) != NULL );
+		}
+	}
+	Bench_Use( found );
+}
+
+/*
+================
+DictSetGet
+================
+*/
+BENCHMARK( DictSetGet, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_KEYS );
+	
+	int found = 0;
+	while( timer.Next() )
+	{
+		for( int n = 0; n < 16; n++ )
+		{
+			idDict dict;
+			for( int i = 0; i < keys.Num(); i++ )
+			{
+				dict.Set( keys[i], "value" );
+			}
+			for( int i = 0; i < keys.Num(); i++ )
+			{
+				found += ( dict.GetString( keys[i] )[0] != '\0' );
+			}
+		}
+	}
+	Bench_Use( found );
+}
+
+/*
+================
+DictGet
+================
+*/
+BENCHMARK( DictGet, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_KEYS );
+	
+	idDict dict;
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		dict.SetInt( keys[i], i );
+	}
+	
+	int sum = 0;
+	while( timer.Next() )
+	{
+		for( int n = 0; n < 64; n++ )
+		{
+			for( int i = 0; i < keys.Num(); i++ )
+			{
+				sum += dict.GetInt( keys[i] );
+			}
+		}
+	}
+	Bench_Use( sum );
+}
+
+/*
+================
+DictGetSymbol
+================
+*/
+BENCHMARK( DictGetSymbol, "containers" )
+{
+	idStrList keys;
+	Bench_Keys( keys, BENCH_NUM_KEYS );
+	
+	idDict dict;
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		dict.SetInt( keys[i], i );
+	}
+	
+	idList<idDictSymbol*> symbols;
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		symbols.Append( new idDictSymbol( keys[i] ) );
+	}
+	
+	int sum = 0;
+	while( timer.Next() )
+	{
+		for( int n = 0; n < 64; n++ )
+		{
+			for( int i = 0; i < symbols.Num(); i++ )
+			{
+				sum += dict.GetInt( *symbols[i] );
+			}
+		}
+	}
+	Bench_Use( sum );
+	
+	symbols.DeleteContents();
+}
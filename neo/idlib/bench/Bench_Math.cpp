@@ -0,0 +1,229 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+#include "../math/Simd_Generic.h"
+
+/*
+================================================================================================
+
+	idSIMD kernels
+
+	The animation kernels run over a batch of skeletons so a single run is long enough to time
+	and the working set is closer to what a frame with many animated models touches.
+
+================================================================================================
+*/
+
+static const int BENCH_NUM_VERTS		= 256 * 1024;
+static const int BENCH_NUM_JOINTS		= 128;
+static const int BENCH_NUM_SKELETONS	= 256;
+
+/*
+================
+Bench_RandomVerts
+================
+*/
+static void Bench_RandomVerts( idVec3* verts, int numVerts )
+{
+	idRandom random( 1 );
+	for( int i = 0; i < numVerts; i++ )
+	{
+		verts[i].Set( random.CRandomFloat() * 1000.0f, random.CRandomFloat() * 1000.0f, random.CRandomFloat() * 1000.0f );
+	}
+}
+
+/*
+================
+Bench_RandomSkeleton
+
+Every joint is parented to one of the eight joints before it, which gives both long chains
+and siblings.
+================
+*/
+static void Bench_RandomSkeleton( int* parents, idJointQuat* quats, int numJoints, idRandom& random )
+{
+	for( int i = 0; i < numJoints; i++ )
+	{
+		parents[i] = ( i == 0 ) ? -1 : Max( 0, i - 1 - random.RandomInt( 8 ) );
+		
+		idAngles angles( random.CRandomFloat() * 180.0f, random.CRandomFloat() * 180.0f, random.CRandomFloat() * 180.0f );
+		quats[i].q = angles.ToQuat();
+		quats[i].t.Set( random.CRandomFloat() * 10.0f, random.CRandomFloat() * 10.0f, random.CRandomFloat() * 10.0f );
+		quats[i].w = 0.0f;
+	}
+}
+
+/*
+================
+MinMax
+================
+*/
+BENCHMARK( MinMax, "simd" )
+{
+	idTempArray< idVec3 > verts( BENCH_NUM_VERTS );
+	Bench_RandomVerts( verts.Ptr(), BENCH_NUM_VERTS );
+	
+	idVec3 min, max;
+	while( timer.Next() )
+	{
+		SIMDProcessor->MinMax( min, max, verts.Ptr(), BENCH_NUM_VERTS );
+	}
+	Bench_Use( min.x + max.x );
+	timer.SetBytes( BENCH_NUM_VERTS * sizeof( idVec3 ) );
+}
+
+/*
+================
+MinMaxDrawVerts
+================
+*/
+BENCHMARK( MinMaxDrawVerts, "simd" )
+{
+	const int numVerts = BENCH_NUM_VERTS / 4;
+	idTempArray< idVec3 > xyz( numVerts );
+	Bench_RandomVerts( xyz.Ptr(), numVerts );
+	
+	idTempArray< idDrawVert > verts( numVerts );
+	verts.Zero();
+	for( int i = 0; i < numVerts; i++ )
+	{
+		verts[i].xyz = xyz[i];
+	}
+	
+	idVec3 min, max;
+	while( timer.Next() )
+	{
+		SIMDProcessor->MinMax( min, max, verts.Ptr(), numVerts );
+	}
+	Bench_Use( min.x + max.x );
+	timer.SetBytes( numVerts * sizeof( idDrawVert ) );
+}
+
+/*
+================
+BlendJoints
+================
+*/
+BENCHMARK( BlendJoints, "simd" )
+{
+	const int numJoints = BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS;
+	idTempArray< int > parents( numJoints );
+	idTempArray< idJointQuat > joints( numJoints );
+	idTempArray< idJointQuat > blendJoints( numJoints );
+	idTempArray< int > index( numJoints );
+	
+	idRandom random( 2 );
+	Bench_RandomSkeleton( parents.Ptr(), joints.Ptr(), numJoints, random );
+	Bench_RandomSkeleton( parents.Ptr(), blendJoints.Ptr(), numJoints, random );
+	for( int i = 0; i < numJoints; i++ )
+	{
+		index[i] = i;
+	}
+	
+	while( timer.Next() )
+	{
+		SIMDProcessor->BlendJoints( joints.Ptr(), blendJoints.Ptr(), 0.37f, index.Ptr(), numJoints );
+	}
+	Bench_Use( joints[0].q.x );
+	timer.SetBytes( numJoints * sizeof( idJointQuat ) * 2 );
+}
+
+/*
+================
+ConvertJointQuatsToJointMats
+================
+*/
+BENCHMARK( ConvertJointQuatsToJointMats, "simd" )
+{
+	const int numJoints = BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS;
+	idTempArray< int > parents( numJoints );
+	idTempArray< idJointQuat > quats( numJoints );
+	idTempArray< idJointMat > mats( numJoints );
+	
+	idRandom random( 3 );
+	Bench_RandomSkeleton( parents.Ptr(), quats.Ptr(), numJoints, random );
+	
+	while( timer.Next() )
+	{
+		SIMDProcessor->ConvertJointQuatsToJointMats( mats.Ptr(), quats.Ptr(), numJoints );
+	}
+	Bench_Use( mats[0].ToFloatPtr()[0] );
+	timer.SetBytes( numJoints * sizeof( idJointQuat ) );
+}
+
+/*
+================
+TransformJoints
+
+The result is the largest difference to the generic code.
+================
+*/
+BENCHMARK( TransformJoints, "simd" )
+{
+	idTempArray< int > parents( BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS );
+	idTempArray< idJointQuat > quats( BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS );
+	idTempArray< idJointMat > mats( BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS );
+	
+	idRandom random( 4 );
+	for( int i = 0; i < BENCH_NUM_SKELETONS; i++ )
+	{
+		Bench_RandomSkeleton( parents.Ptr() + i * BENCH_NUM_JOINTS, quats.Ptr() + i * BENCH_NUM_JOINTS, BENCH_NUM_JOINTS, random );
+	}
+	SIMDProcessor->ConvertJointQuatsToJointMats( mats.Ptr(), quats.Ptr(), BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS );
+	
+	// the joints are transformed in place, but the rotations stay orthonormal so repeating it is fine
+	while( timer.Next() )
+	{
+		for( int i = 0; i < BENCH_NUM_SKELETONS; i++ )
+		{
+			SIMDProcessor->TransformJoints( mats.Ptr() + i * BENCH_NUM_JOINTS, parents.Ptr() + i * BENCH_NUM_JOINTS, 1, BENCH_NUM_JOINTS - 1 );
+		}
+	}
+	Bench_Use( mats[0].ToFloatPtr()[0] );
+	timer.SetBytes( BENCH_NUM_JOINTS * BENCH_NUM_SKELETONS * sizeof( idJointMat ) );
+	
+	idTempArray< idJointMat > genericMats( BENCH_NUM_JOINTS );
+	idSIMD_Generic generic;
+	generic.ConvertJointQuatsToJointMats( genericMats.Ptr(), quats.Ptr(), BENCH_NUM_JOINTS );
+	generic.TransformJoints( genericMats.Ptr(), parents.Ptr(), 1, BENCH_NUM_JOINTS - 1 );
+	generic.ConvertJointQuatsToJointMats( mats.Ptr(), quats.Ptr(), BENCH_NUM_JOINTS );
+	SIMDProcessor->TransformJoints( mats.Ptr(), parents.Ptr(), 1, BENCH_NUM_JOINTS - 1 );
+	
+	float maxError = 0.0f;
+	for( int i = 0; i < BENCH_NUM_JOINTS; i++ )
+	{
+		for( int j = 0; j < JOINTMAT_TYPESIZE; j++ )
+		{
+			maxError = Max( maxError, idMath::Fabs( mats[i].ToFloatPtr()[j] - genericMats[i].ToFloatPtr()[j] ) );
+		}
+	}
+	timer.SetResult( "maxerror", maxError );
+}
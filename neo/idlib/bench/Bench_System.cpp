@@ -0,0 +1,628 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+
+#if defined( _WIN32 )
+#include <io.h>
+#include <intrin.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/*
+================================================================================================
+
+	Headless system layer
+
+	idlib_bench links idLib and a handful of engine files without the framework, so this file
+	provides the few globals and system functions they need: a console that prints to stdout,
+	processor detection for idSIMD and the timers.
+
+================================================================================================
+*/
+
+idCVar* 		idCVar::staticVars = NULL;
+idCVarSystem* 	cvarSystem = NULL;
+idCmdSystem* 	cmdSystem = NULL;
+idFileSystem* 	fileSystem = NULL;
+
+/*
+================================================
+idCommonBench
+================================================
+*/
+class idCommonBench : public idCommon
+{
+public:
+	virtual void				Init( int argc, const char* const* argv, const char* cmdline ) {}
+	virtual void				Shutdown() {}
+	virtual bool				IsShuttingDown() const
+	{
+		return false;
+	}
+	virtual	void				CreateMainMenu() {}
+	virtual void				Quit()
+	{
+		exit( 0 );
+	}
+	virtual bool				IsInitialized() const
+	{
+		return true;
+	}
+	virtual void				Frame() {}
+	virtual void				UpdateScreen( bool captureToImage, bool releaseMouse = true ) {}
+	virtual void				UpdateLevelLoadPacifier() {}
+	virtual void				StartupVariable( const char* match ) {}
+	virtual void				BeginRedirect( char* buffer, int buffersize, void ( *flush )( const char* ) ) {}
+	virtual void				EndRedirect() {}
+	virtual void				SetRefreshOnPrint( bool set ) {}
+	
+	virtual void				Printf( VERIFY_FORMAT_STRING const char* fmt, ... )
+	{
+		va_list argptr;
+		va_start( argptr, fmt );
+		VPrintf( fmt, argptr );
+		va_end( argptr );
+	}
+	virtual void				VPrintf( const char* fmt, va_list arg )
+	{
+		vprintf( fmt, arg );
+		fflush( stdout );
+	}
+	virtual void				DPrintf( VERIFY_FORMAT_STRING const char* fmt, ... ) {}
+	virtual void				Warning( VERIFY_FORMAT_STRING const char* fmt, ... )
+	{
+		va_list argptr;
+		va_start( argptr, fmt );
+		fprintf( stderr, "WARNING: " );
+		vfprintf( stderr, fmt, argptr );
+		fprintf( stderr, "\n" );
+		va_end( argptr );
+	}
+	virtual void				DWarning( VERIFY_FORMAT_STRING const char* fmt, ... ) {}
+	virtual void				PrintWarnings() {}
+	virtual void				ClearWarnings( const char* reason ) {}
+	virtual void				Error( VERIFY_FORMAT_STRING const char* fmt, ... )
+	{
+		va_list argptr;
+		va_start( argptr, fmt );
+		fprintf( stderr, "ERROR: " );
+		vfprintf( stderr, fmt, argptr );
+		fprintf( stderr, "\n" );
+		va_end( argptr );
+		exit( 1 );
+	}
+	virtual void                FatalError( VERIFY_FORMAT_STRING const char* fmt, ... )
+	{
+		va_list argptr;
+		va_start( argptr, fmt );
+		fprintf( stderr, "FATAL ERROR: " );
+		vfprintf( stderr, fmt, argptr );
+		fprintf( stderr, "\n" );
+		va_end( argptr );
+		exit( 1 );
+	}
+	
+	virtual const char* 		KeysFromBinding( const char* bind )
+	{
+		return "";
+	}
+	virtual const char* 		BindingFromKey( const char* key )
+	{
+		return "";
+	}
+	virtual int					ButtonState( int key )
+	{
+		return 0;
+	}
+	virtual int					KeyState( int key )
+	{
+		return 0;
+	}
+	
+	virtual bool				IsMultiplayer()
+	{
+		return false;
+	}
+	virtual bool				IsServer()
+	{
+		return false;
+	}
+	virtual bool				IsClient()
+	{
+		return false;
+	}
+	virtual bool				GetConsoleUsed()
+	{
+		return false;
+	}
+	virtual int					GetSnapRate()
+	{
+		return 0;
+	}
+	virtual void				NetReceiveReliable( int peer, int type, idBitMsg& msg ) {}
+	virtual void				NetReceiveSnapshot( class idSnapShot& ss ) {}
+	virtual void				NetReceiveUsercmds( int peer, idBitMsg& msg ) {}
+	virtual	bool				ProcessEvent( const sysEvent_t* event )
+	{
+		return false;
+	}
+	virtual bool				LoadGame( const char* saveName )
+	{
+		return false;
+	}
+	virtual bool				SaveGame( const char* saveName )
+	{
+		return false;
+	}
+	virtual idDemoFile* 		ReadDemo()
+	{
+		return NULL;
+	}
+	virtual idDemoFile* 		WriteDemo()
+	{
+		return NULL;
+	}
+	virtual idGame* 			Game()
+	{
+		return NULL;
+	}
+	virtual idRenderWorld* 		RW()
+	{
+		return NULL;
+	}
+	virtual idSoundWorld* 		SW()
+	{
+		return NULL;
+	}
+	virtual idSoundWorld* 		MenuSW()
+	{
+		return NULL;
+	}
+	virtual idSession* 			Session()
+	{
+		return NULL;
+	}
+	virtual idCommonDialog& 	Dialog()
+	{
+		FatalError( "idCommonBench::Dialog: there are no dialogs in a headless build" );
+		return *dialog;
+	}
+	virtual void				OnSaveCompleted( idSaveLoadParms& parms ) {}
+	virtual void				OnLoadCompleted( idSaveLoadParms& parms ) {}
+	virtual void				OnLoadFilesCompleted( idSaveLoadParms& parms ) {}
+	virtual void				OnEnumerationCompleted( idSaveLoadParms& parms ) {}
+	virtual void				OnDeleteCompleted( idSaveLoadParms& parms ) {}
+	virtual void				TriggerScreenWipe( const char* _wipeMaterial, bool hold ) {}
+	virtual void				OnStartHosting( idMatchParameters& parms ) {}
+	virtual int					GetGameFrame()
+	{
+		return 0;
+	}
+	virtual void				InitializeMPMapsModes() {}
+	virtual const idStrList& 			GetModeList() const
+	{
+		return modeList;
+	}
+	virtual const idStrList& 			GetModeDisplayList() const
+	{
+		return modeList;
+	}
+	virtual const idList<mpMap_t>& 		GetMapList() const
+	{
+		return mapList;
+	}
+	virtual void				ResetPlayerInput( int playerIndex ) {}
+	virtual bool				JapaneseCensorship() const
+	{
+		return false;
+	}
+	virtual void				QueueShowShell() {}
+	virtual currentGame_t		GetCurrentGame() const
+	{
+		return DOOM3_BFG;
+	}
+	virtual void				SwitchToGame( currentGame_t newGame ) {}
+	
+private:
+	idCommonDialog* 			dialog;
+	idStrList					modeList;
+	idList<mpMap_t>				mapList;
+};
+
+idCommonBench	commonBench;
+idCommon* 		common = &commonBench;
+
+/*
+================
+Bench_GetProcessorId
+================
+*/
+static cpuid_t Bench_GetProcessorId()
+{
+	int flags = CPUID_GENERIC;
+#if defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	// the compiler runtime also checks that the OS saves the AVX registers
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "mmx" ) )
+	{
+		flags |= CPUID_MMX;
+	}
+	if( __builtin_cpu_supports( "sse" ) )
+	{
+		flags |= CPUID_SSE | CPUID_FTZ;
+	}
+	if( __builtin_cpu_supports( "sse2" ) )
+	{
+		flags |= CPUID_SSE2;
+	}
+	if( __builtin_cpu_supports( "sse3" ) )
+	{
+		flags |= CPUID_SSE3;
+	}
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		flags |= CPUID_AVX2;
+	}
+	if( __builtin_cpu_supports( "fma" ) )
+	{
+		flags |= CPUID_FMA3;
+	}
+#elif defined( _M_IX86 ) || defined( _M_X64 )
+	int regs[4];
+	__cpuid( regs, 1 );
+	if( regs[3] & ( 1 << 23 ) )
+	{
+		flags |= CPUID_MMX;
+	}
+	if( regs[3] & ( 1 << 25 ) )
+	{
+		flags |= CPUID_SSE | CPUID_FTZ;
+	}
+	if( regs[3] & ( 1 << 26 ) )
+	{
+		flags |= CPUID_SSE2;
+	}
+	if( regs[2] & ( 1 << 0 ) )
+	{
+		flags |= CPUID_SSE3;
+	}
+#endif
+	return ( cpuid_t )flags;
+}
+
+/*
+================================================
+idSysBench
+================================================
+*/
+class idSysBench : public idSys
+{
+public:
+	virtual void			DebugPrintf( VERIFY_FORMAT_STRING const char* fmt, ... ) {}
+	virtual void			DebugVPrintf( const char* fmt, va_list arg ) {}
+	
+	virtual double			GetClockTicks()
+	{
+		return ( double )Sys_Microseconds();
+	}
+	virtual double			ClockTicksPerSecond()
+	{
+		return 1000000.0;
+	}
+	virtual cpuid_t			GetProcessorId()
+	{
+		return Bench_GetProcessorId();
+	}
+	virtual const char* 	GetProcessorString()
+	{
+		return "generic";
+	}
+	virtual const char* 	FPU_GetState()
+	{
+		return "";
+	}
+	virtual bool			FPU_StackIsEmpty()
+	{
+		return true;
+	}
+	virtual void			FPU_SetFTZ( bool enable ) {}
+	virtual void			FPU_SetDAZ( bool enable ) {}
+	virtual void			FPU_EnableExceptions( int exceptions ) {}
+	
+	virtual bool			LockMemory( void* ptr, int bytes )
+	{
+		return false;
+	}
+	virtual bool			UnlockMemory( void* ptr, int bytes )
+	{
+		return false;
+	}
+	
+	virtual int				DLL_Load( const char* dllName )
+	{
+		return 0;
+	}
+	virtual void* 			DLL_GetProcAddress( int dllHandle, const char* procName )
+	{
+		return NULL;
+	}
+	virtual void			DLL_Unload( int dllHandle ) {}
+	virtual void			DLL_GetFileName( const char* baseName, char* dllName, int maxLength ) {}
+	
+	virtual sysEvent_t		GenerateMouseButtonEvent( int button, bool down )
+	{
+		sysEvent_t ev;
+		memset( &ev, 0, sizeof( ev ) );
+		return ev;
+	}
+	virtual sysEvent_t		GenerateMouseMoveEvent( int deltax, int deltay )
+	{
+		sysEvent_t ev;
+		memset( &ev, 0, sizeof( ev ) );
+		return ev;
+	}
+	
+	virtual void			OpenURL( const char* url, bool quit ) {}
+	virtual void			StartProcess( const char* exePath, bool quit ) {}
+};
+
+idSysBench		sysBench;
+idSys* 			sys = &sysBench;
+
+/*
+================
+Sys_Microseconds
+================
+*/
+uint64 Sys_Microseconds()
+{
+#if defined( _WIN32 )
+	static LARGE_INTEGER frequency;
+	if( frequency.QuadPart == 0 )
+	{
+		QueryPerformanceFrequency( &frequency );
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter( &counter );
+	return ( uint64 )( ( double )counter.QuadPart * 1000000.0 / ( double )frequency.QuadPart );
+#else
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64 )ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+/*
+================
+Sys_Milliseconds
+================
+*/
+int Sys_Milliseconds()
+{
+	return ( int )( Sys_Microseconds() / 1000 );
+}
+
+/*
+================
+Sys_CPUCount
+
+Only the logical core count matters for the number of job threads.
+================
+*/
+void Sys_CPUCount( int& numLogicalCPUCores, int& numPhysicalCPUCores, int& numCPUPackages )
+{
+#if defined( _WIN32 )
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	numLogicalCPUCores = info.dwNumberOfProcessors;
+#else
+	numLogicalCPUCores = Max( 1, ( int )sysconf( _SC_NPROCESSORS_ONLN ) );
+#endif
+	numPhysicalCPUCores = numLogicalCPUCores;
+	numCPUPackages = 1;
+}
+
+/*
+================
+Sys_FileTimeStamp
+================
+*/
+ID_TIME_T Sys_FileTimeStamp( idFileHandle fp )
+{
+#if defined( _WIN32 )
+	return 0;
+#else
+	struct stat st;
+	fstat( fileno( fp ), &st );
+	return st.st_mtime;
+#endif
+}
+
+/*
+================
+Bench_InitSystem
+================
+*/
+void Bench_InitSystem()
+{
+	idLib::common = common;
+	idLib::sys = sys;
+	idLib::cvarSystem = cvarSystem;
+	idLib::fileSystem = fileSystem;
+	
+	idLib::Init();
+}
+
+/*
+================
+Bench_StopJobThreads
+================
+*/
+static void Bench_StopJobThreads()
+{
+	parallelJobManager->Shutdown();
+}
+
+/*
+================
+Bench_StartJobThreads
+
+The job threads are only started by the benchmarks that use them.
+================
+*/
+void Bench_StartJobThreads()
+{
+	static bool started = false;
+	if( !started )
+	{
+		started = true;
+		parallelJobManager->Init();
+		atexit( Bench_StopJobThreads );
+	}
+}
+
+/*
+================
+Bench_HasExtension
+
+Extensions is a space separated list like "mtr def skin".
+================
+*/
+static bool Bench_HasExtension( const char* path, const char* extensions )
+{
+	idStr extension;
+	idStr( path ).ExtractFileExtension( extension );
+	if( extension.IsEmpty() )
+	{
+		return false;
+	}
+	return idStr::FindText( va( " %s ", extensions ), va( " %s ", extension.c_str() ), false ) != -1;
+}
+
+/*
+================
+Bench_ListFiles
+
+Recursively adds all files below the directory that have one of the given extensions.
+================
+*/
+void Bench_ListFiles( const char* directory, const char* extensions, idStrList& list )
+{
+	idStrList subDirectories;
+	
+#if defined( _WIN32 )
+	struct _finddata_t findInfo;
+	idStr search = directory;
+	search.AppendPath( "*" );
+	intptr_t findHandle = _findfirst( search.c_str(), &findInfo );
+	if( findHandle == -1 )
+	{
+		return;
+	}
+	do
+	{
+		idStr path = directory;
+		path.AppendPath( findInfo.name );
+		if( ( findInfo.attrib & _A_SUBDIR ) != 0 )
+		{
+			if( findInfo.name[0] != '.' )
+			{
+				subDirectories.Append( path );
+			}
+		}
+		else if( Bench_HasExtension( path, extensions ) )
+		{
+			list.Append( path );
+		}
+	}
+	while( _findnext( findHandle, &findInfo ) != -1 );
+	_findclose( findHandle );
+#else
+	DIR* dir = opendir( directory );
+	if( dir == NULL )
+	{
+		return;
+	}
+	struct dirent* entry;
+	while( ( entry = readdir( dir ) ) != NULL )
+	{
+		idStr path = directory;
+		path.AppendPath( entry->d_name );
+		struct stat st;
+		if( stat( path.c_str(), &st ) == -1 )
+		{
+			continue;
+		}
+		if( S_ISDIR( st.st_mode ) )
+		{
+			if( entry->d_name[0] != '.' )
+			{
+				subDirectories.Append( path );
+			}
+		}
+		else if( Bench_HasExtension( path, extensions ) )
+		{
+			list.Append( path );
+		}
+	}
+	closedir( dir );
+#endif
+	
+	for( int i = 0; i < subDirectories.Num(); i++ )
+	{
+		Bench_ListFiles( subDirectories[i], extensions, list );
+	}
+}
+
+/*
+================
+Bench_LoadFile
+================
+*/
+bool Bench_LoadFile( const char* fileName, idStr& text )
+{
+	FILE* f = fopen( fileName, "rb" );
+	if( f == NULL )
+	{
+		return false;
+	}
+	fseek( f, 0, SEEK_END );
+	const int length = ftell( f );
+	fseek( f, 0, SEEK_SET );
+	text.Fill( ' ', length );
+	const bool ok = ( fread( ( char* )text.c_str(), 1, length, f ) == ( size_t )length );
+	fclose( f );
+	return ok;
+}
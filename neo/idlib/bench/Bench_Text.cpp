@@ -0,0 +1,285 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "Bench.h"
+
+/*
+================================================================================================
+
+	idLexer / idParser
+
+	Tokenizes the decl files given with -decls, or built-in text that looks like materials and
+	entity defs when there are none.
+
+================================================================================================
+*/
+
+static const int BENCH_NUM_BUILTIN_DECLS = 2000;
+static const int BENCH_NUM_BUILTIN_FILES = 16;		// spread over a few files like the real decls
+
+/*
+================
+Bench_BuiltinDecls
+================
+*/
+static void Bench_BuiltinDecls( idStrList& texts )
+{
+	idRandom random( 7 );
+	texts.SetNum( BENCH_NUM_BUILTIN_FILES );
+	for( int i = 0; i < BENCH_NUM_BUILTIN_DECLS; i++ )
+	{
+		idStr& text = texts[i % BENCH_NUM_BUILTIN_FILES];
+		if( i & 1 )
+		{
+			text += va( "textures/bench/surface%d\n{\n", i );
+			text += "\tqer_editorimage textures/bench/surface_ed.tga\n";
+			text += va( "\tsurftype%d\n", random.RandomInt( 8 ) );
+			text += va( "\tdiffusemap textures/bench/surface%d_d.tga\n", i );
+			text += va( "\tbumpmap addnormals( textures/bench/surface%d_local.tga, heightmap( textures/bench/surface%d_h.tga, %d ) )\n", i, i, 1 + random.RandomInt( 8 ) );
+			text += va( "\tspecularmap textures/bench/surface%d_s.tga\n", i );
+			text += "\t{\n\t\tblend add\n\t\tmap textures/bench/glow.tga\n";
+			text += va( "\t\trgb %1.3f * sintable[ time * %1.2f ]\n", random.RandomFloat(), random.RandomFloat() * 4.0f );
+			text += "\t}\n}\n\n";
+		}
+		else
+		{
+			text += va( "entityDef bench_entity%d\n{\n", i );
+			text += "\t\"inherit\"\t\t\t\"monster_default\"\n";
+			text += va( "\t\"model\"\t\t\t\t\"models/md5/bench/entity%d.md5mesh\"\n", i );
+			text += va( "\t\"health\"\t\t\t\"%d\"\n", 50 + random.RandomInt( 200 ) );
+			text += va( "\t\"size\"\t\t\t\t\"%d %d %d\"\n", 16 + random.RandomInt( 32 ), 16 + random.RandomInt( 32 ), 48 + random.RandomInt( 48 ) );
+			text += va( "\t\"mass\"\t\t\t\t\"%1.1f\"\n", random.RandomFloat() * 500.0f );
+			text += va( "\t\"snd_sight\"\t\t\t\"bench_sight%d\"\n", i );
+			text += va( "\t\"def_projectile\"\t\"projectile_bench%d\"\n", i % 16 );
+			text += "\t\"editor_usage\"\t\t\"Generated entity def for the lexer benchmark.\"\n";
+			text += "}\n\n";
+		}
+	}
+}
+
+/*
+================
+Bench_DeclTexts
+================
+*/
+static const idStrList& Bench_DeclTexts()
+{
+	static idStrList texts;
+	if( texts.Num() == 0 )
+	{
+		for( int i = 0; i < bench_declFiles.Num(); i++ )
+		{
+			idStr text;
+			if( Bench_LoadFile( bench_declFiles[i], text ) )
+			{
+				texts.Append( text );
+			}
+		}
+		if( texts.Num() == 0 )
+		{
+			Bench_BuiltinDecls( texts );
+		}
+	}
+	return texts;
+}
+
+/*
+================
+Bench_TextBytes
+================
+*/
+static int64 Bench_TextBytes( const idStrList& texts )
+{
+	int64 bytes = 0;
+	for( int i = 0; i < texts.Num(); i++ )
+	{
+		bytes += texts[i].Length();
+	}
+	return bytes;
+}
+
+/*
+================
+LexerDecls
+================
+*/
+BENCHMARK( LexerDecls, "text" )
+{
+	const idStrList& texts = Bench_DeclTexts();
+	
+	int numTokens = 0;
+	while( timer.Next() )
+	{
+		for( int i = 0; i < texts.Num(); i++ )
+		{
+			idLexer lexer( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+			lexer.LoadMemory( texts[i], texts[i].Length(), "bench" );
+			idToken token;
+			while( lexer.ReadToken( &token ) )
+			{
+				numTokens++;
+			}
+		}
+	}
+	Bench_Use( numTokens );
+	timer.SetBytes( Bench_TextBytes( texts ) );
+}
+
+/*
+================
+LexerDeclsRef
+================
+*/
+BENCHMARK( LexerDeclsRef, "text" )
+{
+	const idStrList& texts = Bench_DeclTexts();
+	
+	int numTokens = 0;
+	while( timer.Next() )
+	{
+		for( int i = 0; i < texts.Num(); i++ )
+		{
+			idLexer lexer( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+			lexer.LoadMemory( texts[i], texts[i].Length(), "bench" );
+			idTokenRef token;
+			while( lexer.ReadTokenRef( &token ) )
+			{
+				numTokens++;
+			}
+		}
+	}
+	Bench_Use( numTokens );
+	timer.SetBytes( Bench_TextBytes( texts ) );
+}
+
+/*
+================
+Bench_CountTokens
+================
+*/
+static void Bench_CountTokens( idLexer& lexer, void* data )
+{
+	int numTokens = 0;
+	idTokenRef token;
+	while( lexer.ReadTokenRef( &token ) )
+	{
+		numTokens++;
+	}
+	*( int* )data = numTokens;
+}
+
+/*
+================
+LexerBatchDecls
+
+Lexes every file in its own job, uses all cores.
+================
+*/
+BENCHMARK( LexerBatchDecls, "text" )
+{
+	const idStrList& texts = Bench_DeclTexts();
+	
+	Bench_StartJobThreads();
+	
+	idList<int> numTokens;
+	numTokens.SetNum( texts.Num() );
+	
+	idLexerBatch batch;
+	for( int i = 0; i < texts.Num(); i++ )
+	{
+		batch.AddMemory( texts[i], texts[i].Length(), "bench", &numTokens[i] );
+	}
+	while( timer.Next() )
+	{
+		batch.Run( Bench_CountTokens, DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS, JOBLIST_PARALLELISM_MAX_CORES );
+	}
+	Bench_Use( numTokens[0] );
+	timer.SetBytes( Bench_TextBytes( texts ) );
+}
+
+/*
+================
+ParserDecls
+================
+*/
+BENCHMARK( ParserDecls, "text" )
+{
+	const idStrList& texts = Bench_DeclTexts();
+	
+	int numTokens = 0;
+	while( timer.Next() )
+	{
+		for( int i = 0; i < texts.Num(); i++ )
+		{
+			idParser parser( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+			parser.LoadMemory( texts[i], texts[i].Length(), "bench" );
+			idToken token;
+			while( parser.ReadToken( &token ) )
+			{
+				numTokens++;
+			}
+		}
+	}
+	Bench_Use( numTokens );
+	timer.SetBytes( Bench_TextBytes( texts ) );
+}
+
+/*
+================
+LexerSkipBracedSection
+
+The decl manager skips over the bodies of all decls when it first scans the files.
+================
+*/
+BENCHMARK( LexerSkipBracedSection, "text" )
+{
+	const idStrList& texts = Bench_DeclTexts();
+	
+	int numDecls = 0;
+	while( timer.Next() )
+	{
+		for( int i = 0; i < texts.Num(); i++ )
+		{
+			idLexer lexer( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+			lexer.LoadMemory( texts[i], texts[i].Length(), "bench" );
+			idToken token;
+			while( lexer.ReadToken( &token ) )
+			{
+				if( token == "{" )
+				{
+					lexer.SkipBracedSection( false );
+					numDecls++;
+				}
+			}
+		}
+	}
+	Bench_Use( numDecls );
+	timer.SetBytes( Bench_TextBytes( texts ) );
+}
@@ -0,0 +1,229 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "precompiled.h"
+
+typedef idHashMap< const char*, int, idHashMapTraitsNoCase > idTestStrMap;
+
+/*
+================
+HashMapTestPrint
+================
+*/
+static void HashMapTestPrint( const char* test, const uint64 hashIndexTime, const uint64 hashMapTime )
+{
+	idLib::common->Printf( "%-24s idHashIndex %6d us   idHashMap %6d us\n", test, ( int )hashIndexTime, ( int )hashMapTime );
+}
+
+/*
+================
+idHashMapBase::Test_f
+
+Compares idHashMap against idHashIndex with integer and string keys.
+================
+*/
+void idHashMapBase::Test_f( const idCmdArgs& args )
+{
+	int count = 1 << 16;
+	if( args.Argc() > 1 )
+	{
+		count = Max( atoi( args.Argv( 1 ) ), 16 );
+	}
+	
+	idRandom random( 0x1234 );
+	idList<int> intKeys;
+	idList<idStr> strKeys;
+	idList<int> order;
+	intKeys.SetNum( count );
+	strKeys.SetNum( count * 2 );
+	order.SetNum( count );
+	for( int i = 0; i < count; i++ )
+	{
+		intKeys[i] = ( int )( i * 2654435761u );	// unique and scattered
+		order[i] = i;
+	}
+	for( int i = 0; i < count * 2; i++ )
+	{
+		// decl style names, the second half is used for misses
+		sprintf( strKeys[i], "textures/test/name_%d_%d", i, random.RandomInt( 1000 ) );
+	}
+	for( int i = count - 1; i > 0; i-- )
+	{
+		SwapValues( order[i], order[random.RandomInt( i + 1 )] );
+	}
+	
+	idLib::common->Printf( "%d keys\n", count );
+	
+	int found = 0;
+	uint64 start, hashIndexTime, hashMapTime;
+	
+	// integer keys
+	{
+		idHashIndex hashIndex( idMath::CeilPowerOfTwo( count ), count );
+		idHashMap< int, int > hashMap( count );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			hashIndex.Add( hashIndex.GenerateKey( intKeys[i] ), i );
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			hashMap.Set( intKeys[i], i );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "int insert", hashIndexTime, hashMapTime );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			const int key = intKeys[order[i]];
+			for( int j = hashIndex.First( hashIndex.GenerateKey( key ) ); j != -1; j = hashIndex.Next( j ) )
+			{
+				if( intKeys[j] == key )
+				{
+					found++;
+					break;
+				}
+			}
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			found += ( hashMap.Find( intKeys[order[i]] ) != NULL );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "int find", hashIndexTime, hashMapTime );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			const int key = intKeys[order[i]] + 1;
+			for( int j = hashIndex.First( hashIndex.GenerateKey( key ) ); j != -1; j = hashIndex.Next( j ) )
+			{
+				if( intKeys[j] == key )
+				{
+					found++;
+					break;
+				}
+			}
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			found += ( hashMap.Find( intKeys[order[i]] + 1 ) != NULL );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "int miss", hashIndexTime, hashMapTime );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i += 2 )
+		{
+			hashIndex.Remove( hashIndex.GenerateKey( intKeys[order[i]] ), order[i] );
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i += 2 )
+		{
+			hashMap.Remove( intKeys[order[i]] );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "int remove", hashIndexTime, hashMapTime );
+		
+		for( int i = 0; i < count; i++ )
+		{
+			if( ( hashMap.Find( intKeys[order[i]] ) != NULL ) != ( ( i & 1 ) != 0 ) )
+			{
+				idLib::common->Printf( "idHashMap int key %d is wrong\n", order[i] );
+				break;
+			}
+		}
+		
+		idLib::common->Printf( "%-24s idHashIndex %6d KB   idHashMap %6d KB   max probe %d\n", "int memory",
+							   ( int )( ( hashIndex.Allocated() + intKeys.Allocated() ) >> 10 ), ( int )( hashMap.Allocated() >> 10 ), hashMap.GetMaxProbe() );
+	}
+	
+	// case insensitive string keys like the decl manager uses
+	{
+		idHashIndex hashIndex( idMath::CeilPowerOfTwo( count ), count );
+		idTestStrMap hashMap( count );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			hashIndex.Add( hashIndex.GenerateKey( strKeys[i], false ), i );
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count; i++ )
+		{
+			hashMap.Set( strKeys[i].c_str(), i );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "string insert", hashIndexTime, hashMapTime );
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < count * 2; i++ )
+		{
+			const char* key = strKeys[( i < count ) ? order[i] : i];
+			for( int j = hashIndex.First( hashIndex.GenerateKey( key, false ) ); j != -1; j = hashIndex.Next( j ) )
+			{
+				if( strKeys[j].Icmp( key ) == 0 )
+				{
+					found++;
+					break;
+				}
+			}
+		}
+		hashIndexTime = Sys_Microseconds() - start;
+		start = Sys_Microseconds();
+		for( int i = 0; i < count * 2; i++ )
+		{
+			found += ( hashMap.Find( strKeys[( i < count ) ? order[i] : i].c_str() ) != NULL );
+		}
+		hashMapTime = Sys_Microseconds() - start;
+		HashMapTestPrint( "string find and miss", hashIndexTime, hashMapTime );
+		
+		for( int i = 0; i < count * 2; i++ )
+		{
+			const int* index = hashMap.Find( strKeys[i].c_str() );
+			if( ( index != NULL ) != ( i < count ) || ( index != NULL && *index != i ) )
+			{
+				idLib::common->Printf( "idHashMap string key %d is wrong\n", i );
+				break;
+			}
+		}
+	}
+	
+	idLib::common->Printf( "%d keys found\n", found );
+}
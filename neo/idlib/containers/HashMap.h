@@ -0,0 +1,814 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __HASHMAP_H__
+#define __HASHMAP_H__
+
+/*
+===============================================================================
+
+	Open addressing hash map.
+
+	The keys and values are stored in a dense list of entries, the table itself
+	only stores the full hash and the entry index of every slot, so a lookup only
+	touches the control bytes, one slot and the matching entry. Collisions are
+	resolved with Robin Hood linear probing and the control bytes of 16 slots are
+	compared at once with SSE2. Removing a key shifts the following slots back so
+	the table never contains tombstones.
+
+	The entries can be iterated with Num() and GetIndex(). Removing a key moves the
+	last entry into the hole unless stable ordering is enabled, in which case the
+	entries stay in insertion order and removal becomes linear in the table size.
+
+	Does not allocate memory until the first key is added.
+
+===============================================================================
+*/
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+================================================
+idHashMapBase holds everything that doesn't depend on the key and value types.
+================================================
+*/
+class idHashMapBase
+{
+public:
+	static const int	GROUP_SIZE = 16;
+	static const int	MIN_TABLE_SIZE = GROUP_SIZE;
+	
+	static void			Test_f( const class idCmdArgs& args );
+	
+	// FNV-1a string hashes, idStr::Hash has too many collisions on similar names for open addressing
+	static unsigned int	StringHash( const char* string )
+	{
+		unsigned int hash = 2166136261u;
+		while( *string != '\0' )
+		{
+			hash = ( hash ^ ( byte ) * string++ ) * 16777619u;
+		}
+		return hash;
+	}
+	static unsigned int	StringHashNoCase( const char* string )
+	{
+		unsigned int hash = 2166136261u;
+		while( *string != '\0' )
+		{
+			hash = ( hash ^ ( byte )idStr::ToLower( *string++ ) ) * 16777619u;
+		}
+		return hash;
+	}
+	
+protected:
+	struct slot_t
+	{
+		unsigned int	hash;			// mixed hash of the key
+		int				entry;			// index into the entry list
+	};
+	
+	// spreads the bits of the key hash over the whole word
+	static unsigned int	MixHash( unsigned int hash )
+	{
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6b;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+	
+	// control byte for a hash, zero is reserved for empty slots
+	static byte			HashTag( unsigned int hash )
+	{
+		return ( byte )( ( hash >> 25 ) + 1 );
+	}
+	
+	// returns a bit for every slot of the group with the given control byte
+	static unsigned int	MatchGroup( const byte* control, const byte tag )
+	{
+#if defined(USE_INTRINSICS)
+		__m128i group = _mm_loadu_si128( ( const __m128i* )control );
+		return ( unsigned int )_mm_movemask_epi8( _mm_cmpeq_epi8( group, _mm_set1_epi8( ( char )tag ) ) );
+#else
+		unsigned int mask = 0;
+		for( int i = 0; i < GROUP_SIZE; i++ )
+		{
+			mask |= ( unsigned int )( control[i] == tag ) << i;
+		}
+		return mask;
+#endif
+	}
+	
+	static int			FirstBit( unsigned int mask )
+	{
+		assert( mask != 0 );
+#if defined(_MSC_VER)
+		unsigned long bit;
+		_BitScanForward( &bit, mask );
+		return ( int )bit;
+#elif defined(__GNUC__)
+		return __builtin_ctz( mask );
+#else
+		int bit = 0;
+		while( ( mask & 1 ) == 0 )
+		{
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+#endif
+	}
+};
+
+/*
+================================================
+idHashMapTraits provides the hash and comparison of a key type.
+The default works for integers, enums and pointers compared by address.
+================================================
+*/
+template< typename _key_ >
+class idHashMapTraits
+{
+public:
+	static unsigned int	Hash( const _key_ & key )
+	{
+		return ( unsigned int )( ( uintptr_t )key ^ ( ( uint64 )( uintptr_t )key >> 32 ) );
+	}
+	static bool			Compare( const _key_ & key1, const _key_ & key2 )
+	{
+		return ( key1 == key2 );
+	}
+};
+
+// string keys can be looked up with both idStr and const char*
+template<>
+class idHashMapTraits< idStr >
+{
+public:
+	static unsigned int	Hash( const char* key )
+	{
+		return idHashMapBase::StringHash( key );
+	}
+	static bool			Compare( const char* key1, const char* key2 )
+	{
+		return ( idStr::Cmp( key1, key2 ) == 0 );
+	}
+};
+
+template<>
+class idHashMapTraits< const char* >
+{
+public:
+	static unsigned int	Hash( const char* key )
+	{
+		return idHashMapBase::StringHash( key );
+	}
+	static bool			Compare( const char* key1, const char* key2 )
+	{
+		return ( idStr::Cmp( key1, key2 ) == 0 );
+	}
+};
+
+/*
+================================================
+idHashMapTraitsNoCase hashes and compares idStr or const char* keys case insensitively.
+================================================
+*/
+class idHashMapTraitsNoCase
+{
+public:
+	static unsigned int	Hash( const char* key )
+	{
+		return idHashMapBase::StringHashNoCase( key );
+	}
+	static bool			Compare( const char* key1, const char* key2 )
+	{
+		return ( idStr::Icmp( key1, key2 ) == 0 );
+	}
+};
+
+/*
+================================================
+idHashMap
+================================================
+*/
+template< typename _key_, typename _value_, typename _traits_ = idHashMapTraits< _key_ >, memTag_t _tag_ = TAG_IDLIB_HASH >
+class idHashMap : public idHashMapBase
+{
+public:
+	struct pair_t
+	{
+		_key_			key;
+		_value_			value;
+	};
+	
+	idHashMap( const int initialSize = 0 );
+	~idHashMap();
+	
+	// returns total size of allocated memory
+	size_t			Allocated() const;
+	// returns total size of allocated memory including size of the map type
+	size_t			Size() const;
+	
+	// the traits are copied, this allows traits that have state like a case sensitivity flag, existing keys are hashed again
+	void			SetTraits( const _traits_ & newTraits );
+	const _traits_& GetTraits() const
+	{
+		return traits;
+	}
+	// keep the entries in insertion order when removing keys
+	void			SetStableOrder( const bool stable )
+	{
+		stableOrder = stable;
+	}
+	
+	// the lookups accept any type the traits can hash and compare with the key type,
+	// for instance a const char* for idStr keys
+	
+	// returns the entry index of the key or -1 if the key is not in the map
+	template< typename _lookup_ >
+	int				FindIndex( const _lookup_ & key ) const;
+	// returns a pointer to the value of the key or NULL if the key is not in the map
+	template< typename _lookup_ >
+	_value_* 		Find( const _lookup_ & key );
+	template< typename _lookup_ >
+	const _value_* 	Find( const _lookup_ & key ) const;
+	// copies the value of the key to value if the key is in the map
+	template< typename _lookup_ >
+	bool			Get( const _lookup_ & key, _value_* value = NULL ) const;
+	// adds the key or replaces the value of the key if it is already in the map
+	_value_& 		Set( const _key_ & key, const _value_ & value );
+	// removes the key, returns false if the key was not in the map
+	template< typename _lookup_ >
+	bool			Remove( const _lookup_ & key );
+	
+	// number of entries in the map
+	int				Num() const
+	{
+		return entries.Num();
+	}
+	// entries are numbered [0, Num())
+	const pair_t& 	GetIndex( const int index ) const
+	{
+		return entries[index];
+	}
+	pair_t& 		GetIndex( const int index )
+	{
+		return entries[index];
+	}
+	
+	// make room for the given number of entries without growing the table
+	void			Reserve( const int numEntries );
+	// remove all entries but keep the memory
+	void			Clear();
+	// remove all entries and free all memory
+	void			Free();
+	// calls delete on all values and clears the map
+	void			DeleteContents();
+	
+	// size of the table in slots
+	int				GetTableSize() const
+	{
+		return tableSize;
+	}
+	// longest probe sequence in the table
+	int				GetMaxProbe() const
+	{
+		return maxProbe;
+	}
+	
+private:
+	idList<pair_t, _tag_>	entries;
+	byte* 			control;			// tableSize + GROUP_SIZE control bytes, the last group mirrors the first
+	slot_t* 		slots;
+	int				tableSize;
+	int				tableMask;
+	int				maxProbe;			// distance of the slot furthest from its home slot
+	bool			stableOrder;
+	_traits_		traits;
+	
+	// maps are not copyable
+	idHashMap( const idHashMap& );
+	void			operator=( const idHashMap& );
+	
+	template< typename _lookup_ >
+	int				FindSlot( const _lookup_ & key, const unsigned int hash ) const;
+	int				FindSlotForEntry( const unsigned int hash, const int entry ) const;
+	void			SetControl( const int slot, const byte tag );
+	void			InsertSlot( unsigned int hash, int entry );
+	void			RemoveSlot( int slot );
+	void			Rehash( const int newTableSize );
+	template< typename _lookup_ >
+	unsigned int	KeyHash( const _lookup_ & key ) const
+	{
+		return MixHash( traits.Hash( key ) );
+	}
+	int				ProbeDistance( const int slot ) const
+	{
+		return ( slot - ( int )( slots[slot].hash & tableMask ) ) & tableMask;
+	}
+};
+
+/*
+================
+idHashMap::idHashMap
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE idHashMap<_key_, _value_, _traits_, _tag_>::idHashMap( const int initialSize ) :
+	control( NULL ),
+	slots( NULL ),
+	tableSize( 0 ),
+	tableMask( 0 ),
+	maxProbe( -1 ),
+	stableOrder( false )
+{
+	if( initialSize > 0 )
+	{
+		Reserve( initialSize );
+	}
+}
+
+/*
+================
+idHashMap::~idHashMap
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE idHashMap<_key_, _value_, _traits_, _tag_>::~idHashMap()
+{
+	Free();
+}
+
+/*
+================
+idHashMap::Allocated
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE size_t idHashMap<_key_, _value_, _traits_, _tag_>::Allocated() const
+{
+	size_t size = entries.Allocated();
+	if( tableSize > 0 )
+	{
+		size += ( tableSize + GROUP_SIZE ) * sizeof( control[0] ) + tableSize * sizeof( slots[0] );
+	}
+	return size;
+}
+
+/*
+================
+idHashMap::Size
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE size_t idHashMap<_key_, _value_, _traits_, _tag_>::Size() const
+{
+	return sizeof( *this ) + Allocated();
+}
+
+/*
+================
+idHashMap::SetTraits
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::SetTraits( const _traits_ & newTraits )
+{
+	traits = newTraits;
+	
+	// the existing keys may hash differently now
+	if( entries.Num() > 0 )
+	{
+		memset( control, 0, tableSize + GROUP_SIZE );
+		maxProbe = -1;
+		for( int i = 0; i < entries.Num(); i++ )
+		{
+			InsertSlot( KeyHash( entries[i].key ), i );
+		}
+	}
+}
+
+/*
+================
+idHashMap::FindSlot
+
+Returns the slot of the key or -1 if the key is not in the map.
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE int idHashMap<_key_, _value_, _traits_, _tag_>::FindSlot( const _lookup_ & key, const unsigned int hash ) const
+{
+	if( maxProbe < 0 )
+	{
+		return -1;
+	}
+	
+	const byte tag = HashTag( hash );
+	int slot = hash & tableMask;
+	
+	// most keys are in their home slot
+	if( control[slot] == tag && slots[slot].hash == hash && traits.Compare( entries[slots[slot].entry].key, key ) )
+	{
+		return slot;
+	}
+	
+	// a key is never further from its home slot than maxProbe
+	for( int distance = 0; distance <= maxProbe; distance += GROUP_SIZE )
+	{
+		unsigned int matches = MatchGroup( control + slot, tag );
+		const unsigned int empty = MatchGroup( control + slot, 0 );
+		if( empty != 0 )
+		{
+			// the probe sequence ends at the first empty slot
+			matches &= ( empty & ( 0 - empty ) ) - 1;
+		}
+		const int remaining = maxProbe + 1 - distance;
+		if( remaining < GROUP_SIZE )
+		{
+			matches &= ( 1u << remaining ) - 1;
+		}
+		while( matches != 0 )
+		{
+			const int s = ( slot + FirstBit( matches ) ) & tableMask;
+			if( slots[s].hash == hash && traits.Compare( entries[slots[s].entry].key, key ) )
+			{
+				return s;
+			}
+			matches &= matches - 1;
+		}
+		if( empty != 0 )
+		{
+			break;
+		}
+		slot = ( slot + GROUP_SIZE ) & tableMask;
+	}
+	return -1;
+}
+
+/*
+================
+idHashMap::FindSlotForEntry
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE int idHashMap<_key_, _value_, _traits_, _tag_>::FindSlotForEntry( const unsigned int hash, const int entry ) const
+{
+	int slot = hash & tableMask;
+	for( int distance = 0; distance <= maxProbe; distance++ )
+	{
+		if( slots[slot].entry == entry && control[slot] != 0 )
+		{
+			return slot;
+		}
+		slot = ( slot + 1 ) & tableMask;
+	}
+	assert( false );
+	return -1;
+}
+
+/*
+================
+idHashMap::SetControl
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::SetControl( const int slot, const byte tag )
+{
+	control[slot] = tag;
+	if( slot < GROUP_SIZE )
+	{
+		control[tableSize + slot] = tag;
+	}
+}
+
+/*
+================
+idHashMap::InsertSlot
+
+Robin Hood insertion, a slot is taken over from any key that is closer to its home slot.
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::InsertSlot( unsigned int hash, int entry )
+{
+	int slot = hash & tableMask;
+	for( int distance = 0; ; distance++ )
+	{
+		if( control[slot] == 0 )
+		{
+			SetControl( slot, HashTag( hash ) );
+			slots[slot].hash = hash;
+			slots[slot].entry = entry;
+			maxProbe = Max( maxProbe, distance );
+			return;
+		}
+		const int slotDistance = ProbeDistance( slot );
+		if( slotDistance < distance )
+		{
+			SetControl( slot, HashTag( hash ) );
+			SwapValues( slots[slot].hash, hash );
+			SwapValues( slots[slot].entry, entry );
+			maxProbe = Max( maxProbe, distance );
+			distance = slotDistance;
+		}
+		slot = ( slot + 1 ) & tableMask;
+	}
+}
+
+/*
+================
+idHashMap::RemoveSlot
+
+Shifts the following slots back until a slot is empty or at its home position.
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::RemoveSlot( int slot )
+{
+	int next = ( slot + 1 ) & tableMask;
+	while( control[next] != 0 && ProbeDistance( next ) > 0 )
+	{
+		SetControl( slot, control[next] );
+		slots[slot] = slots[next];
+		slot = next;
+		next = ( next + 1 ) & tableMask;
+	}
+	SetControl( slot, 0 );
+}
+
+/*
+================
+idHashMap::Rehash
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::Rehash( const int newTableSize )
+{
+	assert( idMath::IsPowerOfTwo( newTableSize ) && newTableSize >= MIN_TABLE_SIZE );
+	
+	byte* oldControl = control;
+	slot_t* oldSlots = slots;
+	const int oldTableSize = tableSize;
+	
+	control = ( byte* )Mem_Alloc( newTableSize + GROUP_SIZE, _tag_ );
+	slots = ( slot_t* )Mem_Alloc( newTableSize * sizeof( slot_t ), _tag_ );
+	memset( control, 0, newTableSize + GROUP_SIZE );
+	tableSize = newTableSize;
+	tableMask = newTableSize - 1;
+	maxProbe = -1;
+	
+	// grow the entries along with the table instead of by the list granularity
+	const int maxEntries = newTableSize - newTableSize / 4;
+	if( entries.NumAllocated() < maxEntries )
+	{
+		entries.Resize( maxEntries );
+	}
+	
+	// the hashes are kept in the slots so the keys don't need to be hashed again
+	for( int i = 0; i < oldTableSize; i++ )
+	{
+		if( oldControl[i] != 0 )
+		{
+			InsertSlot( oldSlots[i].hash, oldSlots[i].entry );
+		}
+	}
+	
+	if( oldTableSize > 0 )
+	{
+		Mem_Free( oldControl );
+		Mem_Free( oldSlots );
+	}
+}
+
+/*
+================
+idHashMap::Reserve
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::Reserve( const int numEntries )
+{
+	// keep the load factor at or below 3/4
+	const int minTableSize = Max( numEntries + ( numEntries + 2 ) / 3, ( int )MIN_TABLE_SIZE );
+	if( minTableSize > tableSize )
+	{
+		Rehash( idMath::CeilPowerOfTwo( minTableSize ) );
+	}
+}
+
+/*
+================
+idHashMap::FindIndex
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE int idHashMap<_key_, _value_, _traits_, _tag_>::FindIndex( const _lookup_ & key ) const
+{
+	const int slot = FindSlot( key, KeyHash( key ) );
+	return ( slot >= 0 ) ? slots[slot].entry : -1;
+}
+
+/*
+================
+idHashMap::Find
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE _value_* idHashMap<_key_, _value_, _traits_, _tag_>::Find( const _lookup_ & key )
+{
+	const int index = FindIndex( key );
+	return ( index >= 0 ) ? &entries[index].value : NULL;
+}
+
+/*
+================
+idHashMap::Find
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE const _value_* idHashMap<_key_, _value_, _traits_, _tag_>::Find( const _lookup_ & key ) const
+{
+	const int index = FindIndex( key );
+	return ( index >= 0 ) ? &entries[index].value : NULL;
+}
+
+/*
+================
+idHashMap::Get
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE bool idHashMap<_key_, _value_, _traits_, _tag_>::Get( const _lookup_ & key, _value_* value ) const
+{
+	const int index = FindIndex( key );
+	if( index < 0 )
+	{
+		return false;
+	}
+	if( value != NULL )
+	{
+		*value = entries[index].value;
+	}
+	return true;
+}
+
+/*
+================
+idHashMap::Set
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE _value_& idHashMap<_key_, _value_, _traits_, _tag_>::Set( const _key_ & key, const _value_ & value )
+{
+	const unsigned int hash = KeyHash( key );
+	const int slot = FindSlot( key, hash );
+	if( slot >= 0 )
+	{
+		pair_t& pair = entries[slots[slot].entry];
+		pair.value = value;
+		return pair.value;
+	}
+	
+	// grow when the load factor would go over 3/4
+	if( ( entries.Num() + 1 ) * 4 > tableSize * 3 )
+	{
+		Rehash( Max( tableSize * 2, ( int )MIN_TABLE_SIZE ) );
+	}
+	
+	pair_t& pair = entries.Alloc();
+	pair.key = key;
+	pair.value = value;
+	InsertSlot( hash, entries.Num() - 1 );
+	return pair.value;
+}
+
+/*
+================
+idHashMap::Remove
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+template< typename _lookup_ >
+ID_INLINE bool idHashMap<_key_, _value_, _traits_, _tag_>::Remove( const _lookup_ & key )
+{
+	const int slot = FindSlot( key, KeyHash( key ) );
+	if( slot < 0 )
+	{
+		return false;
+	}
+	const int entry = slots[slot].entry;
+	RemoveSlot( slot );
+	
+	const int last = entries.Num() - 1;
+	if( entry == last )
+	{
+		entries.RemoveIndex( last );
+	}
+	else if( stableOrder )
+	{
+		entries.RemoveIndex( entry );
+		for( int i = 0; i < tableSize; i++ )
+		{
+			if( control[i] != 0 && slots[i].entry > entry )
+			{
+				slots[i].entry--;
+			}
+		}
+	}
+	else
+	{
+		// move the last entry into the hole
+		slots[FindSlotForEntry( KeyHash( entries[last].key ), last )].entry = entry;
+		entries.RemoveIndexFast( entry );
+	}
+	return true;
+}
+
+/*
+================
+idHashMap::Clear
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::Clear()
+{
+	entries.SetNum( 0 );
+	if( tableSize > 0 )
+	{
+		memset( control, 0, tableSize + GROUP_SIZE );
+	}
+	maxProbe = -1;
+}
+
+/*
+================
+idHashMap::Free
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::Free()
+{
+	entries.Clear();
+	if( tableSize > 0 )
+	{
+		Mem_Free( control );
+		Mem_Free( slots );
+	}
+	control = NULL;
+	slots = NULL;
+	tableSize = 0;
+	tableMask = 0;
+	maxProbe = -1;
+}
+
+/*
+================
+idHashMap::DeleteContents
+================
+*/
+template< typename _key_, typename _value_, typename _traits_, memTag_t _tag_ >
+ID_INLINE void idHashMap<_key_, _value_, _traits_, _tag_>::DeleteContents()
+{
+	for( int i = 0; i < entries.Num(); i++ )
+	{
+		delete entries[i].value;
+		entries[i].value = NULL;
+	}
+	Clear();
+}
+
+#endif /* !__HASHMAP_H__ */
@@ -96,7 +96,7 @@ ID_INLINE void* idListArrayResize( void* voldptr, int oldNum, int newNum, bool z
 		int overlap = Min( oldNum, newNum );
 		for( int i = 0; i < overlap; i++ )
 		{
-			newptr[i] = oldptr[i];
+			newptr[i] = std::move( oldptr[i] );
 		}
 	}
 	idListArrayDelete<_type_>( voldptr, oldNum );
@@ -124,6 +124,7 @@ public:
 	
 	idList( int newgranularity = 16 );
 	idList( const idList& other );
+	idList( idList&& other );											// takes over the elements of other
 	~idList();
 	
 	void			Clear();											// clear the list
@@ -137,6 +138,7 @@ public:
 	size_t			MemoryUsed() const;									// returns size of the used elements in the list
 	
 	idList<_type_, _tag_>& 		operator=( const idList<_type_, _tag_>& other );
+	idList<_type_, _tag_>& 		operator=( idList<_type_, _tag_>&& other );	// takes over the elements of other
 	const _type_& 	operator[]( int index ) const;
 	_type_& 		operator[]( int index );
 	
@@ -152,6 +154,7 @@ public:
 	const _type_* 	Ptr() const;										// returns a pointer to the list
 	_type_& 		Alloc();											// returns reference to a new data element at the end of the list
 	int				Append( const _type_ & obj );						// append element
+	int				Append( _type_&& obj );							// append element by moving it into the list
 	int				Append( const idList& other );						// append list
 	int				AddUnique( const _type_ & obj );					// add unique element
 	int				Insert( const _type_ & obj, int index = 0 );		// insert the element at the given index
@@ -236,6 +239,21 @@ ID_INLINE idList<_type_, _tag_>::idList( const idList& other )
 	*this = other;
 }
 
+/*
+================
+idList<_type_,_tag_>::idList( idList< _type_, _tag_ > &&other )
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE idList<_type_, _tag_>::idList( idList&& other )
+{
+	list		= NULL;
+	granularity	= other.granularity;
+	memTag		= other.memTag;
+	Clear();
+	Swap( other );
+}
+
 /*
 ================
 idList<_type_,_tag_>::~idList< _type_, _tag_ >
@@ -448,7 +466,7 @@ ID_INLINE void idList<_type_, _tag_>::Condense()
 idList<_type_,_tag_>::Resize
 
 Allocates memory for the amount of elements requested while keeping the contents intact.
-Contents are copied using their = operator so that data is correnctly instantiated.
+Contents are moved using their = operator so that data is correnctly instantiated.
 ================
 */
 template< typename _type_, memTag_t _tag_ >
@@ -482,7 +500,7 @@ ID_INLINE void idList<_type_, _tag_>::Resize( int newsize )
 idList<_type_,_tag_>::Resize
 
 Allocates memory for the amount of elements requested while keeping the contents intact.
-Contents are copied using their = operator so that data is correnctly instantiated.
+Contents are moved using their = operator so that data is correnctly instantiated.
 ================
 */
 template< typename _type_, memTag_t _tag_ >
@@ -638,6 +656,24 @@ ID_INLINE idList<_type_, _tag_>& idList<_type_, _tag_>::operator=( const idList<
 	return *this;
 }
 
+/*
+================
+idList<_type_,_tag_>::operator=
+
+Frees the current contents and takes over the contents of the other list.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE idList<_type_, _tag_>& idList<_type_, _tag_>::operator=( idList<_type_, _tag_>&& other )
+{
+	if( this != &other )
+	{
+		Clear();
+		Swap( other );
+	}
+	return *this;
+}
+
 /*
 ================
 idList<_type_,_tag_>::operator[] const
@@ -764,6 +800,39 @@ ID_INLINE int idList<_type_, _tag_>::Append( _type_ const& obj )
 	return num - 1;
 }
 
+/*
+================
+idList<_type_,_tag_>::Append
+
+Same as above but moves the supplied data into the list.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE int idList<_type_, _tag_>::Append( _type_&& obj )
+{
+	if( !list )
+	{
+		Resize( granularity );
+	}
+	
+	if( num == size )
+	{
+		int newsize;
+		
+		if( granularity == 0 )  	// this is a hack to fix our memset classes
+		{
+			granularity = 16;
+		}
+		newsize = size + granularity;
+		Resize( newsize - newsize % granularity );
+	}
+	
+	list[ num ] = std::move( obj );
+	num++;
+	
+	return num - 1;
+}
+
 
 /*
 ================
@@ -805,7 +874,7 @@ ID_INLINE int idList<_type_, _tag_>::Insert( _type_ const& obj, int index )
 	}
 	for( int i = num; i > index; --i )
 	{
-		list[i] = list[i - 1];
+		list[i] = std::move( list[i - 1] );
 	}
 	num++;
 	list[index] = obj;
@@ -984,7 +1053,7 @@ ID_INLINE bool idList<_type_, _tag_>::RemoveIndex( int index )
 	num--;
 	for( i = index; i < num; i++ )
 	{
-		list[ i ] = list[ i + 1 ];
+		list[ i ] = std::move( list[ i + 1 ] );
 	}
 	
 	return true;
@@ -1016,7 +1085,7 @@ ID_INLINE bool idList<_type_, _tag_>::RemoveIndexFast( int index )
 	num--;
 	if( index != num )
 	{
-		list[ index ] = list[ num ];
+		list[ index ] = std::move( list[ num ] );
 	}
 	
 	return true;
@@ -1064,6 +1133,23 @@ ID_INLINE bool idList<_type_, _tag_>::Remove( _type_ const& obj )
 //	qsort( ( void * )list, ( size_t )num, sizeof( _type_ ), vCompare );
 //}
 
+/*
+================
+idList<_type_,_tag_>::Swap
+
+Swaps the contents of two lists without touching the elements.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE void idList<_type_, _tag_>::Swap( idList<_type_, _tag_>& other )
+{
+	SwapValues( num, other.num );
+	SwapValues( size, other.size );
+	SwapValues( granularity, other.granularity );
+	SwapValues( list, other.list );
+	SwapValues( memTag, other.memTag );
+}
+
 /*
 ========================
 idList<_type_,_tag_>::SortWithTemplate
@@ -79,10 +79,9 @@ idList< idMyObject > list;
 list.Sort( idSort_MySort() );
 
 The sort implementations never create temporaries of the template type. Only the
-'SwapValues' template is used to move data around. This 'SwapValues' template can be
-specialized to implement fast swapping of data. For instance, when sorting a list with
-objects of some string class it is important to implement a specialized 'SwapValues' for
-this string class to avoid excessive re-allocation and copying of strings.
+'SwapValues' template is used to move data around. 'SwapValues' moves the values so types
+with a move constructor and move assignment, like idStr, are swapped without re-allocation
+and copying. It can still be specialized for types that can be swapped even faster.
 
 ================================================================================================
 */
@@ -95,9 +94,9 @@ SwapValues
 template< typename _type_ >
 ID_INLINE void SwapValues( _type_ & a, _type_ & b )
 {
-	_type_ c = a;
-	a = b;
-	b = c;
+	_type_ c = std::move( a );
+	a = std::move( b );
+	b = std::move( c );
 }
 
 /*
@@ -74,14 +74,33 @@ private:
 	mutable int			numUsers;
 };
 
-class idStrPool
+/*
+================================================
+idStrPoolHashTraits hashes the pool strings case sensitive or not.
+================================================
+*/
+class idStrPoolHashTraits
 {
 public:
-	idStrPool()
+	idStrPoolHashTraits()
 	{
 		caseSensitive = true;
 	}
+	unsigned int		Hash( const char* key ) const
+	{
+		return caseSensitive ? idHashMapBase::StringHash( key ) : idHashMapBase::StringHashNoCase( key );
+	}
+	bool				Compare( const char* key1, const char* key2 ) const
+	{
+		return ( caseSensitive ? idStr::Cmp( key1, key2 ) : idStr::Icmp( key1, key2 ) ) == 0;
+	}
 	
+	bool				caseSensitive;
+};
+
+class idStrPool
+{
+public:
 	void				SetCaseSensitive( bool caseSensitive );
 	
 	int					Num() const
@@ -93,7 +112,7 @@ public:
 	
 	const idPoolStr* 	operator[]( int index ) const
 	{
-		return pool[index];
+		return pool.GetIndex( index ).value;
 	}
 	
 	const idPoolStr* 	AllocString( const char* string );
@@ -102,9 +121,8 @@ public:
 	void				Clear();
 	
 private:
-	bool				caseSensitive;
-	idList<idPoolStr*>	pool;
-	idHashIndex			poolHash;
+	// the keys point to the text of the pool strings
+	idHashMap<const char*, idPoolStr*, idStrPoolHashTraits, TAG_IDLIB_STRING>	pool;
 };
 
 /*
@@ -114,7 +132,9 @@ idStrPool::SetCaseSensitive
 */
 ID_INLINE void idStrPool::SetCaseSensitive( bool caseSensitive )
 {
-	this->caseSensitive = caseSensitive;
+	idStrPoolHashTraits traits;
+	traits.caseSensitive = caseSensitive;
+	pool.SetTraits( traits );
 }
 
 /*
@@ -124,38 +144,18 @@ idStrPool::AllocString
 */
 ID_INLINE const idPoolStr* idStrPool::AllocString( const char* string )
 {
-	int i, hash;
-	idPoolStr* poolStr;
-	
-	hash = poolHash.GenerateKey( string, caseSensitive );
-	if( caseSensitive )
+	idPoolStr* const* existing = pool.Find( string );
+	if( existing != NULL )
 	{
-		for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-		{
-			if( pool[i]->Cmp( string ) == 0 )
-			{
-				pool[i]->numUsers++;
-				return pool[i];
-			}
-		}
-	}
-	else
-	{
-		for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-		{
-			if( pool[i]->Icmp( string ) == 0 )
-			{
-				pool[i]->numUsers++;
-				return pool[i];
-			}
-		}
+		( *existing )->numUsers++;
+		return *existing;
 	}
 	
-	poolStr = new( TAG_IDLIB_STRING ) idPoolStr;
+	idPoolStr* poolStr = new( TAG_IDLIB_STRING ) idPoolStr;
 	*static_cast<idStr*>( poolStr ) = string;
 	poolStr->pool = this;
 	poolStr->numUsers = 1;
-	poolHash.Add( hash, pool.Append( poolStr ) );
+	pool.Set( poolStr->c_str(), poolStr );
 	return poolStr;
 }
 
@@ -166,8 +166,6 @@ idStrPool::FreeString
 */
 ID_INLINE void idStrPool::FreeString( const idPoolStr* poolStr )
 {
-	int i, hash;
-	
 	/*
 	 * DG: numUsers can actually be 0 when shutting down the game, because then
 	 * first idCommonLocal::Quit() -> idCommonLocal::Shutdown() -> idLib::Shutdown()
@@ -190,32 +188,8 @@ ID_INLINE void idStrPool::FreeString( const idPoolStr* poolStr )
 	poolStr->numUsers--;
 	if( poolStr->numUsers <= 0 )
 	{
-		hash = poolHash.GenerateKey( poolStr->c_str(), caseSensitive );
-		if( caseSensitive )
-		{
-			for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-			{
-				if( pool[i]->Cmp( poolStr->c_str() ) == 0 )
-				{
-					break;
-				}
-			}
-		}
-		else
-		{
-			for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-			{
-				if( pool[i]->Icmp( poolStr->c_str() ) == 0 )
-				{
-					break;
-				}
-			}
-		}
-		assert( i != -1 );
-		assert( pool[i] == poolStr );
-		delete pool[i];
-		pool.RemoveIndex( i );
-		poolHash.RemoveIndex( hash, i );
+		verify( pool.Remove( poolStr->c_str() ) );
+		delete poolStr;
 	}
 }
 
@@ -249,14 +223,12 @@ idStrPool::Clear
 */
 ID_INLINE void idStrPool::Clear()
 {
-	int i;
-	
-	for( i = 0; i < pool.Num(); i++ )
+	for( int i = 0; i < pool.Num(); i++ )
 	{
-		pool[i]->numUsers = 0;
+		pool.GetIndex( i ).value->numUsers = 0;
 	}
-	pool.DeleteContents( true );
-	poolHash.Free();
+	pool.DeleteContents();
+	pool.Free();
 }
 
 /*
@@ -269,10 +241,10 @@ ID_INLINE size_t idStrPool::Allocated() const
 	int i;
 	size_t size;
 	
-	size = pool.Allocated() + poolHash.Allocated();
+	size = pool.Allocated();
 	for( i = 0; i < pool.Num(); i++ )
 	{
-		size += pool[i]->Allocated();
+		size += pool.GetIndex( i ).value->Allocated();
 	}
 	return size;
 }
@@ -287,10 +259,10 @@ ID_INLINE size_t idStrPool::Size() const
 	int i;
 	size_t size;
 	
-	size = pool.Size() + poolHash.Size();
+	size = pool.Size();
 	for( i = 0; i < pool.Num(); i++ )
 	{
-		size += pool[i]->Size();
+		size += pool.GetIndex( i ).value->Size();
 	}
 	return size;
 }
@@ -59,6 +59,7 @@ public:
 #define JOINTQUAT_SIZE_SHIFT		5			// log2( sizeof( idJointQuat ) )
 #define JOINTQUAT_Q_OFFSET			(0*4)		// offsetof( idJointQuat, q )
 #define JOINTQUAT_T_OFFSET			(4*4)		// offsetof( idJointQuat, t )
+#define JOINTQUAT_TYPESIZE			(8)			// number of floats in an idJointQuat
 
 assert_sizeof( idJointQuat, JOINTQUAT_SIZE );
 assert_sizeof( idJointQuat, ( 1 << JOINTQUAT_SIZE_SHIFT ) );
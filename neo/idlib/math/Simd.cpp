@@ -36,6 +36,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "Simd_Generic.h"
 #include "Simd_SSE.h"
+#include "Simd_AVX2.h"
 
 idSIMDProcessor*		processor = NULL;			// pointer to SIMD processor
 idSIMDProcessor* 	generic = NULL;				// pointer to generic SIMD implementation
@@ -78,7 +79,11 @@ void idSIMD::InitProcessor( const char* module, bool forceGeneric )
 		if( processor == NULL )
 		{
 #if defined(USE_INTRINSICS)
-			if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) )
+			if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_AVX2 ) && ( cpuid & CPUID_FMA3 ) )
+			{
+				processor = new( TAG_MATH ) idSIMD_AVX2;
+			}
+			else if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) )
 			{
 				processor = new( TAG_MATH ) idSIMD_SSE;
 			}
@@ -183,6 +188,16 @@ double ticksPerNanosecond;
 #define StopRecordTime( end )				\
 	end = mach_absolute_time();
 
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+
+#define TIME_TYPE int
+
+#define StartRecordTime( start )			\
+	start = ( int )__builtin_ia32_rdtsc();
+
+#define StopRecordTime( end )				\
+	end = ( int )__builtin_ia32_rdtsc();
+
 #else // not _MSC_VER and _M_IX86 or __APPLE__
 // FIXME: meaningful values/functions here for Linux?
 #define TIME_TYPE int
@@ -819,10 +834,21 @@ void TestConvertJointMatsToJointQuats()
 /*
 ============
 TestTransformJoints
+
+Tests a single chain of joints, a wide tree where every joint has eight children and a
+skeleton where most joints are parented to the joint before them with a branch every few joints.
 ============
 */
-void TestTransformJoints()
+enum jointHierarchy_t
 {
+	JOINTS_CHAIN,
+	JOINTS_TREE,
+	JOINTS_SKELETON
+};
+
+void TestTransformJoints( jointHierarchy_t hierarchy )
+{
+	static const char* hierarchyNames[] = { "", " tree", " skeleton" };
 	int i, j;
 	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
 	idTempArray< idJointMat > joints( COUNT + 1 );
@@ -845,7 +871,18 @@ void TestTransformJoints()
 		v[1] = srnd.CRandomFloat() * 2.0f;
 		v[2] = srnd.CRandomFloat() * 2.0f;
 		joints[i].SetTranslation( v );
-		parents[i] = i - 1;
+		if( hierarchy == JOINTS_TREE )
+		{
+			parents[i] = ( i > 0 ) ? ( i - 1 ) / 8 : -1;
+		}
+		else if( hierarchy == JOINTS_SKELETON && i > 0 && ( i & 3 ) == 0 )
+		{
+			parents[i] = srnd.RandomInt( i );
+		}
+		else
+		{
+			parents[i] = i - 1;
+		}
 	}
 	
 	bestClocksGeneric = 0;
@@ -860,7 +897,7 @@ void TestTransformJoints()
 		StopRecordTime( end );
 		GetBest( start, end, bestClocksGeneric );
 	}
-	PrintClocks( "generic->TransformJoints()", COUNT, bestClocksGeneric );
+	PrintClocks( va( "generic->TransformJoints()%s", hierarchyNames[hierarchy] ), COUNT, bestClocksGeneric );
 	
 	bestClocksSIMD = 0;
 	for( i = 0; i < NUMTESTS; i++ )
@@ -882,8 +919,8 @@ void TestTransformJoints()
 			break;
 		}
 	}
-	result = ( i >= COUNT ) ? "ok" : S_COLOR_RED"X";
-	PrintClocks( va( "   simd->TransformJoints() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+	result = ( i > COUNT ) ? "ok" : S_COLOR_RED"X";
+	PrintClocks( va( "   simd->TransformJoints()%s %s", hierarchyNames[hierarchy], result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
 /*
@@ -956,6 +993,98 @@ void TestUntransformJoints()
 	PrintClocks( va( "   simd->UntransformJoints() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestCullBoundsToPlanes
+============
+*/
+void TestCullBoundsToPlanes()
+{
+	int i;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	const int stride = ( COUNT + 7 ) & ~7;
+	idTempArray< float > bounds( stride * 6 );
+	idTempArray< int > visible1( COUNT );
+	idTempArray< int > visible2( COUNT );
+	idPlane planes[5];
+	int numVisible1 = 0, numVisible2 = 0;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	bounds.Zero();
+	for( i = 0; i < COUNT; i++ )
+	{
+		for( int j = 0; j < 3; j++ )
+		{
+			const float center = srnd.CRandomFloat() * 1000.0f;
+			const float size = srnd.RandomFloat() * 100.0f;
+			bounds[( j + 0 ) * stride + i] = center - size;
+			bounds[( j + 3 ) * stride + i] = center + size;
+		}
+	}
+	
+	for( i = 0; i < 5; i++ )
+	{
+		idVec3 normal( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		normal.Normalize();
+		planes[i].SetNormal( normal );
+		planes[i].SetDist( srnd.CRandomFloat() * 500.0f );
+	}
+	
+	// put every eighth box right at the epsilon of a plane, where a fused multiply-add would round
+	// differently than the generic code
+	for( i = 0; i < COUNT; i += 8 )
+	{
+		const idPlane& plane = planes[( i >> 3 ) % 5];
+		idVec3 point( srnd.CRandomFloat() * 1000.0f, srnd.CRandomFloat() * 1000.0f, srnd.CRandomFloat() * 1000.0f );
+		point -= plane.Normal() * ( plane.Distance( point ) - 0.1f );
+		for( int j = 0; j < 3; j++ )
+		{
+			const float size = srnd.RandomFloat() * 100.0f;
+			if( plane[j] >= 0.0f )
+			{
+				bounds[( j + 0 ) * stride + i] = point[j];
+				bounds[( j + 3 ) * stride + i] = point[j] + size;
+			}
+			else
+			{
+				bounds[( j + 0 ) * stride + i] = point[j] - size;
+				bounds[( j + 3 ) * stride + i] = point[j];
+			}
+		}
+	}
+	
+	bestClocksGeneric = 0;
+	for( i = 0; i < NUMTESTS; i++ )
+	{
+		StartRecordTime( start );
+		numVisible1 = p_generic->CullBoundsToPlanes( visible1.Ptr(), bounds.Ptr(), stride, COUNT, planes, 5, 0.1f );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->CullBoundsToPlanes()", COUNT, bestClocksGeneric );
+	
+	bestClocksSIMD = 0;
+	for( i = 0; i < NUMTESTS; i++ )
+	{
+		StartRecordTime( start );
+		numVisible2 = p_simd->CullBoundsToPlanes( visible2.Ptr(), bounds.Ptr(), stride, COUNT, planes, 5, 0.1f );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+	
+	for( i = 0; i < numVisible1; i++ )
+	{
+		if( visible1[i] != visible2[i] )
+		{
+			break;
+		}
+	}
+	result = ( numVisible1 == numVisible2 && i >= numVisible1 ) ? "ok" : S_COLOR_RED"X";
+	PrintClocks( va( "   simd->CullBoundsToPlanes() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestMath
@@ -1399,10 +1528,19 @@ void idSIMD::Test_f( const idCmdArgs& args )
 			}
 			p_simd = new( TAG_MATH ) idSIMD_SSE;
 		}
+		else if( idStr::Icmp( argString, "AVX2" ) == 0 )
+		{
+			if( !( cpuid & CPUID_AVX2 ) || !( cpuid & CPUID_FMA3 ) )
+			{
+				common->Printf( "CPU does not support AVX2 & FMA3\n" );
+				return;
+			}
+			p_simd = new( TAG_MATH ) idSIMD_AVX2;
+		}
 		else
 #endif
 		{
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: SSE, AVX2\n" );
 			return;
 		}
 	}
@@ -1424,11 +1562,17 @@ void idSIMD::Test_f( const idCmdArgs& args )
 	TestBlendJointsFast();
 	TestConvertJointQuatsToJointMats();
 	TestConvertJointMatsToJointQuats();
-	TestTransformJoints();
+	TestTransformJoints( JOINTS_CHAIN );
+	TestTransformJoints( JOINTS_TREE );
+	TestTransformJoints( JOINTS_SKELETON );
 	TestUntransformJoints();
 	
 	idLib::common->Printf( "====================================\n" );
 	
+	TestCullBoundsToPlanes();
+	
+	idLib::common->Printf( "====================================\n" );
+	
 	idLib::common->SetRefreshOnPrint( false );
 	
 	if( p_simd != processor )
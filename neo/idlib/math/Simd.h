@@ -112,6 +112,9 @@ public:
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat* jointQuats, const idJointMat* jointMats, const int numJoints ) = 0;
 	virtual void VPCALL TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
 	virtual void VPCALL UntransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
+	
+	// culling
+	virtual int VPCALL CullBoundsToPlanes( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon ) = 0;
 };
 
 // pointer to SIMD processor
@@ -0,0 +1,590 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+#include "Simd_Generic.h"
+#include "Simd_SSE.h"
+#include "Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//	The rest of the engine is compiled for SSE2 so the AVX2 code
+//	is enabled per function and this processor is only created
+//	when the CPU reports AVX2 and FMA3 support.
+//
+//===============================================================
+
+#if defined(USE_INTRINSICS)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_FUNC			__attribute__(( target( "avx2,fma" ) ))
+// without fma the compiler can't contract a multiply and an add into one
+#define AVX2_NO_FMA_FUNC	__attribute__(( target( "avx2" ) ))
+#else
+#define AVX2_FUNC
+#define AVX2_NO_FMA_FUNC
+#endif
+
+#ifndef M_PI // DG: this is already defined in math.h
+#define M_PI	3.14159265358979323846f
+#endif
+
+/*
+============
+Transpose4x4_AVX
+
+Transposes the 4x4 matrices in the lower and upper lanes.
+Loading [ joint n | joint n + 4 ] in register n turns four registers
+of AoS joint data into the x, y, z, w arrays of eight joints and back.
+============
+*/
+static AVX2_FUNC inline void Transpose4x4_AVX( __m256& r0, __m256& r1, __m256& r2, __m256& r3 )
+{
+	__m256 t0 = _mm256_unpacklo_ps( r0, r1 );
+	__m256 t1 = _mm256_unpackhi_ps( r0, r1 );
+	__m256 t2 = _mm256_unpacklo_ps( r2, r3 );
+	__m256 t3 = _mm256_unpackhi_ps( r2, r3 );
+	r0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	r1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	r2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	r3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+}
+
+/*
+============
+Load2_AVX
+============
+*/
+static AVX2_FUNC inline __m256 Load2_AVX( const float* lo, const float* hi )
+{
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( lo ) ), _mm_load_ps( hi ), 1 );
+}
+
+/*
+============
+Store2_AVX
+============
+*/
+static AVX2_FUNC inline void Store2_AVX( float* lo, float* hi, const __m256 v )
+{
+	_mm_store_ps( lo, _mm256_castps256_ps128( v ) );
+	_mm_store_ps( hi, _mm256_extractf128_ps( v, 1 ) );
+}
+
+/*
+============
+BlendJoints_AVX2
+============
+*/
+static AVX2_FUNC int BlendJoints_AVX2( idJointQuat* joints, const idJointQuat* blendJoints, const float lerp, const int* index, const int numJoints )
+{
+	const __m256 vlerp					= _mm256_set1_ps( lerp );
+	
+	const __m256 vector_float_one		= _mm256_set1_ps( 1.0f );
+	const __m256 vector_float_sign_bit	= _mm256_castsi256_ps( _mm256_set1_epi32( 0x80000000 ) );
+	const __m256 vector_float_rsqrt_c0	= _mm256_set1_ps( -3.0f );
+	const __m256 vector_float_rsqrt_c1	= _mm256_set1_ps( -0.5f );
+	const __m256 vector_float_tiny		= _mm256_set1_ps( 1e-10f );
+	const __m256 vector_float_half_pi	= _mm256_set1_ps( M_PI * 0.5f );
+	
+	const __m256 vector_float_sin_c0	= _mm256_set1_ps( -2.39e-08f );
+	const __m256 vector_float_sin_c1	= _mm256_set1_ps( 2.7526e-06f );
+	const __m256 vector_float_sin_c2	= _mm256_set1_ps( -1.98409e-04f );
+	const __m256 vector_float_sin_c3	= _mm256_set1_ps( 8.3333315e-03f );
+	const __m256 vector_float_sin_c4	= _mm256_set1_ps( -1.666666664e-01f );
+	
+	const __m256 vector_float_atan_c0	= _mm256_set1_ps( 0.0028662257f );
+	const __m256 vector_float_atan_c1	= _mm256_set1_ps( -0.0161657367f );
+	const __m256 vector_float_atan_c2	= _mm256_set1_ps( 0.0429096138f );
+	const __m256 vector_float_atan_c3	= _mm256_set1_ps( -0.0752896400f );
+	const __m256 vector_float_atan_c4	= _mm256_set1_ps( 0.1065626393f );
+	const __m256 vector_float_atan_c5	= _mm256_set1_ps( -0.1420889944f );
+	const __m256 vector_float_atan_c6	= _mm256_set1_ps( 0.1999355085f );
+	const __m256 vector_float_atan_c7	= _mm256_set1_ps( -0.3333314528f );
+	
+	int i = 0;
+	for( ; i + 7 < numJoints; i += 8 )
+	{
+		const int n0 = index[i + 0];
+		const int n1 = index[i + 1];
+		const int n2 = index[i + 2];
+		const int n3 = index[i + 3];
+		const int n4 = index[i + 4];
+		const int n5 = index[i + 5];
+		const int n6 = index[i + 6];
+		const int n7 = index[i + 7];
+		
+		// the translations don't need to be transposed
+		__m256 jta = Load2_AVX( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr() );
+		__m256 jtb = Load2_AVX( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr() );
+		__m256 jtc = Load2_AVX( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr() );
+		__m256 jtd = Load2_AVX( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr() );
+		
+		__m256 bta = Load2_AVX( blendJoints[n0].t.ToFloatPtr(), blendJoints[n4].t.ToFloatPtr() );
+		__m256 btb = Load2_AVX( blendJoints[n1].t.ToFloatPtr(), blendJoints[n5].t.ToFloatPtr() );
+		__m256 btc = Load2_AVX( blendJoints[n2].t.ToFloatPtr(), blendJoints[n6].t.ToFloatPtr() );
+		__m256 btd = Load2_AVX( blendJoints[n3].t.ToFloatPtr(), blendJoints[n7].t.ToFloatPtr() );
+		
+		jta = _mm256_fmadd_ps( vlerp, _mm256_sub_ps( bta, jta ), jta );
+		jtb = _mm256_fmadd_ps( vlerp, _mm256_sub_ps( btb, jtb ), jtb );
+		jtc = _mm256_fmadd_ps( vlerp, _mm256_sub_ps( btc, jtc ), jtc );
+		jtd = _mm256_fmadd_ps( vlerp, _mm256_sub_ps( btd, jtd ), jtd );
+		
+		Store2_AVX( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr(), jta );
+		Store2_AVX( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr(), jtb );
+		Store2_AVX( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr(), jtc );
+		Store2_AVX( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr(), jtd );
+		
+		__m256 jqx = Load2_AVX( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr() );
+		__m256 jqy = Load2_AVX( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr() );
+		__m256 jqz = Load2_AVX( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr() );
+		__m256 jqw = Load2_AVX( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr() );
+		
+		__m256 bqx = Load2_AVX( blendJoints[n0].q.ToFloatPtr(), blendJoints[n4].q.ToFloatPtr() );
+		__m256 bqy = Load2_AVX( blendJoints[n1].q.ToFloatPtr(), blendJoints[n5].q.ToFloatPtr() );
+		__m256 bqz = Load2_AVX( blendJoints[n2].q.ToFloatPtr(), blendJoints[n6].q.ToFloatPtr() );
+		__m256 bqw = Load2_AVX( blendJoints[n3].q.ToFloatPtr(), blendJoints[n7].q.ToFloatPtr() );
+		
+		Transpose4x4_AVX( jqx, jqy, jqz, jqw );
+		Transpose4x4_AVX( bqx, bqy, bqz, bqw );
+		
+		__m256 cosom = _mm256_mul_ps( jqx, bqx );
+		cosom = _mm256_fmadd_ps( jqy, bqy, cosom );
+		cosom = _mm256_fmadd_ps( jqz, bqz, cosom );
+		cosom = _mm256_fmadd_ps( jqw, bqw, cosom );
+		
+		__m256 sign = _mm256_and_ps( cosom, vector_float_sign_bit );
+		cosom = _mm256_xor_ps( cosom, sign );
+		__m256 ss = _mm256_fnmadd_ps( cosom, cosom, vector_float_one );
+		
+		ss = _mm256_max_ps( ss, vector_float_tiny );
+		
+		__m256 rs = _mm256_rsqrt_ps( ss );
+		__m256 sq = _mm256_mul_ps( rs, rs );
+		__m256 sh = _mm256_mul_ps( rs, vector_float_rsqrt_c1 );
+		__m256 sx = _mm256_fmadd_ps( ss, sq, vector_float_rsqrt_c0 );
+		__m256 sinom = _mm256_mul_ps( sh, sx );						// sinom = 1 / sqrt( ss );
+		
+		ss = _mm256_mul_ps( ss, sinom );
+		
+		__m256 min = _mm256_min_ps( ss, cosom );
+		__m256 max = _mm256_max_ps( ss, cosom );
+		__m256 mask = _mm256_cmp_ps( min, cosom, _CMP_EQ_OQ );
+		__m256 masksign = _mm256_and_ps( mask, vector_float_sign_bit );
+		__m256 maskPI = _mm256_and_ps( mask, vector_float_half_pi );
+		
+		__m256 rcpa = _mm256_rcp_ps( max );
+		__m256 rcpb = _mm256_mul_ps( max, rcpa );
+		__m256 rcpd = _mm256_add_ps( rcpa, rcpa );
+		__m256 rcp = _mm256_fnmadd_ps( rcpb, rcpa, rcpd );			// 1 / y or 1 / x
+		__m256 ata = _mm256_mul_ps( min, rcp );						// x / y or y / x
+		
+		__m256 atb = _mm256_xor_ps( ata, masksign );				// -x / y or y / x
+		__m256 atc = _mm256_mul_ps( atb, atb );
+		__m256 atd = _mm256_fmadd_ps( atc, vector_float_atan_c0, vector_float_atan_c1 );
+		
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c2 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c3 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c4 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c5 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c6 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_atan_c7 );
+		atd = _mm256_fmadd_ps( atd, atc, vector_float_one );
+		
+		__m256 omega_a = _mm256_fmadd_ps( atd, atb, maskPI );
+		__m256 omega_b = _mm256_mul_ps( vlerp, omega_a );
+		omega_a = _mm256_sub_ps( omega_a, omega_b );
+		
+		__m256 sinsa = _mm256_mul_ps( omega_a, omega_a );
+		__m256 sinsb = _mm256_mul_ps( omega_b, omega_b );
+		__m256 sina = _mm256_fmadd_ps( sinsa, vector_float_sin_c0, vector_float_sin_c1 );
+		__m256 sinb = _mm256_fmadd_ps( sinsb, vector_float_sin_c0, vector_float_sin_c1 );
+		sina = _mm256_fmadd_ps( sina, sinsa, vector_float_sin_c2 );
+		sinb = _mm256_fmadd_ps( sinb, sinsb, vector_float_sin_c2 );
+		sina = _mm256_fmadd_ps( sina, sinsa, vector_float_sin_c3 );
+		sinb = _mm256_fmadd_ps( sinb, sinsb, vector_float_sin_c3 );
+		sina = _mm256_fmadd_ps( sina, sinsa, vector_float_sin_c4 );
+		sinb = _mm256_fmadd_ps( sinb, sinsb, vector_float_sin_c4 );
+		sina = _mm256_fmadd_ps( sina, sinsa, vector_float_one );
+		sinb = _mm256_fmadd_ps( sinb, sinsb, vector_float_one );
+		sina = _mm256_mul_ps( sina, omega_a );
+		sinb = _mm256_mul_ps( sinb, omega_b );
+		__m256 scalea = _mm256_mul_ps( sina, sinom );
+		__m256 scaleb = _mm256_mul_ps( sinb, sinom );
+		
+		scaleb = _mm256_xor_ps( scaleb, sign );
+		
+		jqx = _mm256_fmadd_ps( bqx, scaleb, _mm256_mul_ps( jqx, scalea ) );
+		jqy = _mm256_fmadd_ps( bqy, scaleb, _mm256_mul_ps( jqy, scalea ) );
+		jqz = _mm256_fmadd_ps( bqz, scaleb, _mm256_mul_ps( jqz, scalea ) );
+		jqw = _mm256_fmadd_ps( bqw, scaleb, _mm256_mul_ps( jqw, scalea ) );
+		
+		Transpose4x4_AVX( jqx, jqy, jqz, jqw );
+		
+		Store2_AVX( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr(), jqx );
+		Store2_AVX( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr(), jqy );
+		Store2_AVX( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr(), jqz );
+		Store2_AVX( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr(), jqw );
+	}
+	
+	_mm256_zeroupper();
+	
+	return i;
+}
+
+/*
+============
+ConvertJointQuatsToJointMats_AVX2
+============
+*/
+static AVX2_FUNC int ConvertJointQuatsToJointMats_AVX2( idJointMat* jointMats, const idJointQuat* jointQuats, const int numJoints )
+{
+	const float* jointQuatPtr = jointQuats->q.ToFloatPtr();
+	float* jointMatPtr = jointMats->ToFloatPtr();
+	
+	const __m256 vector_float_one = _mm256_set1_ps( 1.0f );
+	
+	int i = 0;
+	for( ; i + 7 < numJoints; i += 8 )
+	{
+		const float* q = jointQuatPtr + i * JOINTQUAT_TYPESIZE;
+		float* m = jointMatPtr + i * JOINTMAT_TYPESIZE;
+		
+		__m256 x = Load2_AVX( q + 0 * JOINTQUAT_TYPESIZE + 0, q + 4 * JOINTQUAT_TYPESIZE + 0 );
+		__m256 y = Load2_AVX( q + 1 * JOINTQUAT_TYPESIZE + 0, q + 5 * JOINTQUAT_TYPESIZE + 0 );
+		__m256 z = Load2_AVX( q + 2 * JOINTQUAT_TYPESIZE + 0, q + 6 * JOINTQUAT_TYPESIZE + 0 );
+		__m256 w = Load2_AVX( q + 3 * JOINTQUAT_TYPESIZE + 0, q + 7 * JOINTQUAT_TYPESIZE + 0 );
+		
+		__m256 tx = Load2_AVX( q + 0 * JOINTQUAT_TYPESIZE + 4, q + 4 * JOINTQUAT_TYPESIZE + 4 );
+		__m256 ty = Load2_AVX( q + 1 * JOINTQUAT_TYPESIZE + 4, q + 5 * JOINTQUAT_TYPESIZE + 4 );
+		__m256 tz = Load2_AVX( q + 2 * JOINTQUAT_TYPESIZE + 4, q + 6 * JOINTQUAT_TYPESIZE + 4 );
+		__m256 tw = Load2_AVX( q + 3 * JOINTQUAT_TYPESIZE + 4, q + 7 * JOINTQUAT_TYPESIZE + 4 );
+		
+		Transpose4x4_AVX( x, y, z, w );
+		Transpose4x4_AVX( tx, ty, tz, tw );
+		
+		__m256 x2 = _mm256_add_ps( x, x );
+		__m256 y2 = _mm256_add_ps( y, y );
+		__m256 z2 = _mm256_add_ps( z, z );
+		
+		__m256 xx = _mm256_mul_ps( x, x2 );
+		__m256 xy = _mm256_mul_ps( x, y2 );
+		__m256 xz = _mm256_mul_ps( x, z2 );
+		
+		__m256 yy = _mm256_mul_ps( y, y2 );
+		__m256 yz = _mm256_mul_ps( y, z2 );
+		__m256 zz = _mm256_mul_ps( z, z2 );
+		
+		__m256 wx = _mm256_mul_ps( w, x2 );
+		__m256 wy = _mm256_mul_ps( w, y2 );
+		__m256 wz = _mm256_mul_ps( w, z2 );
+		
+		// idQuat::ToMat3 transposed into the rows of idJointMat
+		__m256 m0 = _mm256_sub_ps( vector_float_one, _mm256_add_ps( yy, zz ) );
+		__m256 m1 = _mm256_add_ps( xy, wz );
+		__m256 m2 = _mm256_sub_ps( xz, wy );
+		__m256 m3 = tx;
+		
+		__m256 m4 = _mm256_sub_ps( xy, wz );
+		__m256 m5 = _mm256_sub_ps( vector_float_one, _mm256_add_ps( xx, zz ) );
+		__m256 m6 = _mm256_add_ps( yz, wx );
+		__m256 m7 = ty;
+		
+		__m256 m8 = _mm256_add_ps( xz, wy );
+		__m256 m9 = _mm256_sub_ps( yz, wx );
+		__m256 m10 = _mm256_sub_ps( vector_float_one, _mm256_add_ps( xx, yy ) );
+		__m256 m11 = tz;
+		
+		Transpose4x4_AVX( m0, m1, m2, m3 );
+		Transpose4x4_AVX( m4, m5, m6, m7 );
+		Transpose4x4_AVX( m8, m9, m10, m11 );
+		
+		Store2_AVX( m + 0 * JOINTMAT_TYPESIZE + 0, m + 4 * JOINTMAT_TYPESIZE + 0, m0 );
+		Store2_AVX( m + 1 * JOINTMAT_TYPESIZE + 0, m + 5 * JOINTMAT_TYPESIZE + 0, m1 );
+		Store2_AVX( m + 2 * JOINTMAT_TYPESIZE + 0, m + 6 * JOINTMAT_TYPESIZE + 0, m2 );
+		Store2_AVX( m + 3 * JOINTMAT_TYPESIZE + 0, m + 7 * JOINTMAT_TYPESIZE + 0, m3 );
+		
+		Store2_AVX( m + 0 * JOINTMAT_TYPESIZE + 4, m + 4 * JOINTMAT_TYPESIZE + 4, m4 );
+		Store2_AVX( m + 1 * JOINTMAT_TYPESIZE + 4, m + 5 * JOINTMAT_TYPESIZE + 4, m5 );
+		Store2_AVX( m + 2 * JOINTMAT_TYPESIZE + 4, m + 6 * JOINTMAT_TYPESIZE + 4, m6 );
+		Store2_AVX( m + 3 * JOINTMAT_TYPESIZE + 4, m + 7 * JOINTMAT_TYPESIZE + 4, m7 );
+		
+		Store2_AVX( m + 0 * JOINTMAT_TYPESIZE + 8, m + 4 * JOINTMAT_TYPESIZE + 8, m8 );
+		Store2_AVX( m + 1 * JOINTMAT_TYPESIZE + 8, m + 5 * JOINTMAT_TYPESIZE + 8, m9 );
+		Store2_AVX( m + 2 * JOINTMAT_TYPESIZE + 8, m + 6 * JOINTMAT_TYPESIZE + 8, m10 );
+		Store2_AVX( m + 3 * JOINTMAT_TYPESIZE + 8, m + 7 * JOINTMAT_TYPESIZE + 8, m11 );
+	}
+	
+	_mm256_zeroupper();
+	
+	return i;
+}
+
+/*
+============
+TransformJoints_AVX2
+
+A joint and the joint after it are transformed together, one joint in each 128 bit lane, unless
+the second one is the child of the first one. Skeletons are stored depth first, so that happens
+along the chains and then a single joint is transformed, with the parent still in registers.
+============
+*/
+static AVX2_FUNC void TransformJoints_AVX2( float* matrices, const int* parents, const int firstJoint, const int lastJoint )
+{
+	const __m256 vector_float_mask_keep_last = _mm256_castsi256_ps( _mm256_setr_epi32( 0, 0, 0, -1, 0, 0, 0, -1 ) );
+	const __m128 mask = _mm256_castps256_ps128( vector_float_mask_keep_last );
+	
+	// the previous joint
+	__m128 lma = _mm_setzero_ps();
+	__m128 lmb = _mm_setzero_ps();
+	__m128 lmc = _mm_setzero_ps();
+	if( firstJoint > 0 )
+	{
+		lma = _mm_load_ps( matrices + ( firstJoint - 1 ) * JOINTMAT_TYPESIZE + 0 );
+		lmb = _mm_load_ps( matrices + ( firstJoint - 1 ) * JOINTMAT_TYPESIZE + 4 );
+		lmc = _mm_load_ps( matrices + ( firstJoint - 1 ) * JOINTMAT_TYPESIZE + 8 );
+	}
+	
+	int joint = firstJoint;
+	while( joint <= lastJoint )
+	{
+		if( joint < lastJoint && parents[joint + 1] != joint )
+		{
+			const float* p0 = matrices + parents[joint + 0] * JOINTMAT_TYPESIZE;
+			const float* p1 = matrices + parents[joint + 1] * JOINTMAT_TYPESIZE;
+			float* c = matrices + joint * JOINTMAT_TYPESIZE;
+			
+			const __m256 pma = Load2_AVX( p0 + 0, p1 + 0 );
+			const __m256 pmb = Load2_AVX( p0 + 4, p1 + 4 );
+			const __m256 pmc = Load2_AVX( p0 + 8, p1 + 8 );
+			
+			const __m256 cma = Load2_AVX( c + 0, c + JOINTMAT_TYPESIZE + 0 );
+			const __m256 cmb = Load2_AVX( c + 4, c + JOINTMAT_TYPESIZE + 4 );
+			const __m256 cmc = Load2_AVX( c + 8, c + JOINTMAT_TYPESIZE + 8 );
+			
+			__m256 ra = _mm256_fmadd_ps( _mm256_permute_ps( pma, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm256_and_ps( pma, vector_float_mask_keep_last ) );
+			__m256 rb = _mm256_fmadd_ps( _mm256_permute_ps( pmb, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm256_and_ps( pmb, vector_float_mask_keep_last ) );
+			__m256 rc = _mm256_fmadd_ps( _mm256_permute_ps( pmc, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm256_and_ps( pmc, vector_float_mask_keep_last ) );
+			
+			ra = _mm256_fmadd_ps( _mm256_permute_ps( pma, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, ra );
+			rb = _mm256_fmadd_ps( _mm256_permute_ps( pmb, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, rb );
+			rc = _mm256_fmadd_ps( _mm256_permute_ps( pmc, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, rc );
+			
+			ra = _mm256_fmadd_ps( _mm256_permute_ps( pma, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, ra );
+			rb = _mm256_fmadd_ps( _mm256_permute_ps( pmb, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, rb );
+			rc = _mm256_fmadd_ps( _mm256_permute_ps( pmc, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, rc );
+			
+			Store2_AVX( c + 0, c + JOINTMAT_TYPESIZE + 0, ra );
+			Store2_AVX( c + 4, c + JOINTMAT_TYPESIZE + 4, rb );
+			Store2_AVX( c + 8, c + JOINTMAT_TYPESIZE + 8, rc );
+			
+			lma = _mm256_extractf128_ps( ra, 1 );
+			lmb = _mm256_extractf128_ps( rb, 1 );
+			lmc = _mm256_extractf128_ps( rc, 1 );
+			
+			joint += 2;
+		}
+		else
+		{
+			const int parent = parents[joint];
+			float* c = matrices + joint * JOINTMAT_TYPESIZE;
+			
+			__m128 pma = lma;
+			__m128 pmb = lmb;
+			__m128 pmc = lmc;
+			if( parent != joint - 1 )
+			{
+				pma = _mm_load_ps( matrices + parent * JOINTMAT_TYPESIZE + 0 );
+				pmb = _mm_load_ps( matrices + parent * JOINTMAT_TYPESIZE + 4 );
+				pmc = _mm_load_ps( matrices + parent * JOINTMAT_TYPESIZE + 8 );
+			}
+			
+			const __m128 cma = _mm_load_ps( c + 0 );
+			const __m128 cmb = _mm_load_ps( c + 4 );
+			const __m128 cmc = _mm_load_ps( c + 8 );
+			
+			__m128 ra = _mm_fmadd_ps( _mm_permute_ps( pma, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm_and_ps( pma, mask ) );
+			__m128 rb = _mm_fmadd_ps( _mm_permute_ps( pmb, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm_and_ps( pmb, mask ) );
+			__m128 rc = _mm_fmadd_ps( _mm_permute_ps( pmc, _MM_SHUFFLE( 0, 0, 0, 0 ) ), cma, _mm_and_ps( pmc, mask ) );
+			
+			ra = _mm_fmadd_ps( _mm_permute_ps( pma, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, ra );
+			rb = _mm_fmadd_ps( _mm_permute_ps( pmb, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, rb );
+			rc = _mm_fmadd_ps( _mm_permute_ps( pmc, _MM_SHUFFLE( 1, 1, 1, 1 ) ), cmb, rc );
+			
+			ra = _mm_fmadd_ps( _mm_permute_ps( pma, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, ra );
+			rb = _mm_fmadd_ps( _mm_permute_ps( pmb, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, rb );
+			rc = _mm_fmadd_ps( _mm_permute_ps( pmc, _MM_SHUFFLE( 2, 2, 2, 2 ) ), cmc, rc );
+			
+			_mm_store_ps( c + 0, ra );
+			_mm_store_ps( c + 4, rb );
+			_mm_store_ps( c + 8, rc );
+			
+			lma = ra;
+			lmb = rb;
+			lmc = rc;
+			
+			joint++;
+		}
+	}
+	
+	_mm256_zeroupper();
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char* idSIMD_AVX2::GetName() const
+{
+	return "MMX & SSE & AVX2";
+}
+
+/*
+============
+idSIMD_AVX2::BlendJoints
+============
+*/
+void VPCALL idSIMD_AVX2::BlendJoints( idJointQuat* joints, const idJointQuat* blendJoints, const float lerp, const int* index, const int numJoints )
+{
+	if( lerp <= 0.0f || lerp >= 1.0f )
+	{
+		idSIMD_SSE::BlendJoints( joints, blendJoints, lerp, index, numJoints );
+		return;
+	}
+	
+	const int done = BlendJoints_AVX2( joints, blendJoints, lerp, index, numJoints );
+	if( done < numJoints )
+	{
+		idSIMD_SSE::BlendJoints( joints, blendJoints, lerp, index + done, numJoints - done );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat* jointMats, const idJointQuat* jointQuats, const int numJoints )
+{
+	assert( sizeof( idJointQuat ) == JOINTQUAT_SIZE );
+	assert( sizeof( idJointMat ) == JOINTMAT_SIZE );
+	
+	const int done = ConvertJointQuatsToJointMats_AVX2( jointMats, jointQuats, numJoints );
+	if( done < numJoints )
+	{
+		idSIMD_SSE::ConvertJointQuatsToJointMats( jointMats + done, jointQuats + done, numJoints - done );
+	}
+}
+
+/*
+============
+CullBoundsToPlanes_AVX2
+
+Culls eight boxes per iteration. Compiled without fma so the plane distances are rounded like
+the generic and SSE paths and boxes right at the epsilon are culled the same way.
+============
+*/
+static AVX2_NO_FMA_FUNC int CullBoundsToPlanes_AVX2( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon )
+{
+	assert( ( stride & 7 ) == 0 );
+	
+	// select the min or max array per axis up front, based on the sign of the plane normal
+	int* offsets = ( int* ) _alloca16( numPlanes * 3 * sizeof( int ) );
+	for( int j = 0; j < numPlanes; j++ )
+	{
+		offsets[j * 3 + 0] = ( planes[j][0] >= 0.0f ? 0 : 3 ) * stride;
+		offsets[j * 3 + 1] = ( planes[j][1] >= 0.0f ? 1 : 4 ) * stride;
+		offsets[j * 3 + 2] = ( planes[j][2] >= 0.0f ? 2 : 5 ) * stride;
+	}
+	
+	const __m256 vector_eps = _mm256_set1_ps( epsilon );
+	
+	int numVisible = 0;
+	for( int i = 0; i < count; i += 8 )
+	{
+		__m256 culled = _mm256_setzero_ps();
+		for( int j = 0; j < numPlanes; j++ )
+		{
+			const int* o = offsets + j * 3;
+			const __m256 x = _mm256_loadu_ps( bounds + o[0] + i );
+			const __m256 y = _mm256_loadu_ps( bounds + o[1] + i );
+			const __m256 z = _mm256_loadu_ps( bounds + o[2] + i );
+			
+			__m256 d = _mm256_mul_ps( _mm256_set1_ps( planes[j][0] ), x );
+			d = _mm256_add_ps( d, _mm256_mul_ps( _mm256_set1_ps( planes[j][1] ), y ) );
+			d = _mm256_add_ps( d, _mm256_mul_ps( _mm256_set1_ps( planes[j][2] ), z ) );
+			d = _mm256_add_ps( d, _mm256_set1_ps( planes[j][3] ) );
+			
+			culled = _mm256_or_ps( culled, _mm256_cmp_ps( d, vector_eps, _CMP_GT_OQ ) );
+		}
+		
+		// the padding beyond count is never visible
+		const int mask = ~_mm256_movemask_ps( culled );
+		const int num = Min( count - i, 8 );
+		for( int k = 0; k < num; k++ )
+		{
+			if( mask & ( 1 << k ) )
+			{
+				visible[numVisible++] = i + k;
+			}
+		}
+	}
+	return numVisible;
+}
+
+/*
+============
+idSIMD_AVX2::TransformJoints
+============
+*/
+void VPCALL idSIMD_AVX2::TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint )
+{
+	TransformJoints_AVX2( jointMats->ToFloatPtr(), parents, firstJoint, lastJoint );
+}
+
+/*
+============
+idSIMD_AVX2::CullBoundsToPlanes
+============
+*/
+int VPCALL idSIMD_AVX2::CullBoundsToPlanes( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon )
+{
+	if( ( stride & 7 ) != 0 )
+	{
+		return idSIMD_SSE::CullBoundsToPlanes( visible, bounds, stride, count, planes, numPlanes, epsilon );
+	}
+	return CullBoundsToPlanes_AVX2( visible, bounds, stride, count, planes, numPlanes, epsilon );
+}
+
+#endif // #if defined(USE_INTRINSICS)
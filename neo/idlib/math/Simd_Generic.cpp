@@ -235,3 +235,39 @@ void VPCALL idSIMD_Generic::UntransformJoints( idJointMat* jointMats, const int*
 		jointMats[i] /= jointMats[parents[i]];
 	}
 }
+
+/*
+============
+idSIMD_Generic::CullBoundsToPlanes
+
+The bounds are stored as six arrays of 'stride' floats: min x, y, z followed by max x, y, z.
+A box is culled when its corner closest to the back of a plane is still more than epsilon
+in front of that plane. The indexes of the boxes that are not culled are written to 'visible'
+and the number of visible boxes is returned.
+============
+*/
+int VPCALL idSIMD_Generic::CullBoundsToPlanes( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon )
+{
+	int numVisible = 0;
+	for( int i = 0; i < count; i++ )
+	{
+		int j;
+		for( j = 0; j < numPlanes; j++ )
+		{
+			const idPlane& plane = planes[j];
+			const float x = bounds[( plane[0] >= 0.0f ? 0 : 3 ) * stride + i];
+			const float y = bounds[( plane[1] >= 0.0f ? 1 : 4 ) * stride + i];
+			const float z = bounds[( plane[2] >= 0.0f ? 2 : 5 ) * stride + i];
+			const float d = plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+			if( d > epsilon )
+			{
+				break;
+			}
+		}
+		if( j == numPlanes )
+		{
+			visible[numVisible++] = i;
+		}
+	}
+	return numVisible;
+}
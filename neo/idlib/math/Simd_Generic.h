@@ -57,6 +57,8 @@ public:
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat* jointQuats, const idJointMat* jointMats, const int numJoints );
 	virtual void VPCALL TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint );
 	virtual void VPCALL UntransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint );
+	
+	virtual int VPCALL CullBoundsToPlanes( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon );
 };
 
 #endif /* !__MATH_SIMD_GENERIC_H__ */
@@ -974,5 +974,59 @@ void VPCALL idSIMD_SSE::UntransformJoints( idJointMat* jointMats, const int* par
 	}
 }
 
+/*
+============
+idSIMD_SSE::CullBoundsToPlanes
+============
+*/
+int VPCALL idSIMD_SSE::CullBoundsToPlanes( int* visible, const float* bounds, const int stride, const int count, const idPlane* planes, const int numPlanes, const float epsilon )
+{
+	assert( ( stride & 3 ) == 0 );
+	assert_16_byte_aligned( bounds );
+	
+	// select the min or max array per axis up front, based on the sign of the plane normal
+	int* offsets = ( int* ) _alloca16( numPlanes * 3 * sizeof( int ) );
+	for( int j = 0; j < numPlanes; j++ )
+	{
+		offsets[j * 3 + 0] = ( planes[j][0] >= 0.0f ? 0 : 3 ) * stride;
+		offsets[j * 3 + 1] = ( planes[j][1] >= 0.0f ? 1 : 4 ) * stride;
+		offsets[j * 3 + 2] = ( planes[j][2] >= 0.0f ? 2 : 5 ) * stride;
+	}
+	
+	const __m128 vector_eps = _mm_set1_ps( epsilon );
+	
+	int numVisible = 0;
+	for( int i = 0; i < count; i += 4 )
+	{
+		__m128 culled = _mm_setzero_ps();
+		for( int j = 0; j < numPlanes; j++ )
+		{
+			const int* o = offsets + j * 3;
+			const __m128 x = _mm_load_ps( bounds + o[0] + i );
+			const __m128 y = _mm_load_ps( bounds + o[1] + i );
+			const __m128 z = _mm_load_ps( bounds + o[2] + i );
+			
+			__m128 d = _mm_mul_ps( _mm_set1_ps( planes[j][0] ), x );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( planes[j][1] ), y ) );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( planes[j][2] ), z ) );
+			d = _mm_add_ps( d, _mm_set1_ps( planes[j][3] ) );
+			
+			culled = _mm_or_ps( culled, _mm_cmpgt_ps( d, vector_eps ) );
+		}
+		
+		// the padding beyond count is never visible
+		const int mask = ~_mm_movemask_ps( culled );
+		const int num = Min( count - i, 4 );
+		for( int k = 0; k < num; k++ )
+		{
+			if( mask & ( 1 << k ) )
+			{
+				visible[numVisible++] = i + k;
+			}
+		}
+	}
+	return numVisible;
+}
+
 #endif // #if defined(USE_INTRINSICS)
 
@@ -60,8 +60,10 @@ If you have questions concerning this license or the applicable additional terms
 // DG end
 #include "../framework/File.h"
 #include "../framework/File_Manifest.h"
+#include "../framework/File_BakeCache.h"
 #include "../framework/File_SaveGame.h"
 #include "../framework/File_Resource.h"
+#include "../framework/File_Async.h"
 #include "../framework/FileSystem.h"
 #include "../framework/UsercmdGen.h"
 #include "../framework/Serializer.h"
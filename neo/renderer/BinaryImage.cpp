@@ -46,12 +46,51 @@ If you have questions concerning this license or the applicable additional terms
 idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "Use high quality (slow) compression" );
 idCVar r_useHighQualitySky( "r_useHighQualitySky", "0", CVAR_BOOL | CVAR_ARCHIVE, "Use high quality skyboxes" );
 
+/*
+========================
+CompressImageBC
+
+BC4 compresses the red channel, BC5 the red and green channels and BC7 all four channels.
+Returns true if the compression continues in child jobs, see idDxtEncoder::CompressImageTiled.
+========================
+*/
+static bool CompressImageBC( textureFormat_t textureFormat, const byte* pic, byte* data, int width, int height, idParallelJobList* jobList = NULL )
+{
+	idDxtEncoder dxt;
+	idDxtEncoder::compressFunction_t compress;
+	int blockBytes = 16;
+	const bool hq = image_highQualityCompression.GetBool();
+	switch( textureFormat )
+	{
+		case FMT_BC4:
+			commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - BC4%s", width, height, hq ? "HQ" : "Fast" ) );
+			compress = hq ? &idDxtEncoder::CompressImageDXN1HQ : &idDxtEncoder::CompressImageDXN1Fast;
+			blockBytes = 8;
+			break;
+		case FMT_BC5:
+			commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - BC5%s", width, height, hq ? "HQ" : "Fast" ) );
+			compress = hq ? &idDxtEncoder::CompressNormalMapDXN2HQ : &idDxtEncoder::CompressNormalMapDXN2Fast;
+			break;
+		case FMT_BC7:
+			commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - BC7%s", width, height, hq ? "HQ" : "Fast" ) );
+			compress = hq ? &idDxtEncoder::CompressImageBC7HQ : &idDxtEncoder::CompressImageBC7Fast;
+			break;
+		default:
+			assert( false );
+			return false;
+	}
+	return dxt.CompressImageTiled( compress, pic, data, width, height, blockBytes, jobList );
+}
+
 /*
 ========================
 idBinaryImage::Load2DFromMemory
+
+Returns true if the compression continues in child jobs of the calling job on jobList, the
+images are complete and FinishCompression can be called once the children are done.
 ========================
 */
-void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips )
+bool idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips, idParallelJobList* jobList )
 {
 	fileData.textureType = TT_2D;
 	fileData.format = textureFormat;
@@ -85,21 +124,27 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 	}
 	else if( colorFormat == CFM_GREEN_ALPHA )
 	{
+		// BC4 only has a red channel
+		const int channel = ( textureFormat == FMT_BC4 ) ? 0 : 1;
 		for( int i = 0; i < width * height; i++ )
 		{
-			pic[i * 4 + 1] = pic[i * 4 + 3];
+			const byte alpha = pic[i * 4 + 3];
 			pic[i * 4 + 0] = 0;
+			pic[i * 4 + 1] = 0;
 			pic[i * 4 + 2] = 0;
 			pic[i * 4 + 3] = 0;
+			pic[i * 4 + channel] = alpha;
 		}
 	}
 	
+	bool compressing = false;
 	int	scaledWidth = width;
 	int scaledHeight = height;
 	images.SetNum( numLevels );
 	for( int level = 0; level < images.Num(); level++ )
 	{
 		idBinaryImageData& img = images[ level ];
+		bool tiled = false;
 		
 		commonLocal.LoadPacifierBinarizeMiplevel( level + 1, numLevels );
 		
@@ -108,7 +153,7 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		byte* dxtPic = pic;
 		int	dxtWidth = 0;
 		int	dxtHeight = 0;
-		if( textureFormat == FMT_DXT5 || textureFormat == FMT_DXT1 )
+		if( idImage::IsCompressedFormat( textureFormat ) )
 		{
 			if( ( scaledWidth & 3 ) || ( scaledHeight & 3 ) )
 			{
@@ -142,13 +187,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 			{
 				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1HQ", width, height ) );
 				
-				dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+				tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT1HQ, dxtPic, img.data, dxtWidth, dxtHeight, 8, jobList );
 			}
 			else
 			{
 				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1Fast", width, height ) );
 				
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+				tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT1Fast, dxtPic, img.data, dxtWidth, dxtHeight, 8, jobList );
 			}
 		}
 		else if( textureFormat == FMT_DXT5 )
@@ -161,13 +206,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5HQ", width, height ) );
 					
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressNormalMapDXT5HQ, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5Fast", width, height ) );
 					
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressNormalMapDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 			}
 			else if( colorFormat == CFM_YCOCG_DXT5 )
@@ -176,13 +221,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5HQ", width, height ) );
 					
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressYCoCgDXT5HQ, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5Fast", width, height ) );
 					
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressYCoCgDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 			}
 			else
@@ -192,16 +237,21 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5HQ", width, height ) );
 					
-					dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT5HQ, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5Fast", width, height ) );
 					
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16, jobList );
 				}
 			}
 		}
+		else if( textureFormat == FMT_BC4 || textureFormat == FMT_BC5 || textureFormat == FMT_BC7 )
+		{
+			img.Alloc( dxtWidth * dxtHeight * BitsForFormat( textureFormat ) / 8 );
+			tiled = CompressImageBC( textureFormat, dxtPic, img.data, dxtWidth, dxtHeight, jobList );
+		}
 		else if( textureFormat == FMT_LUM8 || textureFormat == FMT_INT8 )
 		{
 			// LUM8 and INT8 just read the red channel
@@ -253,9 +303,10 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		// if we had to pad to quads, free the padded version
 		if( pic != dxtPic )
 		{
-			Mem_Free( dxtPic );
+			FreeSource( dxtPic, tiled );
 			dxtPic = NULL;
 		}
+		compressing |= tiled;
 		
 		// downsample for the next level
 		byte* shrunk = NULL;
@@ -267,7 +318,7 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		{
 			shrunk = R_MipMap( pic, scaledWidth, scaledHeight );
 		}
-		Mem_Free( pic );
+		FreeSource( pic, tiled && dxtPic == pic );
 		pic = shrunk;
 		
 		scaledWidth = Max( 1, scaledWidth >> 1 );
@@ -275,6 +326,7 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 	}
 	
 	Mem_Free( pic );
+	return compressing;
 }
 
 /*
@@ -309,9 +361,12 @@ static void PadImageTo4x4( const byte* src, int width, int height, byte dest[64]
 /*
 ========================
 idBinaryImage::LoadCubeFromMemory
+
+Returns true if the compression continues in child jobs like Load2DFromMemory, pics has to stay
+allocated until FinishCompression then.
 ========================
 */
-void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numLevels, textureFormat_t& textureFormat, bool gammaMips )
+bool idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numLevels, textureFormat_t& textureFormat, bool gammaMips, idParallelJobList* jobList )
 {
 	commonLocal.LoadPacifierBinarizeInfo( va( "cube (%d)", width ) );
 	
@@ -323,6 +378,7 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 	
 	images.SetNum( fileData.numLevels * 6 );
 	
+	bool compressing = false;
 	for( int side = 0; side < 6; side++ )
 	{
 		const byte* orig = pics[side];
@@ -340,7 +396,7 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			ALIGN16( byte padBlock[64] );
 			int		padSize;
 			const byte* padSrc;
-			if( scaledWidth < 4 && ( textureFormat == FMT_DXT1 || textureFormat == FMT_DXT5 ) )
+			if( scaledWidth < 4 && idImage::IsCompressedFormat( textureFormat ) )
 			{
 				PadImageTo4x4( pic, scaledWidth, scaledWidth, padBlock );
 				padSize = 4;
@@ -356,17 +412,23 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			img.destZ = side;
 			img.width = padSize;
 			img.height = padSize;
+			bool tiled = false;
 			if( textureFormat == FMT_DXT1 )
 			{
 				img.Alloc( padSize * padSize / 2 );
 				idDxtEncoder dxt;
-				dxt.CompressImageDXT1Fast( padSrc, img.data, padSize, padSize );
+				tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT1Fast, padSrc, img.data, padSize, padSize, 8, jobList );
 			}
 			else if( textureFormat == FMT_DXT5 )
 			{
 				img.Alloc( padSize * padSize );
 				idDxtEncoder dxt;
-				dxt.CompressImageDXT5Fast( padSrc, img.data, padSize, padSize );
+				tiled = dxt.CompressImageTiled( &idDxtEncoder::CompressImageDXT5Fast, padSrc, img.data, padSize, padSize, 16, jobList );
+			}
+			else if( textureFormat == FMT_BC7 )
+			{
+				img.Alloc( padSize * padSize );
+				tiled = CompressImageBC( textureFormat, padSrc, img.data, padSize, padSize, jobList );
 			}
 			else
 			{
@@ -387,9 +449,11 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			}
 			if( pic != orig )
 			{
-				Mem_Free( ( void* )pic );
+				// a padded block is always compressed right away
+				FreeSource( ( void* )pic, tiled );
 				pic = NULL;
 			}
+			compressing |= tiled;
 			pic = shrunk;
 			
 			scaledWidth = Max( 1, scaledWidth >> 1 );
@@ -401,6 +465,138 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			pic = NULL;
 		}
 	}
+	return compressing;
+}
+
+/*
+========================
+idBinaryImage::FreeSource
+
+Frees the data right away, or in FinishCompression if it's the source of a compression that
+runs in child jobs.
+========================
+*/
+void idBinaryImage::FreeSource( void* data, bool compressing )
+{
+	if( compressing )
+	{
+		compressionSources.Append( data );
+	}
+	else
+	{
+		Mem_Free( data );
+	}
+}
+
+/*
+========================
+idBinaryImage::FinishCompression
+
+Frees the sources of the compression once the child jobs that compress them are done.
+========================
+*/
+void idBinaryImage::FinishCompression()
+{
+	for( int i = 0; i < compressionSources.Num(); i++ )
+	{
+		Mem_Free( compressionSources[i] );
+	}
+	compressionSources.Clear();
+}
+
+/*
+========================
+idBinaryImage::TranscodeToBC
+
+DXT5 normal maps become BC5, DXT5 color and CoCg_Y maps become BC7 and DXT1 coverage maps and
+fonts become BC4. The DXT blocks are decoded and compressed again, the BC formats can represent
+the decoded blocks almost exactly, so little is lost. Returns false if the image has no BC
+equivalent.
+========================
+*/
+bool idBinaryImage::TranscodeToBC()
+{
+	const textureFormat_t textureFormat = ( textureFormat_t )fileData.format;
+	const textureColor_t colorFormat = ( textureColor_t )fileData.colorFormat;
+	
+	textureFormat_t newFormat;
+	textureColor_t newColorFormat = colorFormat;
+	if( textureFormat == FMT_DXT5 && colorFormat == CFM_NORMAL_DXT5 )
+	{
+		newFormat = FMT_BC5;
+		newColorFormat = CFM_DEFAULT;
+	}
+	else if( textureFormat == FMT_DXT5 && ( colorFormat == CFM_DEFAULT || colorFormat == CFM_YCOCG_DXT5 ) )
+	{
+		newFormat = FMT_BC7;
+	}
+	else if( textureFormat == FMT_DXT1 && colorFormat == CFM_GREEN_ALPHA )
+	{
+		newFormat = FMT_BC4;
+	}
+	else
+	{
+		return false;
+	}
+	
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		const int dxtWidth = ( images[i].width + 3 ) & ~3;
+		const int dxtHeight = ( images[i].height + 3 ) & ~3;
+		if( images[i].data == NULL || images[i].dataSize < dxtWidth * dxtHeight * BitsForFormat( textureFormat ) / 8 )
+		{
+			return false;
+		}
+	}
+	
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		idBinaryImageData& img = images[ i ];
+		const int dxtWidth = ( img.width + 3 ) & ~3;
+		const int dxtHeight = ( img.height + 3 ) & ~3;
+		
+		byte* pic = ( byte* )Mem_Alloc( dxtWidth * dxtHeight * 4, TAG_TEMP );
+		
+		idDxtDecoder dxt;
+		if( textureFormat == FMT_DXT1 )
+		{
+			// the coverage is in green, BC4 wants it in red
+			dxt.DecompressImageDXT1( img.data, pic, dxtWidth, dxtHeight );
+			for( int j = 0; j < dxtWidth * dxtHeight; j++ )
+			{
+				pic[j * 4 + 0] = pic[j * 4 + 1];
+			}
+		}
+		else if( colorFormat == CFM_NORMAL_DXT5 )
+		{
+			// Nx is in alpha and Ny in green, BC5 wants them in red and green
+			dxt.DecompressImageDXT5( img.data, pic, dxtWidth, dxtHeight );
+			for( int j = 0; j < dxtWidth * dxtHeight; j++ )
+			{
+				pic[j * 4 + 0] = pic[j * 4 + 3];
+			}
+		}
+		else if( colorFormat == CFM_YCOCG_DXT5 )
+		{
+			dxt.DecompressYCoCgDXT5( img.data, pic, dxtWidth, dxtHeight );
+		}
+		else
+		{
+			dxt.DecompressImageDXT5( img.data, pic, dxtWidth, dxtHeight );
+		}
+		
+		img.Alloc( dxtWidth * dxtHeight * BitsForFormat( newFormat ) / 8 );
+		CompressImageBC( newFormat, pic, img.data, dxtWidth, dxtHeight );
+		
+		Mem_Free( pic );
+	}
+	
+	fileData.format = newFormat;
+	fileData.colorFormat = newColorFormat;
+	
+	// none of the images point into the generated file anymore
+	CloseGeneratedFile();
+	return true;
 }
 
 /*
@@ -450,22 +646,116 @@ ID_TIME_T idBinaryImage::WriteGeneratedFile( ID_TIME_T sourceFileTime )
 idBinaryImage::LoadFromGeneratedFile
 
 Load the preprocessed image from the generated folder.
+
+If fileLock is given the file system is only used while holding it, the file is read into
+memory under the lock and parsed without it.
 ==========================
 */
-ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime )
+ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime, idSysMutex* fileLock )
 {
 	idStr binaryFileName;
 	MakeGeneratedFileName( binaryFileName );
-	idFileLocal bFile = fileSystem->OpenFileRead( binaryFileName );
-	if( bFile == NULL )
+	
+	if( fileLock != NULL )
+	{
+		fileLock->Lock();
+	}
+	CloseGeneratedFile();
+	ID_TIME_T fileTime = FILE_NOT_FOUND_TIMESTAMP;
+	generatedFile = fileSystem->OpenFileRead( binaryFileName );
+	if( generatedFile != NULL )
+	{
+		fileTime = generatedFile->Timestamp();
+		if( fileLock != NULL && generatedFile->ReadInPlace( 0 ) == NULL )
+		{
+			idFile_Memory* memFile = new( TAG_IDFILE ) idFile_Memory( binaryFileName );
+			memFile->SetLength( generatedFile->Length() );
+			generatedFile->Read( ( void* )memFile->GetDataPtr(), generatedFile->Length() );
+			memFile->TakeDataOwnership();
+			delete generatedFile;
+			generatedFile = memFile;
+		}
+	}
+	if( fileLock != NULL )
+	{
+		fileLock->Unlock();
+	}
+	
+	if( generatedFile == NULL )
 	{
 		return FILE_NOT_FOUND_TIMESTAMP;
 	}
-	if( LoadFromGeneratedFile( bFile, sourceFileTime ) )
+	ID_TIME_T timeStamp = FILE_NOT_FOUND_TIMESTAMP;
+	if( LoadFromGeneratedFile( generatedFile, sourceFileTime ) )
+	{
+		timeStamp = fileTime;
+	}
+	
+	bool inPlace = false;
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		inPlace |= ( images[i].data != NULL && !images[i].ownsData );
+	}
+	if( !inPlace || timeStamp == FILE_NOT_FOUND_TIMESTAMP )
+	{
+		// closing the file can give a resource buffer back to the file system
+		if( fileLock != NULL )
+		{
+			fileLock->Lock();
+		}
+		CloseGeneratedFile();
+		if( fileLock != NULL )
+		{
+			fileLock->Unlock();
+		}
+	}
+	return timeStamp;
+}
+
+/*
+==========================
+idBinaryImage::~idBinaryImage
+==========================
+*/
+idBinaryImage::~idBinaryImage()
+{
+	FinishCompression();
+	CloseGeneratedFile();
+}
+
+/*
+==========================
+idBinaryImage::Clear
+==========================
+*/
+void idBinaryImage::Clear()
+{
+	FinishCompression();
+	CloseGeneratedFile();
+	images.Clear();
+}
+
+/*
+==========================
+idBinaryImage::CloseGeneratedFile
+==========================
+*/
+void idBinaryImage::CloseGeneratedFile()
+{
+	if( generatedFile == NULL )
+	{
+		return;
+	}
+	// the images may point into the file
+	for( int i = 0; i < images.Num(); i++ )
 	{
-		return bFile->Timestamp();
+		if( !images[i].ownsData )
+		{
+			images[i].Free();
+		}
 	}
-	return FILE_NOT_FOUND_TIMESTAMP;
+	delete generatedFile;
+	generatedFile = NULL;
 }
 
 /*
@@ -531,6 +821,14 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceTimeSt
 		// sizes are still retained, so the stored data size may be larger than
 		// just the multiplication of dimensions
 		assert( img.dataSize >= img.width * img.height * BitsForFormat( ( textureFormat_t )fileData.format ) / 8 );
+		// use the data straight out of the file if it's in memory
+		const byte* inPlaceData = bFile->ReadInPlace( img.dataSize );
+		if( inPlaceData != NULL )
+		{
+			img.SetInPlace( inPlaceData, img.dataSize );
+			continue;
+		}
+		
 		img.Alloc( img.dataSize );
 		if( img.data == NULL )
 		{
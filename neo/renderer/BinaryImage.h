@@ -41,7 +41,8 @@ generation.
 class idBinaryImage
 {
 public:
-	idBinaryImage( const char* name ) : imgName( name ) { }
+	idBinaryImage( const char* name ) : imgName( name ), generatedFile( NULL ) { }
+	~idBinaryImage();
 	
 	const char* 		GetName() const
 	{
@@ -52,18 +53,27 @@ public:
 		imgName = _name;
 	}
 	
-	void				Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips );
-	void				LoadCubeFromMemory( int width, const byte* pics[6], int numLevels, textureFormat_t& textureFormat, bool gammaMips );
+	// with a jobList these are called from a job on that list and return true if the compression continues
+	// in child jobs, the images are only complete in the continuation of the job then
+	bool				Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips, idParallelJobList* jobList = NULL );
+	bool				LoadCubeFromMemory( int width, const byte* pics[6], int numLevels, textureFormat_t& textureFormat, bool gammaMips, idParallelJobList* jobList = NULL );
+	// frees data now, or in FinishCompression if the compression still reads it
+	void				FreeSource( void* data, bool compressing );
+	void				FinishCompression();
+	// converts DXT images to the BC format the binarizer picks with image_useBCCompression
+	bool				TranscodeToBC();
 	
-	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime );
+	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime, idSysMutex* fileLock = NULL );
 	ID_TIME_T			WriteGeneratedFile( ID_TIME_T sourceFileTime );
+	// frees the images and closes the generated file
+	void				Clear();
 	
 	const bimageFile_t& 	GetFileHeader()
 	{
 		return fileData;
 	}
 	
-	int					NumImages()
+	int					NumImages() const
 	{
 		return images.Num();
 	}
@@ -84,8 +94,9 @@ private:
 	{
 	public:
 		byte* data;
+		bool ownsData;		// false if data points into the generated file
 		
-		idBinaryImageData() : data( NULL ) { }
+		idBinaryImageData() : data( NULL ), ownsData( false ) { }
 		~idBinaryImageData()
 		{
 			Free();
@@ -101,11 +112,30 @@ private:
 			memcpy( data, other.data, other.dataSize );
 			return *this;
 		}
+		// used when idList moves the images around
+		idBinaryImageData& operator=( idBinaryImageData&& other )
+		{
+			if( this == &other )
+			{
+				return *this;
+			}
+			
+			Free();
+			bimageImage_t::operator=( other );
+			data = other.data;
+			ownsData = other.ownsData;
+			other.data = NULL;
+			other.dataSize = 0;
+			return *this;
+		}
 		void Free()
 		{
 			if( data != NULL )
 			{
-				Mem_Free( data );
+				if( ownsData )
+				{
+					Mem_Free( data );
+				}
 				data = NULL;
 				dataSize = 0;
 			}
@@ -115,14 +145,28 @@ private:
 			Free();
 			dataSize = size;
 			data = ( byte* )Mem_Alloc( size, TAG_CRAP );
+			ownsData = true;
+		}
+		void SetInPlace( const byte* inPlaceData, int size )
+		{
+			Free();
+			dataSize = size;
+			data = const_cast< byte* >( inPlaceData );
+			ownsData = false;
 		}
 	};
 	
 	idList< idBinaryImageData, TAG_IDLIB_LIST_IMAGE > images;
+	idFile* 			generatedFile;		// kept open while images point into it
+	idList< void*, TAG_IDLIB_LIST_IMAGE > compressionSources;	// read by the compression in child jobs
 	
 private:
 	void				MakeGeneratedFileName( idStr& gfn );
 	bool				LoadFromGeneratedFile( idFile* f, ID_TIME_T sourceFileTime );
+	void				CloseGeneratedFile();
+	
+	idBinaryImage( const idBinaryImage& );
+	void				operator=( const idBinaryImage& );
 };
 
 #endif // __BINARYIMAGE_H__
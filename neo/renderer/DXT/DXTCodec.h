@@ -48,8 +48,9 @@ The supported formats are:
 	* DXT4 = DXT5 + colors are pre-multiplied by alpha
 	* DXT5 = DXT1 + alpha values in 4x4 block approximated by equidistant points on line through alpha space
 	* CTX1 = colors in a 4x4 block approximated by equidistant points on a line through 2D space
-	* DXN1 = one DXT5 alpha block (aka DXT5A, or ATI1N)
-	* DXN2 = two DXT5 alpha blocks (aka 3Dc, or ATI2N)
+	* DXN1 = one DXT5 alpha block (aka DXT5A, ATI1N, or BC4)
+	* DXN2 = two DXT5 alpha blocks (aka 3Dc, ATI2N, or BC5)
+	* BC7  = RGBA colors in a 4x4 block approximated by 16 points on a line through 4D space (mode 6 only)
 ================================================
 */
 class idDxtEncoder
@@ -70,6 +71,17 @@ public:
 		dstPadding = pad;
 	}
 	
+	typedef void ( idDxtEncoder::*compressFunction_t )( const byte* inBuf, byte* outBuf, int width, int height );
+	
+	// compresses bands of 4x4 block rows with any of the functions below in parallel jobs, blockBytes is 8 for
+	// DXT1 and DXN1 and 16 for DXT5, DXN2 and BC7, the result is the same as calling the function for the whole image.
+	// Called from a job on jobList the bands are added as child jobs of the calling job and true is returned, the
+	// result is then only complete once the children are done, so the continuation of the calling job can use it.
+	bool	CompressImageTiled( compressFunction_t compress, const byte* inBuf, byte* outBuf, int width, int height, int blockBytes, idParallelJobList* jobList = NULL );
+	
+	// true if the CPU and OS support the AVX2 encoders
+	static bool	AVX2Available();
+	
 	// high quality DXT1 compression (no alpha), uses exhaustive search to find a line through color space and is very slow
 	void	CompressImageDXT1HQ( const byte* inBuf, byte* outBuf, int width, int height );
 	
@@ -77,6 +89,7 @@ public:
 	void	CompressImageDXT1Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT1Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT1Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageDXT1Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality DXT1 compression (with alpha), uses exhaustive search to find a line through color space and is very slow
 	void	CompressImageDXT1AlphaHQ( const byte* inBuf, byte* outBuf, int width, int height )
@@ -97,6 +110,7 @@ public:
 	void	CompressImageDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT5Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT5Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality CTX1 compression, uses exhaustive search to find a line through 2D space and is very slow
 	void	CompressImageCTX1HQ( const byte* inBuf, byte* outBuf, int width, int height );
@@ -115,19 +129,13 @@ public:
 		/* not implemented */ assert( 0 );
 	}
 	
-	// high quality DXN1 (aka DXT5A or ATI1N) compression, uses exhaustive search to find a line through color space and is very slow
-	void	CompressImageDXN1HQ( const byte* inBuf, byte* outBuf, int width, int height )
-	{
-		/* not implemented */ assert( 0 );
-	}
+	// high quality DXN1 (aka DXT5A or ATI1N) compression of the red channel, uses exhaustive search to find a line through color space and is very slow
+	void	CompressImageDXN1HQ( const byte* inBuf, byte* outBuf, int width, int height );
 	
-	// fast single channel compression into, DXN1 (aka DXT5A or ATI1N) format, for real-time use
+	// fast single channel compression of the red channel into DXN1 (aka DXT5A or ATI1N) format, for real-time use
 	void	CompressImageDXN1Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXN1Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
-	void	CompressImageDXN1Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height )
-	{
-		/* not implemented */ assert( 0 );
-	}
+	void	CompressImageDXN1Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality YCoCg DXT5 compression, uses exhaustive search to find a line through color space and is very slow
 	void	CompressYCoCgDXT5HQ( const byte* inBuf, byte* outBuf, int width, int height );
@@ -136,6 +144,7 @@ public:
 	void	CompressYCoCgDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressYCoCgDXT5Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressYCoCgDXT5Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressYCoCgDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// fast YCoCg-Alpha DXT5 compression for real-time use (the input is expected to be in CoCgAY format)
 	void	CompressYCoCgAlphaDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
@@ -184,10 +193,15 @@ public:
 	// fast tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N) format, for real-time use
 	void	CompressNormalMapDXN2Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressNormalMapDXN2Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
-	void	CompressNormalMapDXN2Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height )
-	{
-		/* not implemented */ assert( 0 );
-	}
+	void	CompressNormalMapDXN2Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	
+	// high quality BC7 compression, refines the endpoints of each block with least squares fits and is slow
+	void	CompressImageBC7HQ( const byte* inBuf, byte* outBuf, int width, int height );
+	
+	// fast BC7 compression, fits a line through the colors of each block along its principal axis, for real-time use
+	void	CompressImageBC7Fast( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageBC7Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageBC7Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// fast single channel conversion from DXN1 (aka DXT5A or ATI1N) to DXT1, reasonably fast (also works in-place)
 	void	ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int width, int height );
@@ -318,7 +332,14 @@ idDxtEncoder::CompressImageDXT1Fast
 ID_INLINE void idDxtEncoder::CompressImageDXT1Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
 #if defined(USE_INTRINSICS)
-	CompressImageDXT1Fast_SSE2( inBuf, outBuf, width, height );
+	if( AVX2Available() )
+	{
+		CompressImageDXT1Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressImageDXT1Fast_SSE2( inBuf, outBuf, width, height );
+	}
 #else
 	CompressImageDXT1Fast_Generic( inBuf, outBuf, width, height );
 #endif
@@ -346,7 +367,14 @@ idDxtEncoder::CompressImageDXT5Fast
 ID_INLINE void idDxtEncoder::CompressImageDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
 #if defined(USE_INTRINSICS)
-	CompressImageDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	if( AVX2Available() )
+	{
+		CompressImageDXT5Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressImageDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	}
 #else
 	CompressImageDXT5Fast_Generic( inBuf, outBuf, width, height );
 #endif
@@ -359,7 +387,11 @@ idDxtEncoder::CompressImageDXN1Fast
 */
 ID_INLINE void idDxtEncoder::CompressImageDXN1Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
+#if defined(USE_INTRINSICS)
+	CompressImageDXN1Fast_SSE2( inBuf, outBuf, width, height );
+#else
 	CompressImageDXN1Fast_Generic( inBuf, outBuf, width, height );
+#endif
 }
 
 /*
@@ -370,7 +402,14 @@ idDxtEncoder::CompressYCoCgDXT5Fast
 ID_INLINE void idDxtEncoder::CompressYCoCgDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
 #if defined(USE_INTRINSICS)
-	CompressYCoCgDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	if( AVX2Available() )
+	{
+		CompressYCoCgDXT5Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressYCoCgDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	}
 #else
 	CompressYCoCgDXT5Fast_Generic( inBuf, outBuf, width, height );
 #endif
@@ -407,7 +446,25 @@ idDxtEncoder::CompressNormalMapDXN2Fast
 */
 ID_INLINE void idDxtEncoder::CompressNormalMapDXN2Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
+#if defined(USE_INTRINSICS)
+	CompressNormalMapDXN2Fast_SSE2( inBuf, outBuf, width, height );
+#else
 	CompressNormalMapDXN2Fast_Generic( inBuf, outBuf, width, height );
+#endif
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Fast
+========================
+*/
+ID_INLINE void idDxtEncoder::CompressImageBC7Fast( const byte* inBuf, byte* outBuf, int width, int height )
+{
+#if defined(USE_INTRINSICS)
+	CompressImageBC7Fast_SSE2( inBuf, outBuf, width, height );
+#else
+	CompressImageBC7Fast_Generic( inBuf, outBuf, width, height );
+#endif
 }
 
 /*
@@ -35,4 +35,12 @@ Contains the DxtEncoder and DxtDecoder declarations.
 */
 #include "precompiled.h"
 
+// the encoders report their progress to the binarize pacifier, tools that run the
+// encoders without the rest of the engine define ID_DXT_NO_PACIFIER
+#if defined( ID_DXT_NO_PACIFIER )
+#define DXT_PACIFIER_PROGRESS( step )
+#else
+#define DXT_PACIFIER_PROGRESS( step )	commonLocal.LoadPacifierBinarizeProgressIncrement( step )
+#endif
+
 #endif // !__DXTCODEC_LOCAL_H__
@@ -2175,7 +2175,7 @@ void idDxtEncoder::CompressImageDXT1HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2257,7 +2257,7 @@ void idDxtEncoder::CompressImageDXT5HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2357,7 +2357,7 @@ void idDxtEncoder::CompressImageCTX1HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2812,7 +2812,7 @@ void idDxtEncoder::CompressYCoCgDXT5HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			ScaleYCoCg( block );
@@ -2919,7 +2919,7 @@ void idDxtEncoder::CompressYCoCgCTX1DXT5AHQ( const byte* inBuf, byte* outBuf, in
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3068,7 +3068,7 @@ void idDxtEncoder::CompressNormalMapDXT1HQ( const byte* inBuf, byte* outBuf, int
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3138,7 +3138,7 @@ void idDxtEncoder::CompressNormalMapDXT1RenormalizeHQ( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3395,7 +3395,7 @@ void idDxtEncoder::CompressNormalMapDXT5HQ( const byte* inBuf, byte* outBuf, int
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3507,7 +3507,7 @@ void idDxtEncoder::CompressNormalMapDXT5RenormalizeHQ( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3586,7 +3586,7 @@ void idDxtEncoder::CompressNormalMapDXN2HQ( const byte* inBuf, byte* outBuf, int
 	
 	if( width < 4 || height < 4 )
 	{
-		WriteTinyColorDXT5( inBuf, width, height );
+		WriteTinyNormalMapDXN( inBuf, width, height );
 		return;
 	}
 	
@@ -3594,7 +3594,7 @@ void idDxtEncoder::CompressNormalMapDXN2HQ( const byte* inBuf, byte* outBuf, int
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3642,6 +3642,70 @@ void idDxtEncoder::CompressNormalMapDXN2HQ( const byte* inBuf, byte* outBuf, int
 	//idLib::Printf( "\r100%%\n" );
 }
 
+/*
+========================
+idDxtEncoder::CompressImageDXN1HQ
+
+params:	inBuf		- image to compress, only the red channel is used
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXN1HQ( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	ALIGN16( byte block[64] );
+	byte alphaIndices1[6];
+	byte alphaIndices2[6];
+	byte col1[4];
+	byte col2[4];
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	if( width > 4 && ( width & 3 ) != 0 )
+	{
+		return;
+	}
+	if( height > 4 && ( height & 3 ) != 0 )
+	{
+		return;
+	}
+	
+	if( width < 4 || height < 4 )
+	{
+		WriteTinyDXT5A( inBuf, width, height );
+		return;
+	}
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		for( int i = 0; i < width; i += 4 )
+		{
+			DXT_PACIFIER_PROGRESS( 16 );
+			
+			ExtractBlock( inBuf + i * 4, width, block );
+			
+			GetMinMaxAlphaHQ( block, 0, col1, col2 );
+			
+			// try both orders of the end points, the 6 value mode is used when the first one is smaller
+			int error1 = FindAlphaIndices( block, 0, col1[0], col2[0], alphaIndices1 );
+			int error2 = FindAlphaIndices( block, 0, col2[0], col1[0], alphaIndices2 );
+			
+			const byte* alphaIndices = ( error1 < error2 ) ? alphaIndices1 : alphaIndices2;
+			EmitByte( ( error1 < error2 ) ? col1[0] : col2[0] );
+			EmitByte( ( error1 < error2 ) ? col2[0] : col1[0] );
+			for( int k = 0; k < 6; k++ )
+			{
+				EmitByte( alphaIndices[k] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
 /*
 ========================
 idDxtEncoder::GetMinMaxBBox
@@ -4356,7 +4420,7 @@ void idDxtEncoder::CompressImageDXT1Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4401,7 +4465,7 @@ void idDxtEncoder::CompressImageDXT1AlphaFast_Generic( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4455,7 +4519,7 @@ void idDxtEncoder::CompressImageDXT5Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4779,7 +4843,7 @@ void idDxtEncoder::CompressYCoCgDXT5Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4834,7 +4898,7 @@ void idDxtEncoder::CompressYCoCgAlphaDXT5Fast( const byte* inBuf, byte* outBuf,
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4902,7 +4966,7 @@ void idDxtEncoder::CompressYCoCgCTX1DXT5AFast_Generic( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5096,7 +5160,7 @@ void idDxtEncoder::CompressNormalMapDXT5Fast_Generic( const byte* inBuf, byte* o
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5145,7 +5209,7 @@ void idDxtEncoder::CompressImageDXN1Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5189,7 +5253,7 @@ void idDxtEncoder::CompressNormalMapDXN2Fast_Generic( const byte* inBuf, byte* o
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5352,7 +5416,7 @@ void idDxtEncoder::ConvertNormalMapDXN2_DXT5( const byte* inBuf, byte* outBuf, i
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 16, outBuf += 16 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			// decode normal Y stored as a DXT5 alpha channel
 			DecodeDXNAlphaValues( inBuf + 0, values );
@@ -5504,7 +5568,7 @@ void idDxtEncoder::ConvertNormalMapDXT5_DXN2( const byte* inBuf, byte* outBuf, i
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 16, outBuf += 16 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			// decode normal Y stored as a DXT5 alpha channel
 			DecodeNormalYValues( inBuf + 8, minNormalY, maxNormalY, values );
@@ -5556,7 +5620,7 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int w
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 8, outBuf += 8 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement( 16 );
+			DXT_PACIFIER_PROGRESS( 16 );
 			
 			// decode single channel stored as a DXT5 alpha channel
 			DecodeDXNAlphaValues( inBuf + 0, values );
@@ -5583,3 +5647,136 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int w
 		inBuf += srcPadding;
 	}
 }
+
+/*
+================================================================================================
+
+	Tiled compression
+
+================================================================================================
+*/
+
+static const int DXT_TILE_MIN_BLOCKS	= 256;		// 64x64 pixels, smaller tiles aren't worth a job
+static const int DXT_MAX_TILES			= 64;
+
+struct dxtTile_t
+{
+	idDxtEncoder::compressFunction_t	compress;
+	const byte* 						inBuf;
+	byte* 								outBuf;
+	int									width;
+	int									height;
+	int									srcPadding;
+	int									dstPadding;
+	bool								childJob;		// allocated for a child job, freed by the job
+};
+
+/*
+========================
+DxtCompressTileJob
+========================
+*/
+static void DxtCompressTileJob( dxtTile_t* tile )
+{
+	idDxtEncoder encoder;
+	encoder.SetSrcPadding( tile->srcPadding );
+	encoder.SetDstPadding( tile->dstPadding );
+	( encoder.*tile->compress )( tile->inBuf, tile->outBuf, tile->width, tile->height );
+	if( tile->childJob )
+	{
+		delete tile;
+	}
+}
+
+REGISTER_PARALLEL_JOB( DxtCompressTileJob, "DxtCompressTileJob" );
+
+/*
+========================
+idDxtEncoder::CompressImageTiled
+
+Every 4x4 block is compressed on its own, so the image is split into bands of whole block rows
+that are compressed by separate encoders in parallel jobs. Small images are compressed right away.
+
+On the main thread the bands run on a job list of their own and are done on return. The image
+loads and bakes compress in jobs, a job can't wait for other jobs, so they pass the job list they
+run on and the bands become child jobs of the calling job. Returns true in that case, the input
+has to stay allocated and the output can only be used by the continuation of the calling job.
+Off the main thread without a job list the image is compressed right away.
+
+params:	compress	- encoder function
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+params:	blockBytes	- size of a compressed 4x4 block
+params:	jobList		- job list of the calling job or NULL
+========================
+*/
+bool idDxtEncoder::CompressImageTiled( compressFunction_t compress, const byte* inBuf, byte* outBuf, int width, int height, int blockBytes, idParallelJobList* jobList )
+{
+	const int blocksWide = width / 4;
+	const int blocksHigh = height / 4;
+	
+	int rowsPerTile = 0;
+	int numTiles = 0;
+	if( blocksWide > 0 && ( width & 3 ) == 0 && ( height & 3 ) == 0 )
+	{
+		rowsPerTile = Max( ( DXT_TILE_MIN_BLOCKS + blocksWide - 1 ) / blocksWide, ( blocksHigh + DXT_MAX_TILES - 1 ) / DXT_MAX_TILES );
+		numTiles = ( blocksHigh + rowsPerTile - 1 ) / rowsPerTile;
+	}
+	
+	if( numTiles < 2 || ( jobList == NULL && !idLib::IsMainThread() ) )
+	{
+		( this->*compress )( inBuf, outBuf, width, height );
+		return false;
+	}
+	
+	const int srcRowBytes = width * 4 * 4 + srcPadding;
+	const int dstRowBytes = blocksWide * blockBytes + dstPadding;
+	
+	if( jobList != NULL )
+	{
+		for( int row = 0; row < blocksHigh; row += rowsPerTile )
+		{
+			dxtTile_t* tile = new( TAG_IMAGE ) dxtTile_t;
+			tile->compress = compress;
+			tile->inBuf = inBuf + row * srcRowBytes;
+			tile->outBuf = outBuf + row * dstRowBytes;
+			tile->width = width;
+			tile->height = Min( rowsPerTile, blocksHigh - row ) * 4;
+			tile->srcPadding = srcPadding;
+			tile->dstPadding = dstPadding;
+			tile->childJob = true;
+			jobList->AddChildJob( ( jobRun_t )DxtCompressTileJob, tile );
+		}
+	}
+	else
+	{
+		idStaticList< dxtTile_t, DXT_MAX_TILES > tiles;
+		idParallelJobList* tileJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numTiles, 0, NULL );
+		for( int row = 0; row < blocksHigh; row += rowsPerTile )
+		{
+			dxtTile_t& tile = *tiles.Alloc();
+			tile.compress = compress;
+			tile.inBuf = inBuf + row * srcRowBytes;
+			tile.outBuf = outBuf + row * dstRowBytes;
+			tile.width = width;
+			tile.height = Min( rowsPerTile, blocksHigh - row ) * 4;
+			tile.srcPadding = srcPadding;
+			tile.dstPadding = dstPadding;
+			tile.childJob = false;
+			tileJobList->AddJob( ( jobRun_t )DxtCompressTileJob, &tile );
+		}
+		tileJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		tileJobList->Wait();
+		parallelJobManager->FreeJobList( tileJobList );
+		
+		// the encoders only report their progress on the main thread
+		DXT_PACIFIER_PROGRESS( width * height );
+	}
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf + blocksHigh * dstRowBytes;
+	return ( jobList != NULL );
+}
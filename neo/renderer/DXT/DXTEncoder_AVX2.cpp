@@ -0,0 +1,999 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+#include "framework/Common_local.h"
+#include "DXTCodec_local.h"
+#include "DXTCodec.h"
+
+/*
+================================================================================================
+
+	AVX2 fast encoders
+
+	These are the SSE2 fast encoders with every 128 bit operation widened to 256 bits. The AVX2
+	integer instructions work on the two 128 bit lanes separately, so the lower lane encodes a
+	4x4 block and the upper lane the block to the right of it with exactly the same instructions
+	as the SSE2 code, and the output is identical. The rest of the engine is compiled for SSE2 so
+	the code is enabled per function and only used when the CPU reports AVX2.
+
+================================================================================================
+*/
+
+/*
+========================
+idDxtEncoder::AVX2Available
+========================
+*/
+bool idDxtEncoder::AVX2Available()
+{
+#if defined(USE_INTRINSICS)
+	static int available = -1;
+	if( available < 0 )
+	{
+		available = ( idLib::sys->GetProcessorId() & CPUID_AVX2 ) != 0;
+	}
+	return available != 0;
+#else
+	return false;
+#endif
+}
+
+#if defined(USE_INTRINSICS)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_FUNC	__attribute__(( target( "avx2" ) ))
+#else
+#define AVX2_FUNC
+#endif
+
+#define INSET_COLOR_SHIFT		4		// inset the bounding box with ( range >> shift )
+#define INSET_ALPHA_SHIFT		5		// inset alpha channel
+
+#define C565_5_MASK				0xF8	// 0xFF minus last three bits
+#define C565_6_MASK				0xFC	// 0xFF minus last two bits
+
+#define NVIDIA_7X_HARDWARE_BUG_FIX		// keep the DXT5 colors sorted as: max, min
+
+#if !defined( R_SHUFFLE_D )
+#define R_SHUFFLE_D( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
+#endif
+
+// _mm_shuffle_ps on integer registers, used to combine the halves of two registers
+#define SHUFFLE_PS_AVX2( a, b, imm )	_mm256_castps_si256( _mm256_shuffle_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ), imm ) )
+
+/*
+========================
+Lanes_AVX2
+
+The same 128 bit constant in both lanes.
+========================
+*/
+static AVX2_FUNC ID_INLINE __m256i Lanes_AVX2( const __m128i v )
+{
+	return _mm256_inserti128_si256( _mm256_castsi128_si256( v ), v, 1 );
+}
+
+/*
+========================
+FirstDword_AVX2
+
+Clears everything but the first dword of each lane, like _mm_cvtsi32_si128 on the result of
+_mm_cvtsi128_si32 does in the SSE2 code.
+========================
+*/
+static AVX2_FUNC ID_INLINE __m256i FirstDword_AVX2( const __m256i v )
+{
+	return _mm256_and_si256( v, _mm256_setr_epi32( -1, 0, 0, 0, -1, 0, 0, 0 ) );
+}
+
+/*
+========================
+ColorTo565_AVX2
+========================
+*/
+static ID_INLINE unsigned short ColorTo565_AVX2( const unsigned int color )
+{
+	return ( ( ( color >> 3 ) & 0x1F ) << 11 ) | ( ( ( color >> 10 ) & 0x3F ) << 5 ) | ( ( color >> 19 ) & 0x1F );
+}
+
+/*
+========================
+LoadBlocks_AVX2
+
+Loads two horizontally adjacent 4x4 blocks, or a single block into both lanes.
+========================
+*/
+static AVX2_FUNC ID_INLINE void LoadBlocks_AVX2( const byte* inPtr, int width, int numBlocks, __m256i block[4] )
+{
+	if( numBlocks == 2 )
+	{
+		block[0] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 0 ) );
+		block[1] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 1 ) );
+		block[2] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 2 ) );
+		block[3] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 3 ) );
+	}
+	else
+	{
+		block[0] = Lanes_AVX2( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 0 ) ) );
+		block[1] = Lanes_AVX2( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 1 ) ) );
+		block[2] = Lanes_AVX2( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 2 ) ) );
+		block[3] = Lanes_AVX2( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 3 ) ) );
+	}
+}
+
+/*
+========================
+GetMinMaxBBox_AVX2
+========================
+*/
+static AVX2_FUNC ID_INLINE void GetMinMaxBBox_AVX2( const __m256i block[4], __m256i& minColor, __m256i& maxColor )
+{
+	__m256i max1 = _mm256_max_epu8( block[0], block[1] );
+	__m256i min1 = _mm256_min_epu8( block[0], block[1] );
+	__m256i max2 = _mm256_max_epu8( block[2], block[3] );
+	__m256i min2 = _mm256_min_epu8( block[2], block[3] );
+	
+	__m256i max3 = _mm256_max_epu8( max1, max2 );
+	__m256i min3 = _mm256_min_epu8( min1, min2 );
+	
+	__m256i max4 = _mm256_shuffle_epi32( max3, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	__m256i min4 = _mm256_shuffle_epi32( min3, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	
+	__m256i max5 = _mm256_max_epu8( max3, max4 );
+	__m256i min5 = _mm256_min_epu8( min3, min4 );
+	
+	__m256i max6 = _mm256_shufflelo_epi16( max5, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	__m256i min6 = _mm256_shufflelo_epi16( min5, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	
+	maxColor = FirstDword_AVX2( _mm256_max_epu8( max5, max6 ) );
+	minColor = FirstDword_AVX2( _mm256_min_epu8( min5, min6 ) );
+}
+
+/*
+========================
+InsetColorsBBox_AVX2
+========================
+*/
+static AVX2_FUNC ID_INLINE void InsetColorsBBox_AVX2( __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i insetShift = Lanes_AVX2( _mm_setr_epi16( 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0 ) );
+	
+	__m256i xmm0 = _mm256_unpacklo_epi8( minColor, zero );
+	__m256i xmm1 = _mm256_unpacklo_epi8( maxColor, zero );
+	
+	__m256i xmm2 = _mm256_sub_epi16( xmm1, xmm0 );
+	
+	xmm2 = _mm256_mulhi_epi16( xmm2, insetShift );
+	
+	xmm0 = _mm256_add_epi16( xmm0, xmm2 );
+	xmm1 = _mm256_sub_epi16( xmm1, xmm2 );
+	
+	minColor = FirstDword_AVX2( _mm256_packus_epi16( xmm0, xmm0 ) );
+	maxColor = FirstDword_AVX2( _mm256_packus_epi16( xmm1, xmm1 ) );
+}
+
+/*
+========================
+ColorIndices_AVX2
+
+Returns the color indices of each block in the first dword of its lane.
+========================
+*/
+static AVX2_FUNC ID_INLINE __m256i ColorIndices_AVX2( const __m256i block[4], const __m256i minColor, const __m256i maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i colorMask = _mm256_set1_epi64x( ( C565_5_MASK << 16 ) | ( C565_6_MASK << 8 ) | C565_5_MASK );
+	const __m256i div_by_3 = _mm256_set1_epi16( ( 1 << 16 ) / 3 + 1 );
+	const __m256i word_1 = _mm256_set1_epi16( 1 );
+	const __m256i word_2 = _mm256_set1_epi16( 2 );
+	__m256i result = zero;
+	__m256i color0, color1, color2, color3;
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+	__m256i blocka[2], blockb[2];
+	blocka[0] = block[0];
+	blocka[1] = block[2];
+	blockb[0] = block[1];
+	blockb[1] = block[3];
+	
+	temp0 = _mm256_and_si256( maxColor, colorMask );
+	temp0 = _mm256_unpacklo_epi8( temp0, zero );
+	temp4 = _mm256_shufflelo_epi16( temp0, R_SHUFFLE_D( 0, 3, 2, 3 ) );
+	temp5 = _mm256_shufflelo_epi16( temp0, R_SHUFFLE_D( 3, 1, 3, 3 ) );
+	temp4 = _mm256_srli_epi16( temp4, 5 );
+	temp5 = _mm256_srli_epi16( temp5, 6 );
+	temp0 = _mm256_or_si256( temp0, temp4 );
+	temp0 = _mm256_or_si256( temp0, temp5 );
+	
+	temp1 = _mm256_and_si256( minColor, colorMask );
+	temp1 = _mm256_unpacklo_epi8( temp1, zero );
+	temp4 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 0, 3, 2, 3 ) );
+	temp5 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 3, 1, 3, 3 ) );
+	temp4 = _mm256_srli_epi16( temp4, 5 );
+	temp5 = _mm256_srli_epi16( temp5, 6 );
+	temp1 = _mm256_or_si256( temp1, temp4 );
+	temp1 = _mm256_or_si256( temp1, temp5 );
+	
+	temp2 = _mm256_packus_epi16( temp0, zero );
+	color0 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp6 = _mm256_add_epi16( temp0, temp0 );
+	temp6 = _mm256_add_epi16( temp6, temp1 );
+	temp6 = _mm256_mulhi_epi16( temp6, div_by_3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp6 = _mm256_packus_epi16( temp6, zero );
+	color2 = _mm256_shuffle_epi32( temp6, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp3 = _mm256_packus_epi16( temp1, zero );
+	color1 = _mm256_shuffle_epi32( temp3, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp1 = _mm256_add_epi16( temp1, temp1 );
+	temp0 = _mm256_add_epi16( temp0, temp1 );
+	temp0 = _mm256_mulhi_epi16( temp0, div_by_3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp0 = _mm256_packus_epi16( temp0, zero );
+	color3 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	for( int i = 1; i >= 0; i-- )
+	{
+		// Load block
+		temp3 = _mm256_shuffle_epi32( blocka[i], R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = SHUFFLE_PS_AVX2( blocka[i], zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		
+		temp0 = _mm256_sad_epu8( temp3, color0 );
+		temp6 = _mm256_sad_epu8( temp5, color0 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );
+		
+		temp1 = _mm256_sad_epu8( temp3, color1 );
+		temp6 = _mm256_sad_epu8( temp5, color1 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );
+		
+		temp2 = _mm256_sad_epu8( temp3, color2 );
+		temp6 = _mm256_sad_epu8( temp5, color2 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );
+		
+		temp3 = _mm256_sad_epu8( temp3, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp3 = _mm256_packs_epi32( temp3, temp5 );
+		
+		// Load block
+		temp4 = _mm256_shuffle_epi32( blockb[i], R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = SHUFFLE_PS_AVX2( blockb[i], zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		
+		temp6 = _mm256_sad_epu8( temp4, color0 );
+		temp7 = _mm256_sad_epu8( temp5, color0 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );	// d0
+		
+		temp6 = _mm256_sad_epu8( temp4, color1 );
+		temp7 = _mm256_sad_epu8( temp5, color1 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );	// d1
+		
+		temp6 = _mm256_sad_epu8( temp4, color2 );
+		temp7 = _mm256_sad_epu8( temp5, color2 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );	// d2
+		
+		temp4 = _mm256_sad_epu8( temp4, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp4 = _mm256_packs_epi32( temp4, temp5 );
+		temp3 = _mm256_packs_epi32( temp3, temp4 );	// d3
+		
+		temp7 = _mm256_slli_epi32( result, 16 );
+		
+		temp4 = _mm256_cmpgt_epi16( temp0, temp2 );	// b2
+		temp5 = _mm256_cmpgt_epi16( temp1, temp3 );	// b3
+		temp0 = _mm256_cmpgt_epi16( temp0, temp3 );	// b0
+		temp1 = _mm256_cmpgt_epi16( temp1, temp2 );	// b1
+		temp2 = _mm256_cmpgt_epi16( temp2, temp3 );	// b4
+		
+		temp4 = _mm256_and_si256( temp4, temp1 );		// x0
+		temp5 = _mm256_and_si256( temp5, temp0 );		// x1
+		temp2 = _mm256_and_si256( temp2, temp0 );		// x2
+		temp4 = _mm256_or_si256( temp4, temp5 );
+		temp2 = _mm256_and_si256( temp2, word_1 );
+		temp4 = _mm256_and_si256( temp4, word_2 );
+		temp2 = _mm256_or_si256( temp2, temp4 );
+		
+		temp5 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp2 = _mm256_unpacklo_epi16( temp2, zero );
+		temp5 = _mm256_unpacklo_epi16( temp5, zero );
+		temp5 = _mm256_slli_epi32( temp5, 8 );
+		temp7 = _mm256_or_si256( temp7, temp5 );
+		result = _mm256_or_si256( temp7, temp2 );
+	}
+	
+	temp4 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 1, 2, 3, 0 ) );
+	temp5 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+	temp6 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 3, 0, 1, 2 ) );
+	temp4 = _mm256_slli_epi32( temp4, 2 );
+	temp5 = _mm256_slli_epi32( temp5, 4 );
+	temp6 = _mm256_slli_epi32( temp6, 6 );
+	temp7 = _mm256_or_si256( result, temp4 );
+	temp7 = _mm256_or_si256( temp7, temp5 );
+	temp7 = _mm256_or_si256( temp7, temp6 );
+	
+	return temp7;
+}
+
+/*
+========================
+CoCgIndices_AVX2
+
+Returns the CoCg indices of each block in the first dword of its lane.
+========================
+*/
+static AVX2_FUNC ID_INLINE __m256i CoCgIndices_AVX2( const __m256i block[4], const __m256i minColor, const __m256i maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i colorMask2 = _mm256_set1_epi64x( 0x00FFFFFF );
+	const __m256i div_by_3 = _mm256_set1_epi16( ( 1 << 16 ) / 3 + 1 );
+	const __m256i word_1 = _mm256_set1_epi16( 1 );
+	const __m256i word_2 = _mm256_set1_epi16( 2 );
+	__m256i result = zero;
+	__m256i color0, color1, color2, color3;
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+	__m256i blocka[2], blockb[2];
+	blocka[0] = block[0];
+	blocka[1] = block[2];
+	blockb[0] = block[1];
+	blockb[1] = block[3];
+	
+	temp0 = _mm256_and_si256( maxColor, colorMask2 );
+	color0 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp1 = _mm256_and_si256( minColor, colorMask2 );
+	color1 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp0 = _mm256_unpacklo_epi8( color0, zero );
+	temp1 = _mm256_unpacklo_epi8( color1, zero );
+	
+	temp6 = _mm256_add_epi16( temp1, temp0 );
+	temp0 = _mm256_add_epi16( temp0, temp6 );
+	temp0 = _mm256_mulhi_epi16( temp0, div_by_3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp0 = _mm256_packus_epi16( temp0, zero );
+	color2 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	temp1 = _mm256_add_epi16( temp1, temp6 );
+	temp1 = _mm256_mulhi_epi16( temp1, div_by_3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp1 = _mm256_packus_epi16( temp1, zero );
+	color3 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+	
+	for( int i = 1; i >= 0; i-- )
+	{
+		// Load block
+		temp3 = _mm256_shuffle_epi32( blocka[i], R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = SHUFFLE_PS_AVX2( blocka[i], zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		
+		temp0 = _mm256_sad_epu8( temp3, color0 );
+		temp6 = _mm256_sad_epu8( temp5, color0 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );
+		
+		temp1 = _mm256_sad_epu8( temp3, color1 );
+		temp6 = _mm256_sad_epu8( temp5, color1 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );
+		
+		temp2 = _mm256_sad_epu8( temp3, color2 );
+		temp6 = _mm256_sad_epu8( temp5, color2 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );
+		
+		temp3 = _mm256_sad_epu8( temp3, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp3 = _mm256_packs_epi32( temp3, temp5 );
+		
+		// Load block
+		temp4 = _mm256_shuffle_epi32( blockb[i], R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = SHUFFLE_PS_AVX2( blockb[i], zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		
+		temp6 = _mm256_sad_epu8( temp4, color0 );
+		temp7 = _mm256_sad_epu8( temp5, color0 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );	// d0
+		
+		temp6 = _mm256_sad_epu8( temp4, color1 );
+		temp7 = _mm256_sad_epu8( temp5, color1 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );	// d1
+		
+		temp6 = _mm256_sad_epu8( temp4, color2 );
+		temp7 = _mm256_sad_epu8( temp5, color2 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );	// d2
+		
+		temp4 = _mm256_sad_epu8( temp4, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp4 = _mm256_packs_epi32( temp4, temp5 );
+		temp3 = _mm256_packs_epi32( temp3, temp4 );	// d3
+		
+		temp7 = _mm256_slli_epi32( result, 16 );
+		
+		temp4 = _mm256_cmpgt_epi16( temp0, temp2 );	// b2
+		temp5 = _mm256_cmpgt_epi16( temp1, temp3 );	// b3
+		temp0 = _mm256_cmpgt_epi16( temp0, temp3 );	// b0
+		temp1 = _mm256_cmpgt_epi16( temp1, temp2 );	// b1
+		temp2 = _mm256_cmpgt_epi16( temp2, temp3 );	// b4
+		temp4 = _mm256_and_si256( temp4, temp1 );		// x0
+		temp5 = _mm256_and_si256( temp5, temp0 );		// x1
+		temp2 = _mm256_and_si256( temp2, temp0 );		// x2
+		temp4 = _mm256_or_si256( temp4, temp5 );
+		temp2 = _mm256_and_si256( temp2, word_1 );
+		temp4 = _mm256_and_si256( temp4, word_2 );
+		temp2 = _mm256_or_si256( temp2, temp4 );
+		
+		temp5 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp2 = _mm256_unpacklo_epi16( temp2, zero );
+		temp5 = _mm256_unpacklo_epi16( temp5, zero );
+		temp5 = _mm256_slli_epi32( temp5, 8 );
+		temp7 = _mm256_or_si256( temp7, temp5 );
+		result = _mm256_or_si256( temp7, temp2 );
+	}
+	
+	temp4 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 1, 2, 3, 0 ) );
+	temp5 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+	temp6 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 3, 0, 1, 2 ) );
+	temp4 = _mm256_slli_epi32( temp4, 2 );
+	temp5 = _mm256_slli_epi32( temp5, 4 );
+	temp6 = _mm256_slli_epi32( temp6, 6 );
+	temp7 = _mm256_or_si256( result, temp4 );
+	temp7 = _mm256_or_si256( temp7, temp5 );
+	temp7 = _mm256_or_si256( temp7, temp6 );
+	
+	return temp7;
+}
+
+/*
+========================
+AlphaIndices_AVX2
+
+Returns the 3 byte halves of the alpha indices of each block in the first and third dword of
+its lane. The alpha range is in the last byte of minColor and maxColor.
+========================
+*/
+static AVX2_FUNC ID_INLINE __m256i AlphaIndices_AVX2( const __m256i block[4], const __m256i minColor, const __m256i maxColor )
+{
+	const __m256i scale_7_9_11_13 = Lanes_AVX2( _mm_setr_epi16( 7, 7, 9, 9, 11, 11, 13, 13 ) );
+	const __m256i scale_7_5_3_1 = Lanes_AVX2( _mm_setr_epi16( 7, 7, 5, 5, 3, 3, 1, 1 ) );
+	const __m256i word_7 = _mm256_set1_epi16( 7 );
+	const __m256i div_by_14 = _mm256_set1_epi16( ( 1 << 16 ) / 14 + 1 );
+	const __m256i byte_1 = _mm256_set1_epi8( 1 );
+	const __m256i byte_2 = _mm256_set1_epi8( 2 );
+	const __m256i byte_7 = _mm256_set1_epi8( 7 );
+	const __m256i byte_8 = _mm256_set1_epi8( 8 );
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+	
+	temp0 = _mm256_srli_epi32( block[0], 24 );
+	temp5 = _mm256_srli_epi32( block[1], 24 );
+	temp6 = _mm256_srli_epi32( block[2], 24 );
+	temp4 = _mm256_srli_epi32( block[3], 24 );
+	
+	temp0 = _mm256_packus_epi16( temp0, temp5 );
+	temp6 = _mm256_packus_epi16( temp6, temp4 );
+	
+	//---------------------
+	
+	// ab0 = (  7 * maxAlpha +  7 * minAlpha + ALPHA_RANGE ) / 14
+	// ab3 = (  9 * maxAlpha +  5 * minAlpha + ALPHA_RANGE ) / 14
+	// ab2 = ( 11 * maxAlpha +  3 * minAlpha + ALPHA_RANGE ) / 14
+	// ab1 = ( 13 * maxAlpha +  1 * minAlpha + ALPHA_RANGE ) / 14
+	
+	// ab4 = (  7 * maxAlpha +  7 * minAlpha + ALPHA_RANGE ) / 14
+	// ab5 = (  5 * maxAlpha +  9 * minAlpha + ALPHA_RANGE ) / 14
+	// ab6 = (  3 * maxAlpha + 11 * minAlpha + ALPHA_RANGE ) / 14
+	// ab7 = (  1 * maxAlpha + 13 * minAlpha + ALPHA_RANGE ) / 14
+	
+	temp5 = _mm256_srli_epi32( maxColor, 24 );
+	temp5 = _mm256_shufflelo_epi16( temp5, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	
+	temp2 = _mm256_srli_epi32( minColor, 24 );
+	temp2 = _mm256_shufflelo_epi16( temp2, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp2 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	
+	temp7 = _mm256_mullo_epi16( temp5, scale_7_5_3_1 );
+	temp5 = _mm256_mullo_epi16( temp5, scale_7_9_11_13 );
+	temp3 = _mm256_mullo_epi16( temp2, scale_7_9_11_13 );
+	temp2 = _mm256_mullo_epi16( temp2, scale_7_5_3_1 );
+	
+	temp5 = _mm256_add_epi16( temp5, temp2 );
+	temp7 = _mm256_add_epi16( temp7, temp3 );
+	
+	temp5 = _mm256_add_epi16( temp5, word_7 );
+	temp7 = _mm256_add_epi16( temp7, word_7 );
+	
+	temp5 = _mm256_mulhi_epi16( temp5, div_by_14 );
+	temp7 = _mm256_mulhi_epi16( temp7, div_by_14 );
+	
+	temp1 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 3, 3, 3, 3 ) );
+	temp2 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 2, 2, 2, 2 ) );
+	temp3 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 1, 1, 1, 1 ) );
+	temp1 = _mm256_packus_epi16( temp1, temp1 );
+	temp2 = _mm256_packus_epi16( temp2, temp2 );
+	temp3 = _mm256_packus_epi16( temp3, temp3 );
+	
+	temp0 = _mm256_packus_epi16( temp0, temp6 );
+	
+	temp4 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp5 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 1, 1, 1, 1 ) );
+	temp6 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 2, 2, 2, 2 ) );
+	temp7 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 3, 3, 3, 3 ) );
+	temp4 = _mm256_packus_epi16( temp4, temp4 );
+	temp5 = _mm256_packus_epi16( temp5, temp5 );
+	temp6 = _mm256_packus_epi16( temp6, temp6 );
+	temp7 = _mm256_packus_epi16( temp7, temp7 );
+	
+	temp1 = _mm256_max_epu8( temp1, temp0 );
+	temp2 = _mm256_max_epu8( temp2, temp0 );
+	temp3 = _mm256_max_epu8( temp3, temp0 );
+	temp1 = _mm256_cmpeq_epi8( temp1, temp0 );
+	temp2 = _mm256_cmpeq_epi8( temp2, temp0 );
+	temp3 = _mm256_cmpeq_epi8( temp3, temp0 );
+	temp4 = _mm256_max_epu8( temp4, temp0 );
+	temp5 = _mm256_max_epu8( temp5, temp0 );
+	temp6 = _mm256_max_epu8( temp6, temp0 );
+	temp7 = _mm256_max_epu8( temp7, temp0 );
+	temp4 = _mm256_cmpeq_epi8( temp4, temp0 );
+	temp5 = _mm256_cmpeq_epi8( temp5, temp0 );
+	temp6 = _mm256_cmpeq_epi8( temp6, temp0 );
+	temp7 = _mm256_cmpeq_epi8( temp7, temp0 );
+	temp0 = _mm256_adds_epi8( byte_8, temp1 );
+	temp2 = _mm256_adds_epi8( temp2, temp3 );
+	temp4 = _mm256_adds_epi8( temp4, temp5 );
+	temp6 = _mm256_adds_epi8( temp6, temp7 );
+	temp0 = _mm256_adds_epi8( temp0, temp2 );
+	temp4 = _mm256_adds_epi8( temp4, temp6 );
+	temp0 = _mm256_adds_epi8( temp0, temp4 );
+	temp0 = _mm256_and_si256( temp0, byte_7 );
+	temp1 = _mm256_cmpgt_epi8( byte_2, temp0 );
+	temp1 = _mm256_and_si256( temp1, byte_1 );
+	temp0 = _mm256_xor_si256( temp0, temp1 );
+	
+	temp1 = _mm256_srli_epi64( temp0,  8 -  3 );
+	temp2 = _mm256_srli_epi64( temp0, 16 -  6 );
+	temp3 = _mm256_srli_epi64( temp0, 24 -  9 );
+	temp4 = _mm256_srli_epi64( temp0, 32 - 12 );
+	temp5 = _mm256_srli_epi64( temp0, 40 - 15 );
+	temp6 = _mm256_srli_epi64( temp0, 48 - 18 );
+	temp7 = _mm256_srli_epi64( temp0, 56 - 21 );
+	temp0 = _mm256_and_si256( temp0, _mm256_set1_epi64x( 7 << 0 ) );
+	temp1 = _mm256_and_si256( temp1, _mm256_set1_epi64x( 7 << 3 ) );
+	temp2 = _mm256_and_si256( temp2, _mm256_set1_epi64x( 7 << 6 ) );
+	temp3 = _mm256_and_si256( temp3, _mm256_set1_epi64x( 7 << 9 ) );
+	temp4 = _mm256_and_si256( temp4, _mm256_set1_epi64x( 7 << 12 ) );
+	temp5 = _mm256_and_si256( temp5, _mm256_set1_epi64x( 7 << 15 ) );
+	temp6 = _mm256_and_si256( temp6, _mm256_set1_epi64x( 7 << 18 ) );
+	temp7 = _mm256_and_si256( temp7, _mm256_set1_epi64x( 7 << 21 ) );
+	temp0 = _mm256_or_si256( temp0, temp1 );
+	temp2 = _mm256_or_si256( temp2, temp3 );
+	temp4 = _mm256_or_si256( temp4, temp5 );
+	temp6 = _mm256_or_si256( temp6, temp7 );
+	temp0 = _mm256_or_si256( temp0, temp2 );
+	temp4 = _mm256_or_si256( temp4, temp6 );
+	temp0 = _mm256_or_si256( temp0, temp4 );
+	
+	return temp0;
+}
+
+/*
+========================
+ScaleYCoCg_AVX2
+========================
+*/
+static AVX2_FUNC ID_INLINE void ScaleYCoCg_AVX2( __m256i block[4], __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i center_128 = Lanes_AVX2( _mm_setr_epi16( 128, 128, 0, 0, 0, 0, 0, 0 ) );
+	const __m256i minus_128_0 = _mm256_set1_epi32( 0x00008080 );
+	const __m256i byte_1 = _mm256_set1_epi8( 1 );
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+	
+	temp0 = _mm256_unpacklo_epi8( minColor, zero );
+	temp1 = _mm256_unpacklo_epi8( maxColor, zero );
+	
+	temp6 = _mm256_sub_epi16( center_128, temp0 );
+	temp7 = _mm256_sub_epi16( center_128, temp1 );
+	temp0 = _mm256_sub_epi16( temp0, center_128 );
+	temp1 = _mm256_sub_epi16( temp1, center_128 );
+	temp6 = _mm256_max_epi16( temp6, temp0 );
+	temp7 = _mm256_max_epi16( temp7, temp1 );
+	
+	temp6 = _mm256_max_epi16( temp6, temp7 );
+	temp7 = _mm256_shufflelo_epi16( temp6, R_SHUFFLE_D( 1, 0, 1, 0 ) );
+	temp6 = _mm256_max_epi16( temp6, temp7 );
+	temp6 = _mm256_shuffle_epi32( temp6, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	
+	temp7 = temp6;
+	temp6 = _mm256_cmpgt_epi16( temp6, _mm256_set1_epi16( 63 ) );			// mask0
+	temp7 = _mm256_cmpgt_epi16( temp7, _mm256_set1_epi16( 31 ) );			// mask1
+	
+	temp7 = _mm256_andnot_si256( temp7, _mm256_set1_epi8( 2 ) );
+	temp7 = _mm256_or_si256( temp7, byte_1 );
+	temp6 = _mm256_andnot_si256( temp6, temp7 );
+	temp3 = temp6;
+	temp7 = temp6;
+	temp7 = _mm256_xor_si256( temp7, _mm256_set1_epi8( -1 ) );
+	temp7 = _mm256_or_si256( temp7, _mm256_set1_epi32( 0xFFFF0000 ) );		// 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00
+	temp6 = _mm256_add_epi16( temp6, byte_1 );
+	temp6 = _mm256_and_si256( temp6, _mm256_set1_epi32( 0x000000FF ) );		// 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF
+	temp6 = _mm256_or_si256( temp6, _mm256_set1_epi32( 0x00010000 ) );		// 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00
+	
+	temp4 = _mm256_and_si256( minColor, _mm256_set1_epi64x( 0xFF00FFFF ) );	// 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0xFF
+	temp5 = _mm256_and_si256( maxColor, _mm256_set1_epi64x( 0xFF00FFFF ) );
+	
+	temp3 = _mm256_slli_epi32( temp3, 3 );
+	temp3 = _mm256_and_si256( temp3, _mm256_set1_epi64x( 0x00FF0000 ) );	// 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00
+	
+	temp4 = _mm256_or_si256( temp4, temp3 );
+	temp5 = _mm256_or_si256( temp5, temp3 );
+	
+	temp4 = _mm256_add_epi8( temp4, minus_128_0 );
+	temp5 = _mm256_add_epi8( temp5, minus_128_0 );
+	
+	temp4 = _mm256_mullo_epi16( temp4, temp6 );
+	temp5 = _mm256_mullo_epi16( temp5, temp6 );
+	
+	temp4 = _mm256_and_si256( temp4, temp7 );
+	temp5 = _mm256_and_si256( temp5, temp7 );
+	
+	temp4 = _mm256_sub_epi8( temp4, minus_128_0 );
+	temp5 = _mm256_sub_epi8( temp5, minus_128_0 );
+	
+	minColor = FirstDword_AVX2( temp4 );
+	maxColor = FirstDword_AVX2( temp5 );
+	
+	for( int i = 0; i < 4; i++ )
+	{
+		temp0 = _mm256_add_epi8( block[i], minus_128_0 );
+		temp0 = _mm256_mullo_epi16( temp0, temp6 );
+		temp0 = _mm256_and_si256( temp0, temp7 );
+		block[i] = _mm256_sub_epi8( temp0, minus_128_0 );
+	}
+}
+
+/*
+========================
+InsetYCoCgBBox_AVX2
+========================
+*/
+static AVX2_FUNC ID_INLINE void InsetYCoCgBBox_AVX2( __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i insetRound = Lanes_AVX2( _mm_setr_epi16( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1, ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1, ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1, ( 1 << ( INSET_ALPHA_SHIFT - 1 ) ) - 1, 0, 0, 0, 0 ) );
+	const __m256i insetMask = Lanes_AVX2( _mm_setr_epi16( -1, -1, 0, -1, -1, -1, 0, -1 ) );
+	const __m256i insetShiftUp = Lanes_AVX2( _mm_setr_epi16( 1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_ALPHA_SHIFT, 0, 0, 0, 0 ) );
+	const __m256i insetShiftDown = Lanes_AVX2( _mm_setr_epi16( 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0 ) );
+	const __m256i insetQuantMask = Lanes_AVX2( _mm_setr_epi16( C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF ) );
+	const __m256i insetRep = Lanes_AVX2( _mm_setr_epi16( 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0, 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0 ) );
+	__m256i temp0, temp1, temp2, temp3;
+	
+	temp0 = _mm256_unpacklo_epi8( minColor, zero );
+	temp1 = _mm256_unpacklo_epi8( maxColor, zero );
+	
+	temp2 = _mm256_sub_epi16( temp1, temp0 );
+	temp2 = _mm256_sub_epi16( temp2, insetRound );
+	temp2 = _mm256_and_si256( temp2, insetMask );
+	temp0 = _mm256_mullo_epi16( temp0, insetShiftUp );
+	temp1 = _mm256_mullo_epi16( temp1, insetShiftUp );
+	temp0 = _mm256_add_epi16( temp0, temp2 );
+	temp1 = _mm256_sub_epi16( temp1, temp2 );
+	temp0 = _mm256_mulhi_epi16( temp0, insetShiftDown );
+	temp1 = _mm256_mulhi_epi16( temp1, insetShiftDown );
+	temp0 = _mm256_max_epi16( temp0, zero );
+	temp1 = _mm256_max_epi16( temp1, zero );
+	temp0 = _mm256_and_si256( temp0, insetQuantMask );
+	temp1 = _mm256_and_si256( temp1, insetQuantMask );
+	temp2 = _mm256_mulhi_epi16( temp0, insetRep );
+	temp3 = _mm256_mulhi_epi16( temp1, insetRep );
+	temp0 = _mm256_or_si256( temp0, temp2 );
+	temp1 = _mm256_or_si256( temp1, temp3 );
+	
+	minColor = FirstDword_AVX2( _mm256_packus_epi16( temp0, temp0 ) );
+	maxColor = FirstDword_AVX2( _mm256_packus_epi16( temp1, temp1 ) );
+}
+
+/*
+========================
+SelectYCoCgDiagonal_AVX2
+========================
+*/
+static AVX2_FUNC ID_INLINE void SelectYCoCgDiagonal_AVX2( const __m256i block[4], __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i word_mask = _mm256_set1_epi32( 0x0000FFFF );
+	const __m256i word_1 = _mm256_set1_epi16( 1 );
+	const __m256i diagonalMask = _mm256_set1_epi64x( 0x000000000000FF00 );
+	__m256i temp0, temp1, temp2, temp3, temp6, temp7;
+	
+	temp0 = _mm256_and_si256( block[0], word_mask );
+	temp1 = _mm256_and_si256( block[1], word_mask );
+	temp2 = _mm256_and_si256( block[2], word_mask );
+	temp3 = _mm256_and_si256( block[3], word_mask );
+	
+	temp1 = _mm256_slli_si256( temp1, 2 );
+	temp3 = _mm256_slli_si256( temp3, 2 );
+	temp0 = _mm256_or_si256( temp0, temp1 );
+	temp2 = _mm256_or_si256( temp2, temp3 );
+	
+	temp6 = minColor;
+	temp7 = maxColor;
+	
+	temp1 = _mm256_avg_epu8( temp6, temp7 );
+	temp1 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp1 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	
+	temp3 = _mm256_max_epu8( temp1, temp2 );
+	temp1 = _mm256_max_epu8( temp1, temp0 );
+	temp1 = _mm256_cmpeq_epi8( temp1, temp0 );
+	temp3 = _mm256_cmpeq_epi8( temp3, temp2 );
+	
+	temp0 = _mm256_srli_si256( temp1, 1 );
+	temp2 = _mm256_srli_si256( temp3, 1 );
+	
+	temp0 = _mm256_xor_si256( temp0, temp1 );
+	temp2 = _mm256_xor_si256( temp2, temp3 );
+	temp0 = _mm256_and_si256( temp0, word_1 );
+	temp2 = _mm256_and_si256( temp2, word_1 );
+	
+	temp0 = _mm256_add_epi16( temp0, temp2 );
+	temp0 = _mm256_sad_epu8( temp0, _mm256_setzero_si256() );
+	temp1 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+	
+#ifdef NVIDIA_7X_HARDWARE_BUG_FIX
+	temp1 = _mm256_add_epi16( temp1, temp0 );
+	temp1 = _mm256_cmpgt_epi16( temp1, _mm256_set1_epi16( 8 ) );
+	temp1 = _mm256_and_si256( temp1, diagonalMask );
+	temp0 = _mm256_cmpeq_epi8( temp6, temp7 );
+	temp0 = _mm256_slli_si256( temp0, 1 );
+	temp0 = _mm256_andnot_si256( temp0, temp1 );
+#else
+	temp0 = _mm256_add_epi16( temp0, temp1 );
+	temp0 = _mm256_cmpgt_epi16( temp0, _mm256_set1_epi16( 8 ) );
+	temp0 = _mm256_and_si256( temp0, diagonalMask );
+#endif
+	
+	temp6 = _mm256_xor_si256( temp6, temp7 );
+	temp0 = _mm256_and_si256( temp0, temp6 );
+	temp7 = _mm256_xor_si256( temp7, temp0 );
+	temp6 = _mm256_xor_si256( temp6, temp7 );
+	
+	minColor = FirstDword_AVX2( temp6 );
+	maxColor = FirstDword_AVX2( temp7 );
+}
+
+/*
+========================
+EmitBlocks_AVX2
+
+Writes the DXT1 color block or the DXT5 alpha and color block of each lane.
+========================
+*/
+static AVX2_FUNC ID_INLINE byte* EmitBlocks_AVX2( byte* outData, int numBlocks, bool alpha, const __m256i minColor, const __m256i maxColor, const __m256i alphaIndices, const __m256i colorIndices )
+{
+	ALIGN16( unsigned int minColors[8] );
+	ALIGN16( unsigned int maxColors[8] );
+	ALIGN16( unsigned int alphaBits[8] );
+	ALIGN16( unsigned int colorBits[8] );
+	_mm256_storeu_si256( ( __m256i* )minColors, minColor );
+	_mm256_storeu_si256( ( __m256i* )maxColors, maxColor );
+	_mm256_storeu_si256( ( __m256i* )alphaBits, alphaIndices );
+	_mm256_storeu_si256( ( __m256i* )colorBits, colorIndices );
+	
+	for( int i = 0; i < numBlocks * 4; i += 4 )
+	{
+		if( alpha )
+		{
+			outData[0] = ( byte )( maxColors[i] >> 24 );
+			outData[1] = ( byte )( minColors[i] >> 24 );
+			// the fourth byte of each store is overwritten by the next one
+			*( ( unsigned int* )( outData + 2 ) ) = alphaBits[i + 0];
+			*( ( unsigned int* )( outData + 5 ) ) = alphaBits[i + 2];
+			outData += 8;
+		}
+		*( ( unsigned short* )( outData + 0 ) ) = ColorTo565_AVX2( maxColors[i] );
+		*( ( unsigned short* )( outData + 2 ) ) = ColorTo565_AVX2( minColors[i] );
+		*( ( unsigned int* )( outData + 4 ) ) = colorBits[i];
+		outData += 8;
+	}
+	return outData;
+}
+
+/*
+========================
+CompressRowDXT1Fast_AVX2
+========================
+*/
+static AVX2_FUNC byte* CompressRowDXT1Fast_AVX2( const byte* inBuf, byte* outData, int width )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	
+	for( int i = 0; i < width; i += 8 )
+	{
+		const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+		
+		LoadBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+		GetMinMaxBBox_AVX2( block, minColor, maxColor );
+		InsetColorsBBox_AVX2( minColor, maxColor );
+		
+		__m256i colorIndices = ColorIndices_AVX2( block, minColor, maxColor );
+		
+		outData = EmitBlocks_AVX2( outData, numBlocks, false, minColor, maxColor, colorIndices, colorIndices );
+	}
+	return outData;
+}
+
+/*
+========================
+CompressRowDXT5Fast_AVX2
+========================
+*/
+static AVX2_FUNC byte* CompressRowDXT5Fast_AVX2( const byte* inBuf, byte* outData, int width )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	
+	for( int i = 0; i < width; i += 8 )
+	{
+		const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+		
+		LoadBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+		GetMinMaxBBox_AVX2( block, minColor, maxColor );
+		InsetColorsBBox_AVX2( minColor, maxColor );
+		
+		__m256i alphaIndices = AlphaIndices_AVX2( block, minColor, maxColor );
+		__m256i colorIndices = ColorIndices_AVX2( block, minColor, maxColor );
+		
+		outData = EmitBlocks_AVX2( outData, numBlocks, true, minColor, maxColor, alphaIndices, colorIndices );
+	}
+	return outData;
+}
+
+/*
+========================
+CompressRowYCoCgDXT5Fast_AVX2
+========================
+*/
+static AVX2_FUNC byte* CompressRowYCoCgDXT5Fast_AVX2( const byte* inBuf, byte* outData, int width )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	
+	for( int i = 0; i < width; i += 8 )
+	{
+		const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+		
+		LoadBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+		GetMinMaxBBox_AVX2( block, minColor, maxColor );
+		
+		ScaleYCoCg_AVX2( block, minColor, maxColor );
+		InsetYCoCgBBox_AVX2( minColor, maxColor );
+		SelectYCoCgDiagonal_AVX2( block, minColor, maxColor );
+		
+		__m256i alphaIndices = AlphaIndices_AVX2( block, minColor, maxColor );
+		__m256i colorIndices = CoCgIndices_AVX2( block, minColor, maxColor );
+		
+		outData = EmitBlocks_AVX2( outData, numBlocks, true, minColor, maxColor, alphaIndices, colorIndices );
+	}
+	return outData;
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT1Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXT1Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		outData = CompressRowDXT1Fast_AVX2( inBuf, outData, width );
+		
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT5Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		outData = CompressRowDXT5Fast_AVX2( inBuf, outData, width );
+		
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressYCoCgDXT5Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressYCoCgDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		outData = CompressRowYCoCgDXT5Fast_AVX2( inBuf, outData, width );
+		
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+#endif // #if defined(USE_INTRINSICS)
@@ -0,0 +1,782 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+#include "framework/Common_local.h"
+#include "DXTCodec_local.h"
+#include "DXTCodec.h"
+
+/*
+================================================================================================
+
+	BC7 encoders
+
+	Only BC7 mode 6 is written: a single line through RGBA space with two 7.7.7.7 end points, a
+	p-bit per end point that becomes the low bit of all four of its channels, and a 4 bit index
+	per pixel. Color and alpha share the line, which makes it a good fit for smooth color maps
+	and the CoCg_Y diffuse maps, and it is simple enough to encode quickly.
+
+	The fast encoders fit the line along the principal axis of the block and project the pixels
+	onto it. The high quality encoder starts from the same line and refines the end points with
+	least squares fits to the exact index choices.
+
+================================================================================================
+*/
+
+static const int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const int BC7_POWER_ITERATIONS	= 8;
+static const int BC7_REFINE_ITERATIONS	= 3;
+
+/*
+========================
+BC7_ExtractBlock
+========================
+*/
+static void BC7_ExtractBlock( const byte* inPtr, int width, byte* block )
+{
+	for( int j = 0; j < 4; j++ )
+	{
+		memcpy( &block[j * 16], inPtr + width * 4 * j, 16 );
+	}
+}
+
+/*
+========================
+BC7_IsOpaque
+========================
+*/
+static bool BC7_IsOpaque( const byte* block )
+{
+	for( int i = 0; i < 16; i++ )
+	{
+		if( block[i * 4 + 3] != 255 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+========================
+BC7_PrincipalAxis
+
+Finds the mean of the block and the direction along which the colors vary the most with a few
+power iterations on the covariance matrix. The axis is zero for a block with a single color.
+========================
+*/
+static void BC7_PrincipalAxis( const byte* block, float mean[4], float axis[4] )
+{
+	float cov[4][4];
+	
+	for( int c = 0; c < 4; c++ )
+	{
+		int sum = 0;
+		for( int i = 0; i < 16; i++ )
+		{
+			sum += block[i * 4 + c];
+		}
+		mean[c] = sum * ( 1.0f / 16.0f );
+	}
+	
+	memset( cov, 0, sizeof( cov ) );
+	for( int i = 0; i < 16; i++ )
+	{
+		float v[4];
+		for( int c = 0; c < 4; c++ )
+		{
+			v[c] = block[i * 4 + c] - mean[c];
+		}
+		for( int r = 0; r < 4; r++ )
+		{
+			for( int c = 0; c < 4; c++ )
+			{
+				cov[r][c] += v[r] * v[c];
+			}
+		}
+	}
+	
+	// start with the channel that varies the most
+	int start = 0;
+	for( int c = 1; c < 4; c++ )
+	{
+		if( cov[c][c] > cov[start][start] )
+		{
+			start = c;
+		}
+	}
+	for( int c = 0; c < 4; c++ )
+	{
+		axis[c] = cov[start][c];
+	}
+	
+	for( int k = 0; k < BC7_POWER_ITERATIONS; k++ )
+	{
+		float next[4];
+		float maxValue = 0.0f;
+		for( int r = 0; r < 4; r++ )
+		{
+			next[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2] + cov[r][3] * axis[3];
+			maxValue = Max( maxValue, idMath::Fabs( next[r] ) );
+		}
+		if( maxValue < idMath::FLT_SMALLEST_NON_DENORMAL )
+		{
+			axis[0] = axis[1] = axis[2] = axis[3] = 0.0f;
+			return;
+		}
+		for( int r = 0; r < 4; r++ )
+		{
+			axis[r] = next[r] / maxValue;
+		}
+	}
+	
+	const float length = idMath::Sqrt( axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3] );
+	for( int c = 0; c < 4; c++ )
+	{
+		axis[c] /= length;
+	}
+}
+
+/*
+========================
+BC7_QuantizeEndPoint
+
+Quantizes an end point to 7 bits per channel plus the p-bit with the smallest error. Opaque
+blocks always use a p-bit of 1 so the alpha stays exactly 255. Returns the p-bit, the 7 bit
+values are written to quantized and the values the hardware reconstructs to color.
+========================
+*/
+static int BC7_QuantizeEndPoint( const float endPoint[4], bool opaque, byte quantized[4], byte color[4] )
+{
+	int bestBit = 1;
+	float bestError = idMath::INFINITY;
+	
+	for( int p = opaque ? 1 : 0; p < 2; p++ )
+	{
+		float error = 0.0f;
+		for( int c = 0; c < 4; c++ )
+		{
+			int q = idMath::ClampInt( 0, 127, idMath::Ftoi( ( endPoint[c] - p ) * 0.5f + 0.5f ) );
+			float d = ( ( q << 1 ) | p ) - endPoint[c];
+			error += d * d;
+		}
+		if( error < bestError )
+		{
+			bestError = error;
+			bestBit = p;
+		}
+	}
+	
+	for( int c = 0; c < 4; c++ )
+	{
+		quantized[c] = ( byte )idMath::ClampInt( 0, 127, idMath::Ftoi( ( endPoint[c] - bestBit ) * 0.5f + 0.5f ) );
+		color[c] = ( byte )( ( quantized[c] << 1 ) | bestBit );
+	}
+	return bestBit;
+}
+
+/*
+========================
+BC7_QuantizeEndPointBit
+
+Quantizes an end point with the given p-bit.
+========================
+*/
+static void BC7_QuantizeEndPointBit( const float endPoint[4], int p, byte quantized[4], byte color[4] )
+{
+	for( int c = 0; c < 4; c++ )
+	{
+		quantized[c] = ( byte )idMath::ClampInt( 0, 127, idMath::Ftoi( ( endPoint[c] - p ) * 0.5f + 0.5f ) );
+		color[c] = ( byte )( ( quantized[c] << 1 ) | p );
+	}
+}
+
+/*
+========================
+BC7_ProjectIndices
+
+Picks the index of each pixel by projecting it onto the line between the two colors.
+========================
+*/
+static void BC7_ProjectIndices( const byte* block, const byte color0[4], const byte color1[4], byte indices[16] )
+{
+	int d[4];
+	for( int c = 0; c < 4; c++ )
+	{
+		d[c] = color1[c] - color0[c];
+	}
+	const int dd = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] + d[3] * d[3];
+	if( dd == 0 )
+	{
+		memset( indices, 0, 16 );
+		return;
+	}
+	const float scale = 15.0f / dd;
+	for( int i = 0; i < 16; i++ )
+	{
+		const byte* p = &block[i * 4];
+		int dot = ( p[0] - color0[0] ) * d[0] + ( p[1] - color0[1] ) * d[1] + ( p[2] - color0[2] ) * d[2] + ( p[3] - color0[3] ) * d[3];
+		indices[i] = ( byte )idMath::ClampInt( 0, 15, idMath::Ftoi( dot * scale + 0.5f ) );
+	}
+}
+
+/*
+========================
+BC7_FindIndices
+
+Picks the index with the smallest error for each pixel and returns the total squared error.
+========================
+*/
+static int BC7_FindIndices( const byte* block, const byte color0[4], const byte color1[4], byte indices[16] )
+{
+	int palette[16][4];
+	for( int k = 0; k < 16; k++ )
+	{
+		for( int c = 0; c < 4; c++ )
+		{
+			palette[k][c] = ( ( 64 - bc7Weights4[k] ) * color0[c] + bc7Weights4[k] * color1[c] + 32 ) >> 6;
+		}
+	}
+	
+	int error = 0;
+	for( int i = 0; i < 16; i++ )
+	{
+		const byte* p = &block[i * 4];
+		int bestError = INT_MAX;
+		int bestIndex = 0;
+		for( int k = 0; k < 16; k++ )
+		{
+			int d0 = p[0] - palette[k][0];
+			int d1 = p[1] - palette[k][1];
+			int d2 = p[2] - palette[k][2];
+			int d3 = p[3] - palette[k][3];
+			int e = d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+			if( e < bestError )
+			{
+				bestError = e;
+				bestIndex = k;
+			}
+		}
+		indices[i] = ( byte )bestIndex;
+		error += bestError;
+	}
+	return error;
+}
+
+/*
+========================
+BC7_WriteBits
+========================
+*/
+static ID_INLINE void BC7_WriteBits( uint32 words[4], int& bitPos, uint32 value, int numBits )
+{
+	for( int i = 0; i < numBits; i++, bitPos++ )
+	{
+		words[bitPos >> 5] |= ( ( value >> i ) & 1 ) << ( bitPos & 31 );
+	}
+}
+
+/*
+========================
+BC7_PackMode6
+
+The index of the first pixel is stored with 3 bits, so its high bit must be zero. If it isn't,
+the end points are swapped and the indices inverted.
+========================
+*/
+static void BC7_PackMode6( const byte quantized0[4], int p0, const byte quantized1[4], int p1, const byte indices[16], uint32 words[4] )
+{
+	const byte* q[2] = { quantized0, quantized1 };
+	int p[2] = { p0, p1 };
+	int flip = 0;
+	if( indices[0] & 8 )
+	{
+		flip = 15;
+		SwapValues( q[0], q[1] );
+		SwapValues( p[0], p[1] );
+	}
+	
+	words[0] = words[1] = words[2] = words[3] = 0;
+	int bitPos = 0;
+	
+	BC7_WriteBits( words, bitPos, 1 << 6, 7 );		// mode 6
+	for( int c = 0; c < 4; c++ )
+	{
+		BC7_WriteBits( words, bitPos, q[0][c], 7 );
+		BC7_WriteBits( words, bitPos, q[1][c], 7 );
+	}
+	BC7_WriteBits( words, bitPos, p[0], 1 );
+	BC7_WriteBits( words, bitPos, p[1], 1 );
+	
+	BC7_WriteBits( words, bitPos, indices[0] ^ flip, 3 );
+	for( int i = 1; i < 16; i++ )
+	{
+		BC7_WriteBits( words, bitPos, indices[i] ^ flip, 4 );
+	}
+	assert( bitPos == 128 );
+}
+
+/*
+========================
+BC7_LineEndPoints
+
+Projects the pixels onto the principal axis and returns the end points of the covered segment.
+========================
+*/
+static void BC7_LineEndPoints( const byte* block, const float mean[4], const float axis[4], float endPoint0[4], float endPoint1[4] )
+{
+	float minT = 0.0f;
+	float maxT = 0.0f;
+	for( int i = 0; i < 16; i++ )
+	{
+		const byte* p = &block[i * 4];
+		float t = ( p[0] - mean[0] ) * axis[0] + ( p[1] - mean[1] ) * axis[1] + ( p[2] - mean[2] ) * axis[2] + ( p[3] - mean[3] ) * axis[3];
+		minT = Min( minT, t );
+		maxT = Max( maxT, t );
+	}
+	for( int c = 0; c < 4; c++ )
+	{
+		endPoint0[c] = idMath::ClampFloat( 0.0f, 255.0f, mean[c] + axis[c] * minT );
+		endPoint1[c] = idMath::ClampFloat( 0.0f, 255.0f, mean[c] + axis[c] * maxT );
+	}
+}
+
+/*
+========================
+BC7_LeastSquaresEndPoints
+
+Solves for the end points that minimize the squared error of the given indices. Returns false
+if all the pixels use the same weight.
+========================
+*/
+static bool BC7_LeastSquaresEndPoints( const byte* block, const byte indices[16], float endPoint0[4], float endPoint1[4] )
+{
+	float a = 0.0f, b = 0.0f, c = 0.0f;
+	float x0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float x1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	
+	for( int i = 0; i < 16; i++ )
+	{
+		const float w = bc7Weights4[indices[i]] * ( 1.0f / 64.0f );
+		const float iw = 1.0f - w;
+		a += iw * iw;
+		b += iw * w;
+		c += w * w;
+		for( int k = 0; k < 4; k++ )
+		{
+			x0[k] += iw * block[i * 4 + k];
+			x1[k] += w * block[i * 4 + k];
+		}
+	}
+	
+	const float det = a * c - b * b;
+	if( idMath::Fabs( det ) < 1e-6f )
+	{
+		return false;
+	}
+	const float invDet = 1.0f / det;
+	for( int k = 0; k < 4; k++ )
+	{
+		endPoint0[k] = idMath::ClampFloat( 0.0f, 255.0f, ( c * x0[k] - b * x1[k] ) * invDet );
+		endPoint1[k] = idMath::ClampFloat( 0.0f, 255.0f, ( a * x1[k] - b * x0[k] ) * invDet );
+	}
+	return true;
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Fast_Generic
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	ALIGN16( byte block[64] );
+	byte indices[16];
+	float mean[4], axis[4];
+	float endPoint0[4], endPoint1[4];
+	byte quantized0[4], quantized1[4];
+	byte color0[4], color1[4];
+	uint32 words[4];
+	
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		for( int i = 0; i < width; i += 4 )
+		{
+			DXT_PACIFIER_PROGRESS( 16 );
+			
+			BC7_ExtractBlock( inBuf + i * 4, width, block );
+			
+			const bool opaque = BC7_IsOpaque( block );
+			BC7_PrincipalAxis( block, mean, axis );
+			BC7_LineEndPoints( block, mean, axis, endPoint0, endPoint1 );
+			
+			const int p0 = BC7_QuantizeEndPoint( endPoint0, opaque, quantized0, color0 );
+			const int p1 = BC7_QuantizeEndPoint( endPoint1, opaque, quantized1, color1 );
+			BC7_ProjectIndices( block, color0, color1, indices );
+			
+			BC7_PackMode6( quantized0, p0, quantized1, p1, indices, words );
+			EmitUInt( words[0] );
+			EmitUInt( words[1] );
+			EmitUInt( words[2] );
+			EmitUInt( words[3] );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7HQ
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7HQ( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	ALIGN16( byte block[64] );
+	byte indices[16], bestIndices[16];
+	float mean[4], axis[4];
+	float endPoint0[4], endPoint1[4];
+	byte quantized0[4], quantized1[4], bestQuantized0[4], bestQuantized1[4];
+	byte color0[4], color1[4];
+	uint32 words[4];
+	
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		for( int i = 0; i < width; i += 4 )
+		{
+			DXT_PACIFIER_PROGRESS( 16 );
+			
+			BC7_ExtractBlock( inBuf + i * 4, width, block );
+			
+			const bool opaque = BC7_IsOpaque( block );
+			BC7_PrincipalAxis( block, mean, axis );
+			BC7_LineEndPoints( block, mean, axis, endPoint0, endPoint1 );
+			
+			int bestError = INT_MAX;
+			int bestP0 = 1, bestP1 = 1;
+			
+			for( int iteration = 0; iteration <= BC7_REFINE_ITERATIONS; iteration++ )
+			{
+				if( iteration > 0 && !BC7_LeastSquaresEndPoints( block, bestIndices, endPoint0, endPoint1 ) )
+				{
+					break;
+				}
+				
+				// try all the p-bit combinations, the best one depends on the indices
+				const int lastError = bestError;
+				for( int p = opaque ? 3 : 0; p < 4; p++ )
+				{
+					const int p0 = p & 1;
+					const int p1 = p >> 1;
+					BC7_QuantizeEndPointBit( endPoint0, p0, quantized0, color0 );
+					BC7_QuantizeEndPointBit( endPoint1, p1, quantized1, color1 );
+					
+					const int error = BC7_FindIndices( block, color0, color1, indices );
+					if( error < bestError )
+					{
+						bestError = error;
+						bestP0 = p0;
+						bestP1 = p1;
+						memcpy( bestQuantized0, quantized0, 4 );
+						memcpy( bestQuantized1, quantized1, 4 );
+						memcpy( bestIndices, indices, 16 );
+					}
+				}
+				if( bestError == 0 || bestError >= lastError )
+				{
+					break;
+				}
+			}
+			
+			BC7_PackMode6( bestQuantized0, bestP0, bestQuantized1, bestP1, bestIndices, words );
+			EmitUInt( words[0] );
+			EmitUInt( words[1] );
+			EmitUInt( words[2] );
+			EmitUInt( words[3] );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+#if defined(USE_INTRINSICS)
+
+/*
+========================
+BC7_LoadPixels_SSE2
+
+Converts the pixels of a block to floats with the channels in separate registers, four pixels
+per register.
+========================
+*/
+static ID_INLINE void BC7_LoadPixels_SSE2( const byte* inPtr, int width, __m128 channels[4][4] )
+{
+	const __m128i zero = _mm_setzero_si128();
+	for( int j = 0; j < 4; j++ )
+	{
+		__m128i row = _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * j ) );
+		__m128i lo = _mm_unpacklo_epi8( row, zero );
+		__m128i hi = _mm_unpackhi_epi8( row, zero );
+		__m128 p0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) );
+		__m128 p1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) );
+		__m128 p2 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) );
+		__m128 p3 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) );
+		_MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+		channels[0][j] = p0;
+		channels[1][j] = p1;
+		channels[2][j] = p2;
+		channels[3][j] = p3;
+	}
+}
+
+/*
+========================
+BC7_HorizontalSum_SSE2
+========================
+*/
+static ID_INLINE float BC7_HorizontalSum_SSE2( __m128 v )
+{
+	v = _mm_add_ps( v, _mm_movehl_ps( v, v ) );
+	v = _mm_add_ss( v, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( v );
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Fast_SSE2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	__m128 channels[4][4];
+	ALIGN16( byte indices[16] );
+	ALIGN16( float mean[4] );
+	ALIGN16( float axis[4] );
+	float endPoint0[4], endPoint1[4];
+	byte quantized0[4], quantized1[4];
+	byte color0[4], color1[4];
+	uint32 words[4];
+	
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	const __m128 oneSixteenth = _mm_set1_ps( 1.0f / 16.0f );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128i maxIndex = _mm_set1_epi16( 15 );
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		for( int i = 0; i < width; i += 4 )
+		{
+			const byte* blockPtr = inBuf + i * 4;
+			BC7_LoadPixels_SSE2( blockPtr, width, channels );
+			
+			// mean and the pixels relative to it
+			__m128 centered[4][4];
+			for( int c = 0; c < 4; c++ )
+			{
+				__m128 sum = _mm_add_ps( _mm_add_ps( channels[c][0], channels[c][1] ), _mm_add_ps( channels[c][2], channels[c][3] ) );
+				mean[c] = BC7_HorizontalSum_SSE2( _mm_mul_ps( sum, oneSixteenth ) );
+				__m128 m = _mm_set1_ps( mean[c] );
+				for( int k = 0; k < 4; k++ )
+				{
+					centered[c][k] = _mm_sub_ps( channels[c][k], m );
+				}
+			}
+			
+			// the alpha is opaque when the smallest value is 255
+			__m128 minAlpha = _mm_min_ps( _mm_min_ps( channels[3][0], channels[3][1] ), _mm_min_ps( channels[3][2], channels[3][3] ) );
+			minAlpha = _mm_min_ps( minAlpha, _mm_movehl_ps( minAlpha, minAlpha ) );
+			minAlpha = _mm_min_ss( minAlpha, _mm_shuffle_ps( minAlpha, minAlpha, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+			const bool opaque = _mm_cvtss_f32( minAlpha ) >= 255.0f;
+			
+			// covariance matrix
+			float cov[4][4];
+			for( int r = 0; r < 4; r++ )
+			{
+				for( int c = r; c < 4; c++ )
+				{
+					__m128 sum = _mm_mul_ps( centered[r][0], centered[c][0] );
+					sum = _mm_add_ps( sum, _mm_mul_ps( centered[r][1], centered[c][1] ) );
+					sum = _mm_add_ps( sum, _mm_mul_ps( centered[r][2], centered[c][2] ) );
+					sum = _mm_add_ps( sum, _mm_mul_ps( centered[r][3], centered[c][3] ) );
+					cov[r][c] = cov[c][r] = BC7_HorizontalSum_SSE2( sum );
+				}
+			}
+			
+			// power iterations for the principal axis, the rows of the symmetric matrix are its columns
+			__m128 rows[4];
+			int start = 0;
+			for( int r = 0; r < 4; r++ )
+			{
+				rows[r] = _mm_loadu_ps( cov[r] );
+				if( cov[r][r] > cov[start][start] )
+				{
+					start = r;
+				}
+			}
+			__m128 v = rows[start];
+			bool singleColor = false;
+			for( int k = 0; k < BC7_POWER_ITERATIONS; k++ )
+			{
+				__m128 next = _mm_mul_ps( rows[0], _mm_shuffle_ps( v, v, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+				next = _mm_add_ps( next, _mm_mul_ps( rows[1], _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+				next = _mm_add_ps( next, _mm_mul_ps( rows[2], _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+				next = _mm_add_ps( next, _mm_mul_ps( rows[3], _mm_shuffle_ps( v, v, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+				
+				__m128 absNext = _mm_max_ps( next, _mm_sub_ps( _mm_setzero_ps(), next ) );
+				__m128 maxValue = _mm_max_ps( absNext, _mm_movehl_ps( absNext, absNext ) );
+				maxValue = _mm_max_ss( maxValue, _mm_shuffle_ps( maxValue, maxValue, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+				if( _mm_cvtss_f32( maxValue ) < idMath::FLT_SMALLEST_NON_DENORMAL )
+				{
+					singleColor = true;
+					break;
+				}
+				v = _mm_div_ps( next, _mm_shuffle_ps( maxValue, maxValue, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+			}
+			
+			if( singleColor )
+			{
+				for( int c = 0; c < 4; c++ )
+				{
+					endPoint0[c] = endPoint1[c] = mean[c];
+				}
+			}
+			else
+			{
+				const float invLength = idMath::InvSqrt( BC7_HorizontalSum_SSE2( _mm_mul_ps( v, v ) ) );
+				_mm_storeu_ps( axis, _mm_mul_ps( v, _mm_set1_ps( invLength ) ) );
+				
+				// extent of the pixels along the axis
+				__m128 minT = _mm_setzero_ps();
+				__m128 maxT = _mm_setzero_ps();
+				for( int k = 0; k < 4; k++ )
+				{
+					__m128 t = _mm_mul_ps( centered[0][k], _mm_set1_ps( axis[0] ) );
+					t = _mm_add_ps( t, _mm_mul_ps( centered[1][k], _mm_set1_ps( axis[1] ) ) );
+					t = _mm_add_ps( t, _mm_mul_ps( centered[2][k], _mm_set1_ps( axis[2] ) ) );
+					t = _mm_add_ps( t, _mm_mul_ps( centered[3][k], _mm_set1_ps( axis[3] ) ) );
+					minT = _mm_min_ps( minT, t );
+					maxT = _mm_max_ps( maxT, t );
+				}
+				minT = _mm_min_ps( minT, _mm_movehl_ps( minT, minT ) );
+				minT = _mm_min_ss( minT, _mm_shuffle_ps( minT, minT, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+				maxT = _mm_max_ps( maxT, _mm_movehl_ps( maxT, maxT ) );
+				maxT = _mm_max_ss( maxT, _mm_shuffle_ps( maxT, maxT, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+				
+				__m128 m = _mm_loadu_ps( mean );
+				__m128 a = _mm_loadu_ps( axis );
+				__m128 e0 = _mm_add_ps( m, _mm_mul_ps( a, _mm_shuffle_ps( minT, minT, _MM_SHUFFLE( 0, 0, 0, 0 ) ) ) );
+				__m128 e1 = _mm_add_ps( m, _mm_mul_ps( a, _mm_shuffle_ps( maxT, maxT, _MM_SHUFFLE( 0, 0, 0, 0 ) ) ) );
+				e0 = _mm_min_ps( _mm_max_ps( e0, _mm_setzero_ps() ), _mm_set1_ps( 255.0f ) );
+				e1 = _mm_min_ps( _mm_max_ps( e1, _mm_setzero_ps() ), _mm_set1_ps( 255.0f ) );
+				_mm_storeu_ps( endPoint0, e0 );
+				_mm_storeu_ps( endPoint1, e1 );
+			}
+			
+			const int p0 = BC7_QuantizeEndPoint( endPoint0, opaque, quantized0, color0 );
+			const int p1 = BC7_QuantizeEndPoint( endPoint1, opaque, quantized1, color1 );
+			
+			// project the pixels onto the quantized line
+			float d[4];
+			for( int c = 0; c < 4; c++ )
+			{
+				d[c] = ( float )( color1[c] - color0[c] );
+			}
+			const float dd = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] + d[3] * d[3];
+			if( dd == 0.0f )
+			{
+				memset( indices, 0, 16 );
+			}
+			else
+			{
+				const float scale = 15.0f / dd;
+				__m128i index[4];
+				for( int k = 0; k < 4; k++ )
+				{
+					__m128 t = _mm_mul_ps( _mm_sub_ps( channels[0][k], _mm_set1_ps( color0[0] ) ), _mm_set1_ps( d[0] * scale ) );
+					t = _mm_add_ps( t, _mm_mul_ps( _mm_sub_ps( channels[1][k], _mm_set1_ps( color0[1] ) ), _mm_set1_ps( d[1] * scale ) ) );
+					t = _mm_add_ps( t, _mm_mul_ps( _mm_sub_ps( channels[2][k], _mm_set1_ps( color0[2] ) ), _mm_set1_ps( d[2] * scale ) ) );
+					t = _mm_add_ps( t, _mm_mul_ps( _mm_sub_ps( channels[3][k], _mm_set1_ps( color0[3] ) ), _mm_set1_ps( d[3] * scale ) ) );
+					index[k] = _mm_cvttps_epi32( _mm_add_ps( t, half ) );
+				}
+				__m128i index01 = _mm_packs_epi32( index[0], index[1] );
+				__m128i index23 = _mm_packs_epi32( index[2], index[3] );
+				index01 = _mm_min_epi16( _mm_max_epi16( index01, _mm_setzero_si128() ), maxIndex );
+				index23 = _mm_min_epi16( _mm_max_epi16( index23, _mm_setzero_si128() ), maxIndex );
+				_mm_store_si128( ( __m128i* )indices, _mm_packus_epi16( index01, index23 ) );
+			}
+			
+			BC7_PackMode6( quantized0, p0, quantized1, p1, indices, words );
+			EmitUInt( words[0] );
+			EmitUInt( words[1] );
+			EmitUInt( words[2] );
+			EmitUInt( words[3] );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+#endif // #if defined(USE_INTRINSICS)
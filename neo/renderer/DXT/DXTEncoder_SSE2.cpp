@@ -918,16 +918,19 @@ void idDxtEncoder::EmitAlphaIndices_SSE2( const byte* block, const int channelBi
 	temp4 = _mm_or_si128( temp4, temp6 );
 	temp0 = _mm_or_si128( temp0, temp4 );
 	
-	
+	// exactly the 6 index bytes, BC4 and BC5 blocks don't have a color block after the indices
+	// that would overwrite a seventh byte, and the last block would write past the output
 	int out = _mm_cvtsi128_si32( temp0 );
-	EmitUInt( out );
-	outData--;
+	EmitByte( out );
+	EmitByte( out >> 8 );
+	EmitByte( out >> 16 );
 	
 	temp1 = _mm_shuffle_epi32( temp0, R_SHUFFLE_D( 2, 3, 0, 1 ) );
 	
 	out = _mm_cvtsi128_si32( temp1 );
-	EmitUInt( out );
-	outData--;
+	EmitByte( out );
+	EmitByte( out >> 8 );
+	EmitByte( out >> 16 );
 }
 
 /*
@@ -956,7 +959,7 @@ void idDxtEncoder::CompressImageDXT1Fast_SSE2( const byte* inBuf, byte* outBuf,
 	
 	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
 	{
-		commonLocal.LoadPacifierBinarizeProgressIncrement( width * 4 );
+		DXT_PACIFIER_PROGRESS( width * 4 );
 		
 		for( int i = 0; i < width; i += 4 )
 		{
@@ -1019,7 +1022,7 @@ void idDxtEncoder::CompressImageDXT1AlphaFast_SSE2( const byte* inBuf, byte* out
 	
 	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
 	{
-		commonLocal.LoadPacifierBinarizeProgressIncrement( width * 4 );
+		DXT_PACIFIER_PROGRESS( width * 4 );
 		for( int i = 0; i < width; i += 4 )
 		{
 			ExtractBlock_SSE2( inBuf + i * 4, width, block );
@@ -1366,7 +1369,7 @@ void idDxtEncoder::CompressYCoCgDXT5Fast_SSE2( const byte* inBuf, byte* outBuf,
 	
 	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
 	{
-		commonLocal.LoadPacifierBinarizeProgressIncrement( width * 4 );
+		DXT_PACIFIER_PROGRESS( width * 4 );
 		
 		for( int i = 0; i < width; i += 4 )
 		{
@@ -1591,7 +1594,7 @@ void idDxtEncoder::CompressNormalMapDXT5Fast_SSE2( const byte* inBuf, byte* outB
 	
 	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
 	{
-		commonLocal.LoadPacifierBinarizeProgressIncrement( width * 4 );
+		DXT_PACIFIER_PROGRESS( width * 4 );
 		
 		for( int i = 0; i < width; i += 4 )
 		{
@@ -1634,4 +1637,95 @@ void idDxtEncoder::CompressNormalMapDXT5Fast_SSE2( const byte* inBuf, byte* outB
 #endif
 }
 
+/*
+========================
+idDxtEncoder::CompressImageDXN1Fast_SSE2
+
+params:	inBuf		- image to compress, only the red channel is used
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXN1Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	ALIGN16( byte block[64] );
+	ALIGN16( byte min[4] );
+	ALIGN16( byte max[4] );
+	
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		for( int i = 0; i < width; i += 4 )
+		{
+			ExtractBlock_SSE2( inBuf + i * 4, width, block );
+			GetMinMaxBBox_SSE2( block, min, max );
+			InsetNormalsBBox3Dc( min, max );
+			
+			// Write out an alpha channel.
+			EmitByte( max[0] );
+			EmitByte( min[0] );
+			EmitAlphaIndices_SSE2( block, 0 * 8, min[0], max[0] );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressNormalMapDXN2Fast_SSE2
+
+params:	inBuf		- image to compress in xy__ component order
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressNormalMapDXN2Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	ALIGN16( byte block[64] );
+	ALIGN16( byte normal1[4] );
+	ALIGN16( byte normal2[4] );
+	
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+	
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+	
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		DXT_PACIFIER_PROGRESS( width * 4 );
+		
+		for( int i = 0; i < width; i += 4 )
+		{
+			ExtractBlock_SSE2( inBuf + i * 4, width, block );
+			GetMinMaxBBox_SSE2( block, normal1, normal2 );
+			InsetNormalsBBox3Dc( normal1, normal2 );
+			
+			// Write out Nx as an alpha channel.
+			EmitByte( normal2[0] );
+			EmitByte( normal1[0] );
+			EmitAlphaIndices_SSE2( block, 0 * 8, normal1[0], normal2[0] );
+			
+			// Write out Ny as an alpha channel.
+			EmitByte( normal2[1] );
+			EmitByte( normal1[1] );
+			EmitAlphaIndices_SSE2( block, 1 * 8, normal1[1], normal2[1] );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
 #endif // #if defined(USE_INTRINSICS)
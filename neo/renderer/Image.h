@@ -84,6 +84,9 @@ enum imageFileType_t
 
 #define	MAX_IMAGE_NAME	256
 
+class idImageUploadBuffer;
+struct imageBinarize_t;
+
 class idImage
 {
 	friend class Framebuffer;
@@ -160,6 +163,14 @@ public:
 		levelLoadReferenced = true;
 	}
 	void		ActuallyLoadImage( bool fromBackEnd );
+	
+	// ActuallyLoadImage in two halves, so images can be loaded and binarized in jobs and uploaded
+	// in batches afterwards. LoadImageData doesn't touch the GL state and returns false if there
+	// is nothing to upload. UploadImageData copies the data through the upload buffer if it's not NULL.
+	// bake is set by the bakeAssets command, see idImageManager::Bake. A job passes the job list it
+	// runs on, the binarization then finishes in child jobs and a continuation of the job.
+	bool		LoadImageData( idBinaryImage& im, bool bake = false, bool* binarized = NULL, idParallelJobList* jobList = NULL );
+	void		UploadImageData( const idBinaryImage& im, idImageUploadBuffer* uploadBuffer );
 	//---------------------------------------------
 	// Platform specific implementations
 	//---------------------------------------------
@@ -193,7 +204,13 @@ public:
 	
 	bool		IsCompressed() const
 	{
-		return ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 );
+		return IsCompressedFormat( opts.format );
+	}
+	
+	// the block compressed formats, they need complete 4x4 blocks
+	static bool	IsCompressedFormat( textureFormat_t format )
+	{
+		return ( format == FMT_DXT1 || format == FMT_DXT5 || format == FMT_BC4 || format == FMT_BC5 || format == FMT_BC7 );
 	}
 	
 	void		SetTexParameters();	// update aniso and trilinear
@@ -210,6 +227,9 @@ private:
 	
 	void				AllocImage();
 	void				DeriveOpts();
+	bool				LoadBakedImageData( idBinaryImage& im, const char* generatedFileName, unsigned int contentHash, bool loaded );
+	void				FinishImageData( idBinaryImage& im, const char* generatedFileName, unsigned int contentHash, bool* binarized );
+	friend void			R_FinishImageDataJob( imageBinarize_t* binarize );
 	
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
@@ -271,6 +291,48 @@ void	R_WriteTGA( const char* filename, const byte* data, int width, int height,
 void	R_WritePNG( const char* filename, const byte* data, int bytesPerPixel, int width, int height, bool flipVertical = false, const char* basePath = "fs_savepath" );
 // RB end
 
+/*
+================================================
+idImageUploadBuffer is a persistently mapped pixel unpack buffer for uploading batches of
+images. The image data is copied into the buffer and the uploads are sourced from it, so the
+driver can transfer them asynchronously instead of copying them out of client memory. The
+buffer is used as a ring, split into segments that are fenced so the copies never overwrite
+data the GPU hasn't read yet.
+================================================
+*/
+class idImageUploadBuffer
+{
+public:
+	idImageUploadBuffer();
+	
+	// size is in bytes, returns false if persistent buffers aren't supported
+	bool				Init( int size );
+	void				Shutdown();
+	bool				IsValid() const
+	{
+		return mappedData != NULL;
+	}
+	
+	// copies the data into the buffer and binds it for unpacking, returns the offset to upload
+	// from or -1 if the data doesn't fit and has to be uploaded from memory
+	int					Stage( const void* data, int size );
+	// unbinds the buffer after the upload of the data that was staged
+	void				EndUpload();
+	
+private:
+	static const int	NUM_SEGMENTS = 4;
+	
+	void				NextSegment();
+	
+	GLuint				bufferObject;
+	byte*				mappedData;
+	int					bufferSize;
+	int					segmentSize;
+	int					writeOffset;
+	int					currentSegment;
+	GLsync				fences[NUM_SEGMENTS];
+};
+
 class idImageManager
 {
 public:
@@ -279,6 +341,7 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		batchLoads = false;
 	}
 	
 	void				Init();
@@ -327,9 +390,17 @@ public:
 	
 	void				Preload( const idPreloadManifest& manifest, const bool& mapPreload );
 	
+	// checks the binary images of the manifest against their sources and rebuilds the stale
+	// ones, spread over the job threads
+	void				Bake( const idPreloadManifest& manifest, bakeStats_t& stats );
+	
 	// Loads unloaded level images
 	int					LoadLevelImages( bool pacifier );
 	
+	// loads the images that were queued while batchLoads was set, the loading and binarizing runs
+	// in jobs while the previous batch is uploaded
+	void				LoadQueuedImages( bool pacifier );
+	
 	// used to clear and then write the dds conversion batch file
 	void				StartBuild();
 	void				FinishBuild( bool removeDups = false );
@@ -371,6 +442,8 @@ public:
 	idImage*			ambientOcclusionImage[2];		// contain AO and bilateral filtering keys
 	idImage*			hierarchicalZbufferImage;		// zbuffer with mip maps to accelerate screen space ray tracing
 	// RB end
+	idImage*			clusteredLightsImage;			// projection, falloff, origin and color of the clustered lights
+	idImage*			clusterGridImage;				// light index ranges of the view clusters followed by the light indexes
 	idImage* 			scratchImage;
 	idImage* 			scratchImage2;
 	idImage* 			accumImage;
@@ -392,6 +465,11 @@ public:
 	
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
+	
+	bool				batchLoads;					// queue the images instead of loading them right away
+	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	queuedLoads;
+	idSysMutex			loadMutex;					// serializes the file reads of the image loads in jobs
+	idImageUploadBuffer	uploadBuffer;
 };
 
 extern idImageManager*	globalImages;		// pointer to global list for the rest of the system
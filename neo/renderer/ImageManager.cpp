@@ -38,6 +38,8 @@ idImageManager	imageManager;
 idImageManager* globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
+idCVar image_parallelLoad( "image_parallelLoad", "1", CVAR_RENDERER | CVAR_BOOL, "load and binarize the preloaded and level images in jobs" );
+idCVar image_uploadBufferSize( "image_uploadBufferSize", "64", CVAR_RENDERER | CVAR_INTEGER | CVAR_INIT, "size in MB of the persistently mapped buffer used for batched image uploads, 0 to upload straight from memory", 0, 512 );
 
 /*
 ===============
@@ -481,8 +483,15 @@ idImage*	idImageManager::ImageFromFile( const char* _name, textureFilter_t filte
 			if( ( !insideLevelLoad  || preloadingMapImages ) && !image->IsLoaded() )
 			{
 				image->referencedOutsideLevelLoad = ( !insideLevelLoad && !preloadingMapImages );
-				image->ActuallyLoadImage( false );	// load is from front end
-				declManager->MediaPrint( "%ix%i %s (reload for mixed referneces)\n", image->GetUploadWidth(), image->GetUploadHeight(), image->GetName() );
+				if( batchLoads )
+				{
+					queuedLoads.AddUnique( image );
+				}
+				else
+				{
+					image->ActuallyLoadImage( false );	// load is from front end
+					declManager->MediaPrint( "%ix%i %s (reload for mixed referneces)\n", image->GetUploadWidth(), image->GetUploadHeight(), image->GetName() );
+				}
 			}
 			return image;
 		}
@@ -503,8 +512,16 @@ idImage*	idImageManager::ImageFromFile( const char* _name, textureFilter_t filte
 	if( !insideLevelLoad || preloadingMapImages )
 	{
 		image->referencedOutsideLevelLoad = ( !insideLevelLoad && !preloadingMapImages );
-		image->ActuallyLoadImage( false );	// load is from front end
-		declManager->MediaPrint( "%ix%i %s\n", image->GetUploadWidth(), image->GetUploadHeight(), image->GetName() );
+		if( batchLoads )
+		{
+			queuedLoads.Append( image );
+			declManager->MediaPrint( "%s\n", image->GetName() );
+		}
+		else
+		{
+			image->ActuallyLoadImage( false );	// load is from front end
+			declManager->MediaPrint( "%ix%i %s\n", image->GetUploadWidth(), image->GetUploadHeight(), image->GetName() );
+		}
 	}
 	else
 	{
@@ -636,6 +653,8 @@ void idImageManager::PurgeAllImages()
 		image = images[i];
 		image->PurgeImage();
 	}
+	
+	uploadBuffer.Shutdown();
 }
 
 /*
@@ -742,6 +761,75 @@ void R_CombineCubeImages_f( const idCmdArgs& args )
 	common->SetRefreshOnPrint( false );
 }
 
+/*
+===============
+R_ConvertImagesToBC_f
+
+Converts the DXT compressed binary images under generated/images to the formats
+used with image_useBCCompression, so data shipped without source images can use them
+===============
+*/
+void R_ConvertImagesToBC_f( const idCmdArgs& args )
+{
+	if( args.Argc() > 2 )
+	{
+		common->Printf( "USAGE: convertImagesToBC [folder]\n" );
+		return;
+	}
+	
+	idStr folder = "generated/images";
+	if( args.Argc() == 2 )
+	{
+		folder += "/";
+		folder += args.Argv( 1 );
+	}
+	
+	idFileList* files = fileSystem->ListFilesTree( folder, ".bimage", true );
+	
+	int converted = 0;
+	int skipped = 0;
+	int failed = 0;
+	
+	common->SetRefreshOnPrint( true );
+	for( int i = 0; i < files->GetNumFiles(); i++ )
+	{
+		idStr name = files->GetFile( i );
+		name.StripLeadingOnce( "generated/images/" );
+		name.StripFileExtension();
+		
+		idBinaryImage im( name );
+		if( im.LoadFromGeneratedFile( FILE_NOT_FOUND_TIMESTAMP ) == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			failed++;
+			continue;
+		}
+		
+		// only DXT images with a BC counterpart are rewritten
+		if( !im.TranscodeToBC() )
+		{
+			skipped++;
+			continue;
+		}
+		
+		// keep the source timestamp so the image isn't considered out of date
+		if( im.WriteGeneratedFile( im.GetFileHeader().sourceFileTime ) == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			failed++;
+			continue;
+		}
+		converted++;
+	}
+	common->SetRefreshOnPrint( false );
+	
+	fileSystem->FreeFileList( files );
+	
+	common->Printf( "%i images converted, %i skipped, %i failed\n", converted, skipped, failed );
+	if( converted > 0 )
+	{
+		common->Printf( "set image_useBCCompression 1 and reloadImages all to use them\n" );
+	}
+}
+
 /*
 ===============
 UnbindAll
@@ -785,6 +873,7 @@ void idImageManager::Init()
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "convertImagesToBC", R_ConvertImagesToBC_f, CMD_FL_RENDERER, "converts the DXT images in generated/images to BC4/BC5/BC7" );
 	
 	// should forceLoadImages be here?
 }
@@ -875,17 +964,51 @@ void idImageManager::Preload( const idPreloadManifest& manifest, const bool& map
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
 		
-		//fileSystem->StartPreload( preloadImageFiles );
+		// load the images in the order of their generated files in the resource containers,
+		// so the file system can stream them ahead of the loads
+		idList< preloadSort_t > preloadSort;
+		preloadSort.Resize( manifest.NumResources() );
+		idStrList generatedFiles;
+		generatedFiles.SetNum( manifest.NumResources() );
 		for( int i = 0; i < manifest.NumResources(); i++ )
 		{
 			const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
 			if( p.resType == PRELOAD_IMAGE && !ExcludePreloadImage( p.resourceName ) )
 			{
-				globalImages->ImageFromFile( p.resourceName, ( textureFilter_t )p.imgData.filter, ( textureRepeat_t )p.imgData.repeat, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
-				numLoaded++;
+				idStr generatedName = p.resourceName;
+				idImage::GetGeneratedName( generatedName, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
+				idBinaryImage::GetGeneratedFileName( generatedFiles[i], generatedName );
+				
+				preloadSort_t ps = {};
+				ps.idx = i;
+				idResourceCacheEntry rc;
+				if( fileSystem->GetResourceCacheEntry( generatedFiles[i], rc ) )
+				{
+					ps.ofs = rc.offset;
+				}
+				preloadSort.Append( ps );
 			}
 		}
-		//fileSystem->StopPreload();
+		preloadSort.SortWithTemplate( idSort_Preload() );
+		
+		idStrList preloadFiles;
+		preloadFiles.Resize( preloadSort.Num() );
+		for( int i = 0; i < preloadSort.Num(); i++ )
+		{
+			preloadFiles.Append( generatedFiles[ preloadSort[i].idx ] );
+		}
+		
+		fileSystem->StartPreload( preloadFiles );
+		batchLoads = true;
+		for( int i = 0; i < preloadSort.Num(); i++ )
+		{
+			const preloadEntry_s& p = manifest.GetPreloadByIndex( preloadSort[i].idx );
+			globalImages->ImageFromFile( p.resourceName, ( textureFilter_t )p.imgData.filter, ( textureRepeat_t )p.imgData.repeat, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
+			numLoaded++;
+		}
+		batchLoads = false;
+		LoadQueuedImages( false );
+		fileSystem->StopPreload();
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d images preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 		common->Printf( "----------------------------------------\n" );
@@ -903,24 +1026,302 @@ int idImageManager::LoadLevelImages( bool pacifier )
 	int	loadCount = 0;
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
+		idImage*	image = images[ i ];
+		if( image->generatorFunction )
+		{
+			continue;
+		}
+		if( image->levelLoadReferenced && !image->IsLoaded() )
+		{
+			loadCount++;
+			queuedLoads.Append( image );
+		}
+	}
+	LoadQueuedImages( pacifier );
+	return loadCount;
+}
+
+/*
+================================================================================================
+
+Batched image loading
+
+================================================================================================
+*/
+
+// the binary images of two batches are in memory at a time, one being uploaded and one loading
+static const int IMAGE_LOAD_BATCH	= 32;
+// images that are binarized are compressed in child jobs, the ones that don't fit run in place
+static const int IMAGE_LOAD_JOBS	= IMAGE_LOAD_BATCH * 32;
+
+struct imageLoad_t
+{
+	idImage* 		image;
+	idBinaryImage* 	binaryImage;
+	idParallelJobList* jobList;
+	bool			upload;
+};
+
+/*
+===============
+R_LoadImageDataJob
+===============
+*/
+static void R_LoadImageDataJob( imageLoad_t* load )
+{
+	load->upload = load->image->LoadImageData( *load->binaryImage, false, NULL, load->jobList );
+}
+
+REGISTER_PARALLEL_JOB( R_LoadImageDataJob, "R_LoadImageDataJob" );
+
+/*
+===============
+R_SubmitImageLoads
+===============
+*/
+static void R_SubmitImageLoads( idParallelJobList* jobList, idList< imageLoad_t >& loads, int start, int end )
+{
+	for( int i = start; i < end; i++ )
+	{
+		loads[i].binaryImage = new( TAG_IMAGE ) idBinaryImage( loads[i].image->GetName() );
+		loads[i].jobList = jobList;
+		loads[i].upload = false;
+		jobList->AddJob( ( jobRun_t )R_LoadImageDataJob, &loads[i] );
+	}
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_THREADS );
+}
+
+/*
+===============
+idImageManager::LoadQueuedImages
+
+The images are loaded and binarized in jobs, a batch at a time, while the previous batch is
+uploaded. Only the jobs use the file system while a batch is loading, the uploads don't.
+
+The jobs read the binary and source images one at a time under loadMutex and decode, parse,
+hash and compress them in parallel, the reads are also overlapped with the uploads.
+===============
+*/
+void idImageManager::LoadQueuedImages( bool pacifier )
+{
+	if( !R_IsInitialized() || !image_parallelLoad.GetBool() )
+	{
+		for( int i = 0; i < queuedLoads.Num(); i++ )
+		{
+			if( pacifier )
+			{
+				common->UpdateLevelLoadPacifier();
+			}
+			if( !queuedLoads[i]->IsLoaded() )
+			{
+				queuedLoads[i]->ActuallyLoadImage( false );
+			}
+		}
+		queuedLoads.Clear();
+		return;
+	}
+	
+	idList< imageLoad_t > loads;
+	loads.Resize( queuedLoads.Num() );
+	for( int i = 0; i < queuedLoads.Num(); i++ )
+	{
+		idImage* image = queuedLoads[i];
+		if( image->IsLoaded() )
+		{
+			continue;
+		}
+		if( image->generatorFunction )
+		{
+			// generated images need the GL context
+			image->ActuallyLoadImage( false );
+			continue;
+		}
+		imageLoad_t& load = loads.Alloc();
+		load.image = image;
+		load.binaryImage = NULL;
+		load.jobList = NULL;
+		load.upload = false;
+	}
+	queuedLoads.Clear();
+	
+	if( loads.Num() == 0 )
+	{
+		return;
+	}
+	
+	if( !uploadBuffer.IsValid() && image_uploadBufferSize.GetInteger() > 0 )
+	{
+		uploadBuffer.Init( image_uploadBufferSize.GetInteger() * 1024 * 1024 );
+	}
+	
+	idParallelJobList* jobLists[2];
+	for( int i = 0; i < 2; i++ )
+	{
+		jobLists[i] = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, IMAGE_LOAD_JOBS, 0, NULL );
+	}
+	
+	R_SubmitImageLoads( jobLists[0], loads, 0, Min( IMAGE_LOAD_BATCH, loads.Num() ) );
+	for( int start = 0, batch = 0; start < loads.Num(); start += IMAGE_LOAD_BATCH, batch++ )
+	{
+		const int end = Min( start + IMAGE_LOAD_BATCH, loads.Num() );
+		jobLists[batch & 1]->Wait();
+		
+		// nothing is loading now, so the loading screen can be drawn
 		if( pacifier )
 		{
 			common->UpdateLevelLoadPacifier();
+		}
+		
+		if( end < loads.Num() )
+		{
+			R_SubmitImageLoads( jobLists[( batch + 1 ) & 1], loads, end, Min( end + IMAGE_LOAD_BATCH, loads.Num() ) );
+		}
+		
+		for( int i = start; i < end; i++ )
+		{
+			if( loads[i].upload )
+			{
+				loads[i].image->UploadImageData( *loads[i].binaryImage, uploadBuffer.IsValid() ? &uploadBuffer : NULL );
+			}
 			
+			// closing the generated file can give a resource buffer back to the file system
+			loadMutex.Lock();
+			delete loads[i].binaryImage;
+			loadMutex.Unlock();
+			loads[i].binaryImage = NULL;
+		}
+	}
+	
+	for( int i = 0; i < 2; i++ )
+	{
+		parallelJobManager->FreeJobList( jobLists[i] );
+	}
+}
+
+struct imageBake_t
+{
+	idImage* 		image;
+	idBinaryImage* 	binaryImage;
+	idParallelJobList* jobList;
+	bool			binarized;
+	bool			failed;
+};
+
+/*
+===============
+R_BakeImageJob
+===============
+*/
+static void R_BakeImageJob( imageBake_t* bake )
+{
+	// the number of images is known before the compression is done
+	bake->failed = !bake->image->LoadImageData( *bake->binaryImage, true, &bake->binarized, bake->jobList ) || bake->binaryImage->NumImages() == 0;
+}
+
+REGISTER_PARALLEL_JOB( R_BakeImageJob, "R_BakeImageJob" );
+
+/*
+===============
+idImageManager::Bake
+
+The images are loaded with standalone idImages, so nothing is uploaded and the images that
+are in use are left alone. They are baked in batches, the binary images of a batch are kept
+until it's done because they may still be compressed in child jobs.
+===============
+*/
+void idImageManager::Bake( const idPreloadManifest& manifest, bakeStats_t& stats )
+{
+	idList< imageBake_t > bakes;
+	idStrList generatedNames;
+	idHashIndex generatedHash;
+	for( int i = 0; i < manifest.NumResources(); i++ )
+	{
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
+		if( p.resType != PRELOAD_IMAGE || ExcludePreloadImage( p.resourceName ) )
+		{
+			continue;
 		}
 		
-		idImage*	image = images[ i ];
-		if( image->generatorFunction )
+		// the same image is listed in the manifests of many maps
+		idStr generatedName = p.resourceName;
+		idImage::GetGeneratedName( generatedName, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
+		const int key = generatedHash.GenerateKey( generatedName, false );
+		int j;
+		for( j = generatedHash.First( key ); j != -1; j = generatedHash.Next( j ) )
+		{
+			if( generatedNames[j].Icmp( generatedName ) == 0 )
+			{
+				break;
+			}
+		}
+		if( j != -1 )
 		{
 			continue;
 		}
-		if( image->levelLoadReferenced && !image->IsLoaded() )
+		generatedHash.Add( key, generatedNames.Append( generatedName ) );
+		
+		idImage* image = AllocStandaloneImage( p.resourceName );
+		image->filter = ( textureFilter_t )p.imgData.filter;
+		image->repeat = ( textureRepeat_t )p.imgData.repeat;
+		image->usage = ( textureUsage_t )p.imgData.usage;
+		image->cubeFiles = ( cubeFiles_t )p.imgData.cubeMap;
+		
+		imageBake_t& bake = bakes.Alloc();
+		bake.image = image;
+		bake.binaryImage = NULL;
+		bake.jobList = NULL;
+		bake.binarized = false;
+		bake.failed = false;
+	}
+	
+	if( bakes.Num() == 0 )
+	{
+		return;
+	}
+	
+	common->Printf( "Baking %i images...\n", bakes.Num() );
+	
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, IMAGE_LOAD_JOBS, 0, NULL );
+	for( int start = 0; start < bakes.Num(); start += IMAGE_LOAD_BATCH )
+	{
+		const int end = Min( start + IMAGE_LOAD_BATCH, bakes.Num() );
+		for( int i = start; i < end; i++ )
 		{
-			loadCount++;
-			image->ActuallyLoadImage( false );
+			bakes[i].binaryImage = new( TAG_IMAGE ) idBinaryImage( bakes[i].image->GetName() );
+			bakes[i].jobList = jobList;
+			jobList->AddJob( ( jobRun_t )R_BakeImageJob, &bakes[i] );
 		}
+		jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_THREADS );
+		jobList->Wait();
+		
+		// closing the generated files can give resource buffers back to the file system
+		globalImages->loadMutex.Lock();
+		for( int i = start; i < end; i++ )
+		{
+			delete bakes[i].binaryImage;
+			bakes[i].binaryImage = NULL;
+		}
+		globalImages->loadMutex.Unlock();
+	}
+	parallelJobManager->FreeJobList( jobList );
+	
+	for( int i = 0; i < bakes.Num(); i++ )
+	{
+		if( bakes[i].failed )
+		{
+			common->Warning( "couldn't bake image '%s'", bakes[i].image->GetName() );
+			stats.failed++;
+		}
+		else if( bakes[i].binarized )
+		{
+			stats.baked++;
+		}
+		else
+		{
+			stats.upToDate++;
+		}
+		delete bakes[i].image;
 	}
-	return loadCount;
 }
 
 /*
@@ -102,6 +102,10 @@ enum textureFormat_t
 	FMT_RGBA32F,		// 128 bpp
 	FMT_R32F,			// 32 bpp
 	// RB end
+	
+	FMT_BC4,			// 4 bpp, single channel
+	FMT_BC5,			// 8 bpp, two channels
+	FMT_BC7,			// 8 bpp
 };
 
 int BitsForFormat( textureFormat_t format );
@@ -115,8 +119,8 @@ enum textureColor_t
 {
 	CFM_DEFAULT,			// RGBA
 	CFM_NORMAL_DXT5,		// XY format and use the fast DXT5 compressor
-	CFM_YCOCG_DXT5,			// convert RGBA to CoCg_Y format
-	CFM_GREEN_ALPHA,		// Copy the alpha channel to green
+	CFM_YCOCG_DXT5,			// convert RGBA to CoCg_Y format, also used with FMT_BC7
+	CFM_GREEN_ALPHA,		// Copy the alpha channel to green (red for FMT_BC4)
 	
 	// RB: don't change above for legacy .bimage compatibility
 	CFM_YCOCG_RGBA8,
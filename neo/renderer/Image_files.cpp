@@ -121,6 +121,31 @@ void R_WriteTGA( const char* filename, const byte* data, int width, int height,
 static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp );
 static void LoadJPG( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp );
 
+/*
+=============
+R_ReadImageFile
+
+The file system isn't thread safe, the image jobs read the files one at a time under the
+loadMutex of the image manager and only decode them in parallel.
+=============
+*/
+static int R_ReadImageFile( const char* name, byte** buffer, ID_TIME_T* timestamp )
+{
+	idScopedCriticalSection lock( globalImages->loadMutex );
+	return fileSystem->ReadFile( name, ( void** )buffer, timestamp );
+}
+
+/*
+=============
+R_FreeImageFile
+=============
+*/
+static void R_FreeImageFile( byte* buffer )
+{
+	idScopedCriticalSection lock( globalImages->loadMutex );
+	fileSystem->FreeFile( buffer );
+}
+
 /*
 ========================================================================
 
@@ -164,7 +189,7 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 	
 	if( !pic )
 	{
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	
@@ -173,7 +198,7 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 	//
 	// load the file
 	//
-	fileSize = fileSystem->ReadFile( name, ( void** )&buffer, timestamp );
+	fileSize = R_ReadImageFile( name, &buffer, timestamp );
 	if( !buffer )
 	{
 		return;
@@ -412,7 +437,7 @@ breakOut:
 		}
 	}
 	
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 }
 
 /*
@@ -469,6 +494,7 @@ static void LoadJPG( const char* filename, unsigned char** pic, int* width, int*
 		*pic = NULL;		// until proven otherwise
 	}
 	{
+		idScopedCriticalSection lock( globalImages->loadMutex );
 		idFile* f;
 		
 		f = fileSystem->OpenFileRead( filename );
@@ -654,7 +680,7 @@ static void LoadPNG( const char* filename, unsigned char** pic, int* width, int*
 	
 	if( !pic )
 	{
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	
@@ -663,7 +689,7 @@ static void LoadPNG( const char* filename, unsigned char** pic, int* width, int*
 	//
 	// load the file
 	//
-	int fileSize = fileSystem->ReadFile( filename, ( void** )&fbuffer, timestamp );
+	int fileSize = R_ReadImageFile( filename, &fbuffer, timestamp );
 	if( !fbuffer )
 	{
 		return;
@@ -214,6 +214,16 @@ static void R_HierarchicalZBufferImage_ResNative( idImage* image )
 }
 // RB end
 
+static void R_ClusteredLightsImage( idImage* image )
+{
+	image->GenerateImage( NULL, CLUSTERED_LIGHT_VECTORS, MAX_CLUSTERED_LIGHTS, TF_NEAREST, TR_CLAMP, TD_RGBA32F );
+}
+
+static void R_ClusterGridImage( idImage* image )
+{
+	image->GenerateImage( NULL, CLUSTER_GRID_WIDTH, CLUSTER_GRID_HEIGHT, TF_NEAREST, TR_CLAMP, TD_RGBA32F );
+}
+
 static void R_AlphaNotchImage( idImage* image )
 {
 	byte	data[2][4];
@@ -876,6 +886,9 @@ void idImageManager::CreateIntrinsicImages()
 	hierarchicalZbufferImage = ImageFromFunction( "_cszBuffer", R_HierarchicalZBufferImage_ResNative );
 	// RB end
 	
+	clusteredLightsImage = ImageFromFunction( "_clusteredLights", R_ClusteredLightsImage );
+	clusterGridImage = ImageFromFunction( "_clusterGrid", R_ClusterGridImage );
+	
 	// scratchImage is used for screen wipes/doublevision etc..
 	scratchImage = ImageFromFunction( "_scratch", R_RGBA8Image );
 	scratchImage2 = ImageFromFunction( "_scratch2", R_RGBA8Image );
@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "framework/Common_local.h"
 #include "tr_local.h"
 
+idCVar image_useBCCompression( "image_useBCCompression", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "binarize normal maps to BC5, color maps to BC7 and coverage maps to BC4 instead of DXT1/DXT5" );
+
 /*
 ================
 BitsForFormat
@@ -75,6 +77,12 @@ int BitsForFormat( textureFormat_t format )
 		case FMT_R32F:
 			return 32;
 		// RB end
+		case FMT_BC4:
+			return 4;
+		case FMT_BC5:
+			return 8;
+		case FMT_BC7:
+			return 8;
 		case FMT_DEPTH:
 			return 32;
 		case FMT_X16:
@@ -99,10 +107,13 @@ ID_INLINE void idImage::DeriveOpts()
 	{
 		opts.colorFormat = CFM_DEFAULT;
 		
+		// the BC formats need GL_ARB_texture_compression_rgtc and GL_ARB_texture_compression_bptc
+		const bool useBC = image_useBCCompression.GetBool() && glConfig.rgtcTextureCompressionAvailable && glConfig.bptcTextureCompressionAvailable;
+		
 		switch( usage )
 		{
 			case TD_COVERAGE:
-				opts.format = FMT_DXT1;
+				opts.format = useBC ? FMT_BC4 : FMT_DXT1;
 				opts.colorFormat = CFM_GREEN_ALPHA;
 				break;
 			case TD_DEPTH:
@@ -128,7 +139,7 @@ ID_INLINE void idImage::DeriveOpts()
 			case TD_DIFFUSE:
 				// TD_DIFFUSE gets only set to when its a diffuse texture for an interaction
 				opts.gammaMips = true;
-				opts.format = FMT_DXT5;
+				opts.format = useBC ? FMT_BC7 : FMT_DXT5;
 				opts.colorFormat = CFM_YCOCG_DXT5;
 				break;
 			case TD_SPECULAR:
@@ -138,15 +149,25 @@ ID_INLINE void idImage::DeriveOpts()
 				break;
 			case TD_DEFAULT:
 				opts.gammaMips = true;
-				opts.format = FMT_DXT5;
+				opts.format = useBC ? FMT_BC7 : FMT_DXT5;
 				opts.colorFormat = CFM_DEFAULT;
 				break;
 			case TD_BUMP:
-				opts.format = FMT_DXT5;
-				opts.colorFormat = CFM_NORMAL_DXT5;
+				if( useBC )
+				{
+					// sampled as .wy like the DXT5 normal maps, see idImage::SetTexParameters
+					opts.format = FMT_BC5;
+					opts.colorFormat = CFM_DEFAULT;
+				}
+				else
+				{
+					opts.format = FMT_DXT5;
+					opts.colorFormat = CFM_NORMAL_DXT5;
+				}
 				break;
 			case TD_FONT:
-				opts.format = FMT_DXT1;
+				// like the coverage maps, so fonts converted with convertImagesToBC are used as they are
+				opts.format = useBC ? FMT_BC4 : FMT_DXT1;
 				opts.colorFormat = CFM_GREEN_ALPHA;
 				opts.numLevels = 4; // We only support 4 levels because we align to 16 in the exporter
 				opts.gammaMips = true;
@@ -188,7 +209,7 @@ ID_INLINE void idImage::DeriveOpts()
 			{
 				temp_width >>= 1;
 				temp_height >>= 1;
-				if( ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 || opts.format == FMT_ETC1_RGB8_OES ) &&
+				if( ( IsCompressed() || opts.format == FMT_ETC1_RGB8_OES ) &&
 						( ( temp_width & 0x3 ) != 0 || ( temp_height & 0x3 ) != 0 ) )
 				{
 					break;
@@ -425,6 +446,88 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		return;
 	}
 	
+	idBinaryImage im( GetName() );
+	if( LoadImageData( im ) )
+	{
+		UploadImageData( im, NULL );
+	}
+}
+
+/*
+===============
+R_ImageContentHash
+
+Hash of the source pixels and the options the binary image is built with.
+===============
+*/
+static unsigned int R_ImageContentHash( const idImageOpts& opts, const byte** pics, int numPics, int picSize )
+{
+	const int params[] = { BIMAGE_VERSION, opts.format, opts.colorFormat, opts.textureType, opts.width, opts.height, opts.numLevels, opts.gammaMips };
+	
+	unsigned int hash;
+	CRC32_InitChecksum( hash );
+	CRC32_UpdateChecksum( hash, params, sizeof( params ) );
+	for( int i = 0; i < numPics; i++ )
+	{
+		CRC32_UpdateChecksum( hash, pics[i], picSize );
+	}
+	CRC32_FinishChecksum( hash );
+	return hash;
+}
+
+// the rest of a binarization whose compression runs in child jobs
+struct imageBinarize_t
+{
+	idImage* 		image;
+	idBinaryImage* 	binaryImage;
+	idStr			generatedFileName;
+	unsigned int	contentHash;
+	bool* 			binarized;
+};
+
+/*
+===============
+R_FinishImageDataJob
+
+The continuation of the job that called LoadImageData, runs once the image is compressed.
+===============
+*/
+void R_FinishImageDataJob( imageBinarize_t* binarize )
+{
+	binarize->image->FinishImageData( *binarize->binaryImage, binarize->generatedFileName, binarize->contentHash, binarize->binarized );
+	delete binarize;
+}
+
+REGISTER_PARALLEL_JOB( R_FinishImageDataJob, "R_FinishImageDataJob" );
+
+/*
+===============
+LoadImageData
+
+Loads the binary image, binarizing it from the source images if it's missing or out of date.
+This doesn't touch the GL state, so the image manager runs it in jobs when it loads images in
+batches. Returns false if there is nothing to upload.
+
+A bake also hashes the sources of binary images that are up to date by their timestamps if the
+bake cache doesn't know them yet. binarized is set if the binary image had to be rebuilt.
+
+jobList is the job list of the calling job, if any. An image that is binarized is then compressed
+in child jobs and written out by the continuation of the calling job, so im and binarized are only
+complete once the job list is done.
+===============
+*/
+bool idImage::LoadImageData( idBinaryImage& im, bool bake, bool* binarized, idParallelJobList* jobList )
+{
+	if( binarized != NULL )
+	{
+		*binarized = false;
+	}
+	
+	// the file system, the bake cache and the load pacifier aren't thread safe and are only used
+	// under loadMutex. The image loaders and the binary image only hold it for the file reads, so
+	// the jobs decode, parse, hash and compress the images in parallel.
+	idSysMutex& loadMutex = globalImages->loadMutex;
+	
 	if( com_productionMode.GetInteger() != 0 )
 	{
 		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
@@ -461,8 +564,15 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 	idStrStatic< MAX_OSPATH > generatedName = GetName();
 	GetGeneratedName( generatedName, usage, cubeFiles );
 	
-	idBinaryImage im( generatedName );
-	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+	im.SetName( generatedName );
+	
+	// the binary image was already checked against the content of sources with this timestamp
+	idStrStatic< MAX_OSPATH > generatedFileName;
+	idBinaryImage::GetGeneratedFileName( generatedFileName, generatedName );
+	loadMutex.Lock();
+	const bool verified = bakeCache.IsVerified( generatedFileName, sourceFileTime );
+	loadMutex.Unlock();
+	binaryFileTime = im.LoadFromGeneratedFile( verified ? FILE_NOT_FOUND_TIMESTAMP : sourceFileTime, &loadMutex );
 	
 	// BFHACK, do not want to tweak on buildgame so catch these images here
 	if( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP && fileSystem->UsingResourceFiles() )
@@ -474,46 +584,49 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			{
 				generatedName.Replace( "white#__0000", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, &loadMutex );
 				break;
 			}
 			if( generatedName.Find( "guis/assets/white#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "white#__0100", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, &loadMutex );
 				break;
 			}
 			if( generatedName.Find( "textures/black#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "black#__0100", "black#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, &loadMutex );
 				break;
 			}
 			if( generatedName.Find( "textures/decals/bulletglass1_d#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "bulletglass1_d#__0100", "bulletglass1_d#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, &loadMutex );
 				break;
 			}
 			if( generatedName.Find( "models/monsters/skeleton/skeleton01_d#__1000", false ) >= 0 )
 			{
 				generatedName.Replace( "skeleton01_d#__1000", "skeleton01_d#__0100" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, &loadMutex );
 				break;
 			}
 		}
 	}
 	const bimageFile_t& header = im.GetFileHeader();
 	
-	if( ( fileSystem->InProductionMode() && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) || ( ( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP )
-			&& ( header.colorFormat == opts.colorFormat )
-			&& ( header.format == opts.format )
-			&& ( header.textureType == opts.textureType )
-																							) )
+	const bool upToDate = ( fileSystem->InProductionMode() && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) || ( ( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP )
+						  && ( header.colorFormat == opts.colorFormat )
+						  && ( header.format == opts.format )
+						  && ( header.textureType == opts.textureType )
+																											  );
+	const bool hashSources = bake && upToDate && !verified && sourceFileTime != FILE_NOT_FOUND_TIMESTAMP;
+	
+	if( upToDate && !hashSources )
 	{
 		opts.width = header.width;
 		opts.height = header.height;
@@ -524,12 +637,16 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
 		{
 			// for resource gathering write this image to the preload file for this map
+			loadMutex.Lock();
 			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
+			loadMutex.Unlock();
 		}
 	}
 	else
 	{
 		idStr binarizeReason = "binarize: unknown reason";
+		unsigned int contentHash = 0;
+		bool compressing = false;
 		if( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP )
 		{
 			binarizeReason = va( "binarize: binary file not found '%s'", generatedName.c_str() );
@@ -557,7 +674,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			if( !R_LoadCubeImages( GetName(), cubeFiles, pics, &size, &sourceFileTime ) || size == 0 )
 			{
 				idLib::Warning( "Couldn't load cube image: %s", GetName() );
-				return;
+				return false;
 			}
 			
 			repeat = TR_CLAMP;
@@ -569,7 +686,18 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			
 			DeriveOpts();
 			
+			contentHash = R_ImageContentHash( opts, ( const byte** )pics, 6, size * size * 4 );
+			if( LoadBakedImageData( im, generatedFileName, contentHash, hashSources ) )
+			{
+				for( int i = 0; i < 6; i++ )
+				{
+					Mem_Free( pics[i] );
+				}
+				return true;
+			}
+			
 			// foresthale 2014-05-30: give a nice progress display when binarizing
+			loadMutex.Lock();
 			commonLocal.LoadPacifierBinarizeFilename( generatedName.c_str(), binarizeReason.c_str() );
 			if( opts.numLevels > 1 )
 			{
@@ -580,9 +708,8 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 				commonLocal.LoadPacifierBinarizeProgressTotal( opts.width * opts.width * 6 );
 			}
 			
-			im.LoadCubeFromMemory( size, ( const byte** )pics, opts.numLevels, opts.format, opts.gammaMips );
-			
-			commonLocal.LoadPacifierBinarizeEnd();
+			loadMutex.Unlock();
+			compressing = im.LoadCubeFromMemory( size, ( const byte** )pics, opts.numLevels, opts.format, opts.gammaMips, jobList );
 			
 			repeat = TR_CLAMP;
 			
@@ -590,7 +717,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			{
 				if( pics[i] )
 				{
-					Mem_Free( pics[i] );
+					im.FreeSource( pics[i], compressing );
 				}
 			}
 		}
@@ -610,17 +737,12 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 				opts.height = 8;
 				opts.numLevels = 1;
 				DeriveOpts();
-				AllocImage();
 				
-				// clear the data so it's not left uninitialized
-				idTempArray<byte> clear( opts.width * opts.height * 4 );
-				memset( clear.Ptr(), 0, clear.Size() );
-				for( int level = 0; level < opts.numLevels; level++ )
-				{
-					SubImageUpload( level, 0, 0, 0, opts.width >> level, opts.height >> level, clear.Ptr() );
-				}
-				
-				return;
+				// UploadImageData clears it if the binary image is empty
+				loadMutex.Lock();
+				im.Clear();
+				loadMutex.Unlock();
+				return true;
 			}
 			
 			opts.width = width;
@@ -628,7 +750,15 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			opts.numLevels = 0;
 			DeriveOpts();
 			
+			contentHash = R_ImageContentHash( opts, ( const byte** )&pic, 1, width * height * 4 );
+			if( LoadBakedImageData( im, generatedFileName, contentHash, hashSources ) )
+			{
+				Mem_Free( pic );
+				return true;
+			}
+			
 			// foresthale 2014-05-30: give a nice progress display when binarizing
+			loadMutex.Lock();
 			commonLocal.LoadPacifierBinarizeFilename( generatedName.c_str(), binarizeReason.c_str() );
 			if( opts.numLevels > 1 )
 			{
@@ -639,22 +769,137 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 				commonLocal.LoadPacifierBinarizeProgressTotal( opts.width * opts.width * 6 );
 			}
 			
-			im.Load2DFromMemory( opts.width, opts.height, pic, opts.numLevels, opts.format, opts.colorFormat, opts.gammaMips );
-			commonLocal.LoadPacifierBinarizeEnd();
+			loadMutex.Unlock();
+			compressing = im.Load2DFromMemory( opts.width, opts.height, pic, opts.numLevels, opts.format, opts.colorFormat, opts.gammaMips, jobList );
 			
+			// the binary image has its own copy
 			Mem_Free( pic );
 		}
-		binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
+		
+		if( compressing )
+		{
+			imageBinarize_t* binarize = new( TAG_IMAGE ) imageBinarize_t;
+			binarize->image = this;
+			binarize->binaryImage = &im;
+			binarize->generatedFileName = generatedFileName;
+			binarize->contentHash = contentHash;
+			binarize->binarized = binarized;
+			jobList->SetContinuationJob( ( jobRun_t )R_FinishImageDataJob, binarize );
+			return true;
+		}
+		FinishImageData( im, generatedFileName, contentHash, binarized );
 	}
 	
+	return true;
+}
+
+/*
+===============
+FinishImageData
+
+Writes out the binary image that LoadImageData binarized once it's compressed.
+===============
+*/
+void idImage::FinishImageData( idBinaryImage& im, const char* generatedFileName, unsigned int contentHash, bool* binarized )
+{
+	im.FinishCompression();
+	
+	idScopedCriticalSection lock( globalImages->loadMutex );
+	commonLocal.LoadPacifierBinarizeEnd();
+	binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
+	if( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP && sourceFileTime != FILE_NOT_FOUND_TIMESTAMP )
+	{
+		bakeCache.Update( generatedFileName, contentHash, sourceFileTime );
+	}
+	if( binarized != NULL )
+	{
+		*binarized = true;
+	}
+}
+
+/*
+===============
+LoadBakedImageData
+
+The sources have a different timestamp than the binary image was built with, but if their
+content is the same, as after the files were copied, the binary image doesn't need a rebuild.
+loaded is set if im already holds the binary image.
+===============
+*/
+bool idImage::LoadBakedImageData( idBinaryImage& im, const char* generatedFileName, unsigned int contentHash, bool loaded )
+{
+	idSysMutex& loadMutex = globalImages->loadMutex;
+	if( loaded )
+	{
+		// the binary image is up to date, only the content of the sources wasn't known
+		idScopedCriticalSection lock( loadMutex );
+		bakeCache.Update( generatedFileName, contentHash, sourceFileTime );
+	}
+	else
+	{
+		loadMutex.Lock();
+		const bool current = bakeCache.IsCurrent( generatedFileName, contentHash, sourceFileTime );
+		loadMutex.Unlock();
+		if( !current )
+		{
+			return false;
+		}
+		
+		binaryFileTime = im.LoadFromGeneratedFile( FILE_NOT_FOUND_TIMESTAMP, &loadMutex );
+		const bimageFile_t& header = im.GetFileHeader();
+		if( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP || header.format != opts.format || header.colorFormat != opts.colorFormat || header.textureType != opts.textureType )
+		{
+			idScopedCriticalSection lock( loadMutex );
+			im.Clear();
+			return false;
+		}
+	}
+	
+	const bimageFile_t& header = im.GetFileHeader();
+	opts.width = header.width;
+	opts.height = header.height;
+	opts.numLevels = header.numLevels;
+	return true;
+}
+
+/*
+===============
+UploadImageData
+
+Creates the texture and uploads the images of a binary image that was loaded by LoadImageData,
+through the upload buffer if there is one.
+===============
+*/
+void idImage::UploadImageData( const idBinaryImage& im, idImageUploadBuffer* uploadBuffer )
+{
 	AllocImage();
 	
+	if( im.NumImages() == 0 )
+	{
+		// the image couldn't be loaded, clear the default so it's not left uninitialized
+		idTempArray<byte> clear( opts.width * opts.height * 4 );
+		memset( clear.Ptr(), 0, clear.Size() );
+		for( int level = 0; level < opts.numLevels; level++ )
+		{
+			SubImageUpload( level, 0, 0, 0, opts.width >> level, opts.height >> level, clear.Ptr() );
+		}
+		return;
+	}
 	
 	for( int i = 0; i < im.NumImages(); i++ )
 	{
 		const bimageImage_t& img = im.GetImageHeader( i );
 		const byte* data = im.GetImageData( i );
-		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+		const int offset = ( uploadBuffer != NULL ) ? uploadBuffer->Stage( data, img.dataSize ) : -1;
+		if( offset >= 0 )
+		{
+			SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, ( const void* )( intptr_t )offset );
+			uploadBuffer->EndUpload();
+		}
+		else
+		{
+			SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+		}
 	}
 }
 
@@ -1015,6 +1260,9 @@ void idImage::Print() const
 			NAME_FORMAT( RGBA32F );
 			NAME_FORMAT( R32F );
 			// RB end
+			NAME_FORMAT( BC4 );
+			NAME_FORMAT( BC5 );
+			NAME_FORMAT( BC7 );
 			NAME_FORMAT( DEPTH );
 			NAME_FORMAT( X16 );
 			NAME_FORMAT( Y16_X16 );
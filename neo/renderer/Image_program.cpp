@@ -373,16 +373,19 @@ static void R_ImageAdd( byte* data1, int width1, int height1, byte* data2, int w
 }
 
 
-// we build a canonical token form of the image program here
-static char parseBuffer[MAX_IMAGE_NAME];
-
 /*
 ===================
 AppendToken
+
+Builds the canonical token form of the image program in parseBuffer, if there is one
 ===================
 */
-static void AppendToken( idToken& token )
+static void AppendToken( char* parseBuffer, idToken& token )
 {
+	if( parseBuffer == NULL )
+	{
+		return;
+	}
 	// add a leading space if not at the beginning
 	if( parseBuffer[0] )
 	{
@@ -396,9 +399,9 @@ static void AppendToken( idToken& token )
 MatchAndAppendToken
 ===================
 */
-static void MatchAndAppendToken( idLexer& src, const char* match )
+static void MatchAndAppendToken( char* parseBuffer, idLexer& src, const char* match )
 {
-	if( !src.ExpectTokenString( match ) )
+	if( !src.ExpectTokenString( match ) || parseBuffer == NULL )
 	{
 		return;
 	}
@@ -413,10 +416,11 @@ R_ParseImageProgram_r
 If pic is NULL, the timestamps will be filled in, but no image will be generated
 If both pic and timestamps are NULL, it will just advance past it, which can be
 used to parse an image program from a text stream.
+The canonical form of the program is appended to parseBuffer if it isn't NULL.
 ===================
 */
 static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* height,
-								   ID_TIME_T* timestamps, textureUsage_t* usage )
+								   ID_TIME_T* timestamps, textureUsage_t* usage, char* parseBuffer )
 {
 	idToken		token;
 	float		scale;
@@ -439,21 +443,21 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 		token = "guis\\assets\\white";
 	}
 	
-	AppendToken( token );
+	AppendToken( parseBuffer, token );
 	
 	if( !token.Icmp( "heightmap" ) )
 	{
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer ) )
 		{
 			return false;
 		}
 		
-		MatchAndAppendToken( src, "," );
+		MatchAndAppendToken( parseBuffer, src, "," );
 		
 		src.ReadToken( &token );
-		AppendToken( token );
+		AppendToken( parseBuffer, token );
 		scale = token.GetFloatValue();
 		
 		// process it
@@ -466,7 +470,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			}
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -475,16 +479,16 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 		byte*	pic2 = NULL;
 		int		width2, height2;
 		
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer ) )
 		{
 			return false;
 		}
 		
-		MatchAndAppendToken( src, "," );
+		MatchAndAppendToken( parseBuffer, src, "," );
 		
-		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, usage, parseBuffer ) )
 		{
 			if( pic )
 			{
@@ -505,15 +509,15 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			}
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
 	if( !token.Icmp( "smoothnormals" ) )
 	{
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer ) )
 		{
 			return false;
 		}
@@ -527,7 +531,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			}
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -536,16 +540,16 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 		byte*	pic2 = NULL;
 		int		width2, height2;
 		
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer ) )
 		{
 			return false;
 		}
 		
-		MatchAndAppendToken( src, "," );
+		MatchAndAppendToken( parseBuffer, src, "," );
 		
-		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, usage ) )
+		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, usage, parseBuffer ) )
 		{
 			if( pic )
 			{
@@ -562,7 +566,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			R_StaticFree( pic2 );
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -571,15 +575,15 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 		float	scale[4];
 		int		i;
 		
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer );
 		
 		for( i = 0 ; i < 4 ; i++ )
 		{
-			MatchAndAppendToken( src, "," );
+			MatchAndAppendToken( parseBuffer, src, "," );
 			src.ReadToken( &token );
-			AppendToken( token );
+			AppendToken( parseBuffer, token );
 			scale[i] = token.GetFloatValue();
 		}
 		
@@ -589,15 +593,15 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			R_ImageScale( *pic, *width, *height, scale );
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
 	if( !token.Icmp( "invertAlpha" ) )
 	{
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer );
 		
 		// process it
 		if( pic )
@@ -605,15 +609,15 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			R_InvertAlpha( *pic, *width, *height );
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
 	if( !token.Icmp( "invertColor" ) )
 	{
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer );
 		
 		// process it
 		if( pic )
@@ -621,7 +625,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			R_InvertColor( *pic, *width, *height );
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -629,9 +633,9 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		int		i;
 		
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer );
 		
 		// copy red to green, blue, and alpha
 		if( pic )
@@ -646,7 +650,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			}
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -654,9 +658,9 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		int		i;
 		
-		MatchAndAppendToken( src, "(" );
+		MatchAndAppendToken( parseBuffer, src, "(" );
 		
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, parseBuffer );
 		
 		// average RGB into alpha, then set RGB to white
 		if( pic )
@@ -672,7 +676,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 			}
 		}
 		
-		MatchAndAppendToken( src, ")" );
+		MatchAndAppendToken( parseBuffer, src, ")" );
 		return true;
 	}
 	
@@ -707,6 +711,8 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 /*
 ===================
 R_LoadImageProgram
+
+Doesn't touch any shared state, the image jobs load image programs concurrently.
 ===================
 */
 void R_LoadImageProgram( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamps, textureUsage_t* usage )
@@ -716,13 +722,12 @@ void R_LoadImageProgram( const char* name, byte** pic, int* width, int* height,
 	src.LoadMemory( name, strlen( name ), name );
 	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
 	
-	parseBuffer[0] = 0;
 	if( timestamps )
 	{
 		*timestamps = 0;
 	}
 	
-	R_ParseImageProgram_r( src, pic, width, height, timestamps, usage );
+	R_ParseImageProgram_r( src, pic, width, height, timestamps, usage, NULL );
 	
 	src.FreeSource();
 }
@@ -730,12 +735,16 @@ void R_LoadImageProgram( const char* name, byte** pic, int* width, int* height,
 /*
 ===================
 R_ParsePastImageProgram
+
+The returned canonical form is only valid until the next call, the materials are parsed on
+the main thread.
 ===================
 */
 const char* R_ParsePastImageProgram( idLexer& src )
 {
+	static char parseBuffer[MAX_IMAGE_NAME];
 	parseBuffer[0] = 0;
-	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL );
+	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL, parseBuffer );
 	return parseBuffer;
 }
 
@@ -2288,6 +2288,12 @@ void idMaterial::ParseMaterial( idLexer& src )
 			SetMaterialFlag( MF_NOPORTALFOG );
 			continue;
 		}
+		// occluder lets the surfaces of non-world models hide what is behind them for occlusion culling
+		else if( !token.Icmp( "occluder" ) )
+		{
+			SetMaterialFlag( MF_OCCLUDER );
+			continue;
+		}
 		// forceShadows allows nodraw surfaces to cast shadows
 		else if( !token.Icmp( "forceShadows" ) )
 		{
@@ -290,7 +290,8 @@ typedef enum
 	MF_LOD2						= BIT( 8 ),	 // motorsep 11-24-2014; material flag for LOD2 iteration
 	MF_LOD3						= BIT( 9 ),	 // motorsep 11-24-2014; material flag for LOD3 iteration
 	MF_LOD4						= BIT( 10 ), // motorsep 11-24-2014; material flag for LOD4 iteration
-	MF_LOD_PERSISTENT			= BIT( 11 )	 // motorsep 11-24-2014; material flag for persistent LOD iteration
+	MF_LOD_PERSISTENT			= BIT( 11 ),	 // motorsep 11-24-2014; material flag for persistent LOD iteration
+	MF_OCCLUDER					= BIT( 12 )	 // surfaces of non-world models hide what is behind them for occlusion culling
 } materialFlags_t;
 
 // contents flags, NOTE: make sure to keep the defines in doom_defs.script up to date with these!
@@ -451,6 +452,13 @@ public:
 		return hasSubview;
 	}
 	
+	// returns true if the surfaces can be used for software occlusion culling, all opaque
+	// world surfaces are occluders, other models need the "occluder" keyword
+	bool				IsOccluder( bool worldSurface ) const
+	{
+		return ( IsDrawn() && coverage == MC_OPAQUE && !hasSubview && deform == DFRM_NONE && ( worldSurface || TestMaterialFlag( MF_OCCLUDER ) ) );
+	}
+	
 	// returns true if the material will generate shadows, not making a
 	// distinction between global and no-self shadows
 	bool				SurfaceCastsShadow() const
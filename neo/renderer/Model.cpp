@@ -69,6 +69,8 @@ idRenderModelStatic::idRenderModelStatic()
 	hasInteractingSurfaces = true;
 	hasShadowCastingSurfaces = true;
 	timeStamp = 0;
+	loadingInJob = false;
+	jobMaterialsMissing = false;
 	numInvertedJoints = 0;
 	jointsInverted = NULL;
 	jointsInvertedBuffer = 0;
@@ -383,7 +385,10 @@ bool idRenderModelStatic::LoadBinaryModel( idFile* file, const ID_TIME_T sourceT
 	}
 	// RB end
 	
-	common->UpdateLevelLoadPacifier();
+	if( !loadingInJob )
+	{
+		common->UpdateLevelLoadPacifier();
+	}
 	
 	int numSurfaces;
 	file->ReadBig( numSurfaces );
@@ -399,7 +404,7 @@ bool idRenderModelStatic::LoadBinaryModel( idFile* file, const ID_TIME_T sourceT
 		}
 		else
 		{
-			surfaces[i].shader = declManager->FindMaterial( materialName );
+			surfaces[i].shader = FindBinaryMaterial( materialName );
 		}
 		
 		bool isGeometry;
@@ -551,6 +556,65 @@ bool idRenderModelStatic::LoadBinaryModel( idFile* file, const ID_TIME_T sourceT
 	return true;
 }
 
+/*
+========================
+idRenderModelStatic::LoadBinaryModelInJob
+========================
+*/
+bool idRenderModelStatic::LoadBinaryModelInJob( idFile* file, const ID_TIME_T sourceTimeStamp )
+{
+	loadingInJob = true;
+	jobMaterialsMissing = false;
+	
+	bool loaded = LoadBinaryModel( file, sourceTimeStamp );
+	
+	loadingInJob = false;
+	
+	return loaded && !jobMaterialsMissing;
+}
+
+/*
+========================
+idRenderModelStatic::FinishBinaryModel
+
+re-finds the materials looked up by the job so they get added to the level keep list
+========================
+*/
+void idRenderModelStatic::FinishBinaryModel()
+{
+	for( int i = 0; i < surfaces.Num(); i++ )
+	{
+		if( surfaces[i].shader != NULL )
+		{
+			declManager->FindMaterial( surfaces[i].shader->GetName() );
+		}
+	}
+}
+
+/*
+========================
+idRenderModelStatic::FindBinaryMaterial
+
+A job may not parse decls, so it only takes materials that are already parsed.
+The decl manager is only changed on the main thread, which waits for the jobs.
+========================
+*/
+const idMaterial* idRenderModelStatic::FindBinaryMaterial( const char* materialName )
+{
+	if( !loadingInJob )
+	{
+		return declManager->FindMaterial( materialName );
+	}
+	
+	const idDecl* decl = declManager->FindDeclWithoutParsing( DECL_MATERIAL, materialName, false );
+	if( decl == NULL || decl->GetState() == DS_UNPARSED )
+	{
+		jobMaterialsMissing = true;
+		return tr.defaultMaterial;
+	}
+	return static_cast<const idMaterial*>( decl );
+}
+
 /*
 ========================
 idRenderModelStatic::WriteBinaryModel
@@ -1211,11 +1275,22 @@ void idRenderModelStatic::FinishSurfaces()
 	}
 	
 	// clean the surfaces
+	idTempArray< cleanupTriangles_t > cleanups( surfaces.Num() );
+	for( i = 0; i < surfaces.Num(); i++ )
+	{
+		const modelSurface_t*	surf = &surfaces[i];
+		
+		cleanups[i].tri = surf->geometry;
+		cleanups[i].createNormals = surf->geometry->generateNormals;
+		cleanups[i].identifySilEdges = true;
+		cleanups[i].useUnsmoothedTangents = surf->shader->UseUnsmoothedTangents();
+	}
+	R_CleanupTrianglesList( cleanups.Ptr(), surfaces.Num() );
+	
 	for( i = 0; i < surfaces.Num(); i++ )
 	{
 		const modelSurface_t*	surf = &surfaces[i];
 		
-		R_CleanupTriangles( surf->geometry, surf->geometry->generateNormals, true, surf->shader->UseUnsmoothedTangents() );
 		if( surf->shader->SurfaceCastsShadow() )
 		{
 			totalVerts += surf->geometry->numVerts;
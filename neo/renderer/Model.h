@@ -172,6 +172,15 @@ public:
 	virtual void				WriteBinaryModel( idFile* file, ID_TIME_T* _timeStamp = NULL ) const = 0;
 	virtual bool				SupportsBinaryModel() = 0;
 	
+	// LoadBinaryModel that is safe to call from a job: materials are only looked
+	// up, never parsed, and no vertex cache or level load pacifier work is done.
+	// Returns false if the file is out of date or a material was not parsed yet,
+	// in which case the model should be purged and loaded on the main thread.
+	virtual bool				LoadBinaryModelInJob( idFile* file, const ID_TIME_T sourceTimeStamp ) = 0;
+	
+	// called on the main thread after LoadBinaryModelInJob succeeded
+	virtual void				FinishBinaryModel() = 0;
+	
 	// RB begin
 	virtual void				ExportOBJ( idFile* objFile, idFile* mtlFile, ID_TIME_T* _timeStamp = NULL ) const = 0;
 	// RB end
@@ -34,11 +34,14 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar binaryLoadRenderModels( "binaryLoadRenderModels", "1", 0, "enable binary load/write of render models" );
 idCVar preload_MapModels( "preload_MapModels", "1", CVAR_SYSTEM | CVAR_BOOL, "preload models during begin or end levelload" );
+idCVar preload_MapModelsInJobs( "preload_MapModelsInJobs", "1", CVAR_SYSTEM | CVAR_BOOL, "load the binary models of the preload manifest in jobs" );
 
 // RB begin
 idCVar postLoadExportModels( "postLoadExportModels", "0", CVAR_BOOL | CVAR_RENDERER, "export models after loading to OBJ model format" );
 // RB end
 
+struct modelLoad_t;
+
 class idRenderModelManagerLocal : public idRenderModelManager
 {
 public:
@@ -60,6 +63,7 @@ public:
 	virtual void			BeginLevelLoad();
 	virtual void			EndLevelLoad();
 	virtual void			Preload( const idPreloadManifest& manifest );
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats );
 	
 	virtual	void			PrintMemInfo( MemInfo_t* mi );
 	
@@ -72,6 +76,12 @@ private:
 	bool					insideLevelLoad;		// don't actually load now
 	
 	idRenderModel* 			GetModel( const char* modelName, bool createIfNotFound );
+	idRenderModel* 			LookupModel( const char* canonical );
+	idRenderModel* 			RegisterModel( idRenderModel* model, const char* canonical, bool createIfNotFound );
+	
+	void					PreloadInJobs( const idPreloadManifest& manifest, idList< modelLoad_t >& loads );
+	void					PrepareModelLoads( const idPreloadManifest& manifest, idList< modelLoad_t >& loads, int start, int end );
+	void					FinishModelLoads( const idPreloadManifest& manifest, idList< modelLoad_t >& loads, int start, int end );
 	
 	static void				PrintModel_f( const idCmdArgs& args );
 	static void				ListModels_f( const idCmdArgs& args );
@@ -272,6 +282,80 @@ void idRenderModelManagerLocal::Shutdown()
 	hash.Free();
 }
 
+/*
+=================
+R_AllocModelForExtension
+
+Returns NULL if it's not one of the known formats.
+=================
+*/
+static idRenderModel* R_AllocModelForExtension( const char* extension )
+{
+	// RB: added dae
+	if( ( idStr::Icmp( extension, "dae" ) == 0 ) || ( idStr::Icmp( extension, "ase" ) == 0 ) || ( idStr::Icmp( extension, "lwo" ) == 0 ) || ( idStr::Icmp( extension, "flt" ) == 0 ) || ( idStr::Icmp( extension, "ma" ) == 0 ) )
+	{
+		return new( TAG_MODEL ) idRenderModelStatic;
+	}
+	else if( idStr::Icmp( extension, MD5_MESH_EXT ) == 0 )
+	{
+		return new( TAG_MODEL ) idRenderModelMD5;
+	}
+	else if( idStr::Icmp( extension, "md3" ) == 0 )
+	{
+		return new( TAG_MODEL ) idRenderModelMD3;
+	}
+	else if( idStr::Icmp( extension, "prt" ) == 0 )
+	{
+		return new( TAG_MODEL ) idRenderModelPrt;
+	}
+	else if( idStr::Icmp( extension, "liquid" ) == 0 )
+	{
+		return new( TAG_MODEL ) idRenderModelLiquid;
+	}
+	return NULL;
+}
+
+/*
+=================
+R_LoadBinaryModel
+
+Loads the binary model if it was built from the current source. When the source was only
+copied the timestamps don't match anymore, but the bake cache knows the source content.
+=================
+*/
+static bool R_LoadBinaryModel( idRenderModel* model, idFile* file, const char* generatedFileName, const char* sourceName, ID_TIME_T sourceTimeStamp )
+{
+	if( file == NULL )
+	{
+		return false;
+	}
+	if( model->LoadBinaryModel( file, sourceTimeStamp ) )
+	{
+		return true;
+	}
+	if( !bakeCache.IsFileCurrent( generatedFileName, sourceName, sourceTimeStamp, 0 ) )
+	{
+		return false;
+	}
+	file->Seek( 0, FS_SEEK_SET );
+	return model->LoadBinaryModel( file, FILE_NOT_FOUND_TIMESTAMP );
+}
+
+/*
+=================
+R_WriteBinaryModel
+=================
+*/
+static void R_WriteBinaryModel( idRenderModel* model, const char* generatedFileName, const char* sourceName, ID_TIME_T sourceTimeStamp )
+{
+	{
+		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
+		idLib::Printf( "Writing %s\n", generatedFileName );
+		model->WriteBinaryModel( outputFile );
+	}
+	bakeCache.UpdateFile( generatedFileName, sourceName, sourceTimeStamp, 0 );
+}
+
 /*
 =================
 idRenderModelManagerLocal::GetModel
@@ -313,7 +397,7 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 				{
 					idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
 					model->PurgeModel();
-					if( !model->LoadBinaryModel( file, sourceTimeStamp ) )
+					if( !R_LoadBinaryModel( model, file, generatedFileName, canonical, sourceTimeStamp ) )
 					{
 						model->LoadModel();
 					}
@@ -338,30 +422,7 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 	// see if we can load it
 	
 	// determine which subclass of idRenderModel to initialize
-	
-	idRenderModel* model = NULL;
-	
-	// RB: added dae
-	if( ( extension.Icmp( "dae" ) == 0 ) || ( extension.Icmp( "ase" ) == 0 ) || ( extension.Icmp( "lwo" ) == 0 ) || ( extension.Icmp( "flt" ) == 0 ) || ( extension.Icmp( "ma" ) == 0 ) )
-	{
-		model = new( TAG_MODEL ) idRenderModelStatic;
-	}
-	else if( extension.Icmp( MD5_MESH_EXT ) == 0 )
-	{
-		model = new( TAG_MODEL ) idRenderModelMD5;
-	}
-	else if( extension.Icmp( "md3" ) == 0 )
-	{
-		model = new( TAG_MODEL ) idRenderModelMD3;
-	}
-	else if( extension.Icmp( "prt" ) == 0 )
-	{
-		model = new( TAG_MODEL ) idRenderModelPrt;
-	}
-	else if( extension.Icmp( "liquid" ) == 0 )
-	{
-		model = new( TAG_MODEL ) idRenderModelLiquid;
-	}
+	idRenderModel* model = R_AllocModelForExtension( extension );
 	
 	idStrStatic< MAX_OSPATH > generatedFileName;
 	
@@ -383,16 +444,14 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 		}
 		else
 		{
-			if( !model->LoadBinaryModel( file, sourceTimeStamp ) )
+			if( !R_LoadBinaryModel( model, file, generatedFileName, canonical, sourceTimeStamp ) )
 			{
 				model->InitFromFile( canonical );
 				
 				// RB: default models shouldn't be cached as binary models
 				if( !model->IsDefaultModel() )
 				{
-					idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
-					idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
-					model->WriteBinaryModel( outputFile );
+					R_WriteBinaryModel( model, generatedFileName, canonical, sourceTimeStamp );
 				}
 				// RB end
 			} /* else {
@@ -422,6 +481,18 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 		model = smodel;
 	}
 	
+	return RegisterModel( model, canonical, createIfNotFound );
+}
+
+/*
+=================
+idRenderModelManagerLocal::RegisterModel
+
+Adds a newly loaded model to the manager, or deletes it if it defaulted and createIfNotFound isn't set
+=================
+*/
+idRenderModel* idRenderModelManagerLocal::RegisterModel( idRenderModel* model, const char* canonical, bool createIfNotFound )
+{
 	if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
 	{
 		fileSystem->AddModelPreload( canonical );
@@ -473,6 +544,24 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 	return model;
 }
 
+/*
+=================
+idRenderModelManagerLocal::LookupModel
+=================
+*/
+idRenderModel* idRenderModelManagerLocal::LookupModel( const char* canonical )
+{
+	int key = hash.GenerateKey( canonical, false );
+	for( int i = hash.First( key ); i != -1; i = hash.Next( i ) )
+	{
+		if( idStr::Icmp( canonical, models[i]->Name() ) == 0 )
+		{
+			return models[i];
+		}
+	}
+	return NULL;
+}
+
 /*
 =================
 idRenderModelManagerLocal::AllocModel
@@ -666,6 +755,231 @@ void idRenderModelManagerLocal::BeginLevelLoad()
 	vertexCache.FreeStaticData();
 }
 
+/*
+================================================================================================
+
+Batched model loading
+
+================================================================================================
+*/
+
+// the generated files of two batches are open at a time, one being loaded and one opened
+static const int MODEL_LOAD_BATCH	= 32;
+
+struct modelLoad_t
+{
+	modelLoad_t()
+	{
+		manifestIndex = -1;
+		model = NULL;
+		file = NULL;
+		sourceTimeStamp = FILE_NOT_FOUND_TIMESTAMP;
+		isNew = false;
+		loaded = false;
+	}
+	
+	int				manifestIndex;
+	idStr			canonical;
+	idRenderModel* 	model;				// NULL if the entry is loaded on the main thread
+	idFile* 		file;
+	ID_TIME_T		sourceTimeStamp;
+	bool			isNew;				// not registered with the manager yet
+	bool			loaded;
+};
+
+/*
+=================
+R_LoadModelJob
+=================
+*/
+static void R_LoadModelJob( modelLoad_t* load )
+{
+	load->loaded = load->model->LoadBinaryModelInJob( load->file, load->sourceTimeStamp );
+}
+
+REGISTER_PARALLEL_JOB( R_LoadModelJob, "R_LoadModelJob" );
+
+/*
+=================
+idRenderModelManagerLocal::PrepareModelLoads
+
+Opens the generated files and allocates the models of a batch on the main thread. Entries that
+can't be loaded from a binary model are left for FinishModelLoads.
+=================
+*/
+void idRenderModelManagerLocal::PrepareModelLoads( const idPreloadManifest& manifest, idList< modelLoad_t >& loads, int start, int end )
+{
+	for( int i = start; i < end; i++ )
+	{
+		modelLoad_t& load = loads[i];
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( load.manifestIndex );
+		if( p.resType != PRELOAD_MODEL )
+		{
+			continue;
+		}
+		
+		load.canonical = p.resourceName;
+		load.canonical.ToLower();
+		
+		// a model that is listed twice is found by the second entry once the first one is registered
+		bool duplicate = false;
+		for( int j = Max( 0, start - MODEL_LOAD_BATCH ); j < i && !duplicate; j++ )
+		{
+			duplicate = ( loads[j].model != NULL && load.canonical.Icmp( loads[j].canonical ) == 0 );
+		}
+		if( duplicate )
+		{
+			continue;
+		}
+		
+		idStrStatic< MAX_OSPATH > extension;
+		load.canonical.ExtractFileExtension( extension );
+		
+		idRenderModel* model = LookupModel( load.canonical );
+		if( model != NULL )
+		{
+			if( model->IsLoaded() || !model->SupportsBinaryModel() )
+			{
+				continue;
+			}
+			load.isNew = false;
+		}
+		else
+		{
+			model = R_AllocModelForExtension( extension );
+			if( model == NULL )
+			{
+				continue;
+			}
+			if( !model->SupportsBinaryModel() )
+			{
+				delete model;
+				continue;
+			}
+			load.isNew = true;
+		}
+		
+		idStrStatic< MAX_OSPATH > generatedFileName = "generated/rendermodels/";
+		generatedFileName.AppendPath( load.canonical );
+		generatedFileName.SetFileExtension( va( "b%s", extension.c_str() ) );
+		
+		load.sourceTimeStamp = fileSystem->GetTimestamp( load.canonical );
+		load.file = fileSystem->OpenFileReadMemory( generatedFileName );
+		if( load.file == NULL )
+		{
+			if( load.isNew )
+			{
+				delete model;
+			}
+			continue;
+		}
+		
+		if( !load.isNew )
+		{
+			model->PurgeModel();
+		}
+		load.model = model;
+	}
+}
+
+/*
+=================
+idRenderModelManagerLocal::FinishModelLoads
+
+Registers the models of a batch once its jobs are done. Everything a job couldn't load goes
+through FindModel, which also rebuilds out of date binary models.
+=================
+*/
+void idRenderModelManagerLocal::FinishModelLoads( const idPreloadManifest& manifest, idList< modelLoad_t >& loads, int start, int end )
+{
+	for( int i = start; i < end; i++ )
+	{
+		modelLoad_t& load = loads[i];
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( load.manifestIndex );
+		
+		delete load.file;
+		load.file = NULL;
+		
+		if( p.resType == PRELOAD_PARTICLE )
+		{
+			declManager->FindType( DECL_PARTICLE, p.resourceName );
+			continue;
+		}
+		if( p.resType != PRELOAD_MODEL )
+		{
+			continue;
+		}
+		
+		idRenderModel* model = load.model;
+		if( model != NULL && load.loaded )
+		{
+			model->FinishBinaryModel();
+			if( load.isNew )
+			{
+				model = RegisterModel( model, load.canonical, true );
+			}
+		}
+		else
+		{
+			if( model != NULL )
+			{
+				model->PurgeModel();
+				if( load.isNew )
+				{
+					delete model;
+				}
+			}
+			model = FindModel( p.resourceName );
+		}
+		
+		if( model != NULL )
+		{
+			model->SetLevelLoadReferenced( true );
+		}
+	}
+}
+
+/*
+=================
+idRenderModelManagerLocal::PreloadInJobs
+
+The binary models are read in jobs, a batch at a time, while the files of the next batch are
+opened. Materials, vertex caches and the model list are only touched on the main thread while
+no jobs are running, so a model whose materials are not parsed yet is loaded again by FindModel.
+=================
+*/
+void idRenderModelManagerLocal::PreloadInJobs( const idPreloadManifest& manifest, idList< modelLoad_t >& loads )
+{
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MODEL_LOAD_BATCH, 0, NULL );
+	
+	PrepareModelLoads( manifest, loads, 0, Min( MODEL_LOAD_BATCH, loads.Num() ) );
+	for( int start = 0; start < loads.Num(); start += MODEL_LOAD_BATCH )
+	{
+		const int end = Min( start + MODEL_LOAD_BATCH, loads.Num() );
+		for( int i = start; i < end; i++ )
+		{
+			if( loads[i].model != NULL )
+			{
+				jobList->AddJob( ( jobRun_t )R_LoadModelJob, &loads[i] );
+			}
+		}
+		jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		
+		if( end < loads.Num() )
+		{
+			PrepareModelLoads( manifest, loads, end, Min( end + MODEL_LOAD_BATCH, loads.Num() ) );
+		}
+		
+		jobList->Wait();
+		
+		common->UpdateLevelLoadPacifier();
+		
+		FinishModelLoads( manifest, loads, start, end );
+	}
+	
+	parallelJobManager->FreeJobList( jobList );
+}
+
 /*
 =================
 idRenderModelManagerLocal::Preload
@@ -680,6 +994,8 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest& manifest )
 		int numLoaded = 0;
 		idList< preloadSort_t > preloadSort;
 		preloadSort.Resize( manifest.NumResources() );
+		idStrList generatedFiles;
+		generatedFiles.SetNum( manifest.NumResources() );
 		for( int i = 0; i < manifest.NumResources(); i++ )
 		{
 			const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
@@ -707,30 +1023,54 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest& manifest )
 					ps.idx = i;
 					ps.ofs = rc.offset;
 					preloadSort.Append( ps );
+					generatedFiles[i] = filename;
 				}
 			}
 		}
 		
 		preloadSort.SortWithTemplate( idSort_Preload() );
 		
+		idStrList preloadFiles;
+		preloadFiles.Resize( preloadSort.Num() );
 		for( int i = 0; i < preloadSort.Num(); i++ )
 		{
-			const preloadSort_t& ps = preloadSort[ i ];
-			const preloadEntry_s& p = manifest.GetPreloadByIndex( ps.idx );
-			if( p.resType == PRELOAD_MODEL )
+			preloadFiles.Append( generatedFiles[ preloadSort[i].idx ] );
+		}
+		
+		fileSystem->StartPreload( preloadFiles );
+		if( preload_MapModelsInJobs.GetBool() && binaryLoadRenderModels.GetBool() )
+		{
+			idList< modelLoad_t > loads;
+			loads.SetNum( preloadSort.Num() );
+			for( int i = 0; i < preloadSort.Num(); i++ )
 			{
-				idRenderModel* model = FindModel( p.resourceName );
-				if( model != NULL )
-				{
-					model->SetLevelLoadReferenced( true );
-				}
+				loads[i].manifestIndex = preloadSort[i].idx;
 			}
-			else if( p.resType == PRELOAD_PARTICLE )
+			PreloadInJobs( manifest, loads );
+			numLoaded = loads.Num();
+		}
+		else
+		{
+			for( int i = 0; i < preloadSort.Num(); i++ )
 			{
-				declManager->FindType( DECL_PARTICLE, p.resourceName );
+				const preloadSort_t& ps = preloadSort[ i ];
+				const preloadEntry_s& p = manifest.GetPreloadByIndex( ps.idx );
+				if( p.resType == PRELOAD_MODEL )
+				{
+					idRenderModel* model = FindModel( p.resourceName );
+					if( model != NULL )
+					{
+						model->SetLevelLoadReferenced( true );
+					}
+				}
+				else if( p.resType == PRELOAD_PARTICLE )
+				{
+					declManager->FindType( DECL_PARTICLE, p.resourceName );
+				}
+				numLoaded++;
 			}
-			numLoaded++;
 		}
+		fileSystem->StopPreload();
 		
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d models preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
@@ -738,6 +1078,97 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest& manifest )
 	}
 }
 
+/*
+=================
+idRenderModelManagerLocal::Bake
+
+The model loaders use the decl manager, so unlike the images the models are baked one at a time.
+=================
+*/
+void idRenderModelManagerLocal::Bake( const idPreloadManifest& manifest, bakeStats_t& stats )
+{
+	if( !binaryLoadRenderModels.GetBool() )
+	{
+		return;
+	}
+	
+	idStrList modelNames;
+	idHashIndex modelHash;
+	for( int i = 0; i < manifest.NumResources(); i++ )
+	{
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
+		if( p.resType != PRELOAD_MODEL )
+		{
+			continue;
+		}
+		const int key = modelHash.GenerateKey( p.resourceName, false );
+		int j;
+		for( j = modelHash.First( key ); j != -1; j = modelHash.Next( j ) )
+		{
+			if( modelNames[j].Icmp( p.resourceName ) == 0 )
+			{
+				break;
+			}
+		}
+		if( j == -1 )
+		{
+			modelHash.Add( key, modelNames.Append( p.resourceName ) );
+		}
+	}
+	
+	if( modelNames.Num() == 0 )
+	{
+		return;
+	}
+	
+	common->Printf( "Baking %i models...\n", modelNames.Num() );
+	
+	for( int i = 0; i < modelNames.Num(); i++ )
+	{
+		idStrStatic< MAX_OSPATH > canonical = modelNames[i];
+		canonical.ToLower();
+		
+		idStrStatic< MAX_OSPATH > extension;
+		canonical.ExtractFileExtension( extension );
+		
+		idRenderModel* model = R_AllocModelForExtension( extension );
+		if( model == NULL || !model->SupportsBinaryModel() )
+		{
+			delete model;
+			continue;
+		}
+		
+		idStrStatic< MAX_OSPATH > generatedFileName = "generated/rendermodels/";
+		generatedFileName.AppendPath( canonical );
+		generatedFileName.SetFileExtension( va( "b%s", extension.c_str() ) );
+		
+		ID_TIME_T sourceTimeStamp = fileSystem->GetTimestamp( canonical );
+		
+		idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
+		if( R_LoadBinaryModel( model, file, generatedFileName, canonical, sourceTimeStamp ) )
+		{
+			// the timestamps may still match, make sure the source content is known
+			bakeCache.UpdateFile( generatedFileName, canonical, sourceTimeStamp, 0 );
+			stats.upToDate++;
+		}
+		else
+		{
+			model->InitFromFile( canonical );
+			if( model->IsDefaultModel() )
+			{
+				common->Warning( "couldn't bake model '%s'", canonical.c_str() );
+				stats.failed++;
+			}
+			else
+			{
+				R_WriteBinaryModel( model, generatedFileName, canonical, sourceTimeStamp );
+				stats.baked++;
+			}
+		}
+		delete model;
+	}
+}
+
 
 
 /*
@@ -59,6 +59,9 @@ public:
 	// called only by renderer::Preload
 	virtual void			Preload( const idPreloadManifest& manifest ) = 0;
 	
+	// called only by renderer::Bake
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats ) = 0;
+	
 	// allocates a new empty render model.
 	virtual idRenderModel* 	AllocModel() = 0;
 	
@@ -52,6 +52,8 @@ public:
 	
 	virtual void				InitFromFile( const char* fileName );
 	virtual bool				LoadBinaryModel( idFile* file, const ID_TIME_T sourceTimeStamp );
+	virtual bool				LoadBinaryModelInJob( idFile* file, const ID_TIME_T sourceTimeStamp );
+	virtual void				FinishBinaryModel();
 	virtual void				WriteBinaryModel( idFile* file, ID_TIME_T* _timeStamp = NULL ) const;
 	virtual bool				SupportsBinaryModel()
 	{
@@ -131,6 +133,9 @@ public:
 	void						DeleteSurfacesWithNegativeId();
 	bool						FindSurfaceWithId( int id, int& surfaceNum ) const;
 	
+protected:
+	const idMaterial* 			FindBinaryMaterial( const char* materialName );
+	
 public:
 	idList<modelSurface_t, TAG_MODEL>	surfaces;
 	idBounds					bounds;
@@ -156,6 +161,8 @@ protected:
 	bool						hasInteractingSurfaces;
 	bool						hasShadowCastingSurfaces;
 	ID_TIME_T					timeStamp;
+	bool						loadingInJob;			// LoadBinaryModel is running in a job
+	bool						jobMaterialsMissing;	// a material was not parsed when the job needed it
 	
 	static idCVar				r_mergeModelSurfaces;	// combine model surfaces with the same material
 	static idCVar				r_slopVertex;			// merge xyz coordinates this far apart
@@ -211,6 +218,7 @@ class idRenderModelMD5 : public idRenderModelStatic
 public:
 	virtual void				InitFromFile( const char* fileName );
 	virtual bool				LoadBinaryModel( idFile* file, const ID_TIME_T sourceTimeStamp );
+	virtual void				FinishBinaryModel();
 	virtual void				WriteBinaryModel( idFile* file, ID_TIME_T* _timeStamp = NULL ) const;
 	virtual dynamicModel_t		IsDynamicModel() const;
 	virtual idBounds			Bounds( const struct renderEntity_s* ent ) const;
@@ -241,6 +249,7 @@ private:
 	
 	void						DrawJoints( const renderEntity_t* ent, const viewDef_t* view ) const;
 	void						ParseJoint( idLexer& parser, idMD5Joint* joint, idJointQuat* defaultPose );
+	void						CreateStaticCaches( deformInfo_t& deform );
 };
 
 /*
@@ -781,7 +781,7 @@ bool idRenderModelMD5::LoadBinaryModel( idFile* file, const ID_TIME_T sourceTime
 		}
 		else
 		{
-			meshes[i].shader = declManager->FindMaterial( materialName );
+			meshes[i].shader = FindBinaryMaterial( materialName );
 		}
 		
 		file->ReadBig( meshes[i].numVerts );
@@ -850,14 +850,11 @@ bool idRenderModelMD5::LoadBinaryModel( idFile* file, const ID_TIME_T sourceTime
 			}
 		}
 		
-		idShadowVertSkinned* shadowVerts = ( idShadowVertSkinned* ) Mem_Alloc( ALIGN( deform.numOutputVerts * 2 * sizeof( idShadowVertSkinned ), 16 ), TAG_MODEL );
-		idShadowVertSkinned::CreateShadowCache( shadowVerts, deform.verts, deform.numOutputVerts );
-		
-		deform.staticAmbientCache = vertexCache.AllocStaticVertex( deform.verts, ALIGN( deform.numOutputVerts * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
-		deform.staticIndexCache = vertexCache.AllocStaticIndex( deform.indexes, ALIGN( deform.numIndexes * sizeof( triIndex_t ), INDEX_CACHE_ALIGN ) );
-		deform.staticShadowCache = vertexCache.AllocStaticVertex( shadowVerts, ALIGN( deform.numOutputVerts * 2 * sizeof( idShadowVertSkinned ), VERTEX_CACHE_ALIGN ) );
-		
-		Mem_Free( shadowVerts );
+		// the vertex cache can only be filled on the main thread
+		if( !loadingInJob )
+		{
+			CreateStaticCaches( deform );
+		}
 		
 		file->ReadBig( meshes[i].surfaceNum );
 	}
@@ -865,6 +862,42 @@ bool idRenderModelMD5::LoadBinaryModel( idFile* file, const ID_TIME_T sourceTime
 	return true;
 }
 
+/*
+========================
+idRenderModelMD5::FinishBinaryModel
+========================
+*/
+void idRenderModelMD5::FinishBinaryModel()
+{
+	for( int i = 0; i < meshes.Num(); i++ )
+	{
+		CreateStaticCaches( *meshes[i].deformInfo );
+		if( meshes[i].shader != NULL )
+		{
+			declManager->FindMaterial( meshes[i].shader->GetName() );
+		}
+	}
+	
+	idRenderModelStatic::FinishBinaryModel();
+}
+
+/*
+========================
+idRenderModelMD5::CreateStaticCaches
+========================
+*/
+void idRenderModelMD5::CreateStaticCaches( deformInfo_t& deform )
+{
+	idShadowVertSkinned* shadowVerts = ( idShadowVertSkinned* ) Mem_Alloc( ALIGN( deform.numOutputVerts * 2 * sizeof( idShadowVertSkinned ), 16 ), TAG_MODEL );
+	idShadowVertSkinned::CreateShadowCache( shadowVerts, deform.verts, deform.numOutputVerts );
+	
+	deform.staticAmbientCache = vertexCache.AllocStaticVertex( deform.verts, ALIGN( deform.numOutputVerts * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
+	deform.staticIndexCache = vertexCache.AllocStaticIndex( deform.indexes, ALIGN( deform.numIndexes * sizeof( triIndex_t ), INDEX_CACHE_ALIGN ) );
+	deform.staticShadowCache = vertexCache.AllocStaticVertex( shadowVerts, ALIGN( deform.numOutputVerts * 2 * sizeof( idShadowVertSkinned ), VERTEX_CACHE_ALIGN ) );
+	
+	Mem_Free( shadowVerts );
+}
+
 /*
 ========================
 idRenderModelMD5::WriteBinaryModel
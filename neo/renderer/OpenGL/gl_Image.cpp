@@ -199,7 +199,15 @@ void idImage::SetTexParameters()
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ONE );
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_ONE );
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ONE );
-		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_GREEN );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, ( opts.format == FMT_BC4 ) ? GL_RED : GL_GREEN );
+	}
+	else if( opts.format == FMT_BC5 )
+	{
+		// the shaders read normal maps as .wy like the DXT5 ones
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	}
 	else if( opts.format == FMT_LUM8 )
 	{
@@ -242,7 +250,14 @@ void idImage::SetTexParameters()
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ONE );
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_ONE );
 		glTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ONE );
-		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_GREEN );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, ( opts.format == FMT_BC4 ) ? GL_RED : GL_GREEN );
+	}
+	else if( opts.format == FMT_BC5 )
+	{
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		glTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	}
 	else if( opts.format == FMT_ALPHA )
 	{
@@ -450,6 +465,21 @@ void idImage::AllocImage()
 			dataFormat = GL_RGBA;
 			dataType = GL_UNSIGNED_BYTE;
 			break;
+		case FMT_BC4:
+			internalFormat = GL_COMPRESSED_RED_RGTC1;
+			dataFormat = GL_RED;
+			dataType = GL_UNSIGNED_BYTE;
+			break;
+		case FMT_BC5:
+			internalFormat = GL_COMPRESSED_RG_RGTC2;
+			dataFormat = GL_RG;
+			dataType = GL_UNSIGNED_BYTE;
+			break;
+		case FMT_BC7:
+			internalFormat = ( glConfig.sRGBFramebufferAvailable && ( sRGB == 1 || sRGB == 3 ) && opts.colorFormat != CFM_YCOCG_DXT5 ) ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+			dataFormat = GL_RGBA;
+			dataType = GL_UNSIGNED_BYTE;
+			break;
 		case FMT_DEPTH:
 			internalFormat = GL_DEPTH_COMPONENT;
 			dataFormat = GL_DEPTH_COMPONENT;
@@ -471,13 +501,13 @@ void idImage::AllocImage()
 		case FMT_RGBA32F:
 			internalFormat = GL_RGBA32F;
 			dataFormat = GL_RGBA;
-			dataType = GL_UNSIGNED_BYTE;
+			dataType = GL_FLOAT;
 			break;
 			
 		case FMT_R32F:
 			internalFormat = GL_R32F;
 			dataFormat = GL_RED;
-			dataType = GL_UNSIGNED_BYTE;
+			dataType = GL_FLOAT;
 			break;
 			
 		case FMT_X16:
@@ -662,3 +692,175 @@ void idImage::Resize( int width, int height )
 	opts.height = height;
 	AllocImage();
 }
+
+/*
+================================================================================================
+
+idImageUploadBuffer
+
+================================================================================================
+*/
+
+// offsets of the staged data, enough for the unpack alignment and the block formats
+static const int UPLOAD_BUFFER_ALIGNMENT = 64;
+
+/*
+========================
+idImageUploadBuffer::idImageUploadBuffer
+========================
+*/
+idImageUploadBuffer::idImageUploadBuffer()
+{
+	bufferObject = 0;
+	mappedData = NULL;
+	bufferSize = 0;
+	segmentSize = 0;
+	writeOffset = 0;
+	currentSegment = 0;
+	for( int i = 0; i < NUM_SEGMENTS; i++ )
+	{
+		fences[i] = NULL;
+	}
+}
+
+/*
+========================
+idImageUploadBuffer::Init
+========================
+*/
+bool idImageUploadBuffer::Init( int size )
+{
+	Shutdown();
+	
+#if !defined(USE_GLES2) && !defined(USE_GLES3)
+	if( !glConfig.bufferStorageAvailable || !glConfig.syncAvailable )
+	{
+		return false;
+	}
+	
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	
+	glGenBuffers( 1, &bufferObject );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, bufferObject );
+	glBufferStorage( GL_PIXEL_UNPACK_BUFFER, size, NULL, flags );
+	mappedData = ( byte* )glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, size, flags );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	
+	if( mappedData == NULL )
+	{
+		idLib::Warning( "idImageUploadBuffer: couldn't map a %d MB buffer", size >> 20 );
+		glDeleteBuffers( 1, &bufferObject );
+		bufferObject = 0;
+		return false;
+	}
+	
+	bufferSize = size;
+	segmentSize = size / NUM_SEGMENTS;
+	writeOffset = 0;
+	currentSegment = 0;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*
+========================
+idImageUploadBuffer::Shutdown
+========================
+*/
+void idImageUploadBuffer::Shutdown()
+{
+	if( bufferObject == 0 )
+	{
+		return;
+	}
+	for( int i = 0; i < NUM_SEGMENTS; i++ )
+	{
+		if( fences[i] != NULL )
+		{
+			glDeleteSync( fences[i] );
+			fences[i] = NULL;
+		}
+	}
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, bufferObject );
+	glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	glDeleteBuffers( 1, &bufferObject );
+	bufferObject = 0;
+	mappedData = NULL;
+	bufferSize = 0;
+}
+
+/*
+========================
+idImageUploadBuffer::NextSegment
+
+Fences the uploads from the current segment and waits until the GPU is done with the
+uploads from the next one.
+========================
+*/
+void idImageUploadBuffer::NextSegment()
+{
+	assert( fences[currentSegment] == NULL );
+	fences[currentSegment] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	
+	currentSegment = ( currentSegment + 1 ) % NUM_SEGMENTS;
+	
+	GLsync& fence = fences[currentSegment];
+	if( fence != NULL )
+	{
+		for( GLenum r = GL_TIMEOUT_EXPIRED; r == GL_TIMEOUT_EXPIRED; )
+		{
+			r = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000 * 1000 );
+		}
+		glDeleteSync( fence );
+		fence = NULL;
+	}
+}
+
+/*
+========================
+idImageUploadBuffer::Stage
+========================
+*/
+int idImageUploadBuffer::Stage( const void* data, int size )
+{
+	if( mappedData == NULL || size <= 0 || size > bufferSize )
+	{
+		return -1;
+	}
+	
+	int offset = ( writeOffset + UPLOAD_BUFFER_ALIGNMENT - 1 ) & ~( UPLOAD_BUFFER_ALIGNMENT - 1 );
+	if( offset + size > bufferSize )
+	{
+		// wrap around, going through every segment up to the first one
+		offset = 0;
+		do
+		{
+			NextSegment();
+		}
+		while( currentSegment != 0 );
+	}
+	const int lastSegment = Min( ( offset + size - 1 ) / segmentSize, NUM_SEGMENTS - 1 );
+	while( currentSegment != lastSegment )
+	{
+		NextSegment();
+	}
+	
+	memcpy( mappedData + offset, data, size );
+	writeOffset = offset + size;
+	
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, bufferObject );
+	return offset;
+}
+
+/*
+========================
+idImageUploadBuffer::EndUpload
+========================
+*/
+void idImageUploadBuffer::EndUpload()
+{
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+}
@@ -107,6 +107,8 @@ idRenderLightLocal::idRenderLightLocal()
 	foggedPortals			= NULL;
 	firstInteraction		= NULL;
 	lastInteraction			= NULL;
+	candidatesAreaGeneration	= -1;
+	candidatesConnectedAreaNum	= -1;
 	
 	baseLightProject.Zero();
 	inverseBaseLightProject.Zero();
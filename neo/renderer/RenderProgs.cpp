@@ -118,6 +118,8 @@ void idRenderProgManager::Init()
 		{ BUILTIN_INTERACTION_SHADOW_MAPPING_PARALLEL, "interactionSM", "_parallel", BIT( LIGHT_PARALLEL ), false },
 		{ BUILTIN_INTERACTION_SHADOW_MAPPING_PARALLEL_SKINNED, "interactionSM", "_parallel_skinned", BIT( USE_GPU_SKINNING ) | BIT( LIGHT_PARALLEL ), true },
 		// RB end
+		{ BUILTIN_INTERACTION_CLUSTERED, "interactionClustered", "", 0, false },
+		{ BUILTIN_INTERACTION_CLUSTERED_SKINNED, "interactionClustered", "_skinned", BIT( USE_GPU_SKINNING ), true },
 		{ BUILTIN_ENVIRONMENT, "environment.vfp", "", 0, false },
 		{ BUILTIN_ENVIRONMENT_SKINNED, "environment_skinned.vfp", "",  0, true },
 		{ BUILTIN_BUMPY_ENVIRONMENT, "bumpyenvironment.vfp", "", 0, false },
@@ -200,10 +202,10 @@ void idRenderProgManager::Init()
 		LoadFragmentShader( i );
 		LoadGLSLProgram( i, i, i );
 	}
-
+	
 	r_useHalfLambertLighting.ClearModified();
 	r_useHDR.ClearModified();
-
+	
 	// special case handling for fastZ shaders
 	/*
 	switch( glConfig.driverType )
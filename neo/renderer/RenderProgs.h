@@ -310,6 +310,16 @@ public:
 	}
 	// RB end
 	
+	void	BindShader_Interaction_Clustered()
+	{
+		BindShader_Builtin( BUILTIN_INTERACTION_CLUSTERED );
+	}
+	
+	void	BindShader_Interaction_Clustered_Skinned()
+	{
+		BindShader_Builtin( BUILTIN_INTERACTION_CLUSTERED_SKINNED );
+	}
+	
 	void	BindShader_SimpleShade()
 	{
 		BindShader_Builtin( BUILTIN_SIMPLESHADE );
@@ -598,6 +608,8 @@ protected:
 		BUILTIN_INTERACTION_SHADOW_MAPPING_PARALLEL,
 		BUILTIN_INTERACTION_SHADOW_MAPPING_PARALLEL_SKINNED,
 		// RB end
+		BUILTIN_INTERACTION_CLUSTERED,
+		BUILTIN_INTERACTION_CLUSTERED_SKINNED,
 		BUILTIN_ENVIRONMENT,
 		BUILTIN_ENVIRONMENT_SKINNED,
 		BUILTIN_BUMPY_ENVIRONMENT,
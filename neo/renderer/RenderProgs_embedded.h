@@ -9074,6 +9074,368 @@ static const cgShaderDef_t cg_renderprogs[] =
 		
 	},
 	
+	{
+		"renderprogs/interactionClustered.pixel",
+		"/*\n"
+		"===========================================================================\n"
+		"\n"
+		"Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. \n"
+		"\n"
+		"This file is part of the Doom 3 BFG Edition GPL Source Code (\"Doom 3 BFG Edition Source Code\").  \n"
+		"\n"
+		"Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify\n"
+		"it under the terms of the GNU General Public License as published by\n"
+		"the Free Software Foundation, either version 3 of the License, or\n"
+		"(at your option) any later version.\n"
+		"\n"
+		"Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,\n"
+		"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+		"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+		"GNU General Public License for more details.\n"
+		"\n"
+		"You should have received a copy of the GNU General Public License\n"
+		"along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.\n"
+		"\n"
+		"In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.\n"
+		"\n"
+		"If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.\n"
+		"\n"
+		"===========================================================================\n"
+		"*/\n"
+		"\n"
+		"#include \"renderprogs/global.inc\"\n"
+		"\n"
+		"uniform sampler2D	samp0 : register(s0); // texture 0 is the per-surface bump map\n"
+		"uniform sampler2D	samp1 : register(s1); // texture 1 is the light falloff texture shared by all clustered lights\n"
+		"uniform sampler2D	samp2 : register(s2); // texture 2 is the light projection texture shared by all clustered lights\n"
+		"uniform sampler2D	samp3 : register(s3); // texture 3 is the per-surface diffuse map\n"
+		"uniform sampler2D	samp4 : register(s4); // texture 4 is the per-surface specular map\n"
+		"uniform sampler2D	samp5 : register(s5); // texture 5 has a row with the projection, falloff, origin and color of each light\n"
+		"uniform sampler2D	samp6 : register(s6); // texture 6 has the offset and count of each cluster followed by the light indexes\n"
+		"\n"
+		"uniform float4 rpUser0 : register( c128 );	// tiles per pixel in x and y, depth slice scale and bias\n"
+		"uniform float4 rpUser1 : register( c129 );	// window coordinates of the viewport origin\n"
+		"\n"
+		"// these must match the cluster grid in tr_local.h\n"
+		"#define CLUSTER_TILES_X			16\n"
+		"#define CLUSTER_TILES_Y			8\n"
+		"#define CLUSTER_SLICES			16\n"
+		"#define CLUSTER_COUNT			( CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES )\n"
+		"#define CLUSTER_GRID_WIDTH		512\n"
+		"\n"
+		"struct PS_IN\n"
+		"{\n"
+		"	half4 position	: VPOS;\n"
+		"	half4 texcoord0	: TEXCOORD0_centroid;\n"
+		"	half4 texcoord1	: TEXCOORD1_centroid;\n"
+		"	half4 texcoord2	: TEXCOORD2_centroid;\n"
+		"	half4 texcoord3	: TEXCOORD3_centroid;\n"
+		"	half4 texcoord4	: TEXCOORD4_centroid;\n"
+		"	half4 texcoord5	: TEXCOORD5_centroid;\n"
+		"	half4 texcoord6	: TEXCOORD6_centroid;\n"
+		"	half4 color		: COLOR0;\n"
+		"};\n"
+		"\n"
+		"struct PS_OUT\n"
+		"{\n"
+		"	half4 color : COLOR;\n"
+		"};\n"
+		"\n"
+		"float4 fetchClusterGrid( int texel )\n"
+		"{\n"
+		"	return texelFetch( samp6, int2( texel % CLUSTER_GRID_WIDTH, texel / CLUSTER_GRID_WIDTH ), 0 );\n"
+		"}\n"
+		"\n"
+		"void main( PS_IN fragment, out PS_OUT result )\n"
+		"{\n"
+		"	half4 bumpMap =			tex2D( samp0, fragment.texcoord1.xy );\n"
+		"	half4 YCoCG =			tex2D( samp3, fragment.texcoord4.xy );\n"
+		"	half4 specMapSRGB =		tex2D( samp4, fragment.texcoord5.xy );\n"
+		"	half4 specMap =			sRGBAToLinearRGBA( specMapSRGB );\n"
+		"\n"
+		"	half3 diffuseMap = sRGBToLinearRGB( ConvertYCoCgToRGB( YCoCG ) );\n"
+		"\n"
+		"	half3 localNormal;\n"
+		"#if defined(USE_NORMAL_FMT_RGB8)\n"
+		"	localNormal.xy = bumpMap.rg - 0.5;\n"
+		"#else\n"
+		"	localNormal.xy = bumpMap.wy - 0.5;\n"
+		"#endif\n"
+		"	localNormal.z = sqrt( abs( dot( localNormal.xy, localNormal.xy ) - 0.25 ) );\n"
+		"	localNormal = normalize( localNormal );\n"
+		"\n"
+		"	// the lights are shared by all surfaces, so the normal is taken to world space\n"
+		"	half3 worldNormal = normalize( localNormal.x * fragment.texcoord2.xyz + localNormal.y * fragment.texcoord3.xyz + localNormal.z * fragment.texcoord6.xyz );\n"
+		"\n"
+		"	float4 worldPosition = float4( fragment.texcoord0.xyz, 1.0 );\n"
+		"	half3 viewVector = normalize( rpGlobalEyePos.xyz - worldPosition.xyz );\n"
+		"\n"
+		"	// find the cluster of this fragment from the screen tile and the exponential depth slice\n"
+		"	int tileX = clamp( int( ( fragment.position.x - rpUser1.x ) * rpUser0.x ), 0, CLUSTER_TILES_X - 1 );\n"
+		"	int tileY = clamp( int( ( fragment.position.y - rpUser1.y ) * rpUser0.y ), 0, CLUSTER_TILES_Y - 1 );\n"
+		"	int slice = clamp( int( log( max( fragment.texcoord0.w, 0.001 ) ) * rpUser0.z + rpUser0.w ), 0, CLUSTER_SLICES - 1 );\n"
+		"\n"
+		"	float4 cluster = fetchClusterGrid( ( slice * CLUSTER_TILES_Y + tileY ) * CLUSTER_TILES_X + tileX );\n"
+		"	int firstIndex = int( cluster.x );\n"
+		"	int numIndexes = int( cluster.y );\n"
+		"\n"
+		"	const half specularPower = 10.0f;\n"
+		"\n"
+		"	half3 color = _half3( 0.0 );\n"
+		"	for( int i = 0; i < numIndexes; i++ )\n"
+		"	{\n"
+		"		// the light indexes are packed four to a texel\n"
+		"		int index = firstIndex + i;\n"
+		"		float4 indexes = fetchClusterGrid( CLUSTER_COUNT + index / 4 );\n"
+		"		int light = int( indexes[index & 3] );\n"
+		"\n"
+		"		float4 lightProjectS =	texelFetch( samp5, int2( 0, light ), 0 );\n"
+		"		float4 lightProjectT =	texelFetch( samp5, int2( 1, light ), 0 );\n"
+		"		float4 lightProjectQ =	texelFetch( samp5, int2( 2, light ), 0 );\n"
+		"		float4 lightFalloffS =	texelFetch( samp5, int2( 3, light ), 0 );\n"
+		"		float4 lightOrigin =	texelFetch( samp5, int2( 4, light ), 0 );\n"
+		"		float4 lightColor =		texelFetch( samp5, int2( 5, light ), 0 );\n"
+		"\n"
+		"		float3 lightTexCoord;\n"
+		"		lightTexCoord.x = dot4( worldPosition, lightProjectS );\n"
+		"		lightTexCoord.y = dot4( worldPosition, lightProjectT );\n"
+		"		lightTexCoord.z = dot4( worldPosition, lightProjectQ );\n"
+		"\n"
+		"		// behind a projected light\n"
+		"		if( lightTexCoord.z <= 0.0 )\n"
+		"		{\n"
+		"			continue;\n"
+		"		}\n"
+		"\n"
+		"		// the loop is not uniform across the fragments, so sample without derivatives\n"
+		"		half4 lightFalloff =	textureLod( samp1, float2( dot4( worldPosition, lightFalloffS ), 0.5 ), 0.0 );\n"
+		"		half4 lightProj	=		textureLod( samp2, lightTexCoord.xy / lightTexCoord.z, 0.0 );\n"
+		"\n"
+		"		half3 lightVector = normalize( lightOrigin.xyz - worldPosition.xyz );\n"
+		"\n"
+		"		// traditional very dark Lambert light model used in Doom 3\n"
+		"		half ldotN = saturate( dot3( worldNormal, lightVector ) );\n"
+		"\n"
+		"#if defined(USE_HALF_LAMBERT)\n"
+		"		// RB: http://developer.valvesoftware.com/wiki/Half_Lambert\n"
+		"		half halfLdotN = dot3( worldNormal, lightVector ) * 0.5 + 0.5;\n"
+		"		halfLdotN *= halfLdotN;\n"
+		"\n"
+		"		// tweak to not loose so many details\n"
+		"		half lambert = lerp( ldotN, halfLdotN, 0.5 );\n"
+		"#else\n"
+		"		half lambert = ldotN;\n"
+		"#endif\n"
+		"\n"
+		"		half3 halfAngleVector = normalize( lightVector + viewVector );\n"
+		"		half hdotN = clamp( dot3( halfAngleVector, worldNormal ), 0.0, 1.0 );\n"
+		"\n"
+		"		half3 specularContribution = _half3( pow( hdotN, specularPower ) );\n"
+		"\n"
+		"		// rpDiffuseModifier and rpSpecularModifier only have the surface stage colors,\n"
+		"		// the light color comes from the light data\n"
+		"		half3 diffuseColor = diffuseMap * sRGBToLinearRGB( rpDiffuseModifier.xyz * lightColor.xyz );\n"
+		"		half3 specularColor = specMap.xyz * specularContribution * sRGBToLinearRGB( rpSpecularModifier.xyz * lightColor.xyz );\n"
+		"		half3 lightTextureColor = sRGBToLinearRGB( lightProj.xyz * lightFalloff.xyz );\n"
+		"\n"
+		"		color += ( diffuseColor + specularColor ) * lambert * lightTextureColor;\n"
+		"	}\n"
+		"\n"
+		"	result.color.xyz = color * fragment.color.rgb;\n"
+		"	result.color.w = 1.0;\n"
+		"}\n"
+		"\n"
+		
+	},
+	
+	{
+		"renderprogs/interactionClustered.vertex",
+		"/*\n"
+		"===========================================================================\n"
+		"\n"
+		"Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. \n"
+		"\n"
+		"This file is part of the Doom 3 BFG Edition GPL Source Code (\"Doom 3 BFG Edition Source Code\").  \n"
+		"\n"
+		"Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify\n"
+		"it under the terms of the GNU General Public License as published by\n"
+		"the Free Software Foundation, either version 3 of the License, or\n"
+		"(at your option) any later version.\n"
+		"\n"
+		"Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,\n"
+		"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+		"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+		"GNU General Public License for more details.\n"
+		"\n"
+		"You should have received a copy of the GNU General Public License\n"
+		"along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.\n"
+		"\n"
+		"In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.\n"
+		"\n"
+		"If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.\n"
+		"\n"
+		"===========================================================================\n"
+		"*/\n"
+		"\n"
+		"#include \"renderprogs/global.inc\"\n"
+		"\n"
+		"#if defined( USE_GPU_SKINNING )\n"
+		"uniform matrices_ubo { float4 matrices[408]; };\n"
+		"#endif\n"
+		"\n"
+		"struct VS_IN {\n"
+		"	float4 position : POSITION;\n"
+		"	float2 texcoord : TEXCOORD0;\n"
+		"	float4 normal : NORMAL;\n"
+		"	float4 tangent : TANGENT;\n"
+		"	float4 color : COLOR0;\n"
+		"	float4 color2 : COLOR1;\n"
+		"};\n"
+		"\n"
+		"struct VS_OUT {\n"
+		"	float4 position		: POSITION;\n"
+		"	float4 texcoord0	: TEXCOORD0;\n"
+		"	float4 texcoord1	: TEXCOORD1;\n"
+		"	float4 texcoord2	: TEXCOORD2;\n"
+		"	float4 texcoord3	: TEXCOORD3;\n"
+		"	float4 texcoord4	: TEXCOORD4;\n"
+		"	float4 texcoord5	: TEXCOORD5;\n"
+		"	float4 texcoord6	: TEXCOORD6;\n"
+		"	float4 color		: COLOR0;\n"
+		"};\n"
+		"\n"
+		"void main( VS_IN vertex, out VS_OUT result ) {\n"
+		"\n"
+		"	float4 vNormal = vertex.normal * 2.0 - 1.0;\n"
+		"	float4 vTangent = vertex.tangent * 2.0 - 1.0;\n"
+		"	float3 vBitangent = cross( vNormal.xyz, vTangent.xyz ) * vTangent.w;\n"
+		"\n"
+		"#if defined( USE_GPU_SKINNING )\n"
+		"	//--------------------------------------------------------------\n"
+		"	// GPU transformation of the normal / tangent / bitangent\n"
+		"	//\n"
+		"	// multiplying with 255.1 give us the same result and is faster than floor( w * 255 + 0.5 )\n"
+		"	//--------------------------------------------------------------\n"
+		"	const float w0 = vertex.color2.x;\n"
+		"	const float w1 = vertex.color2.y;\n"
+		"	const float w2 = vertex.color2.z;\n"
+		"	const float w3 = vertex.color2.w;\n"
+		"\n"
+		"	float4 matX, matY, matZ;	// must be float4 for vec4\n"
+		"	int joint = int(vertex.color.x * 255.1 * 3.0);\n"
+		"	matX = matrices[int(joint+0)] * w0;\n"
+		"	matY = matrices[int(joint+1)] * w0;\n"
+		"	matZ = matrices[int(joint+2)] * w0;\n"
+		"\n"
+		"	joint = int(vertex.color.y * 255.1 * 3.0);\n"
+		"	matX += matrices[int(joint+0)] * w1;\n"
+		"	matY += matrices[int(joint+1)] * w1;\n"
+		"	matZ += matrices[int(joint+2)] * w1;\n"
+		"\n"
+		"	joint = int(vertex.color.z * 255.1 * 3.0);\n"
+		"	matX += matrices[int(joint+0)] * w2;\n"
+		"	matY += matrices[int(joint+1)] * w2;\n"
+		"	matZ += matrices[int(joint+2)] * w2;\n"
+		"\n"
+		"	joint = int(vertex.color.w * 255.1 * 3.0);\n"
+		"	matX += matrices[int(joint+0)] * w3;\n"
+		"	matY += matrices[int(joint+1)] * w3;\n"
+		"	matZ += matrices[int(joint+2)] * w3;\n"
+		"\n"
+		"	float3 normal;\n"
+		"	normal.x = dot3( matX, vNormal );\n"
+		"	normal.y = dot3( matY, vNormal );\n"
+		"	normal.z = dot3( matZ, vNormal );\n"
+		"	normal = normalize( normal );\n"
+		"\n"
+		"	float3 tangent;\n"
+		"	tangent.x = dot3( matX, vTangent );\n"
+		"	tangent.y = dot3( matY, vTangent );\n"
+		"	tangent.z = dot3( matZ, vTangent );\n"
+		"	tangent = normalize( tangent );\n"
+		"\n"
+		"	float3 bitangent;\n"
+		"	bitangent.x = dot3( matX, vBitangent );\n"
+		"	bitangent.y = dot3( matY, vBitangent );\n"
+		"	bitangent.z = dot3( matZ, vBitangent );\n"
+		"	bitangent = normalize( bitangent );\n"
+		"\n"
+		"	float4 modelPosition;\n"
+		"	modelPosition.x = dot4( matX, vertex.position );\n"
+		"	modelPosition.y = dot4( matY, vertex.position );\n"
+		"	modelPosition.z = dot4( matZ, vertex.position );\n"
+		"	modelPosition.w = 1.0;\n"
+		"\n"
+		"#else\n"
+		"	float4 modelPosition = vertex.position;\n"
+		"	float3 normal = vNormal.xyz;\n"
+		"	float3 tangent = vTangent.xyz;\n"
+		"	float3 bitangent = vBitangent.xyz;\n"
+		"#endif\n"
+		"\n"
+		"	result.position.x = dot4( modelPosition, rpMVPmatrixX );\n"
+		"	result.position.y = dot4( modelPosition, rpMVPmatrixY );\n"
+		"	result.position.z = dot4( modelPosition, rpMVPmatrixZ );\n"
+		"	result.position.w = dot4( modelPosition, rpMVPmatrixW );\n"
+		"\n"
+		"	float4 defaultTexCoord = float4( 0.0f, 0.5f, 0.0f, 1.0f );\n"
+		"\n"
+		"	// the clustered lights are stored in world space, so the lighting is done in world space\n"
+		"\n"
+		"	//result.texcoord0 is the world position and the distance to the view plane\n"
+		"	result.texcoord0.x = dot4( modelPosition, rpModelMatrixX );\n"
+		"	result.texcoord0.y = dot4( modelPosition, rpModelMatrixY );\n"
+		"	result.texcoord0.z = dot4( modelPosition, rpModelMatrixZ );\n"
+		"	result.texcoord0.w = -dot4( modelPosition, rpModelViewMatrixZ );\n"
+		"\n"
+		"	//textures 1 takes the base coordinates by the texture matrix\n"
+		"	result.texcoord1 = defaultTexCoord;\n"
+		"	result.texcoord1.x = dot4( vertex.texcoord.xy, rpBumpMatrixS );\n"
+		"	result.texcoord1.y = dot4( vertex.texcoord.xy, rpBumpMatrixT );\n"
+		"\n"
+		"	//# textures 2, 3 and 6 are the tangent, bitangent and normal in world space\n"
+		"	result.texcoord2.x = dot3( rpModelMatrixX, tangent );\n"
+		"	result.texcoord2.y = dot3( rpModelMatrixY, tangent );\n"
+		"	result.texcoord2.z = dot3( rpModelMatrixZ, tangent );\n"
+		"	result.texcoord2.w = 0.0f;\n"
+		"\n"
+		"	result.texcoord3.x = dot3( rpModelMatrixX, bitangent );\n"
+		"	result.texcoord3.y = dot3( rpModelMatrixY, bitangent );\n"
+		"	result.texcoord3.z = dot3( rpModelMatrixZ, bitangent );\n"
+		"	result.texcoord3.w = 0.0f;\n"
+		"\n"
+		"	result.texcoord6.x = dot3( rpModelMatrixX, normal );\n"
+		"	result.texcoord6.y = dot3( rpModelMatrixY, normal );\n"
+		"	result.texcoord6.z = dot3( rpModelMatrixZ, normal );\n"
+		"	result.texcoord6.w = 0.0f;\n"
+		"\n"
+		"	//# textures 4 takes the base coordinates by the texture matrix\n"
+		"	result.texcoord4 = defaultTexCoord;\n"
+		"	result.texcoord4.x = dot4( vertex.texcoord.xy, rpDiffuseMatrixS );\n"
+		"	result.texcoord4.y = dot4( vertex.texcoord.xy, rpDiffuseMatrixT );\n"
+		"\n"
+		"	//# textures 5 takes the base coordinates by the texture matrix\n"
+		"	result.texcoord5 = defaultTexCoord;\n"
+		"	result.texcoord5.x = dot4( vertex.texcoord.xy, rpSpecularMatrixS );\n"
+		"	result.texcoord5.y = dot4( vertex.texcoord.xy, rpSpecularMatrixT );\n"
+		"\n"
+		"#if defined( USE_GPU_SKINNING )\n"
+		"	// for joint transformation of the tangent space, we use color and\n"
+		"	// color2 for weighting information, so hopefully there aren't any\n"
+		"	// effects that need vertex color...\n"
+		"	result.color = float4( 1.0f, 1.0f, 1.0f, 1.0f );\n"
+		"#else\n"
+		"	//# generate the vertex color, which can be 1.0, color, or 1.0 - color\n"
+		"	//# for 1.0 : env[16] = 0, env[17] = 1\n"
+		"	//# for color : env[16] = 1, env[17] = 0\n"
+		"	//# for 1.0-color : env[16] = -1, env[17] = 1	\n"
+		"	result.color = ( swizzleColor( vertex.color ) * rpVertexColorModulate ) + rpVertexColorAdd;\n"
+		"#endif\n"
+		"}\n"
+		"\n"
+		
+	},
+	
 	{
 		"renderprogs/interactionSM.pixel",
 		"/*\n"
@@ -89,7 +89,7 @@ static void R_PerformanceCounters()
 	}
 	if( r_showMemory.GetBool() )
 	{
-		common->Printf( "frameData: %i (%i)\n", frameData->frameMemoryAllocated.GetValue(), frameData->highWaterAllocated );
+		common->Printf( "frameData: %i (%i) last: %i overflow: %i\n", frameData->frameMemoryAllocated.GetValue(), frameData->highWaterAllocated, frameData->lastFrameAllocated, frameData->frameMemoryOverflow.GetValue() );
 	}
 	
 	memset( &tr.pc, 0, sizeof( tr.pc ) );
@@ -138,6 +138,8 @@ struct glconfig_t
 	bool				multitextureAvailable;
 	bool				directStateAccess;
 	bool				textureCompressionAvailable;
+	bool				rgtcTextureCompressionAvailable;
+	bool				bptcTextureCompressionAvailable;
 	bool				anisotropicFilterAvailable;
 	bool				textureLODBiasAvailable;
 	bool				seamlessCubeMapAvailable;
@@ -152,6 +154,7 @@ struct glconfig_t
 	bool				twoSidedStencilAvailable;
 	bool				depthBoundsTestAvailable;
 	bool				syncAvailable;
+	bool				bufferStorageAvailable;
 	bool				timerQueryAvailable;
 	bool				occlusionQueryAvailable;
 	bool				debugOutputAvailable;
@@ -271,6 +274,8 @@ public:
 	virtual void			BeginLevelLoad() = 0;
 	virtual void			EndLevelLoad() = 0;
 	virtual void			Preload( const idPreloadManifest& manifest, const char* mapName ) = 0;
+	// rebuilds the generated images and models of the manifest that are out of date
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats ) = 0;
 	virtual void			LoadLevelImages() = 0;
 	
 	virtual void			BeginAutomaticBackgroundSwaps( autoRenderIconType_t icon = AUTORENDER_DEFAULTICON ) = 0;
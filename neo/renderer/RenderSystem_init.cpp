@@ -429,6 +429,11 @@ static void R_CheckPortableExtensions()
 	{
 		glConfig.textureCompressionAvailable = GLEW_ARB_texture_compression != 0 && GLEW_EXT_texture_compression_s3tc != 0;
 	}
+	
+	// GL_ARB_texture_compression_rgtc + GL_ARB_texture_compression_bptc for BC4, BC5 and BC7
+	glConfig.rgtcTextureCompressionAvailable = ( glConfig.glVersion >= 3.0f ) || GLEW_ARB_texture_compression_rgtc != 0;
+	glConfig.bptcTextureCompressionAvailable = ( glConfig.glVersion >= 4.2f ) || GLEW_ARB_texture_compression_bptc != 0;
+	
 	// GL_EXT_texture_filter_anisotropic
 	glConfig.anisotropicFilterAvailable = GLEW_EXT_texture_filter_anisotropic != 0;
 	if( glConfig.anisotropicFilterAvailable )
@@ -531,6 +536,9 @@ static void R_CheckPortableExtensions()
 							 // do not appear to work for the Intel HD 4000 graphics
 							 ( glConfig.vendor != VENDOR_INTEL || r_skipIntelWorkarounds.GetBool() );
 							 
+	// GL_ARB_buffer_storage
+	glConfig.bufferStorageAvailable = GLEW_ARB_buffer_storage != 0;
+	
 	// GL_ARB_occlusion_query
 	glConfig.occlusionQueryAvailable = GLEW_ARB_occlusion_query != 0;
 	
@@ -2957,7 +2965,7 @@ void idRenderSystemLocal::Init()
 		testImageTriangles = R_MakeTestImageTriangles();
 	}
 	
-	frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
+	frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, FRONTEND_MAX_JOBS, FRONTEND_MAX_SYNCS, NULL );
 	
 	// make sure the command buffers are ready to accept the first screen update
 	SwapCommandBuffers( NULL, NULL, NULL, NULL );
@@ -3061,6 +3069,17 @@ void idRenderSystemLocal::Preload( const idPreloadManifest& manifest, const char
 	renderModelManager->Preload( manifest );
 }
 
+/*
+========================
+idRenderSystemLocal::Bake
+========================
+*/
+void idRenderSystemLocal::Bake( const idPreloadManifest& manifest, bakeStats_t& stats )
+{
+	globalImages->Bake( manifest, stats );
+	renderModelManager->Bake( manifest, stats );
+}
+
 /*
 ========================
 idRenderSystemLocal::EndLevelLoad
@@ -1663,6 +1663,98 @@ CREATE MODEL REFS
 =================================================================================
 */
 
+/*
+=================
+idAreaReferenceBounds::Add
+=================
+*/
+void idAreaReferenceBounds::Add( areaReference_t* ref, const idBounds& refBounds )
+{
+	if( num >= max )
+	{
+		// keep the arrays padded to a multiple of the widest SIMD batch
+		const int newMax = max + GRANULARITY;
+		areaReference_t** newRefs = ( areaReference_t** ) Mem_Alloc( newMax * sizeof( refs[0] ), TAG_RENDER );
+		float* newBounds = ( float* ) Mem_ClearedAlloc( newMax * 6 * sizeof( float ), TAG_RENDER );
+		if( refs != NULL )
+		{
+			memcpy( newRefs, refs, num * sizeof( refs[0] ) );
+			for( int i = 0; i < 6; i++ )
+			{
+				memcpy( newBounds + i * newMax, bounds + i * max, num * sizeof( float ) );
+			}
+			Mem_Free( refs );
+			Mem_Free( bounds );
+		}
+		refs = newRefs;
+		bounds = newBounds;
+		max = newMax;
+	}
+	
+	refs[num] = ref;
+	for( int i = 0; i < 3; i++ )
+	{
+		bounds[( i + 0 ) * max + num] = refBounds[0][i];
+		bounds[( i + 3 ) * max + num] = refBounds[1][i];
+	}
+	ref->boundsIndex = num++;
+}
+
+/*
+=================
+idAreaReferenceBounds::Remove
+=================
+*/
+void idAreaReferenceBounds::Remove( areaReference_t* ref )
+{
+	const int index = ref->boundsIndex;
+	assert( index >= 0 && index < num && refs[index] == ref );
+	
+	num--;
+	if( index != num )
+	{
+		refs[index] = refs[num];
+		refs[index]->boundsIndex = index;
+		for( int i = 0; i < 6; i++ )
+		{
+			bounds[i * max + index] = bounds[i * max + num];
+		}
+	}
+	ref->boundsIndex = -1;
+}
+
+/*
+=================
+idAreaReferenceBounds::Free
+=================
+*/
+void idAreaReferenceBounds::Free()
+{
+	Mem_Free( refs );
+	Mem_Free( bounds );
+	refs = NULL;
+	bounds = NULL;
+	num = 0;
+	max = 0;
+}
+
+/*
+=================
+idAreaReferenceBounds::CullToPlanes
+
+Only references that are completely in front of one of the planes are culled, so
+this never removes anything the exact culling to the portal planes would keep.
+=================
+*/
+int idAreaReferenceBounds::CullToPlanes( int* visible, const idPlane* planes, const int numPlanes ) const
+{
+	if( num == 0 )
+	{
+		return 0;
+	}
+	return SIMDProcessor->CullBoundsToPlanes( visible, bounds, max, num, planes, numPlanes, ON_EPSILON );
+}
+
 /*
 =================
 idRenderWorldLocal::AddEntityRefToArea
@@ -1705,6 +1797,9 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal* def, portalAre
 	ref->areaPrev = area->entityRefs.areaPrev;
 	ref->areaNext->areaPrev = ref;
 	ref->areaPrev->areaNext = ref;
+	
+	area->entityBounds.Add( ref, def->globalReferenceBounds );
+	area->entityRefsGeneration++;
 }
 
 /*
@@ -1737,6 +1832,8 @@ void idRenderWorldLocal::AddLightRefToArea( idRenderLightLocal* light, portalAre
 	lref->areaNext = area->lightRefs.areaNext;
 	lref->areaPrev = &area->lightRefs;
 	area->lightRefs.areaNext = lref;
+	
+	area->lightBounds.Add( lref, light->globalLightBounds );
 }
 
 /*
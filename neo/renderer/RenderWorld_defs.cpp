@@ -126,6 +126,8 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal* def, bool keepDecals, bool
 		// unlink from the area
 		ref->areaNext->areaPrev = ref->areaPrev;
 		ref->areaPrev->areaNext = ref->areaNext;
+		ref->area->entityBounds.Remove( ref );
+		ref->area->entityRefsGeneration++;
 		
 		// put it back on the free list for reuse
 		def->world->areaReferenceAllocator.Free( ref );
@@ -522,11 +524,16 @@ void R_FreeLightDefDerivedData( idRenderLightLocal* ldef )
 		// unlink from the area
 		lref->areaNext->areaPrev = lref->areaPrev;
 		lref->areaPrev->areaNext = lref->areaNext;
+		lref->area->lightBounds.Remove( lref );
 		
 		// put it back on the free list for reuse
 		ldef->world->areaReferenceAllocator.Free( lref );
 	}
 	ldef->references = NULL;
+	
+	// the light will be linked into new areas
+	ldef->interactionCandidates.Clear();
+	ldef->candidatesAreaGeneration = -1;
 }
 
 // RB begin
@@ -65,6 +65,9 @@ void idRenderWorldLocal::FreeWorld()
 		{
 			common->Error( "FreeWorld: unexpected remaining entityRefs" );
 		}
+		
+		area->entityBounds.Free();
+		area->lightBounds.Free();
 	}
 	
 	if( portalAreas )
@@ -60,6 +60,43 @@ typedef struct doublePortal_s
 } doublePortal_t;
 
 
+// The bounds of the entity or light references of an area packed as six float arrays
+// (min x, y, z, max x, y, z), so the portal flow can cull all of them against the portal
+// planes with SIMDProcessor->CullBoundsToPlanes() before touching any of the defs.
+// The portal areas are allocated cleared, so this has no constructor and the memory
+// must be released with Free().
+class idAreaReferenceBounds
+{
+public:
+	// the reference is added at the end and remembers its index
+	void				Add( areaReference_t* ref, const idBounds& bounds );
+	
+	// the last reference is moved into the hole
+	void				Remove( areaReference_t* ref );
+	
+	void				Free();
+	
+	int					Num() const
+	{
+		return num;
+	}
+	areaReference_t* 	GetReference( const int index ) const
+	{
+		return refs[index];
+	}
+	
+	// returns the number of indexes filled in visible[], which must have room for Num() indexes
+	int					CullToPlanes( int* visible, const idPlane* planes, const int numPlanes ) const;
+	
+private:
+	static const int	GRANULARITY = 64;
+	
+	areaReference_t** 	refs;
+	float* 				bounds;		// [6][max]
+	int					num;
+	int					max;
+};
+
 typedef struct portalArea_s
 {
 	int				areaNum;
@@ -69,6 +106,9 @@ typedef struct portalArea_s
 	portal_t* 		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	int				entityRefsGeneration;	// incremented whenever an entityRef is added or removed
+	idAreaReferenceBounds	entityBounds;	// packed bounds of the entityRefs
+	idAreaReferenceBounds	lightBounds;	// packed bounds of the lightRefs
 } portalArea_t;
 
 
@@ -212,6 +212,31 @@ bool idRenderWorldLocal::CullEntityByPortals( const idRenderEntityLocal* entity,
 	return false;
 }
 
+/*
+===================
+R_CullAreaReferenceBounds
+
+Culls the packed bounds of the references of an area to the same portal stack planes
+the exact culling uses for the cull mode, so only the references that may pass it
+have their defs touched at all.
+Returns the number of indexes filled in visible[].
+===================
+*/
+static int R_CullAreaReferenceBounds( const idAreaReferenceBounds& refBounds, const portalStack_t* ps, const int cullMode, int* visible )
+{
+	int numPlanes = 0;
+	if( cullMode == 1 )
+	{
+		numPlanes = ps->numPortalPlanes;
+	}
+	else if( cullMode >= 2 )
+	{
+		// skip the last plane which is the last portal itself
+		numPlanes = Max( ps->numPortalPlanes - 1, 0 );
+	}
+	return refBounds.CullToPlanes( visible, ps->portalPlanes, numPlanes );
+}
+
 /*
 ===================
 AddAreaViewEntities
@@ -223,9 +248,22 @@ void idRenderWorldLocal::AddAreaViewEntities( int areaNum, const portalStack_t*
 {
 	portalArea_t* area = &portalAreas[ areaNum ];
 	
+	// remove decals that are completely faded away, also on the entities the bounds cull skips
 	for( areaReference_t* ref = area->entityRefs.areaNext; ref != &area->entityRefs; ref = ref->areaNext )
 	{
-		idRenderEntityLocal*	 entity = ref->entity;
+		if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != ref->entity->index )
+		{
+			continue;
+		}
+		R_FreeEntityDefFadedDecals( ref->entity, tr.viewDef->renderView.time[0] );
+	}
+	
+	int* visible = ( int* ) _alloca16( area->entityBounds.Num() * sizeof( int ) );
+	const int numVisible = R_CullAreaReferenceBounds( area->entityBounds, ps, r_useEntityPortalCulling.GetInteger(), visible );
+	
+	for( int i = 0; i < numVisible; i++ )
+	{
+		idRenderEntityLocal*	 entity = area->entityBounds.GetReference( visible[i] )->entity;
 		
 		// debug tool to allow viewing of only one entity at a time
 		if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != entity->index )
@@ -233,9 +271,6 @@ void idRenderWorldLocal::AddAreaViewEntities( int areaNum, const portalStack_t*
 			continue;
 		}
 		
-		// remove decals that are completely faded away
-		R_FreeEntityDefFadedDecals( entity, tr.viewDef->renderView.time[0] );
-		
 		// check for completely suppressing the model
 		if( !r_skipSuppress.GetBool() )
 		{
@@ -365,9 +400,12 @@ void idRenderWorldLocal::AddAreaViewLights( int areaNum, const portalStack_t* ps
 {
 	portalArea_t* area = &portalAreas[ areaNum ];
 	
-	for( areaReference_t* lref = area->lightRefs.areaNext; lref != &area->lightRefs; lref = lref->areaNext )
+	int* visible = ( int* ) _alloca16( area->lightBounds.Num() * sizeof( int ) );
+	const int numVisible = R_CullAreaReferenceBounds( area->lightBounds, ps, r_useLightPortalCulling.GetInteger(), visible );
+	
+	for( int i = 0; i < numVisible; i++ )
 	{
-		idRenderLightLocal* light = lref->light;
+		idRenderLightLocal* light = area->lightBounds.GetReference( visible[i] )->light;
 		
 		// debug tool to allow viewing of only one light at a time
 		if( r_singleLight.GetInteger() >= 0 && r_singleLight.GetInteger() != light->index )
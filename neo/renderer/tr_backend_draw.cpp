@@ -1053,6 +1053,10 @@ const int INTERACTION_TEXUNIT_SPECULAR		= 4;
 const int INTERACTION_TEXUNIT_SHADOWMAPS	= 5;
 const int INTERACTION_TEXUNIT_JITTER		= 6;
 
+// the clustered interaction pass doesn't use shadow maps, so the light data takes their texture units
+const int INTERACTION_TEXUNIT_CLUSTERED_LIGHTS	= 5;
+const int INTERACTION_TEXUNIT_CLUSTER_GRID		= 6;
+
 /*
 ==================
 RB_SetupInteractionStage
@@ -1210,6 +1214,141 @@ static void RB_SetupForFastPathInteractions( const idVec4& diffuseColor, const i
 	SetFragmentParm( RENDERPARM_SPECULARMODIFIER, specularColor.ToFloatPtr() );
 }
 
+/*
+=============
+RB_DrawInteractionStages
+
+Draws the interaction stages of a surface with the render prog and light parms that
+are already set.  Complex surfaces overwrite the parms of RB_SetupForFastPathInteractions,
+so the fast path surfaces have to be drawn first.
+=============
+*/
+static void RB_DrawInteractionStages( drawInteraction_t& inter, const drawSurf_t* surf, const idVec4& diffuseColor, const idVec4& specularColor )
+{
+	const idMaterial* surfaceShader = surf->material;
+	const float* surfaceRegs = surf->shaderRegisters;
+	
+	inter.surf = surf;
+	
+	// check for the fast path
+	if( surfaceShader->GetFastPathBumpImage() && !r_skipInteractionFastPath.GetBool() )
+	{
+		renderLog.OpenBlock( surf->material->GetName() );
+		
+		// texture 0 will be the per-surface bump map
+		GL_SelectTexture( INTERACTION_TEXUNIT_BUMP );
+		surfaceShader->GetFastPathBumpImage()->Bind();
+		
+		// texture 3 is the per-surface diffuse map
+		GL_SelectTexture( INTERACTION_TEXUNIT_DIFFUSE );
+		surfaceShader->GetFastPathDiffuseImage()->Bind();
+		
+		// texture 4 is the per-surface specular map
+		GL_SelectTexture( INTERACTION_TEXUNIT_SPECULAR );
+		surfaceShader->GetFastPathSpecularImage()->Bind();
+		
+		RB_DrawElementsWithCounters( surf );
+		
+		renderLog.CloseBlock();
+		return;
+	}
+	
+	renderLog.OpenBlock( surf->material->GetName() );
+	
+	inter.bumpImage = NULL;
+	inter.specularImage = NULL;
+	inter.diffuseImage = NULL;
+	inter.diffuseColor[0] = inter.diffuseColor[1] = inter.diffuseColor[2] = inter.diffuseColor[3] = 0;
+	inter.specularColor[0] = inter.specularColor[1] = inter.specularColor[2] = inter.specularColor[3] = 0;
+	
+	// go through the individual surface stages
+	//
+	// This is somewhat arcane because of the old support for video cards that had to render
+	// interactions in multiple passes.
+	//
+	// We also have the very rare case of some materials that have conditional interactions
+	// for the "hell writing" that can be shined on them.
+	for( int surfaceStageNum = 0; surfaceStageNum < surfaceShader->GetNumStages(); surfaceStageNum++ )
+	{
+		const shaderStage_t*	surfaceStage = surfaceShader->GetStage( surfaceStageNum );
+		
+		switch( surfaceStage->lighting )
+		{
+			case SL_COVERAGE:
+			{
+				// ignore any coverage stages since they should only be used for the depth fill pass
+				// for diffuse stages that use alpha test.
+				break;
+			}
+			case SL_AMBIENT:
+			{
+				// ignore ambient stages while drawing interactions
+				break;
+			}
+			case SL_BUMP:
+			{
+				// ignore stage that fails the condition
+				if( !surfaceRegs[ surfaceStage->conditionRegister ] )
+				{
+					break;
+				}
+				// draw any previous interaction
+				if( inter.bumpImage != NULL )
+				{
+					RB_DrawSingleInteraction( &inter );
+				}
+				inter.bumpImage = surfaceStage->texture.image;
+				inter.diffuseImage = NULL;
+				inter.specularImage = NULL;
+				RB_SetupInteractionStage( surfaceStage, surfaceRegs, NULL,
+										  inter.bumpMatrix, NULL );
+				break;
+			}
+			case SL_DIFFUSE:
+			{
+				// ignore stage that fails the condition
+				if( !surfaceRegs[ surfaceStage->conditionRegister ] )
+				{
+					break;
+				}
+				// draw any previous interaction
+				if( inter.diffuseImage != NULL )
+				{
+					RB_DrawSingleInteraction( &inter );
+				}
+				inter.diffuseImage = surfaceStage->texture.image;
+				inter.vertexColor = surfaceStage->vertexColor;
+				RB_SetupInteractionStage( surfaceStage, surfaceRegs, diffuseColor.ToFloatPtr(),
+										  inter.diffuseMatrix, inter.diffuseColor.ToFloatPtr() );
+				break;
+			}
+			case SL_SPECULAR:
+			{
+				// ignore stage that fails the condition
+				if( !surfaceRegs[ surfaceStage->conditionRegister ] )
+				{
+					break;
+				}
+				// draw any previous interaction
+				if( inter.specularImage != NULL )
+				{
+					RB_DrawSingleInteraction( &inter );
+				}
+				inter.specularImage = surfaceStage->texture.image;
+				inter.vertexColor = surfaceStage->vertexColor;
+				RB_SetupInteractionStage( surfaceStage, surfaceRegs, specularColor.ToFloatPtr(),
+										  inter.specularMatrix, inter.specularColor.ToFloatPtr() );
+				break;
+			}
+		}
+	}
+	
+	// draw the final interaction
+	RB_DrawSingleInteraction( &inter );
+	
+	renderLog.CloseBlock();
+}
+
 /*
 =============
 RB_RenderInteractions
@@ -1490,11 +1629,6 @@ static void RB_RenderInteractions( const drawSurf_t* surfList, const viewLight_t
 				}
 			}
 			
-			const idMaterial* surfaceShader = surf->material;
-			const float* surfaceRegs = surf->shaderRegisters;
-			
-			inter.surf = surf;
-			
 			// change the MVP matrix, view/light origin and light projection vectors if needed
 			if( surf->space != backEnd.currentSpace )
 			{
@@ -1620,132 +1754,153 @@ static void RB_RenderInteractions( const drawSurf_t* surfList, const viewLight_t
 				// RB end
 			}
 			
-			// check for the fast path
-			if( surfaceShader->GetFastPathBumpImage() && !r_skipInteractionFastPath.GetBool() )
+			RB_DrawInteractionStages( inter, surf, diffuseColor, specularColor );
+		}
+	}
+	
+	if( useLightDepthBounds && lightDepthBoundsDisabled )
+	{
+		GL_DepthBoundsTest( vLight->scissorRect.zmin, vLight->scissorRect.zmax );
+	}
+	
+	renderProgManager.Unbind();
+}
+
+/*
+=============
+RB_DrawClusteredInteractions
+
+Draws the opaque surfaces once for all lights in the cluster grid of the view.
+The fragment program finds the cluster of each fragment and loops over its lights.
+=============
+*/
+static void RB_DrawClusteredInteractions( const viewDef_t* viewDef )
+{
+	const clusteredLights_t* clusters = viewDef->clusteredLights;
+	if( clusters == NULL )
+	{
+		return;
+	}
+	
+	renderLog.OpenBlock( "Clustered Light Interactions" );
+	
+	// upload the light data and the cluster grid for this view
+	globalImages->clusteredLightsImage->SubImageUpload( 0, 0, 0, 0, CLUSTERED_LIGHT_VECTORS, clusters->numLights, clusters->lightVectors );
+	globalImages->clusterGridImage->SubImageUpload( 0, 0, 0, 0, CLUSTER_GRID_WIDTH, clusters->numGridVectors / CLUSTER_GRID_WIDTH, clusters->gridVectors );
+	
+	// no fragment outside of the light scissor rects can find a light
+	if( !backEnd.currentScissor.Equals( clusters->scissorRect ) && r_useScissor.GetBool() )
+	{
+		GL_Scissor( viewDef->viewport.x1 + clusters->scissorRect.x1,
+					viewDef->viewport.y1 + clusters->scissorRect.y1,
+					clusters->scissorRect.x2 + 1 - clusters->scissorRect.x1,
+					clusters->scissorRect.y2 + 1 - clusters->scissorRect.y1 );
+		backEnd.currentScissor = clusters->scissorRect;
+	}
+	
+	GL_State( GLS_SRCBLEND_ONE | GLS_DSTBLEND_ONE | GLS_DEPTHMASK | GLS_DEPTHFUNC_EQUAL | GLS_STENCIL_FUNC_ALWAYS );
+	
+	// texture 1 will be the light falloff texture
+	GL_SelectTexture( INTERACTION_TEXUNIT_FALLOFF );
+	clusters->falloffImage->Bind();
+	
+	// texture 2 will be the light projection texture
+	GL_SelectTexture( INTERACTION_TEXUNIT_PROJECTION );
+	clusters->projectionImage->Bind();
+	
+	// texture 5 will be the light data
+	GL_SelectTexture( INTERACTION_TEXUNIT_CLUSTERED_LIGHTS );
+	globalImages->clusteredLightsImage->Bind();
+	
+	// texture 6 will be the cluster grid
+	GL_SelectTexture( INTERACTION_TEXUNIT_CLUSTER_GRID );
+	globalImages->clusterGridImage->Bind();
+	
+	const float clusterParms[4] = { clusters->tileScale[0], clusters->tileScale[1], clusters->sliceScale, clusters->sliceBias };
+	SetFragmentParm( ( renderParm_t )( RENDERPARM_USER + 0 ), clusterParms ); // rpUser0
+	
+	const float viewportParms[4] = { ( float )viewDef->viewport.x1, ( float )viewDef->viewport.y1, 0.0f, 0.0f };
+	SetFragmentParm( ( renderParm_t )( RENDERPARM_USER + 1 ), viewportParms ); // rpUser1
+	
+	// the light colors are in the light data, only the 2x factor for specular is applied here
+	const idVec4 diffuseColor( 1.0f, 1.0f, 1.0f, 1.0f );
+	const idVec4 specularColor( 2.0f, 2.0f, 2.0f, 2.0f );
+	
+	drawInteraction_t inter = {};
+	
+	backEnd.currentSpace = NULL;
+	
+	// draw the fast path surfaces in a row before the complex surfaces
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		if( pass == 0 )
+		{
+			RB_SetupForFastPathInteractions( diffuseColor, specularColor );
+		}
+		
+		for( int i = 0; i < viewDef->numDrawSurfs; i++ )
+		{
+			const drawSurf_t* surf = viewDef->drawSurfs[i];
+			const idMaterial* surfaceShader = surf->material;
+			
+			// translucent surfaces are drawn with the regular interactions of the light
+			if( !surfaceShader->ReceivesLighting() || surfaceShader->Coverage() == MC_TRANSLUCENT || surfaceShader->Spectrum() != 0 )
+			{
+				continue;
+			}
+			
+			// so are the surfaces of entities that not all the clustered lights interact with
+			if( surf->space->skipClusteredLights )
 			{
-				renderLog.OpenBlock( surf->material->GetName() );
-				
-				// texture 0 will be the per-surface bump map
-				GL_SelectTexture( INTERACTION_TEXUNIT_BUMP );
-				surfaceShader->GetFastPathBumpImage()->Bind();
-				
-				// texture 3 is the per-surface diffuse map
-				GL_SelectTexture( INTERACTION_TEXUNIT_DIFFUSE );
-				surfaceShader->GetFastPathDiffuseImage()->Bind();
-				
-				// texture 4 is the per-surface specular map
-				GL_SelectTexture( INTERACTION_TEXUNIT_SPECULAR );
-				surfaceShader->GetFastPathSpecularImage()->Bind();
-				
-				RB_DrawElementsWithCounters( surf );
-				
-				renderLog.CloseBlock();
 				continue;
 			}
 			
-			renderLog.OpenBlock( surf->material->GetName() );
+			const bool fastPath = ( surfaceShader->GetFastPathBumpImage() != NULL && !r_skipInteractionFastPath.GetBool() );
+			if( fastPath != ( pass == 0 ) )
+			{
+				continue;
+			}
 			
-			inter.bumpImage = NULL;
-			inter.specularImage = NULL;
-			inter.diffuseImage = NULL;
-			inter.diffuseColor[0] = inter.diffuseColor[1] = inter.diffuseColor[2] = inter.diffuseColor[3] = 0;
-			inter.specularColor[0] = inter.specularColor[1] = inter.specularColor[2] = inter.specularColor[3] = 0;
+			idScreenRect surfRect = surf->scissorRect;
+			surfRect.Intersect( clusters->scissorRect );
+			if( surfRect.IsEmpty() )
+			{
+				continue;
+			}
 			
-			// go through the individual surface stages
-			//
-			// This is somewhat arcane because of the old support for video cards that had to render
-			// interactions in multiple passes.
-			//
-			// We also have the very rare case of some materials that have conditional interactions
-			// for the "hell writing" that can be shined on them.
-			for( int surfaceStageNum = 0; surfaceStageNum < surfaceShader->GetNumStages(); surfaceStageNum++ )
+			if( surf->jointCache )
 			{
-				const shaderStage_t*	surfaceStage = surfaceShader->GetStage( surfaceStageNum );
-				
-				switch( surfaceStage->lighting )
-				{
-					case SL_COVERAGE:
-					{
-						// ignore any coverage stages since they should only be used for the depth fill pass
-						// for diffuse stages that use alpha test.
-						break;
-					}
-					case SL_AMBIENT:
-					{
-						// ignore ambient stages while drawing interactions
-						break;
-					}
-					case SL_BUMP:
-					{
-						// ignore stage that fails the condition
-						if( !surfaceRegs[ surfaceStage->conditionRegister ] )
-						{
-							break;
-						}
-						// draw any previous interaction
-						if( inter.bumpImage != NULL )
-						{
-							RB_DrawSingleInteraction( &inter );
-						}
-						inter.bumpImage = surfaceStage->texture.image;
-						inter.diffuseImage = NULL;
-						inter.specularImage = NULL;
-						RB_SetupInteractionStage( surfaceStage, surfaceRegs, NULL,
-												  inter.bumpMatrix, NULL );
-						break;
-					}
-					case SL_DIFFUSE:
-					{
-						// ignore stage that fails the condition
-						if( !surfaceRegs[ surfaceStage->conditionRegister ] )
-						{
-							break;
-						}
-						// draw any previous interaction
-						if( inter.diffuseImage != NULL )
-						{
-							RB_DrawSingleInteraction( &inter );
-						}
-						inter.diffuseImage = surfaceStage->texture.image;
-						inter.vertexColor = surfaceStage->vertexColor;
-						RB_SetupInteractionStage( surfaceStage, surfaceRegs, diffuseColor.ToFloatPtr(),
-												  inter.diffuseMatrix, inter.diffuseColor.ToFloatPtr() );
-						break;
-					}
-					case SL_SPECULAR:
-					{
-						// ignore stage that fails the condition
-						if( !surfaceRegs[ surfaceStage->conditionRegister ] )
-						{
-							break;
-						}
-						// draw any previous interaction
-						if( inter.specularImage != NULL )
-						{
-							RB_DrawSingleInteraction( &inter );
-						}
-						inter.specularImage = surfaceStage->texture.image;
-						inter.vertexColor = surfaceStage->vertexColor;
-						RB_SetupInteractionStage( surfaceStage, surfaceRegs, specularColor.ToFloatPtr(),
-												  inter.specularMatrix, inter.specularColor.ToFloatPtr() );
-						break;
-					}
-				}
+				renderProgManager.BindShader_Interaction_Clustered_Skinned();
+			}
+			else
+			{
+				renderProgManager.BindShader_Interaction_Clustered();
 			}
 			
-			// draw the final interaction
-			RB_DrawSingleInteraction( &inter );
+			// change the MVP and model matrices if needed
+			if( surf->space != backEnd.currentSpace )
+			{
+				backEnd.currentSpace = surf->space;
+				
+				RB_SetMVP( surf->space->mvp );
+				
+				idRenderMatrix modelMatrix;
+				idRenderMatrix::Transpose( *( idRenderMatrix* )surf->space->modelMatrix, modelMatrix );
+				SetVertexParms( RENDERPARM_MODELMATRIX_X, modelMatrix[0], 4 );
+				
+				// for determining the depth slice
+				idRenderMatrix modelViewMatrix;
+				idRenderMatrix::Transpose( *( idRenderMatrix* )surf->space->modelViewMatrix, modelViewMatrix );
+				SetVertexParms( RENDERPARM_MODELVIEWMATRIX_X, modelViewMatrix[0], 4 );
+			}
 			
-			renderLog.CloseBlock();
+			RB_DrawInteractionStages( inter, surf, diffuseColor, specularColor );
 		}
 	}
 	
-	if( useLightDepthBounds && lightDepthBoundsDisabled )
-	{
-		GL_DepthBoundsTest( vLight->scissorRect.zmin, vLight->scissorRect.zmax );
-	}
-	
 	renderProgManager.Unbind();
+	
+	renderLog.CloseBlock();
 }
 
 // RB begin
@@ -3476,6 +3631,17 @@ static void RB_DrawInteractions( const viewDef_t* viewDef )
 		renderLog.CloseBlock();
 	}
 	
+	// the lights without shadows in the cluster grid of the view
+	if( viewDef->clusteredLights != NULL )
+	{
+		if( useLightDepthBounds )
+		{
+			GL_DepthBoundsTest( 0.0f, 0.0f );
+		}
+		
+		RB_DrawClusteredInteractions( viewDef );
+	}
+	
 	// disable stencil shadow test
 	GL_State( GLS_DEFAULT );
 	
@@ -39,6 +39,7 @@ extern idCVar r_useShadowPreciseInsideTest;
 
 idCVar r_useAreasConnectedForShadowCulling( "r_useAreasConnectedForShadowCulling", "2", CVAR_RENDERER | CVAR_INTEGER, "cull entities cut off by doors" );
 idCVar r_useParallelAddLights( "r_useParallelAddLights", "1", CVAR_RENDERER | CVAR_BOOL, "aadd all lights in parallel with jobs" );
+idCVar r_useLightInteractionCache( "r_useLightInteractionCache", "1", CVAR_RENDERER | CVAR_BOOL, "keep the entities that may interact with a light across frames" );
 
 /*
 ============================
@@ -83,6 +84,120 @@ bool idRenderEntityLocal::IsDirectlyVisible() const
 	return true;
 }
 
+/*
+===================
+R_UpdateLightInteractionCandidates
+
+Rebuilds the list of entities in the light's areas that may interact with the light
+if an entity has been linked into or out of one of the areas, or a door changed the
+area connectivity since it was last built. Everything checked here only depends on the
+entity and light defs and the area connectivity, so in a static scene the walk over all
+the entityRefs of the light's areas and the culling of the entity bounds to the light
+are done once instead of every frame. The defs themselves invalidate the list through
+their refs when they are updated.
+
+May be run in parallel, it only touches the given light.
+===================
+*/
+static void R_UpdateLightInteractionCandidates( idRenderLightLocal* light )
+{
+	// the area generations only grow, so the sum changes whenever one of them does
+	int areaGeneration = 0;
+	for( const areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		areaGeneration += lref->area->entityRefsGeneration;
+	}
+	
+	const bool cullConnectedAreas = ( light->areaNum != -1 && r_useAreasConnectedForShadowCulling.GetInteger() == 2 );
+	const int connectedAreaNum = cullConnectedAreas ? light->world->connectedAreaNum : -1;
+	
+	if( r_useLightInteractionCache.GetBool()
+			&& light->candidatesAreaGeneration == areaGeneration
+			&& light->candidatesConnectedAreaNum == connectedAreaNum )
+	{
+		return;
+	}
+	
+	light->interactionCandidates.SetNum( 0 );
+	light->candidatesAreaGeneration = areaGeneration;
+	light->candidatesConnectedAreaNum = connectedAreaNum;
+	
+	byte* entityChecked = ( byte* )R_ClearedFrameAlloc( light->world->entityDefs.Num() * sizeof( byte ), FRAME_ALLOC_INTERACTION_STATE );
+	
+	idInteraction** const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
+	
+	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		portalArea_t* area = lref->area;
+		
+		// some lights have their center of projection outside the world, but otherwise
+		// we want to ignore areas that are not connected to the light center due to a closed door
+		if( cullConnectedAreas )
+		{
+			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
+			{
+				// can't possibly be seen or shadowed
+				continue;
+			}
+		}
+		
+		// check all the models in this area
+		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+		{
+			idRenderEntityLocal* edef = eref->entity;
+			
+			if( entityChecked[ edef->index ] )
+			{
+				continue;
+			}
+			entityChecked[ edef->index ] = 1;
+			
+			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
+			const idInteraction* inter = interactionTableRow[ edef->index ];
+			
+			const idRenderModel* eModel = edef->parms.hModel;
+			
+			// a large fraction of static entity / light pairs will still have no interactions even though
+			// they are both present in the same area(s)
+			if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
+			{
+				// the interaction was statically checked, and it didn't generate any surfaces,
+				// so there is no need to force the entity onto the view list if it isn't
+				// already there
+				continue;
+			}
+			
+			// We don't want the lights on weapons to illuminate anything else.
+			// There are two assumptions here -- that allowLightInViewID is only
+			// used for weapon lights, and that all weapons will have weaponDepthHack.
+			// A more general solution would be to have an allowLightOnEntityID field.
+			// HACK: the armor-mounted flashlight is a private spot light, which is probably
+			// wrong -- you would expect to see them in multiplayer.
+			//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
+			//	{
+			//		continue;
+			//	}
+			
+			// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
+			if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
+			{
+				continue;
+			}
+			
+			// do a check of the entity reference bounds against the light frustum to see if they can't
+			// possibly interact, despite sharing one or more world areas
+			// this is done even if an interaction is present, because an interaction with an entity
+			// outside the light never has any surfaces, so the result stays valid with the list
+			if( R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix ) )
+			{
+				continue;
+			}
+			
+			light->interactionCandidates.Append( edef );
+		}
+	}
+}
+
 /*
 ===================
 R_AddSingleLight
@@ -356,151 +471,101 @@ static void R_AddSingleLight( viewLight_t* vLight )
 	
 	idInteraction** const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
 	
-	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	// only the entities that passed the view independent checks the last time an entity
+	// moved through one of the light's areas need to be looked at
+	R_UpdateLightInteractionCandidates( vLight->lightDef );
+	
+	for( int i = 0; i < light->interactionCandidates.Num(); i++ )
 	{
-		portalArea_t* area = lref->area;
+		idRenderEntityLocal* edef = light->interactionCandidates[i];
 		
-		// some lights have their center of projection outside the world, but otherwise
-		// we want to ignore areas that are not connected to the light center due to a closed door
-		if( light->areaNum != -1 && r_useAreasConnectedForShadowCulling.GetInteger() == 2 )
+		// until proven otherwise
+		vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
+		
+		// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
+		const idInteraction* inter = interactionTableRow[ edef->index ];
+		
+		const renderEntity_t& eParms = edef->parms;
+		const idRenderModel* eModel = eParms.hModel;
+		
+		// the interaction may have been created and found empty since the candidates were built
+		if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
 		{
-			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
-			{
-				// can't possibly be seen or shadowed
-				continue;
-			}
+			continue;
 		}
 		
-		// check all the models in this area
-		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+		// non-shadow casting entities don't need to be added if they aren't
+		// directly visible
+		if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
 		{
-			idRenderEntityLocal* edef = eref->entity;
-			
-			if( vLight->entityInteractionState[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
-			{
-				continue;
-			}
-			// until proven otherwise
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
-			
-			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-			const idInteraction* inter = interactionTableRow[ edef->index ];
-			
-			const renderEntity_t& eParms = edef->parms;
-			const idRenderModel* eModel = eParms.hModel;
-			
-			// a large fraction of static entity / light pairs will still have no interactions even though
-			// they are both present in the same area(s)
-			if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
-			{
-				// the interaction was statically checked, and it didn't generate any surfaces,
-				// so there is no need to force the entity onto the view list if it isn't
-				// already there
-				continue;
-			}
-			
-			// We don't want the lights on weapons to illuminate anything else.
-			// There are two assumptions here -- that allowLightInViewID is only
-			// used for weapon lights, and that all weapons will have weaponDepthHack.
-			// A more general solution would be to have an allowLightOnEntityID field.
-			// HACK: the armor-mounted flashlight is a private spot light, which is probably
-			// wrong -- you would expect to see them in multiplayer.
-			//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
-			//	{
-			//		continue;
-			//	}
-			
-			// non-shadow casting entities don't need to be added if they aren't
-			// directly visible
-			if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
-			{
-				continue;
-			}
-			
-			// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
-			if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
-			{
-				continue;
-			}
-			
-			// no interaction present, so either the light or entity has moved
-			// assert( lightHasMoved || edef->entityHasMoved );
-			if( inter == NULL )
-			{
-				// some big outdoor meshes are flagged to not create any dynamic interactions
-				// when the level designer knows that nearby moving lights shouldn't actually hit them
-				if( eParms.noDynamicInteractions )
-				{
-					continue;
-				}
-				
-				// do a check of the entity reference bounds against the light frustum to see if they can't
-				// possibly interact, despite sharing one or more world areas
-				if( R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix ) )
-				{
-					continue;
-				}
-			}
-			
-			// we now know that the entity and light do overlap
-			
-			if( edef->IsDirectlyVisible() )
-			{
-				// entity is directly visible, so the interaction is definitely needed
-				vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
-				continue;
-			}
-			
-			// the entity is not directly visible, but if we can tell that it may cast
-			// shadows onto visible surfaces, we must make a viewEntity for it
-			if( !lightCastsShadows )
-			{
-				// surfaces are never shadowed in this light
-				continue;
-			}
-			// if we are suppressing its shadow in this view (player shadows, etc), skip
-			if( !r_skipSuppress.GetBool() )
-			{
-				if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == renderViewID )
-				{
-					continue;
-				}
-				if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
-				{
-					continue;
-				}
-			}
-			
-			// should we use the shadow bounds from pre-calculated interactions?
-			idBounds shadowBounds;
-			R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, shadowBounds );
-			
-			// this test is pointless if we knew the light was completely contained
-			// in the view frustum, but the entity would also be directly visible in most
-			// of those cases.
-			
-			// this doesn't say that the shadow can't effect anything, only that it can't
-			// effect anything in the view, so we shouldn't set up a view entity
-			if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) )
+			continue;
+		}
+		
+		// some big outdoor meshes are flagged to not create any dynamic interactions
+		// when the level designer knows that nearby moving lights shouldn't actually hit them
+		if( inter == NULL && eParms.noDynamicInteractions )
+		{
+			continue;
+		}
+		
+		// we now know that the entity and light do overlap
+		
+		if( edef->IsDirectlyVisible() )
+		{
+			// entity is directly visible, so the interaction is definitely needed
+			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+			continue;
+		}
+		
+		// the entity is not directly visible, but if we can tell that it may cast
+		// shadows onto visible surfaces, we must make a viewEntity for it
+		if( !lightCastsShadows )
+		{
+			// surfaces are never shadowed in this light
+			continue;
+		}
+		// if we are suppressing its shadow in this view (player shadows, etc), skip
+		if( !r_skipSuppress.GetBool() )
+		{
+			if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == renderViewID )
 			{
 				continue;
 			}
-			
-			// debug tool to allow viewing of only one entity at a time
-			if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
+			if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
 			{
 				continue;
 			}
-			
-			// we do need it for shadows
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
-			
-			// we will need to create a viewEntity_t for it in the serial code section
-			shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
-			shadEnt->next = vLight->shadowOnlyViewEntities;
-			shadEnt->edef = edef;
-			vLight->shadowOnlyViewEntities = shadEnt;
 		}
+		
+		// should we use the shadow bounds from pre-calculated interactions?
+		idBounds shadowBounds;
+		R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, shadowBounds );
+		
+		// this test is pointless if we knew the light was completely contained
+		// in the view frustum, but the entity would also be directly visible in most
+		// of those cases.
+		
+		// this doesn't say that the shadow can't effect anything, only that it can't
+		// effect anything in the view, so we shouldn't set up a view entity
+		if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) )
+		{
+			continue;
+		}
+		
+		// debug tool to allow viewing of only one entity at a time
+		if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
+		{
+			continue;
+		}
+		
+		// we do need it for shadows
+		vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+		
+		// we will need to create a viewEntity_t for it in the serial code section
+		shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
+		shadEnt->next = vLight->shadowOnlyViewEntities;
+		shadEnt->edef = edef;
+		vLight->shadowOnlyViewEntities = shadEnt;
 	}
 	
 	//--------------------------------------------
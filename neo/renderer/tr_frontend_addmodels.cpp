@@ -372,6 +372,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 	vEntity->drawSurfs = NULL;
 	vEntity->staticShadowVolumes = NULL;
 	vEntity->dynamicShadowVolumes = NULL;
+	vEntity->skipClusteredLights = false;
 	
 	// globals we really should pass in...
 	const viewDef_t* viewDef = tr.viewDef;
@@ -493,6 +494,37 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 		}
 	}
 	
+	// the clustered interaction pass lights every opaque surface in the cluster grid, so an entity
+	// that a clustered light touches without an interaction (noDynamicInteractions, behind a closed
+	// door) has to go through the regular interactions to get the same result
+	if( modelIsVisible && viewDef->clusteredLights != NULL )
+	{
+		// for comparing with the regular interactions
+		if( r_useClusteredLights.GetInteger() == 2 && vEntity->scissorRect.x1 + vEntity->scissorRect.x2 > viewDef->viewport.GetWidth() )
+		{
+			vEntity->skipClusteredLights = true;
+		}
+		for( viewLight_t* vLight = viewDef->viewLights; vLight != NULL && !vEntity->skipClusteredLights; vLight = vLight->next )
+		{
+			if( !vLight->clusteredLight || !vLight->lightDef->globalLightBounds.IntersectsBounds( entityDef->globalReferenceBounds ) )
+			{
+				continue;
+			}
+			int i;
+			for( i = 0; i < numContactedLights; i++ )
+			{
+				if( contactedLights[i] == vLight )
+				{
+					break;
+				}
+			}
+			if( i == numContactedLights )
+			{
+				vEntity->skipClusteredLights = true;
+			}
+		}
+	}
+	
 	// if we aren't visible and none of the shadows stretch into the view,
 	// we don't need to do anything else
 	if( !modelIsVisible && numContactedLights == 0 )
@@ -808,6 +840,13 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 			const idRenderLightLocal* lightDef = vLight->lightDef;
 			const idInteraction* interaction = staticInteractions[contactedLight];
 			
+			// the opaque surfaces of clustered lights are lit by the clustered interaction pass,
+			// and clustered lights don't cast shadows
+			if( vLight->clusteredLight && shader->Coverage() != MC_TRANSLUCENT && !vEntity->skipClusteredLights )
+			{
+				continue;
+			}
+			
 			// check for a static interaction
 			surfaceInteraction_t* surfInter = NULL;
 			if( interaction > INTERACTION_EMPTY && interaction->staticInteraction )
@@ -1285,6 +1324,33 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 
 REGISTER_PARALLEL_JOB( R_AddSingleModel, "R_AddSingleModel" );
 
+/*
+===================
+R_AddSingleModelAndShadows
+
+Adds a single model and then immediately starts the shadow volume jobs
+for it as child jobs, so the shadow volumes of the models that are done
+can be built while the other models are still being added.
+===================
+*/
+static void R_AddSingleModelAndShadows( viewEntity_t* vEntity )
+{
+	R_AddSingleModel( vEntity );
+	
+	for( staticShadowVolumeParms_t* shadowParms = vEntity->staticShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next )
+	{
+		tr.frontEndJobList->AddChildJob( ( jobRun_t )StaticShadowVolumeJob, shadowParms );
+	}
+	for( dynamicShadowVolumeParms_t* shadowParms = vEntity->dynamicShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next )
+	{
+		tr.frontEndJobList->AddChildJob( ( jobRun_t )DynamicShadowVolumeJob, shadowParms );
+	}
+	vEntity->staticShadowVolumes = NULL;
+	vEntity->dynamicShadowVolumes = NULL;
+}
+
+REGISTER_PARALLEL_JOB( R_AddSingleModelAndShadows, "R_AddSingleModelAndShadows" );
+
 /*
 =================
 R_LinkDrawSurfToView
@@ -1338,13 +1404,19 @@ void R_AddModels()
 	// any light that intersects the view (for shadows).
 	//-------------------------------------------------
 	
+	const bool skipShadowVolumes = ( r_skipStaticShadows.GetBool() && r_skipDynamicShadows.GetBool() ) || r_useShadowMapping.GetBool();
+	
 	if( r_useParallelAddModels.GetBool() )
 	{
+		// if the shadow volumes are built in parallel as well, each model job starts the shadow
+		// volume jobs for its own model so there is no need to wait for all models to finish first
+		const jobRun_t addModelJob = ( !skipShadowVolumes && r_useParallelAddShadows.GetInteger() == 1 ) ? ( jobRun_t )R_AddSingleModelAndShadows : ( jobRun_t )R_AddSingleModel;
 		for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
 		{
-			tr.frontEndJobList->AddJob( ( jobRun_t )R_AddSingleModel, vEntity );
+			tr.frontEndJobList->AddJob( addModelJob, vEntity );
 		}
 		tr.frontEndJobList->Submit();
+		// wait here otherwise the shadow volume index buffer may be unmapped before all shadow volumes have been constructed
 		tr.frontEndJobList->Wait();
 	}
 	else
@@ -1358,10 +1430,14 @@ void R_AddModels()
 	//-------------------------------------------------
 	// Kick off jobs to setup static and dynamic shadow volumes.
 	//-------------------------------------------------
-	if( ( r_skipStaticShadows.GetBool() && r_skipDynamicShadows.GetBool() ) || r_useShadowMapping.GetBool() )
+	if( skipShadowVolumes )
 	{
 		// no shadow volumes were chained to any entity, all are in DONE state, we don't need to Submit() or Wait()
 	}
+	else if( r_useParallelAddModels.GetBool() && r_useParallelAddShadows.GetInteger() == 1 )
+	{
+		// the shadow volume jobs were already run as child jobs of the model jobs
+	}
 	else
 	{
 		if( r_useParallelAddShadows.GetInteger() == 1 )
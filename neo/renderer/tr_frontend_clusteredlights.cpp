@@ -0,0 +1,400 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+idCVar r_useClusteredLights( "r_useClusteredLights", "0", CVAR_RENDERER | CVAR_INTEGER, "draw the opaque interactions of lights without shadows in a single clustered pass, 2 = only for the entities left of the view center to compare with the regular interactions", 0, 2 );
+idCVar r_clusteredLightsMinimum( "r_clusteredLightsMinimum", "4", CVAR_RENDERER | CVAR_INTEGER, "minimum number of lights that can share the cluster grid before it is used", 1, MAX_CLUSTERED_LIGHTS );
+idCVar r_showClusteredLights( "r_showClusteredLights", "0", CVAR_RENDERER | CVAR_BOOL, "print the number of clustered lights and light indexes" );
+
+/*
+==========================================================================================
+
+CLUSTERED LIGHTS
+
+Every light that is drawn with the regular interaction path costs a list of interaction
+surfaces in the front end and a pass over those surfaces in the back end.  In scenes with
+hundreds of small lights most of that cost is spent on lights that don't cast shadows.
+
+The view is divided into CLUSTER_TILES_X * CLUSTER_TILES_Y screen tiles and CLUSTER_SLICES
+exponential depth slices.  Lights without shadows are added to each cluster that their
+scissor rect and depth range overlap.  The opaque surfaces are then drawn once, and each
+fragment loops over the lights of its cluster.
+
+The lights share the falloff and projection image of the grid, so only the lights that
+use the most common pair of images are clustered.  The other lights, and the translucent
+surfaces of the clustered lights, still go through the regular interaction path.  So do the
+entities that a clustered light touches without an interaction, like noDynamicInteractions
+entities and entities in areas that aren't connected to the light.
+
+r_useClusteredLights 2 leaves the entities right of the view center to the regular interaction
+path, so both paths can be compared side by side.
+
+This runs after R_AddLights, when the scissor rects and shader registers of the lights
+are known, and before R_AddModels creates the interaction surfaces.
+
+==========================================================================================
+*/
+
+struct clusteredLightRange_t
+{
+	viewLight_t* 			vLight;
+	const shaderStage_t* 	lightStage;
+	int						tileX1;
+	int						tileY1;
+	int						tileX2;
+	int						tileY2;
+	float					minDepth;
+	float					maxDepth;
+	int						slice1;
+	int						slice2;
+};
+
+/*
+=================
+R_ClusteredLightStage
+
+Returns the single light stage of a light that can be added to the cluster grid,
+or NULL if the light has to be drawn with the regular interaction path.
+=================
+*/
+static const shaderStage_t* R_ClusteredLightStage( const viewLight_t* vLight )
+{
+	const idMaterial* lightShader = vLight->lightShader;
+	if( lightShader->IsFogLight() || lightShader->IsBlendLight() || lightShader->IsAmbientLight() )
+	{
+		return NULL;
+	}
+	
+	// "invisible ink" lights only light the surfaces with the same spectrum
+	if( lightShader->Spectrum() != 0 )
+	{
+		return NULL;
+	}
+	
+	if( vLight->lightDef->LightCastsShadows() || vLight->parallel || vLight->scissorRect.IsEmpty() )
+	{
+		return NULL;
+	}
+	
+	const float* lightRegs = vLight->shaderRegisters;
+	const shaderStage_t* clusteredStage = NULL;
+	for( int i = 0; i < lightShader->GetNumStages(); i++ )
+	{
+		const shaderStage_t* lightStage = lightShader->GetStage( i );
+		if( !lightRegs[ lightStage->conditionRegister ] )
+		{
+			continue;
+		}
+		if( clusteredStage != NULL )
+		{
+			// rare lights with multiple stages
+			return NULL;
+		}
+		clusteredStage = lightStage;
+	}
+	
+	if( clusteredStage == NULL || clusteredStage->texture.image == NULL || clusteredStage->texture.hasMatrix )
+	{
+		return NULL;
+	}
+	
+	return clusteredStage;
+}
+
+/*
+=================
+R_ClusterSlice
+=================
+*/
+static int R_ClusterSlice( const clusteredLights_t* clusters, float depth )
+{
+	const int slice = idMath::Ftoi( idMath::Floor( idMath::Log( depth ) * clusters->sliceScale + clusters->sliceBias ) );
+	return idMath::ClampInt( 0, CLUSTER_SLICES - 1, slice );
+}
+
+/*
+=================
+R_AssignClusteredLights
+
+Builds the cluster grid for the lights without shadows in the current view.
+=================
+*/
+void R_AssignClusteredLights()
+{
+	tr.viewDef->clusteredLights = NULL;
+	
+	if( !r_useClusteredLights.GetBool() || tr.viewDef->viewLights == NULL )
+	{
+		return;
+	}
+	
+	SCOPED_PROFILE_EVENT( "R_AssignClusteredLights" );
+	
+	//-------------------------------------------------
+	// find the most common pair of falloff and projection images
+	//-------------------------------------------------
+	
+	struct lightImages_t
+	{
+		idImage* 	falloffImage;
+		idImage* 	projectionImage;
+		int			numLights;
+	};
+	idStaticList< lightImages_t, 32 > lightImages;
+	int bestImages = -1;
+	
+	for( viewLight_t* vLight = tr.viewDef->viewLights; vLight != NULL; vLight = vLight->next )
+	{
+		const shaderStage_t* lightStage = R_ClusteredLightStage( vLight );
+		if( lightStage == NULL )
+		{
+			continue;
+		}
+		
+		int i;
+		for( i = 0; i < lightImages.Num(); i++ )
+		{
+			if( lightImages[i].falloffImage == vLight->falloffImage && lightImages[i].projectionImage == lightStage->texture.image )
+			{
+				break;
+			}
+		}
+		if( i == lightImages.Num() )
+		{
+			lightImages_t* images = lightImages.Alloc();
+			if( images == NULL )
+			{
+				continue;
+			}
+			images->falloffImage = vLight->falloffImage;
+			images->projectionImage = lightStage->texture.image;
+			images->numLights = 0;
+		}
+		lightImages[i].numLights++;
+		
+		if( bestImages == -1 || lightImages[i].numLights > lightImages[bestImages].numLights )
+		{
+			bestImages = i;
+		}
+	}
+	
+	if( bestImages == -1 || lightImages[bestImages].numLights < r_clusteredLightsMinimum.GetInteger() )
+	{
+		return;
+	}
+	
+	idImage* falloffImage = lightImages[bestImages].falloffImage;
+	idImage* projectionImage = lightImages[bestImages].projectionImage;
+	const int maxLights = Min( lightImages[bestImages].numLights, MAX_CLUSTERED_LIGHTS );
+	
+	//-------------------------------------------------
+	// find the screen tiles and the depth range of the lights
+	//-------------------------------------------------
+	
+	const idScreenRect& viewport = tr.viewDef->viewport;
+	const float tileScaleX = ( float )CLUSTER_TILES_X / viewport.GetWidth();
+	const float tileScaleY = ( float )CLUSTER_TILES_Y / viewport.GetHeight();
+	
+	const idVec3& viewOrigin = tr.viewDef->renderView.vieworg;
+	const idVec3& viewForward = tr.viewDef->renderView.viewaxis[0];
+	const float zNear = r_znear.GetFloat();
+	float zFar = zNear * 2.0f;
+	
+	clusteredLightRange_t* ranges = ( clusteredLightRange_t* )R_FrameAlloc( maxLights * sizeof( ranges[0] ), FRAME_ALLOC_UNKNOWN );
+	int numRanges = 0;
+	
+	for( viewLight_t* vLight = tr.viewDef->viewLights; vLight != NULL && numRanges < maxLights; vLight = vLight->next )
+	{
+		const shaderStage_t* lightStage = R_ClusteredLightStage( vLight );
+		if( lightStage == NULL || vLight->falloffImage != falloffImage || lightStage->texture.image != projectionImage )
+		{
+			continue;
+		}
+		
+		const idBounds& bounds = vLight->lightDef->globalLightBounds;
+		float minDepth = idMath::INFINITY;
+		float maxDepth = -idMath::INFINITY;
+		for( int i = 0; i < 8; i++ )
+		{
+			const idVec3 corner( bounds[i & 1].x, bounds[( i >> 1 ) & 1].y, bounds[( i >> 2 ) & 1].z );
+			const float depth = ( corner - viewOrigin ) * viewForward;
+			minDepth = Min( minDepth, depth );
+			maxDepth = Max( maxDepth, depth );
+		}
+		if( maxDepth < zNear )
+		{
+			continue;
+		}
+		
+		const idScreenRect& rect = vLight->scissorRect;
+		
+		clusteredLightRange_t& range = ranges[numRanges++];
+		range.vLight = vLight;
+		range.lightStage = lightStage;
+		range.tileX1 = idMath::ClampInt( 0, CLUSTER_TILES_X - 1, idMath::Ftoi( rect.x1 * tileScaleX ) );
+		range.tileY1 = idMath::ClampInt( 0, CLUSTER_TILES_Y - 1, idMath::Ftoi( rect.y1 * tileScaleY ) );
+		range.tileX2 = idMath::ClampInt( 0, CLUSTER_TILES_X - 1, idMath::Ftoi( ( rect.x2 + 1 ) * tileScaleX ) );
+		range.tileY2 = idMath::ClampInt( 0, CLUSTER_TILES_Y - 1, idMath::Ftoi( ( rect.y2 + 1 ) * tileScaleY ) );
+		range.minDepth = Max( minDepth, zNear );
+		range.maxDepth = maxDepth;
+		
+		zFar = Max( zFar, maxDepth );
+	}
+	
+	if( numRanges < r_clusteredLightsMinimum.GetInteger() )
+	{
+		return;
+	}
+	
+	clusteredLights_t* clusters = ( clusteredLights_t* )R_ClearedFrameAlloc( sizeof( *clusters ), FRAME_ALLOC_UNKNOWN );
+	clusters->tileScale[0] = tileScaleX;
+	clusters->tileScale[1] = tileScaleY;
+	clusters->sliceScale = CLUSTER_SLICES / idMath::Log( zFar / zNear );
+	clusters->sliceBias = -idMath::Log( zNear ) * clusters->sliceScale;
+	clusters->falloffImage = falloffImage;
+	clusters->projectionImage = projectionImage;
+	clusters->scissorRect.Clear();
+	
+	//-------------------------------------------------
+	// count the lights of each cluster, lights that don't fit in the
+	// grid anymore are left to the regular interaction path
+	//-------------------------------------------------
+	
+	int* clusterCounts = ( int* )R_ClearedFrameAlloc( CLUSTER_COUNT * sizeof( clusterCounts[0] ), FRAME_ALLOC_UNKNOWN );
+	int numIndexes = 0;
+	int numClusteredRanges = 0;
+	
+	for( int i = 0; i < numRanges; i++ )
+	{
+		clusteredLightRange_t& range = ranges[i];
+		range.slice1 = R_ClusterSlice( clusters, range.minDepth );
+		range.slice2 = R_ClusterSlice( clusters, range.maxDepth );
+		
+		const int rangeIndexes = ( range.tileX2 - range.tileX1 + 1 ) * ( range.tileY2 - range.tileY1 + 1 ) * ( range.slice2 - range.slice1 + 1 );
+		if( numIndexes + rangeIndexes > MAX_CLUSTER_LIGHT_INDEXES )
+		{
+			continue;
+		}
+		numIndexes += rangeIndexes;
+		
+		for( int z = range.slice1; z <= range.slice2; z++ )
+		{
+			for( int y = range.tileY1; y <= range.tileY2; y++ )
+			{
+				for( int x = range.tileX1; x <= range.tileX2; x++ )
+				{
+					clusterCounts[( z * CLUSTER_TILES_Y + y ) * CLUSTER_TILES_X + x]++;
+				}
+			}
+		}
+		
+		ranges[numClusteredRanges++] = range;
+	}
+	
+	if( numClusteredRanges == 0 )
+	{
+		return;
+	}
+	
+	//-------------------------------------------------
+	// fill in the light data and the cluster grid
+	//-------------------------------------------------
+	
+	const int numIndexVectors = ( numIndexes + 3 ) >> 2;
+	const int numGridRows = ( CLUSTER_COUNT + numIndexVectors + CLUSTER_GRID_WIDTH - 1 ) / CLUSTER_GRID_WIDTH;
+	
+	clusters->numLights = numClusteredRanges;
+	clusters->lightVectors = ( idVec4* )R_FrameAlloc( numClusteredRanges * CLUSTERED_LIGHT_VECTORS * sizeof( idVec4 ), FRAME_ALLOC_UNKNOWN );
+	clusters->numGridVectors = numGridRows * CLUSTER_GRID_WIDTH;
+	clusters->gridVectors = ( idVec4* )R_ClearedFrameAlloc( clusters->numGridVectors * sizeof( idVec4 ), FRAME_ALLOC_UNKNOWN );
+	
+	idVec4* gridVectors = clusters->gridVectors;
+	float* gridIndexes = gridVectors[CLUSTER_COUNT].ToFloatPtr();
+	
+	int firstIndex = 0;
+	for( int i = 0; i < CLUSTER_COUNT; i++ )
+	{
+		gridVectors[i].x = firstIndex;
+		firstIndex += clusterCounts[i];
+		clusterCounts[i] = 0;
+	}
+	
+	const float lightScale = r_useHDR.GetBool() ? 3.0f : r_lightScale.GetFloat();
+	
+	for( int i = 0; i < numClusteredRanges; i++ )
+	{
+		const clusteredLightRange_t& range = ranges[i];
+		viewLight_t* vLight = range.vLight;
+		const float* lightRegs = vLight->shaderRegisters;
+		const shaderStage_t* lightStage = range.lightStage;
+		
+		idVec4* lightVectors = clusters->lightVectors + i * CLUSTERED_LIGHT_VECTORS;
+		lightVectors[0] = vLight->lightProject[0].ToVec4();
+		lightVectors[1] = vLight->lightProject[1].ToVec4();
+		lightVectors[2] = vLight->lightProject[2].ToVec4();
+		lightVectors[3] = vLight->lightProject[3].ToVec4();
+		lightVectors[4].Set( vLight->globalLightOrigin.x, vLight->globalLightOrigin.y, vLight->globalLightOrigin.z, 1.0f );
+		lightVectors[5].Set( lightScale * lightRegs[ lightStage->color.registers[0] ],
+							 lightScale * lightRegs[ lightStage->color.registers[1] ],
+							 lightScale * lightRegs[ lightStage->color.registers[2] ],
+							 lightRegs[ lightStage->color.registers[3] ] );
+							 
+		for( int z = range.slice1; z <= range.slice2; z++ )
+		{
+			for( int y = range.tileY1; y <= range.tileY2; y++ )
+			{
+				for( int x = range.tileX1; x <= range.tileX2; x++ )
+				{
+					const int cluster = ( z * CLUSTER_TILES_Y + y ) * CLUSTER_TILES_X + x;
+					gridIndexes[ idMath::Ftoi( gridVectors[cluster].x ) + clusterCounts[cluster]++ ] = i;
+				}
+			}
+		}
+		
+		clusters->scissorRect.Union( vLight->scissorRect );
+		
+		// R_AddModels will only add the translucent interactions of the light
+		vLight->clusteredLight = true;
+	}
+	
+	for( int i = 0; i < CLUSTER_COUNT; i++ )
+	{
+		gridVectors[i].y = clusterCounts[i];
+	}
+	
+	if( r_showClusteredLights.GetBool() )
+	{
+		common->Printf( "clustered lights: %i of %i lights, %i indexes\n", numClusteredRanges, numRanges, numIndexes );
+	}
+	
+	tr.viewDef->clusteredLights = clusters;
+}
@@ -44,10 +44,27 @@ static const unsigned int NUM_FRAME_DATA = 2;
 static const unsigned int FRAME_ALLOC_ALIGNMENT = 128;
 static const unsigned int MAX_FRAME_MEMORY = 64 * 1024 * 1024;	// larger so that we can noclip on PC for dev purposes
 
+// every thread takes a block of this size out of the frame memory
+// and allocates from it without touching any shared state
+static const unsigned int FRAME_ALLOC_BLOCK_SIZE = 64 * 1024;
+static const unsigned int MAX_FRAME_ALLOC_THREADS = 64;
+
 idFrameData		smpFrameData[NUM_FRAME_DATA];
 idFrameData* 	frameData;
 unsigned int	smpFrame;
 
+struct frameAllocBlock_t
+{
+	byte* 			current;
+	byte* 			end;
+	unsigned int	frame;		// smpFrame the block was taken in, stale blocks are never used
+	byte			pad[CACHE_LINE_SIZE - sizeof( unsigned int ) - 2 * sizeof( byte* )];
+};
+
+static frameAllocBlock_t		frameAllocBlocks[MAX_FRAME_ALLOC_THREADS];
+static idSysInterlockedInteger	numFrameAllocBlocks;
+static ID_TLS					frameAllocBlockIndex;	// 1 based, -1 if the thread didn't get a block
+
 //#define TRACK_FRAME_ALLOCS
 
 #if defined( TRACK_FRAME_ALLOCS )
@@ -55,6 +72,23 @@ idSysInterlockedInteger frameAllocTypeCount[FRAME_ALLOC_MAX];
 int frameHighWaterTypeCount[FRAME_ALLOC_MAX];
 #endif
 
+/*
+====================
+R_FreeFrameOverflow
+====================
+*/
+static void R_FreeFrameOverflow( idFrameData* data )
+{
+	frameOverflowBlock_t* next;
+	for( frameOverflowBlock_t* block = data->overflowBlocks; block != NULL; block = next )
+	{
+		next = block->next;
+		Mem_Free16( block );
+	}
+	data->overflowBlocks = NULL;
+	data->frameMemoryOverflow.SetValue( 0 );
+}
+
 /*
 ====================
 R_ToggleSmpFrame
@@ -63,6 +97,7 @@ R_ToggleSmpFrame
 void R_ToggleSmpFrame()
 {
 	// update the highwater mark
+	const int lastFrameAllocated = frameData->frameMemoryAllocated.GetValue() + frameData->frameMemoryOverflow.GetValue();
 	if( frameData->frameMemoryAllocated.GetValue() > frameData->highWaterAllocated )
 	{
 		frameData->highWaterAllocated = frameData->frameMemoryAllocated.GetValue();
@@ -75,7 +110,7 @@ void R_ToggleSmpFrame()
 #endif
 	}
 	
-	// switch to the next frame
+	// switch to the next frame, this also invalidates the blocks of all threads
 	smpFrame++;
 	frameData = &smpFrameData[smpFrame % NUM_FRAME_DATA];
 	
@@ -87,6 +122,10 @@ void R_ToggleSmpFrame()
 	
 	frameData->frameMemoryAllocated.SetValue( bytesNeededForAlignment );
 	frameData->frameMemoryUsed.SetValue( 0 );
+	frameData->lastFrameAllocated = lastFrameAllocated;
+	
+	// the back end is done with this frame so anything that overflowed can go
+	R_FreeFrameOverflow( frameData );
 	
 #if defined( TRACK_FRAME_ALLOCS )
 	for( int i = 0; i < FRAME_ALLOC_MAX; i++ )
@@ -111,6 +150,7 @@ void R_ShutdownFrameData()
 	frameData = NULL;
 	for( int i = 0; i < NUM_FRAME_DATA; i++ )
 	{
+		R_FreeFrameOverflow( &smpFrameData[i] );
 		Mem_Free16( smpFrameData[i].frameMemory );
 		smpFrameData[i].frameMemory = NULL;
 	}
@@ -136,6 +176,83 @@ void R_InitFrameData()
 	R_ToggleSmpFrame();
 }
 
+/*
+================
+R_FrameOverflowAlloc
+
+The frame memory is exhausted, so get the memory from the heap
+and keep it until this frame data is used again.
+================
+*/
+static byte* R_FrameOverflowAlloc( int bytes )
+{
+	if( frameData->frameMemoryOverflow.Add( bytes ) == bytes )
+	{
+		idLib::Warning( "R_FrameAlloc ran out of frame memory, highWaterAllocated = %d", frameData->highWaterAllocated );
+	}
+	
+	frameOverflowBlock_t* block = ( frameOverflowBlock_t* )Mem_Alloc16( FRAME_ALLOC_ALIGNMENT + bytes, TAG_RENDER );
+	
+	frameData->overflowMutex.Lock();
+	block->next = frameData->overflowBlocks;
+	frameData->overflowBlocks = block;
+	frameData->overflowMutex.Unlock();
+	
+	byte* ptr = ( byte* )block + FRAME_ALLOC_ALIGNMENT;
+	memset( ptr, 0, bytes );
+	return ptr;
+}
+
+/*
+================
+R_FrameSharedAlloc
+
+Allocates straight from the frame memory, returns NULL if it is exhausted.
+================
+*/
+static byte* R_FrameSharedAlloc( int bytes )
+{
+	// don't keep adding once we're out of memory, the counter would eventually wrap
+	if( frameData->frameMemoryAllocated.GetValue() > ( int )MAX_FRAME_MEMORY )
+	{
+		return NULL;
+	}
+	
+	// thread safe add
+	int	end = frameData->frameMemoryAllocated.Add( bytes );
+	if( end > ( int )MAX_FRAME_MEMORY )
+	{
+		return NULL;
+	}
+	return frameData->frameMemory + end - bytes;
+}
+
+/*
+================
+R_GetFrameAllocBlock
+
+Returns the allocation block of the calling thread, or NULL if all blocks are taken.
+================
+*/
+static frameAllocBlock_t* R_GetFrameAllocBlock()
+{
+	ptrdiff_t index = frameAllocBlockIndex;
+	if( index == 0 )
+	{
+		index = numFrameAllocBlocks.Increment();
+		if( index > ( ptrdiff_t )MAX_FRAME_ALLOC_THREADS )
+		{
+			index = -1;
+		}
+		frameAllocBlockIndex = index;
+	}
+	if( index < 0 )
+	{
+		return NULL;
+	}
+	return &frameAllocBlocks[index - 1];
+}
+
 /*
 ================
 R_FrameAlloc
@@ -149,6 +266,9 @@ back end shouldn't need to allocate memory.
 All temporary data, like dynamic tesselations
 and local spaces are allocated here.
 
+Small allocations come out of a block owned by the calling
+thread, so the front end jobs don't fight over a single counter.
+
 All memory is cache-line-cleared for the best performance.
 ================
 */
@@ -161,14 +281,33 @@ void* R_FrameAlloc( int bytes, frameAllocType_t type )
 	
 	bytes = ( bytes + FRAME_ALLOC_ALIGNMENT - 1 ) & ~( FRAME_ALLOC_ALIGNMENT - 1 );
 	
-	// thread safe add
-	int	end = frameData->frameMemoryAllocated.Add( bytes );
-	if( end > MAX_FRAME_MEMORY )
+	byte* ptr = NULL;
+	
+	frameAllocBlock_t* block = ( bytes <= ( int )FRAME_ALLOC_BLOCK_SIZE / 4 ) ? R_GetFrameAllocBlock() : NULL;
+	if( block != NULL )
+	{
+		if( block->frame != smpFrame || block->current + bytes > block->end )
+		{
+			// the rest of the old block is wasted
+			block->frame = smpFrame;
+			block->current = R_FrameSharedAlloc( FRAME_ALLOC_BLOCK_SIZE );
+			block->end = ( block->current != NULL ) ? block->current + FRAME_ALLOC_BLOCK_SIZE : NULL;
+		}
+		if( block->current != NULL )
+		{
+			ptr = block->current;
+			block->current += bytes;
+		}
+	}
+	else
 	{
-		idLib::Error( "R_FrameAlloc ran out of memory. bytes = %d, end = %d, highWaterAllocated = %d\n", bytes, end, frameData->highWaterAllocated );
+		ptr = R_FrameSharedAlloc( bytes );
 	}
 	
-	byte* ptr = frameData->frameMemory + end - bytes;
+	if( ptr == NULL )
+	{
+		return R_FrameOverflowAlloc( bytes );
+	}
 	
 	// cache line clear the memory
 	for( int offset = 0; offset < bytes; offset += CACHE_LINE_SIZE )
@@ -248,141 +387,327 @@ FONT-END RENDERING
 ==========================================================================================
 */
 
+idCVar r_useParallelSortDrawSurfs( "r_useParallelSortDrawSurfs", "1", CVAR_RENDERER | CVAR_BOOL, "sort the draw surfs with jobs if there are enough of them" );
+
+static const int SORT_KEY_PASSES				= sizeof( uint64 );
+static const int SORT_KEY_BUCKETS				= 256;
+static const int MAX_SORT_JOBS					= 16;
+static const int MIN_DRAW_SURFS_PER_SORT_JOB	= 2048;
+
+compile_time_assert( MAX_SORT_JOBS * ( SORT_KEY_PASSES * 2 + 1 ) <= FRONTEND_MAX_JOBS );
+compile_time_assert( SORT_KEY_PASSES * 3 - 1 <= FRONTEND_MAX_SYNCS );
+
+struct drawSurfSortKey_t
+{
+	uint64					key;
+	drawSurf_t* 			surf;
+};
+
+struct drawSurfSort_t
+{
+	drawSurf_t** 			drawSurfs;
+	int						numDrawSurfs;
+	int						numChunks;
+	drawSurfSortKey_t* 		keys[2];
+	int						readBuffer[SORT_KEY_PASSES + 1];	// set by the offset job of the previous pass
+	bool					skipPass[SORT_KEY_PASSES];
+	int						counts[MAX_SORT_JOBS][SORT_KEY_BUCKETS];	// counts and then offsets per chunk
+};
+
+struct drawSurfSortJob_t
+{
+	drawSurfSort_t* 		sort;
+	int						pass;
+	int						chunk;
+};
+
 /*
 =================
-R_SortDrawSurfs
+R_DrawSurfSortKey
 =================
 */
-static void R_SortDrawSurfs( drawSurf_t** drawSurfs, const int numDrawSurfs )
+static uint64 R_DrawSurfSortKey( const drawSurf_t* drawSurf )
+{
+	// flip the float bits so that they sort like the float values
+	uint32 sortBits = *( const uint32* )&drawSurf->sort;
+	sortBits = ( sortBits & 0x80000000 ) ? ~sortBits : ( sortBits | 0x80000000 );
+	
+	uint32 depth = 0;
+	if( drawSurf->frontEndGeo != NULL )
+	{
+		float min = 0.0f;
+		float max = 1.0f;
+		idRenderMatrix::DepthBoundsForBounds( min, max, drawSurf->space->mvp, drawSurf->frontEndGeo->bounds );
+		depth = idMath::Ftoui16( min * 0xFFFF );
+	}
+	
+	uint32 stateBits;
+	const idMaterial* material = drawSurf->material;
+	if( drawSurf->sort == SS_OPAQUE && material != NULL && material->Coverage() != MC_TRANSLUCENT )
+	{
+		// opaque surfaces are depth tested against the depth pre-pass, so they can be
+		// grouped to minimize the program, buffer and material changes in the back end
+		stateBits = ( drawSurf->jointCache != 0 ) ? ( 1u << 31 ) : 0;
+		stateBits |= vertexCache.CacheIsStatic( drawSurf->ambientCache ) ? 0 : ( 1u << 30 );
+		stateBits |= ( material->Index() & 0x3FFF ) << 16;
+		stateBits |= depth;
+	}
+	else
+	{
+		stateBits = ( 0xFFFF - depth ) << 16;
+	}
+	
+	return ( ( uint64 )sortBits << 32 ) | stateBits;
+}
+
+/*
+=================
+R_CountSortKeys
+=================
+*/
+static void R_CountSortKeys( const drawSurfSortKey_t* keys, const int numKeys, const int pass, int counts[SORT_KEY_BUCKETS] )
 {
-#if 1
+	const int shift = pass * 8;
+	for( int i = 0; i < numKeys; i++ )
+	{
+		counts[( keys[i].key >> shift ) & ( SORT_KEY_BUCKETS - 1 )]++;
+	}
+}
+
+/*
+=================
+R_ScatterSortKeys
+=================
+*/
+static void R_ScatterSortKeys( const drawSurfSortKey_t* keys, const int numKeys, const int pass, int offsets[SORT_KEY_BUCKETS], drawSurfSortKey_t* sorted )
+{
+	const int shift = pass * 8;
+	for( int i = 0; i < numKeys; i++ )
+	{
+		sorted[offsets[( keys[i].key >> shift ) & ( SORT_KEY_BUCKETS - 1 )]++] = keys[i];
+	}
+}
 
-	uint64* indices = ( uint64* ) _alloca16( numDrawSurfs * sizeof( indices[0] ) );
+/*
+=================
+R_SortChunk
+=================
+*/
+static void R_SortChunk( const drawSurfSort_t* sort, const int chunk, int& first, int& num )
+{
+	first = ( int )( ( int64 )sort->numDrawSurfs * chunk / sort->numChunks );
+	num = ( int )( ( int64 )sort->numDrawSurfs * ( chunk + 1 ) / sort->numChunks ) - first;
+}
+
+/*
+=================
+R_CountSortKeysJob
+=================
+*/
+static void R_CountSortKeysJob( drawSurfSortJob_t* job )
+{
+	drawSurfSort_t* sort = job->sort;
 	
-	// sort the draw surfs based on:
-	// 1. sort value (largest first)
-	// 2. depth (smallest first)
-	// 3. index (largest first)
-	assert( numDrawSurfs <= 0xFFFF );
-	for( int i = 0; i < numDrawSurfs; i++ )
+	int first, num;
+	R_SortChunk( sort, job->chunk, first, num );
+	
+	drawSurfSortKey_t* keys = sort->keys[sort->readBuffer[job->pass]] + first;
+	if( job->pass == 0 )
 	{
-		float sort = SS_POST_PROCESS - drawSurfs[i]->sort;
-		assert( sort >= 0.0f );
-		
-		uint64 dist = 0;
-		if( drawSurfs[i]->frontEndGeo != NULL )
+		for( int i = 0; i < num; i++ )
 		{
-			float min = 0.0f;
-			float max = 1.0f;
-			idRenderMatrix::DepthBoundsForBounds( min, max, drawSurfs[i]->space->mvp, drawSurfs[i]->frontEndGeo->bounds );
-			dist = idMath::Ftoui16( min * 0xFFFF );
+			keys[i].key = R_DrawSurfSortKey( sort->drawSurfs[first + i] );
+			keys[i].surf = sort->drawSurfs[first + i];
 		}
-		
-		indices[i] = ( ( numDrawSurfs - i ) & 0xFFFF ) | ( dist << 16 ) | ( ( uint64 )( *( uint32* )&sort ) << 32 );
 	}
 	
-	const int64 MAX_LEVELS = 128;
-	int64 lo[MAX_LEVELS];
-	int64 hi[MAX_LEVELS];
+	memset( sort->counts[job->chunk], 0, sizeof( sort->counts[0] ) );
+	R_CountSortKeys( keys, num, job->pass, sort->counts[job->chunk] );
+}
+
+/*
+=================
+R_SortKeyOffsetsJob
+=================
+*/
+static void R_SortKeyOffsetsJob( drawSurfSortJob_t* job )
+{
+	drawSurfSort_t* sort = job->sort;
 	
-	// Keep the top of the stack in registers to avoid load-hit-stores.
-	register int64 st_lo = 0;
-	register int64 st_hi = numDrawSurfs - 1;
-	register int64 level = 0;
+	// the chunks are scattered in order, so the sort is stable
+	int offset = 0;
+	for( int bucket = 0; bucket < SORT_KEY_BUCKETS; bucket++ )
+	{
+		int bucketCount = 0;
+		for( int chunk = 0; chunk < sort->numChunks; chunk++ )
+		{
+			const int count = sort->counts[chunk][bucket];
+			sort->counts[chunk][bucket] = offset;
+			offset += count;
+			bucketCount += count;
+		}
+		if( bucketCount == sort->numDrawSurfs )
+		{
+			// all the keys are in this bucket
+			sort->skipPass[job->pass] = true;
+		}
+	}
 	
-	for( ; ; )
+	const int readBuffer = sort->readBuffer[job->pass];
+	sort->readBuffer[job->pass + 1] = sort->skipPass[job->pass] ? readBuffer : ( readBuffer ^ 1 );
+}
+
+/*
+=================
+R_ScatterSortKeysJob
+=================
+*/
+static void R_ScatterSortKeysJob( drawSurfSortJob_t* job )
+{
+	drawSurfSort_t* sort = job->sort;
+	if( sort->skipPass[job->pass] )
 	{
-		register int64 i = st_lo;
-		register int64 j = st_hi;
-		if( j - i >= 4 && level < MAX_LEVELS - 1 )
+		return;
+	}
+	
+	int first, num;
+	R_SortChunk( sort, job->chunk, first, num );
+	
+	const int readBuffer = sort->readBuffer[job->pass];
+	R_ScatterSortKeys( sort->keys[readBuffer] + first, num, job->pass, sort->counts[job->chunk], sort->keys[readBuffer ^ 1] );
+}
+
+REGISTER_PARALLEL_JOB( R_CountSortKeysJob, "R_CountSortKeysJob" );
+REGISTER_PARALLEL_JOB( R_SortKeyOffsetsJob, "R_SortKeyOffsetsJob" );
+REGISTER_PARALLEL_JOB( R_ScatterSortKeysJob, "R_ScatterSortKeysJob" );
+
+/*
+=================
+R_SortDrawSurfs
+
+The draw surfs are sorted on a 64 bit key with a stable LSD radix sort:
+1. sort value (smallest first)
+2. for opaque surfaces, the GL state: skinning, vertex buffer and material,
+   followed by the depth (nearest first)
+3. for all other surfaces, the depth (farthest first) so blending stays correct
+4. the order in which the surfaces were added
+
+The radix sort uses one byte of the key per pass. Passes in which all the
+keys have the same byte are skipped. With enough surfaces each pass is split
+over jobs: a count job per chunk, a job that turns the counts into offsets,
+and a scatter job per chunk, separated by sync points.
+=================
+*/
+static void R_SortDrawSurfs( drawSurf_t** drawSurfs, const int numDrawSurfs )
+{
+	if( numDrawSurfs <= 1 )
+	{
+		return;
+	}
+	
+	drawSurfSortKey_t* keys[2];
+	keys[0] = ( drawSurfSortKey_t* )R_FrameAlloc( numDrawSurfs * sizeof( drawSurfSortKey_t ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	keys[1] = ( drawSurfSortKey_t* )R_FrameAlloc( numDrawSurfs * sizeof( drawSurfSortKey_t ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	
+	int numChunks = 0;
+	if( r_useParallelSortDrawSurfs.GetBool() )
+	{
+		numChunks = Min( numDrawSurfs / MIN_DRAW_SURFS_PER_SORT_JOB, Min( parallelJobManager->GetNumProcessingUnits(), MAX_SORT_JOBS ) );
+	}
+	
+	int sortedBuffer = 0;
+	if( numChunks > 1 )
+	{
+		// only used from the main thread, and each sort finishes before any subviews are rendered
+		static drawSurfSort_t sort;
+		sort.drawSurfs = drawSurfs;
+		sort.numDrawSurfs = numDrawSurfs;
+		sort.numChunks = numChunks;
+		sort.keys[0] = keys[0];
+		sort.keys[1] = keys[1];
+		sort.readBuffer[0] = 0;
+		memset( sort.skipPass, 0, sizeof( sort.skipPass ) );
+		
+		drawSurfSortJob_t jobs[SORT_KEY_PASSES][MAX_SORT_JOBS];
+		for( int pass = 0; pass < SORT_KEY_PASSES; pass++ )
 		{
-			register uint64 pivot = indices[( i + j ) / 2];
-			do
+			for( int chunk = 0; chunk < numChunks; chunk++ )
 			{
-				while( indices[i] > pivot ) i++;
-				while( indices[j] < pivot ) j--;
-				if( i > j ) break;
-				uint64 h = indices[i];
-				indices[i] = indices[j];
-				indices[j] = h;
+				jobs[pass][chunk].sort = &sort;
+				jobs[pass][chunk].pass = pass;
+				jobs[pass][chunk].chunk = chunk;
 			}
-			while( ++i <= --j );
-			
-			// No need for these iterations because we are always sorting unique values.
-			//while ( indices[j] == pivot && st_lo < j ) j--;
-			//while ( indices[i] == pivot && i < st_hi ) i++;
-			
-			assert( level < MAX_LEVELS - 1 );
-			lo[level] = i;
-			hi[level] = st_hi;
-			st_hi = j;
-			level++;
 		}
-		else
+		
+		idParallelJobList* jobList = tr.frontEndJobList;
+		for( int pass = 0; pass < SORT_KEY_PASSES; pass++ )
 		{
-			for( ; i < j; j-- )
+			if( pass > 0 )
 			{
-				register int64 m = i;
-				for( int64 k = i + 1; k <= j; k++ )
-				{
-					if( indices[k] < indices[m] )
-					{
-						m = k;
-					}
-				}
-				uint64 h = indices[m];
-				indices[m] = indices[j];
-				indices[j] = h;
+				jobList->InsertSyncPoint( SYNC_SIGNAL );
+				jobList->InsertSyncPoint( SYNC_SYNCHRONIZE );
 			}
-			if( --level < 0 )
+			for( int chunk = 0; chunk < numChunks; chunk++ )
 			{
-				break;
+				jobList->AddJob( ( jobRun_t )R_CountSortKeysJob, &jobs[pass][chunk] );
+			}
+			jobList->InsertSyncPoint( SYNC_SIGNAL );
+			jobList->InsertSyncPoint( SYNC_SYNCHRONIZE );
+			jobList->AddJob( ( jobRun_t )R_SortKeyOffsetsJob, &jobs[pass][0] );
+			jobList->InsertSyncPoint( SYNC_SIGNAL );
+			jobList->InsertSyncPoint( SYNC_SYNCHRONIZE );
+			for( int chunk = 0; chunk < numChunks; chunk++ )
+			{
+				jobList->AddJob( ( jobRun_t )R_ScatterSortKeysJob, &jobs[pass][chunk] );
 			}
-			st_lo = lo[level];
-			st_hi = hi[level];
 		}
+		jobList->Submit();
+		jobList->Wait();
+		
+		sortedBuffer = sort.readBuffer[SORT_KEY_PASSES];
 	}
-	
-	drawSurf_t** newDrawSurfs = ( drawSurf_t** ) indices;
-	for( int i = 0; i < numDrawSurfs; i++ )
-	{
-		newDrawSurfs[i] = drawSurfs[numDrawSurfs - ( indices[i] & 0xFFFF )];
-	}
-	memcpy( drawSurfs, newDrawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
-	
-#else
-	
-	struct local_t
+	else
 	{
-		static int R_QsortSurfaces( const void* a, const void* b )
+		for( int i = 0; i < numDrawSurfs; i++ )
+		{
+			keys[0][i].key = R_DrawSurfSortKey( drawSurfs[i] );
+			keys[0][i].surf = drawSurfs[i];
+		}
+		
+		int counts[SORT_KEY_PASSES][SORT_KEY_BUCKETS];
+		memset( counts, 0, sizeof( counts ) );
+		for( int i = 0; i < numDrawSurfs; i++ )
 		{
-			const drawSurf_t* ea = *( drawSurf_t** )a;
-			const drawSurf_t* eb = *( drawSurf_t** )b;
-			if( ea->sort < eb->sort )
+			const uint64 key = keys[0][i].key;
+			for( int pass = 0; pass < SORT_KEY_PASSES; pass++ )
 			{
-				return -1;
+				counts[pass][( key >> ( pass * 8 ) ) & ( SORT_KEY_BUCKETS - 1 )]++;
 			}
-			if( ea->sort > eb->sort )
+		}
+		
+		for( int pass = 0; pass < SORT_KEY_PASSES; pass++ )
+		{
+			const int bucket = ( keys[sortedBuffer][0].key >> ( pass * 8 ) ) & ( SORT_KEY_BUCKETS - 1 );
+			if( counts[pass][bucket] == numDrawSurfs )
 			{
-				return 1;
+				continue;
 			}
-			return 0;
+			int offset = 0;
+			for( int i = 0; i < SORT_KEY_BUCKETS; i++ )
+			{
+				const int count = counts[pass][i];
+				counts[pass][i] = offset;
+				offset += count;
+			}
+			R_ScatterSortKeys( keys[sortedBuffer], numDrawSurfs, pass, counts[pass], keys[sortedBuffer ^ 1] );
+			sortedBuffer ^= 1;
 		}
-	};
+	}
 	
-	// Add a sort offset so surfaces with equal sort orders still deterministically
-	// draw in the order they were added, at least within a given model.
-	float sorfOffset = 0.0f;
 	for( int i = 0; i < numDrawSurfs; i++ )
 	{
-		drawSurf[i]->sort += sorfOffset;
-		sorfOffset += 0.000001f;
+		drawSurfs[i] = keys[sortedBuffer][i].surf;
 	}
-	
-	// sort the drawsurfs
-	qsort( drawSurfs, numDrawSurfs, sizeof( drawSurfs[0] ), local_t::R_QsortSurfaces );
-	
-#endif
 }
 
 // RB begin
@@ -505,10 +830,16 @@ void R_RenderView( viewDef_t* parms )
 	// wait for any shadow volume jobs from the previous frame to finish
 	tr.frontEndJobList->Wait();
 	
+	// cull the entities and lights that are hidden behind the world geometry
+	R_OcclusionCull();
+	
 	// make sure that interactions exist for all light / entity combinations that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
 	R_AddLights();
 	
+	// put the lights without shadows in the cluster grid so their opaque interactions are drawn in a single pass
+	R_AssignClusteredLights();
+	
 	// adds ambient surfaces and create any necessary interaction surfaces to add to the light lists
 	R_AddModels();
 	
@@ -0,0 +1,521 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+idCVar r_useOcclusionCulling( "r_useOcclusionCulling", "1", CVAR_RENDERER | CVAR_BOOL, "cull entities and lights hidden behind the world geometry with a software depth buffer" );
+idCVar r_showOcclusionCulling( "r_showOcclusionCulling", "0", CVAR_RENDERER | CVAR_BOOL, "print the number of occluder triangles and occluded entities and lights" );
+
+/*
+==========================================================================================
+
+SOFTWARE OCCLUSION CULLING
+
+The opaque surfaces of the world areas, and static models with an "occluder" material,
+are rasterized into a coarse depth buffer. The depth buffer is reduced to a pyramid where
+each texel holds the farthest depth of the texels below it. The bounds of each view entity
+and light volume are projected to the screen and tested against the pyramid level where
+they cover only a few texels.
+
+The depth buffer is sampled at the texel centers, so an occluder edge that passes through
+a texel may leave part of it uncovered. The occludee rectangle is expanded by a texel to
+include the neighbours of such a texel. The depth that is stored is the farthest depth of
+the occluder plane over the whole texel.
+
+This runs on the main thread, after the portal flow and before any models are instantiated
+or any shadow volume jobs are started.
+
+==========================================================================================
+*/
+
+static const int OCCLUSION_WIDTH		= 256;
+static const int OCCLUSION_HEIGHT		= 128;
+static const int OCCLUSION_LEVELS		= 8;		// 256x128 down to 2x1
+
+compile_time_assert( ( OCCLUSION_WIDTH & 3 ) == 0 );
+compile_time_assert( ( OCCLUSION_WIDTH >> ( OCCLUSION_LEVELS - 1 ) ) >= 1 && ( OCCLUSION_HEIGHT >> ( OCCLUSION_LEVELS - 1 ) ) >= 1 );
+
+// all levels of the pyramid, level 0 is the depth buffer that the occluders are rasterized into
+static ALIGNTYPE16 float	occlusionDepth[OCCLUSION_WIDTH * OCCLUSION_HEIGHT * 2];
+static float* 				occlusionLevels[OCCLUSION_LEVELS];
+static idList< idVec4, TAG_RENDER >	occluderClipVerts;
+
+/*
+=================
+R_ClearOcclusionBuffer
+=================
+*/
+static void R_ClearOcclusionBuffer()
+{
+	float* level = occlusionDepth;
+	for( int i = 0; i < OCCLUSION_LEVELS; i++ )
+	{
+		occlusionLevels[i] = level;
+		level += ( OCCLUSION_WIDTH >> i ) * ( OCCLUSION_HEIGHT >> i );
+	}
+	assert( level <= occlusionDepth + sizeof( occlusionDepth ) / sizeof( occlusionDepth[0] ) );
+	
+	for( int i = 0; i < OCCLUSION_WIDTH * OCCLUSION_HEIGHT; i++ )
+	{
+		occlusionDepth[i] = 1.0f;
+	}
+}
+
+/*
+=================
+R_BuildOcclusionPyramid
+=================
+*/
+static void R_BuildOcclusionPyramid()
+{
+	for( int i = 1; i < OCCLUSION_LEVELS; i++ )
+	{
+		const int width = OCCLUSION_WIDTH >> i;
+		const int height = OCCLUSION_HEIGHT >> i;
+		const float* src = occlusionLevels[i - 1];
+		float* dst = occlusionLevels[i];
+		for( int y = 0; y < height; y++ )
+		{
+			const float* src0 = src + ( y * 2 + 0 ) * width * 2;
+			const float* src1 = src + ( y * 2 + 1 ) * width * 2;
+			for( int x = 0; x < width; x++ )
+			{
+				dst[y * width + x] = Max( Max( src0[x * 2 + 0], src0[x * 2 + 1] ), Max( src1[x * 2 + 0], src1[x * 2 + 1] ) );
+			}
+		}
+	}
+}
+
+/*
+=================
+R_RasterizeOccluderTriangle
+
+The vertices are in occlusion buffer pixels, with the window depth in z.
+Only the pixels with their center inside the triangle are written.
+=================
+*/
+static void R_RasterizeOccluderTriangle( const idVec3& v0, const idVec3& v1, const idVec3& v2 )
+{
+	float area = ( v1.x - v0.x ) * ( v2.y - v0.y ) - ( v2.x - v0.x ) * ( v1.y - v0.y );
+	if( idMath::Fabs( area ) < 1e-6f )
+	{
+		return;
+	}
+	
+	// bounds in pixels with a center inside the triangle bounds
+	const float minX = Min( v0.x, Min( v1.x, v2.x ) );
+	const float maxX = Max( v0.x, Max( v1.x, v2.x ) );
+	const float minY = Min( v0.y, Min( v1.y, v2.y ) );
+	const float maxY = Max( v0.y, Max( v1.y, v2.y ) );
+	const int x1 = Max( idMath::Ftoi( idMath::Ceil( minX - 0.5f ) ), 0 );
+	const int x2 = Min( idMath::Ftoi( idMath::Floor( maxX - 0.5f ) ), OCCLUSION_WIDTH - 1 );
+	const int y1 = Max( idMath::Ftoi( idMath::Ceil( minY - 0.5f ) ), 0 );
+	const int y2 = Min( idMath::Ftoi( idMath::Floor( maxY - 0.5f ) ), OCCLUSION_HEIGHT - 1 );
+	if( x1 > x2 || y1 > y2 )
+	{
+		return;
+	}
+	
+	// edge functions that are positive inside the triangle
+	const float orient = ( area > 0.0f ) ? 1.0f : -1.0f;
+	const idVec3* verts[3] = { &v0, &v1, &v2 };
+	float edgeA[3], edgeB[3], edgeC[3];
+	for( int i = 0; i < 3; i++ )
+	{
+		const idVec3& a = *verts[i];
+		const idVec3& b = *verts[( i + 1 ) % 3];
+		edgeA[i] = ( a.y - b.y ) * orient;
+		edgeB[i] = ( b.x - a.x ) * orient;
+		edgeC[i] = -( edgeA[i] * a.x + edgeB[i] * a.y );
+	}
+	
+	// the depth plane, offset to the farthest depth over a pixel
+	const float invArea = 1.0f / area;
+	const float dzdx = ( ( v1.z - v0.z ) * ( v2.y - v0.y ) - ( v2.z - v0.z ) * ( v1.y - v0.y ) ) * invArea;
+	const float dzdy = ( ( v2.z - v0.z ) * ( v1.x - v0.x ) - ( v1.z - v0.z ) * ( v2.x - v0.x ) ) * invArea;
+	const float dz0 = v0.z - dzdx * v0.x - dzdy * v0.y + 0.5f * ( idMath::Fabs( dzdx ) + idMath::Fabs( dzdy ) );
+	const float maxZ = Max( v0.z, Max( v1.z, v2.z ) );
+	
+	float* depth = occlusionLevels[0];
+	
+#if defined(USE_INTRINSICS)
+	const int alignedX1 = x1 & ~3;
+	
+	const __m128 vector_step = _mm_setr_ps( 0.5f, 1.5f, 2.5f, 3.5f );
+	const __m128 vector_zero = _mm_setzero_ps();
+	const __m128 vector_four = _mm_set1_ps( 4.0f );
+	const __m128 vector_maxZ = _mm_set1_ps( maxZ );
+	
+	const __m128 vector_a0 = _mm_set1_ps( edgeA[0] );
+	const __m128 vector_a1 = _mm_set1_ps( edgeA[1] );
+	const __m128 vector_a2 = _mm_set1_ps( edgeA[2] );
+	const __m128 vector_dzdx = _mm_set1_ps( dzdx );
+	
+	const __m128 vector_a0Step = _mm_mul_ps( vector_a0, vector_four );
+	const __m128 vector_a1Step = _mm_mul_ps( vector_a1, vector_four );
+	const __m128 vector_a2Step = _mm_mul_ps( vector_a2, vector_four );
+	const __m128 vector_dzStep = _mm_mul_ps( vector_dzdx, vector_four );
+	
+	const __m128 vector_x = _mm_add_ps( _mm_set1_ps( ( float )alignedX1 ), vector_step );
+	
+	for( int y = y1; y <= y2; y++ )
+	{
+		const float py = y + 0.5f;
+		
+		__m128 e0 = _mm_add_ps( _mm_mul_ps( vector_a0, vector_x ), _mm_set1_ps( edgeB[0] * py + edgeC[0] ) );
+		__m128 e1 = _mm_add_ps( _mm_mul_ps( vector_a1, vector_x ), _mm_set1_ps( edgeB[1] * py + edgeC[1] ) );
+		__m128 e2 = _mm_add_ps( _mm_mul_ps( vector_a2, vector_x ), _mm_set1_ps( edgeB[2] * py + edgeC[2] ) );
+		__m128 z = _mm_add_ps( _mm_mul_ps( vector_dzdx, vector_x ), _mm_set1_ps( dzdy * py + dz0 ) );
+		
+		float* row = depth + y * OCCLUSION_WIDTH;
+		for( int x = alignedX1; x <= x2; x += 4 )
+		{
+			__m128 inside = _mm_and_ps( _mm_cmpge_ps( e0, vector_zero ), _mm_and_ps( _mm_cmpge_ps( e1, vector_zero ), _mm_cmpge_ps( e2, vector_zero ) ) );
+			if( _mm_movemask_ps( inside ) != 0 )
+			{
+				__m128 d = _mm_load_ps( row + x );
+				__m128 nd = _mm_min_ps( d, _mm_min_ps( z, vector_maxZ ) );
+				_mm_store_ps( row + x, _mm_or_ps( _mm_and_ps( inside, nd ), _mm_andnot_ps( inside, d ) ) );
+			}
+			e0 = _mm_add_ps( e0, vector_a0Step );
+			e1 = _mm_add_ps( e1, vector_a1Step );
+			e2 = _mm_add_ps( e2, vector_a2Step );
+			z = _mm_add_ps( z, vector_dzStep );
+		}
+	}
+	
+#else
+	
+	for( int y = y1; y <= y2; y++ )
+	{
+		const float py = y + 0.5f;
+		float* row = depth + y * OCCLUSION_WIDTH;
+		for( int x = x1; x <= x2; x++ )
+		{
+			const float px = x + 0.5f;
+			if( edgeA[0] * px + edgeB[0] * py + edgeC[0] < 0.0f ||
+					edgeA[1] * px + edgeB[1] * py + edgeC[1] < 0.0f ||
+					edgeA[2] * px + edgeB[2] * py + edgeC[2] < 0.0f )
+			{
+				continue;
+			}
+			const float z = Min( dzdx * px + dzdy * py + dz0, maxZ );
+			row[x] = Min( row[x], z );
+		}
+	}
+	
+#endif
+}
+
+/*
+=================
+R_ClipToOcclusionBuffer
+=================
+*/
+static ID_INLINE void R_ClipToOcclusionBuffer( const idVec4& clip, idVec3& out )
+{
+	const float invW = 1.0f / clip.w;
+	out.x = ( clip.x * invW * 0.5f + 0.5f ) * OCCLUSION_WIDTH;
+	out.y = ( clip.y * invW * 0.5f + 0.5f ) * OCCLUSION_HEIGHT;
+#if defined( CLIP_SPACE_D3D )	// the D3D clip space Z is already in the range [0,1]
+	out.z = clip.z * invW;
+#else
+	out.z = clip.z * invW * 0.5f + 0.5f;
+#endif
+}
+
+/*
+=================
+R_NearClipDistance
+=================
+*/
+static ID_INLINE float R_NearClipDistance( const idVec4& clip )
+{
+#if defined( CLIP_SPACE_D3D )
+	return clip.z;
+#else
+	return clip.z + clip.w;
+#endif
+}
+
+/*
+=================
+R_RasterizeOccluderSurface
+=================
+*/
+static int R_RasterizeOccluderSurface( const srfTriangles_t* tri, const idRenderMatrix& mvp, const cullType_t cullType )
+{
+	occluderClipVerts.AssureSize( tri->numVerts );
+	idVec4* clipVerts = occluderClipVerts.Ptr();
+	for( int i = 0; i < tri->numVerts; i++ )
+	{
+		mvp.TransformPoint( tri->verts[i].xyz, clipVerts[i] );
+	}
+	
+	int numTris = 0;
+	for( int i = 0; i + 2 < tri->numIndexes; i += 3 )
+	{
+		const idVec4* triVerts[3] = { &clipVerts[tri->indexes[i + 0]], &clipVerts[tri->indexes[i + 1]], &clipVerts[tri->indexes[i + 2]] };
+		
+		// clip the triangle to the near plane
+		idVec4 poly[4];
+		int numPoints = 0;
+		for( int j = 0; j < 3; j++ )
+		{
+			const idVec4& a = *triVerts[j];
+			const idVec4& b = *triVerts[( j + 1 ) % 3];
+			const float da = R_NearClipDistance( a );
+			const float db = R_NearClipDistance( b );
+			if( da >= 0.0f )
+			{
+				poly[numPoints++] = a;
+			}
+			if( ( da >= 0.0f ) != ( db >= 0.0f ) )
+			{
+				poly[numPoints++] = a + ( b - a ) * ( da / ( da - db ) );
+			}
+		}
+		if( numPoints < 3 )
+		{
+			continue;
+		}
+		
+		idVec3 screen[4];
+		for( int j = 0; j < numPoints; j++ )
+		{
+			R_ClipToOcclusionBuffer( poly[j], screen[j] );
+		}
+		
+		// only rasterize the triangles the back end doesn't cull, the front faces are
+		// clockwise in window space
+		if( cullType != CT_TWO_SIDED )
+		{
+			const float area = ( screen[1].x - screen[0].x ) * ( screen[2].y - screen[0].y ) - ( screen[2].x - screen[0].x ) * ( screen[1].y - screen[0].y );
+			if( ( cullType == CT_FRONT_SIDED ) ? ( area >= 0.0f ) : ( area <= 0.0f ) )
+			{
+				continue;
+			}
+		}
+		
+		for( int j = 2; j < numPoints; j++ )
+		{
+			R_RasterizeOccluderTriangle( screen[0], screen[j - 1], screen[j] );
+		}
+		numTris++;
+	}
+	return numTris;
+}
+
+/*
+=================
+R_AddEntityOccluders
+=================
+*/
+static int R_AddEntityOccluders( const viewDef_t* viewDef, const idRenderEntityLocal* entityDef )
+{
+	const renderEntity_t& parms = entityDef->parms;
+	const idRenderModel* model = parms.hModel;
+	if( model == NULL || parms.weaponDepthHack || parms.modelDepthHack != 0.0f || parms.xrayIndex == 2 || parms.callback != NULL )
+	{
+		return 0;
+	}
+	
+	const bool worldModel = model->IsStaticWorldModel();
+	if( !worldModel && model->IsDynamicModel() != DM_STATIC )
+	{
+		return 0;
+	}
+	
+	idRenderMatrix mvp;
+	idRenderMatrix::Multiply( viewDef->worldSpace.mvp, entityDef->modelRenderMatrix, mvp );
+	
+	int numTris = 0;
+	for( int i = 0; i < model->NumSurfaces(); i++ )
+	{
+		const modelSurface_t* surf = model->Surface( i );
+		const srfTriangles_t* tri = surf->geometry;
+		if( tri == NULL || tri->verts == NULL || tri->indexes == NULL )
+		{
+			continue;
+		}
+		
+		const idMaterial* shader = R_RemapShaderBySkin( surf->shader, parms.customSkin, parms.customShader );
+		if( shader == NULL || !shader->IsOccluder( worldModel ) )
+		{
+			continue;
+		}
+		
+		// skip surfaces that are outside the view or too small to cover a texel
+		idBounds projected;
+		idRenderMatrix::ProjectedNearClippedBounds( projected, mvp, tri->bounds );
+		if( projected[0][2] >= projected[1][2] ||
+				( projected[1][0] - projected[0][0] ) * OCCLUSION_WIDTH < 1.0f ||
+				( projected[1][1] - projected[0][1] ) * OCCLUSION_HEIGHT < 1.0f )
+		{
+			continue;
+		}
+		
+		numTris += R_RasterizeOccluderSurface( tri, mvp, shader->GetCullType() );
+	}
+	return numTris;
+}
+
+/*
+=================
+R_BoundsAreOccluded
+=================
+*/
+static bool R_BoundsAreOccluded( const idRenderMatrix& mvp, const idBounds& bounds )
+{
+	idBounds projected;
+	idRenderMatrix::ProjectedNearClippedBounds( projected, mvp, bounds );
+	
+	// bounds that cross the near plane or are outside the view are left to the other tests
+	if( projected[0][2] <= 0.0f || projected[0][2] >= projected[1][2] )
+	{
+		return false;
+	}
+	
+	// expand by a texel to cover the partially covered texels at occluder edges
+	int x1 = Max( idMath::Ftoi( projected[0][0] * OCCLUSION_WIDTH ) - 1, 0 );
+	int x2 = Min( idMath::Ftoi( projected[1][0] * OCCLUSION_WIDTH ) + 1, OCCLUSION_WIDTH - 1 );
+	int y1 = Max( idMath::Ftoi( projected[0][1] * OCCLUSION_HEIGHT ) - 1, 0 );
+	int y2 = Min( idMath::Ftoi( projected[1][1] * OCCLUSION_HEIGHT ) + 1, OCCLUSION_HEIGHT - 1 );
+	
+	// find the level where the bounds cover at most 4x4 texels
+	int level = 0;
+	while( level < OCCLUSION_LEVELS - 1 && ( x2 - x1 > 3 || y2 - y1 > 3 ) )
+	{
+		x1 >>= 1;
+		x2 >>= 1;
+		y1 >>= 1;
+		y2 >>= 1;
+		level++;
+	}
+	
+	const int width = OCCLUSION_WIDTH >> level;
+	const float* depth = occlusionLevels[level];
+	const float nearestZ = projected[0][2];
+	for( int y = y1; y <= y2; y++ )
+	{
+		for( int x = x1; x <= x2; x++ )
+		{
+			if( nearestZ <= depth[y * width + x] )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+=================
+R_OcclusionCull
+
+Clears the scissor rect of the view entities that are hidden behind the occluders,
+so they are only considered for shadows, and removes the hidden lights from the view.
+=================
+*/
+void R_OcclusionCull()
+{
+	viewDef_t* viewDef = tr.viewDef;
+	if( !r_useOcclusionCulling.GetBool() || viewDef->isSubview || viewDef->renderWorld == NULL || viewDef->areaNum < 0 )
+	{
+		return;
+	}
+	
+	SCOPED_PROFILE_EVENT( "R_OcclusionCull" );
+	
+	R_ClearOcclusionBuffer();
+	
+	int numOccluderTris = 0;
+	for( viewEntity_t* vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		if( !vEntity->scissorRect.IsEmpty() )
+		{
+			numOccluderTris += R_AddEntityOccluders( viewDef, vEntity->entityDef );
+		}
+	}
+	if( numOccluderTris == 0 )
+	{
+		return;
+	}
+	
+	R_BuildOcclusionPyramid();
+	
+	int numEntities = 0;
+	int numOccludedEntities = 0;
+	for( viewEntity_t* vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		const idRenderEntityLocal* entityDef = vEntity->entityDef;
+		if( vEntity->scissorRect.IsEmpty() || entityDef->parms.weaponDepthHack || entityDef->parms.modelDepthHack != 0.0f )
+		{
+			continue;
+		}
+		numEntities++;
+		
+		idRenderMatrix mvp;
+		idRenderMatrix::Multiply( viewDef->worldSpace.mvp, entityDef->modelRenderMatrix, mvp );
+		if( R_BoundsAreOccluded( mvp, entityDef->localReferenceBounds ) )
+		{
+			// it may still cast a shadow into the view
+			vEntity->scissorRect.Clear();
+			numOccludedEntities++;
+		}
+	}
+	
+	int numLights = 0;
+	int numOccludedLights = 0;
+	viewLight_t** ptr = &viewDef->viewLights;
+	while( *ptr != NULL )
+	{
+		viewLight_t* vLight = *ptr;
+		numLights++;
+		
+		// nothing that the light touches can be seen if the whole light volume is hidden
+		idRenderMatrix invProjectMVPMatrix;
+		idRenderMatrix::Multiply( viewDef->worldSpace.mvp, vLight->lightDef->inverseBaseLightProject, invProjectMVPMatrix );
+		if( R_BoundsAreOccluded( invProjectMVPMatrix, bounds_zeroOneCube ) )
+		{
+			vLight->lightDef->viewCount = -1;
+			*ptr = vLight->next;
+			numOccludedLights++;
+			continue;
+		}
+		ptr = &vLight->next;
+	}
+	
+	if( r_showOcclusionCulling.GetBool() )
+	{
+		common->Printf( "occlusion: %i occluder tris, %i/%i entities, %i/%i lights occluded\n", numOccluderTris, numOccludedEntities, numEntities, numOccludedLights, numLights );
+	}
+}
@@ -135,6 +135,7 @@ struct areaReference_t
 	idRenderEntityLocal* 	entity;					// only one of entity / light will be non-NULL
 	idRenderLightLocal* 	light;					// only one of entity / light will be non-NULL
 	struct portalArea_s*		area;					// so owners can find all the areas they are in
+	int						boundsIndex;			// index in the packed bounds of the area
 };
 
 
@@ -220,6 +221,13 @@ public:
 	idInteraction* 			firstInteraction;		// doubly linked list
 	idInteraction* 			lastInteraction;
 	
+	// entities in the light's areas that passed the view independent interaction checks,
+	// rebuilt by R_AddSingleLight when an entity is linked into or out of one of the
+	// areas or a door changes the area connectivity
+	idList<idRenderEntityLocal*, TAG_RENDER>	interactionCandidates;
+	int						candidatesAreaGeneration;	// -1 = needs to be rebuilt
+	int						candidatesConnectedAreaNum;
+	
 	struct doublePortal_s* 	foggedPortals;
 };
 
@@ -311,6 +319,10 @@ struct viewLight_t
 	// R_AddSingleLight() determined that the light isn't actually needed
 	bool					removeFromList;
 	
+	// R_AssignClusteredLights() put the light in the cluster grid, the opaque
+	// surfaces are lit in a single pass and only translucent interactions are added
+	bool					clusteredLight;
+	
 	// R_AddSingleLight builds this list of entities that need to be added
 	// to the viewEntities list because they potentially cast shadows into
 	// the view, even though the aren't directly visible
@@ -349,6 +361,40 @@ struct viewLight_t
 	preLightShadowVolumeParms_t* 	preLightShadowVolumes;
 };
 
+// lights without shadows can be assigned to a grid of view space clusters and drawn
+// in a single interaction pass, see tr_frontend_clusteredlights.cpp
+const int CLUSTER_TILES_X				= 16;
+const int CLUSTER_TILES_Y				= 8;
+const int CLUSTER_SLICES				= 16;		// exponential depth slices
+const int CLUSTER_COUNT					= CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES;
+const int CLUSTERED_LIGHT_VECTORS		= 6;		// projection S/T/Q, falloff S, origin, color
+const int MAX_CLUSTERED_LIGHTS			= 1024;
+const int CLUSTER_GRID_WIDTH			= 512;
+const int CLUSTER_GRID_HEIGHT			= 64;
+const int MAX_CLUSTER_LIGHT_INDEXES		= ( CLUSTER_GRID_WIDTH * CLUSTER_GRID_HEIGHT - CLUSTER_COUNT ) * 4;
+
+// the cluster grid is allocated on the frame temporary stack memory and
+// uploaded to the clusteredLightsImage and clusterGridImage by the back end
+struct clusteredLights_t
+{
+	int						numLights;
+	idVec4* 				lightVectors;		// [numLights * CLUSTERED_LIGHT_VECTORS]
+	
+	// CLUSTER_COUNT first index / number of indexes pairs, followed by
+	// the light indexes packed four to a vector, padded to whole rows
+	int						numGridVectors;
+	idVec4* 				gridVectors;
+	
+	idScreenRect			scissorRect;		// union of the scissor rects of the lights
+	float					tileScale[2];		// tiles per pixel
+	float					sliceScale;			// slice = log( depth ) * sliceScale + sliceBias
+	float					sliceBias;
+	
+	// all lights in the grid share a single falloff and projection image
+	idImage* 				falloffImage;
+	idImage* 				projectionImage;
+};
+
 // a viewEntity is created whenever a idRenderEntityLocal is considered for inclusion
 // in the current view, but it may still turn out to be culled.
 // viewEntity are allocated on the frame temporary stack memory
@@ -376,6 +422,11 @@ struct viewEntity_t
 	bool					weaponDepthHack;
 	float					modelDepthHack;
 	
+	// R_AddSingleModel found a clustered light that touches the entity but doesn't interact
+	// with it, or r_useClusteredLights 2 compares the entity, so the opaque surfaces get the
+	// regular interactions of the clustered lights
+	bool					skipClusteredLights;
+	
 	float					modelMatrix[16];		// local coords to global coords
 	float					modelViewMatrix[16];	// local coords to eye coords
 	
@@ -496,6 +547,8 @@ struct viewDef_t
 	// crossing a closed door.  This is used to avoid drawing interactions
 	// when the light is behind a closed door.
 	bool* 				connectedAreas;
+	
+	clusteredLights_t* 	clusteredLights;		// NULL if no lights were assigned to the cluster grid
 };
 
 
@@ -604,6 +657,13 @@ enum frameAllocType_t
 	FRAME_ALLOC_MAX
 };
 
+// frame allocations that didn't fit in the frame memory
+// are chained on the frame and freed when it is reused
+struct frameOverflowBlock_t
+{
+	frameOverflowBlock_t* 	next;
+};
+
 // all of the information needed by the back end must be
 // contained in a idFrameData.  This entire structure is
 // duplicated so the front and back end can run in parallel
@@ -615,6 +675,11 @@ public:
 	idSysInterlockedInteger	frameMemoryUsed;
 	byte* 					frameMemory;
 	
+	idSysInterlockedInteger	frameMemoryOverflow;	// bytes allocated from the heap because the frame memory was full
+	frameOverflowBlock_t* 	overflowBlocks;
+	idSysMutex				overflowMutex;
+	
+	int						lastFrameAllocated;	// used by the frame before this one
 	int						highWaterAllocated;	// max used on any frame
 	int						highWaterUsed;
 	
@@ -774,6 +839,9 @@ const int MAX_GUI_SURFACES	= 1024;		// default size of the drawSurfs list for gu
 
 static const int MAX_RENDER_CROPS = 8;
 
+static const int FRONTEND_MAX_JOBS	= 2048;
+static const int FRONTEND_MAX_SYNCS	= 32;		// the draw surf sort synchronizes between its passes
+
 /*
 ** Most renderer globals are defined here.
 ** backend functions should never modify any of these fields,
@@ -808,6 +876,7 @@ public:
 	virtual void			EndLevelLoad();
 	virtual void			LoadLevelImages();
 	virtual void			Preload( const idPreloadManifest& manifest, const char* mapName );
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats );
 	virtual void			BeginAutomaticBackgroundSwaps( autoRenderIconType_t icon = AUTORENDER_DEFAULTICON );
 	virtual void			EndAutomaticBackgroundSwaps();
 	virtual bool			AreAutomaticBackgroundSwapsRunning( autoRenderIconType_t* usingAlternateIcon = NULL ) const;
@@ -851,7 +920,7 @@ public:
 	// internal functions
 	idRenderSystemLocal();
 	~idRenderSystemLocal();
-
+	
 	void					UpdateStereo3DMode();
 	
 	void					Clear();
@@ -975,6 +1044,7 @@ extern idCVar r_useLightPortalCulling;		// 0 = none, 1 = box, 2 = exact clip of
 extern idCVar r_useLightAreaCulling;		// 0 = off, 1 = on
 extern idCVar r_useLightScissors;			// 1 = use custom scissor rectangle for each light
 extern idCVar r_useEntityPortalCulling;		// 0 = none, 1 = box
+extern idCVar r_useClusteredLights;			// 0 = off, 1 = on, 2 = only left of the view center
 extern idCVar r_skipPrelightShadows;		// 1 = skip the dmap generated static shadow volumes
 extern idCVar r_useCachedDynamicModels;		// 1 = cache snapshots of dynamic models
 extern idCVar r_useScissor;					// 1 = scissor clip as portals and lights are processed
@@ -1290,6 +1360,26 @@ void R_RenderPostProcess( viewDef_t* parms );
 /*
 ============================================================
 
+TR_FRONTEND_OCCLUSION
+
+============================================================
+*/
+
+void R_OcclusionCull();
+
+/*
+============================================================
+
+TR_FRONTEND_CLUSTEREDLIGHTS
+
+============================================================
+*/
+
+void R_AssignClusteredLights();
+
+/*
+============================================================
+
 TR_FRONTEND_ADDLIGHTS
 
 ============================================================
@@ -1396,6 +1486,17 @@ void				R_RemoveUnusedVerts( srfTriangles_t* tri );
 void				R_RangeCheckIndexes( const srfTriangles_t* tri );
 void				R_CreateVertexNormals( srfTriangles_t* tri );		// also called by dmap
 void				R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents );
+
+struct cleanupTriangles_t
+{
+	srfTriangles_t* 	tri;
+	bool				createNormals;
+	bool				identifySilEdges;
+	bool				useUnsmoothedTangents;
+};
+
+// Does R_CleanupTriangles on all the surfaces, in jobs if there are enough triangles.
+void				R_CleanupTrianglesList( cleanupTriangles_t* cleanups, int numCleanups );
 void				R_ReverseTriangles( srfTriangles_t* tri );
 
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
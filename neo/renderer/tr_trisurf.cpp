@@ -656,11 +656,10 @@ void R_CreateDupVerts( srfTriangles_t* tri )
 R_DefineEdge
 ===============
 */
-static int c_duplicatedEdges, c_tripledEdges;
 static const int MAX_SIL_EDGES			= 0x7ffff;
 
 static void R_DefineEdge( const int v1, const int v2, const int planeNum, const int numPlanes,
-						  idList<silEdge_t>& silEdges, idHashIndex&	 silEdgeHash )
+						  idList<silEdge_t>& silEdges, idHashIndex&	 silEdgeHash, int& c_duplicatedEdges, int& c_tripledEdges )
 {
 	int		i, hashKey;
 	
@@ -741,8 +740,9 @@ If the surface will not deform, coplanar edges (polygon interiors)
 can never create silhouette plains, and can be omited
 =================
 */
-int	c_coplanarSilEdges;
-int	c_totalSilEdges;
+// updated from the jobs of R_CleanupTrianglesList
+interlockedInt_t	c_coplanarSilEdges;
+interlockedInt_t	c_totalSilEdges;
 
 void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 {
@@ -762,8 +762,8 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 	
 	silEdgeHash.Clear();
 	
-	c_duplicatedEdges = 0;
-	c_tripledEdges = 0;
+	int c_duplicatedEdges = 0;
+	int c_tripledEdges = 0;
 	
 	for( i = 0; i < numTris; i++ )
 	{
@@ -774,9 +774,9 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		i3 = tri->silIndexes[ i * 3 + 2 ];
 		
 		// create the edges
-		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash );
+		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
 	}
 	
 	if( c_duplicatedEdges || c_tripledEdges )
@@ -839,12 +839,12 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		}
 		if( c_coplanarCulled )
 		{
-			c_coplanarSilEdges += c_coplanarCulled;
+			Sys_InterlockedAdd( c_coplanarSilEdges, c_coplanarCulled );
 //			common->Printf( "%i of %i sil edges coplanar culled\n", c_coplanarCulled,
 //				c_coplanarCulled + numSilEdges );
 		}
 	}
-	c_totalSilEdges += silEdges.Num();
+	Sys_InterlockedAdd( c_totalSilEdges, silEdges.Num() );
 	
 	// sort the sil edges based on plane number
 	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
@@ -1910,12 +1910,10 @@ void R_ReverseTriangles( srfTriangles_t* tri )
 
 /*
 =================
-R_CleanupTriangles
-
-FIXME: allow createFlat and createSmooth normals, as well as explicit
+R_CleanupTriangleIndexes
 =================
 */
-void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents )
+static void R_CleanupTriangleIndexes( srfTriangles_t* tri )
 {
 	R_RangeCheckIndexes( tri );
 	
@@ -1928,12 +1926,17 @@ void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifyS
 	R_TestDegenerateTextureSpace( tri );
 	
 //	R_RemoveUnusedVerts( tri );
+}
 
-	if( identifySilEdges )
-	{
-		R_IdentifySilEdges( tri, true );	// assume it is non-deformable, and omit coplanar edges
-	}
-	
+/*
+=================
+R_CleanupTriangleVerts
+
+Only uses the silIndexes of the silhouette data, so it can run at the same time as R_IdentifySilEdges.
+=================
+*/
+static void R_CleanupTriangleVerts( srfTriangles_t* tri, bool createNormals, bool useUnsmoothedTangents )
+{
 	// bust vertexes that share a mirrored edge into separate vertexes
 	R_DuplicateMirroredVertexes( tri );
 	
@@ -1956,6 +1959,114 @@ void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifyS
 	}
 }
 
+/*
+=================
+R_CleanupTriangles
+
+FIXME: allow createFlat and createSmooth normals, as well as explicit
+=================
+*/
+void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents )
+{
+	R_CleanupTriangleIndexes( tri );
+	
+	if( identifySilEdges )
+	{
+		R_IdentifySilEdges( tri, true );	// assume it is non-deformable, and omit coplanar edges
+	}
+	
+	R_CleanupTriangleVerts( tri, createNormals, useUnsmoothedTangents );
+}
+
+idCVar r_cleanupTrianglesInJobs( "r_cleanupTrianglesInJobs", "1", CVAR_RENDERER | CVAR_BOOL, "cleans up the triangles of large models in jobs" );
+
+static const int CLEANUP_JOBS_MIN_INDEXES		= 3 * 4096;		// below this the surfaces of a model are cleaned up in place
+static const int CLEANUP_SILEDGE_JOB_MIN_INDEXES	= 3 * 8192;		// surfaces this large identify the sil edges in a job of their own
+
+struct cleanupTrianglesJob_t
+{
+	cleanupTriangles_t* 	cleanup;
+	idParallelJobList* 		jobList;
+};
+
+/*
+=================
+R_IdentifySilEdgesJob
+=================
+*/
+static void R_IdentifySilEdgesJob( srfTriangles_t* tri )
+{
+	R_IdentifySilEdges( tri, true );
+}
+
+/*
+=================
+R_CleanupTrianglesJob
+=================
+*/
+static void R_CleanupTrianglesJob( cleanupTrianglesJob_t* job )
+{
+	const cleanupTriangles_t& cleanup = *job->cleanup;
+	
+	R_CleanupTriangleIndexes( cleanup.tri );
+	
+	if( cleanup.identifySilEdges )
+	{
+		if( cleanup.tri->numIndexes >= CLEANUP_SILEDGE_JOB_MIN_INDEXES )
+		{
+			job->jobList->AddChildJob( ( jobRun_t )R_IdentifySilEdgesJob, cleanup.tri );
+		}
+		else
+		{
+			R_IdentifySilEdges( cleanup.tri, true );
+		}
+	}
+	
+	R_CleanupTriangleVerts( cleanup.tri, cleanup.createNormals, cleanup.useUnsmoothedTangents );
+}
+
+REGISTER_PARALLEL_JOB( R_IdentifySilEdgesJob, "R_IdentifySilEdgesJob" );
+REGISTER_PARALLEL_JOB( R_CleanupTrianglesJob, "R_CleanupTrianglesJob" );
+
+/*
+=================
+R_CleanupTrianglesList
+
+Each surface is cleaned up in a job, and the sil edges of large surfaces are identified
+in parallel with the rest of their cleanup. The results are the same as R_CleanupTriangles.
+=================
+*/
+void R_CleanupTrianglesList( cleanupTriangles_t* cleanups, int numCleanups )
+{
+	int totalIndexes = 0;
+	for( int i = 0; i < numCleanups; i++ )
+	{
+		totalIndexes += cleanups[i].tri->numIndexes;
+	}
+	
+	// a job can't wait for other jobs
+	if( !r_cleanupTrianglesInJobs.GetBool() || totalIndexes < CLEANUP_JOBS_MIN_INDEXES || !idLib::IsMainThread() )
+	{
+		for( int i = 0; i < numCleanups; i++ )
+		{
+			R_CleanupTriangles( cleanups[i].tri, cleanups[i].createNormals, cleanups[i].identifySilEdges, cleanups[i].useUnsmoothedTangents );
+		}
+		return;
+	}
+	
+	idTempArray< cleanupTrianglesJob_t > jobs( numCleanups );
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numCleanups, 0, NULL );
+	for( int i = 0; i < numCleanups; i++ )
+	{
+		jobs[i].cleanup = &cleanups[i];
+		jobs[i].jobList = jobList;
+		jobList->AddJob( ( jobRun_t )R_CleanupTrianglesJob, &jobs[i] );
+	}
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_THREADS );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+}
+
 /*
 ===================================================================================
 
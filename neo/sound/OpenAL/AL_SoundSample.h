@@ -153,6 +153,7 @@ public:
 protected:
 	friend class idSoundHardware_OpenAL;
 	friend class idSoundVoice_OpenAL;
+	friend class idSoundSystemLocal;
 	
 	~idSoundSample_OpenAL();
 	
@@ -132,6 +132,7 @@ public:
 protected:
 	friend class idSoundHardware_XAudio2;
 	friend class idSoundVoice_XAudio2;
+	friend class idSoundSystemLocal;
 	
 	~idSoundSample_XAudio2();
 	
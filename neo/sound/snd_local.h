@@ -545,6 +545,7 @@ public:
 	idSoundSample* 			LoadSample( const char* name );
 	
 	virtual void			Preload( idPreloadManifest& preload );
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats );
 	
 	struct bufferContext_t
 	{
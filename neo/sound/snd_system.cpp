@@ -574,6 +574,8 @@ void idSoundSystemLocal::Preload( idPreloadManifest& manifest )
 	
 	idList< preloadSort_t > preloadSort;
 	preloadSort.Resize( manifest.NumResources() );
+	idStrList generatedFiles;
+	generatedFiles.SetNum( manifest.NumResources() );
 	for( int i = 0; i < manifest.NumResources(); i++ )
 	{
 		const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
@@ -594,12 +596,21 @@ void idSoundSystemLocal::Preload( idPreloadManifest& manifest )
 				ps.idx = i;
 				ps.ofs = rc.offset;
 				preloadSort.Append( ps );
+				generatedFiles[i] = filename;
 			}
 		}
 	}
 	
 	preloadSort.SortWithTemplate( idSort_Preload() );
 	
+	idStrList preloadFiles;
+	preloadFiles.Resize( preloadSort.Num() );
+	for( int i = 0; i < preloadSort.Num(); i++ )
+	{
+		preloadFiles.Append( generatedFiles[ preloadSort[i].idx ] );
+	}
+	
+	fileSystem->StartPreload( preloadFiles );
 	for( int i = 0; i < preloadSort.Num(); i++ )
 	{
 		const preloadSort_t& ps = preloadSort[ i ];
@@ -614,12 +625,116 @@ void idSoundSystemLocal::Preload( idPreloadManifest& manifest )
 			sample->SetLevelLoadReferenced();
 		}
 	}
+	fileSystem->StopPreload();
 	
 	int	end = Sys_Milliseconds();
 	common->Printf( "%05d sounds preloaded in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 	common->Printf( "----------------------------------------\n" );
 }
 
+/*
+========================
+idSoundSystemLocal::Bake
+
+The generated samples are otherwise only written while building resources, and the loads
+don't check their timestamps at all.
+========================
+*/
+void idSoundSystemLocal::Bake( const idPreloadManifest& manifest, bakeStats_t& stats )
+{
+	idStrList sampleNames;
+	idHashIndex sampleHash;
+	for( int i = 0; i < manifest.NumResources(); i++ )
+	{
+		const preloadEntry_s& p = manifest.GetPreloadByIndex( i );
+		if( p.resType != PRELOAD_SAMPLE )
+		{
+			continue;
+		}
+		idStr sampleName = p.resourceName;
+		sampleName.StripLeadingOnce( "generated/" );
+		sampleName.StripFileExtension();
+		const int key = sampleHash.GenerateKey( sampleName, false );
+		int j;
+		for( j = sampleHash.First( key ); j != -1; j = sampleHash.Next( j ) )
+		{
+			if( sampleNames[j].Icmp( sampleName ) == 0 )
+			{
+				break;
+			}
+		}
+		if( j == -1 )
+		{
+			sampleHash.Add( key, sampleNames.Append( sampleName ) );
+		}
+	}
+	
+	if( sampleNames.Num() == 0 )
+	{
+		return;
+	}
+	
+	common->Printf( "Baking %i sounds...\n", sampleNames.Num() );
+	
+	for( int i = 0; i < sampleNames.Num(); i++ )
+	{
+		// WriteAllSamples prefers the compressed source
+		idStrStatic< MAX_OSPATH > sourceName = sampleNames[i];
+		sourceName.Append( ".msadpcm" );
+		ID_TIME_T sourceTime = fileSystem->GetTimestamp( sourceName );
+		if( sourceTime == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			sourceName.SetFileExtension( "wav" );
+			sourceTime = fileSystem->GetTimestamp( sourceName );
+		}
+		if( sourceTime == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			common->Warning( "couldn't bake sound '%s'", sampleNames[i].c_str() );
+			stats.failed++;
+			continue;
+		}
+		
+		idStrStatic< MAX_OSPATH > generatedName = "generated/";
+		generatedName.Append( sampleNames[i] );
+		generatedName.Append( ".idwav" );
+		
+		// the source timestamp follows the magic
+		ID_TIME_T generatedTime = FILE_NOT_FOUND_TIMESTAMP;
+		{
+			idFileLocal file( fileSystem->OpenFileRead( generatedName ) );
+			if( file != NULL )
+			{
+				uint32 magic;
+				file->ReadBig( magic );
+				file->ReadBig( generatedTime );
+			}
+		}
+		
+		if( generatedTime == sourceTime )
+		{
+			bakeCache.UpdateFile( generatedName, sourceName, sourceTime, 0 );
+			stats.upToDate++;
+			continue;
+		}
+		if( generatedTime != FILE_NOT_FOUND_TIMESTAMP && bakeCache.IsFileCurrent( generatedName, sourceName, sourceTime, 0 ) )
+		{
+			stats.upToDate++;
+			continue;
+		}
+		
+		idSoundSample sample;
+		sample.WriteAllSamples( sampleNames[i] );
+		if( fileSystem->GetTimestamp( generatedName ) == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			common->Warning( "couldn't bake sound '%s'", sampleNames[i].c_str() );
+			stats.failed++;
+			continue;
+		}
+		bakeCache.UpdateFile( generatedName, sourceName, sourceTime, 0 );
+		stats.baked++;
+	}
+}
+
 /*
 ========================
 idSoundSystemLocal::EndLevelLoad
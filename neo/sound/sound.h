@@ -336,6 +336,9 @@ public:
 	
 	virtual void			Preload( idPreloadManifest& preload ) = 0;
 	
+	// rebuilds the generated samples of the manifest that are out of date
+	virtual void			Bake( const idPreloadManifest& manifest, bakeStats_t& stats ) = 0;
+	
 	// prints memory info
 	virtual void			PrintMemInfo( MemInfo_t* mi ) = 0;
 };
@@ -221,7 +221,8 @@ public:
 	float			GetAmplitude( int timeMS ) const;
 	
 protected:
-
+	friend class idSoundSystemLocal;
+	
 	/*
 		friend class idSoundHardware_XAudio2;
 		friend class idSoundVoice_XAudio2;
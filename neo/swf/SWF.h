@@ -50,6 +50,10 @@ public:
 	idSWFDictionaryEntry();
 	~idSWFDictionaryEntry();
 	idSWFDictionaryEntry& operator=( idSWFDictionaryEntry& other );
+	idSWFDictionaryEntry& operator=( idSWFDictionaryEntry&& other )
+	{
+		return operator=( other );
+	}
 	
 	swfDictType_t		type;
 	const idMaterial* 	material;
@@ -43,6 +43,10 @@ public:
 	}
 	
 	idSWFBitStream& operator=( idSWFBitStream& other );
+	idSWFBitStream& operator=( idSWFBitStream&& other )
+	{
+		return operator=( other );
+	}
 	
 	void			Load( const byte* data, uint32 len, bool copy );
 	void			Free();
@@ -49,6 +49,10 @@ static int cmdargc = 0;
 #include <mcheck.h>
 #endif
 
+#if defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
 /*
 ==============
 Sys_EXEPath
@@ -80,7 +84,94 @@ Sys_GetProcessorId
 */
 cpuid_t Sys_GetProcessorId()
 {
+#if defined(__i386__) || defined(__x86_64__)
+	static int flags = CPUID_NONE;
+	if( flags != CPUID_NONE )
+	{
+		return ( cpuid_t )flags;
+	}
+	
+	unsigned int eax, ebx, ecx, edx;
+	
+	const unsigned int maxLevel = __get_cpuid_max( 0, NULL );
+	if( maxLevel < 1 )
+	{
+		flags = CPUID_GENERIC;
+		return ( cpuid_t )flags;
+	}
+	
+	__cpuid( 0, eax, ebx, ecx, edx );
+	if( ebx == 0x68747541 )		// "Auth" enticAMD
+	{
+		flags = CPUID_AMD;
+	}
+	else if( ebx == 0x756e6547 )	// "Genu" ineIntel
+	{
+		flags = CPUID_INTEL;
+	}
+	else
+	{
+		flags = CPUID_GENERIC;
+	}
+	
+	__cpuid( 1, eax, ebx, ecx, edx );
+	if( edx & bit_MMX )
+	{
+		flags |= CPUID_MMX;
+	}
+	if( edx & bit_SSE )
+	{
+		flags |= CPUID_SSE | CPUID_FTZ;
+	}
+	if( edx & bit_SSE2 )
+	{
+		flags |= CPUID_SSE2;
+	}
+	if( ecx & bit_SSE3 )
+	{
+		flags |= CPUID_SSE3;
+	}
+	if( edx & ( 1 << 28 ) )
+	{
+		flags |= CPUID_HTT;
+	}
+	if( edx & bit_CMOV )
+	{
+		flags |= CPUID_CMOV;
+	}
+#if defined(__x86_64__)
+	// every x86-64 CPU can do Denormals-Are-Zero
+	flags |= CPUID_DAZ;
+#endif
+	
+	// AVX registers can only be used if the OS saves them on context switches
+	const bool osxsave = ( ecx & bit_OSXSAVE ) != 0;
+	const bool fma = ( ecx & bit_FMA ) != 0;
+	bool avxState = false;
+	if( osxsave && ( ecx & bit_AVX ) )
+	{
+		unsigned int xcr0Lo, xcr0Hi;
+		__asm__ __volatile__( "xgetbv" : "=a"( xcr0Lo ), "=d"( xcr0Hi ) : "c"( 0 ) );
+		avxState = ( xcr0Lo & 6 ) == 6;	// XMM and YMM state
+	}
+	
+	if( avxState && maxLevel >= 7 )
+	{
+		__cpuid_count( 7, 0, eax, ebx, ecx, edx );
+		if( ebx & ( 1 << 5 ) )
+		{
+			flags |= CPUID_AVX2;
+		}
+		if( fma )
+		{
+			flags |= CPUID_FMA3;
+		}
+	}
+	
+	return ( cpuid_t )flags;
+#else
 	return CPUID_GENERIC;
+#endif
 }
 
 /*
@@ -807,6 +807,46 @@ ID_TIME_T Sys_FileTimeStamp( idFileHandle fp )
 	return st.st_mtime;
 }
 
+const byte* Sys_MapFile( const char* osPath, int* length )
+{
+	int fd = open( osPath, O_RDONLY );
+	if( fd == -1 )
+	{
+		return NULL;
+	}
+	
+	struct stat st;
+	if( fstat( fd, &st ) == -1 || st.st_size <= 0 || st.st_size > INT_MAX )
+	{
+		close( fd );
+		return NULL;
+	}
+	
+	// the mapping stays valid after the descriptor is closed
+	void* data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( data == MAP_FAILED )
+	{
+		return NULL;
+	}
+	
+	*length = ( int )st.st_size;
+	return ( const byte* )data;
+}
+
+void Sys_UnmapFile( const byte* data, int length )
+{
+	munmap( ( void* )data, length );
+}
+
+void Sys_PrefetchMappedFile( const byte* data, int length )
+{
+	// madvise wants a page aligned start
+	const uintptr_t pageMask = ( uintptr_t )sysconf( _SC_PAGESIZE ) - 1;
+	const uintptr_t start = ( uintptr_t )data & ~pageMask;
+	madvise( ( void* )start, ( uintptr_t )data + length - start, MADV_WILLNEED );
+}
+
 void Sys_Sleep( int msec )
 {
 #if 0 // DG: I don't really care, this spams the console (and on windows this case isn't handled either)
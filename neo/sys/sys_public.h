@@ -58,7 +58,9 @@ enum cpuid_t
 	CPUID_FTZ							= 0x04000,	// Flush-To-Zero mode (denormal results are flushed to zero)
 	CPUID_DAZ							= 0x08000,	// Denormals-Are-Zero mode (denormal source operands are set to zero)
 	CPUID_XENON							= 0x10000,	// Xbox 360
-	CPUID_CELL							= 0x20000	// PS3
+	CPUID_CELL							= 0x20000,	// PS3
+	CPUID_AVX2							= 0x40000,	// Advanced Vector Extensions 2, only set when the OS saves the AVX state
+	CPUID_FMA3							= 0x80000	// Fused Multiply-Add
 };
 
 enum fpuExceptions_t
@@ -623,6 +625,12 @@ typedef FILE* idFileHandle;
 
 
 ID_TIME_T		Sys_FileTimeStamp( idFileHandle fp );
+// maps the whole file read only into the address space, the mapping outlives closing the file
+// returns NULL if the file can't be mapped
+const byte* 	Sys_MapFile( const char* osPath, int* length );
+void			Sys_UnmapFile( const byte* data, int length );
+// hints the OS to page in a range of a mapped file ahead of use, never blocks
+void			Sys_PrefetchMappedFile( const byte* data, int length );
 // NOTE: do we need to guarantee the same output on all platforms?
 const char* 	Sys_TimeStampToStr( ID_TIME_T timeStamp );
 const char* 	Sys_SecToStr( int sec );
@@ -461,6 +461,69 @@ ID_TIME_T Sys_FileTimeStamp( idFileHandle fp ) {
 	return itime.QuadPart;
 }
 
+/*
+========================
+Sys_MapFile
+========================
+*/
+const byte * Sys_MapFile( const char *osPath, int *length ) {
+	HANDLE file = CreateFile( osPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return NULL;
+	}
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( file, &size ) || size.QuadPart <= 0 || size.QuadPart > INT_MAX ) {
+		CloseHandle( file );
+		return NULL;
+	}
+	HANDLE mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( mapping == NULL ) {
+		return NULL;
+	}
+	// the view keeps the mapping alive
+	const byte * data = (const byte *)MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( mapping );
+	if ( data == NULL ) {
+		return NULL;
+	}
+	*length = (int)size.QuadPart;
+	return data;
+}
+
+/*
+========================
+Sys_UnmapFile
+========================
+*/
+void Sys_UnmapFile( const byte *data, int length ) {
+	UnmapViewOfFile( data );
+}
+
+/*
+========================
+Sys_PrefetchMappedFile
+
+PrefetchVirtualMemory only exists on Windows 8 and later, older systems just page in on use
+========================
+*/
+typedef struct {
+	PVOID	VirtualAddress;
+	SIZE_T	NumberOfBytes;
+} prefetchRange_t;
+typedef BOOL ( WINAPI * PrefetchVirtualMemory_t )( HANDLE, ULONG_PTR, prefetchRange_t *, ULONG );
+
+void Sys_PrefetchMappedFile( const byte *data, int length ) {
+	static PrefetchVirtualMemory_t PrefetchVirtualMemory = (PrefetchVirtualMemory_t)GetProcAddress( GetModuleHandle( "kernel32.dll" ), "PrefetchVirtualMemory" );
+	if ( PrefetchVirtualMemory == NULL ) {
+		return;
+	}
+	prefetchRange_t range;
+	range.VirtualAddress = (PVOID)data;
+	range.NumberOfBytes = length;
+	PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 );
+}
+
 /*
 ========================
 Sys_Rmdir